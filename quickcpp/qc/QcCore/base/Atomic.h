@@ -0,0 +1,204 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Atomic
+// 
+// Overview
+// --------
+// Static helpers for sharing a variable between two threads without a lock,
+// as PipeBuffer and AsyncFileOutputStream do for the offsets of their rings.
+//
+// LoadAcquire() prevents later memory accesses from moving before the load,
+// StoreRelease() prevents earlier ones from moving after the store, and
+// FullBarrier() orders everything on either side of it.  The variable must be
+// naturally aligned and no larger than 64 bits.
+//
+// Visual C++ only gives volatile accesses acquire and release semantics under
+// /volatile:ms, which is not the default on ARM, so those builds use the
+// __iso_volatile intrinsics with an explicit barrier.  Other compilers use the
+// GCC __atomic builtins.
+//
+//=============================================================================
+
+#ifndef QC_BASE_Atomic_h
+#define QC_BASE_Atomic_h
+
+#ifndef QC_BASE_DEFS_h
+#include "defs.h"
+#endif //QC_BASE_DEFS_h
+
+#if defined(WIN32)
+	#include "QcCore/base/winincl.h"
+	#include <intrin.h>
+#endif //WIN32
+
+QC_BASE_NAMESPACE_BEGIN
+
+class Atomic
+{
+public:
+	template<typename T>
+	static T LoadAcquire(const volatile T& var);
+
+	template<typename T>
+	static void StoreRelease(volatile T& var, T value);
+
+	static void FullBarrier();
+
+private:
+	Atomic(); // not instantiable
+
+#if defined(WIN32)
+
+	static void Barrier();
+
+	template<size_t size> struct Word;
+
+#endif //WIN32
+};
+
+#if defined(WIN32)
+
+template<> struct Atomic::Word<1>
+{
+	typedef __int8 Type;
+	static Type Load(const volatile void* p) {return __iso_volatile_load8((const volatile __int8*)p);}
+	static void Store(volatile void* p, Type value) {__iso_volatile_store8((volatile __int8*)p, value);}
+};
+
+template<> struct Atomic::Word<2>
+{
+	typedef __int16 Type;
+	static Type Load(const volatile void* p) {return __iso_volatile_load16((const volatile __int16*)p);}
+	static void Store(volatile void* p, Type value) {__iso_volatile_store16((volatile __int16*)p, value);}
+};
+
+template<> struct Atomic::Word<4>
+{
+	typedef __int32 Type;
+	static Type Load(const volatile void* p) {return __iso_volatile_load32((const volatile __int32*)p);}
+	static void Store(volatile void* p, Type value) {__iso_volatile_store32((volatile __int32*)p, value);}
+};
+
+template<> struct Atomic::Word<8>
+{
+	typedef __int64 Type;
+	static Type Load(const volatile void* p) {return __iso_volatile_load64((const volatile __int64*)p);}
+	static void Store(volatile void* p, Type value) {__iso_volatile_store64((volatile __int64*)p, value);}
+};
+
+//==============================================================================
+// Atomic::Barrier
+//
+// Keeps the processor from reordering memory accesses across the call.  x86
+// and x64 never move a load before an earlier load, or a store before an
+// earlier access, so there only the compiler needs to be stopped.
+//==============================================================================
+inline
+	void Atomic::Barrier()
+{
+#if defined(_M_ARM64)
+	__dmb(_ARM64_BARRIER_ISH);
+#elif defined(_M_ARM)
+	__dmb(_ARM_BARRIER_ISH);
+#else
+	_ReadWriteBarrier();
+#endif
+}
+
+//==============================================================================
+// Atomic::LoadAcquire
+//
+//==============================================================================
+template<typename T>
+inline
+	T Atomic::LoadAcquire(const volatile T& var)
+{
+	const typename Word<sizeof(T)>::Type value = Word<sizeof(T)>::Load(&var);
+	Barrier();
+	return (T)value;
+}
+
+//==============================================================================
+// Atomic::StoreRelease
+//
+//==============================================================================
+template<typename T>
+inline
+	void Atomic::StoreRelease(volatile T& var, T value)
+{
+	Barrier();
+	Word<sizeof(T)>::Store(&var, (typename Word<sizeof(T)>::Type)value);
+}
+
+//==============================================================================
+// Atomic::FullBarrier
+//
+//==============================================================================
+inline
+	void Atomic::FullBarrier()
+{
+	::MemoryBarrier();
+}
+
+#else
+
+//==============================================================================
+// Atomic::LoadAcquire
+//
+//==============================================================================
+template<typename T>
+inline
+	T Atomic::LoadAcquire(const volatile T& var)
+{
+	return __atomic_load_n(&var, __ATOMIC_ACQUIRE);
+}
+
+//==============================================================================
+// Atomic::StoreRelease
+//
+//==============================================================================
+template<typename T>
+inline
+	void Atomic::StoreRelease(volatile T& var, T value)
+{
+	__atomic_store_n(&var, value, __ATOMIC_RELEASE);
+}
+
+//==============================================================================
+// Atomic::FullBarrier
+//
+//==============================================================================
+inline
+	void Atomic::FullBarrier()
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+#endif //WIN32
+
+QC_BASE_NAMESPACE_END
+
+#endif //QC_BASE_Atomic_h
@@ -0,0 +1,560 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: BufferPool
+// 
+/**
+	@class qc::BufferPool
+	
+	@brief Class module that recycles the blocks of memory used as i/o
+	buffers.
+
+	Each BufferedInputStream, BufferedOutputStream, BufferedReader,
+	BufferedWriter, InputStreamReader and OutputStreamWriter owns a buffer of
+	several kilobytes.  An application that creates a stack of these objects
+	for each network connection or file would otherwise allocate and free
+	these large blocks continually.  Instead, the buffers are obtained from
+	the BufferPool and returned to it when the object is closed or destroyed.
+
+	Requests are rounded up to one of a set of size classes, which are the
+	powers of two from MinBlockSize (1KB) to MaxBlockSize (64KB).  Larger
+	requests are passed straight to the heap.
+
+	Released blocks are first kept in a small cache belonging to the calling
+	thread, which can be used again by the same thread without any locking.
+	SetThreadCacheSize() controls how many blocks of each size class a thread
+	may keep.  When a thread's cache is full, blocks are returned to a shared
+	pool, up to the limit set by SetMaxPoolSize(), and beyond that to the heap.
+	When a Thread ends its cache is emptied into the shared pool
+	automatically; threads not created by the Thread class should call
+	ReleaseThreadCache() before they end.
+
+	The pool can be disabled with SetEnabled(false), after which buffers are
+	allocated from and returned to the heap.  GetStatistics() reports how
+	effective the pool has been; statistics are not collected while the
+	pool is disabled.
+
+    @mt
+    All methods may be called from any thread.
+*/
+//==============================================================================
+
+#include "BufferPool.h"
+
+#ifdef QC_MT
+	#include "AutoLock.h"
+	#include "FastMutex.h"
+	#include "ThreadLocal.h"
+#endif //QC_MT
+
+#include <new>
+#include <string.h>
+
+QC_BASE_NAMESPACE_BEGIN
+
+const size_t NumSizeClasses = 7; // MinBlockSize << 6 == MaxBlockSize
+
+//
+// A block in the shared pool holds the link to the next free block
+//
+struct PoolFreeBlock
+{
+	PoolFreeBlock* pNext;
+};
+
+//
+// Each thread's cache is linked into a list so that its statistics can be
+// collected by GetStatistics()
+//
+struct PoolThreadCache
+{
+	void* blocks[NumSizeClasses][BufferPool::MaxThreadCacheSize];
+	size_t count[NumSizeClasses];
+	BufferPool::Statistics stats;
+	PoolThreadCache* pPrev;
+	PoolThreadCache* pNext;
+};
+
+static bool QC_MT_VOLATILE PoolEnabled = true;
+static size_t QC_MT_VOLATILE MaxPoolSize = 0x400000;
+static size_t QC_MT_VOLATILE ThreadCacheSize = 2;
+
+//
+// The following are protected by BufferPoolMutex
+//
+static PoolFreeBlock* FreeLists[NumSizeClasses];
+static size_t PooledBytes;
+static PoolThreadCache* pThreadCaches;
+static BufferPool::Statistics RetiredStats;
+
+#ifdef QC_MT
+	static FastMutex BufferPoolMutex;
+	static ThreadLocal* QC_MT_VOLATILE pThreadCacheKey = 0;
+#else
+	static PoolThreadCache* pSingleThreadCache = 0;
+#endif //QC_MT
+
+//==============================================================================
+// GetSizeClass
+//
+// Returns the index of the smallest size class that can hold size bytes.
+// size must not exceed MaxBlockSize.
+//==============================================================================
+static size_t GetSizeClass(size_t size)
+{
+	size_t sizeClass = 0;
+	size_t blockSize = BufferPool::MinBlockSize;
+	while(blockSize < size)
+	{
+		blockSize <<= 1;
+		++sizeClass;
+	}
+	return sizeClass;
+}
+
+//==============================================================================
+// GetBlockSize
+//
+//==============================================================================
+static size_t GetBlockSize(size_t sizeClass)
+{
+	return size_t(BufferPool::MinBlockSize) << sizeClass;
+}
+
+//==============================================================================
+// GetThreadCache
+//
+// Returns the calling thread's cache, creating it if necessary when bCreate
+// is true.
+//==============================================================================
+static PoolThreadCache* GetThreadCache(bool bCreate)
+{
+#ifdef QC_MT
+
+	if(!pThreadCacheKey)
+	{
+		if(!bCreate)
+		{
+			return 0;
+		}
+
+		QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+		if(!pThreadCacheKey)
+		{
+			// never deleted, so that buffers can be released during termination
+			pThreadCacheKey = new ThreadLocal;
+		}
+	}
+	PoolThreadCache* pCache = static_cast<PoolThreadCache*>(pThreadCacheKey->get());
+
+#else
+
+	PoolThreadCache* pCache = pSingleThreadCache;
+
+#endif //QC_MT
+
+	if(!pCache && bCreate)
+	{
+		pCache = new PoolThreadCache;
+		::memset(pCache, 0, sizeof(PoolThreadCache));
+		{
+			QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+			pCache->pNext = pThreadCaches;
+			if(pThreadCaches)
+			{
+				pThreadCaches->pPrev = pCache;
+			}
+			pThreadCaches = pCache;
+		}
+
+#ifdef QC_MT
+		pThreadCacheKey->set(pCache);
+#else
+		pSingleThreadCache = pCache;
+#endif //QC_MT
+	}
+
+	return pCache;
+}
+
+//==============================================================================
+// ReleaseToPool
+//
+// Adds a block to the shared pool, or frees it if the pool is full.
+//==============================================================================
+static void ReleaseToPool(void* pBuffer, size_t sizeClass, PoolThreadCache* pCache)
+{
+	const size_t blockSize = GetBlockSize(sizeClass);
+	{
+		QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+		if(PooledBytes + blockSize <= MaxPoolSize)
+		{
+			PoolFreeBlock* pBlock = static_cast<PoolFreeBlock*>(pBuffer);
+			pBlock->pNext = FreeLists[sizeClass];
+			FreeLists[sizeClass] = pBlock;
+			PooledBytes += blockSize;
+			return;
+		}
+	}
+
+	++pCache->stats.heapReleases;
+	::operator delete(pBuffer);
+}
+
+//==============================================================================
+// FlushThreadCache
+//
+// Moves every block held by a thread's cache to the shared pool.
+//==============================================================================
+static void FlushThreadCache(PoolThreadCache* pCache)
+{
+	for(size_t sizeClass=0; sizeClass<NumSizeClasses; ++sizeClass)
+	{
+		while(pCache->count[sizeClass])
+		{
+			ReleaseToPool(pCache->blocks[sizeClass][--pCache->count[sizeClass]], sizeClass, pCache);
+		}
+	}
+}
+
+//==============================================================================
+// BufferPool::Allocate
+//
+/**
+   Allocates a block of at least @c size bytes.
+
+   The block must be returned to the pool using Release() with the same
+   @c size.  It must not be freed using @c delete.
+
+   @param size the number of bytes required
+   @returns a pointer to the block
+   @throws std::bad_alloc if the memory cannot be allocated
+*/
+//==============================================================================
+void* BufferPool::Allocate(size_t size)
+{
+	if(size > MaxBlockSize)
+	{
+		if(PoolEnabled)
+		{
+			PoolThreadCache* pCache = GetThreadCache(true);
+			++pCache->stats.allocations;
+			++pCache->stats.heapAllocations;
+		}
+		return ::operator new(size);
+	}
+
+	//
+	// The block must be the full size of its class, even when the pool
+	// is disabled, because it may be released after the pool is enabled
+	//
+	const size_t sizeClass = GetSizeClass(size);
+
+	if(!PoolEnabled)
+	{
+		return ::operator new(GetBlockSize(sizeClass));
+	}
+
+	PoolThreadCache* pCache = GetThreadCache(true);
+	++pCache->stats.allocations;
+
+	if(pCache->count[sizeClass])
+	{
+		++pCache->stats.threadCacheHits;
+		return pCache->blocks[sizeClass][--pCache->count[sizeClass]];
+	}
+
+	{
+		QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+		PoolFreeBlock* pBlock = FreeLists[sizeClass];
+		if(pBlock)
+		{
+			FreeLists[sizeClass] = pBlock->pNext;
+			PooledBytes -= GetBlockSize(sizeClass);
+			++pCache->stats.poolHits;
+			return pBlock;
+		}
+	}
+
+	++pCache->stats.heapAllocations;
+	return ::operator new(GetBlockSize(sizeClass));
+}
+
+//==============================================================================
+// BufferPool::Release
+//
+/**
+   Returns a block allocated by Allocate() to the pool.
+
+   @param pBuffer the block to release.  If this is null the method does
+          nothing.
+   @param size the size passed to Allocate()
+*/
+//==============================================================================
+void BufferPool::Release(void* pBuffer, size_t size)
+{
+	if(!pBuffer)
+	{
+		return;
+	}
+
+	if(!PoolEnabled)
+	{
+		::operator delete(pBuffer);
+		return;
+	}
+
+	PoolThreadCache* pCache = GetThreadCache(true);
+	++pCache->stats.releases;
+
+	if(size > MaxBlockSize)
+	{
+		++pCache->stats.heapReleases;
+		::operator delete(pBuffer);
+		return;
+	}
+
+	const size_t sizeClass = GetSizeClass(size);
+
+	if(pCache->count[sizeClass] < ThreadCacheSize)
+	{
+		pCache->blocks[sizeClass][pCache->count[sizeClass]++] = pBuffer;
+	}
+	else
+	{
+		ReleaseToPool(pBuffer, sizeClass, pCache);
+	}
+}
+
+//==============================================================================
+// BufferPool::IsEnabled
+//
+/**
+   Tests whether the pool is enabled.  The pool is enabled by default.
+   @sa SetEnabled()
+*/
+//==============================================================================
+bool BufferPool::IsEnabled()
+{
+	return PoolEnabled;
+}
+
+//==============================================================================
+// BufferPool::SetEnabled
+//
+/**
+   Enables or disables the pool.
+
+   While the pool is disabled, every buffer is allocated from and returned
+   to the heap.  Disabling the pool also frees the blocks held by the shared
+   pool and by the calling thread's cache.
+
+   @param bEnabled true to enable the pool; false to disable it
+*/
+//==============================================================================
+void BufferPool::SetEnabled(bool bEnabled)
+{
+	PoolEnabled = bEnabled;
+	if(!bEnabled)
+	{
+		Purge();
+	}
+}
+
+//==============================================================================
+// BufferPool::GetMaxPoolSize
+//
+/**
+   Returns the maximum number of bytes held by the shared pool.
+   @sa SetMaxPoolSize()
+*/
+//==============================================================================
+size_t BufferPool::GetMaxPoolSize()
+{
+	return MaxPoolSize;
+}
+
+//==============================================================================
+// BufferPool::SetMaxPoolSize
+//
+/**
+   Sets the maximum number of bytes held by the shared pool.  Blocks that
+   are released when the pool is full are returned to the heap.  The default
+   value is 4MB.
+
+   Reducing the size does not free any blocks already in the pool; call
+   Purge() to do that.
+*/
+//==============================================================================
+void BufferPool::SetMaxPoolSize(size_t bytes)
+{
+	MaxPoolSize = bytes;
+}
+
+//==============================================================================
+// BufferPool::GetThreadCacheSize
+//
+/**
+   Returns the number of blocks of each size class that a thread may keep
+   in its own cache.
+   @sa SetThreadCacheSize()
+*/
+//==============================================================================
+size_t BufferPool::GetThreadCacheSize()
+{
+	return ThreadCacheSize;
+}
+
+//==============================================================================
+// BufferPool::SetThreadCacheSize
+//
+/**
+   Sets the number of blocks of each size class that a thread may keep in
+   its own cache.  The default value is 2.  A value of zero disables the
+   thread caches, so that every block is recycled through the shared pool.
+
+   @param blocks the number of blocks.  Values above MaxThreadCacheSize
+          are reduced to MaxThreadCacheSize.
+*/
+//==============================================================================
+void BufferPool::SetThreadCacheSize(size_t blocks)
+{
+	ThreadCacheSize = (blocks < size_t(MaxThreadCacheSize)) ? blocks : size_t(MaxThreadCacheSize);
+}
+
+//==============================================================================
+// BufferPool::GetStatistics
+//
+/**
+   Returns statistics describing the use of the pool by all threads since
+   the application started.
+
+   Counts belonging to other threads that are still running are read
+   without synchronization and may be slightly out of date.
+*/
+//==============================================================================
+BufferPool::Statistics BufferPool::GetStatistics()
+{
+	QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+
+	Statistics ret = RetiredStats;
+	for(const PoolThreadCache* pCache = pThreadCaches; pCache; pCache = pCache->pNext)
+	{
+		ret.allocations += pCache->stats.allocations;
+		ret.threadCacheHits += pCache->stats.threadCacheHits;
+		ret.poolHits += pCache->stats.poolHits;
+		ret.heapAllocations += pCache->stats.heapAllocations;
+		ret.releases += pCache->stats.releases;
+		ret.heapReleases += pCache->stats.heapReleases;
+	}
+	ret.pooledBytes = PooledBytes;
+	return ret;
+}
+
+//==============================================================================
+// BufferPool::Purge
+//
+/**
+   Returns the blocks held by the shared pool and by the calling thread's
+   cache to the heap.  The caches of other threads are not affected.
+*/
+//==============================================================================
+void BufferPool::Purge()
+{
+	PoolThreadCache* pCache = GetThreadCache(false);
+	if(pCache)
+	{
+		FlushThreadCache(pCache);
+	}
+
+	PoolFreeBlock* pFree[NumSizeClasses];
+	{
+		QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+		::memcpy(pFree, FreeLists, sizeof(FreeLists));
+		::memset(FreeLists, 0, sizeof(FreeLists));
+		PooledBytes = 0;
+	}
+
+	for(size_t sizeClass=0; sizeClass<NumSizeClasses; ++sizeClass)
+	{
+		while(pFree[sizeClass])
+		{
+			PoolFreeBlock* pBlock = pFree[sizeClass];
+			pFree[sizeClass] = pBlock->pNext;
+			::operator delete(pBlock);
+		}
+	}
+}
+
+//==============================================================================
+// BufferPool::ReleaseThreadCache
+//
+/**
+   Moves the blocks held by the calling thread's cache to the shared pool
+   and frees the cache.
+
+   This is called automatically when a Thread ends.  Threads that were not
+   created by the Thread class should call it before they end, otherwise
+   the blocks in their cache are lost.
+*/
+//==============================================================================
+void BufferPool::ReleaseThreadCache()
+{
+	PoolThreadCache* pCache = GetThreadCache(false);
+	if(!pCache)
+	{
+		return;
+	}
+
+	FlushThreadCache(pCache);
+
+	{
+		QC_AUTO_LOCK(FastMutex, BufferPoolMutex);
+
+		if(pCache->pPrev)
+			pCache->pPrev->pNext = pCache->pNext;
+		else
+			pThreadCaches = pCache->pNext;
+		if(pCache->pNext)
+			pCache->pNext->pPrev = pCache->pPrev;
+
+		RetiredStats.allocations += pCache->stats.allocations;
+		RetiredStats.threadCacheHits += pCache->stats.threadCacheHits;
+		RetiredStats.poolHits += pCache->stats.poolHits;
+		RetiredStats.heapAllocations += pCache->stats.heapAllocations;
+		RetiredStats.releases += pCache->stats.releases;
+		RetiredStats.heapReleases += pCache->stats.heapReleases;
+	}
+
+#ifdef QC_MT
+	pThreadCacheKey->set(0);
+#else
+	pSingleThreadCache = 0;
+#endif //QC_MT
+
+	delete pCache;
+}
+
+QC_BASE_NAMESPACE_END
@@ -0,0 +1,179 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: BufferPool
+// 
+// Overview
+// --------
+// The BufferPool class is a class module that recycles the i/o buffers used
+// by the stream, reader and writer classes.  It cannot be instantiated - all
+// methods are static.
+//
+//==============================================================================
+
+#ifndef QC_BASE_BufferPool_h
+#define QC_BASE_BufferPool_h
+
+#ifndef QC_BASE_DEFS_h
+#include "defs.h"
+#endif //QC_BASE_DEFS_h
+
+QC_BASE_NAMESPACE_BEGIN
+
+class QC_BASE_PKG BufferPool
+{
+public:
+
+	enum {MinBlockSize = 0x400,   /*!< size of the smallest size class */
+	      MaxBlockSize = 0x10000, /*!< size of the largest size class */
+	      MaxThreadCacheSize = 8  /*!< upper limit for SetThreadCacheSize() */};
+
+	/** Usage statistics returned by GetStatistics(). */
+	struct Statistics
+	{
+		size_t allocations;     //!< number of calls to Allocate()
+		size_t threadCacheHits; //!< allocations satisfied by the calling thread's cache
+		size_t poolHits;        //!< allocations satisfied by the shared pool
+		size_t heapAllocations; //!< allocations satisfied by the heap
+		size_t releases;        //!< number of calls to Release()
+		size_t heapReleases;    //!< released blocks returned to the heap
+		size_t pooledBytes;     //!< bytes currently held by the shared pool
+	};
+
+	static void* Allocate(size_t size);
+	static void Release(void* pBuffer, size_t size);
+
+	template<typename T> static T* AllocateArray(size_t count);
+	template<typename T> static void ReleaseArray(T* pArray, size_t count);
+
+	static bool IsEnabled();
+	static void SetEnabled(bool bEnabled);
+
+	static size_t GetMaxPoolSize();
+	static void SetMaxPoolSize(size_t bytes);
+
+	static size_t GetThreadCacheSize();
+	static void SetThreadCacheSize(size_t blocks);
+
+	static Statistics GetStatistics();
+	static void Purge();
+	static void ReleaseThreadCache();
+
+private:
+	BufferPool(); // not implemented
+};
+
+//==============================================================================
+// BufferPool::AllocateArray
+//
+/**
+   Allocates an array of @c count elements of type @c T from the pool.
+   @c T must be a type that does not require construction, such as ::Byte
+   or ::CharType.  The array must be returned using ReleaseArray() with the
+   same @c count.
+*/
+//==============================================================================
+template<typename T>
+inline
+	T* BufferPool::AllocateArray(size_t count)
+{
+	return static_cast<T*>(Allocate(count * sizeof(T)));
+}
+
+//==============================================================================
+// BufferPool::ReleaseArray
+//
+/**
+   Returns an array allocated by AllocateArray() to the pool.
+*/
+//==============================================================================
+template<typename T>
+inline
+	void BufferPool::ReleaseArray(T* pArray, size_t count)
+{
+	Release(pArray, count * sizeof(T));
+}
+
+//==============================================================================
+// Class: PooledArray
+//
+/**
+	@class qc::PooledArray
+	
+	@brief Holds an array allocated from the BufferPool for the duration of
+	       a scope.
+*/
+//==============================================================================
+	template<typename T>
+class PooledArray
+{
+public:
+	explicit PooledArray(size_t count);
+	~PooledArray();
+
+	T* get() const;
+	size_t size() const;
+
+private:
+	PooledArray(const PooledArray& rhs);            // cannot be copied
+	PooledArray& operator=(const PooledArray& rhs); // nor assigned
+
+private:
+	T* m_pArray;
+	size_t m_count;
+};
+
+template<typename T>
+inline
+	PooledArray<T>::PooledArray(size_t count) :
+	m_pArray(BufferPool::AllocateArray<T>(count)),
+	m_count(count)
+{
+}
+
+template<typename T>
+inline
+	PooledArray<T>::~PooledArray()
+{
+	BufferPool::ReleaseArray(m_pArray, m_count);
+}
+
+template<typename T>
+inline
+	T* PooledArray<T>::get() const
+{
+	return m_pArray;
+}
+
+template<typename T>
+inline
+	size_t PooledArray<T>::size() const
+{
+	return m_count;
+}
+
+QC_BASE_NAMESPACE_END
+
+#endif //QC_BASE_BufferPool_h
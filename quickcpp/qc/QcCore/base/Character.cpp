@@ -77,6 +77,16 @@ Character::Character(UCS4Char ch)
 {
 	if(ch > 0x10FFFFUL) throw IllegalCharacterException();
 
+	//
+	// ASCII is a single ::CharType in every internal encoding
+	//
+	if(ch < 0x80UL)
+	{
+		m_data[0] = CharType(ch);
+		m_length = 1;
+		return;
+	}
+
 	CharType* pNext;
 	const CharType* pEnd = m_data+MaxSeqLen;
 	SystemCodeConverter::Result res = 
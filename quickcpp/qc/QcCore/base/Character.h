@@ -544,20 +544,11 @@ inline
 
 #else // !(QC_UCS4 || QC_UCS2)
 
-	switch(m_length)
+	// UTF-8 is the only internal encoding that can take > 2 character positions
+	for(int i=0; i<m_length; ++i)
 	{
-
-		// UTF-8 is the only internal encoding that can take > 2 character positions
-#if defined(QC_UTF8) 
-
-	case 4: if(m_data[3] != rhs.m_data[3]) return false;
-	case 3: if(m_data[2] != rhs.m_data[2]) return false;
-
-#endif //QC_UTF8
-
-	case 2: if(m_data[1] != rhs.m_data[1]) return false;
-	default:
-	case 1: if(m_data[0] != rhs.m_data[0]) return false;
+		if(m_data[i] != rhs.m_data[i])
+			return false;
 	}
 
 	return true;
@@ -603,21 +594,10 @@ inline
 
 #else // !(QC_UCS4 || QC_UCS2)
 
-	pData += m_length;
-	switch(m_length)
+	// UTF-8 is the only internal encoding that can take > 2 character positions
+	for(int i=0; i<m_length; ++i)
 	{
-
-		// UTF-8 is the only internal encoding that can take > 2 character positions
-#if defined(QC_UTF8) 
-
-	case 4: m_data[3] = *--pData;
-	case 3: m_data[2] = *--pData;
-
-#endif //QC_UTF8
-
-	case 2: m_data[1] = *--pData;
-	default:
-	case 1: m_data[0] = *--pData;
+		m_data[i] = pData[i];
 	}
 
 #endif //QC_UCS4
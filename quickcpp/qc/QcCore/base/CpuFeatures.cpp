@@ -0,0 +1,236 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CpuFeatures
+// 
+/**
+	@class qc::CpuFeatures
+	
+	@brief Class module that reports the vector instruction set extensions
+	available on the host processor.
+
+	Several @QuickCPP components (notably the UTF-8 and 8-bit CodeConverters)
+	contain vectorized implementations of their inner loops.  These are
+	compiled for a range of instruction set extensions and the most capable
+	implementation supported by the host processor is selected at run-time
+	using the information provided by this class.
+
+	The processor is only interrogated once; subsequent calls return the
+	cached result.
+
+	When @QuickCPP is compiled with the @c QC_NO_SIMD pre-processor symbol
+	defined, or on platforms other than x86 and x86-64, every method
+	returns false.
+*/
+//==============================================================================
+
+#include "CpuFeatures.h"
+
+#if defined(QC_X86_SIMD)
+	#if defined(_MSC_VER)
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif //QC_X86_SIMD
+
+QC_BASE_NAMESPACE_BEGIN
+
+//==================================================================
+// Multi-threaded locking strategy
+//
+// The feature flags are calculated on first use and cached in a
+// static variable.  No mutex is required because every thread will
+// calculate exactly the same value, so a race between two threads
+// can do no harm.
+//==================================================================
+unsigned long QC_MT_VOLATILE CpuFeatures::s_features = 0;
+
+//==============================================================================
+// CpuFeatures::HasSSE2
+//
+/**
+   Tests if the processor supports the SSE2 instruction set.
+   @mtsafe
+*/
+//==============================================================================
+bool CpuFeatures::HasSSE2()
+{
+	return (GetFeatures() & SSE2) != 0;
+}
+
+//==============================================================================
+// CpuFeatures::HasSSE41
+//
+/**
+   Tests if the processor supports the SSE4.1 instruction set.
+   @mtsafe
+*/
+//==============================================================================
+bool CpuFeatures::HasSSE41()
+{
+	return (GetFeatures() & SSE41) != 0;
+}
+
+//==============================================================================
+// CpuFeatures::HasSSE42
+//
+/**
+   Tests if the processor supports the SSE4.2 instruction set, which
+   includes the @c crc32 instruction.
+   @mtsafe
+*/
+//==============================================================================
+bool CpuFeatures::HasSSE42()
+{
+	return (GetFeatures() & SSE42) != 0;
+}
+
+//==============================================================================
+// CpuFeatures::HasPCLMUL
+//
+/**
+   Tests if the processor supports the carry-less multiplication
+   (@c pclmulqdq) instruction.
+   @mtsafe
+*/
+//==============================================================================
+bool CpuFeatures::HasPCLMUL()
+{
+	return (GetFeatures() & PCLMUL) != 0;
+}
+
+//==============================================================================
+// CpuFeatures::HasAVX2
+//
+/**
+   Tests if the processor supports the AVX2 instruction set and the operating
+   system preserves the 256-bit YMM registers across context switches.
+   @mtsafe
+*/
+//==============================================================================
+bool CpuFeatures::HasAVX2()
+{
+	return (GetFeatures() & AVX2) != 0;
+}
+
+//==============================================================================
+// CpuFeatures::Disable
+//
+/**
+   Stops the given features from being reported by this class, so that code
+   paths selected afterwards use a less capable implementation.
+
+   Components select their implementation the first time they are used, so
+   this must be called before any conversion takes place.  It is intended for
+   tests and benchmarks that compare the vectorized code paths with the
+   portable ones.
+
+   @param features a combination of CpuFeatures::Feature flags
+*/
+//==============================================================================
+void CpuFeatures::Disable(unsigned long features)
+{
+	s_features = GetFeatures() & ~(features & ~(unsigned long)Probed);
+}
+
+//==============================================================================
+// CpuFeatures::GetFeatures
+//
+// Returns the cached feature flags, probing the processor on first use.
+//==============================================================================
+unsigned long CpuFeatures::GetFeatures()
+{
+	if(s_features == 0)
+	{
+		s_features = Probe() | Probed;
+	}
+	return s_features;
+}
+
+//==============================================================================
+// CpuFeatures::Probe
+//
+// Interrogates the processor using the cpuid instruction.
+//==============================================================================
+unsigned long CpuFeatures::Probe()
+{
+	unsigned long features = 0;
+
+#if defined(QC_X86_SIMD)
+
+	unsigned int regs[4] = {0, 0, 0, 0}; // eax, ebx, ecx, edx
+
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		const unsigned int maxLeaf = info[0];
+		__cpuid(info, 1);
+		regs[2] = info[2]; regs[3] = info[3];
+	#else
+		const unsigned int maxLeaf = __get_cpuid_max(0, 0);
+		if(maxLeaf >= 1)
+		{
+			__cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+		}
+	#endif
+
+	if(regs[3] & (1U << 26)) features |= SSE2;
+	if(regs[2] & (1U << 19)) features |= SSE41;
+	if(regs[2] & (1U << 20)) features |= SSE42;
+	if(regs[2] & (1U << 1))  features |= PCLMUL;
+
+	//
+	// AVX2 is only usable if the operating system has enabled the
+	// saving of the XMM and YMM register state (OSXSAVE + XCR0 bits 1 and 2)
+	//
+	const bool bOSXSave = (regs[2] & (1U << 27)) != 0;
+	const bool bAVX = (regs[2] & (1U << 28)) != 0;
+
+	if(bOSXSave && bAVX && maxLeaf >= 7)
+	{
+	#if defined(_MSC_VER)
+		const unsigned long long xcr0 = _xgetbv(0);
+		__cpuidex(info, 7, 0);
+		const unsigned int ebx7 = info[1];
+	#else
+		unsigned int xcrLow, xcrHigh;
+		__asm__ __volatile__ ("xgetbv" : "=a"(xcrLow), "=d"(xcrHigh) : "c"(0));
+		const unsigned long long xcr0 = xcrLow;
+		unsigned int eax7, ebx7, ecx7, edx7;
+		__cpuid_count(7, 0, eax7, ebx7, ecx7, edx7);
+	#endif
+		if((xcr0 & 0x6) == 0x6 && (ebx7 & (1U << 5)))
+		{
+			features |= AVX2;
+		}
+	}
+
+#endif //QC_X86_SIMD
+
+	return features;
+}
+
+QC_BASE_NAMESPACE_END
@@ -0,0 +1,99 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CpuFeatures
+// 
+// Overview
+// --------
+// The CpuFeatures class is a class module that reports the vector instruction
+// set extensions supported by the processor the library is running on.  It is
+// used to select optimized code paths at run-time.  It cannot be
+// instantiated - all methods are static.
+//
+//==============================================================================
+
+#ifndef QC_BASE_CpuFeatures_h
+#define QC_BASE_CpuFeatures_h
+
+#ifndef QC_BASE_DEFS_h
+#include "defs.h"
+#endif //QC_BASE_DEFS_h
+
+//
+// QC_X86_SIMD is defined when the target architecture is x86 or x86-64 and
+// the compiler is able to generate SSE/AVX code for individual functions.
+// When it is not defined, all vectorized code paths are compiled out and
+// the portable scalar implementations are always used.
+//
+#if !defined(QC_NO_SIMD)
+	#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)) && _MSC_VER >= 1700
+		#define QC_X86_SIMD 1
+		#define QC_TARGET_SSE2
+		#define QC_TARGET_SSE42
+		#define QC_TARGET_AVX2
+		#define QC_TARGET_PCLMUL
+	#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+	      (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) || defined(__clang__))
+		#define QC_X86_SIMD 1
+		#define QC_TARGET_SSE2  __attribute__((target("sse2")))
+		#define QC_TARGET_SSE42 __attribute__((target("sse4.2")))
+		#define QC_TARGET_AVX2  __attribute__((target("avx2")))
+		#define QC_TARGET_PCLMUL __attribute__((target("sse4.2,pclmul")))
+	#endif
+#endif //QC_NO_SIMD
+
+QC_BASE_NAMESPACE_BEGIN
+
+class QC_BASE_PKG CpuFeatures
+{
+public:
+
+	static bool HasSSE2();
+	static bool HasSSE41();
+	static bool HasSSE42();
+	static bool HasPCLMUL();
+	static bool HasAVX2();
+
+	enum Feature {SSE2   = 0x01,
+	              SSE41  = 0x02,
+	              SSE42  = 0x04,
+	              PCLMUL = 0x08,
+	              AVX2   = 0x10,
+	              Probed = 0x100};
+
+	static void Disable(unsigned long features);
+
+private:
+	CpuFeatures(); // not implemented
+
+	static unsigned long GetFeatures();
+	static unsigned long Probe();
+
+	static unsigned long QC_MT_VOLATILE s_features;
+};
+
+QC_BASE_NAMESPACE_END
+
+#endif //QC_BASE_CpuFeatures_h
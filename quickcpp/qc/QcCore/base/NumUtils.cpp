@@ -64,6 +64,20 @@ String NumUtils::ToString(unsigned long x)
 	return StringUtils::FromLatin1(StringUtils::Format("%lu", x));
 }
 
+//==============================================================================
+// NumUtils::ToString
+//
+/**
+   Converts the unsigned long long value @c x, such as a ::FileOffset, into
+   a String.
+*/
+//==============================================================================
+String NumUtils::ToString(unsigned long long x)
+{
+	return StringUtils::FromLatin1(StringUtils::Format("%llu", x));
+}
+
+
 //==============================================================================
 // NumUtils::ToString
 //
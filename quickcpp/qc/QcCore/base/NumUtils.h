@@ -42,6 +42,8 @@ public:
 	static String ToString(unsigned long x);
 	static String ToString(int x);
 	static String ToString(unsigned int x);
+	static String ToString(unsigned long long x);
+
 	static String ToString(time_t x);
 	static String ToString(double d);
 	static int ToInt(const String& str, int base=10);
@@ -53,9 +53,58 @@
 #include <stdio.h>
 #include <errno.h>
 
+#if defined(HAVE_NL_LANGINFO)
+#include <langinfo.h>
+#endif //HAVE_NL_LANGINFO
+
 
 QC_BASE_NAMESPACE_BEGIN
 
+#if defined(QC_UTF8)
+//==============================================================================
+// IsAsciiString
+//
+// Returns true if no member of [p, p+len) has its top bit set.  The test is
+// made a word at a time, which allows conversions between UTF-8 Strings and
+// 8-bit encodings to copy the (usual) all-ASCII String unchanged.
+//==============================================================================
+static bool IsAsciiString(const char* p, size_t len)
+{
+	const size_t highBits = ~size_t(0) / 0xFF * 0x80;
+	size_t acc = 0;
+	size_t i = 0;
+
+	for(; i + sizeof(size_t) <= len; i += sizeof(size_t))
+	{
+		size_t word;
+		::memcpy(&word, p + i, sizeof(word));
+		acc |= word;
+	}
+	for(; i < len; ++i)
+	{
+		acc |= (unsigned char)p[i];
+	}
+	return (acc & highBits) == 0;
+}
+
+//==============================================================================
+// IsUTF8Locale
+//
+// Returns true if the multi-byte encoding of the current locale is UTF-8, in
+// which case native strings need no conversion to or from internal Strings.
+//==============================================================================
+static bool IsUTF8Locale()
+{
+#if defined(HAVE_NL_LANGINFO)
+	const char* pCodeset = ::nl_langinfo(CODESET);
+	return pCodeset && (StringUtils::CompareNoCase(pCodeset, "UTF-8") == 0 ||
+	                    StringUtils::CompareNoCase(pCodeset, "UTF8") == 0);
+#else
+	return false;
+#endif //HAVE_NL_LANGINFO
+}
+#endif //QC_UTF8
+
 //==============================================================================
 // StringUtils::CompareNoCase
 //
@@ -273,6 +322,11 @@ String StringUtils::FromUTF8(const ByteString& str)
 //==============================================================================
 ByteString StringUtils::ToLatin1(const String& str)
 {
+#if defined(QC_UTF8)
+	if(IsAsciiString(str.data(), str.size()))
+		return str;
+#endif //QC_UTF8
+
 	AutoBuffer<Byte> workBuffer;
 	StringIterator i(str.data());
 	StringIterator end(str.data()+str.size());
@@ -308,6 +362,11 @@ ByteString StringUtils::ToLatin1(const String& str)
 //=============================================================================
 ByteString StringUtils::ToAscii(const String& str)
 {
+#if defined(QC_UTF8)
+	if(IsAsciiString(str.data(), str.size()))
+		return str;
+#endif //QC_UTF8
+
 	AutoBuffer<Byte> workBuffer;
 	StringIterator i(str.data());
 	StringIterator end(str.data()+str.size());
@@ -338,19 +397,7 @@ ByteString StringUtils::ToAscii(const String& str)
 //==============================================================================
 String StringUtils::FromLatin1(const char* pStr)
 {
-	String strRet;
-	size_t len = strlen(pStr);
-	strRet.reserve(len);
-	const unsigned char* iter = (const unsigned char*)pStr;
-	const unsigned char* end  = iter + len;
-
-	for(; iter!=end; ++iter)
-	{
-		// use unsigned so that we don't propogate the sign
-		Character x((UCS4Char)*iter);
-		x.appendToString(strRet);
-	}
-	return strRet;
+	return FromLatin1(pStr, strlen(pStr));
 }
 
 //==============================================================================
@@ -368,33 +415,49 @@ String StringUtils::FromLatin1(const char* pStr)
 //==============================================================================
 String StringUtils::FromLatin1(const char* pStr, size_t len)
 {
+	//
+	// If we are in wchar_t mode, then each Latin1 character can simply
+	// be padded with leading zeros and added to the string.  Otherwise
+	// we need to encode ISO-8859-1 into UTF-8, where US-ASCII is copied
+	// unchanged and every other character becomes a 2-byte sequence.
+	//
+#ifdef QC_UNICODE
+
+	// use unsigned so that we don't propogate the sign into the wide char
+	const unsigned char* pBegin = (const unsigned char*)pStr;
+	return String(pBegin, pBegin + len);
+
+#else
+
+	if(IsAsciiString(pStr, len))
+		return String(pStr, len);
+
 	String strRet;
-	strRet.reserve(len);
+	strRet.reserve(len + len / 4);
 
 	const char* iter = pStr;
 	const char* end  = pStr + len;
 
-	for(; iter!=end; ++iter)
+	while(iter != end)
 	{
+		const char* pRun = iter;
+		while(iter != end && (unsigned char)*iter < 0x80U)
+		{
+			++iter;
+		}
+		strRet.append(pRun, iter - pRun);
 
-		//
-		// If we are in wchar_t mode, then each Latin1 character can simply
-		// be padded with leading zeros and added to the string.  Otherwise
-		// we need to encode ISO-8859-1 into UTF-8 which is sufficiently
-		// complicated to enlist the help of the Character class.
-		//
-#ifdef QC_UNICODE
-		// use unsigned so that we don't propogate the sign into the wide char
-		CharType x = (unsigned char)(*iter);
-		strRet += x;
-#else
-		Character x((unsigned char)*iter);
-		x.appendToString(strRet);
-#endif
-
+		if(iter != end)
+		{
+			const unsigned char ch = (unsigned char)*iter++;
+			strRet += CharType(0xC0 | (ch >> 6));
+			strRet += CharType(0x80 | (ch & 0x3F));
+		}
 	}
 
 	return strRet;
+
+#endif
 }
 
 //==============================================================================
@@ -798,11 +861,12 @@ String StringUtils::FromNativeMBCS(const char* pStr)
 
 	//
 	// We are using UTF-8 internally, is the MBCS encoding UTF-8 also?
+	// If so there is nothing to do, otherwise assume Latin-1.
 	//
+	if(IsUTF8Locale())
+		return String(pStr, len);
 
-	// todo: detect locale character encoding for Unix/Linux
-	// assume Latin-1 for now
-	return FromLatin1(pStr);
+	return FromLatin1(pStr, len);
 
 #else
 
@@ -881,7 +945,9 @@ ByteString StringUtils::ToNativeMBCS(const String& str)
 
 #else
 
-	//todo: detect locale character encoding...
+	if(IsUTF8Locale())
+		return str;
+
 	return ToLatin1(str);
 
 #endif
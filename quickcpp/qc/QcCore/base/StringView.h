@@ -0,0 +1,257 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: StringView
+/**
+	@class qc::StringView
+	
+	@brief A read-only reference to a sequence of ::CharType characters
+	       owned by some other object.
+
+	A StringView does not copy or own the characters it refers to; it is
+	only valid for as long as the owner leaves them untouched.  It is used
+	to return text from an internal buffer without the cost of creating
+	a String.  Use toString() to make a copy that outlives the owner.
+*/
+//==============================================================================
+
+#ifndef QC_BASE_StringView_h
+#define QC_BASE_StringView_h
+
+#ifndef QC_BASE_DEFS_h
+#include "defs.h"
+#endif //QC_BASE_DEFS_h
+
+#include "String.h"
+#include "debug.h"
+
+#include <string.h>
+
+QC_BASE_NAMESPACE_BEGIN
+
+class StringView
+{
+public:
+	StringView();
+	StringView(const CharType* pData, size_t length);
+	StringView(const String& str);
+
+	const CharType* data() const;
+	size_t size() const;
+	size_t length() const;
+	bool empty() const;
+
+	const CharType* begin() const;
+	const CharType* end() const;
+	CharType operator[](size_t index) const;
+
+	String toString() const;
+
+	bool operator==(const StringView& rhs) const;
+	bool operator!=(const StringView& rhs) const;
+
+private:
+	const CharType* m_pData;
+	size_t m_length;
+};
+
+//==============================================================================
+// StringView::StringView
+//
+/**
+	Constructs an empty StringView.
+*/
+//==============================================================================
+inline
+	StringView::StringView() :
+	m_pData(0),
+	m_length(0)
+{
+}
+
+//==============================================================================
+// StringView::StringView
+//
+/**
+	Constructs a StringView referring to the @c length characters starting
+	at @c pData.
+*/
+//==============================================================================
+inline
+	StringView::StringView(const CharType* pData, size_t length) :
+	m_pData(pData),
+	m_length(length)
+{
+}
+
+//==============================================================================
+// StringView::StringView
+//
+/**
+	Constructs a StringView referring to the contents of @c str.  The view
+	is invalidated by any operation that modifies @c str.
+*/
+//==============================================================================
+inline
+	StringView::StringView(const String& str) :
+	m_pData(str.data()),
+	m_length(str.size())
+{
+}
+
+//==============================================================================
+// StringView::data
+//
+/**
+	Returns a pointer to the first character.  The characters are not
+	null-terminated.
+*/
+//==============================================================================
+inline
+	const CharType* StringView::data() const
+{
+	return m_pData;
+}
+
+//==============================================================================
+// StringView::size
+//
+/**
+	Returns the number of ::CharType characters in the view.
+*/
+//==============================================================================
+inline
+	size_t StringView::size() const
+{
+	return m_length;
+}
+
+//==============================================================================
+// StringView::length
+//
+/**
+	Synonym for size().
+*/
+//==============================================================================
+inline
+	size_t StringView::length() const
+{
+	return m_length;
+}
+
+//==============================================================================
+// StringView::empty
+//
+/**
+	Returns true if the view contains no characters.
+*/
+//==============================================================================
+inline
+	bool StringView::empty() const
+{
+	return (m_length == 0);
+}
+
+//==============================================================================
+// StringView::begin
+//
+/**
+	Returns a pointer to the first character.
+*/
+//==============================================================================
+inline
+	const CharType* StringView::begin() const
+{
+	return m_pData;
+}
+
+//==============================================================================
+// StringView::end
+//
+/**
+	Returns a pointer one past the last character.
+*/
+//==============================================================================
+inline
+	const CharType* StringView::end() const
+{
+	return m_pData + m_length;
+}
+
+//==============================================================================
+// StringView::operator[]
+//
+/**
+	Returns the character at position @c index, which must be less
+	than size().
+*/
+//==============================================================================
+inline
+	CharType StringView::operator[](size_t index) const
+{
+	QC_DBG_ASSERT(index < m_length);
+	return m_pData[index];
+}
+
+//==============================================================================
+// StringView::toString
+//
+/**
+	Returns a String containing a copy of the characters in the view.
+*/
+//==============================================================================
+inline
+	String StringView::toString() const
+{
+	return m_length ? String(m_pData, m_length) : String();
+}
+
+//==============================================================================
+// StringView::operator==
+//
+/**
+	Returns true if both views contain the same sequence of characters.
+*/
+//==============================================================================
+inline
+	bool StringView::operator==(const StringView& rhs) const
+{
+	return m_length == rhs.m_length
+	    && (m_length == 0 || ::memcmp(m_pData, rhs.m_pData, m_length*sizeof(CharType)) == 0);
+}
+
+//==============================================================================
+// StringView::operator!=
+//
+//==============================================================================
+inline
+	bool StringView::operator!=(const StringView& rhs) const
+{
+	return !(*this == rhs);
+}
+
+QC_BASE_NAMESPACE_END
+
+#endif //QC_BASE_StringView_h
@@ -69,11 +69,15 @@
 	standard @QuickCPP reference-counted object references can be created and stored.
 
     If you wish to synchronize against another SynchronizedObject, there
-	are two other macros to choose from:-
+	are three other macros to choose from:-
 	- @c QC_SYNCHRONIZED_PTR if the foreign object is guaranteed to exist
-	  for the lifetime of the scoped lock; or
+	  for the lifetime of the scoped lock;
 	- @c QC_SYNCHRONIZED_PTR_ADD which increments the reference count of
-	  the SynchronizedObject for the duration of the scoped lock.
+	  the SynchronizedObject for the duration of the scoped lock; or
+	- @c QC_SYNCHRONIZED_PTR_IF which behaves like @c QC_SYNCHRONIZED_PTR
+	  but only acquires the lock when a condition is true.  This is used by
+	  objects that can be switched into an unsynchronized mode, such as
+	  Reader::setSynchronized().
 
     @code
     void someSynchronizedFunction()
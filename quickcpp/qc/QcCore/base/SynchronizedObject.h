@@ -82,11 +82,17 @@ private:
 		AutoPtr<SynchronizedObject> _rp_object_(_p_object_);\
 		SynchronizedObject::Lock _scoped_lock_(*_p_object_);
 
+	#define QC_SYNCHRONIZED_PTR_IF(_LOCK_PTR, _CONDITION)\
+		QC_DBG_ASSERT(_LOCK_PTR!=0);\
+		SynchronizedObject* _p_object_ = _LOCK_PTR;\
+		SynchronizedObject::Lock _scoped_lock_(*_p_object_, (_CONDITION));
+
 #else
 
 	#define QC_SYNCHRONIZED
 	#define QC_SYNCHRONIZED_PTR(_LOCK_PTR)
 	#define QC_SYNCHRONIZED_PTR_ADD(_LOCK_PTR)
+	#define QC_SYNCHRONIZED_PTR_IF(_LOCK_PTR, _CONDITION)
 
 #endif //QC_MT
 
@@ -53,6 +53,8 @@
 #include "NullPointerException.h"
 #include "debug.h"
 
+#include <string.h>
+
 QC_BASE_NAMESPACE_BEGIN 
 
 static const size_t MaxEncodedSize = 4;
@@ -359,6 +361,24 @@ SystemCodeConverter::TestEncodedSequence(const CharType* from,
 
 	while(from!=from_end)
 	{
+#if defined(QC_UTF8)
+
+		//
+		// US-ASCII is always valid, so it is skipped a word at a time
+		//
+		while(from_end - from >= (ptrdiff_t)sizeof(size_t))
+		{
+			size_t word;
+			::memcpy(&word, from, sizeof(word));
+			if(word & (~size_t(0) / 0xFF * 0x80))
+				break;
+			from += sizeof(word);
+		}
+		if(from == from_end)
+			break;
+
+#endif //QC_UTF8
+
 		if(!IsSequenceStartChar(*from))
 			return error;
 
@@ -180,6 +180,7 @@ inline
 	bool SystemCodeConverter::IsValidCharSequence(const CharType* from, size_t len)
 {
 #if defined(QC_UTF8)
+	if(len == 1 && UCharType(*from) < 0x80U) return true;
 	return IsLegalUTF8((const Byte*)from, len);
 #elif defined(QC_UTF16)
 	return IsLegalUTF16((const wchar_t*)from, len);
@@ -112,6 +112,7 @@
 //==============================================================================
 
 #include "Thread.h"
+#include "BufferPool.h"
 #include "Tracer.h"
 #include "IllegalArgumentException.h"
 #include "IllegalThreadStateException.h"
@@ -305,6 +306,11 @@ void Thread::doRun()
 		Tracer::Trace(Tracer::Base, Tracer::High, traceMsg);
 	}
 
+	//
+	// Return any i/o buffers cached by this thread to the shared pool
+	//
+	BufferPool::ReleaseThreadCache();
+
 	setState(Terminated);
 
 	//
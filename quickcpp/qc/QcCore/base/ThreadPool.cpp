@@ -0,0 +1,329 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ThreadPool
+//
+/**
+	@class qc::ThreadPool
+	
+	@brief A fixed set of daemon threads that execute Runnable tasks.
+
+	Creating a Thread for every short-lived task can cost more than the task
+	itself.  A ThreadPool starts its threads once and then hands each task
+	passed to execute() to the next idle thread.  Tasks are started in the
+	order in which they were submitted.
+
+	A ThreadPool makes no attempt to report the outcome of a task.  A task
+	that needs to tell another thread that it has finished, or that it failed,
+	should do so itself, typically by updating a Monitor.  Exceptions that
+	escape from a task's @c run() method are traced and otherwise ignored.
+
+	The threads are @a daemon threads, so an application is not prevented
+	from terminating by an idle ThreadPool.  When a ThreadPool is destroyed
+	it waits for the tasks that have already been submitted to finish.
+
+	A shared pool with one thread per processor is available from
+	GetDefaultPool().
+
+	This class is only available in multi-threaded versions of the library,
+	with the exception of GetProcessorCount().
+*/
+//==============================================================================
+
+#include "ThreadPool.h"
+#include "IllegalStateException.h"
+#include "NullPointerException.h"
+#include "ObjectManager.h"
+#include "System.h"
+#include "Tracer.h"
+
+#ifdef WIN32
+	#include "winincl.h"
+#else // !WIN32
+	#include <unistd.h>
+#endif //WIN32
+
+QC_BASE_NAMESPACE_BEGIN
+
+#ifdef QC_MT
+
+//==================================================================
+// Multi-threaded locking strategy
+//
+// The task queue and the shutdown flag are protected by the pool's
+// Monitor.  Worker threads wait on the Monitor while the queue is
+// empty.
+//
+// Update access to the default pool is mutex protected, but to 
+// minimise the runtime cost, read access is not protected.
+//==================================================================
+
+FastMutex ThreadPoolMutex;
+
+ThreadPool* QC_MT_VOLATILE ThreadPool::s_pDefaultPool = NULL;
+
+//==============================================================================
+// Class: ThreadPool::Worker
+//
+// The Runnable executed by each of the pool's threads.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ThreadPool::Worker : public Runnable
+{
+public:
+	Worker(ThreadPool* pPool) : m_pPool(pPool) {}
+
+	virtual void run()
+	{
+		AutoPtr<Runnable> rpTask;
+		while((rpTask = m_pPool->takeTask()) )
+		{
+			try
+			{
+				rpTask->run();
+			}
+			catch(Exception& e)
+			{
+				if(Tracer::IsEnabled())
+				{
+					Tracer::Trace(Tracer::Base, Tracer::Exceptions, e.toString());
+				}
+			}
+			rpTask.release();
+		}
+	}
+
+private:
+	ThreadPool* m_pPool; // the pool outlives its threads
+};
+
+//==============================================================================
+// ThreadPool::ThreadPool
+//
+/**
+   Constructs a ThreadPool and starts @c numThreads threads.
+
+   @param numThreads the number of threads.  If zero, one thread is started
+          for each processor.
+*/
+//==============================================================================
+ThreadPool::ThreadPool(size_t numThreads) :
+	m_bShutdown(false)
+{
+	if(numThreads == 0)
+	{
+		numThreads = GetProcessorCount();
+	}
+
+	m_threads.reserve(numThreads);
+
+	for(size_t i=0; i<numThreads; ++i)
+	{
+		AutoPtr<Thread> rpThread = new Thread(new Worker(this));
+		rpThread->setDaemon(true);
+		rpThread->start();
+		m_threads.push_back(rpThread);
+	}
+}
+
+//==============================================================================
+// ThreadPool::~ThreadPool
+//
+/**
+   Destructor.  Waits for the tasks that have been submitted to finish and
+   for the threads to terminate.
+*/
+//==============================================================================
+ThreadPool::~ThreadPool()
+{
+	try
+	{
+		shutdown();
+	}
+	catch(Exception& /*e*/)
+	{
+	}
+}
+
+//==============================================================================
+// ThreadPool::execute
+//
+/**
+   Submits @c pTask to be run by one of the pool's threads.
+
+   The ThreadPool holds a counted reference to the task until it has run.
+
+   @param pTask the task to run
+   @throws NullPointerException if @c pTask is null.
+   @throws IllegalStateException if the pool has been shut down.
+   @mtsafe
+*/
+//==============================================================================
+void ThreadPool::execute(Runnable* pTask)
+{
+	if(!pTask) throw NullPointerException();
+
+	AutoPtr<Runnable> rpTask(pTask);
+
+	QC_SYNCHRONIZED
+
+	if(m_bShutdown)
+	{
+		throw IllegalStateException(QC_T("thread pool has been shut down"));
+	}
+
+	m_taskQueue.push_back(rpTask);
+	notify();
+}
+
+//==============================================================================
+// ThreadPool::shutdown
+//
+/**
+   Stops the pool from accepting new tasks and waits for the tasks that have
+   already been submitted to finish.
+
+   This function must not be called by one of the pool's own tasks.
+   @mtsafe
+*/
+//==============================================================================
+void ThreadPool::shutdown()
+{
+	ThreadVector threads;
+
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+		m_bShutdown = true;
+		threads.swap(m_threads);
+		notifyAll();
+	}
+
+	for(ThreadVector::iterator i=threads.begin(); i!=threads.end(); ++i)
+	{
+		(*i)->join();
+	}
+}
+
+//==============================================================================
+// ThreadPool::getThreadCount
+//
+/**
+   Returns the number of threads started by this ThreadPool.
+   @mtsafe
+*/
+//==============================================================================
+size_t ThreadPool::getThreadCount() const
+{
+	QC_SYNCHRONIZED
+	return m_threads.size();
+}
+
+//==============================================================================
+// ThreadPool::takeTask
+//
+// Called by a Worker to remove the next task from the queue, waiting until
+// one is available.  Returns null when the pool has been shut down and the
+// queue is empty.
+//==============================================================================
+AutoPtr<Runnable> ThreadPool::takeTask()
+{
+	QC_SYNCHRONIZED
+
+	while(m_taskQueue.empty() && !m_bShutdown)
+	{
+		wait();
+	}
+
+	AutoPtr<Runnable> rpTask;
+	if(!m_taskQueue.empty())
+	{
+		rpTask = m_taskQueue.front();
+		m_taskQueue.pop_front();
+	}
+	return rpTask;
+}
+
+//==============================================================================
+// ThreadPool::GetDefaultPool
+//
+/**
+   Returns the global ThreadPool, creating it with one thread per processor
+   when it is first requested.
+
+   The pool is registered with the system's ObjectManager, which shuts it
+   down during System::Terminate().
+   @mtsafe
+*/
+//==============================================================================
+AutoPtr<ThreadPool> ThreadPool::GetDefaultPool()
+{
+	//==================================================================
+	// Multi-threaded locking strategy
+	//
+	// This uses the "double-checked locking pattern" (Schmidt 1996)
+	// with a volatile storage member to minimise race conditions due
+	// to the so-called "relaxed memory model"..
+	//==================================================================
+	if(s_pDefaultPool == NULL)
+	{
+		QC_AUTO_LOCK(FastMutex, ThreadPoolMutex);
+		if(s_pDefaultPool == NULL)
+		{
+			s_pDefaultPool = new ThreadPool(0);
+			// registerObject() will increment the new object's ref count
+			System::GetObjectManager().registerObject(s_pDefaultPool);
+		}
+	}
+	return s_pDefaultPool;
+}
+
+#endif //QC_MT
+
+//==============================================================================
+// ThreadPool::GetProcessorCount
+//
+/**
+   Returns the number of processors available to the application, or 1 if it
+   cannot be determined.
+*/
+//==============================================================================
+size_t ThreadPool::GetProcessorCount()
+{
+	long count = 1;
+
+#if defined(WIN32)
+	SYSTEM_INFO info;
+	::GetSystemInfo(&info);
+	count = info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+	count = ::sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+	return (count > 0) ? size_t(count) : 1;
+}
+
+QC_BASE_NAMESPACE_END
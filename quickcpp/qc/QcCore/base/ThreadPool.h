@@ -0,0 +1,98 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ThreadPool
+// 
+//==============================================================================
+
+#ifndef QC_BASE_ThreadPool_h
+#define QC_BASE_ThreadPool_h
+
+#ifndef QC_BASE_DEFS_h
+#include "defs.h"
+#endif //QC_BASE_DEFS_h
+
+#include "AutoPtr.h"
+#include "Monitor.h"
+#include "Runnable.h"
+
+#ifdef QC_MT
+
+#include "Thread.h"
+
+#include <deque>
+#include <vector>
+
+#endif //QC_MT
+
+QC_BASE_NAMESPACE_BEGIN
+
+class QC_BASE_PKG ThreadPool : public Monitor
+{
+public: // static functions available in single-threaded versions
+
+	static size_t GetProcessorCount();
+
+	//
+	// Everything from here is only present in multi-threaded
+	// versions of the library
+	//
+#ifdef QC_MT
+
+public:
+	ThreadPool(size_t numThreads);
+	virtual ~ThreadPool();
+
+	void execute(Runnable* pTask);
+	void shutdown();
+	size_t getThreadCount() const;
+
+	static AutoPtr<ThreadPool> GetDefaultPool();
+
+private:
+	ThreadPool(const ThreadPool& rhs);            // not implemented
+	ThreadPool& operator=(const ThreadPool& rhs); // not implemented
+
+	class Worker;
+	friend class Worker;
+
+	AutoPtr<Runnable> takeTask();
+
+private:
+	typedef std::deque< AutoPtr<Runnable> > TaskQueue;
+	typedef std::vector< AutoPtr<Thread> > ThreadVector;
+
+	TaskQueue m_taskQueue;
+	ThreadVector m_threads;
+	bool m_bShutdown;
+
+	static ThreadPool* QC_MT_VOLATILE s_pDefaultPool;
+
+#endif //QC_MT
+};
+
+QC_BASE_NAMESPACE_END
+
+#endif //QC_BASE_ThreadPool_h
@@ -144,6 +144,19 @@ typedef unsigned short UShort;
 //==============================================================================
 typedef QC_INT_TYPE IntType;
 
+//==============================================================================
+//  typedef: FileOffset
+/**
+	Represents an offset or a length within a file.
+
+	Files may be larger than the address space of the process, so a
+	@c FileOffset is always a 64-bit unsigned value even on platforms where
+	@c size_t is only 32 bits wide.
+*/
+//==============================================================================
+typedef unsigned long long FileOffset;
+
+
 QC_BASE_NAMESPACE_END
 
 #endif //QC_BASE_DEFS_h
@@ -115,12 +115,18 @@ namespace N {
 
 //
 // QuickCPP is currently configured to use either char or wchar_t as its
-// character type.  The default is char, but wchar_t is selected if the QC_UNICODE
-// macro is defined
+// character type.  The default is wchar_t (QC_UNICODE), but char with a UTF-8
+// internal encoding is selected if the QC_UTF8 macro is defined.  On
+// platforms with a 4-byte wchar_t the UTF-8 configuration uses a quarter of
+// the memory for US-ASCII text and decodes UTF-8 input without widening it.
 //
 #ifndef QC_DOCUMENTATION_ONLY
 
-#ifndef QC_UNICODE
+#if defined(QC_UNICODE) && defined(QC_UTF8)
+	#error QC_UNICODE and QC_UTF8 cannot both be defined
+#endif
+
+#if !defined(QC_UNICODE) && !defined(QC_UTF8)
 #define QC_UNICODE 1
 #endif
 
@@ -172,7 +178,9 @@ namespace N {
 	#define QC_INT_TYPE int
 	#define QC_T(t) t
 	#define QC_MAX_CHAR 0x10FFFF
+	#ifndef QC_UTF8
 	#define QC_UTF8
+	#endif
 	#undef  QC_UTF16
 	#undef  QC_UCS4
 	#undef  QC_UCS2
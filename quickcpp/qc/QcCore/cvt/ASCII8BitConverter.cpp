@@ -29,7 +29,8 @@
 // mapping the 256 values to specific Unicode characters.
 //
 // This class implements a general-purpose, table-driven approach
-// to encoding and decoding these values.
+// to encoding and decoding these values.  The tables are held in a
+// CodePageTable which is shared by all converters for the same code page.
 //
 //==============================================================================
 
@@ -39,8 +40,6 @@
 
 QC_CVT_NAMESPACE_BEGIN
 
-const ASCII8BitConverter::CodedChar UNDEFINED = 0xFFFF;
-
 ASCII8BitConverter::ASCII8BitConverter(const String& name,
                                        const CodedChar decodingTable[128]) :
 	m_pDecodingTable(decodingTable),
@@ -55,14 +54,7 @@ ASCII8BitConverter::ASCII8BitConverter(const String& name,
 //==============================================================================
 void ASCII8BitConverter::generateEncodingMap()
 {
-	for(size_t i=0; i<128; ++i)
-	{
-		const CodedChar theChar = m_pDecodingTable[i];
-		if(theChar != UNDEFINED)
-		{
-			m_encodingMap[theChar] = Byte(i+128);
-		}
-	}
+	m_rpTable = CodePageTable::GetTable(m_pDecodingTable, true);
 }
 
 //==============================================================================
@@ -83,11 +75,30 @@ CodeConverter::Result ASCII8BitConverter::decode(const Byte *from, const Byte *f
 	//
 	while(ret == ok && from_next < from_end && to_next < to_limit)
 	{
+#if !defined(QC_UTF8)
+		//
+		// Decode as much as possible using the table, stopping
+		// at the first undefined byte
+		//
+		size_t runLen = from_end - from_next;
+		if(runLen > size_t(to_limit - to_next))
+			runLen = to_limit - to_next;
+
+		runLen = m_rpTable->decodeRun(from_next, runLen, to_next);
+		from_next += runLen;
+		to_next += runLen;
+
+		if(from_next == from_end || to_next == to_limit)
+		{
+			break;
+		}
+#endif //QC_UTF8
+
 		if(*from_next & 0x80)
 		{
-			const CodedChar nextChar = m_pDecodingTable[(*from_next) & 0x7F];
+			const UCS4Char nextChar = m_rpTable->decodeByte(*from_next);
 
-			if(nextChar == UNDEFINED)
+			if(nextChar == CodePageTable::Undefined)
 			{
 				if(getInvalidCharAction() == abort)
 				{
@@ -143,17 +154,30 @@ CodeConverter::Result ASCII8BitConverter::encode(const CharType *from, const Cha
 	//
 	while(from_next < from_end && to_next < to_limit && ret == ok)
 	{
+#if !defined(QC_UTF8)
+		//
+		// Characters below the surrogate range are always represented
+		// by a single internal character, so can be looked up directly
+		//
+		Byte mapped;
+		if(UCS4Char(*from_next) < 0xD800U && m_rpTable->encodeChar(UCS4Char(*from_next), mapped))
+		{
+			*to_next++ = mapped;
+			++from_next;
+			continue;
+		}
+#endif //QC_UTF8
+
 		UCS4Char ch;
 		const CharType * from_next_copy;
 		if( (ret=SystemCodeConverter::FromInternalEncoding(ch, from_next, from_end, from_next_copy)) == ok)
 		{
 			if(ch > 0x7F)
 			{
-				EncodingMap::const_iterator iter;
-
-				if((ch <= 0xFFFFU) && ( (iter = m_encodingMap.find(CodedChar(ch))) != m_encodingMap.end()))
+				Byte b;
+				if(m_rpTable->encodeChar(ch, b))
 				{
-					*to_next++ = (*iter).second;
+					*to_next++ = b;
 					from_next = from_next_copy;
 				}
 				else // the character is not in the map
@@ -194,6 +218,17 @@ bool ASCII8BitConverter::alwaysNoConversion() const
 	return (false);
 }
 
+//==============================================================================
+// ASCII8BitConverter::findCharBoundary
+//
+// Every byte is a complete character.
+//==============================================================================
+const Byte* ASCII8BitConverter::findCharBoundary(const Byte* /*from*/, const Byte* /*from_end*/,
+                                                 const Byte* pos) const
+{
+	return pos;
+}
+
 size_t ASCII8BitConverter::getMaxEncodedLength() const
 {
 	return 1;
@@ -208,5 +243,14 @@ String ASCII8BitConverter::getEncodingName() const
 	return m_name;
 }
 
+//==============================================================================
+// ASCII8BitConverter::clone
+//
+//==============================================================================
+AutoPtr<CodeConverter> ASCII8BitConverter::clone() const
+{
+	return new ASCII8BitConverter(*this);
+}
+
 QC_CVT_NAMESPACE_END
 
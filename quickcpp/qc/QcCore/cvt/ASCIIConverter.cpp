@@ -149,6 +149,17 @@ bool ASCIIConverter::alwaysNoConversion() const
 	return (false);
 }
 
+//==============================================================================
+// ASCIIConverter::findCharBoundary
+//
+// Every byte is a complete character.
+//==============================================================================
+const Byte* ASCIIConverter::findCharBoundary(const Byte* /*from*/, const Byte* /*from_end*/,
+                                             const Byte* pos) const
+{
+	return pos;
+}
+
 size_t ASCIIConverter::getMaxEncodedLength() const
 {
 	return 1;
@@ -163,5 +174,14 @@ String ASCIIConverter::getEncodingName() const
 	return QC_T("US-ASCII");
 }
 
+//==============================================================================
+// ASCIIConverter::clone
+//
+//==============================================================================
+AutoPtr<CodeConverter> ASCIIConverter::clone() const
+{
+	return new ASCIIConverter(*this);
+}
+
 QC_CVT_NAMESPACE_END
 
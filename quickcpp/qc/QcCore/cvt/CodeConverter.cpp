@@ -46,6 +46,7 @@
 
 #include "QcCore/base/IllegalCharacterException.h"
 #include "QcCore/base/SystemCodeConverter.h"
+#include "QcCore/base/UnsupportedOperationException.h"
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/io/CharacterCodingException.h"
 #include "QcCore/io/MalformedInputException.h"
@@ -159,6 +160,35 @@ size_t CodeConverter::getDecodedLength(const Byte *from, const Byte *from_end) c
 	return from_end - from;
 }
 
+//==============================================================================
+// CodeConverter::findCharBoundary
+//
+/**
+   Returns the first position at or after @c pos at which an encoded
+   character sequence begins.
+
+   Decoding may start afresh at the returned position, which allows a large
+   array of bytes to be divided into pieces that are decoded independently.
+   The position @c from must itself be the start of a sequence; it is used
+   by encodings whose sequences are aligned, such as UTF-16.
+
+   The base class cannot tell where its sequences begin and returns null.
+   Derived classes that are able to resynchronize should override this
+   method.
+
+   @param from pointer to the start of an encoded array of bytes
+   @param from_end pointer to the next byte after the end of the array
+   @param pos the position to search from, between @c from and @c from_end
+   @returns a position between @c pos and @c from_end, or null if the
+            converter cannot determine where its sequences begin
+*/
+//==============================================================================
+const Byte* CodeConverter::findCharBoundary(const Byte* /*from*/, const Byte* /*from_end*/,
+                                            const Byte* /*pos*/) const
+{
+	return 0;
+}
+
 //==============================================================================
 // CodeConverter::getMaxEncodedLength
 //
@@ -201,6 +231,27 @@ String CodeConverter::getEncodingName() const
 	return String();
 }
 
+//==============================================================================
+// CodeConverter::clone
+//
+/**
+   Returns a new CodeConverter of the same type and with the same settings
+   as this one.
+
+   The CodeConverterFactory creates CodeConverters by cloning a registered
+   prototype, so derived classes that are registered with
+   CodeConverterFactory::registerConverter() must override this method.
+
+   @throws UnsupportedOperationException if the derived class does not
+           support cloning
+   @sa CodeConverterFactory::registerConverter()
+*/
+//==============================================================================
+AutoPtr<CodeConverter> CodeConverter::clone() const
+{
+	throw UnsupportedOperationException(QC_T("CodeConverter::clone"));
+}
+
 //==============================================================================
 // CodeConverter::setInvalidCharAction
 //
@@ -34,10 +34,23 @@
 	is aware of the supplied encodings, and will return an appropriate
 	CodeConverter instance for every encoding name that it recognizes.
 
-    Applications can extend @QuickCPP by supplementing their own encodings.  To
-	achieve this the application must create a new factory class @a derived
-	from CodeConverterFactory and set an instance of the @a derived class as
-	the global CodeConverterFactory by calling SetInstance().
+    Encoding names are matched without regard to case or punctuation, so
+	that "UTF-8", "utf8" and "UTF_8" all select the same CodeConverter.  The
+	common IANA aliases for each encoding (such as "latin1" and "cp1252")
+	are also recognized.
+
+    CodeConverters are not created from scratch each time one is requested.
+	Instead the factory holds a prototype for each encoding, and returns a
+	clone of it.  Converters for single-byte code pages share their
+	translation tables, so cloning them is very cheap.
+
+    Applications can extend @QuickCPP by supplementing their own encodings.
+	This is achieved by registering a prototype CodeConverter under the
+	encoding name using registerConverter(), and optionally registering
+	aliases for the name using registerAlias().  Alternatively the application
+	can create a new factory class @a derived from CodeConverterFactory and set
+	an instance of the @a derived class as the global CodeConverterFactory
+	by calling SetInstance().
 */
 //==============================================================================
 
@@ -49,6 +62,8 @@
 #include "ASCII8BitConverter.h"
 
 #include "QcCore/base/FastMutex.h"
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/NullPointerException.h"
 #include "QcCore/base/ObjectManager.h"
 #include "QcCore/base/System.h"
 #include "QcCore/base/StringUtils.h"
@@ -97,6 +112,235 @@ CodeConverterFactory* QC_MT_VOLATILE CodeConverterFactory::s_pInstance = NULL;
 #include "ISO-8859-16.tab"
 
 
+//==============================================================================
+// Standard encodings
+//
+// The canonical names of the encodings supplied with QuickCPP, followed by
+// their aliases.  The aliases are taken from the IANA character set registry,
+// plus a few (such as "cp1252") that are in widespread use.
+//==============================================================================
+struct StandardAliases
+{
+	const CharType* name;
+	const CharType* aliases[12];
+};
+
+static const StandardAliases StandardNames[] =
+{
+	{QC_T("ISO-8859-1"),   {QC_T("ISO_8859-1:1987"), QC_T("iso-ir-100"), QC_T("latin1"), QC_T("l1"), QC_T("IBM819"), QC_T("CP819"), QC_T("csISOLatin1"), 0}},
+	{QC_T("UTF-8"),        {QC_T("csUTF8"), QC_T("unicode-1-1-utf-8"), 0}},
+	{QC_T("US-ASCII"),     {QC_T("ASCII"), QC_T("iso-ir-6"), QC_T("ANSI_X3.4-1968"), QC_T("ANSI_X3.4-1986"), QC_T("ISO_646.irv:1991"), QC_T("ISO646-US"), QC_T("us"), QC_T("IBM367"), QC_T("cp367"), QC_T("csASCII"), 0}},
+	{QC_T("UTF-16BE"),     {QC_T("csUTF16BE"), 0}},
+	{QC_T("UTF-16LE"),     {QC_T("csUTF16LE"), 0}},
+	{QC_T("UTF-16"),       {QC_T("csUTF16"), 0}},
+	{QC_T("windows-1250"), {QC_T("cp1250"), QC_T("cswindows1250"), 0}},
+	{QC_T("windows-1251"), {QC_T("cp1251"), QC_T("cswindows1251"), 0}},
+	{QC_T("windows-1252"), {QC_T("cp1252"), QC_T("cswindows1252"), 0}},
+	{QC_T("windows-1253"), {QC_T("cp1253"), QC_T("cswindows1253"), 0}},
+	{QC_T("windows-1254"), {QC_T("cp1254"), QC_T("cswindows1254"), 0}},
+	{QC_T("windows-1255"), {QC_T("cp1255"), QC_T("cswindows1255"), 0}},
+	{QC_T("windows-1256"), {QC_T("cp1256"), QC_T("cswindows1256"), 0}},
+	{QC_T("windows-1257"), {QC_T("cp1257"), QC_T("cswindows1257"), 0}},
+	{QC_T("windows-1258"), {QC_T("cp1258"), QC_T("cswindows1258"), 0}},
+	{QC_T("ISO-8859-2"),   {QC_T("ISO_8859-2:1987"), QC_T("iso-ir-101"), QC_T("latin2"), QC_T("l2"), QC_T("csISOLatin2"), 0}},
+	{QC_T("ISO-8859-3"),   {QC_T("ISO_8859-3:1988"), QC_T("iso-ir-109"), QC_T("latin3"), QC_T("l3"), QC_T("csISOLatin3"), 0}},
+	{QC_T("ISO-8859-4"),   {QC_T("ISO_8859-4:1988"), QC_T("iso-ir-110"), QC_T("latin4"), QC_T("l4"), QC_T("csISOLatin4"), 0}},
+	{QC_T("ISO-8859-5"),   {QC_T("ISO_8859-5:1988"), QC_T("iso-ir-144"), QC_T("cyrillic"), QC_T("csISOLatinCyrillic"), 0}},
+	{QC_T("ISO-8859-6"),   {QC_T("ISO_8859-6:1987"), QC_T("iso-ir-127"), QC_T("ECMA-114"), QC_T("ASMO-708"), QC_T("arabic"), QC_T("csISOLatinArabic"), 0}},
+	{QC_T("ISO-8859-7"),   {QC_T("ISO_8859-7:1987"), QC_T("iso-ir-126"), QC_T("ELOT_928"), QC_T("ECMA-118"), QC_T("greek"), QC_T("greek8"), QC_T("csISOLatinGreek"), 0}},
+	{QC_T("ISO-8859-8"),   {QC_T("ISO_8859-8:1988"), QC_T("iso-ir-138"), QC_T("hebrew"), QC_T("csISOLatinHebrew"), 0}},
+	{QC_T("ISO-8859-9"),   {QC_T("ISO_8859-9:1989"), QC_T("iso-ir-148"), QC_T("latin5"), QC_T("l5"), QC_T("csISOLatin5"), 0}},
+	{QC_T("ISO-8859-10"),  {QC_T("iso-ir-157"), QC_T("l6"), QC_T("latin6"), QC_T("csISOLatin6"), 0}},
+	{QC_T("ISO-8859-13"),  {QC_T("csISO885913"), 0}},
+	{QC_T("ISO-8859-14"),  {QC_T("iso-ir-199"), QC_T("ISO_8859-14:1998"), QC_T("latin8"), QC_T("iso-celtic"), QC_T("l8"), QC_T("csISO885914"), 0}},
+	{QC_T("ISO-8859-15"),  {QC_T("Latin-9"), QC_T("csISO885915"), 0}},
+	{QC_T("ISO-8859-16"),  {QC_T("iso-ir-226"), QC_T("ISO_8859-16:2001"), QC_T("latin10"), QC_T("l10"), QC_T("csISO885916"), 0}},
+	{QC_T("IBM850"),       {QC_T("cp850"), QC_T("850"), QC_T("csPC850Multilingual"), 0}},
+	{0, {0}}
+};
+
+//==============================================================================
+// CodeConverterFactory::CodeConverterFactory
+//
+/**
+   Constructs a CodeConverterFactory that recognizes all of the encodings
+   supplied with @QuickCPP.
+*/
+//==============================================================================
+CodeConverterFactory::CodeConverterFactory()
+{
+	registerStandardConverters();
+}
+
+//==============================================================================
+// CodeConverterFactory::registerStandardConverters
+//
+// Private helper function to register the supplied encodings and their
+// aliases.  Prototypes for the single-byte code pages are not created until
+// they are first requested.
+//==============================================================================
+void CodeConverterFactory::registerStandardConverters()
+{
+	struct CodePageEntry
+	{
+		const CharType* name;
+		CodePage* table;
+	};
+
+	static const CodePageEntry codePages[] = 
+	{
+		{QC_T("windows-1250"), &Encode_CP1250_Table},
+		{QC_T("windows-1251"), &Encode_CP1251_Table},
+		{QC_T("windows-1252"), &Encode_CP1252_Table},
+		{QC_T("windows-1253"), &Encode_CP1253_Table},
+		{QC_T("windows-1254"), &Encode_CP1254_Table},
+		{QC_T("windows-1255"), &Encode_CP1255_Table},
+		{QC_T("windows-1256"), &Encode_CP1256_Table},
+		{QC_T("windows-1257"), &Encode_CP1257_Table},
+		{QC_T("windows-1258"), &Encode_CP1258_Table},
+		{QC_T("ISO-8859-2"),   &Encode_8859_2_Table},
+		{QC_T("ISO-8859-3"),   &Encode_8859_3_Table},
+		{QC_T("ISO-8859-4"),   &Encode_8859_4_Table},
+		{QC_T("ISO-8859-5"),   &Encode_8859_5_Table},
+		{QC_T("ISO-8859-6"),   &Encode_8859_6_Table},
+		{QC_T("ISO-8859-7"),   &Encode_8859_7_Table},
+		{QC_T("ISO-8859-8"),   &Encode_8859_8_Table},
+		{QC_T("ISO-8859-9"),   &Encode_8859_9_Table},
+		{QC_T("ISO-8859-10"),  &Encode_8859_10_Table},
+		{QC_T("ISO-8859-13"),  &Encode_8859_13_Table},
+		{QC_T("ISO-8859-14"),  &Encode_8859_14_Table},
+		{QC_T("ISO-8859-15"),  &Encode_8859_15_Table},
+		{QC_T("ISO-8859-16"),  &Encode_8859_16_Table},
+		{QC_T("IBM850"),       &Encode_IBM_850_Table},
+		{0, 0}
+	};
+
+	addName(NormalizeName(QC_T("ISO-8859-1")), addRegistration(QC_T("ISO-8859-1"), 0, new ISO88591Converter));
+	addName(NormalizeName(QC_T("UTF-8")),      addRegistration(QC_T("UTF-8"),      0, new UTF8Converter));
+	addName(NormalizeName(QC_T("US-ASCII")),   addRegistration(QC_T("US-ASCII"),   0, new ASCIIConverter));
+	addName(NormalizeName(QC_T("UTF-16BE")),   addRegistration(QC_T("UTF-16BE"),   0, new UTF16Converter(UTF16Converter::big_endian)));
+	addName(NormalizeName(QC_T("UTF-16LE")),   addRegistration(QC_T("UTF-16LE"),   0, new UTF16Converter(UTF16Converter::little_endian)));
+	addName(NormalizeName(QC_T("UTF-16")),     addRegistration(QC_T("UTF-16"),     0, new UTF16Converter()));
+
+	size_t i;
+	for(i=0; codePages[i].name; ++i)
+	{
+		addName(NormalizeName(codePages[i].name),
+		        addRegistration(codePages[i].name, codePages[i].table, 0));
+	}
+
+	for(i=0; StandardNames[i].name; ++i)
+	{
+		const NameEntry* pEntry = findName(NormalizeName(StandardNames[i].name));
+		QC_DBG_ASSERT(pEntry != 0);
+		
+		for(size_t j=0; StandardNames[i].aliases[j]; ++j)
+		{
+			addName(NormalizeName(StandardNames[i].aliases[j]), pEntry->index);
+		}
+	}
+}
+
+//==============================================================================
+// CodeConverterFactory::addRegistration
+//
+// Private helper function.  Returns the index of the new registration.
+//==============================================================================
+size_t CodeConverterFactory::addRegistration(const String& name, CodePage* pCodePage,
+                                             CodeConverter* pPrototype)
+{
+	Registration registration;
+	registration.name = name;
+	registration.pCodePage = pCodePage;
+	registration.rpPrototype = pPrototype;
+	m_registrations.push_back(registration);
+	return m_registrations.size() - 1;
+}
+
+//==============================================================================
+// CodeConverterFactory::addName
+//
+// Private helper function to map a normalized name onto a registration,
+// replacing any existing mapping for the name.
+//==============================================================================
+void CodeConverterFactory::addName(const String& key, size_t index)
+{
+	NameBucket& bucket = m_names[HashName(key) % NumBuckets];
+
+	for(NameBucket::iterator iter = bucket.begin(); iter != bucket.end(); ++iter)
+	{
+		if((*iter).key == key)
+		{
+			(*iter).index = index;
+			return;
+		}
+	}
+
+	NameEntry entry;
+	entry.key = key;
+	entry.index = index;
+	bucket.push_back(entry);
+}
+
+//==============================================================================
+// CodeConverterFactory::findName
+//
+// Private helper function to look up a normalized name.
+//==============================================================================
+const CodeConverterFactory::NameEntry* CodeConverterFactory::findName(const String& key) const
+{
+	const NameBucket& bucket = m_names[HashName(key) % NumBuckets];
+
+	for(NameBucket::const_iterator iter = bucket.begin(); iter != bucket.end(); ++iter)
+	{
+		if((*iter).key == key)
+		{
+			return &(*iter);
+		}
+	}
+	return 0;
+}
+
+//==============================================================================
+// CodeConverterFactory::NormalizeName
+//
+// Returns the key under which an encoding name is registered.  Following
+// the charset alias matching rules of Unicode Technical Standard #22, all
+// characters other than ASCII letters and digits are ignored and letters
+// are compared without regard to case.
+//==============================================================================
+String CodeConverterFactory::NormalizeName(const String& encoding)
+{
+	String key;
+	key.reserve(encoding.size());
+
+	for(String::const_iterator iter = encoding.begin(); iter != encoding.end(); ++iter)
+	{
+		const CharType ch = *iter;
+		if(ch >= 'A' && ch <= 'Z')
+			key += CharType(ch - 'A' + 'a');
+		else if((ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9'))
+			key += ch;
+	}
+	return key;
+}
+
+//==============================================================================
+// CodeConverterFactory::HashName
+//
+// FNV-1a hash of a normalized name.
+//==============================================================================
+size_t CodeConverterFactory::HashName(const String& key)
+{
+	unsigned long hash = 2166136261UL;
+
+	for(String::const_iterator iter = key.begin(); iter != key.end(); ++iter)
+	{
+		hash = ((hash ^ (unsigned long)(*iter)) * 16777619UL) & 0xFFFFFFFFUL;
+	}
+	return size_t(hash);
+}
+
 //==============================================================================
 // CodeConverterFactory::GetInstance
 //
@@ -197,84 +441,105 @@ void CodeConverterFactory::SetInstance(CodeConverterFactory* pFactory)
 
    @param encoding the name of the encoding which is used to 
           select a matching CodeConverter without regard to case
+          or punctuation
+   @returns a new CodeConverter or null if the encoding is not recognized
    @mtsafe
 */
 //==============================================================================
 AutoPtr<CodeConverter> CodeConverterFactory::getConverter(const String& encoding) const
 {
-	//
-	// First check if the requested encoding matches one of the custom encoders.
-	//
-	if(StringUtils::CompareNoCase(encoding, QC_T("ISO-8859-1")) == 0)
-		return new ISO88591Converter;
-	else if(StringUtils::CompareNoCase(encoding, QC_T("UTF-8")) == 0)
-		return new UTF8Converter;
-	else if(StringUtils::CompareNoCase(encoding, QC_T("US-ASCII")) == 0)
-		return new ASCIIConverter;
-	else if(StringUtils::CompareNoCase(encoding, QC_T("ASCII")) == 0)
-		return new ASCIIConverter;
-	else if(StringUtils::CompareNoCase(encoding, QC_T("UTF-16BE")) == 0)
-		return new UTF16Converter(UTF16Converter::big_endian);
-	else if(StringUtils::CompareNoCase(encoding, QC_T("UTF-16LE")) == 0)
-		return new UTF16Converter(UTF16Converter::little_endian);
-	else if(StringUtils::CompareNoCase(encoding, QC_T("UTF-16")) == 0)
-		return new UTF16Converter();
+	const String key = NormalizeName(encoding);
 
-	//
-	// None of the custom encodings match.  What about the ASCII-boys?
-	// These all share the ASCII encodings up to 0x7F, but above that they
-	// are all different.
-	//
-	struct EncodingTableEntry
+	QC_AUTO_LOCK(FastMutex, m_mutex);
+
+	const NameEntry* pEntry = findName(key);
+	if(!pEntry)
 	{
-		typedef const unsigned short ExtAsciiTab[128];
-		const CharType* name;
-		ExtAsciiTab* table;
-	};
+		return 0;
+	}
 
-	EncodingTableEntry encodingTable[] = 
+	Registration& registration = m_registrations[pEntry->index];
+	if(!registration.rpPrototype)
 	{
-		{QC_T("windows-1250"), &Encode_CP1250_Table},
-		{QC_T("windows-1251"), &Encode_CP1251_Table},
-		{QC_T("windows-1252"), &Encode_CP1252_Table},
-		{QC_T("windows-1253"), &Encode_CP1253_Table},
-		{QC_T("windows-1254"), &Encode_CP1254_Table},
-		{QC_T("windows-1255"), &Encode_CP1255_Table},
-		{QC_T("windows-1256"), &Encode_CP1256_Table},
-		{QC_T("windows-1257"), &Encode_CP1257_Table},
-		{QC_T("windows-1258"), &Encode_CP1258_Table},
-		{QC_T("ISO-8859-2"),   &Encode_8859_2_Table},
-		{QC_T("ISO-8859-3"),   &Encode_8859_3_Table},
-		{QC_T("ISO-8859-4"),   &Encode_8859_4_Table},
-		{QC_T("ISO-8859-5"),   &Encode_8859_5_Table},
-		{QC_T("ISO-8859-6"),   &Encode_8859_6_Table},
-		{QC_T("ISO-8859-7"),   &Encode_8859_7_Table},
-		{QC_T("ISO-8859-8"),   &Encode_8859_8_Table},
-		{QC_T("ISO-8859-9"),   &Encode_8859_9_Table},
-		{QC_T("ISO-8859-10"),  &Encode_8859_10_Table},
-		{QC_T("ISO-8859-13"),  &Encode_8859_13_Table},
-		{QC_T("ISO-8859-14"),  &Encode_8859_14_Table},
-		{QC_T("ISO-8859-15"),  &Encode_8859_15_Table},
-		{QC_T("IBM850"),       &Encode_IBM_850_Table},
-		{0, 0}
-	};
+		QC_DBG_ASSERT(registration.pCodePage != 0);
+		registration.rpPrototype = new ASCII8BitConverter(registration.name, *registration.pCodePage);
+	}
+
+	return registration.rpPrototype->clone();
+}
+
+//==============================================================================
+// CodeConverterFactory::registerConverter
+//
+/**
+   Registers a prototype CodeConverter for the named encoding.  Subsequent
+   calls to getConverter() for the encoding will return a clone of the
+   prototype, so the prototype must override CodeConverter::clone().
+
+   If the encoding is already registered, @c pPrototype replaces the existing
+   registration, including any aliases for it.
+
+   @param encoding the name of the encoding
+   @param pPrototype the CodeConverter to clone
+   @throws NullPointerException if @c pPrototype is null
+   @throws IllegalArgumentException if @c encoding does not contain any
+           letters or digits
+   @mtsafe
+*/
+//==============================================================================
+void CodeConverterFactory::registerConverter(const String& encoding, CodeConverter* pPrototype)
+{
+	if(!pPrototype) throw NullPointerException();
+
+	AutoPtr<CodeConverter> rpPrototype(pPrototype);
+
+	const String key = NormalizeName(encoding);
+	if(key.empty()) throw IllegalArgumentException(QC_T("invalid encoding name"));
 
-	size_t i=0;
-	while(true)
+	QC_AUTO_LOCK(FastMutex, m_mutex);
+
+	const NameEntry* pEntry = findName(key);
+	if(pEntry)
 	{
-		const EncodingTableEntry& entry = encodingTable[i];
-		if(entry.name == 0)
-		{
-			break;
-		}
-		else if(StringUtils::CompareNoCase(encoding, entry.name) == 0)
-		{
-			return new ASCII8BitConverter(entry.name, *entry.table);
-		}
-		i++;
+		Registration& registration = m_registrations[pEntry->index];
+		registration.rpPrototype = rpPrototype;
+		registration.pCodePage = 0;
 	}
+	else
+	{
+		addName(key, addRegistration(encoding, 0, rpPrototype.get()));
+	}
+}
 
-	return 0;
+//==============================================================================
+// CodeConverterFactory::registerAlias
+//
+/**
+   Registers @c alias as an alternative name for a registered encoding.
+
+   @param alias the alternative name
+   @param encoding the name of a registered encoding
+   @throws IllegalArgumentException if @c encoding is not registered or
+           @c alias does not contain any letters or digits
+   @mtsafe
+*/
+//==============================================================================
+void CodeConverterFactory::registerAlias(const String& alias, const String& encoding)
+{
+	const String aliasKey = NormalizeName(alias);
+	if(aliasKey.empty()) throw IllegalArgumentException(QC_T("invalid alias name"));
+
+	const String key = NormalizeName(encoding);
+
+	QC_AUTO_LOCK(FastMutex, m_mutex);
+
+	const NameEntry* pEntry = findName(key);
+	if(!pEntry)
+	{
+		throw IllegalArgumentException(QC_T("unknown encoding: ") + encoding);
+	}
+
+	addName(aliasKey, pEntry->index);
 }
 
 //==============================================================================
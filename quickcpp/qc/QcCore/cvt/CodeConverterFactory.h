@@ -34,21 +34,68 @@
 #include "defs.h"
 #endif //QC_CVT_DEFS_h
 
-QC_CVT_NAMESPACE_BEGIN
+#include "CodeConverter.h"
+#include "QcCore/base/FastMutex.h"
+
+#include <list>
+#include <vector>
 
-class CodeConverter;
+QC_CVT_NAMESPACE_BEGIN
 
 class QC_CVT_PKG CodeConverterFactory : public virtual QCObject
 {
 public:
 
+	CodeConverterFactory();
+
 	static CodeConverterFactory& GetInstance();
 	static void SetInstance(CodeConverterFactory* pFactory);
 
 	AutoPtr<CodeConverter> getConverter(const String& encoding) const;
 	AutoPtr<CodeConverter> getDefaultConverter() const;
 
+	void registerConverter(const String& encoding, CodeConverter* pPrototype);
+	void registerAlias(const String& alias, const String& encoding);
+
 private:
+	CodeConverterFactory(const CodeConverterFactory& rhs);            // not implemented
+	CodeConverterFactory& operator=(const CodeConverterFactory& rhs); // not implemented
+
+	typedef const unsigned short CodePage[128];
+
+	struct Registration
+	{
+		String name;
+		CodePage* pCodePage;
+		AutoPtr<CodeConverter> rpPrototype;
+	};
+
+	struct NameEntry
+	{
+		String key;
+		size_t index;
+	};
+
+	typedef std::vector<Registration> RegistrationList;
+	typedef std::list<NameEntry> NameBucket;
+	enum {NumBuckets = 64};
+
+	void registerStandardConverters();
+	size_t addRegistration(const String& name, CodePage* pCodePage, CodeConverter* pPrototype);
+	void addName(const String& key, size_t index);
+	const NameEntry* findName(const String& key) const;
+
+	static String NormalizeName(const String& encoding);
+	static size_t HashName(const String& key);
+
+private:
+	mutable RegistrationList m_registrations;
+	NameBucket m_names[NumBuckets];
+
+#ifdef QC_MT
+	FastMutex m_mutex;
+#endif //QC_MT
+
 	static CodeConverterFactory* QC_MT_VOLATILE s_pInstance;
 };
 
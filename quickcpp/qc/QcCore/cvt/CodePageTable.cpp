@@ -0,0 +1,235 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CodePageTable
+// 
+// Single-byte code pages were previously encoded using a std::map that was
+// rebuilt for every new CodeConverter.  A CodePageTable replaces the map with
+// a two-level lookup table that needs no searching, and is built only once
+// for each code page.
+//
+// Tables are identified by the address of the static decoding table from
+// which they were generated.  Because applications may construct converters
+// from their own tables, the contents of the table are compared as well
+// before a cached CodePageTable is reused.
+//
+// Once built, a CodePageTable is registered with the ObjectManager so that
+// it is freed when the library terminates.  The destructor removes the table
+// from the list of known tables.
+//
+//==============================================================================
+
+#include "CodePageTable.h"
+
+#include "QcCore/base/FastMutex.h"
+#include "QcCore/base/ObjectManager.h"
+#include "QcCore/base/System.h"
+
+QC_CVT_NAMESPACE_BEGIN
+
+#ifdef QC_MT
+	FastMutex CodePageTableMutex;
+#endif //QC_MT
+
+CodePageTable* CodePageTable::s_pFirst = 0;
+
+//
+// Page shared by every range of 256 characters that has no mappings
+//
+static const Byte EmptyPage[256] = {0};
+
+//==============================================================================
+// CodePageTable::GetTable
+//
+// Returns the shared CodePageTable for a decoding table, creating it if
+// necessary.  If @c bASCIIBased is true, @c pDecodingTable contains 128
+// entries for the bytes 0x80-0xFF and the lower half of the code page is
+// US-ASCII.  Otherwise it contains 256 entries.
+//==============================================================================
+AutoPtr<CodePageTable> CodePageTable::GetTable(const CodedChar* pDecodingTable,
+                                               bool bASCIIBased)
+{
+	QC_AUTO_LOCK(FastMutex, CodePageTableMutex);
+
+	for(CodePageTable* pTable = s_pFirst; pTable; pTable = pTable->m_pNext)
+	{
+		if(pTable->matches(pDecodingTable, bASCIIBased))
+		{
+			return pTable;
+		}
+	}
+
+	AutoPtr<CodePageTable> rpTable = new CodePageTable(pDecodingTable, bASCIIBased);
+	rpTable->m_pNext = s_pFirst;
+	s_pFirst = rpTable.get();
+
+	// registerObject() will increment the new object's ref count
+	System::GetObjectManager().registerObject(rpTable.get());
+
+	return rpTable;
+}
+
+//==============================================================================
+// CodePageTable::CreateTable
+//
+// Creates a private CodePageTable from a transient 256-entry decoding table.
+// The new table is not shared, so @c pDecodingTable need not outlive the
+// call.
+//==============================================================================
+AutoPtr<CodePageTable> CodePageTable::CreateTable(const CodedChar* pDecodingTable)
+{
+	AutoPtr<CodePageTable> rpTable = new CodePageTable(pDecodingTable, false);
+	rpTable->m_pSourceTable = 0;
+	return rpTable;
+}
+
+//==============================================================================
+// CodePageTable::CodePageTable
+//
+// Builds the 32-bit decoding table and the two-level encoding table.
+//==============================================================================
+CodePageTable::CodePageTable(const CodedChar* pDecodingTable, bool bASCIIBased) :
+	m_pSourceTable(pDecodingTable),
+	m_bASCIIBased(bASCIIBased),
+	m_bASCIICompatible(true),
+	m_pPageStore(0),
+	m_charForZero(Undefined),
+	m_pNext(0)
+{
+	size_t i;
+
+	for(i=0; i<256; ++i)
+	{
+		if(!bASCIIBased)
+			m_decodingTable[i] = pDecodingTable[i];
+		else if(i < 0x80)
+			m_decodingTable[i] = (unsigned int)i;
+		else
+			m_decodingTable[i] = pDecodingTable[i-0x80];
+
+		if(i < 0x80 && m_decodingTable[i] != i)
+			m_bASCIICompatible = false;
+	}
+
+	//
+	// Count the pages that contain at least one character
+	//
+	bool bPageUsed[256] = {false};
+	size_t numPages = 0;
+
+	for(i=0; i<256; ++i)
+	{
+		const unsigned int ch = m_decodingTable[i];
+		if(ch != Undefined && !bPageUsed[ch >> 8])
+		{
+			bPageUsed[ch >> 8] = true;
+			++numPages;
+		}
+	}
+
+	m_pPageStore = new Byte[numPages * 256];
+	::memset(m_pPageStore, 0, numPages * 256);
+
+	Byte* pNextPage = m_pPageStore;
+	for(i=0; i<256; ++i)
+	{
+		if(bPageUsed[i])
+		{
+			m_encodingPages[i] = pNextPage;
+			pNextPage += 256;
+		}
+		else
+		{
+			m_encodingPages[i] = EmptyPage;
+		}
+	}
+
+	//
+	// Fill in the pages.  When a character is mapped by more than one byte,
+	// the highest byte value wins.
+	//
+	for(i=0; i<256; ++i)
+	{
+		const unsigned int ch = m_decodingTable[i];
+		if(ch != Undefined)
+		{
+			const_cast<Byte*>(m_encodingPages[ch >> 8])[ch & 0xFF] = Byte(i);
+			if(i == 0)
+			{
+				m_charForZero = ch;
+			}
+		}
+	}
+}
+
+//==============================================================================
+// CodePageTable::~CodePageTable
+//
+//==============================================================================
+CodePageTable::~CodePageTable()
+{
+	{
+		QC_AUTO_LOCK(FastMutex, CodePageTableMutex);
+
+		CodePageTable** ppTable = &s_pFirst;
+		while(*ppTable && *ppTable != this)
+		{
+			ppTable = &(*ppTable)->m_pNext;
+		}
+		if(*ppTable)
+		{
+			*ppTable = m_pNext;
+		}
+	}
+
+	delete [] m_pPageStore;
+}
+
+//==============================================================================
+// CodePageTable::matches
+//
+// Tests whether this CodePageTable was generated from the same decoding
+// table.
+//==============================================================================
+bool CodePageTable::matches(const CodedChar* pDecodingTable, bool bASCIIBased) const
+{
+	if(pDecodingTable != m_pSourceTable || bASCIIBased != m_bASCIIBased)
+	{
+		return false;
+	}
+
+	const size_t offset = bASCIIBased ? 0x80 : 0;
+
+	for(size_t i=offset; i<256; ++i)
+	{
+		if(m_decodingTable[i] != pDecodingTable[i-offset])
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+QC_CVT_NAMESPACE_END
@@ -0,0 +1,134 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CodePageTable
+// 
+// Overview
+// --------
+// Holds the decoding and encoding tables for a single-byte code page.  One
+// CodePageTable is built for each code page and shared by every
+// CodeConverter instance that uses it.
+//
+// This is an internal class and is not exported from the library.
+//
+//=============================================================================
+
+#ifndef QC_CVT_CodePageTable_h
+#define QC_CVT_CodePageTable_h
+
+#ifndef QC_CVT_DEFS_h
+#include "defs.h"
+#endif //QC_CVT_DEFS_h
+
+#include "VectorCodec.h"
+
+QC_CVT_NAMESPACE_BEGIN
+
+class CodePageTable : public QCObject
+{
+public:
+
+	typedef unsigned short CodedChar;
+
+	enum {Undefined = VectorCodec::UndefinedChar};
+
+	static AutoPtr<CodePageTable> GetTable(const CodedChar* pDecodingTable,
+	                                       bool bASCIIBased);
+
+	static AutoPtr<CodePageTable> CreateTable(const CodedChar* pDecodingTable);
+
+	virtual ~CodePageTable();
+
+	UCS4Char decodeByte(Byte b) const;
+	size_t decodeRun(const Byte* from, size_t len, CharType* to) const;
+	bool encodeChar(UCS4Char ch, Byte& b) const;
+
+private:
+	CodePageTable(const CodedChar* pDecodingTable, bool bASCIIBased);
+	CodePageTable(const CodePageTable& rhs);            // not implemented
+	CodePageTable& operator=(const CodePageTable& rhs); // not implemented
+
+	bool matches(const CodedChar* pDecodingTable, bool bASCIIBased) const;
+
+private:
+	const CodedChar* m_pSourceTable;
+	bool m_bASCIIBased;
+	bool m_bASCIICompatible;
+	unsigned int m_decodingTable[256];
+	const Byte* m_encodingPages[256];
+	Byte* m_pPageStore;
+	UCS4Char m_charForZero;
+	CodePageTable* m_pNext;
+
+	static CodePageTable* s_pFirst;
+};
+
+//==============================================================================
+// CodePageTable::decodeByte
+//
+// Returns the Unicode character for byte @c b, or Undefined.
+//==============================================================================
+inline
+	UCS4Char CodePageTable::decodeByte(Byte b) const
+{
+	return m_decodingTable[b];
+}
+
+//==============================================================================
+// CodePageTable::decodeRun
+//
+// Decodes bytes into internal characters until an undefined byte is found.
+// Returns the number of bytes decoded.  Must not be used when the internal
+// encoding is UTF-8.
+//==============================================================================
+inline
+	size_t CodePageTable::decodeRun(const Byte* from, size_t len, CharType* to) const
+{
+	return VectorCodec::DecodeSingleByte(from, len, to, m_decodingTable, m_bASCIICompatible);
+}
+
+//==============================================================================
+// CodePageTable::encodeChar
+//
+// Looks up the byte value for the Unicode character @c ch.  The encoding
+// table has two levels: the high-order byte of @c ch selects a 256-byte page
+// and the low-order byte indexes into the page.  A zero byte in a page means
+// that the character is not mapped, except for the single character that
+// does map to byte 0.
+//==============================================================================
+inline
+	bool CodePageTable::encodeChar(UCS4Char ch, Byte& b) const
+{
+	if(ch < 0x10000U)
+	{
+		b = m_encodingPages[ch >> 8][ch & 0xFF];
+		return (b != 0 || ch == m_charForZero);
+	}
+	return false;
+}
+
+QC_CVT_NAMESPACE_END
+
+#endif //QC_CVT_CodePageTable_h
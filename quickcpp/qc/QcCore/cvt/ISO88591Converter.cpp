@@ -96,12 +96,12 @@ CodeConverter::Result ISO88591Converter::encode(const CharType *from, const Char
 		const CharType * from_next_copy;
 		if( (ret=SystemCodeConverter::FromInternalEncoding(ch, from_next, from_end, from_next_copy))==ok)
 		{
-			if (ch < 0xFFU)	// needs just 1 byte
+			if (ch <= 0xFFU)	// needs just 1 byte
 			{
 				*to_next++ = Byte(ch);
 				from_next = from_next_copy;
 			}
-			else // greater than 0xFE is an error for ISO-8859-1
+			else // greater than 0xFF is an error for ISO-8859-1
 			{
 				if( (ret = handleUnmappableCharacter(ch, to_next, to_limit, to_next)) == ok)
 				{
@@ -138,6 +138,17 @@ bool ISO88591Converter::alwaysNoConversion() const
 	return (false);
 }
 
+//==============================================================================
+// ISO88591Converter::findCharBoundary
+//
+// Every byte is a complete character.
+//==============================================================================
+const Byte* ISO88591Converter::findCharBoundary(const Byte* /*from*/, const Byte* /*from_end*/,
+                                                const Byte* pos) const
+{
+	return pos;
+}
+
 size_t ISO88591Converter::getMaxEncodedLength() const
 {
 	return 1;
@@ -152,5 +163,14 @@ String ISO88591Converter::getEncodingName() const
 	return QC_T("ISO-8859-1");
 }
 
+//==============================================================================
+// ISO88591Converter::clone
+//
+//==============================================================================
+AutoPtr<CodeConverter> ISO88591Converter::clone() const
+{
+	return new ISO88591Converter(*this);
+}
+
 QC_CVT_NAMESPACE_END
 
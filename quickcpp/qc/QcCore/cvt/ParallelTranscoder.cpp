@@ -0,0 +1,827 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ParallelTranscoder
+//
+/**
+	@class qc::cvt::ParallelTranscoder
+	
+	@brief Converts large arrays of bytes from one encoding into another
+	using several threads.
+
+	A Transcoder converts its input one byte at a time on the calling thread.
+	A ParallelTranscoder divides a large input into chunks and converts
+	the chunks concurrently on the shared ThreadPool, each with its own
+	Transcoder and its own clones of the decoder and encoder.
+
+	The input is divided at character boundaries, which are located by the
+	decoder's CodeConverter::findCharBoundary() method.  For UTF-8 this is
+	the next byte that is not a continuation byte; for UTF-16 it is the next
+	code unit that is not a trailing surrogate; for single-byte encodings any
+	position will do.  If the decoder is unable to locate character
+	boundaries, the input is converted serially.
+
+	Before the input is divided, its first few characters are converted on the
+	calling thread.  This allows a decoder that reads a byte-order mark to
+	establish the byte order, and an encoder that writes a byte-order mark to
+	write it once at the start of the output.
+
+	The chunks are converted in two passes.  The first pass calls
+	CodeConverter::getDecodedLength() for each chunk to calculate the most
+	bytes that the chunk can produce.  A single output buffer is then
+	allocated with room for every chunk, and the second pass converts each
+	chunk into its own region of that buffer.  Finally the regions are moved
+	together to form a contiguous result.
+
+	If a chunk cannot be converted independently, for example because it
+	contains an invalid sequence and the converter's policy is to abort, or
+	because its output is longer than calculated, the chunks that precede it
+	are kept and the remainder of the input is converted serially.  In this
+	way any CharacterCodingException is thrown on the calling thread, exactly
+	as it would be by a Transcoder.  When the invalid character policy
+	is CodeConverter::replace, an ill-formed sequence that straddles a chunk
+	boundary may be replaced by a different number of replacement characters
+	than a serial conversion would produce.
+
+	Inputs that are smaller than twice the minimum chunk size (see
+	setMinChunkSize()) are always converted serially.  In single-threaded
+	versions of the library all conversion is serial.
+*/
+//==============================================================================
+
+#include "ParallelTranscoder.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/ThreadPool.h"
+#include "QcCore/io/InputStream.h"
+#include "QcCore/io/MalformedInputException.h"
+#include "QcCore/io/OutputStream.h"
+
+#include <string.h>
+#include <vector>
+
+QC_CVT_NAMESPACE_BEGIN
+
+using io::MalformedInputException;
+
+//
+// The number of bytes at the start of the input that are converted serially
+// before the input is divided into chunks.
+//
+const size_t PrimeLength = 64;
+
+//
+// The default minimum size of a chunk.  Smaller chunks do not convert
+// enough bytes to repay the cost of dispatching them to another thread.
+//
+const size_t DefaultMinChunkSize = 256 * 1024;
+
+//
+// The number of bytes read for each thread when a stream is converted.
+//
+const size_t StreamChunkSize = 1024 * 1024;
+
+//
+// The minimum free space in a ResultBuffer when converting serially.
+//
+const size_t SerialBufferSize = 4096;
+
+//==============================================================================
+// Class: ParallelTranscoder::ResultBuffer
+//
+// A growable array of bytes that holds the converted output.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ParallelTranscoder::ResultBuffer
+{
+public:
+	ResultBuffer() : m_capacity(0), m_length(0) {}
+
+	Byte* data() const {return m_apBuffer.get();}
+	Byte* end() const {return m_apBuffer.get() + m_length;}
+	Byte* limit() const {return m_apBuffer.get() + m_capacity;}
+
+	size_t length() const {return m_length;}
+	void setLength(size_t length) {m_length = length;}
+	void setEnd(Byte* pEnd) {m_length = pEnd - m_apBuffer.get();}
+
+	//
+	// Ensures that there is room for at least @c size more bytes,
+	// preserving the contents.
+	//
+	void reserve(size_t size)
+	{
+		if(m_capacity - m_length < size)
+		{
+			size_t capacity = m_capacity * 2;
+			if(capacity < m_length + size)
+			{
+				capacity = m_length + size;
+			}
+			ArrayAutoPtr<Byte> apBuffer(new Byte[capacity]);
+			if(m_length)
+			{
+				::memcpy(apBuffer.get(), m_apBuffer.get(), m_length);
+			}
+			m_apBuffer = apBuffer;
+			m_capacity = capacity;
+		}
+	}
+
+	ArrayAutoPtr<Byte> release()
+	{
+		ArrayAutoPtr<Byte> apBuffer = m_apBuffer;
+		m_capacity = m_length = 0;
+		return apBuffer;
+	}
+
+private:
+	ArrayAutoPtr<Byte> m_apBuffer;
+	size_t m_capacity;
+	size_t m_length;
+};
+
+//==============================================================================
+// Class: ParallelTranscoder::Batch
+//
+// The set of chunks that a block of input has been divided into.  The chunks
+// of each pass are taken in turn by the calling thread and by pooled
+// threads; the Batch counts the chunks that are being processed.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ParallelTranscoder::Batch : public Monitor
+{
+public:
+	enum Pass {measure, convert};
+
+	struct Chunk
+	{
+		const Byte* from;
+		const Byte* from_end;
+		const Byte* from_next;
+		bool bLast;
+		bool bEndOfInput;
+		bool bFailed;
+		AutoPtr<Transcoder> rpTranscoder;
+		size_t maxLength;
+		Byte* to;
+		size_t length;
+	};
+
+	typedef std::vector<Chunk> ChunkVector;
+
+	Batch() : m_pass(measure), m_nextChunk(0), m_active(0) {}
+
+	//
+	// Adds a chunk converted by a clone of @c pPrototype, which shares the
+	// prototype's tables instead of building them for every chunk
+	//
+	void addChunk(const Byte* from, const Byte* from_end, const Transcoder* pPrototype)
+	{
+		Chunk chunk;
+		chunk.from = chunk.from_next = from;
+		chunk.from_end = from_end;
+		chunk.bLast = chunk.bEndOfInput = chunk.bFailed = false;
+		chunk.rpTranscoder = pPrototype->clone();
+		chunk.maxLength = chunk.length = 0;
+		chunk.to = 0;
+		m_chunks.push_back(chunk);
+	}
+
+	ChunkVector& getChunks() {return m_chunks;}
+
+	void run(Pass pass);
+	void work();
+
+private:
+	class Task;
+
+	bool takeChunk(size_t& index, Pass& pass);
+	void chunkFinished();
+	void process(size_t index, Pass pass);
+
+private:
+	ChunkVector m_chunks;
+	Pass m_pass;
+	size_t m_nextChunk;
+	size_t m_active;
+};
+
+#ifdef QC_MT
+
+//==============================================================================
+// Class: ParallelTranscoder::Batch::Task
+//
+// Processes chunks of a Batch on a pooled thread.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ParallelTranscoder::Batch::Task : public Runnable
+{
+public:
+	Task(Batch* pBatch) : m_rpBatch(pBatch) {}
+
+	virtual void run()
+	{
+		m_rpBatch->work();
+	}
+
+private:
+	AutoPtr<Batch> m_rpBatch;
+};
+
+#endif //QC_MT
+
+//==============================================================================
+// ParallelTranscoder::Batch::run
+//
+// Processes every chunk.  The calling thread takes chunks alongside the
+// pooled threads, so every chunk is processed even if no pooled thread is
+// free, as happens when the caller is itself running on the default
+// ThreadPool.  The caller then waits only for chunks that other threads
+// have already started.
+//==============================================================================
+void ParallelTranscoder::Batch::run(Pass pass)
+{
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+		m_pass = pass;
+		m_nextChunk = 0;
+	}
+
+#ifdef QC_MT
+
+	AutoPtr<ThreadPool> rpPool = ThreadPool::GetDefaultPool();
+
+	for(size_t i=1; i<m_chunks.size(); ++i)
+	{
+		rpPool->execute(new Task(this));
+	}
+
+	//
+	// Tasks that only start once every chunk has been taken return at once
+	//
+	work();
+
+	QC_SYNCHRONIZED
+	while(m_active)
+	{
+		wait();
+	}
+
+#else
+
+	work();
+
+#endif //QC_MT
+}
+
+//==============================================================================
+// ParallelTranscoder::Batch::work
+//
+// Processes chunks until none remain to be taken.  Nothing is thrown: a
+// chunk that fails is marked so that it can be converted again on the
+// calling thread, and chunkFinished() is called whatever happens.
+//==============================================================================
+void ParallelTranscoder::Batch::work()
+{
+	size_t index;
+	Pass pass;
+	while(takeChunk(index, pass))
+	{
+		try
+		{
+			process(index, pass);
+		}
+		catch(...)
+		{
+			m_chunks[index].bFailed = true;
+		}
+		chunkFinished();
+	}
+}
+
+//==============================================================================
+// ParallelTranscoder::Batch::takeChunk
+//
+// Returns the index of the next chunk to be processed and the current pass,
+// or false if every chunk of the pass has been taken.
+//==============================================================================
+bool ParallelTranscoder::Batch::takeChunk(size_t& index, Pass& pass)
+{
+	QC_SYNCHRONIZED
+	if(m_nextChunk == m_chunks.size())
+	{
+		return false;
+	}
+	index = m_nextChunk++;
+	pass = m_pass;
+	++m_active;
+	return true;
+}
+
+//==============================================================================
+// ParallelTranscoder::Batch::chunkFinished
+//
+//==============================================================================
+void ParallelTranscoder::Batch::chunkFinished()
+{
+	QC_SYNCHRONIZED
+#ifdef QC_MT
+	if(--m_active == 0)
+	{
+		notifyAll();
+	}
+#else
+	--m_active;
+#endif //QC_MT
+}
+
+//==============================================================================
+// ParallelTranscoder::Batch::process
+//
+// Measures or converts a single chunk.  A chunk that could not be measured
+// is not converted.
+//==============================================================================
+void ParallelTranscoder::Batch::process(size_t index, Pass pass)
+{
+	Chunk& chunk = m_chunks[index];
+
+	if(chunk.bFailed)
+	{
+		return;
+	}
+
+	if(pass == measure)
+	{
+		const size_t maxEncodedLength = chunk.rpTranscoder->getEncoder()->getMaxEncodedLength();
+
+		chunk.maxLength = chunk.rpTranscoder->getDecoder()->getDecodedLength(chunk.from, chunk.from_end)
+		                * maxEncodedLength;
+
+		// room for a replacement character at the end of the input
+		if(chunk.bEndOfInput)
+		{
+			chunk.maxLength += maxEncodedLength;
+		}
+		return;
+	}
+
+	Transcoder& transcoder = *chunk.rpTranscoder;
+
+	Byte* to_limit = chunk.to + chunk.maxLength;
+	Byte* to_next;
+	const Byte* from_next;
+
+	CodeConverter::Result ret = transcoder.transcode(chunk.from, chunk.from_end,
+		from_next, chunk.to, to_limit, to_next);
+
+	if(ret == CodeConverter::inputExhausted && chunk.bEndOfInput)
+	{
+		transcoder.endOfInput(from_next, chunk.from_end);
+		from_next = chunk.from_end;
+
+		Byte* pStart = to_next;
+		ret = transcoder.flush(pStart, to_limit, to_next);
+	}
+
+	chunk.from_next = from_next;
+	chunk.length = to_next - chunk.to;
+
+	//
+	// Only the last chunk may end with an incomplete sequence, which
+	// will be converted with the next block of input
+	//
+	chunk.bFailed = !(ret == CodeConverter::ok ||
+	                  (ret == CodeConverter::inputExhausted && chunk.bLast));
+}
+
+//==============================================================================
+// ParallelTranscoder::ParallelTranscoder
+//
+/**
+   Constructs a ParallelTranscoder that converts from the encoding of
+   @c pDecoder into the encoding of @c pEncoder.
+
+   The converters are never used directly: each conversion starts with fresh
+   clones of them, so both must support CodeConverter::clone().
+
+   @param pDecoder the CodeConverter that decodes the source encoding
+   @param pEncoder the CodeConverter that encodes the target encoding
+   @param numThreads the maximum number of threads to use.  If zero, one
+          thread is used for each processor.
+   @throws NullPointerException if either converter is null.
+*/
+//==============================================================================
+ParallelTranscoder::ParallelTranscoder(CodeConverter* pDecoder, CodeConverter* pEncoder,
+                                       size_t numThreads) :
+	m_rpDecoder(pDecoder),
+	m_rpEncoder(pEncoder),
+	m_numThreads(numThreads ? numThreads : ThreadPool::GetProcessorCount()),
+	m_minChunkSize(DefaultMinChunkSize),
+	m_bStarted(false)
+{
+	if(!pDecoder || !pEncoder) throw NullPointerException();
+}
+
+//==============================================================================
+// ParallelTranscoder::transcode
+//
+/**
+   Converts the complete input [from, from_end) and returns the result in a
+   newly allocated array.
+
+   An incomplete sequence at the end of the input is treated in the same way
+   as by Transcoder::endOfInput().
+
+   @param from pointer to the start of the input
+   @param from_end pointer to the next byte after the end of the input
+   @param resultLen returns the number of bytes in the result
+   @returns an ArrayAutoPtr that owns the converted bytes
+   @throws CharacterCodingException if an invalid or unmappable character is
+           detected and the relevant policy is to abort.
+*/
+//==============================================================================
+ArrayAutoPtr<Byte> ParallelTranscoder::transcode(const Byte* from, const Byte* from_end,
+                                                 size_t& resultLen)
+{
+	reset();
+
+	ResultBuffer result;
+	transcodeBlock(from, from_end, true, result);
+
+	resultLen = result.length();
+	return result.release();
+}
+
+//==============================================================================
+// ParallelTranscoder::transcode
+//
+/**
+   Reads @c pInputStream until end-of-file, converting each block of bytes
+   read and writing the result to @c pOutputStream.
+
+   The input is read in blocks of one megabyte for each thread.
+   Neither stream is closed.
+
+   @throws NullPointerException if either stream is null.
+   @throws IOException if an I/O error occurs.
+   @throws CharacterCodingException if an invalid or unmappable character is
+           detected and the relevant policy is to abort.
+*/
+//==============================================================================
+void ParallelTranscoder::transcode(io::InputStream* pInputStream,
+                                   io::OutputStream* pOutputStream)
+{
+	if(!pInputStream || !pOutputStream) throw NullPointerException();
+
+	reset();
+
+	const size_t chunkSize = (m_minChunkSize > StreamChunkSize) ? m_minChunkSize
+	                                                            : StreamChunkSize;
+	const size_t blockSize = chunkSize * m_numThreads;
+
+	ArrayAutoPtr<Byte> apBlock(new Byte[blockSize]);
+	ResultBuffer result;
+	size_t used = 0;
+	bool bEOF = false;
+
+	while(!bEOF)
+	{
+		while(used < blockSize)
+		{
+			const long bytesRead = pInputStream->read(apBlock.get() + used, blockSize - used);
+			if(bytesRead == io::InputStream::EndOfFile)
+			{
+				bEOF = true;
+				break;
+			}
+			used += bytesRead;
+		}
+
+		result.setLength(0);
+		const Byte* pNext = transcodeBlock(apBlock.get(), apBlock.get() + used,
+		                                   bEOF, result);
+
+		if(result.length())
+		{
+			pOutputStream->write(result.data(), result.length());
+		}
+
+		//
+		// Move any incomplete sequence to the start of the block
+		//
+		const size_t remaining = apBlock.get() + used - pNext;
+		::memmove(apBlock.get(), pNext, remaining);
+		used = remaining;
+	}
+
+	pOutputStream->flush();
+}
+
+//==============================================================================
+// ParallelTranscoder::reset
+//
+// Prepares for a new conversion with fresh clones of the converters.
+//==============================================================================
+void ParallelTranscoder::reset()
+{
+	m_rpTranscoder = new Transcoder(m_rpDecoder->clone().get(), m_rpEncoder->clone().get());
+	m_bStarted = false;
+}
+
+//==============================================================================
+// ParallelTranscoder::transcodeBlock
+//
+// Converts [from, from_end), appending the output to @c result.  Unless
+// @c bEndOfInput is true, an incomplete sequence at the end of the block is
+// left unconverted.  Returns a pointer to the first unconverted byte.
+//==============================================================================
+const Byte* ParallelTranscoder::transcodeBlock(const Byte* from, const Byte* from_end,
+                                               bool bEndOfInput, ResultBuffer& result)
+{
+	size_t numChunks = 1;
+
+#ifdef QC_MT
+	numChunks = size_t(from_end - from) / m_minChunkSize;
+	if(numChunks > m_numThreads)
+	{
+		numChunks = m_numThreads;
+	}
+#endif //QC_MT
+
+	if(numChunks < 2)
+	{
+		return transcodeSerial(from, from_end, bEndOfInput, result);
+	}
+
+	const Byte* from_next = from;
+
+	if(!m_bStarted)
+	{
+		const Byte* pHeadEnd = m_rpTranscoder->getDecoder()->findCharBoundary(
+			from, from_end, (size_t(from_end - from) > PrimeLength) ? from + PrimeLength : from_end);
+
+		if(!pHeadEnd)
+		{
+			return transcodeSerial(from, from_end, bEndOfInput, result);
+		}
+
+		from_next = transcodeSerial(from, pHeadEnd, false, result);
+		m_bStarted = true;
+	}
+
+	return transcodeChunks(from_next, from_end, bEndOfInput, numChunks, result);
+}
+
+//==============================================================================
+// ParallelTranscoder::transcodeSerial
+//
+// Converts [from, from_end) on the calling thread using m_rpTranscoder,
+// growing the result buffer as required.
+//==============================================================================
+const Byte* ParallelTranscoder::transcodeSerial(const Byte* from, const Byte* from_end,
+                                                bool bEndOfInput, ResultBuffer& result)
+{
+	const Byte* from_next = from;
+	CodeConverter::Result ret;
+
+	do
+	{
+		result.reserve(SerialBufferSize);
+
+		Byte* pStart = result.end();
+		Byte* to_next;
+		ret = m_rpTranscoder->transcode(from_next, from_end, from_next,
+		                                pStart, result.limit(), to_next);
+		result.setEnd(to_next);
+
+		//
+		// If bytes were converted before the error, the next call
+		// will raise the appropriate exception
+		//
+		if(ret == CodeConverter::error && to_next == pStart)
+		{
+			throw MalformedInputException(QC_T("encoding error"), m_rpTranscoder->getDecoder().get());
+		}
+	}
+	while(ret == CodeConverter::outputExhausted || ret == CodeConverter::error);
+
+	if(bEndOfInput)
+	{
+		m_rpTranscoder->endOfInput(from_next, from_end);
+		from_next = from_end;
+	}
+
+	while(m_rpTranscoder->hasPendingOutput())
+	{
+		result.reserve(SerialBufferSize);
+
+		Byte* pStart = result.end();
+		Byte* to_next;
+		ret = m_rpTranscoder->flush(pStart, result.limit(), to_next);
+		result.setEnd(to_next);
+
+		if(ret == CodeConverter::error && to_next == pStart)
+		{
+			throw MalformedInputException(QC_T("encoding error"), m_rpTranscoder->getDecoder().get());
+		}
+	}
+
+	if(from_next > from)
+	{
+		m_bStarted = true;
+	}
+
+	return from_next;
+}
+
+//==============================================================================
+// ParallelTranscoder::transcodeChunks
+//
+// Divides [from, from_end) into up to @c numChunks chunks at character
+// boundaries and converts them concurrently.
+//==============================================================================
+const Byte* ParallelTranscoder::transcodeChunks(const Byte* from, const Byte* from_end,
+                                                bool bEndOfInput, size_t numChunks,
+                                                ResultBuffer& result)
+{
+	AutoPtr<CodeConverter> rpDecoder = m_rpTranscoder->getDecoder();
+
+	AutoPtr<Batch> rpBatch = new Batch;
+	Batch::ChunkVector& chunks = rpBatch->getChunks();
+
+	const size_t chunkSize = size_t(from_end - from) / numChunks;
+	const Byte* pChunkStart = from;
+
+	for(size_t i=1; i<numChunks; ++i)
+	{
+		const Byte* pChunkEnd = rpDecoder->findCharBoundary(from, from_end, from + chunkSize * i);
+		if(!pChunkEnd)
+		{
+			return transcodeSerial(from, from_end, bEndOfInput, result);
+		}
+		if(pChunkEnd > pChunkStart && pChunkEnd < from_end)
+		{
+			rpBatch->addChunk(pChunkStart, pChunkEnd, m_rpTranscoder.get());
+			pChunkStart = pChunkEnd;
+		}
+	}
+
+	rpBatch->addChunk(pChunkStart, from_end, m_rpTranscoder.get());
+	chunks.back().bLast = true;
+	chunks.back().bEndOfInput = bEndOfInput;
+
+	//
+	// Measure each chunk and allocate a single buffer with room for all
+	// of them
+	//
+	rpBatch->run(Batch::measure);
+
+	size_t totalLength = 0;
+	Batch::ChunkVector::iterator i;
+	for(i=chunks.begin(); i!=chunks.end(); ++i)
+	{
+		totalLength += i->maxLength;
+	}
+
+	result.reserve(totalLength);
+
+	Byte* pRegion = result.end();
+	for(i=chunks.begin(); i!=chunks.end(); ++i)
+	{
+		i->to = pRegion;
+		pRegion += i->maxLength;
+	}
+
+	rpBatch->run(Batch::convert);
+
+	//
+	// Move the converted regions together.  Each region starts at or after
+	// the point where it is moved to, so a region is never overwritten
+	// before it has been moved.
+	//
+	Byte* pEnd = result.end();
+	for(i=chunks.begin(); i!=chunks.end(); ++i)
+	{
+		if(i->bFailed)
+		{
+			result.setEnd(pEnd);
+			return transcodeSerial(i->from, from_end, bEndOfInput, result);
+		}
+		::memmove(pEnd, i->to, i->length);
+		pEnd += i->length;
+	}
+
+	result.setEnd(pEnd);
+	return chunks.back().from_next;
+}
+
+//==============================================================================
+// ParallelTranscoder::getThreadCount
+//
+/**
+   Returns the maximum number of threads used to convert a block of input.
+*/
+//==============================================================================
+size_t ParallelTranscoder::getThreadCount() const
+{
+	return m_numThreads;
+}
+
+//==============================================================================
+// ParallelTranscoder::setThreadCount
+//
+/**
+   Sets the maximum number of threads used to convert a block of input.  The
+   input is divided into no more than this number of chunks.
+
+   The chunks are converted by the default ThreadPool, which has one thread
+   for each processor; a larger value divides the input more finely but does
+   not increase the number of chunks converted at once.
+
+   @param numThreads the maximum number of threads.  If zero, one thread is
+          used for each processor.
+*/
+//==============================================================================
+void ParallelTranscoder::setThreadCount(size_t numThreads)
+{
+	m_numThreads = numThreads ? numThreads : ThreadPool::GetProcessorCount();
+}
+
+//==============================================================================
+// ParallelTranscoder::getMinChunkSize
+//
+/**
+   Returns the minimum number of input bytes in a chunk.
+*/
+//==============================================================================
+size_t ParallelTranscoder::getMinChunkSize() const
+{
+	return m_minChunkSize;
+}
+
+//==============================================================================
+// ParallelTranscoder::setMinChunkSize
+//
+/**
+   Sets the minimum number of input bytes in a chunk.  The default is 256KB.
+
+   @param size the minimum chunk size, which must be greater than zero.
+*/
+//==============================================================================
+void ParallelTranscoder::setMinChunkSize(size_t size)
+{
+	m_minChunkSize = size ? size : 1;
+}
+
+//==============================================================================
+// ParallelTranscoder::getDecoder
+//
+/**
+   Returns the CodeConverter that decodes the source encoding.
+*/
+//==============================================================================
+AutoPtr<CodeConverter> ParallelTranscoder::getDecoder() const
+{
+	return m_rpDecoder;
+}
+
+//==============================================================================
+// ParallelTranscoder::getEncoder
+//
+/**
+   Returns the CodeConverter that encodes the target encoding.
+*/
+//==============================================================================
+AutoPtr<CodeConverter> ParallelTranscoder::getEncoder() const
+{
+	return m_rpEncoder;
+}
+
+QC_CVT_NAMESPACE_END
@@ -0,0 +1,101 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ParallelTranscoder
+// 
+// Converts large arrays of bytes, and complete byte streams, from one
+// encoding into another by dividing the input into chunks which are
+// transcoded concurrently.
+//
+//==============================================================================
+
+#ifndef QC_CVT_ParallelTranscoder_h
+#define QC_CVT_ParallelTranscoder_h
+
+#ifndef QC_CVT_DEFS_h
+#include "defs.h"
+#endif //QC_CVT_DEFS_h
+
+#include "CodeConverter.h"
+#include "Transcoder.h"
+
+#include "QcCore/base/ArrayAutoPtr.h"
+
+QC_SUB_NAMESPACE_BEGIN(io)
+class InputStream;
+class OutputStream;
+QC_SUB_NAMESPACE_END(io)
+
+QC_CVT_NAMESPACE_BEGIN
+
+class QC_CVT_PKG ParallelTranscoder : public virtual QCObject
+{
+public:
+
+	ParallelTranscoder(CodeConverter* pDecoder, CodeConverter* pEncoder,
+	                   size_t numThreads=0);
+
+	ArrayAutoPtr<Byte> transcode(const Byte* from, const Byte* from_end,
+	                             size_t& resultLen);
+
+	void transcode(io::InputStream* pInputStream, io::OutputStream* pOutputStream);
+
+	size_t getThreadCount() const;
+	void setThreadCount(size_t numThreads);
+
+	size_t getMinChunkSize() const;
+	void setMinChunkSize(size_t size);
+
+	AutoPtr<CodeConverter> getDecoder() const;
+	AutoPtr<CodeConverter> getEncoder() const;
+
+private:
+	ParallelTranscoder(const ParallelTranscoder& rhs);            // not implemented
+	ParallelTranscoder& operator=(const ParallelTranscoder& rhs); // not implemented
+
+	class ResultBuffer;
+	class Batch;
+
+	void reset();
+	const Byte* transcodeBlock(const Byte* from, const Byte* from_end,
+	                           bool bEndOfInput, ResultBuffer& result);
+	const Byte* transcodeSerial(const Byte* from, const Byte* from_end,
+	                            bool bEndOfInput, ResultBuffer& result);
+	const Byte* transcodeChunks(const Byte* from, const Byte* from_end,
+	                            bool bEndOfInput, size_t numChunks,
+	                            ResultBuffer& result);
+
+private:
+	AutoPtr<CodeConverter> m_rpDecoder;
+	AutoPtr<CodeConverter> m_rpEncoder;
+	AutoPtr<Transcoder> m_rpTranscoder;
+	size_t m_numThreads;
+	size_t m_minChunkSize;
+	bool m_bStarted;
+};
+
+QC_CVT_NAMESPACE_END
+
+#endif //QC_CVT_ParallelTranscoder_h
@@ -29,7 +29,8 @@
 // mapping the 256 values to specific Unicode characters.
 //
 // This class implements a general-purpose, table-driven approach
-// to encoding and decoding these values.
+// to encoding and decoding these values.  The tables are held in a
+// CodePageTable which is shared by all converters for the same code page.
 //
 //==============================================================================
 
@@ -39,8 +40,6 @@
 
 QC_CVT_NAMESPACE_BEGIN
 
-const Simple8BitConverter::CodedChar UNDEFINED = 0xFFFF;
-
 Simple8BitConverter::Simple8BitConverter(const String& name,
                                          const CodedChar* decodingTable) :
 	m_pDecodingTable(decodingTable),
@@ -55,14 +54,7 @@ Simple8BitConverter::Simple8BitConverter(const String& name,
 //==============================================================================
 void Simple8BitConverter::generateEncodingMap()
 {
-	for(size_t i=0; i<256; ++i)
-	{
-		const CodedChar theChar = m_pDecodingTable[i];
-		if(theChar != UNDEFINED)
-		{
-			m_encodingMap[theChar] = Byte(i);
-		}
-	}
+	m_rpTable = CodePageTable::GetTable(m_pDecodingTable, false);
 }
 
 //==============================================================================
@@ -82,8 +74,27 @@ CodeConverter::Result Simple8BitConverter::decode(const Byte *from, const Byte *
 	//
 	while(ret == ok && from_next < from_end && to_next < to_limit)
 	{
-		const CodedChar nextChar = m_pDecodingTable[*from_next];
-		if(nextChar == UNDEFINED)
+#if !defined(QC_UTF8)
+		//
+		// Decode as much as possible using the table, stopping
+		// at the first undefined byte
+		//
+		size_t runLen = from_end - from_next;
+		if(runLen > size_t(to_limit - to_next))
+			runLen = to_limit - to_next;
+
+		runLen = m_rpTable->decodeRun(from_next, runLen, to_next);
+		from_next += runLen;
+		to_next += runLen;
+
+		if(from_next == from_end || to_next == to_limit)
+		{
+			break;
+		}
+#endif //QC_UTF8
+
+		const UCS4Char nextChar = m_rpTable->decodeByte(*from_next);
+		if(nextChar == CodePageTable::Undefined)
 		{
 			if(getInvalidCharAction() == abort)
 			{
@@ -130,14 +141,28 @@ CodeConverter::Result Simple8BitConverter::encode(const CharType *from, const Ch
 	//
 	while(from_next < from_end && to_next < to_limit && ret == ok)
 	{
+#if !defined(QC_UTF8)
+		//
+		// Characters below the surrogate range are always represented
+		// by a single internal character, so can be looked up directly
+		//
+		Byte mapped;
+		if(UCS4Char(*from_next) < 0xD800U && m_rpTable->encodeChar(UCS4Char(*from_next), mapped))
+		{
+			*to_next++ = mapped;
+			++from_next;
+			continue;
+		}
+#endif //QC_UTF8
+
 		UCS4Char ch;
 		const CharType * from_next_copy;
 		if( (ret=SystemCodeConverter::FromInternalEncoding(ch, from_next, from_end, from_next_copy)) == ok)
 		{
-			EncodingMap::const_iterator iter = m_encodingMap.find(CodedChar(ch));
-			if(iter != m_encodingMap.end())
+			Byte b;
+			if(m_rpTable->encodeChar(ch, b))
 			{
-				*to_next++ = (*iter).second;
+				*to_next++ = b;
 				from_next = from_next_copy;
 			}
 			else // if the character is not in the map then we have an error
@@ -173,6 +198,17 @@ bool Simple8BitConverter::alwaysNoConversion() const
 	return (false);
 }
 
+//==============================================================================
+// Simple8BitConverter::findCharBoundary
+//
+// Every byte is a complete character.
+//==============================================================================
+const Byte* Simple8BitConverter::findCharBoundary(const Byte* /*from*/, const Byte* /*from_end*/,
+                                                  const Byte* pos) const
+{
+	return pos;
+}
+
 size_t Simple8BitConverter::getMaxEncodedLength() const
 {
 	return 1;
@@ -187,5 +223,14 @@ String Simple8BitConverter::getEncodingName() const
 	return m_name;
 }
 
+//==============================================================================
+// Simple8BitConverter::clone
+//
+//==============================================================================
+AutoPtr<CodeConverter> Simple8BitConverter::clone() const
+{
+	return new Simple8BitConverter(*this);
+}
+
 QC_CVT_NAMESPACE_END
 
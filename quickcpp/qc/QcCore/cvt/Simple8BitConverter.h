@@ -40,7 +40,7 @@
 #endif //QC_CVT_DEFS_h
 
 #include "CodeConverter.h"
-#include <map>
+#include "CodePageTable.h"
 
 QC_CVT_NAMESPACE_BEGIN
 
@@ -66,18 +66,22 @@ public:
 
 	virtual size_t getDecodedLength(const Byte *from, const Byte *from_end) const;
 
+	virtual const Byte* findCharBoundary(const Byte *from, const Byte *from_end,
+	                                     const Byte *pos) const;
+
 	virtual size_t getMaxEncodedLength() const;
 
 	virtual bool alwaysNoConversion() const;
 
 	virtual String getEncodingName() const;
 
+	virtual AutoPtr<CodeConverter> clone() const;
+
 protected:
 	void generateEncodingMap();
 
 private:
-	typedef std::map<CodedChar, Byte, std::less<CodedChar> > EncodingMap;
-	EncodingMap m_encodingMap;
+	AutoPtr<CodePageTable> m_rpTable;
 	const CodedChar* m_pDecodingTable;
 	String m_name;
 };
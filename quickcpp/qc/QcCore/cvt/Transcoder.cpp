@@ -0,0 +1,1055 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Transcoder
+// 
+// Transcoding through a Reader and a Writer decodes every byte into an
+// internal ::CharType buffer and then encodes the buffer again.  For the
+// common pairs of encodings a Transcoder instead uses one of the following
+// byte-to-byte loops:
+//
+// - single-byte to single-byte: a fused 256-entry table maps each source byte
+//   directly to its target byte.
+// - single-byte to UTF-8: a fused 256-entry table holds the complete UTF-8
+//   sequence for each source byte.
+// - UTF-8 to single-byte: UTF-8 sequences are decoded in-line and looked up
+//   in the target code page's encoding table.
+// - UTF-16BE/LE to UTF-8 and UTF-8 to UTF-16BE/LE: sequences are converted
+//   in-line, including surrogate pairs.
+//
+// In each case runs of US-ASCII are copied by VectorCodec.
+//
+// Single-byte encodings are recognized by their maximum encoded length.
+// Their tables are built by decoding each of the 256 byte values with a
+// clone of the converter, so any single-byte CodeConverter can take part.
+// UTF-8 and UTF-16 are recognized by their canonical encoding name.
+//
+// A specialized loop stops at the first sequence that it does not handle
+// (ill-formed input, unmappable characters, truncated sequences and
+// insufficient room in the output buffer).  The next few characters are then
+// converted by the CodeConverters themselves, which apply the invalid and
+// unmappable character policies exactly as a Reader or Writer would.
+//
+// The first characters are always converted by the CodeConverters, so that
+// an encoder that writes a byte-order mark (such as the UTF-16 encoder) has
+// done so before a specialized loop takes over.
+//
+// Characters that have been decoded but could not be encoded for lack of
+// room are held in a pending buffer and are written before any more input
+// is converted.
+//
+//==============================================================================
+
+#include "Transcoder.h"
+#include "CodePageTable.h"
+#include "VectorCodec.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/SystemCodeConverter.h"
+#include "QcCore/base/UnsupportedOperationException.h"
+#include "QcCore/io/CharacterCodingException.h"
+#include "QcCore/io/MalformedInputException.h"
+
+#include <string.h>
+
+QC_CVT_NAMESPACE_BEGIN
+
+using io::CharacterCodingException;
+using io::MalformedInputException;
+
+//==============================================================================
+// DecodeUTF8
+//
+// Decodes the well-formed UTF-8 sequence at @c from.  Returns the length of
+// the sequence, or zero if the sequence is truncated, ill-formed or encodes
+// a surrogate.
+//==============================================================================
+static inline size_t DecodeUTF8(const Byte* from, const Byte* from_end, UCS4Char& ch)
+{
+	const Byte lead = from[0];
+	const size_t avail = from_end - from;
+
+	if(lead < 0x80U)
+	{
+		ch = lead;
+		return 1;
+	}
+	else if(lead < 0xC2U)
+	{
+		return 0;
+	}
+	else if(lead < 0xE0U)
+	{
+		if(avail < 2 || (from[1] & 0xC0) != 0x80)
+			return 0;
+		ch = ((lead & 0x1F) << 6) | (from[1] & 0x3F);
+		return 2;
+	}
+	else if(lead < 0xF0U)
+	{
+		if(avail < 3 || (from[1] & 0xC0) != 0x80 || (from[2] & 0xC0) != 0x80)
+			return 0;
+		ch = ((lead & 0x0F) << 12) | ((from[1] & 0x3F) << 6) | (from[2] & 0x3F);
+		if(ch < 0x800U || (ch >= 0xD800U && ch <= 0xDFFFU))
+			return 0;
+		return 3;
+	}
+	else if(lead < 0xF5U)
+	{
+		if(avail < 4 || (from[1] & 0xC0) != 0x80 || (from[2] & 0xC0) != 0x80 ||
+		   (from[3] & 0xC0) != 0x80)
+			return 0;
+		ch = ((lead & 0x07) << 18) | ((from[1] & 0x3F) << 12) |
+		     ((from[2] & 0x3F) << 6) | (from[3] & 0x3F);
+		if(ch < 0x10000U || ch > 0x10FFFFU)
+			return 0;
+		return 4;
+	}
+	return 0;
+}
+
+//==============================================================================
+// EncodeUTF8
+//
+// Encodes a Unicode scalar value into 1-4 bytes at @c to, which must have room
+// for the complete sequence.  Returns the length of the sequence.
+//==============================================================================
+static inline size_t EncodeUTF8(UCS4Char ch, Byte* to)
+{
+	if(ch < 0x80U)
+	{
+		to[0] = Byte(ch);
+		return 1;
+	}
+	else if(ch < 0x800U)
+	{
+		to[0] = Byte(0xC0 | (ch >> 6));
+		to[1] = Byte(0x80 | (ch & 0x3F));
+		return 2;
+	}
+	else if(ch < 0x10000U)
+	{
+		to[0] = Byte(0xE0 | (ch >> 12));
+		to[1] = Byte(0x80 | ((ch >> 6) & 0x3F));
+		to[2] = Byte(0x80 | (ch & 0x3F));
+		return 3;
+	}
+	else
+	{
+		to[0] = Byte(0xF0 | (ch >> 18));
+		to[1] = Byte(0x80 | ((ch >> 12) & 0x3F));
+		to[2] = Byte(0x80 | ((ch >> 6) & 0x3F));
+		to[3] = Byte(0x80 | (ch & 0x3F));
+		return 4;
+	}
+}
+
+//==============================================================================
+// IsASCIIBlock
+//
+// Tests whether the ShortRunLength bytes at @c p are all US-ASCII.
+//==============================================================================
+static inline bool IsASCIIBlock(const Byte* p)
+{
+	return ((p[0] | p[1] | p[2] | p[3] | p[4] | p[5] | p[6] | p[7]) & 0x80) == 0;
+}
+
+//==============================================================================
+// Transcoder::Transcoder
+//
+/**
+   Constructs a Transcoder that decodes bytes using @c pDecoder and encodes
+   them using @c pEncoder.
+   
+   The Transcoder takes ownership of both CodeConverters, which must not be
+   used for any other purpose while the Transcoder exists.
+
+   @throws NullPointerException if either converter is null.
+*/
+//==============================================================================
+Transcoder::Transcoder(CodeConverter* pDecoder, CodeConverter* pEncoder) :
+	m_rpDecoder(pDecoder),
+	m_rpEncoder(pEncoder),
+	m_kernel(generic),
+	m_bBigEndian(false),
+	m_bASCIICompatible(false),
+	m_bStarted(false),
+	m_pPendingNext(m_pending),
+	m_pPendingEnd(m_pending)
+{
+	if(!pDecoder || !pEncoder) throw NullPointerException();
+	selectKernel();
+}
+
+//==============================================================================
+// Transcoder::Transcoder
+//
+// Constructs a Transcoder for the converters, which are clones of those of
+// @c prototype, sharing the prototype's tables rather than building them
+// again.
+//==============================================================================
+Transcoder::Transcoder(CodeConverter* pDecoder, CodeConverter* pEncoder,
+                       const Transcoder& prototype) :
+	m_rpDecoder(pDecoder),
+	m_rpEncoder(pEncoder),
+	m_rpSourceTable(prototype.m_rpSourceTable),
+	m_rpTargetTable(prototype.m_rpTargetTable),
+	m_kernel(prototype.m_kernel),
+	m_bBigEndian(prototype.m_bBigEndian),
+	m_bASCIICompatible(prototype.m_bASCIICompatible),
+	m_bStarted(false),
+	m_pPendingNext(m_pending),
+	m_pPendingEnd(m_pending)
+{
+	::memcpy(m_byteTable, prototype.m_byteTable, sizeof(m_byteTable));
+	::memcpy(m_utf8Table, prototype.m_utf8Table, sizeof(m_utf8Table));
+	::memcpy(m_utf8Length, prototype.m_utf8Length, sizeof(m_utf8Length));
+}
+
+//==============================================================================
+// Transcoder::~Transcoder
+//
+//==============================================================================
+Transcoder::~Transcoder()
+{
+}
+
+//==============================================================================
+// Transcoder::GetForm
+//
+// Classifies a CodeConverter by the form of its encoding.  For single-byte
+// encodings @c rpTable is set to the code page's table.
+//==============================================================================
+Transcoder::Form Transcoder::GetForm(CodeConverter* pConverter,
+                                     AutoPtr<CodePageTable>& rpTable)
+{
+	const String name = pConverter->getEncodingName();
+
+	if(name == QC_T("UTF-8"))
+	{
+		return utf8;
+	}
+	else if(name == QC_T("UTF-16BE"))
+	{
+		return utf16be;
+	}
+	else if(name == QC_T("UTF-16LE"))
+	{
+		return utf16le;
+	}
+	else if(pConverter->getMaxEncodedLength() == 1)
+	{
+		rpTable = ProbeCodePage(pConverter);
+		if(rpTable)
+		{
+			return singleByte;
+		}
+	}
+	return other;
+}
+
+//==============================================================================
+// Transcoder::ProbeCodePage
+//
+// Builds a CodePageTable for a single-byte encoding by decoding each byte
+// value with a clone of the converter.  Bytes that the converter does not
+// decode into a single BMP character are left undefined so that they are
+// always handled by the converter itself.  Returns null if the converter
+// cannot be cloned.
+//==============================================================================
+AutoPtr<CodePageTable> Transcoder::ProbeCodePage(CodeConverter* pConverter)
+{
+	AutoPtr<CodeConverter> rpProbe;
+
+	try
+	{
+		rpProbe = pConverter->clone();
+	}
+	catch(UnsupportedOperationException& /*e*/)
+	{
+		return 0;
+	}
+
+	rpProbe->setInvalidCharAction(CodeConverter::replace);
+	rpProbe->setInvalidCharReplacement(CodePageTable::Undefined);
+
+	CodePageTable::CodedChar decodingTable[256];
+
+	for(size_t i=0; i<256; ++i)
+	{
+		const Byte byte = Byte(i);
+		const Byte* pByteNext;
+		CharType buffer[RecoveryBlockSize];
+		CharType* pCharEnd;
+		UCS4Char ch = CodePageTable::Undefined;
+
+		if(rpProbe->decode(&byte, &byte+1, pByteNext, buffer, buffer+RecoveryBlockSize, pCharEnd) == CodeConverter::ok
+		   && pByteNext == &byte+1 && pCharEnd > buffer)
+		{
+			const CharType* pCharNext;
+			if(SystemCodeConverter::FromInternalEncoding(ch, buffer, pCharEnd, pCharNext) != CodeConverter::ok
+			   || pCharNext != pCharEnd || ch > CodePageTable::Undefined)
+			{
+				ch = CodePageTable::Undefined;
+			}
+		}
+		decodingTable[i] = CodePageTable::CodedChar(ch);
+	}
+
+	return CodePageTable::CreateTable(decodingTable);
+}
+
+//==============================================================================
+// Transcoder::selectKernel
+//
+// Chooses the conversion loop for the pair of encodings and builds any
+// fused tables that it requires.
+//==============================================================================
+void Transcoder::selectKernel()
+{
+	const Form source = GetForm(m_rpDecoder.get(), m_rpSourceTable);
+	const Form target = GetForm(m_rpEncoder.get(), m_rpTargetTable);
+	size_t i;
+
+	if(source == singleByte && target == singleByte)
+	{
+		m_kernel = byteToByte;
+		for(i=0; i<256; ++i)
+		{
+			const UCS4Char ch = m_rpSourceTable->decodeByte(Byte(i));
+			Byte b;
+			if(ch != CodePageTable::Undefined && m_rpTargetTable->encodeChar(ch, b))
+				m_byteTable[i] = b;
+			else
+				m_byteTable[i] = Unmapped;
+		}
+	}
+	else if(source == singleByte && target == utf8)
+	{
+		m_kernel = byteToUTF8;
+		m_bASCIICompatible = true;
+		for(i=0; i<256; ++i)
+		{
+			const UCS4Char ch = m_rpSourceTable->decodeByte(Byte(i));
+			Byte sequence[4] = {0, 0, 0, 0};
+			m_utf8Length[i] = (ch != CodePageTable::Undefined) ? Byte(EncodeUTF8(ch, sequence)) : 0;
+			::memcpy(&m_utf8Table[i], sequence, sizeof(sequence));
+			if(i < 0x80 && ch != i)
+			{
+				m_bASCIICompatible = false;
+			}
+		}
+	}
+	else if(source == utf8 && target == singleByte)
+	{
+		m_kernel = utf8ToByte;
+		m_bASCIICompatible = true;
+		for(i=0; i<0x80; ++i)
+		{
+			Byte b;
+			if(!m_rpTargetTable->encodeChar(UCS4Char(i), b) || b != i)
+			{
+				m_bASCIICompatible = false;
+			}
+		}
+	}
+	else if((source == utf16be || source == utf16le) && target == utf8)
+	{
+		m_kernel = utf16ToUTF8;
+		m_bBigEndian = (source == utf16be);
+	}
+	else if(source == utf8 && (target == utf16be || target == utf16le))
+	{
+		m_kernel = utf8ToUTF16;
+		m_bBigEndian = (target == utf16be);
+	}
+}
+
+//==============================================================================
+// Transcoder::transcode
+//
+/**
+   Converts bytes from the source encoding into bytes in the target encoding.
+   
+   Conversion stops when the input is exhausted, when there is insufficient
+   room in the output buffer or when the input ends with an incomplete
+   sequence.  Characters that have been decoded but not yet written are held
+   by the Transcoder and are written before any further input is converted.
+
+   @returns CodeConverter::ok if all the input was converted;
+            CodeConverter::inputExhausted if the input ends with an
+            incomplete sequence, which is left unconsumed;
+            CodeConverter::outputExhausted if there was insufficient room in
+            the output buffer; or CodeConverter::error if conversion
+            stopped at an error after some bytes had been converted, or a
+            converter reported an error without throwing an exception.
+   @throws CharacterCodingException if a converter detects an invalid or
+           unmappable character and its policy is to abort.  The exception
+           is only thrown when no bytes have been converted by this call;
+           otherwise CodeConverter::error is returned and the exception is
+           thrown by the next call.
+*/
+//==============================================================================
+Transcoder::Result Transcoder::transcode(const Byte* from, const Byte* from_end,
+                                         const Byte*& from_next,
+                                         Byte* to, Byte* to_limit,
+                                         Byte*& to_next)
+{
+	from_next = from, to_next = to;
+
+	if(m_pPendingNext < m_pPendingEnd)
+	{
+		const Result ret = flush(to_next, to_limit, to_next);
+		if(ret != CodeConverter::ok)
+		{
+			return ret;
+		}
+	}
+
+	while(from_next < from_end)
+	{
+		size_t maxChars = GenericBlockSize;
+
+		if(m_kernel != generic && m_bStarted)
+		{
+			switch(m_kernel)
+			{
+			case byteToByte:
+				transcodeByteToByte(from_next, from_end, to_next, to_limit);
+				break;
+			case byteToUTF8:
+				transcodeByteToUTF8(from_next, from_end, to_next, to_limit);
+				break;
+			case utf8ToByte:
+				transcodeUTF8ToByte(from_next, from_end, to_next, to_limit);
+				break;
+			case utf16ToUTF8:
+				transcodeUTF16ToUTF8(from_next, from_end, to_next, to_limit);
+				break;
+			case utf8ToUTF16:
+				transcodeUTF8ToUTF16(from_next, from_end, to_next, to_limit);
+				break;
+			default:
+				break;
+			}
+
+			if(from_next == from_end)
+			{
+				break;
+			}
+
+			//
+			// Convert just enough with the CodeConverters to get past the
+			// sequence that stopped the specialized loop
+			//
+			maxChars = RecoveryBlockSize;
+		}
+
+		const Byte* pStart = from_next;
+		Byte* pOutStart = to_next;
+
+		Result ret;
+
+		try
+		{
+			ret = transcodeGeneric(from_next, from_end, from_next,
+			                       to_next, to_limit, to_next, maxChars);
+		}
+		catch(CharacterCodingException& /*e*/)
+		{
+			//
+			// Return the bytes converted so far.  The next call will
+			// encounter the same error and raise the exception again.
+			//
+			if(to_next == to)
+			{
+				throw;
+			}
+			return CodeConverter::error;
+		}
+
+		if(ret != CodeConverter::ok)
+		{
+			return ret;
+		}
+		else if(from_next == pStart && to_next == pOutStart)
+		{
+			// no progress is possible
+			return (to_next == to_limit) ? CodeConverter::outputExhausted
+			                             : CodeConverter::inputExhausted;
+		}
+	}
+
+	return CodeConverter::ok;
+}
+
+//==============================================================================
+// Transcoder::transcodeGeneric
+//
+// Converts up to @c maxChars internal characters using the CodeConverters.
+// Returns ok if conversion may continue.
+//==============================================================================
+Transcoder::Result Transcoder::transcodeGeneric(const Byte* from, const Byte* from_end,
+                                                const Byte*& from_next,
+                                                Byte* to, Byte* to_limit,
+                                                Byte*& to_next, size_t maxChars)
+{
+	QC_DBG_ASSERT(m_pPendingNext == m_pPendingEnd);
+	QC_DBG_ASSERT(maxChars <= GenericBlockSize);
+
+	CharType buffer[GenericBlockSize];
+	CharType* pCharEnd = buffer;
+	to_next = to;
+
+	Result decodeResult;
+
+	try
+	{
+		decodeResult = m_rpDecoder->decode(from, from_end, from_next,
+		                                   buffer, buffer+maxChars, pCharEnd);
+	}
+	catch(CharacterCodingException& /*e*/)
+	{
+		//
+		// If some characters were decoded before the error was detected,
+		// write them now and leave the exception to be raised again by the
+		// next call, as InputStreamReader does
+		//
+		if(pCharEnd == buffer)
+		{
+			throw;
+		}
+		decodeResult = CodeConverter::ok;
+	}
+
+	if(pCharEnd > buffer)
+	{
+		const CharType* pCharNext = buffer;
+		Result encodeResult;
+
+		try
+		{
+			encodeResult = m_rpEncoder->encode(buffer, pCharEnd, pCharNext,
+			                                   to, to_limit, to_next);
+		}
+		catch(CharacterCodingException& /*e*/)
+		{
+			//
+			// The input has already been consumed, so the characters
+			// that were not encoded must be kept
+			//
+			setPending(pCharNext, pCharEnd);
+			throw;
+		}
+
+		if(pCharNext > buffer)
+		{
+			m_bStarted = true;
+		}
+
+		if(pCharNext < pCharEnd)
+		{
+			setPending(pCharNext, pCharEnd);
+			return (encodeResult == CodeConverter::error) ? CodeConverter::error
+			                                              : CodeConverter::outputExhausted;
+		}
+	}
+
+	switch(decodeResult)
+	{
+	case CodeConverter::inputExhausted:
+	case CodeConverter::error:
+		return decodeResult;
+	default:
+		return CodeConverter::ok;
+	}
+}
+
+//==============================================================================
+// Transcoder::setPending
+//
+// Saves characters that have been decoded but not encoded.
+//==============================================================================
+void Transcoder::setPending(const CharType* from, const CharType* from_end)
+{
+	QC_DBG_ASSERT(from_end - from <= GenericBlockSize);
+
+	const size_t remaining = from_end - from;
+	::memmove(m_pending, from, remaining * sizeof(CharType));
+	m_pPendingNext = m_pending;
+	m_pPendingEnd = m_pending + remaining;
+}
+
+//==============================================================================
+// Transcoder::flush
+//
+/**
+   Writes any characters that have been decoded but not yet encoded.
+
+   @returns CodeConverter::ok if there are no characters left to write;
+            CodeConverter::outputExhausted if there was insufficient room in
+            the output buffer; or CodeConverter::error if the encoder
+            detected an error after some bytes had been written.
+   @throws CharacterCodingException if the encoder detects an unmappable
+           character, its policy is to abort and no bytes have been written.
+*/
+//==============================================================================
+Transcoder::Result Transcoder::flush(Byte* to, Byte* to_limit, Byte*& to_next)
+{
+	to_next = to;
+
+	if(m_pPendingNext < m_pPendingEnd)
+	{
+		const CharType* pCharNext = m_pPendingNext;
+		Result ret;
+
+		try
+		{
+			ret = m_rpEncoder->encode(m_pPendingNext, m_pPendingEnd, pCharNext,
+			                          to, to_limit, to_next);
+		}
+		catch(CharacterCodingException& /*e*/)
+		{
+			m_pPendingNext = pCharNext;
+			if(to_next == to)
+			{
+				throw;
+			}
+			return CodeConverter::error;
+		}
+
+		if(pCharNext > m_pPendingNext)
+		{
+			m_bStarted = true;
+		}
+		m_pPendingNext = pCharNext;
+
+		if(m_pPendingNext < m_pPendingEnd)
+		{
+			return (ret == CodeConverter::error) ? CodeConverter::error
+			                                     : CodeConverter::outputExhausted;
+		}
+	}
+
+	m_pPendingNext = m_pPendingEnd = m_pending;
+	return CodeConverter::ok;
+}
+
+//==============================================================================
+// Transcoder::endOfInput
+//
+/**
+   Informs the Transcoder that the input has ended with the incomplete
+   sequence [from, from_end).
+   
+   If the decoder's policy for invalid characters is to abort, a
+   MalformedInputException is thrown.  Otherwise the decoder's replacement
+   character is added to the pending output, which must then be written
+   using flush().
+
+   @throws MalformedInputException if the decoder's policy is to abort.
+*/
+//==============================================================================
+void Transcoder::endOfInput(const Byte* from, const Byte* from_end)
+{
+	if(from == from_end)
+	{
+		return;
+	}
+
+	if(m_rpDecoder->getInvalidCharAction() == CodeConverter::abort)
+	{
+		throw MalformedInputException(QC_T("premature EOF within multi-byte sequence"), m_rpDecoder.get());
+	}
+
+	if(m_pPendingNext == m_pPendingEnd)
+	{
+		m_pPendingNext = m_pPendingEnd = m_pending;
+	}
+	else if(m_pPendingNext > m_pending)
+	{
+		const size_t pending = m_pPendingEnd - m_pPendingNext;
+		::memmove(m_pending, m_pPendingNext, pending * sizeof(CharType));
+		m_pPendingNext = m_pending;
+		m_pPendingEnd = m_pending + pending;
+	}
+
+	CharType* pEnd = m_pending + (m_pPendingEnd - m_pending);
+	SystemCodeConverter::ToInternalEncoding(m_rpDecoder->getInvalidCharReplacement(),
+		pEnd, m_pending+GenericBlockSize, pEnd);
+	m_pPendingEnd = pEnd;
+}
+
+//==============================================================================
+// Transcoder::hasPendingOutput
+//
+/**
+   Tests whether the Transcoder holds characters that have not yet been
+   written.
+*/
+//==============================================================================
+bool Transcoder::hasPendingOutput() const
+{
+	return (m_pPendingNext < m_pPendingEnd);
+}
+
+//==============================================================================
+// Transcoder::getDecoder
+//
+/**
+   Returns the CodeConverter used to decode the source encoding.
+*/
+//==============================================================================
+AutoPtr<CodeConverter> Transcoder::getDecoder() const
+{
+	return m_rpDecoder;
+}
+
+//==============================================================================
+// Transcoder::getEncoder
+//
+/**
+   Returns the CodeConverter used to encode the target encoding.
+*/
+//==============================================================================
+AutoPtr<CodeConverter> Transcoder::getEncoder() const
+{
+	return m_rpEncoder;
+}
+
+//==============================================================================
+// Transcoder::clone
+//
+/**
+   Returns a new Transcoder that converts between the same encodings using
+   clones of this Transcoder's CodeConverters.
+
+   The new Transcoder shares the tables that this one built for its pair of
+   encodings, so it is much cheaper to create than a Transcoder constructed
+   from the converters.  It starts with no pending output.
+
+   @throws UnsupportedOperationException if either CodeConverter does not
+           support cloning.
+   @sa CodeConverter::clone()
+*/
+//==============================================================================
+AutoPtr<Transcoder> Transcoder::clone() const
+{
+	AutoPtr<CodeConverter> rpDecoder = m_rpDecoder->clone();
+	AutoPtr<CodeConverter> rpEncoder = m_rpEncoder->clone();
+	return new Transcoder(rpDecoder.get(), rpEncoder.get(), *this);
+}
+
+//==============================================================================
+// Transcoder::transcodeByteToByte
+//
+// Single-byte to single-byte using the fused byte table.
+//==============================================================================
+void Transcoder::transcodeByteToByte(const Byte*& from_next, const Byte* from_end,
+                                     Byte*& to_next, Byte* to_limit) const
+{
+	const Byte* pFrom = from_next;
+	Byte* pTo = to_next;
+	const Byte* pEnd = (to_limit - pTo < from_end - pFrom) ? pFrom + (to_limit - pTo) : from_end;
+
+	for(; pFrom < pEnd; ++pFrom, ++pTo)
+	{
+		const unsigned short b = m_byteTable[*pFrom];
+		if(b == Unmapped)
+		{
+			break;
+		}
+		*pTo = Byte(b);
+	}
+
+	from_next = pFrom;
+	to_next = pTo;
+}
+
+//==============================================================================
+// Transcoder::transcodeByteToUTF8
+//
+// Single-byte to UTF-8 using the fused table of UTF-8 sequences.  While there
+// is ample room in the output buffer, each sequence is stored as a single
+// 4-byte word and the output pointer is advanced by the sequence length,
+// which avoids branching on the length of each sequence.
+//==============================================================================
+void Transcoder::transcodeByteToUTF8(const Byte*& from_next, const Byte* from_end,
+                                     Byte*& to_next, Byte* to_limit) const
+{
+	const Byte* pFrom = from_next;
+	Byte* pTo = to_next;
+	const unsigned int* pTable = m_utf8Table;
+	const Byte* pLength = m_utf8Length;
+	const bool bASCII = m_bASCIICompatible;
+
+	while(from_end - pFrom >= (ptrdiff_t)VectorCodec::ShortRunLength &&
+	      to_limit - pTo >= (ptrdiff_t)(4 * VectorCodec::ShortRunLength))
+	{
+		if(bASCII && IsASCIIBlock(pFrom))
+		{
+			if(from_end - pFrom >= (ptrdiff_t)(2 * VectorCodec::ShortRunLength) &&
+			   IsASCIIBlock(pFrom + VectorCodec::ShortRunLength))
+			{
+				const size_t runLen = (to_limit - pTo < from_end - pFrom) ? to_limit - pTo : from_end - pFrom;
+				const size_t copied = VectorCodec::CopyASCII(pFrom, runLen, pTo);
+				pFrom += copied;
+				pTo += copied;
+			}
+			else
+			{
+				::memcpy(pTo, pFrom, VectorCodec::ShortRunLength);
+				pFrom += VectorCodec::ShortRunLength;
+				pTo += VectorCodec::ShortRunLength;
+			}
+			continue;
+		}
+
+		const Byte* pBlockEnd = pFrom + VectorCodec::ShortRunLength;
+		for(; pFrom < pBlockEnd; ++pFrom)
+		{
+			const size_t len = pLength[*pFrom];
+			if(len == 0)
+			{
+				break;
+			}
+			::memcpy(pTo, &pTable[*pFrom], sizeof(unsigned int));
+			pTo += len;
+		}
+
+		if(pFrom < pBlockEnd)
+		{
+			break;
+		}
+	}
+
+	for(; pFrom < from_end; ++pFrom)
+	{
+		const size_t len = pLength[*pFrom];
+		if(len == 0 || to_limit - pTo < (ptrdiff_t)len)
+		{
+			break;
+		}
+		::memcpy(pTo, &pTable[*pFrom], len);
+		pTo += len;
+	}
+
+	from_next = pFrom;
+	to_next = pTo;
+}
+
+//==============================================================================
+// Transcoder::transcodeUTF8ToByte
+//
+// UTF-8 to single-byte using the target code page's encoding table.
+//==============================================================================
+void Transcoder::transcodeUTF8ToByte(const Byte*& from_next, const Byte* from_end,
+                                     Byte*& to_next, Byte* to_limit) const
+{
+	const Byte* pFrom = from_next;
+	Byte* pTo = to_next;
+	const CodePageTable* pTable = m_rpTargetTable.get();
+	const bool bASCII = m_bASCIICompatible;
+
+	while(pFrom < from_end && pTo < to_limit)
+	{
+		if(bASCII && *pFrom < 0x80U)
+		{
+			if(from_end - pFrom >= (ptrdiff_t)VectorCodec::ShortRunLength &&
+			   to_limit - pTo >= (ptrdiff_t)VectorCodec::ShortRunLength &&
+			   IsASCIIBlock(pFrom))
+			{
+				if(from_end - pFrom >= (ptrdiff_t)(2 * VectorCodec::ShortRunLength) &&
+				   IsASCIIBlock(pFrom + VectorCodec::ShortRunLength))
+				{
+					const size_t runLen = (to_limit - pTo < from_end - pFrom) ? to_limit - pTo : from_end - pFrom;
+					const size_t copied = VectorCodec::CopyASCII(pFrom, runLen, pTo);
+					pFrom += copied;
+					pTo += copied;
+				}
+				else
+				{
+					::memcpy(pTo, pFrom, VectorCodec::ShortRunLength);
+					pFrom += VectorCodec::ShortRunLength;
+					pTo += VectorCodec::ShortRunLength;
+				}
+			}
+			else
+			{
+				*pTo++ = *pFrom++;
+			}
+			continue;
+		}
+
+		UCS4Char ch;
+		Byte b;
+		const size_t len = DecodeUTF8(pFrom, from_end, ch);
+		if(len == 0 || !pTable->encodeChar(ch, b))
+		{
+			break;
+		}
+		*pTo++ = b;
+		pFrom += len;
+	}
+
+	from_next = pFrom;
+	to_next = pTo;
+}
+
+//==============================================================================
+// Transcoder::transcodeUTF16ToUTF8
+//
+// UTF-16BE or UTF-16LE to UTF-8.
+//==============================================================================
+void Transcoder::transcodeUTF16ToUTF8(const Byte*& from_next, const Byte* from_end,
+                                      Byte*& to_next, Byte* to_limit) const
+{
+	const Byte* pFrom = from_next;
+	Byte* pTo = to_next;
+	const size_t hi = m_bBigEndian ? 0 : 1;
+
+	while(from_end - pFrom >= 2)
+	{
+		const UCS4Char W1 = (UCS4Char(pFrom[hi]) << 8) | pFrom[1-hi];
+
+		if(W1 < 0x80U)
+		{
+			if(to_limit - pTo < 1)
+			{
+				break;
+			}
+
+			const size_t units = (from_end - pFrom) / 2;
+			if(units > VectorCodec::ShortRunLength && size_t(to_limit - pTo) > VectorCodec::ShortRunLength)
+			{
+				const size_t runLen = (size_t(to_limit - pTo) < units) ? to_limit - pTo : units;
+				const size_t copied = VectorCodec::UTF16ToASCII(pFrom, runLen, pTo, m_bBigEndian);
+				pFrom += 2*copied;
+				pTo += copied;
+			}
+			else
+			{
+				*pTo++ = Byte(W1);
+				pFrom += 2;
+			}
+		}
+		else if((W1 & 0xF800) != 0xD800)
+		{
+			if(to_limit - pTo < 3)
+			{
+				break;
+			}
+			pTo += EncodeUTF8(W1, pTo);
+			pFrom += 2;
+		}
+		else
+		{
+			if(from_end - pFrom < 4 || to_limit - pTo < 4 || (W1 & 0xFC00) != 0xD800)
+			{
+				break;
+			}
+			const UCS4Char W2 = (UCS4Char(pFrom[2+hi]) << 8) | pFrom[3-hi];
+			if((W2 & 0xFC00) != 0xDC00)
+			{
+				break;
+			}
+			pTo += EncodeUTF8((((W1 & 0x03FF) << 10) | (W2 & 0x03FF)) + 0x10000, pTo);
+			pFrom += 4;
+		}
+	}
+
+	from_next = pFrom;
+	to_next = pTo;
+}
+
+//==============================================================================
+// Transcoder::transcodeUTF8ToUTF16
+//
+// UTF-8 to UTF-16BE or UTF-16LE.
+//==============================================================================
+void Transcoder::transcodeUTF8ToUTF16(const Byte*& from_next, const Byte* from_end,
+                                      Byte*& to_next, Byte* to_limit) const
+{
+	const Byte* pFrom = from_next;
+	Byte* pTo = to_next;
+	const size_t hi = m_bBigEndian ? 0 : 1;
+
+	while(pFrom < from_end && to_limit - pTo >= 2)
+	{
+		if(*pFrom < 0x80U)
+		{
+			const size_t units = (to_limit - pTo) / 2;
+			if(from_end - pFrom > (ptrdiff_t)VectorCodec::ShortRunLength && units > VectorCodec::ShortRunLength &&
+			   IsASCIIBlock(pFrom))
+			{
+				const size_t runLen = (units < size_t(from_end - pFrom)) ? units : from_end - pFrom;
+				const size_t copied = VectorCodec::ASCIIToUTF16(pFrom, runLen, pTo, m_bBigEndian);
+				pFrom += copied;
+				pTo += 2*copied;
+			}
+			else
+			{
+				pTo[hi] = 0;
+				pTo[1-hi] = *pFrom++;
+				pTo += 2;
+			}
+			continue;
+		}
+
+		UCS4Char ch;
+		const size_t len = DecodeUTF8(pFrom, from_end, ch);
+		if(len == 0)
+		{
+			break;
+		}
+
+		if(ch < 0x10000U)
+		{
+			pTo[hi] = Byte(ch >> 8);
+			pTo[1-hi] = Byte(ch);
+			pTo += 2;
+		}
+		else
+		{
+			if(to_limit - pTo < 4)
+			{
+				break;
+			}
+			const UCS4Char W1 = 0xD800 | ((ch - 0x10000) >> 10);
+			const UCS4Char W2 = 0xDC00 | (ch & 0x03FF);
+			pTo[hi] = Byte(W1 >> 8);
+			pTo[1-hi] = Byte(W1);
+			pTo[2+hi] = Byte(W2 >> 8);
+			pTo[3-hi] = Byte(W2);
+			pTo += 4;
+		}
+		pFrom += len;
+	}
+
+	from_next = pFrom;
+	to_next = pTo;
+}
+
+QC_CVT_NAMESPACE_END
@@ -0,0 +1,128 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Transcoder
+// 
+// Converts bytes in one encoding directly into bytes in another encoding.
+// 
+// A Transcoder is constructed from a pair of CodeConverters: one that
+// decodes the source encoding and one that encodes the target encoding.
+// Common pairs of encodings are converted by specialized loops that never
+// produce internal characters; all other pairs, and any input that the
+// specialized loops do not handle, are converted by the CodeConverters
+// themselves.
+//
+//==============================================================================
+
+#ifndef QC_CVT_Transcoder_h
+#define QC_CVT_Transcoder_h
+
+#ifndef QC_CVT_DEFS_h
+#include "defs.h"
+#endif //QC_CVT_DEFS_h
+
+#include "CodeConverter.h"
+
+QC_CVT_NAMESPACE_BEGIN
+
+class CodePageTable;
+
+class QC_CVT_PKG Transcoder : public virtual QCObject
+{
+public:
+
+	typedef CodeConverter::Result Result;
+
+	Transcoder(CodeConverter* pDecoder, CodeConverter* pEncoder);
+	virtual ~Transcoder();
+
+	Result transcode(const Byte* from, const Byte* from_end,
+	                 const Byte*& from_next,
+	                 Byte* to, Byte* to_limit,
+	                 Byte*& to_next);
+
+	Result flush(Byte* to, Byte* to_limit, Byte*& to_next);
+
+	void endOfInput(const Byte* from, const Byte* from_end);
+
+	bool hasPendingOutput() const;
+
+	AutoPtr<CodeConverter> getDecoder() const;
+	AutoPtr<CodeConverter> getEncoder() const;
+
+	AutoPtr<Transcoder> clone() const;
+
+private:
+	Transcoder(const Transcoder& rhs);            // not implemented
+	Transcoder& operator=(const Transcoder& rhs); // not implemented
+
+	Transcoder(CodeConverter* pDecoder, CodeConverter* pEncoder,
+	           const Transcoder& prototype);
+
+	enum Form {other, singleByte, utf8, utf16be, utf16le};
+	enum Kernel {generic, byteToByte, byteToUTF8, utf8ToByte, utf16ToUTF8, utf8ToUTF16};
+	enum {GenericBlockSize = 256, RecoveryBlockSize = 8, Unmapped = 0x100};
+
+	static Form GetForm(CodeConverter* pConverter, AutoPtr<CodePageTable>& rpTable);
+	static AutoPtr<CodePageTable> ProbeCodePage(CodeConverter* pConverter);
+
+	void selectKernel();
+	Result transcodeGeneric(const Byte* from, const Byte* from_end,
+	                        const Byte*& from_next,
+	                        Byte* to, Byte* to_limit,
+	                        Byte*& to_next, size_t maxChars);
+	void setPending(const CharType* from, const CharType* from_end);
+
+	void transcodeByteToByte(const Byte*& from_next, const Byte* from_end,
+	                         Byte*& to_next, Byte* to_limit) const;
+	void transcodeByteToUTF8(const Byte*& from_next, const Byte* from_end,
+	                         Byte*& to_next, Byte* to_limit) const;
+	void transcodeUTF8ToByte(const Byte*& from_next, const Byte* from_end,
+	                         Byte*& to_next, Byte* to_limit) const;
+	void transcodeUTF16ToUTF8(const Byte*& from_next, const Byte* from_end,
+	                          Byte*& to_next, Byte* to_limit) const;
+	void transcodeUTF8ToUTF16(const Byte*& from_next, const Byte* from_end,
+	                          Byte*& to_next, Byte* to_limit) const;
+
+private:
+	AutoPtr<CodeConverter> m_rpDecoder;
+	AutoPtr<CodeConverter> m_rpEncoder;
+	AutoPtr<CodePageTable> m_rpSourceTable;
+	AutoPtr<CodePageTable> m_rpTargetTable;
+	Kernel m_kernel;
+	bool m_bBigEndian;
+	bool m_bASCIICompatible;
+	bool m_bStarted;
+	unsigned short m_byteTable[256];
+	unsigned int m_utf8Table[256];
+	Byte m_utf8Length[256];
+	CharType m_pending[GenericBlockSize];
+	const CharType* m_pPendingNext;
+	const CharType* m_pPendingEnd;
+};
+
+QC_CVT_NAMESPACE_END
+
+#endif //QC_CVT_Transcoder_h
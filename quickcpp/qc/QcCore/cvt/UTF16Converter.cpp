@@ -43,6 +43,7 @@
 //==============================================================================
 
 #include "UTF16Converter.h"
+#include "VectorCodec.h"
 
 #include "QcCore/io/IOException.h"
 #include "QcCore/base/SystemCodeConverter.h"
@@ -118,7 +119,23 @@ CodeConverter::Result UTF16Converter::decode(const Byte *from, const Byte *from_
 			//
 			if((W1 & 0xF800) != 0xD800) // ie not a surrogate
 			{
-				if( (ret=SystemCodeConverter::ToInternalEncoding(W1, to_next, to_limit, to_next)) == ok)
+				//
+				// Decode the whole run of non-surrogate code units that
+				// starts here in one go.  The run is empty only when the
+				// internal encoding needs more than one character for W1.
+				//
+				const size_t maxUnits = (from_end - from_next) / 2;
+				const size_t maxChars = to_limit - to_next;
+				const size_t run = VectorCodec::DecodeUTF16(from_next,
+					(maxUnits < maxChars) ? maxUnits : maxChars,
+					to_next, m_endianness==big_endian);
+
+				if(run)
+				{
+					from_next += 2*run;
+					to_next += run;
+				}
+				else if( (ret=SystemCodeConverter::ToInternalEncoding(W1, to_next, to_limit, to_next)) == ok)
 				{
 					from_next+=2;
 				}
@@ -320,6 +337,23 @@ CodeConverter::Result UTF16Converter::encode(const CharType *from, const CharTyp
 	//
 	while(ret == ok && from_next < from_end && (to_next+1) < to_limit)
 	{
+		//
+		// Characters that encode into a single code unit are
+		// encoded a run at a time
+		//
+		const size_t maxChars = from_end - from_next;
+		const size_t maxUnits = (to_limit - to_next) / 2;
+		const size_t run = VectorCodec::EncodeUTF16(from_next,
+			(maxChars < maxUnits) ? maxChars : maxUnits,
+			to_next, m_endianness != little_endian);
+
+		if(run)
+		{
+			from_next += run;
+			to_next += 2*run;
+			continue;
+		}
+
 		const CharType* from_next_copy = from_next;
 		UCS4Char ch;
 		ret = SystemCodeConverter::FromInternalEncoding(ch, from_next, from_end, from_next_copy);
@@ -399,30 +433,56 @@ CodeConverter::Result UTF16Converter::encode(const CharType *from, const CharTyp
 //
 // Returns the number of Unicode characters that an external array of bytes will
 // generate once decoded.
+//
+// Every character is a single 16-bit code unit apart from those encoded
+// as a surrogate pair, so the characters are counted by subtracting the
+// number of trailing (low) surrogates from the number of code units.  Only the
+// high-order byte of each code unit needs to be examined.
 //==============================================================================
 size_t UTF16Converter::getDecodedLength(const Byte *from, const Byte *from_end) const
 {
-	int ret = 0;
+	const size_t units = (from_end - from) / 2;
+	const Byte* pHigh = from + ((m_endianness != little_endian) ? 0 : 1);
+	size_t lowSurrogates = 0;
 
-    for (; from < from_end; )
+	for(size_t i=0; i<units; ++i)
+	{
+		lowSurrogates += ((pHigh[i*2] & 0xFC) == 0xDC);
+	}
+
+	//
+	// A trailing odd byte is decoded as an invalid character
+	//
+	return units - lowSurrogates + ((from_end - from) & 1);
+}
+
+//==============================================================================
+// UTF16Converter::findCharBoundary
+//
+// Sequences start at an even offset from the start of the array, and never
+// with a low (trailing) surrogate.
+//
+// If the byte order has not yet been established from a byte-order mark,
+// big-endian is assumed.
+//==============================================================================
+const Byte* UTF16Converter::findCharBoundary(const Byte* from, const Byte* from_end,
+                                             const Byte* pos) const
+{
+	pos += (pos - from) & 1;
+
+	if(pos + 1 < from_end)
 	{
 		unsigned short W1 = (m_endianness != little_endian)
-		                  ? *from << 8 | *(from+1) 
-		                  : *(from+1) << 8 | *from;
+		                  ? *pos << 8 | *(pos+1) 
+		                  : *(pos+1) << 8 | *pos;
 
-		if ((W1 & 0xF800) == 0xD800) // ie a surrogate
-		{
-			from += 4;
-		}
-		else
+		if(W1 >= 0xDC00 && W1 <= 0xDFFF)
 		{
-			from += 2;
+			pos += 2;
 		}
-
-		ret++;
 	}
-    
-	return (ret);
+
+	return (pos < from_end) ? pos : from_end;
 }
 
 //==============================================================================
@@ -490,6 +550,14 @@ String UTF16Converter::getEncodingName() const
 	return String();
 }
 
+//==============================================================================
+// UTF16Converter::clone
+//
+//==============================================================================
+AutoPtr<CodeConverter> UTF16Converter::clone() const
+{
+	return new UTF16Converter(*this);
+}
 
 QC_CVT_NAMESPACE_END
 
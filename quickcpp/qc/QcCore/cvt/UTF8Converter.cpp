@@ -54,14 +54,195 @@
 // We test non-first bytes for validity by anding 0xC0 (11000000) with the
 // byte and expecting an answer of 0x80 (10000000).  Anything else means
 // that the first two bits aren't "10" which is an encoding error.
+//
+// Decoding is optimized for the common case of ASCII-heavy text.  Runs of
+// US-ASCII bytes are widened a block at a time by VectorCodec, and well-formed
+// 2- and 3-byte sequences (which cover Latin, Greek, Cyrillic and CJK text)
+// are decoded in-line.  Everything else, including all invalid sequences,
+// is handed to the general SystemCodeConverter routines so that the
+// abort/replace policies behave exactly as before.
+//
+// Encoding mirrors this: runs of ASCII characters are narrowed to bytes by
+// VectorCodec and BMP characters are encoded in-line into 2 or 3 bytes.
+// Surrogates, supplementary characters and characters that do not fit in the
+// remaining output space are left to the general routines.
+//
+// When the internal encoding is also UTF-8 (QC_UTF8) neither direction needs
+// to convert anything: well-formed sequences are validated and copied as
+// they stand, and only invalid input reaches the general routines.
 //==============================================================================
 
 #include "UTF8Converter.h"
+#include "VectorCodec.h"
 
 #include "QcCore/base/SystemCodeConverter.h"
 
+#include <string.h>
+
 QC_CVT_NAMESPACE_BEGIN
 
+//==============================================================================
+// WellFormedSequenceLength
+//
+// Returns the length of the well-formed 2-, 3- or 4-byte UTF-8 sequence
+// starting at @c p, or zero if the sequence is truncated, malformed, overlong
+// or encodes a surrogate.
+//==============================================================================
+#if defined(QC_UTF8)
+static inline size_t WellFormedSequenceLength(const Byte* p, const Byte* end)
+{
+	const Byte lead = p[0];
+
+	if(lead >= 0xC2U && lead <= 0xDFU)
+	{
+		if(end - p > 1 && (p[1] & 0xC0) == 0x80)
+			return 2;
+	}
+	else if(lead >= 0xE0U && lead <= 0xEFU)
+	{
+		if(end - p > 2 &&
+		   (p[1] & 0xC0) == 0x80 &&
+		   (p[2] & 0xC0) == 0x80 &&
+		   (lead != 0xE0U || p[1] >= 0xA0U) && // overlong
+		   (lead != 0xEDU || p[1] <  0xA0U))   // surrogate
+			return 3;
+	}
+	else if(lead >= 0xF0U && lead <= 0xF4U)
+	{
+		if(end - p > 3 &&
+		   (p[1] & 0xC0) == 0x80 &&
+		   (p[2] & 0xC0) == 0x80 &&
+		   (p[3] & 0xC0) == 0x80 &&
+		   (lead != 0xF0U || p[1] >= 0x90U) && // overlong
+		   (lead != 0xF4U || p[1] <  0x90U))   // above U+10FFFF
+			return 4;
+	}
+	return 0;
+}
+#endif //QC_UTF8
+
+//==============================================================================
+// DecodeBMPSequence
+//
+// Fast path for well-formed 2- and 3-byte sequences that decode into a single
+// ::CharType.  Returns false, without consuming anything, for every other
+// sequence (4-byte sequences, truncated or malformed input and the surrogate
+// range) leaving the caller to use the general decoder.
+//
+// When the internal encoding is UTF-8 a well-formed sequence of any length
+// is already a valid internal sequence, so it is validated and copied
+// instead, provided the output buffer has room for all of it.
+//==============================================================================
+static inline bool DecodeBMPSequence(const Byte*& from_next, const Byte* from_end,
+                                     CharType*& to_next, const CharType* to_limit)
+{
+#if defined(QC_UTF8)
+
+	const size_t len = WellFormedSequenceLength(from_next, from_end);
+	if(len && size_t(to_limit - to_next) >= len)
+	{
+		::memcpy(to_next, from_next, len);
+		from_next += len;
+		to_next += len;
+		return true;
+	}
+	return false;
+
+#else
+
+	(void)to_limit; // the caller guarantees room for one CharType
+
+	const Byte lead = from_next[0];
+
+	if(lead >= 0xC2U && lead <= 0xDFU)
+	{
+		if(from_end - from_next > 1 && (from_next[1] & 0xC0) == 0x80)
+		{
+			*to_next++ = CharType(((lead & 0x1F) << 6) | (from_next[1] & 0x3F));
+			from_next += 2;
+			return true;
+		}
+	}
+	else if(lead >= 0xE0U && lead <= 0xEFU)
+	{
+		if(from_end - from_next > 2 &&
+		   (from_next[1] & 0xC0) == 0x80 &&
+		   (from_next[2] & 0xC0) == 0x80 &&
+		   (lead != 0xE0U || from_next[1] >= 0xA0U) && // overlong
+		   (lead != 0xEDU || from_next[1] <  0xA0U))   // surrogate
+		{
+			*to_next++ = CharType(((lead & 0x0F) << 12) |
+			                      ((from_next[1] & 0x3F) << 6) |
+			                      (from_next[2] & 0x3F));
+			from_next += 3;
+			return true;
+		}
+	}
+	return false;
+
+#endif //QC_UTF8
+}
+
+//==============================================================================
+// EncodeBMPCharacter
+//
+// Fast path for a single ::CharType in the range 0x80-0xFFFF, excluding the
+// surrogate range, which always encodes into 2 or 3 bytes.  Returns false,
+// without consuming anything, if the character is outside that range or
+// there is insufficient room in the output buffer.
+//
+// When the internal encoding is UTF-8 the characters are already encoded, so
+// a well-formed internal sequence of any length is copied unchanged.
+//==============================================================================
+static inline bool EncodeBMPCharacter(const CharType*& from_next, const CharType* from_end,
+                                      Byte*& to_next, const Byte* to_limit)
+{
+#if defined(QC_UTF8)
+
+	const size_t len = WellFormedSequenceLength((const Byte*)from_next, (const Byte*)from_end);
+	if(len && size_t(to_limit - to_next) >= len)
+	{
+		::memcpy(to_next, from_next, len);
+		from_next += len;
+		to_next += len;
+		return true;
+	}
+	return false;
+
+#else
+
+	(void)from_end; // the caller guarantees one CharType of input
+
+	const UCS4Char ch = UCS4Char(*from_next);
+
+	if(ch < 0x800U)
+	{
+		if(to_limit - to_next >= 2)
+		{
+			to_next[0] = Byte(0xC0 | (ch >> 6));
+			to_next[1] = Byte(0x80 | (ch & 0x3F));
+			to_next += 2;
+			++from_next;
+			return true;
+		}
+	}
+	else if(ch < 0x10000U && (ch < 0xD800U || ch > 0xDFFFU))
+	{
+		if(to_limit - to_next >= 3)
+		{
+			to_next[0] = Byte(0xE0 | (ch >> 12));
+			to_next[1] = Byte(0x80 | ((ch >> 6) & 0x3F));
+			to_next[2] = Byte(0x80 | (ch & 0x3F));
+			to_next += 3;
+			++from_next;
+			return true;
+		}
+	}
+	return false;
+
+#endif //QC_UTF8
+}
+
 //==============================================================================
 // UTF8Converter::decode
 //
@@ -81,10 +262,38 @@ CodeConverter::Result UTF8Converter::decode(const Byte *from, const Byte *from_e
 	//
 	while(ret == ok && from_next < from_end && to_next < to_limit)
 	{
-		// If the top bit is not on, then this is plain US-ASCII
+		// If the top bit is not on, then this is plain US-ASCII.
+		// Short runs are copied in-line, longer ones are widened a block at a time.
 		if ((*from_next & 0x80) == 0x00)
 		{
-			*to_next++ = *from_next++ & 0xff;
+			size_t runLen = from_end - from_next;
+			if(runLen > size_t(to_limit - to_next))
+				runLen = to_limit - to_next;
+
+			const Byte* pFrom = from_next;
+			const Byte* pRunEnd = pFrom + runLen;
+			const Byte* pShortEnd = (runLen > VectorCodec::ShortRunLength) ? pFrom + VectorCodec::ShortRunLength : pRunEnd;
+			CharType* pTo = to_next;
+
+			do
+			{
+				*pTo++ = *pFrom++;
+			}
+			while(pFrom < pShortEnd && (*pFrom & 0x80) == 0x00);
+
+			if(pFrom == pShortEnd && pFrom < pRunEnd)
+			{
+				const size_t copied = VectorCodec::WidenASCII(pFrom, pRunEnd - pFrom, pTo);
+				pFrom += copied;
+				pTo += copied;
+			}
+
+			from_next = pFrom;
+			to_next = pTo;
+		}
+		else if(DecodeBMPSequence(from_next, from_end, to_next, to_limit))
+		{
+			continue;
 		}
 		else
 		{
@@ -157,7 +366,39 @@ CodeConverter::Result UTF8Converter::encode(const CharType *from, const CharType
 	{
 		if ((unsigned)*from_next <= 0x7F)	// needs just 1 byte
 		{
-			*to_next++ = Byte(*from_next++);
+			//
+			// Short runs of ASCII (such as the spaces and punctuation in
+			// non-Latin text) are copied in-line; once a run proves to be
+			// longer than ShortRunLength the rest is narrowed a block at a time
+			//
+			size_t runLen = from_end - from_next;
+			if(runLen > size_t(to_limit - to_next))
+				runLen = to_limit - to_next;
+
+			const CharType* pFrom = from_next;
+			const CharType* pRunEnd = pFrom + runLen;
+			const CharType* pShortEnd = (runLen > VectorCodec::ShortRunLength) ? pFrom + VectorCodec::ShortRunLength : pRunEnd;
+			Byte* pTo = to_next;
+
+			do
+			{
+				*pTo++ = Byte(*pFrom++);
+			}
+			while(pFrom < pShortEnd && (unsigned)*pFrom <= 0x7F);
+
+			if(pFrom == pShortEnd && pFrom < pRunEnd)
+			{
+				const size_t copied = VectorCodec::NarrowASCII(pFrom, pRunEnd - pFrom, pTo);
+				pFrom += copied;
+				pTo += copied;
+			}
+
+			from_next = pFrom;
+			to_next = pTo;
+		}
+		else if(EncodeBMPCharacter(from_next, from_end, to_next, to_limit))
+		{
+			continue;
 		}
 		else
 		{
@@ -192,18 +433,55 @@ CodeConverter::Result UTF8Converter::encode(const CharType *from, const CharType
 //
 // Returns the number of Unicode characters that an external array of bytes will
 // generate once decoded.
+//
+// Every character starts with exactly one byte that is not a continuation
+// byte (10xxxxxx), so the characters are counted by subtracting the number
+// of continuation bytes from the length of the array.  The continuation bytes
+// are counted four at a time: the top bit of each continuation byte in
+// a word is isolated and the bits are summed by a multiplication.
 //==============================================================================
 size_t UTF8Converter::getDecodedLength(const Byte *from, const Byte *from_end) const
 {
-	int ret = 0;
+	size_t continuations = 0;
+	const Byte* p = from;
+
+	for(; from_end - p >= 4; p += 4)
+	{
+		unsigned int word;
+		::memcpy(&word, p, 4);
+		const unsigned int cont = (word & ~(word << 1) & 0x80808080U) >> 7;
+		continuations += (cont * 0x01010101U) >> 24;
+	}
 
-    for (; from < from_end; )
+	for(; p < from_end; ++p)
 	{
-		from += s_TrailingBytesForUTF8[*from]+1;
-		ret++;
+		if((*p & 0xC0) == 0x80)
+		{
+			++continuations;
+		}
 	}
 	
-	return ret;
+	return (from_end - from) - continuations;
+}
+
+//==============================================================================
+// UTF8Converter::findCharBoundary
+//
+// UTF-8 is self-synchronizing: every byte that is not a continuation byte
+// (10xxxxxx) starts a new sequence.  No more than three continuation bytes
+// are skipped, as a longer run is ill-formed anyway.
+//==============================================================================
+const Byte* UTF8Converter::findCharBoundary(const Byte* /*from*/, const Byte* from_end,
+                                            const Byte* pos) const
+{
+	const Byte* pLimit = (from_end - pos > 3) ? pos + 3 : from_end;
+
+	while(pos < pLimit && (*pos & 0xC0) == 0x80)
+	{
+		++pos;
+	}
+
+	return pos;
 }
 
 //==============================================================================
@@ -245,5 +523,14 @@ String UTF8Converter::getEncodingName() const
 	return QC_T("UTF-8");
 }
 
+//==============================================================================
+// UTF8Converter::clone
+//
+//==============================================================================
+AutoPtr<CodeConverter> UTF8Converter::clone() const
+{
+	return new UTF8Converter(*this);
+}
+
 QC_CVT_NAMESPACE_END
 
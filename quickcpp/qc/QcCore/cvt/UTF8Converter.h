@@ -60,11 +60,16 @@ public:
 
 	virtual size_t getDecodedLength(const Byte *from, const Byte *from_end) const;
 
+	virtual const Byte* findCharBoundary(const Byte *from, const Byte *from_end,
+	                                     const Byte *pos) const;
+
 	virtual size_t getMaxEncodedLength() const;
 
 	virtual bool alwaysNoConversion() const;
 
 	virtual String getEncodingName() const;
+
+	virtual AutoPtr<CodeConverter> clone() const;
 };
 
 QC_CVT_NAMESPACE_END
@@ -0,0 +1,1109 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: VectorCodec
+//
+// All of the internal encodings (UTF-8, UTF-16 and UCS-4) represent the
+// US-ASCII range identically, as a single ::CharType holding the value of the
+// byte.  Runs of ASCII bytes can therefore be converted by simply widening
+// each byte to the size of a ::CharType, which is an operation that maps
+// directly onto the SIMD unpack instructions.
+//
+// Each vector loop tests a whole block for bytes with the high-order bit set
+// using a single movemask instruction.  As soon as a block containing
+// non-ASCII bytes is found, the remainder of the run is completed by the
+// scalar implementation which stops exactly at the first non-ASCII byte.
+//
+// Narrowing is the reverse operation.  A block of characters is ASCII when
+// none of the bits above the low seven are set, in which case the characters
+// are packed down to bytes using the saturating pack instructions (which
+// cannot saturate because every value is known to be less than 0x80).
+//
+// Single-byte code pages are decoded using a 256-entry table.  When the
+// table maps every US-ASCII byte to itself, blocks that are entirely ASCII
+// are widened directly, exactly as WidenASCII() does.  Other blocks are
+// translated with the AVX2 gather instruction, which looks up eight table
+// entries at once.  There is no SSE2 equivalent of gather, so the SSE2
+// implementation translates those blocks with the scalar loop.
+//
+// Byte-to-byte transcoding uses the same technique on raw bytes: US-ASCII
+// runs are copied unchanged between ASCII-compatible encodings, and are
+// widened to or narrowed from UTF-16 code units of either byte order.
+//
+// UTF-16 is decoded and encoded a block of code units at a time for as long
+// as the block contains no surrogates.  Big-endian code units are
+// byte-swapped within each 16-bit lane.  When the internal encoding is UTF-16
+// the lanes are stored unchanged; when it is UCS-4 they are zero-extended to
+// 32 bits.  Encoding from UCS-4 requires every character in the block to be
+// below 0x10000, after which the characters are packed into 16-bit lanes.
+// The pack instructions saturate signed values, so the low 16 bits of each
+// character are first sign-extended, which packs them without change.
+// When the internal encoding is UTF-8 only US-ASCII runs are converted.
+//
+// The SSE2 and AVX2 implementations are compiled with function-level target
+// attributes so that the library does not require the application to be
+// compiled for a particular instruction set.  The AVX2 implementations must
+// issue vzeroupper before returning to non-VEX code.
+//
+//==============================================================================
+
+#include "VectorCodec.h"
+
+#include "QcCore/base/CpuFeatures.h"
+
+#include <string.h>
+
+#if defined(QC_X86_SIMD)
+	#include <immintrin.h>
+#endif
+
+QC_CVT_NAMESPACE_BEGIN
+
+VectorCodec::WidenFunc QC_MT_VOLATILE VectorCodec::s_pWidenASCII = 0;
+VectorCodec::NarrowFunc QC_MT_VOLATILE VectorCodec::s_pNarrowASCII = 0;
+VectorCodec::TableFunc QC_MT_VOLATILE VectorCodec::s_pDecodeSingleByte = 0;
+VectorCodec::CopyFunc QC_MT_VOLATILE VectorCodec::s_pCopyASCII = 0;
+VectorCodec::UTF16Func QC_MT_VOLATILE VectorCodec::s_pASCIIToUTF16 = 0;
+VectorCodec::UTF16Func QC_MT_VOLATILE VectorCodec::s_pUTF16ToASCII = 0;
+VectorCodec::DecodeUTF16Func QC_MT_VOLATILE VectorCodec::s_pDecodeUTF16 = 0;
+VectorCodec::EncodeUTF16Func QC_MT_VOLATILE VectorCodec::s_pEncodeUTF16 = 0;
+
+//==============================================================================
+// WidenASCII_Scalar
+//
+// Portable implementation.  Tests 8 bytes at a time while the run continues.
+//==============================================================================
+static size_t WidenASCII_Scalar(const Byte* from, size_t len, CharType* to)
+{
+	size_t i = 0;
+
+	while(i + 8 <= len)
+	{
+		const Byte* p = from + i;
+		if((p[0] | p[1] | p[2] | p[3] | p[4] | p[5] | p[6] | p[7]) & 0x80)
+		{
+			break;
+		}
+		to[i]   = p[0]; to[i+1] = p[1]; to[i+2] = p[2]; to[i+3] = p[3];
+		to[i+4] = p[4]; to[i+5] = p[5]; to[i+6] = p[6]; to[i+7] = p[7];
+		i += 8;
+	}
+
+	while(i < len && from[i] < 0x80U)
+	{
+		to[i] = from[i];
+		++i;
+	}
+
+	return i;
+}
+
+//==============================================================================
+// NarrowASCII_Scalar
+//
+// Portable implementation.  The cast to UCS4Char ensures that negative values
+// of a signed ::CharType are not mistaken for ASCII.
+//==============================================================================
+static size_t NarrowASCII_Scalar(const CharType* from, size_t len, Byte* to)
+{
+	size_t i = 0;
+
+	while(i + 4 <= len)
+	{
+		const UCS4Char c0 = UCS4Char(from[i]);
+		const UCS4Char c1 = UCS4Char(from[i+1]);
+		const UCS4Char c2 = UCS4Char(from[i+2]);
+		const UCS4Char c3 = UCS4Char(from[i+3]);
+		if((c0 | c1 | c2 | c3) >= 0x80U)
+		{
+			break;
+		}
+		to[i] = Byte(c0); to[i+1] = Byte(c1); to[i+2] = Byte(c2); to[i+3] = Byte(c3);
+		i += 4;
+	}
+
+	while(i < len && UCS4Char(from[i]) < 0x80U)
+	{
+		to[i] = Byte(from[i]);
+		++i;
+	}
+
+	return i;
+}
+
+//==============================================================================
+// DecodeSingleByte_Scalar
+//
+// Portable implementation.
+//==============================================================================
+static size_t DecodeSingleByte_Scalar(const Byte* from, size_t len, CharType* to,
+                                      const unsigned int* pTable, bool /*bASCIICompatible*/)
+{
+	size_t i = 0;
+
+	for(; i < len; ++i)
+	{
+		const unsigned int ch = pTable[from[i]];
+		if(ch == VectorCodec::UndefinedChar)
+		{
+			break;
+		}
+		to[i] = CharType(ch);
+	}
+
+	return i;
+}
+
+//==============================================================================
+// CopyASCII_Scalar
+//
+// Portable implementation.  Tests 8 bytes at a time while the run continues.
+//==============================================================================
+static size_t CopyASCII_Scalar(const Byte* from, size_t len, Byte* to)
+{
+	size_t i = 0;
+
+	while(i + 8 <= len)
+	{
+		const Byte* p = from + i;
+		if((p[0] | p[1] | p[2] | p[3] | p[4] | p[5] | p[6] | p[7]) & 0x80)
+		{
+			break;
+		}
+		::memcpy(to + i, p, 8);
+		i += 8;
+	}
+
+	while(i < len && from[i] < 0x80U)
+	{
+		to[i] = from[i];
+		++i;
+	}
+
+	return i;
+}
+
+//==============================================================================
+// ASCIIToUTF16_Scalar
+//
+// Portable implementation.
+//==============================================================================
+static size_t ASCIIToUTF16_Scalar(const Byte* from, size_t len, Byte* to, bool bBigEndian)
+{
+	const size_t lo = bBigEndian ? 1 : 0;
+	size_t i = 0;
+
+	for(; i < len && from[i] < 0x80U; ++i)
+	{
+		to[2*i + lo] = from[i];
+		to[2*i + 1 - lo] = 0;
+	}
+
+	return i;
+}
+
+//==============================================================================
+// UTF16ToASCII_Scalar
+//
+// Portable implementation.
+//==============================================================================
+static size_t UTF16ToASCII_Scalar(const Byte* from, size_t len, Byte* to, bool bBigEndian)
+{
+	const size_t lo = bBigEndian ? 1 : 0;
+	size_t i = 0;
+
+	for(; i < len; ++i)
+	{
+		const Byte* p = from + 2*i;
+		if(p[1 - lo] != 0 || p[lo] >= 0x80U)
+		{
+			break;
+		}
+		to[i] = p[lo];
+	}
+
+	return i;
+}
+
+//==============================================================================
+// DecodeUTF16_Scalar
+//
+// Portable implementation.
+//==============================================================================
+static size_t DecodeUTF16_Scalar(const Byte* from, size_t len, CharType* to, bool bBigEndian)
+{
+	if(sizeof(CharType) == 1)
+	{
+		return UTF16ToASCII_Scalar(from, len, (Byte*)to, bBigEndian);
+	}
+
+	const size_t hi = bBigEndian ? 0 : 1;
+	size_t i = 0;
+
+	for(; i < len; ++i)
+	{
+		const Byte* p = from + 2*i;
+		const unsigned int unit = (p[hi] << 8) | p[1 - hi];
+		if((unit & 0xF800) == 0xD800)
+		{
+			break;
+		}
+		to[i] = CharType(unit);
+	}
+
+	return i;
+}
+
+//==============================================================================
+// EncodeUTF16_Scalar
+//
+// Portable implementation.  The cast to UCS4Char ensures that negative values
+// of a signed ::CharType are not mistaken for BMP characters.
+//==============================================================================
+static size_t EncodeUTF16_Scalar(const CharType* from, size_t len, Byte* to, bool bBigEndian)
+{
+	if(sizeof(CharType) == 1)
+	{
+		return ASCIIToUTF16_Scalar((const Byte*)from, len, to, bBigEndian);
+	}
+
+	const size_t hi = bBigEndian ? 0 : 1;
+	size_t i = 0;
+
+	for(; i < len; ++i)
+	{
+		const UCS4Char ch = UCS4Char(from[i]);
+		if(ch > 0xFFFFU || (ch & 0xF800) == 0xD800)
+		{
+			break;
+		}
+		to[2*i + hi] = Byte(ch >> 8);
+		to[2*i + 1 - hi] = Byte(ch);
+	}
+
+	return i;
+}
+
+#if defined(QC_X86_SIMD)
+
+//==============================================================================
+// WidenBlock_SSE2
+//
+// Stores the 16 US-ASCII bytes in v as 16 ::CharTypes.
+//==============================================================================
+QC_TARGET_SSE2
+static inline void WidenBlock_SSE2(__m128i v, CharType* to)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i* pOut = (__m128i*)to;
+
+	if(sizeof(CharType) == 1)
+	{
+		_mm_storeu_si128(pOut, v);
+	}
+	else if(sizeof(CharType) == 2)
+	{
+		_mm_storeu_si128(pOut,   _mm_unpacklo_epi8(v, zero));
+		_mm_storeu_si128(pOut+1, _mm_unpackhi_epi8(v, zero));
+	}
+	else
+	{
+		const __m128i lo = _mm_unpacklo_epi8(v, zero);
+		const __m128i hi = _mm_unpackhi_epi8(v, zero);
+		_mm_storeu_si128(pOut,   _mm_unpacklo_epi16(lo, zero));
+		_mm_storeu_si128(pOut+1, _mm_unpackhi_epi16(lo, zero));
+		_mm_storeu_si128(pOut+2, _mm_unpacklo_epi16(hi, zero));
+		_mm_storeu_si128(pOut+3, _mm_unpackhi_epi16(hi, zero));
+	}
+}
+
+//==============================================================================
+// WidenBlock_AVX2
+//
+// Stores the 32 US-ASCII bytes in v as 32 ::CharTypes.
+//==============================================================================
+QC_TARGET_AVX2
+static inline void WidenBlock_AVX2(__m256i v, CharType* to)
+{
+	__m256i* pOut = (__m256i*)to;
+
+	if(sizeof(CharType) == 1)
+	{
+		_mm256_storeu_si256(pOut, v);
+	}
+	else if(sizeof(CharType) == 2)
+	{
+		_mm256_storeu_si256(pOut,   _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+		_mm256_storeu_si256(pOut+1, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+	}
+	else
+	{
+		const __m128i lo = _mm256_castsi256_si128(v);
+		const __m128i hi = _mm256_extracti128_si256(v, 1);
+		_mm256_storeu_si256(pOut,   _mm256_cvtepu8_epi32(lo));
+		_mm256_storeu_si256(pOut+1, _mm256_cvtepu8_epi32(_mm_srli_si128(lo, 8)));
+		_mm256_storeu_si256(pOut+2, _mm256_cvtepu8_epi32(hi));
+		_mm256_storeu_si256(pOut+3, _mm256_cvtepu8_epi32(_mm_srli_si128(hi, 8)));
+	}
+}
+
+//==============================================================================
+// WidenASCII_SSE2
+//
+// 16 bytes per iteration.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t WidenASCII_SSE2(const Byte* from, size_t len, CharType* to)
+{
+	size_t i = 0;
+
+	for(; i + 16 <= len; i += 16)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+		if(_mm_movemask_epi8(v))
+		{
+			break;
+		}
+		WidenBlock_SSE2(v, to + i);
+	}
+
+	return i + WidenASCII_Scalar(from + i, len - i, to + i);
+}
+
+//==============================================================================
+// WidenASCII_AVX2
+//
+// 32 bytes per iteration.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t WidenASCII_AVX2(const Byte* from, size_t len, CharType* to)
+{
+	size_t i = 0;
+
+	for(; i + 32 <= len; i += 32)
+	{
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(from + i));
+		if(_mm256_movemask_epi8(v))
+		{
+			break;
+		}
+		WidenBlock_AVX2(v, to + i);
+	}
+
+	//
+	// Clear the upper halves of the YMM registers before running legacy
+	// SSE code, otherwise every transition incurs a heavy penalty
+	//
+	_mm256_zeroupper();
+
+	return i + WidenASCII_Scalar(from + i, len - i, to + i);
+}
+
+//==============================================================================
+// NarrowASCII_SSE2
+//
+// 16 characters per iteration.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t NarrowASCII_SSE2(const CharType* from, size_t len, Byte* to)
+{
+	size_t i = 0;
+
+	if(sizeof(CharType) == 1)
+	{
+		for(; i + 16 <= len; i += 16)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+			if(_mm_movemask_epi8(v))
+			{
+				break;
+			}
+			_mm_storeu_si128((__m128i*)(to + i), v);
+		}
+	}
+	else if(sizeof(CharType) == 2)
+	{
+		const __m128i mask = _mm_set1_epi16(short(0xFF80));
+		for(; i + 16 <= len; i += 16)
+		{
+			const __m128i* pIn = (const __m128i*)(from + i);
+			const __m128i a = _mm_loadu_si128(pIn);
+			const __m128i b = _mm_loadu_si128(pIn+1);
+			const __m128i hi = _mm_and_si128(_mm_or_si128(a, b), mask);
+			if(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, _mm_setzero_si128())) != 0xFFFF)
+			{
+				break;
+			}
+			_mm_storeu_si128((__m128i*)(to + i), _mm_packus_epi16(a, b));
+		}
+	}
+	else
+	{
+		const __m128i mask = _mm_set1_epi32(int(0xFFFFFF80));
+		for(; i + 16 <= len; i += 16)
+		{
+			const __m128i* pIn = (const __m128i*)(from + i);
+			const __m128i a = _mm_loadu_si128(pIn);
+			const __m128i b = _mm_loadu_si128(pIn+1);
+			const __m128i c = _mm_loadu_si128(pIn+2);
+			const __m128i d = _mm_loadu_si128(pIn+3);
+			const __m128i hi = _mm_and_si128(_mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d)), mask);
+			if(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, _mm_setzero_si128())) != 0xFFFF)
+			{
+				break;
+			}
+			_mm_storeu_si128((__m128i*)(to + i),
+				_mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d)));
+		}
+	}
+
+	return i + NarrowASCII_Scalar(from + i, len - i, to + i);
+}
+
+//==============================================================================
+// NarrowASCII_AVX2
+//
+// 32 characters per iteration.  The AVX2 pack instructions operate within
+// each 128-bit lane, so the packed result has to be permuted back into
+// character order.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t NarrowASCII_AVX2(const CharType* from, size_t len, Byte* to)
+{
+	size_t i = 0;
+
+	if(sizeof(CharType) == 1)
+	{
+		for(; i + 32 <= len; i += 32)
+		{
+			const __m256i v = _mm256_loadu_si256((const __m256i*)(from + i));
+			if(_mm256_movemask_epi8(v))
+			{
+				break;
+			}
+			_mm256_storeu_si256((__m256i*)(to + i), v);
+		}
+	}
+	else if(sizeof(CharType) == 2)
+	{
+		const __m256i mask = _mm256_set1_epi16(short(0xFF80));
+		for(; i + 32 <= len; i += 32)
+		{
+			const __m256i* pIn = (const __m256i*)(from + i);
+			const __m256i a = _mm256_loadu_si256(pIn);
+			const __m256i b = _mm256_loadu_si256(pIn+1);
+			if(!_mm256_testz_si256(_mm256_or_si256(a, b), mask))
+			{
+				break;
+			}
+			_mm256_storeu_si256((__m256i*)(to + i),
+				_mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+		}
+	}
+	else
+	{
+		const __m256i mask = _mm256_set1_epi32(int(0xFFFFFF80));
+		const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		for(; i + 32 <= len; i += 32)
+		{
+			const __m256i* pIn = (const __m256i*)(from + i);
+			const __m256i a = _mm256_loadu_si256(pIn);
+			const __m256i b = _mm256_loadu_si256(pIn+1);
+			const __m256i c = _mm256_loadu_si256(pIn+2);
+			const __m256i d = _mm256_loadu_si256(pIn+3);
+			if(!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)), mask))
+			{
+				break;
+			}
+			const __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+			_mm256_storeu_si256((__m256i*)(to + i), _mm256_permutevar8x32_epi32(packed, order));
+		}
+	}
+
+	_mm256_zeroupper();
+
+	return i + NarrowASCII_Scalar(from + i, len - i, to + i);
+}
+
+//==============================================================================
+// DecodeSingleByte_SSE2
+//
+// 16 bytes per iteration.  Blocks that are not entirely ASCII, or every
+// block when the table does not map ASCII to itself, are translated by the
+// scalar loop.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t DecodeSingleByte_SSE2(const Byte* from, size_t len, CharType* to,
+                                    const unsigned int* pTable, bool bASCIICompatible)
+{
+	size_t i = 0;
+
+	if(bASCIICompatible)
+	{
+		for(; i + 16 <= len; i += 16)
+		{
+			const __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+			if(_mm_movemask_epi8(v))
+			{
+				const size_t count = DecodeSingleByte_Scalar(from + i, 16, to + i, pTable, true);
+				if(count < 16)
+				{
+					return i + count;
+				}
+			}
+			else
+			{
+				WidenBlock_SSE2(v, to + i);
+			}
+		}
+	}
+
+	return i + DecodeSingleByte_Scalar(from + i, len - i, to + i, pTable, bASCIICompatible);
+}
+
+//==============================================================================
+// DecodeSingleByte_AVX2
+//
+// 8 bytes per iteration, or 32 while the input is entirely ASCII and the
+// table maps ASCII to itself.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t DecodeSingleByte_AVX2(const Byte* from, size_t len, CharType* to,
+                                    const unsigned int* pTable, bool bASCIICompatible)
+{
+	const __m256i undefined = _mm256_set1_epi32(VectorCodec::UndefinedChar);
+	size_t i = 0;
+
+	while(i + 8 <= len)
+	{
+		if(bASCIICompatible && i + 32 <= len)
+		{
+			const __m256i v = _mm256_loadu_si256((const __m256i*)(from + i));
+			if(!_mm256_movemask_epi8(v))
+			{
+				WidenBlock_AVX2(v, to + i);
+				i += 32;
+				continue;
+			}
+		}
+
+		const __m128i bytes = _mm_loadl_epi64((const __m128i*)(from + i));
+		const __m256i chars = _mm256_i32gather_epi32((const int*)pTable,
+		                                             _mm256_cvtepu8_epi32(bytes), 4);
+		if(!_mm256_testz_si256(_mm256_cmpeq_epi32(chars, undefined), _mm256_cmpeq_epi32(chars, chars)))
+		{
+			break;
+		}
+
+		if(sizeof(CharType) == 4)
+		{
+			_mm256_storeu_si256((__m256i*)(to + i), chars);
+		}
+		else if(sizeof(CharType) == 2)
+		{
+			const __m128i packed = _mm_packus_epi32(_mm256_castsi256_si128(chars),
+			                                        _mm256_extracti128_si256(chars, 1));
+			_mm_storeu_si128((__m128i*)(to + i), packed);
+		}
+		else
+		{
+			break;
+		}
+		i += 8;
+	}
+
+	_mm256_zeroupper();
+
+	return i + DecodeSingleByte_Scalar(from + i, len - i, to + i, pTable, bASCIICompatible);
+}
+
+//==============================================================================
+// CopyASCII_SSE2
+//
+// 16 bytes per iteration.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t CopyASCII_SSE2(const Byte* from, size_t len, Byte* to)
+{
+	size_t i = 0;
+
+	for(; i + 16 <= len; i += 16)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+		if(_mm_movemask_epi8(v))
+		{
+			break;
+		}
+		_mm_storeu_si128((__m128i*)(to + i), v);
+	}
+
+	return i + CopyASCII_Scalar(from + i, len - i, to + i);
+}
+
+//==============================================================================
+// CopyASCII_AVX2
+//
+// 32 bytes per iteration.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t CopyASCII_AVX2(const Byte* from, size_t len, Byte* to)
+{
+	size_t i = 0;
+
+	for(; i + 32 <= len; i += 32)
+	{
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(from + i));
+		if(_mm256_movemask_epi8(v))
+		{
+			break;
+		}
+		_mm256_storeu_si256((__m256i*)(to + i), v);
+	}
+
+	_mm256_zeroupper();
+
+	return i + CopyASCII_Scalar(from + i, len - i, to + i);
+}
+
+//==============================================================================
+// ASCIIToUTF16_SSE2
+//
+// 16 bytes per iteration.  The byte order only decides which operand of the
+// unpack instruction supplies the zero byte.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t ASCIIToUTF16_SSE2(const Byte* from, size_t len, Byte* to, bool bBigEndian)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+
+	for(; i + 16 <= len; i += 16)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(from + i));
+		if(_mm_movemask_epi8(v))
+		{
+			break;
+		}
+
+		__m128i* pOut = (__m128i*)(to + 2*i);
+
+		if(bBigEndian)
+		{
+			_mm_storeu_si128(pOut,   _mm_unpacklo_epi8(zero, v));
+			_mm_storeu_si128(pOut+1, _mm_unpackhi_epi8(zero, v));
+		}
+		else
+		{
+			_mm_storeu_si128(pOut,   _mm_unpacklo_epi8(v, zero));
+			_mm_storeu_si128(pOut+1, _mm_unpackhi_epi8(v, zero));
+		}
+	}
+
+	return i + ASCIIToUTF16_Scalar(from + i, len - i, to + 2*i, bBigEndian);
+}
+
+//==============================================================================
+// UTF16ToASCII_SSE2
+//
+// 16 code units per iteration.  Each 16-bit lane is loaded in little-endian
+// order, so for big-endian input the significant byte is in the upper half
+// of the lane and is shifted down before packing.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t UTF16ToASCII_SSE2(const Byte* from, size_t len, Byte* to, bool bBigEndian)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i mask = _mm_set1_epi16(short(bBigEndian ? 0x80FF : 0xFF80));
+	size_t i = 0;
+
+	for(; i + 16 <= len; i += 16)
+	{
+		const __m128i* pIn = (const __m128i*)(from + 2*i);
+		__m128i a = _mm_loadu_si128(pIn);
+		__m128i b = _mm_loadu_si128(pIn+1);
+		const __m128i hi = _mm_and_si128(_mm_or_si128(a, b), mask);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi8(hi, zero)) != 0xFFFF)
+		{
+			break;
+		}
+		if(bBigEndian)
+		{
+			a = _mm_srli_epi16(a, 8);
+			b = _mm_srli_epi16(b, 8);
+		}
+		_mm_storeu_si128((__m128i*)(to + i), _mm_packus_epi16(a, b));
+	}
+
+	return i + UTF16ToASCII_Scalar(from + 2*i, len - i, to + i, bBigEndian);
+}
+
+//==============================================================================
+// DecodeUTF16_SSE2
+//
+// 8 code units per iteration.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t DecodeUTF16_SSE2(const Byte* from, size_t len, CharType* to, bool bBigEndian)
+{
+	if(sizeof(CharType) == 1)
+	{
+		return UTF16ToASCII_SSE2(from, len, (Byte*)to, bBigEndian);
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i surrogateMask = _mm_set1_epi16(short(0xF800));
+	const __m128i surrogate = _mm_set1_epi16(short(0xD800));
+	size_t i = 0;
+
+	for(; i + 8 <= len; i += 8)
+	{
+		__m128i v = _mm_loadu_si128((const __m128i*)(from + 2*i));
+		if(bBigEndian)
+		{
+			v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		}
+		if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, surrogateMask), surrogate)))
+		{
+			break;
+		}
+
+		__m128i* pOut = (__m128i*)(to + i);
+
+		if(sizeof(CharType) == 2)
+		{
+			_mm_storeu_si128(pOut, v);
+		}
+		else
+		{
+			_mm_storeu_si128(pOut,   _mm_unpacklo_epi16(v, zero));
+			_mm_storeu_si128(pOut+1, _mm_unpackhi_epi16(v, zero));
+		}
+	}
+
+	return i + DecodeUTF16_Scalar(from + 2*i, len - i, to + i, bBigEndian);
+}
+
+//==============================================================================
+// DecodeUTF16_AVX2
+//
+// 16 code units per iteration.  Big-endian code units are swapped with a
+// byte shuffle, which never crosses a 128-bit lane.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t DecodeUTF16_AVX2(const Byte* from, size_t len, CharType* to, bool bBigEndian)
+{
+	if(sizeof(CharType) == 1)
+	{
+		return UTF16ToASCII_SSE2(from, len, (Byte*)to, bBigEndian);
+	}
+
+	const __m256i swap = _mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+	                                      1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+	const __m256i surrogateMask = _mm256_set1_epi16(short(0xF800));
+	const __m256i surrogate = _mm256_set1_epi16(short(0xD800));
+	size_t i = 0;
+
+	for(; i + 16 <= len; i += 16)
+	{
+		__m256i v = _mm256_loadu_si256((const __m256i*)(from + 2*i));
+		if(bBigEndian)
+		{
+			v = _mm256_shuffle_epi8(v, swap);
+		}
+		if(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(v, surrogateMask), surrogate)))
+		{
+			break;
+		}
+
+		__m256i* pOut = (__m256i*)(to + i);
+
+		if(sizeof(CharType) == 2)
+		{
+			_mm256_storeu_si256(pOut, v);
+		}
+		else
+		{
+			_mm256_storeu_si256(pOut,   _mm256_cvtepu16_epi32(_mm256_castsi256_si128(v)));
+			_mm256_storeu_si256(pOut+1, _mm256_cvtepu16_epi32(_mm256_extracti128_si256(v, 1)));
+		}
+	}
+
+	_mm256_zeroupper();
+
+	return i + DecodeUTF16_Scalar(from + 2*i, len - i, to + i, bBigEndian);
+}
+
+//==============================================================================
+// EncodeUTF16_SSE2
+//
+// 8 characters per iteration.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t EncodeUTF16_SSE2(const CharType* from, size_t len, Byte* to, bool bBigEndian)
+{
+	if(sizeof(CharType) == 1)
+	{
+		return ASCIIToUTF16_SSE2((const Byte*)from, len, to, bBigEndian);
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i surrogateMask = _mm_set1_epi16(short(0xF800));
+	const __m128i surrogate = _mm_set1_epi16(short(0xD800));
+	const __m128i upperMask = _mm_set1_epi32(int(0xFFFF0000));
+	size_t i = 0;
+
+	for(; i + 8 <= len; i += 8)
+	{
+		const __m128i* pIn = (const __m128i*)(from + i);
+		__m128i v;
+
+		if(sizeof(CharType) == 2)
+		{
+			v = _mm_loadu_si128(pIn);
+		}
+		else
+		{
+			const __m128i a = _mm_loadu_si128(pIn);
+			const __m128i b = _mm_loadu_si128(pIn+1);
+			const __m128i upper = _mm_and_si128(_mm_or_si128(a, b), upperMask);
+			if(_mm_movemask_epi8(_mm_cmpeq_epi32(upper, zero)) != 0xFFFF)
+			{
+				break;
+			}
+			v = _mm_packs_epi32(_mm_srai_epi32(_mm_slli_epi32(a, 16), 16),
+			                    _mm_srai_epi32(_mm_slli_epi32(b, 16), 16));
+		}
+
+		if(_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, surrogateMask), surrogate)))
+		{
+			break;
+		}
+		if(bBigEndian)
+		{
+			v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		}
+		_mm_storeu_si128((__m128i*)(to + 2*i), v);
+	}
+
+	return i + EncodeUTF16_Scalar(from + i, len - i, to + 2*i, bBigEndian);
+}
+
+//==============================================================================
+// EncodeUTF16_AVX2
+//
+// 16 characters per iteration.  The AVX2 pack instruction operates within
+// each 128-bit lane, so the packed result has to be permuted back into
+// character order.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t EncodeUTF16_AVX2(const CharType* from, size_t len, Byte* to, bool bBigEndian)
+{
+	if(sizeof(CharType) == 1)
+	{
+		return ASCIIToUTF16_SSE2((const Byte*)from, len, to, bBigEndian);
+	}
+
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i swap = _mm256_setr_epi8(1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14,
+	                                      1,0,3,2,5,4,7,6,9,8,11,10,13,12,15,14);
+	const __m256i surrogateMask = _mm256_set1_epi16(short(0xF800));
+	const __m256i surrogate = _mm256_set1_epi16(short(0xD800));
+	const __m256i upperMask = _mm256_set1_epi32(int(0xFFFF0000));
+	size_t i = 0;
+
+	for(; i + 16 <= len; i += 16)
+	{
+		const __m256i* pIn = (const __m256i*)(from + i);
+		__m256i v;
+
+		if(sizeof(CharType) == 2)
+		{
+			v = _mm256_loadu_si256(pIn);
+		}
+		else
+		{
+			const __m256i a = _mm256_loadu_si256(pIn);
+			const __m256i b = _mm256_loadu_si256(pIn+1);
+			const __m256i upper = _mm256_and_si256(_mm256_or_si256(a, b), upperMask);
+			if(_mm256_movemask_epi8(_mm256_cmpeq_epi32(upper, zero)) != -1)
+			{
+				break;
+			}
+			v = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16),
+			                       _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16));
+			v = _mm256_permute4x64_epi64(v, 0xD8);
+		}
+
+		if(_mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(v, surrogateMask), surrogate)))
+		{
+			break;
+		}
+		if(bBigEndian)
+		{
+			v = _mm256_shuffle_epi8(v, swap);
+		}
+		_mm256_storeu_si256((__m256i*)(to + 2*i), v);
+	}
+
+	_mm256_zeroupper();
+
+	return i + EncodeUTF16_Scalar(from + i, len - i, to + 2*i, bBigEndian);
+}
+
+#endif //QC_X86_SIMD
+
+//==============================================================================
+// VectorCodec::SelectWiden
+//
+// Selects the best WidenASCII implementation for the host processor.
+//==============================================================================
+VectorCodec::WidenFunc VectorCodec::SelectWiden()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &WidenASCII_AVX2;
+	else if(CpuFeatures::HasSSE2())
+		return &WidenASCII_SSE2;
+#endif //QC_X86_SIMD
+
+	return &WidenASCII_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectNarrow
+//
+// Selects the best NarrowASCII implementation for the host processor.
+//==============================================================================
+VectorCodec::NarrowFunc VectorCodec::SelectNarrow()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &NarrowASCII_AVX2;
+	else if(CpuFeatures::HasSSE2())
+		return &NarrowASCII_SSE2;
+#endif //QC_X86_SIMD
+
+	return &NarrowASCII_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectTable
+//
+// Selects the best DecodeSingleByte implementation for the host processor.
+//==============================================================================
+VectorCodec::TableFunc VectorCodec::SelectTable()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &DecodeSingleByte_AVX2;
+	else if(CpuFeatures::HasSSE2())
+		return &DecodeSingleByte_SSE2;
+#endif //QC_X86_SIMD
+
+	return &DecodeSingleByte_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectCopy
+//
+// Selects the best CopyASCII implementation for the host processor.
+//==============================================================================
+VectorCodec::CopyFunc VectorCodec::SelectCopy()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &CopyASCII_AVX2;
+	else if(CpuFeatures::HasSSE2())
+		return &CopyASCII_SSE2;
+#endif //QC_X86_SIMD
+
+	return &CopyASCII_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectToUTF16
+//
+// Selects the best ASCIIToUTF16 implementation for the host processor.
+//==============================================================================
+VectorCodec::UTF16Func VectorCodec::SelectToUTF16()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasSSE2())
+		return &ASCIIToUTF16_SSE2;
+#endif //QC_X86_SIMD
+
+	return &ASCIIToUTF16_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectFromUTF16
+//
+// Selects the best UTF16ToASCII implementation for the host processor.
+//==============================================================================
+VectorCodec::UTF16Func VectorCodec::SelectFromUTF16()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasSSE2())
+		return &UTF16ToASCII_SSE2;
+#endif //QC_X86_SIMD
+
+	return &UTF16ToASCII_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectDecodeUTF16
+//
+// Selects the best DecodeUTF16 implementation for the host processor.
+//==============================================================================
+VectorCodec::DecodeUTF16Func VectorCodec::SelectDecodeUTF16()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &DecodeUTF16_AVX2;
+	if(CpuFeatures::HasSSE2())
+		return &DecodeUTF16_SSE2;
+#endif //QC_X86_SIMD
+
+	return &DecodeUTF16_Scalar;
+}
+
+//==============================================================================
+// VectorCodec::SelectEncodeUTF16
+//
+// Selects the best EncodeUTF16 implementation for the host processor.
+//==============================================================================
+VectorCodec::EncodeUTF16Func VectorCodec::SelectEncodeUTF16()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &EncodeUTF16_AVX2;
+	if(CpuFeatures::HasSSE2())
+		return &EncodeUTF16_SSE2;
+#endif //QC_X86_SIMD
+
+	return &EncodeUTF16_Scalar;
+}
+
+QC_CVT_NAMESPACE_END
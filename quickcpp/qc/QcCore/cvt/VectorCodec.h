@@ -0,0 +1,224 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: VectorCodec
+// 
+// Overview
+// --------
+// Class module containing the vectorized inner loops shared by the
+// CodeConverter implementations.  Each operation is implemented for SSE2,
+// AVX2 and plain C++; the best implementation supported by the host
+// processor is selected the first time the operation is used.
+//
+// This is an internal class and is not exported from the library.
+//
+//=============================================================================
+
+#ifndef QC_CVT_VectorCodec_h
+#define QC_CVT_VectorCodec_h
+
+#ifndef QC_CVT_DEFS_h
+#include "defs.h"
+#endif //QC_CVT_DEFS_h
+
+QC_CVT_NAMESPACE_BEGIN
+
+class VectorCodec
+{
+public:
+
+	static size_t WidenASCII(const Byte* from, size_t len, CharType* to);
+	static size_t NarrowASCII(const CharType* from, size_t len, Byte* to);
+	static size_t DecodeSingleByte(const Byte* from, size_t len, CharType* to,
+	                               const unsigned int* pTable, bool bASCIICompatible);
+	static size_t CopyASCII(const Byte* from, size_t len, Byte* to);
+	static size_t ASCIIToUTF16(const Byte* from, size_t len, Byte* to, bool bBigEndian);
+	static size_t UTF16ToASCII(const Byte* from, size_t len, Byte* to, bool bBigEndian);
+	static size_t DecodeUTF16(const Byte* from, size_t len, CharType* to, bool bBigEndian);
+	static size_t EncodeUTF16(const CharType* from, size_t len, Byte* to, bool bBigEndian);
+
+	//
+	// Runs of ASCII no longer than ShortRunLength are converted in-line
+	// by the callers rather than by VectorCodec.
+	//
+	enum {UndefinedChar = 0xFFFF, ShortRunLength = 8};
+
+private:
+	VectorCodec(); // not implemented
+
+	typedef size_t (*WidenFunc)(const Byte*, size_t, CharType*);
+	typedef size_t (*NarrowFunc)(const CharType*, size_t, Byte*);
+	typedef size_t (*TableFunc)(const Byte*, size_t, CharType*, const unsigned int*, bool);
+	typedef size_t (*CopyFunc)(const Byte*, size_t, Byte*);
+	typedef size_t (*UTF16Func)(const Byte*, size_t, Byte*, bool);
+	typedef size_t (*DecodeUTF16Func)(const Byte*, size_t, CharType*, bool);
+	typedef size_t (*EncodeUTF16Func)(const CharType*, size_t, Byte*, bool);
+
+	static WidenFunc SelectWiden();
+	static NarrowFunc SelectNarrow();
+	static TableFunc SelectTable();
+	static CopyFunc SelectCopy();
+	static UTF16Func SelectToUTF16();
+	static UTF16Func SelectFromUTF16();
+	static DecodeUTF16Func SelectDecodeUTF16();
+	static EncodeUTF16Func SelectEncodeUTF16();
+
+	static WidenFunc QC_MT_VOLATILE s_pWidenASCII;
+	static NarrowFunc QC_MT_VOLATILE s_pNarrowASCII;
+	static TableFunc QC_MT_VOLATILE s_pDecodeSingleByte;
+	static CopyFunc QC_MT_VOLATILE s_pCopyASCII;
+	static UTF16Func QC_MT_VOLATILE s_pASCIIToUTF16;
+	static UTF16Func QC_MT_VOLATILE s_pUTF16ToASCII;
+	static DecodeUTF16Func QC_MT_VOLATILE s_pDecodeUTF16;
+	static EncodeUTF16Func QC_MT_VOLATILE s_pEncodeUTF16;
+};
+
+//==============================================================================
+// VectorCodec::WidenASCII
+//
+// Copies the run of US-ASCII bytes at the start of the array [from, from+len)
+// into the ::CharType array @c to, stopping at the first byte with its high-order
+// bit set.  Returns the number of characters copied.
+//==============================================================================
+inline
+	size_t VectorCodec::WidenASCII(const Byte* from, size_t len, CharType* to)
+{
+	if(!s_pWidenASCII) s_pWidenASCII = SelectWiden();
+	return (*s_pWidenASCII)(from, len, to);
+}
+
+//==============================================================================
+// VectorCodec::NarrowASCII
+//
+// Copies the run of US-ASCII characters at the start of the ::CharType array
+// [from, from+len) into the Byte array @c to, stopping at the first character
+// outside the range 0-0x7F.  Returns the number of bytes copied.
+//==============================================================================
+inline
+	size_t VectorCodec::NarrowASCII(const CharType* from, size_t len, Byte* to)
+{
+	if(!s_pNarrowASCII) s_pNarrowASCII = SelectNarrow();
+	return (*s_pNarrowASCII)(from, len, to);
+}
+
+//==============================================================================
+// VectorCodec::DecodeSingleByte
+//
+// Decodes bytes from the array [from, from+len) into the ::CharType array
+// @c to by looking up each byte in the 256-entry table @c pTable, stopping
+// at the first byte whose table entry is UndefinedChar.  Every defined
+// entry must be a character that the internal encoding represents as a
+// single ::CharType.  @c bASCIICompatible must be true only if the table
+// maps each of the bytes 0-0x7F to itself, which allows runs of them to be
+// widened without looking them up.  Returns the number of bytes decoded.
+//==============================================================================
+inline
+	size_t VectorCodec::DecodeSingleByte(const Byte* from, size_t len, CharType* to,
+	                                     const unsigned int* pTable, bool bASCIICompatible)
+{
+	if(!s_pDecodeSingleByte) s_pDecodeSingleByte = SelectTable();
+	return (*s_pDecodeSingleByte)(from, len, to, pTable, bASCIICompatible);
+}
+
+//==============================================================================
+// VectorCodec::CopyASCII
+//
+// Copies the run of US-ASCII bytes at the start of the array [from, from+len)
+// into the Byte array @c to, stopping at the first byte with its high-order
+// bit set.  Returns the number of bytes copied.
+//==============================================================================
+inline
+	size_t VectorCodec::CopyASCII(const Byte* from, size_t len, Byte* to)
+{
+	if(!s_pCopyASCII) s_pCopyASCII = SelectCopy();
+	return (*s_pCopyASCII)(from, len, to);
+}
+
+//==============================================================================
+// VectorCodec::ASCIIToUTF16
+//
+// Encodes the run of US-ASCII bytes at the start of the array [from, from+len)
+// as UTF-16 code units of the requested byte order, writing two bytes to
+// @c to for each byte copied.  Returns the number of bytes copied.
+//==============================================================================
+inline
+	size_t VectorCodec::ASCIIToUTF16(const Byte* from, size_t len, Byte* to, bool bBigEndian)
+{
+	if(!s_pASCIIToUTF16) s_pASCIIToUTF16 = SelectToUTF16();
+	return (*s_pASCIIToUTF16)(from, len, to, bBigEndian);
+}
+
+//==============================================================================
+// VectorCodec::UTF16ToASCII
+//
+// Copies the run of US-ASCII characters at the start of the array of @c len
+// UTF-16 code units at @c from into the Byte array @c to, stopping at the
+// first code unit outside the range 0-0x7F.  Returns the number of code
+// units copied.
+//==============================================================================
+inline
+	size_t VectorCodec::UTF16ToASCII(const Byte* from, size_t len, Byte* to, bool bBigEndian)
+{
+	if(!s_pUTF16ToASCII) s_pUTF16ToASCII = SelectFromUTF16();
+	return (*s_pUTF16ToASCII)(from, len, to, bBigEndian);
+}
+
+//==============================================================================
+// VectorCodec::DecodeUTF16
+//
+// Decodes the run of UTF-16 code units of the requested byte order at the
+// start of the array of @c len code units at @c from into the ::CharType
+// array @c to, stopping at the first surrogate.  When the internal encoding
+// is UTF-8 the run also stops at the first code unit outside the range
+// 0-0x7F.  Returns the number of code units decoded, each of which produces
+// one ::CharType.
+//==============================================================================
+inline
+	size_t VectorCodec::DecodeUTF16(const Byte* from, size_t len, CharType* to, bool bBigEndian)
+{
+	if(!s_pDecodeUTF16) s_pDecodeUTF16 = SelectDecodeUTF16();
+	return (*s_pDecodeUTF16)(from, len, to, bBigEndian);
+}
+
+//==============================================================================
+// VectorCodec::EncodeUTF16
+//
+// Encodes the run of characters at the start of the ::CharType array
+// [from, from+len) as UTF-16 code units of the requested byte order, stopping
+// at the first character that is not a single code unit: a surrogate, or a
+// character above 0xFFFF.  When the internal encoding is UTF-8 the run also
+// stops at the first character outside the range 0-0x7F.  Returns the number
+// of characters encoded, each of which produces two bytes.
+//==============================================================================
+inline
+	size_t VectorCodec::EncodeUTF16(const CharType* from, size_t len, Byte* to, bool bBigEndian)
+{
+	if(!s_pEncodeUTF16) s_pEncodeUTF16 = SelectEncodeUTF16();
+	return (*s_pEncodeUTF16)(from, len, to, bBigEndian);
+}
+
+QC_CVT_NAMESPACE_END
+
+#endif //QC_CVT_VectorCodec_h
@@ -0,0 +1,88 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: AlignedBuffer
+//
+// See AlignedBuffer.h for an overview.
+//
+//==============================================================================
+
+#include "AlignedBuffer.h"
+
+#include "QcCore/base/debug.h"
+
+#include <new>
+#include <stdlib.h>
+
+#if defined(WIN32)
+	#include <malloc.h>
+#endif //WIN32
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// AlignedBuffer::AlignedBuffer
+//
+// Allocates size bytes at an address that is a multiple of alignment, which
+// must be a power of two no smaller than sizeof(void*).
+//
+// @throws std::bad_alloc if the memory cannot be allocated
+//==============================================================================
+AlignedBuffer::AlignedBuffer(size_t size, size_t alignment) :
+	m_pBuffer(0),
+	m_size(size)
+{
+	QC_DBG_ASSERT(alignment >= sizeof(void*) && (alignment & (alignment-1)) == 0);
+
+#if defined(WIN32)
+	m_pBuffer = static_cast<Byte*>(::_aligned_malloc(size, alignment));
+#else
+	void* p = 0;
+	if(::posix_memalign(&p, alignment, size) == 0)
+	{
+		m_pBuffer = static_cast<Byte*>(p);
+	}
+#endif //WIN32
+
+	if(!m_pBuffer)
+	{
+		throw std::bad_alloc();
+	}
+}
+
+//==============================================================================
+// AlignedBuffer::~AlignedBuffer
+//
+//==============================================================================
+AlignedBuffer::~AlignedBuffer()
+{
+#if defined(WIN32)
+	::_aligned_free(m_pBuffer);
+#else
+	::free(m_pBuffer);
+#endif //WIN32
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,100 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: AlignedBuffer
+// 
+// Overview
+// --------
+// A block of memory whose address is a multiple of a given alignment, as
+// required for the buffers of FileSystem::DirectAccess transfers.  Used by
+// FileInputStream and FileOutputStream.
+//
+// This is an internal class and is not exported from the library.
+//
+//=============================================================================
+
+#ifndef QC_IO_AlignedBuffer_h
+#define QC_IO_AlignedBuffer_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+QC_IO_NAMESPACE_BEGIN
+
+class AlignedBuffer
+{
+public:
+	AlignedBuffer(size_t size, size_t alignment);
+	~AlignedBuffer();
+
+	Byte* get() const;
+	size_t size() const;
+
+	static bool IsAligned(const void* p, size_t alignment);
+
+private:
+	AlignedBuffer(const AlignedBuffer& rhs);            // cannot be copied
+	AlignedBuffer& operator=(const AlignedBuffer& rhs); // nor assigned
+
+private:
+	Byte* m_pBuffer;
+	size_t m_size;
+};
+
+//==============================================================================
+// AlignedBuffer::get
+//
+//==============================================================================
+inline
+	Byte* AlignedBuffer::get() const
+{
+	return m_pBuffer;
+}
+
+//==============================================================================
+// AlignedBuffer::size
+//
+//==============================================================================
+inline
+	size_t AlignedBuffer::size() const
+{
+	return m_size;
+}
+
+//==============================================================================
+// AlignedBuffer::IsAligned
+//
+// Tests if p is a multiple of alignment, which must be a power of two.
+//==============================================================================
+inline
+	bool AlignedBuffer::IsAligned(const void* p, size_t alignment)
+{
+	return ((size_t)p & (alignment-1)) == 0;
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_AlignedBuffer_h
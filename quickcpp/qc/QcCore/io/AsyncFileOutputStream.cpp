@@ -0,0 +1,698 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: AsyncFileOutputStream
+/**
+	@class qc::io::AsyncFileOutputStream
+	
+	@brief An OutputStream that writes bytes to a file using a background
+	       thread.
+
+	An AsyncFileOutputStream copies the bytes passed to write() into a
+	bounded ring buffer, from which a writer thread owned by the stream takes
+	everything that is waiting and writes it to the file.  The application's
+	thread therefore only waits for the file system when it asks to, which
+	makes this class well suited to log files and other output that is
+	produced by a thread that should not be held up.  The ring is shared
+	without a lock (see PipeBuffer), so a write() that finds room costs a copy
+	and a memory barrier; the writer thread is only woken when it is waiting
+	for data.
+
+	Bytes are queued as soon as they are written, so the writer thread
+	naturally combines many small writes into one large one whenever it
+	falls behind.  flush() waits until every byte written so far has been
+	passed to the operating system, and sync() additionally waits until the
+	operating system has written it to the storage device.  close() writes
+	out everything that is queued before closing the file.
+
+	The queue holds up to getQueueLimit() bytes.  When a write() does not
+	fit, it either waits for the writer thread to make room, or discards
+	everything passed to that write(), according to the OverflowPolicy (see
+	setOverflowPolicy()).  Discarding keeps the application responsive when
+	the storage device cannot keep up, at the cost of gaps in the file.
+
+	An error that occurs on the writer thread cannot be reported by the call
+	that queued the data.  Instead, the next call to write(), flush(), sync()
+	or close() throws an IOException, and any data queued after the error is
+	discarded.
+
+	The writer thread is a daemon thread, so an AsyncFileOutputStream that is
+	never closed or destroyed does not prevent the application from
+	terminating, but data still queued at that point is lost.  In
+	single-threaded versions of the library there is no writer thread, and
+	the queue is written out whenever it is full.
+
+	Like other output streams, an AsyncFileOutputStream should be used by
+	only one thread at a time.
+*/
+//==============================================================================
+
+#include "AsyncFileOutputStream.h"
+#include "File.h"
+#include "FileSystem.h"
+#include "IOException.h"
+#include "PipeBuffer.h"
+
+#include "QcCore/base/Atomic.h"
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/Runnable.h"
+
+#ifdef QC_MT
+#include "QcCore/base/Thread.h"
+#endif //QC_MT
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// Class: AsyncFileOutputStream::Queue
+//
+// The bytes waiting to be written, shared between the stream and its writer
+// thread.  The stream is the only writer of the PipeBuffer and the writer
+// thread its only reader, so bytes are queued and taken without a lock.
+//
+// An error on the writer thread is recorded once, with a release store, and
+// the stream picks it up with an acquire load.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class AsyncFileOutputStream::Queue : public Runnable
+{
+public:
+	Queue(FileDescriptor* pFD, size_t capacity) :
+		m_rpFD(pFD),
+		m_rpBuffer(new PipeBuffer(capacity)),
+		m_bFailed(false) {}
+
+	void start();
+	void stop();
+	size_t getCapacity() const;
+	void put(const Byte* pBuffer, size_t bufLen);
+	bool tryPut(const Byte* pBuffer, size_t bufLen);
+	void flushBuffers();
+	void waitWritten();
+	void checkError() const;
+
+	// From Runnable...
+	virtual void run();
+
+private:
+	void writeQueued(size_t count);
+	void setError(const String& errMsg);
+
+private:
+	AutoPtr<FileDescriptor> m_rpFD;
+	AutoPtr<PipeBuffer> m_rpBuffer;
+	volatile bool m_bFailed;
+	String m_errorMsg;
+
+#ifdef QC_MT
+	AutoPtr<Thread> m_rpThread;
+#endif //QC_MT
+};
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::start
+//
+// Starts the writer thread.  The thread holds a reference to the Queue until
+// it has finished, and the Queue holds one to the thread until stop() has
+// joined it.
+//==============================================================================
+void AsyncFileOutputStream::Queue::start()
+{
+#ifdef QC_MT
+	m_rpThread = new Thread(this);
+	m_rpThread->setDaemon(true);
+	m_rpThread->start();
+#endif //QC_MT
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::stop
+//
+// Tells the writer thread to finish once the queue is empty and waits for it.
+//==============================================================================
+void AsyncFileOutputStream::Queue::stop()
+{
+#ifdef QC_MT
+	if(m_rpThread)
+	{
+		m_rpBuffer->closeWrite();
+		m_rpThread->join();
+		m_rpThread.release();
+	}
+#else
+	writeQueued(m_rpBuffer->available());
+#endif //QC_MT
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::getCapacity
+//
+//==============================================================================
+size_t AsyncFileOutputStream::Queue::getCapacity() const
+{
+	return m_rpBuffer->getCapacity();
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::put
+//
+// Queues bufLen bytes, waiting for the writer thread to make room for them
+// as necessary.
+//==============================================================================
+void AsyncFileOutputStream::Queue::put(const Byte* pBuffer, size_t bufLen)
+{
+	while(bufLen)
+	{
+		checkError();
+
+#ifdef QC_MT
+		const size_t space = m_rpBuffer->waitForSpace();
+#else
+		if(!m_rpBuffer->space())
+		{
+			writeQueued(m_rpBuffer->available());
+		}
+		const size_t space = m_rpBuffer->space();
+#endif //QC_MT
+
+		const size_t len = (bufLen < space) ? bufLen : space;
+		m_rpBuffer->copyIn(pBuffer, len);
+		m_rpBuffer->commit(len);
+		pBuffer += len;
+		bufLen -= len;
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::tryPut
+//
+// Queues bufLen bytes if there is room for all of them, and returns false
+// without queueing anything otherwise.
+//==============================================================================
+bool AsyncFileOutputStream::Queue::tryPut(const Byte* pBuffer, size_t bufLen)
+{
+	checkError();
+
+#ifndef QC_MT
+	if(m_rpBuffer->space() < bufLen)
+	{
+		writeQueued(m_rpBuffer->available());
+	}
+#endif //QC_MT
+
+	if(m_rpBuffer->space() < bufLen)
+	{
+		return false;
+	}
+
+	m_rpBuffer->copyIn(pBuffer, bufLen);
+	m_rpBuffer->commit(bufLen);
+	return true;
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::flushBuffers
+//
+// The writer thread is told about bytes as soon as they are queued, so there
+// is nothing to pass on unless there is no writer thread.
+//==============================================================================
+void AsyncFileOutputStream::Queue::flushBuffers()
+{
+#ifndef QC_MT
+	writeQueued(m_rpBuffer->available());
+#endif //QC_MT
+
+	checkError();
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::waitWritten
+//
+// Waits until every byte queued so far has been written or discarded, then
+// reports any error.
+//==============================================================================
+void AsyncFileOutputStream::Queue::waitWritten()
+{
+#ifdef QC_MT
+	m_rpBuffer->waitForEmpty();
+#else
+	writeQueued(m_rpBuffer->available());
+#endif //QC_MT
+
+	checkError();
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::checkError
+//
+// Throws an IOException if the writer thread has failed.
+//==============================================================================
+void AsyncFileOutputStream::Queue::checkError() const
+{
+	if(Atomic::LoadAcquire(m_bFailed))
+	{
+		throw IOException(m_errorMsg);
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::run
+//
+// The writer thread.  Writes everything that is waiting each time it wakes,
+// until the stream closes the queue and it has been emptied.
+//==============================================================================
+void AsyncFileOutputStream::Queue::run()
+{
+#ifdef QC_MT
+	size_t count;
+	while((count = m_rpBuffer->waitForData()) != 0)
+	{
+		writeQueued(count);
+	}
+#endif //QC_MT
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::writeQueued
+//
+// Writes the next count bytes of the queue with a single gather write, even
+// when they wrap around the end of the ring, and releases their space.  Once
+// an error has occurred the bytes are discarded.
+//==============================================================================
+void AsyncFileOutputStream::Queue::writeQueued(size_t count)
+{
+	if(!m_bFailed)
+	{
+		IoVec vecs[2];
+		const size_t numVecs = m_rpBuffer->readVecs(count, vecs);
+		try
+		{
+			m_rpFD->getFileSystem()->writeFile(m_rpFD.get(), vecs, numVecs);
+		}
+		catch(Exception& e)
+		{
+			setError(e.getMessage());
+		}
+	}
+
+	m_rpBuffer->consume(count);
+}
+
+//==============================================================================
+// AsyncFileOutputStream::Queue::setError
+//
+// Called only by the writer thread, so the message is never changed once the
+// flag has been published.
+//==============================================================================
+void AsyncFileOutputStream::Queue::setError(const String& errMsg)
+{
+	if(!m_bFailed)
+	{
+		m_errorMsg = errMsg;
+		Atomic::StoreRelease(m_bFailed, true);
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::AsyncFileOutputStream
+//
+/**
+   Constructs an AsyncFileOutputStream by opening a connection to the file
+   with the abstract pathname denoted by @c file.  If a file with the abstract
+   pathname already exists then it is truncated and its contents discarded.
+
+   @param file the abstract pathname of the file to open
+   @throws IOException if the specified file could not be opened.  This includes
+           the case where @c file refers to a directory instead of a normal file.
+*/
+//==============================================================================
+AsyncFileOutputStream::AsyncFileOutputStream(const File& file) :
+	m_policy(WaitForSpace),
+	m_discarded(0)
+{
+	open(file.getPath(), false /*bAppend*/);
+}
+
+//==============================================================================
+// AsyncFileOutputStream::AsyncFileOutputStream
+//
+/**
+   Constructs an AsyncFileOutputStream by opening a connection to the named
+   file @c name.  If the file already exists it is truncated and its
+   contents discarded.
+
+   @param name the name of the file to open
+   @throws IOException if the specified file name could not be opened.  This
+           includes the case where @c name refers to a directory instead of a
+           normal file.
+*/
+//==============================================================================
+AsyncFileOutputStream::AsyncFileOutputStream(const String& name) :
+	m_policy(WaitForSpace),
+	m_discarded(0)
+{
+	open(name, false /*bAppend*/);
+}
+
+//==============================================================================
+// AsyncFileOutputStream::AsyncFileOutputStream
+//
+/**
+   Constructs an AsyncFileOutputStream by opening a connection to the named
+   file @c name.
+
+   @param name the name of the file to open
+   @param bAppend @c true if the contents of an existing file should be kept
+          and written bytes added to its end; @c false if the file should be
+          truncated
+   @throws IOException if the specified file name could not be opened.  This
+           includes the case where @c name refers to a directory instead of a
+           normal file.
+*/
+//==============================================================================
+AsyncFileOutputStream::AsyncFileOutputStream(const String& name, bool bAppend) :
+	m_policy(WaitForSpace),
+	m_discarded(0)
+{
+	open(name, bAppend);
+}
+
+//==============================================================================
+// AsyncFileOutputStream::AsyncFileOutputStream
+//
+/**
+   Constructs an AsyncFileOutputStream that writes to the open file @c pFD.
+
+   @param pFD the open file to write to
+   @throws NullPointerException if @c pFD is null.
+*/
+//==============================================================================
+AsyncFileOutputStream::AsyncFileOutputStream(FileDescriptor* pFD) :
+	m_policy(WaitForSpace),
+	m_discarded(0)
+{
+	if(!pFD) throw NullPointerException();
+	init(pFD);
+}
+
+//==============================================================================
+// AsyncFileOutputStream::~AsyncFileOutputStream
+//
+/**
+   Writes out any data that is still queued and closes the file.  Errors
+   are ignored; call close() to have them reported.
+*/
+//==============================================================================
+AsyncFileOutputStream::~AsyncFileOutputStream()
+{
+	try
+	{
+		close();
+	}
+	catch(IOException& /*e*/)
+	{
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::init
+//
+// Private helper function called by each constructor.
+//==============================================================================
+void AsyncFileOutputStream::init(FileDescriptor* pFD)
+{
+	m_rpFD = pFD;
+	m_rpQueue = new Queue(pFD, DefaultQueueLimit);
+	m_rpQueue->start();
+}
+
+//==============================================================================
+// AsyncFileOutputStream::open
+//
+// Open (and optionally create) the file associated with this OutputStream.
+//==============================================================================
+void AsyncFileOutputStream::open(const String& fileName, bool bAppend) 
+{
+	FileSystem::CreationDisp disp = bAppend ? FileSystem::OpenCreateAppend
+	                                        : FileSystem::OpenCreateTruncate;
+	
+	AutoPtr<FileDescriptor> rpFD =
+		FileSystem::GetFileSystem()->openFile(fileName,
+		                                      FileSystem::WriteAccess,
+		                                      disp,
+		                                      0);
+	init(rpFD.get());
+}
+
+//==============================================================================
+// AsyncFileOutputStream::close
+//
+/**
+   Writes out any data that is still queued, stops the writer thread and
+   closes the file.  Once closed, the stream cannot be used for further
+   output.
+
+   @throws IOException if an I/O error occurs, including an error that
+           occurred on the writer thread and has not yet been reported.
+*/
+//==============================================================================
+void AsyncFileOutputStream::close()
+{
+	if(m_rpFD)
+	{
+		AutoPtr<FileDescriptor> rpFD = m_rpFD;
+		AutoPtr<Queue> rpQueue = m_rpQueue;
+		m_rpFD.release();
+		m_rpQueue.release();
+
+		rpQueue->stop();
+		rpFD->close();
+		rpQueue->checkError();
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::flushBuffers
+//
+/**
+   Reports any error that has occurred on the writer thread.  Bytes are
+   passed to the writer thread as they are written, so there is nothing to
+   pass on; in single-threaded versions of the library the queued bytes are
+   written out.
+
+   @throws IOException if an error has occurred on the writer thread.
+   @sa flush()
+*/
+//==============================================================================
+void AsyncFileOutputStream::flushBuffers()
+{
+	if(m_rpFD)
+	{
+		m_rpQueue->flushBuffers();
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::flush
+//
+/**
+   Waits until all of the bytes written to this stream have been written to
+   the file by the writer thread.  The bytes are then visible to other readers
+   of the file, but may not yet have been written to the storage device.
+
+   @throws IOException if an I/O error occurs on the writer thread.
+   @sa sync()
+*/
+//==============================================================================
+void AsyncFileOutputStream::flush()
+{
+	if(m_rpFD)
+	{
+		m_rpQueue->waitWritten();
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::sync
+//
+/**
+   Waits until all of the bytes written to this stream have been written to
+   the storage device.
+
+   @param bMetadata if @c true, file attributes such as the modification
+          time are also written.  By default only the file data and those
+          attributes required to read it back are written.
+   @throws IOException if this stream is closed or an I/O error occurs.
+   @sa FileSystem::syncFile()
+*/
+//==============================================================================
+void AsyncFileOutputStream::sync(bool bMetadata)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream closed"));
+
+	flush();
+	m_rpFD->getFileSystem()->syncFile(m_rpFD.get(), bMetadata);
+}
+
+//==============================================================================
+// AsyncFileOutputStream::write
+//
+/**
+   Queues @c bufLen bytes from @c pBuffer for the writer thread.  If the
+   queue does not have room for them, this either waits for the writer
+   thread to make room or discards all of them, according to the
+   OverflowPolicy.
+
+   @param pBuffer pointer to the bytes to write
+   @param bufLen the number of bytes to write
+   @throws IOException if this stream is closed or an error has occurred on
+           the writer thread.
+*/
+//==============================================================================
+void AsyncFileOutputStream::write(const Byte* pBuffer, size_t bufLen)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream closed"));
+	if(!pBuffer && bufLen) throw NullPointerException();
+
+	if(m_policy == DiscardData)
+	{
+		if(!m_rpQueue->tryPut(pBuffer, bufLen))
+		{
+			m_discarded += bufLen;
+		}
+	}
+	else
+	{
+		m_rpQueue->put(pBuffer, bufLen);
+	}
+}
+
+//==============================================================================
+// AsyncFileOutputStream::getQueueLimit
+//
+/**
+   Returns the maximum number of bytes that may be queued for the writer
+   thread.
+*/
+//==============================================================================
+size_t AsyncFileOutputStream::getQueueLimit() const
+{
+	if(!m_rpQueue) throw IOException(QC_T("stream closed"));
+
+	return m_rpQueue->getCapacity();
+}
+
+//==============================================================================
+// AsyncFileOutputStream::setQueueLimit
+//
+/**
+   Sets the maximum number of bytes that may be queued for the writer thread.
+   The limit is rounded up to a power of two.  The default is 4MB.
+
+   The bytes already queued are written first, as if by flush(), and the
+   writer thread is then restarted with a queue of the new size.
+
+   @param bytes the queue limit
+   @throws IOException if this stream is closed or an error has occurred on
+           the writer thread.
+   @sa setOverflowPolicy()
+*/
+//==============================================================================
+void AsyncFileOutputStream::setQueueLimit(size_t bytes)
+{
+	if(!m_rpQueue) throw IOException(QC_T("stream closed"));
+
+	m_rpQueue->waitWritten();
+	m_rpQueue->stop();
+	m_rpQueue = new Queue(m_rpFD.get(), bytes);
+	m_rpQueue->start();
+}
+
+//==============================================================================
+// AsyncFileOutputStream::getOverflowPolicy
+//
+/**
+   Returns what write() does when the queue is full.
+*/
+//==============================================================================
+AsyncFileOutputStream::OverflowPolicy AsyncFileOutputStream::getOverflowPolicy() const
+{
+	if(!m_rpQueue) throw IOException(QC_T("stream closed"));
+
+	return m_policy;
+}
+
+//==============================================================================
+// AsyncFileOutputStream::setOverflowPolicy
+//
+/**
+   Sets what write() does when the queue is full.  With WaitForSpace, the
+   default, write() waits until the writer thread has made room.  With
+   DiscardData, a write() that does not fit is discarded and its length added
+   to getDiscardedCount().
+
+   @param policy the new overflow policy
+   @throws IOException if this stream is closed.
+*/
+//==============================================================================
+void AsyncFileOutputStream::setOverflowPolicy(OverflowPolicy policy)
+{
+	if(!m_rpQueue) throw IOException(QC_T("stream closed"));
+
+	m_policy = policy;
+}
+
+//==============================================================================
+// AsyncFileOutputStream::getDiscardedCount
+//
+/**
+   Returns the number of bytes that have been discarded because the queue
+   was full.
+   @sa setOverflowPolicy()
+*/
+//==============================================================================
+size_t AsyncFileOutputStream::getDiscardedCount() const
+{
+	if(!m_rpQueue) throw IOException(QC_T("stream closed"));
+
+	return m_discarded;
+}
+
+//==============================================================================
+// AsyncFileOutputStream::getFD
+//
+/**
+   Returns the FileDescriptor for the file that this stream writes to.  The
+   writer thread may be using the file at the same time, so the application
+   should call flush() before using it.
+*/
+//==============================================================================
+AutoPtr<FileDescriptor> AsyncFileOutputStream::getFD() const
+{
+	return m_rpFD;
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,103 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: AsyncFileOutputStream
+// 
+// An OutputStream that writes to a file on a background thread.
+//
+//==============================================================================
+
+#ifndef QC_IO_AsyncFileOutputStream_h
+#define QC_IO_AsyncFileOutputStream_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "OutputStream.h"
+#include "FileDescriptor.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class File;
+
+class QC_IO_PKG AsyncFileOutputStream : public OutputStream
+{
+public:
+
+	enum OverflowPolicy {WaitForSpace, /*!< block the writer until the queue has room */
+	                     DiscardData   /*!< discard the data that does not fit */};
+
+	enum {DefaultQueueLimit = 0x400000 /*!< default limit on queued bytes */};
+
+	AsyncFileOutputStream(const File& file);
+	AsyncFileOutputStream(const String& name);
+	AsyncFileOutputStream(const String& name, bool bAppend);
+	AsyncFileOutputStream(FileDescriptor* pFD);
+	virtual ~AsyncFileOutputStream();
+
+	virtual void close();
+	virtual void flush();
+	virtual void flushBuffers();
+
+#ifdef QC_USING_DECL_BROKEN
+	virtual void write(Byte x) {OutputStream::write(x);}
+#else
+	using OutputStream::write; 	// unhide inherited write method
+#endif
+
+	virtual void write(const Byte* pBuffer, size_t bufLen);
+
+	void sync(bool bMetadata=false);
+
+	size_t getQueueLimit() const;
+	void setQueueLimit(size_t bytes);
+
+	OverflowPolicy getOverflowPolicy() const;
+	void setOverflowPolicy(OverflowPolicy policy);
+
+	size_t getDiscardedCount() const;
+
+	AutoPtr<FileDescriptor> getFD() const;
+
+private:
+	AsyncFileOutputStream(const AsyncFileOutputStream& rhs);            // cannot be copied
+	AsyncFileOutputStream& operator=(const AsyncFileOutputStream& rhs); // nor assigned
+
+	class Queue;
+
+	void init(FileDescriptor* pFD);
+	void open(const String& fileName, bool bAppend);
+
+private:
+	AutoPtr<FileDescriptor> m_rpFD;
+	AutoPtr<Queue> m_rpQueue;
+	OverflowPolicy m_policy;
+	size_t m_discarded;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_AsyncFileOutputStream_h
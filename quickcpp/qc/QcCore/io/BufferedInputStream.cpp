@@ -46,9 +46,17 @@
 	buffer is bypassed and bytes are read directly into the application's buffer.
 
     mark() and reset() are supported by buffering all data after a mark() operation
-	until the @c readLimit has been exceeded.  If mark() is called with a @c readLimit
-	that is larger than the internal buffer, the buffer is re-allocated to the 
-	size requested.
+	until the @c readLimit has been exceeded.  The internal buffer is circular,
+	so neither mark() nor reset() moves any data: mark() simply notes the
+	current position, and the bytes that follow it are kept in place while
+	new bytes are read into the space behind them.  The buffer is only
+	enlarged, by doubling its size, when it is full of marked bytes and the
+	@c readLimit has not yet been reached.  The buffer size is rounded up to
+	a power of two.
+
+	Line-oriented protocols can use readUntil() and skipUntil(), which search
+	the internal buffer for a delimiter a block at a time rather than reading
+	one byte at a time, and peek() to examine bytes before consuming them.
 */
 //=============================================================================
 
@@ -57,6 +65,7 @@
 
 #include "QcCore/base/SystemUtils.h"
 #include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/IllegalArgumentException.h"
 
 QC_IO_NAMESPACE_BEGIN
 
@@ -108,8 +117,6 @@ BufferedInputStream::BufferedInputStream(InputStream* pInputStream,
 //==============================================================================
 BufferedInputStream::~BufferedInputStream()
 {
-	delete [] m_pBuffer;
-	m_pBuffer = 0;
 }
 
 //==============================================================================
@@ -119,11 +126,12 @@ BufferedInputStream::~BufferedInputStream()
 //==============================================================================
 void BufferedInputStream::init(size_t bufSize)
 {
-	m_bufSize = bufSize;
-	m_pBuffer = new Byte[m_bufSize];
-	m_markPos = -1;
+	m_buffer.allocate(bufSize);
 	m_pos = 0;
 	m_count = 0;
+	m_markPos = 0;
+	m_markLimit = 0;
+	m_bMarkValid = false;
 	m_eof = false;
 }
 
@@ -145,9 +153,9 @@ void BufferedInputStream::init(size_t bufSize)
    will establish a new mark position; reset() can only reset the position
    to the most recently established mark position.
 
-   If the current buffer has less than @c readLimit bytes available
-   then the buffer is re-organized or reallocated so that is can hold at least
-   @c readLimit bytes forward from the current position.
+   No data is moved by this operation.  If the internal buffer becomes full
+   of bytes that have been read since the mark, and fewer than @c readLimit
+   bytes have been read, the buffer is enlarged by doubling its size.
 
    @sa markSupported()
    @sa reset()
@@ -160,38 +168,9 @@ void BufferedInputStream::mark(size_t readLimit)
 {
 	if(!m_rpInputStream) throw IOException(QC_T("stream is closed"));
 
-	QC_DBG_ASSERT(m_pBuffer!=0);
-
-	size_t bufferAvailable = m_bufSize - m_pos;
-	if(readLimit <= bufferAvailable)
-	{
-		m_markPos = m_pos;
-	}
-	else
-	{
-		const size_t bytesRemaining = m_count - m_pos;
-		m_markPos = 0;
-		m_count = bytesRemaining;
-
-		if(m_bufSize >= readLimit)
-		{
-			// overlapping copy operation requires ::memmove
-			::memmove(m_pBuffer, m_pBuffer+m_pos, bytesRemaining);
-
-			m_pos = 0;
-		}
-		else
-		{
-			Byte* pNewBuf = new Byte[readLimit];
-
-			::memcpy(pNewBuf, m_pBuffer+m_pos, bytesRemaining);
-
-			delete [] m_pBuffer;
-			m_pos = 0;
-			m_pBuffer = pNewBuf;
-			m_bufSize = readLimit;
-		}
-	}
+	m_markPos = m_pos;
+	m_markLimit = readLimit;
+	m_bMarkValid = true;
 }
 
 //==============================================================================
@@ -232,7 +211,7 @@ void BufferedInputStream::reset()
 {
 	if(!m_rpInputStream) throw IOException(QC_T("stream is closed"));
 
-	if(m_markPos == -1)
+	if(!m_bMarkValid)
 	{
 		throw IOException(QC_T("unable to reset input stream, either no mark or readLimit exceeded"));
 	}
@@ -252,9 +231,7 @@ size_t BufferedInputStream::available()
 {
 	if(m_rpInputStream)
 	{
-		long bytesRemaining = m_count - m_pos;
-		QC_DBG_ASSERT(bytesRemaining >= 0);
-		return bytesRemaining + m_rpInputStream->available();
+		return (m_count - m_pos) + m_rpInputStream->available();
 	}
 	else
 	{
@@ -275,10 +252,10 @@ void BufferedInputStream::close()
 	//
 	// Free our resources
 	//
-	delete [] m_pBuffer;
-	m_pBuffer = 0;
+	m_buffer.free();
 	m_pos = 0;
 	m_count = 0;
+	m_bMarkValid = false;
 	//
 	//  Pass the request to the contained stream (if any)
 	// and then release its reference
@@ -311,12 +288,12 @@ long BufferedInputStream::read(Byte* pBuffer, size_t bufLen)
 	if(m_pos == m_count && !m_eof)
 	{
 		//
-		// The mark can be reset if we have reached the end of our buffer - 
+		// The mark can be forgotten once the read limit has been reached -
 		// but not before
 		//
-		if((m_markPos == -1 || m_bufSize == m_count) && bufLen >= m_bufSize)
+		expireMark();
+		if(!m_bMarkValid && bufLen >= m_buffer.capacity())
 		{
-			m_markPos = -1;
 			int bytesRead = m_rpInputStream->read(pBuffer, bufLen);
 			m_eof = (bytesRead == EndOfFile);
 			return bytesRead;
@@ -339,21 +316,154 @@ long BufferedInputStream::read(Byte* pBuffer, size_t bufLen)
 		size_t bytesRemaining = m_count - m_pos;
 		size_t bytesToRead = (bytesRemaining > bufLen) ? bufLen : bytesRemaining;
 		QC_DBG_ASSERT(bytesToRead!=0);
-		QC_DBG_ASSERT(m_pBuffer!=0);
-		::memcpy(pBuffer, m_pBuffer+m_pos, bytesToRead);
+		m_buffer.copyOut(m_pos, pBuffer, bytesToRead);
 		m_pos += bytesToRead;
 		return bytesToRead;
 	}
 }
 
+//==============================================================================
+// BufferedInputStream::peek
+//
+/**
+   Returns a pointer to the next @c len bytes in the byte stream without
+   consuming them.
+
+   If fewer than @c len bytes are buffered, this method reads from the
+   contained InputStream, blocking if necessary, until @c len bytes are
+   available or the end of the byte stream is reached.  The internal buffer
+   is enlarged if it is too small to hold @c len bytes.  As the bytes must be
+   contiguous, buffered bytes are moved if they would otherwise wrap around
+   the end of the circular buffer.
+
+   The returned bytes belong to the BufferedInputStream.  They remain valid
+   until the next operation on the stream and must not be modified.
+
+   @param pData set to the next unread byte
+   @param len the number of bytes required
+   @returns the number of bytes available at @c pData, which is at least
+            @c len unless the end of the byte stream has been reached, or
+            InputStream::EndOfFile if there are no bytes left to read.
+   @throws IllegalArgumentException if @c len is zero.
+   @throws IOException if the input stream is closed
+*/
+//==============================================================================
+long BufferedInputStream::peek(const Byte*& pData, size_t len)
+{
+	if(!m_rpInputStream) throw IOException(QC_T("stream is closed"));
+	if(!len) throw IllegalArgumentException(QC_T("zero buffer length"));
+
+	//
+	// Make sure that the requested bytes will be contiguous, by moving the
+	// unread bytes, together with any marked bytes, to the start of a buffer
+	// that is large enough to hold them
+	//
+	const size_t unread = m_count - m_pos;
+	const size_t contiguousLen = (m_eof && unread < len) ? unread : len;
+	const size_t keep = m_bMarkValid ? m_markPos : m_pos;
+	const size_t required = (m_pos - keep) + contiguousLen;
+
+	if(keep == m_count)
+	{
+		m_buffer.rebase(m_count);
+	}
+
+	if(required > m_buffer.capacity() || m_buffer.contiguous(m_pos) < contiguousLen)
+	{
+		m_buffer.relocate(keep, m_count,
+			(required > m_buffer.capacity()) ? required : m_buffer.capacity());
+	}
+
+	while(m_count - m_pos < len && !m_eof)
+	{
+		readIntoBuffer(len - (m_count - m_pos));
+	}
+
+	if(m_pos == m_count)
+	{
+		return EndOfFile;
+	}
+
+	pData = m_buffer.at(m_pos);
+	const size_t avail = m_buffer.contiguous(m_pos);
+	return long((m_count - m_pos < avail) ? m_count - m_pos : avail);
+}
+
+//==============================================================================
+// BufferedInputStream::readUntil
+//
+// Searches the buffer for the delimiter using ::memchr.
+//==============================================================================
+long BufferedInputStream::readUntil(Byte delim, ByteString& out, size_t maxLen)
+{
+	return scanUntil(delim, &out, maxLen);
+}
+
+//==============================================================================
+// BufferedInputStream::skipUntil
+//
+// Searches the buffer for the delimiter using ::memchr.
+//==============================================================================
+long BufferedInputStream::skipUntil(Byte delim, size_t maxLen)
+{
+	return scanUntil(delim, 0, maxLen);
+}
+
+//==============================================================================
+// BufferedInputStream::scanUntil
+//
+// Common implementation of readUntil() and skipUntil().  Consumes buffered
+// bytes up to and including the delimiter, appending them to pOut if it is
+// not null, and refills the buffer as often as necessary.
+//==============================================================================
+long BufferedInputStream::scanUntil(Byte delim, ByteString* pOut, size_t maxLen)
+{
+	if(!m_rpInputStream) throw IOException(QC_T("stream is closed"));
+	if(!maxLen) throw IllegalArgumentException(QC_T("zero buffer length"));
+
+	size_t count = 0;
+
+	while(count < maxLen)
+	{
+		if(m_pos == m_count)
+		{
+			fillBuffer();
+			if(m_pos == m_count)
+			{
+				break; // end of stream
+			}
+		}
+
+		const Byte* pStart = m_buffer.at(m_pos);
+		const size_t contiguous = m_buffer.contiguous(m_pos);
+		const size_t bytesRemaining = (m_count - m_pos < contiguous) ? m_count - m_pos : contiguous;
+		size_t len = (bytesRemaining < maxLen - count) ? bytesRemaining : maxLen - count;
+		const Byte* pDelim = (const Byte*)::memchr(pStart, delim, len);
+		if(pDelim)
+		{
+			len = (pDelim - pStart) + 1;
+		}
+
+		if(pOut)
+		{
+			pOut->append((const char*)pStart, len);
+		}
+		m_pos += len;
+		count += len;
+
+		if(pDelim)
+		{
+			break;
+		}
+	}
+
+	return count ? long(count) : long(EndOfFile);
+}
+
 //==============================================================================
 // BufferedInputStream::fillBuffer
 //
 // Called whenever the buffers are exhausted and need replenishing.
-//
-// If there is space available at the end of the buffer then we only read
-// that many bytes (this simplifies the mark/reset operations), otherwise
-// the buffer is completely overwritten (which splats any pending reset())
 //==============================================================================
 void BufferedInputStream::fillBuffer()
 {
@@ -365,36 +475,85 @@ void BufferedInputStream::fillBuffer()
 
 	// we should only be called when the stream is open
 	QC_DBG_ASSERT(m_rpInputStream);
+
 	// we should only be called when all the available bytes have been read
 	QC_DBG_ASSERT(m_pos == m_count);
-	// and there should be a buffer allocated 
-	QC_DBG_ASSERT(m_pBuffer!=0 && m_bufSize!=0);
 
-	long bufferAvailable = m_bufSize - m_count;
-	QC_DBG_ASSERT(bufferAvailable >= 0);
+	readIntoBuffer(size_t(-1));
+}
+
+//==============================================================================
+// BufferedInputStream::readIntoBuffer
+//
+// Reads up to maxLen bytes from the contained stream into the free space
+// following the buffered bytes, and returns the number of bytes read, or zero
+// if the end of the stream has been reached.
+//
+// Bytes from the mark onwards are preserved in case the app calls reset().
+// If they fill the buffer, it is doubled in size unless the mark's read limit
+// has been reached, in which case the mark is forgotten and the buffer is
+// re-used.
+//==============================================================================
+size_t BufferedInputStream::readIntoBuffer(size_t maxLen)
+{
+	QC_DBG_ASSERT(!m_eof);
+
+	size_t keep = m_bMarkValid ? m_markPos : m_pos;
+
+	if(m_count - keep == m_buffer.capacity())
+	{
+		QC_DBG_ASSERT(m_bMarkValid);
+		if(m_pos - m_markPos < m_markLimit)
+		{
+			m_buffer.relocate(keep, m_count, m_buffer.capacity()*2);
+		}
+		else
+		{
+			m_bMarkValid = false;
+			keep = m_pos;
+		}
+	}
 
 	//
-	// If the buffer is exhausted, or there is no pending reset then
-	// we are free to re-use the entire buffer. Otherwise we must
-	// preserve the buffer in case the app calls reset().
+	// If nothing needs to be preserved, the whole buffer is available and
+	// can be read into with a single operation
 	//
-	if(bufferAvailable == 0 || m_markPos == -1)
+	if(keep == m_count)
 	{
-		m_markPos = -1;
-		m_pos = 0;
-		m_count = 0;
-		bufferAvailable = m_bufSize;
+		m_buffer.rebase(m_count);
 	}
 
-	int bytesRead = m_rpInputStream->read(m_pBuffer+m_count, bufferAvailable);
+	const size_t freeSpace = m_buffer.capacity() - (m_count - keep);
+	size_t len = m_buffer.contiguous(m_count);
+	if(len > freeSpace) len = freeSpace;
+	if(len > maxLen) len = maxLen;
+	QC_DBG_ASSERT(len!=0);
+
+	long bytesRead = m_rpInputStream->read(m_buffer.at(m_count), len);
+
 	if(bytesRead == EndOfFile)
 	{
 		m_eof = true;
+		return 0;
 	}
 	else
 	{
 		QC_DBG_ASSERT(bytesRead > 0);
 		m_count += bytesRead;
+		return bytesRead;
+	}
+}
+
+//==============================================================================
+// BufferedInputStream::expireMark
+//
+// Forgets the mark once the mark's read limit has been reached.
+//==============================================================================
+void BufferedInputStream::expireMark()
+{
+	if(m_bMarkValid && m_pos - m_markPos >= m_markLimit)
+	{
+		m_bMarkValid = false;
 	}
 }
 
@@ -31,6 +31,7 @@
 #endif //QC_IO_DEFS_h
 
 #include "InputStream.h"
+#include "RingBuffer.h"
 
 QC_IO_NAMESPACE_BEGIN
 
@@ -55,6 +56,10 @@ public:
 #endif
 
 	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual long readUntil(Byte delim, ByteString& out, size_t maxLen=size_t(-1));
+	virtual long skipUntil(Byte delim, size_t maxLen=size_t(-1));
+
+	long peek(const Byte*& pData, size_t len);
 
 private:
 	BufferedInputStream(const BufferedInputStream& rhs);            // cannot be copied
@@ -62,13 +67,17 @@ private:
 
 	void init(size_t bufSize);
 	void fillBuffer();
+	size_t readIntoBuffer(size_t maxLen);
+	void expireMark();
+	long scanUntil(Byte delim, ByteString* pOut, size_t maxLen);
 
 private:
-	Byte* m_pBuffer;
-	int m_markPos;
-	size_t m_pos;
-	size_t m_count;
-	size_t m_bufSize;
+	RingBuffer<Byte> m_buffer;
+	size_t m_pos;       // offset of the next byte to be read
+	size_t m_count;     // offset following the last byte in the buffer
+	size_t m_markPos;   // offset of the marked byte
+	size_t m_markLimit;
+	bool m_bMarkValid;
 	bool m_eof;
 	AutoPtr<InputStream> m_rpInputStream;
 };
@@ -53,8 +53,12 @@
 #include "BufferedOutputStream.h"
 #include "IOException.h"
 
+#include "QcCore/base/BufferPool.h"
 #include "QcCore/base/NullPointerException.h"
 
+#include <algorithm>
+#include <vector>
+
 QC_IO_NAMESPACE_BEGIN
 
 const size_t DefaultBufferSize = 1024;
@@ -148,7 +152,7 @@ void BufferedOutputStream::close()
 void BufferedOutputStream::init(size_t bufferSize)
 {
 	m_bufferSize = bufferSize;
-	m_pBuffer = new Byte[m_bufferSize];
+	m_pBuffer = BufferPool::AllocateArray<Byte>(m_bufferSize);
 	m_used=0;
 }
 
@@ -158,7 +162,7 @@ void BufferedOutputStream::init(size_t bufferSize)
 //==============================================================================
 void BufferedOutputStream::freeBuffers()
 {
-	delete [] m_pBuffer; m_pBuffer=0;
+	BufferPool::ReleaseArray(m_pBuffer, m_bufferSize); m_pBuffer=0;
 	m_used = m_bufferSize = 0;
 }
 
@@ -184,6 +188,30 @@ void BufferedOutputStream::flushBuffers()
 	m_rpOutputStream->flushBuffers();
 }
 
+//==============================================================================
+// BufferedOutputStream::transferFrom
+//
+/**
+   Writes up to @c length bytes from the open file denoted by @c pFD to
+   this output stream.
+
+   The internal buffer is written out and the transfer is then passed
+   directly to the contained OutputStream, so that a file can be sent over a
+   buffered socket stream without being copied through the buffer.
+
+   @sa OutputStream::transferFrom()
+*/
+//==============================================================================
+size_t BufferedOutputStream::transferFrom(FileDescriptor* pFD, FileOffset offset, size_t length)
+
+{
+	if(!pFD) throw NullPointerException();
+	if(!m_rpOutputStream) throw IOException(QC_T("stream closed"));
+
+	writeBuffer();
+	return m_rpOutputStream->transferFrom(pFD, offset, length);
+}
+
 //==============================================================================
 // BufferedOutputStream::write
 //
@@ -195,9 +223,10 @@ void BufferedOutputStream::flushBuffers()
    when it becomes full.
 
    In the situation where @c bufLen is larger than the internal buffer size,
-   the internal buffer will first be flushed before passing this write call
-   directly to the contained OutputStream.  By using this technique, the unnecessary
-   copying of data is avoided.
+   the contents of the internal buffer and the passed bytes are written
+   to the contained OutputStream together using a gather write.  By using this
+   technique, the unnecessary copying of data is avoided and the contained
+   OutputStream receives a single write request.
 
    @param pBuffer pointer to the start of an array of bytes to be written
    @param bufLen length of the byte array
@@ -210,21 +239,34 @@ void BufferedOutputStream::write(const Byte* pBuffer, size_t bufLen)
 	if(!pBuffer) throw NullPointerException();
 	if(!m_rpOutputStream) throw IOException(QC_T("stream closed"));
 
-	if(m_used + bufLen > m_bufferSize)
-	{
-		QC_DBG_ASSERT(m_pBuffer!=0);
-		// Write our buffer without flushing out the stream
-		writeBuffer();
-		QC_DBG_ASSERT(0 == m_used);
-	}
-
 	if(bufLen > m_bufferSize)
 	{
-		QC_DBG_ASSERT(0 == m_used);
-		m_rpOutputStream->write(pBuffer, bufLen);
+		if(m_used)
+		{
+			// Write our buffer and the caller's bytes without copying
+			IoVec vecs[2];
+			vecs[0].pData = m_pBuffer;
+			vecs[0].length = m_used;
+			vecs[1].pData = pBuffer;
+			vecs[1].length = bufLen;
+			m_rpOutputStream->write(vecs, 2);
+			m_used = 0;
+		}
+		else
+		{
+			m_rpOutputStream->write(pBuffer, bufLen);
+		}
 	}
 	else
 	{
+		if(m_used + bufLen > m_bufferSize)
+		{
+			QC_DBG_ASSERT(m_pBuffer!=0);
+			// Write our buffer without flushing out the stream
+			writeBuffer();
+			QC_DBG_ASSERT(0 == m_used);
+		}
+
 		QC_DBG_ASSERT(m_pBuffer!=0);
 		QC_DBG_ASSERT(bufLen + m_used <= m_bufferSize);
 		::memcpy(m_pBuffer+m_used, pBuffer, bufLen);
@@ -232,6 +274,62 @@ void BufferedOutputStream::write(const Byte* pBuffer, size_t bufLen)
 	}
 }
 
+//==============================================================================
+// BufferedOutputStream::write
+//
+/**
+   Writes @c count blocks of bytes, described by the array of IoVec structures
+   starting at @c pVecs, to this output stream.
+
+   If the blocks fit into the space remaining in the internal buffer they
+   are copied there.  Otherwise the contents of the internal buffer and all
+   the blocks are passed to the contained OutputStream in a single gather
+   write.
+
+   @param pVecs pointer to the first element of an array of IoVec structures
+   @param count number of elements in the array
+   @throws NullPointerException if @c pVecs is null and @c count is not zero.
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void BufferedOutputStream::write(const IoVec* pVecs, size_t count)
+{
+	if(!pVecs && count) throw NullPointerException();
+	if(!m_rpOutputStream) throw IOException(QC_T("stream closed"));
+
+	size_t totalLen = 0;
+	for(size_t i=0; i<count; ++i)
+	{
+		totalLen += pVecs[i].length;
+	}
+
+	if(m_used + totalLen <= m_bufferSize)
+	{
+		QC_DBG_ASSERT(m_pBuffer!=0);
+		for(size_t j=0; j<count; ++j)
+		{
+			if(pVecs[j].length)
+			{
+				::memcpy(m_pBuffer+m_used, pVecs[j].pData, pVecs[j].length);
+				m_used+=pVecs[j].length;
+			}
+		}
+	}
+	else if(m_used)
+	{
+		std::vector<IoVec> vecs(count+1);
+		vecs[0].pData = m_pBuffer;
+		vecs[0].length = m_used;
+		std::copy(pVecs, pVecs+count, vecs.begin()+1);
+		m_rpOutputStream->write(&vecs[0], vecs.size());
+		m_used = 0;
+	}
+	else
+	{
+		m_rpOutputStream->write(pVecs, count);
+	}
+}
+
 //==============================================================================
 // BufferedOutputStream::writeBuffer
 //
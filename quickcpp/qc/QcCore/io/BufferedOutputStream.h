@@ -49,6 +49,8 @@ public:
 	virtual void close();
 	virtual void flush();
 	virtual void flushBuffers();
+	virtual size_t transferFrom(FileDescriptor* pFD, FileOffset offset, size_t length);
+
 
 #ifdef QC_USING_DECL_BROKEN
 	virtual void write(Byte x) {OutputStream::write(x);}
@@ -57,6 +59,7 @@ public:
 #endif
 
 	virtual void write(const Byte* pBuffer, size_t bufLen);
+	virtual void write(const IoVec* pVecs, size_t count);
 
 private:
 	BufferedOutputStream(const BufferedOutputStream& rhs);            // cannot be copied
@@ -47,9 +47,15 @@
 	buffer is bypassed and characters are read directly into the application's buffer.
 
     mark() and reset() are supported by buffering all data after a mark() operation
-	until the @c readLimit has been exceeded.  If mark() is called with a @c readLimit
-	that is larger than the internal buffer, the buffer is re-allocated to the 
-	size requested.
+	until the @c readLimit has been exceeded.  As with BufferedInputStream, the
+	internal buffer is circular, so mark() and reset() do not move any data,
+	and the buffer is only enlarged, by doubling its size, when it is full of
+	marked characters and the @c readLimit has not yet been reached.
+
+    readLine() locates line terminators by scanning the internal buffer a
+	block of characters at a time.  The overload that takes a StringView returns
+	lines without copying them when they are contained within the buffer;
+	LineIterator provides a convenient interface to it.
 
     @mt
     The contained Reader is used as the lock object for synchronized methods.
@@ -60,6 +66,7 @@
 #include "BufferedReader.h"
 #include "AtomicReadException.h"
 #include "IOException.h"
+#include "LineScanner.h"
 
 #include "QcCore/base/SystemUtils.h"
 
@@ -86,6 +93,7 @@ BufferedReader::BufferedReader(Reader* pReader) :
 {
 	if(!pReader) throw NullPointerException();
 	m_rpLock = pReader->getLock();
+	m_bSynchronized = pReader->isSynchronized();
 
 	init(DefaultBufferSize);
 }
@@ -107,6 +115,7 @@ BufferedReader::BufferedReader(Reader* pReader, size_t size) :
 {
 	if(!pReader) throw NullPointerException();
 	m_rpLock = pReader->getLock();
+	m_bSynchronized = pReader->isSynchronized();
 
 	init(size);
 }
@@ -121,7 +130,6 @@ BufferedReader::BufferedReader(Reader* pReader, size_t size) :
 //==============================================================================
 BufferedReader::~BufferedReader()
 {
-	delete [] m_pBuffer; m_pBuffer=0;
 }
 
 //==============================================================================
@@ -131,11 +139,12 @@ BufferedReader::~BufferedReader()
 //==============================================================================
 void BufferedReader::init(size_t bufSize)
 {
-	m_bufSize = bufSize;
-	m_pBuffer = new CharType[m_bufSize];
-	m_markPos = -1;
+	m_buffer.allocate(bufSize);
 	m_pos = 0;
 	m_count = 0;
+	m_markPos = 0;
+	m_markLimit = 0;
+	m_bMarkValid = false;
 	m_eof = false;
 	m_bCRSeen = false;
 }
@@ -158,9 +167,10 @@ void BufferedReader::init(size_t bufSize)
    will establish a new mark position; reset() can only reset the position
    to the most recently established mark position.
 
-   If the current buffer has less than @c readLimit character positions available
-   then the buffer is re-organized or reallocated so that is can hold at least
-   @c readLimit character positions forward from the current position.
+   No data is moved by this operation.  If the internal buffer becomes full
+   of characters that have been read since the mark, and fewer than
+   @c readLimit character positions have been read, the buffer is enlarged
+   by doubling its size.
 
    Note:  remember that a single Unicode character may occupy several character
    positions.
@@ -175,41 +185,13 @@ void BufferedReader::init(size_t bufSize)
 //==============================================================================
 void BufferedReader::mark(size_t readLimit)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(!m_rpReader) throw IOException(QC_T("stream is closed"));
 
-	size_t bufferAvailable = m_bufSize - m_pos;
-
-	if(readLimit <= bufferAvailable)
-	{
-		m_markPos = m_pos;
-	}
-	else
-	{
-		const size_t charsRemaining = m_count - m_pos;
-		m_markPos = 0;
-		m_count = charsRemaining;
-
-		if(m_bufSize >= readLimit)
-		{
-			// overlapping copy operation requires ::memmove
-			::memmove(m_pBuffer, m_pBuffer+m_pos, charsRemaining*sizeof(CharType));
-
-			m_pos = 0;
-		}
-		else
-		{
-			CharType* pNewBuf = new CharType[readLimit];
-
-			::memcpy(pNewBuf, m_pBuffer+m_pos, charsRemaining*sizeof(CharType));
-
-			delete [] m_pBuffer;
-			m_pos = 0;
-			m_pBuffer = pNewBuf;
-			m_bufSize = readLimit;
-		}
-	}
+	m_markPos = m_pos;
+	m_markLimit = readLimit;
+	m_bMarkValid = true;
 }
 
 //==============================================================================
@@ -238,11 +220,11 @@ bool BufferedReader::markSupported() const
 //==============================================================================
 void BufferedReader::reset()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 	
 	if(!m_rpReader) throw IOException(QC_T("stream is closed"));
 
-	if(m_markPos == -1)
+	if(!m_bMarkValid)
 	{
 		throw IOException(QC_T("unable to reset input stream, either no mark or readLimit exceeded"));
 	}
@@ -259,18 +241,31 @@ void BufferedReader::reset()
 //==============================================================================
 void BufferedReader::close()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_rpReader)
 	{
 		m_rpReader->close();
 		m_rpReader.release(); // this is our indicator that the stream is closed
 	}
-	delete [] m_pBuffer;
-	m_pBuffer = 0;
+	m_buffer.free();
 	m_pos = 0;
 	m_count = 0;
-	m_markPos = -1;
+	m_bMarkValid = false;
+}
+
+//==============================================================================
+// BufferedReader::setSynchronized
+//
+// Also sets the mode of the contained Reader, which shares our lock.
+//==============================================================================
+void BufferedReader::setSynchronized(bool bSynchronized)
+{
+	Reader::setSynchronized(bSynchronized);
+	if(m_rpReader)
+	{
+		m_rpReader->setSynchronized(bSynchronized);
+	}
 }
 
 //==============================================================================
@@ -285,7 +280,7 @@ long BufferedReader::read(CharType* pBuffer, size_t bufLen)
 {
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 	
 	if(!m_rpReader) throw IOException(QC_T("stream is closed"));
 
@@ -300,7 +295,8 @@ long BufferedReader::read(CharType* pBuffer, size_t bufLen)
 	//
 	if(m_pos == m_count && !m_eof)
 	{
-		if(m_markPos == -1 && bufLen >= m_bufSize)
+		expireMark();
+		if(!m_bMarkValid && bufLen >= m_buffer.capacity())
 		{
 			int ret = m_rpReader->readAtomic(pBuffer, bufLen);
 			m_eof = (ret == EndOfFile);
@@ -324,8 +320,7 @@ long BufferedReader::read(CharType* pBuffer, size_t bufLen)
 		size_t charactersRemaining = m_count - m_pos;
 		size_t charactersToRead = (charactersRemaining > bufLen) ? bufLen : charactersRemaining;
 		QC_DBG_ASSERT(charactersToRead!=0);
-		QC_DBG_ASSERT(m_pBuffer!=0);
-		::memcpy(pBuffer, m_pBuffer+m_pos, charactersToRead*sizeof(CharType));
+		m_buffer.copyOut(m_pos, pBuffer, charactersToRead);
 		m_pos += charactersToRead;
 		return charactersToRead;
 	}
@@ -339,7 +334,7 @@ long BufferedReader::readAtomic(CharType* pBuffer, size_t bufLen)
 {
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(!m_rpReader) throw IOException(QC_T("stream is closed"));
 
@@ -350,7 +345,8 @@ long BufferedReader::readAtomic(CharType* pBuffer, size_t bufLen)
 	//
 	if(m_pos == m_count && !m_eof)
 	{
-		if(m_markPos == -1 && bufLen >= m_bufSize)
+		expireMark();
+		if(!m_bMarkValid && bufLen >= m_buffer.capacity())
 		{
 			long ret = m_rpReader->readAtomic(pBuffer, bufLen);
 			m_eof = (ret == EndOfFile);
@@ -390,9 +386,9 @@ long BufferedReader::readAtomic(CharType* pBuffer, size_t bufLen)
 		{
 			charCount = bufLen;
 			do {--charCount;}
-			while(charCount && !SystemCodeConverter::IsSequenceStartChar(*(m_pBuffer+m_pos+charCount)));
+			while(charCount && !SystemCodeConverter::IsSequenceStartChar(*m_buffer.at(m_pos+charCount)));
 
-			size_t charSeqLen = SystemCodeConverter::GetCharSequenceLength(*(m_pBuffer+m_pos+charCount));
+			size_t charSeqLen = SystemCodeConverter::GetCharSequenceLength(*m_buffer.at(m_pos+charCount));
 			if((charCount + charSeqLen) <= bufLen)
 			{
 				charCount += charSeqLen;
@@ -407,7 +403,7 @@ long BufferedReader::readAtomic(CharType* pBuffer, size_t bufLen)
 
 		if(charCount)
 		{
-			::memcpy(pBuffer, m_pBuffer+m_pos, charCount*sizeof(CharType));
+			m_buffer.copyOut(m_pos, pBuffer, charCount);
 			m_pos += charCount;
 		}
 		return charCount;
@@ -420,7 +416,7 @@ long BufferedReader::readAtomic(CharType* pBuffer, size_t bufLen)
 //==============================================================================
 Character BufferedReader::readAtomic()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	// No need to check for closed stream, fillBuffer() does that
 	if(m_pos == m_count)
@@ -434,17 +430,16 @@ Character BufferedReader::readAtomic()
 	}
 	else
 	{
-		size_t oldPos = m_pos;
-		const CharType nextChar = m_pBuffer[m_pos];
+		const CharType nextChar = *m_buffer.at(m_pos);
 		
 		if(!SystemCodeConverter::IsSequenceStartChar(nextChar))
 		{
 			throw AtomicReadException(QC_T("not on character sequence boundary"));
 		}
 
-		// The buffer must contain a whole sequence because it is filled
-		// using an atomic read
-		Character ret(m_pBuffer+oldPos, (m_count - m_pos));
+		// The buffer must contain a whole, contiguous sequence because it
+		// is filled using atomic reads into contiguous space
+		Character ret(m_buffer.at(m_pos), getContiguousLength());
 		m_pos += ret.length();
 		return ret;
 	}
@@ -459,6 +454,10 @@ Character BufferedReader::readAtomic()
    a carriage return followed immediately by a linefeed or when the end of the
    character stream is reached.
 
+   The contents of @c ret are replaced, but its capacity is retained, so
+   reading successive lines into the same String does not normally require
+   any memory to be allocated.
+
    @returns the number of ::CharType characters read or Reader::EndOfFile 
    if the end of the character stream is reached before any characters
    have been read.
@@ -471,38 +470,141 @@ long BufferedReader::readLine(String& ret)
 {
 	ret.erase();
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
+
+	const CharType* pLine;
+	const long len = scanLine(ret, pLine);
+
+	//
+	// A line contained within the internal buffer has not been
+	// copied into ret yet
+	//
+	if(len > 0 && pLine != ret.data())
+	{
+		ret.assign(pLine, len);
+	}
+
+	return len;
+}
+
+//==============================================================================
+// BufferedReader::readLine
+//
+/**
+   Reads a line of text without copying it.  Lines are terminated in the
+   same way as for readLine(String&).
+
+   When the whole line is contained within the internal buffer, @c ret
+   refers directly to the characters in the buffer.  Only a line that spans
+   a refill of the buffer is copied, into a String which is owned by the
+   BufferedReader and which is re-used for each line.
+
+   The returned StringView is only valid until the next operation on
+   this BufferedReader, so this method is not suitable for use by more
+   than one thread at a time.  Use StringView::toString() to retain a
+   copy of the line.
+
+   @returns the number of ::CharType characters in the line or Reader::EndOfFile 
+   if the end of the character stream is reached before any characters
+   have been read.
+
+   @throws IOException if an I/O error occurs.
+   @sa LineIterator
+   @synchronized
+*/
+//==============================================================================
+long BufferedReader::readLine(StringView& ret)
+{
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
+
+	m_lineBuffer.erase();
+
+	const CharType* pLine;
+	const long len = scanLine(m_lineBuffer, pLine);
+	ret = (len > 0) ? StringView(pLine, len) : StringView();
+	return len;
+}
+
+//==============================================================================
+// BufferedReader::scanLine
+//
+// Common implementation of the readLine() methods.  The buffered characters
+// are searched for the next line terminator using LineScanner.
+//
+// If a terminator is found in the buffer, pLine is set to the start of the
+// line within the buffer and nothing is copied.  Otherwise the characters
+// scanned so far are appended to spill before the buffer is refilled, and
+// pLine is set to spill.data() when the line is complete.
+//
+// Returns the length of the line, or EndOfFile.
+//
+// MT Note: m_lock must be held prior to calling
+//==============================================================================
+long BufferedReader::scanLine(String& spill, const CharType*& pLine)
+{
+	bool bSpilled = false;
+	pLine = 0;
 
-	int nextChar;
-	while( (nextChar = read()) != EndOfFile)
+	for(;;)
 	{
-		if(nextChar == '\r')
+		if(m_pos == m_count)
 		{
-			m_bCRSeen = true;
-			break;
+			fillBuffer();
+			if(m_pos == m_count)
+			{
+				break; // end of stream
+			}
 		}
-		else if(nextChar == '\n')
+
+		//
+		// A line feed immediately following a carriage return
+		// belongs to the previous line
+		//
+		if(m_bCRSeen)
 		{
-			if(!m_bCRSeen)
+			m_bCRSeen = false;
+			if(*m_buffer.at(m_pos) == '\n')
 			{
-				break;
+				++m_pos;
+				continue;
 			}
-			m_bCRSeen = false;
 		}
-		else
+
+		const CharType* pStart = m_buffer.at(m_pos);
+		const size_t avail = getContiguousLength();
+		const size_t lineLen = LineScanner::FindLineEnd(pStart, avail);
+
+		if(lineLen < avail)
 		{
-			m_bCRSeen = false;
-			ret += CharType(nextChar);
+			m_bCRSeen = (pStart[lineLen] == '\r');
+			m_pos += lineLen + 1;
+
+			if(bSpilled)
+			{
+				spill.append(pStart, lineLen);
+				pLine = spill.data();
+				return spill.size();
+			}
+			else
+			{
+				pLine = pStart;
+				return lineLen;
+			}
 		}
+
+		spill.append(pStart, avail);
+		bSpilled = true;
+		m_pos += avail;
 	}
-	
-	if(!ret.empty())
+
+	if(!spill.empty())
 	{
-		return ret.size();
+		pLine = spill.data();
+		return spill.size();
 	}
 	else
 	{
-		return (nextChar == EndOfFile) ? EndOfFile : 0;
+		return EndOfFile;
 	}
 }
 
@@ -511,12 +613,14 @@ long BufferedReader::readLine(String& ret)
 //
 // Called whenever the input buffer is exhausted and needs replenishing.
 //
-// If there is space available at the end of the buffer then we only read
-// that many characters (this preserves the buffer for mark/reset operations),
-// otherwise the buffer is completely overwritten (which splats any pending reset())
+// Characters from the mark onwards are preserved in case the app calls
+// reset().  If they fill the buffer, it is doubled in size unless the mark's
+// read limit has been reached, in which case the mark is forgotten and the
+// buffer is re-used.
 //
 // Note: in order to support readAtomic(), we only fill the buffer with atomic
-//       character sequences.
+//       character sequences, and each read is made into contiguous space so
+//       that no sequence wraps around the end of the buffer.
 //
 // MT Note: m_lock must be held prior to calling
 //==============================================================================
@@ -532,32 +636,56 @@ void BufferedReader::fillBuffer()
 
 	// we should only be called when all the available characters have been read
 	QC_DBG_ASSERT(m_pos == m_count);
-	QC_DBG_ASSERT(((long)m_bufSize - (long)m_count) >= 0);
 
-	size_t bufferAvailable = m_bufSize - m_count;
+	size_t keep = m_bMarkValid ? m_markPos : m_pos;
 
 	//
-	// If the buffer is exhausted, then reset everything
+	// There must be at least N character positions available in the
+	// input buffer to make the read worthwhile.  This is necessary to support
+	// Atomic read operations where the input buffer must be at least as large
+	// as any expected sequence of characters.
 	//
-	// Note: There must be at least N character positions available in the
-	// input buffer to make the read worthwhile, otherwise we treat it as though
-	// the buffer is exhausted.  This is necessary to support Atomic read operations
-	// where the input buffer must be at least as large as any expected sequence
-	// of characters.
+	if(m_buffer.capacity() - (m_count - keep) < MinBufferSize)
+	{
+		QC_DBG_ASSERT(m_bMarkValid);
+		if(m_pos - m_markPos < m_markLimit)
+		{
+			m_buffer.relocate(keep, m_count, m_buffer.capacity()*2);
+		}
+		else
+		{
+			m_bMarkValid = false;
+			keep = m_pos;
+		}
+	}
+
 	//
 	// If there is no mark/reset operation pending, then we are free to make use
 	// of the whole buffer - but optimization means that we are unlikely to be
 	// called in that case!
 	//
-	if(bufferAvailable < MinBufferSize || m_markPos == -1)
+	if(keep == m_count)
 	{
-		m_markPos = -1;
-		m_pos = 0;
-		m_count = 0;
-		bufferAvailable = m_bufSize;
+		m_buffer.rebase(m_count);
+	}
+
+	const size_t freeSpace = m_buffer.capacity() - (m_count - keep);
+	size_t bufferAvailable = m_buffer.contiguous(m_count);
+	if(bufferAvailable > freeSpace)
+	{
+		bufferAvailable = freeSpace;
+	}
+	else if(bufferAvailable < MinBufferSize)
+	{
+		//
+		// The space before the end of the buffer is too small, so the
+		// marked characters are moved to the start of the buffer
+		//
+		m_buffer.relocate(keep, m_count, m_buffer.capacity());
+		bufferAvailable = freeSpace;
 	}
 
-	long charactersRead = m_rpReader->readAtomic(m_pBuffer+m_count, bufferAvailable);
+	long charactersRead = m_rpReader->readAtomic(m_buffer.at(m_count), bufferAvailable);
 
 	if(charactersRead == EndOfFile)
 	{
@@ -570,4 +698,29 @@ void BufferedReader::fillBuffer()
 	}
 }
 
+//==============================================================================
+// BufferedReader::expireMark
+//
+// Forgets the mark once the mark's read limit has been reached.
+//==============================================================================
+void BufferedReader::expireMark()
+{
+	if(m_bMarkValid && m_pos - m_markPos >= m_markLimit)
+	{
+		m_bMarkValid = false;
+	}
+}
+
+//==============================================================================
+// BufferedReader::getContiguousLength
+//
+// Returns the number of unread characters that can be addressed from the
+// current position before the end of the circular buffer is reached.
+//==============================================================================
+size_t BufferedReader::getContiguousLength() const
+{
+	const size_t contiguous = m_buffer.contiguous(m_pos);
+	return (m_count - m_pos < contiguous) ? m_count - m_pos : contiguous;
+}
+
 QC_IO_NAMESPACE_END
@@ -35,6 +35,9 @@
 #endif //QC_IO_DEFS_h
 
 #include "Reader.h"
+#include "RingBuffer.h"
+
+#include "QcCore/base/StringView.h"
 
 QC_IO_NAMESPACE_BEGIN
 
@@ -50,6 +53,7 @@ public:
 	virtual bool markSupported() const;
 	virtual void reset();
 	virtual void close();
+	virtual void setSynchronized(bool bSynchronized);
 
 #ifdef QC_USING_DECL_BROKEN
 	virtual IntType read() {return Reader::read();}
@@ -62,20 +66,26 @@ public:
 	virtual Character readAtomic();
 
 	virtual long readLine(String& ret);
+	long readLine(StringView& ret);
 
 private:
 	void init(size_t bufSize);
 	void fillBuffer();
+	void expireMark();
+	size_t getContiguousLength() const;
+	long scanLine(String& spill, const CharType*& pLine);
 
 private:
-	CharType* m_pBuffer;
-	int m_markPos;
-	size_t m_pos;
-	size_t m_count;
-	size_t m_bufSize;
+	RingBuffer<CharType> m_buffer;
+	size_t m_pos;       // offset of the next character to be read
+	size_t m_count;     // offset following the last character in the buffer
+	size_t m_markPos;   // offset of the marked character
+	size_t m_markLimit;
+	bool m_bMarkValid;
 	bool m_eof;
 	bool m_bCRSeen;
 	AutoPtr<Reader> m_rpReader;
+	String m_lineBuffer;
 };
 
 QC_IO_NAMESPACE_END
@@ -55,6 +55,7 @@
 
 #include "BufferedWriter.h"
 
+#include "QcCore/base/BufferPool.h"
 #include "QcCore/base/NullPointerException.h"
 
 QC_IO_NAMESPACE_BEGIN
@@ -76,6 +77,7 @@ BufferedWriter::BufferedWriter(Writer* pWriter) :
 {
 	if(!pWriter) throw NullPointerException();
 	m_rpLock = pWriter->getLock();
+	m_bSynchronized = pWriter->isSynchronized();
 
 	init(DefaultBufferSize);
 }
@@ -96,6 +98,7 @@ BufferedWriter::BufferedWriter(Writer* pWriter, size_t bufSize) :
 {
 	if(!pWriter) throw NullPointerException();
 	m_rpLock = pWriter->getLock();
+	m_bSynchronized = pWriter->isSynchronized();
 
 	init(bufSize ? bufSize : DefaultBufferSize);
 }
@@ -117,7 +120,7 @@ BufferedWriter::~BufferedWriter()
 	catch(...)
 	{
 	}
-	delete [] m_pBuffer;
+	BufferPool::ReleaseArray(m_pBuffer, m_bufferSize);
 }
 
 //==============================================================================
@@ -128,7 +131,7 @@ BufferedWriter::~BufferedWriter()
 void BufferedWriter::init(size_t bufferSize)
 {
 	m_bufferSize = bufferSize;
-	m_pBuffer = new CharType[m_bufferSize];
+	m_pBuffer = BufferPool::AllocateArray<CharType>(m_bufferSize);
 	m_used=0;
 }
 
@@ -138,7 +141,7 @@ void BufferedWriter::init(size_t bufferSize)
 //==============================================================================
 void BufferedWriter::flush()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	flushBuffersImpl();
 	m_rpWriter->flush();
@@ -157,7 +160,7 @@ void BufferedWriter::flush()
 //==============================================================================
 void BufferedWriter::flushBuffers()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	flushBuffersImpl();
 }
@@ -181,7 +184,7 @@ void BufferedWriter::write(const CharType* pStr, size_t len)
 {
 	if(!pStr) throw NullPointerException();
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 	
 	if(m_used + len > m_bufferSize)
 	{
@@ -207,13 +210,27 @@ void BufferedWriter::write(const CharType* pStr, size_t len)
 //==============================================================================
 void BufferedWriter::close()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	flushBuffersImpl();
 	m_rpWriter->close();
 	// force writes through to closed stream
-	delete [] m_pBuffer; m_pBuffer = 0;
+	BufferPool::ReleaseArray(m_pBuffer, m_bufferSize); m_pBuffer = 0;
 	m_bufferSize = 0; 
 }
 
+//==============================================================================
+// BufferedWriter::setSynchronized
+//
+// Also sets the mode of the contained Writer, which shares our lock.
+//==============================================================================
+void BufferedWriter::setSynchronized(bool bSynchronized)
+{
+	Writer::setSynchronized(bSynchronized);
+	if(m_rpWriter)
+	{
+		m_rpWriter->setSynchronized(bSynchronized);
+	}
+}
+
 QC_IO_NAMESPACE_END
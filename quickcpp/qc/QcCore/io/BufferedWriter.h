@@ -47,6 +47,7 @@ public:
 	virtual ~BufferedWriter();
 
 	virtual void close();
+	virtual void setSynchronized(bool bSynchronized);
 	virtual void flush();
 	virtual void flushBuffers();
 
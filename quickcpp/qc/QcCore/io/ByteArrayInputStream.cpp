@@ -37,8 +37,11 @@
 #include "IOException.h"
 
 #include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/IllegalArgumentException.h"
 #include "QcCore/base/SystemUtils.h"
 
+#include <limits.h>
+
 QC_IO_NAMESPACE_BEGIN
 
 //==============================================================================
@@ -154,6 +157,54 @@ long ByteArrayInputStream::read(Byte* pBuffer, size_t bufLen)
 	}
 }
 
+//==============================================================================
+// ByteArrayInputStream::readView
+//
+/**
+   Returns a pointer to up to @c maxLen bytes of the byte array without
+   copying them.  The bytes remain valid until the stream is closed.
+
+   @sa InputStream::readView()
+*/
+//==============================================================================
+long ByteArrayInputStream::readView(const Byte*& pData, size_t maxLen)
+{
+	if(!maxLen) throw IllegalArgumentException(QC_T("zero buffer length"));
+	if(maxLen > LONG_MAX) maxLen = LONG_MAX;
+
+	if(m_bClosed) throw IOException(QC_T("stream is closed"));
+
+	const size_t bytesAvailable = (m_bufSize - m_pos);
+
+	if(bytesAvailable)
+	{
+		const size_t count = (maxLen < bytesAvailable)
+		                   ? maxLen
+		                   : bytesAvailable;
+
+		pData = m_apBuffer.get()+m_pos;
+		m_pos+=count;
+		return count;
+	}
+	else
+	{
+		return EndOfFile;
+	}
+}
+
+//==============================================================================
+// ByteArrayInputStream::viewSupported
+//
+/**
+   Returns @c true for ByteArrayInputStream.
+   @sa readView()
+*/
+//==============================================================================
+bool ByteArrayInputStream::viewSupported() const
+{
+	return true;
+}
+
 //==============================================================================
 // ByteArrayInputStream::available
 //
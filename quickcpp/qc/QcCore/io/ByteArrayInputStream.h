@@ -54,6 +54,8 @@ public:
 #endif
 
 	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual long readView(const Byte*& pData, size_t maxLen);
+	virtual bool viewSupported() const;
 
 	size_t m_pos;
 	ArrayAutoPtr<Byte> m_apBuffer;
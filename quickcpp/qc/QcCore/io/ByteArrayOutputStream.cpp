@@ -32,11 +32,18 @@
 	constructor.  
 
     When bytes are written to this output stream, they are copied into
-	the internal buffer.  The buffer is automatically expanded as additional
-	bytes are written to it.
+	the internal buffer.  The buffer is held as a list of segments, and is
+	expanded by adding a new segment whenever the existing ones are full, so
+	bytes that have already been written are never moved or copied as the
+	buffer grows.  Each new segment is as large as all the preceding ones
+	together, up to a limit of 64KB.
 
     The buffered data may be retrieved at any time using the data() and size()
-	methods.
+	methods.  data() has to combine the segments into a single block first,
+	so writeTo(), getSegments() and moveTo() are the more efficient ways to
+	hand the data on to something else.  reset() keeps the segments, so a
+	ByteArrayOutputStream that is reused for a series of messages of similar
+	size soon stops allocating memory altogether.
 
 	@sa ByteArrayInputStream
 */
@@ -65,6 +72,9 @@ using namespace cvt;
 */
 //==============================================================================
 ByteArrayOutputStream::ByteArrayOutputStream() :
+	m_segmentsUsed(0),
+	m_size(0),
+	m_initialSize(DefaultSegmentSize),
 	m_bClosed(false)
 {
 }
@@ -77,11 +87,14 @@ ByteArrayOutputStream::ByteArrayOutputStream() :
    As bytes are written to the output stream the buffer is automatically
    extended as required.
 
-   @param size the initial buffer size.
+   @param size the initial buffer size.  This is the size of the first
+          segment, which is allocated when the first bytes are written.
 */
 //==============================================================================
 ByteArrayOutputStream::ByteArrayOutputStream(size_t size) :
-	m_buffer(size),
+	m_segmentsUsed(0),
+	m_size(0),
+	m_initialSize(size ? size : size_t(DefaultSegmentSize)),
 	m_bClosed(false)
 {
 }
@@ -109,7 +122,56 @@ void ByteArrayOutputStream::write(const Byte* pBuffer, size_t bufLen)
 {
 	if(m_bClosed) throw IOException(QC_T("cannot write to a closed stream"));
 
-	m_buffer.append(pBuffer, bufLen);
+	while(bufLen)
+	{
+		if(!m_segmentsUsed ||
+		   m_segments[m_segmentsUsed-1].size() == m_segments[m_segmentsUsed-1].capacity())
+		{
+			addSegment(bufLen);
+		}
+
+		ByteString& segment = m_segments[m_segmentsUsed-1];
+		const size_t freeSpace = segment.capacity() - segment.size();
+		const size_t len = (bufLen < freeSpace) ? bufLen : freeSpace;
+		segment.append((const char*)pBuffer, len);
+		pBuffer += len;
+		bufLen -= len;
+		m_size += len;
+	}
+}
+
+//==============================================================================
+// ByteArrayOutputStream::addSegment
+//
+// Private helper to make another segment available for writing.  A segment
+// left over from before the last reset() is used if there is one, otherwise a
+// new segment is allocated that is large enough to double the size of the
+// buffer, or to hold the required number of bytes if that is greater.
+//==============================================================================
+void ByteArrayOutputStream::addSegment(size_t required)
+{
+	if(m_segmentsUsed < m_segments.size())
+	{
+		ByteString& spare = m_segments[m_segmentsUsed++];
+		QC_DBG_ASSERT(spare.empty());
+		if(spare.capacity() < size_t(DefaultSegmentSize))
+		{
+			spare.reserve(DefaultSegmentSize);
+		}
+		return;
+	}
+
+	size_t segmentSize = m_segments.empty() ? m_initialSize
+	                   : (m_size < size_t(MaxSegmentSize)) ? m_size
+	                   : size_t(MaxSegmentSize);
+	if(segmentSize < required)
+	{
+		segmentSize = required;
+	}
+
+	m_segments.push_back(ByteString());
+	m_segments.back().reserve(segmentSize);
+	++m_segmentsUsed;
 }
 
 //==============================================================================
@@ -119,12 +181,18 @@ void ByteArrayOutputStream::write(const Byte* pBuffer, size_t bufLen)
    Resets the internal buffer to zero size.
 
    This does not change the capacity of the internal buffer or free the
-   resources used by the buffer.
+   resources used by the buffer.  The segments are kept and are filled again
+   by subsequent writes.
 */
 //==============================================================================
 void ByteArrayOutputStream::reset()
 {
-	m_buffer.clear();
+	for(size_t i=0; i<m_segmentsUsed; ++i)
+	{
+		m_segments[i].erase();
+	}
+	m_segmentsUsed = 0;
+	m_size = 0;
 }
 
 //==============================================================================
@@ -133,6 +201,9 @@ void ByteArrayOutputStream::reset()
 /**
    Writes the contents of the internal buffer to the specified OutputStream.
 
+   The segments of the buffer are passed to @c pOut with a single gather
+   write, so they do not have to be combined first.
+
    @param pOut the OutputStream to write the contents of the buffer to.
    @throws IOException if an error occurs writing to the OutputStream.
    @throws NullPointerException if @c pOut is null.
@@ -142,7 +213,45 @@ void ByteArrayOutputStream::writeTo(OutputStream* pOut) const
 {
 	if(!pOut) throw NullPointerException();
 
-	pOut->write(m_buffer.data(), m_buffer.size());
+	std::vector<IoVec> vecs;
+	if(getSegments(vecs))
+	{
+		pOut->write(&vecs[0], vecs.size());
+	}
+}
+
+//==============================================================================
+// ByteArrayOutputStream::getSegments
+//
+/**
+   Appends an IoVec describing each segment of the internal buffer to
+   @c vecs.  Together the segments hold the bytes written to this stream,
+   in order.
+
+   The IoVec structures remain valid until the next operation that modifies
+   this ByteArrayOutputStream, or until data() is called.
+
+   @param vecs the vector to which the segment descriptions are appended.
+   @returns the number of IoVec structures appended to @c vecs.
+   @sa writeTo()
+*/
+//==============================================================================
+size_t ByteArrayOutputStream::getSegments(std::vector<IoVec>& vecs) const
+{
+	size_t count = 0;
+	for(size_t i=0; i<m_segmentsUsed; ++i)
+	{
+		const ByteString& segment = m_segments[i];
+		if(!segment.empty())
+		{
+			IoVec vec;
+			vec.pData = (const Byte*)segment.data();
+			vec.length = segment.size();
+			vecs.push_back(vec);
+			++count;
+		}
+	}
+	return count;
 }
 
 //==============================================================================
@@ -155,7 +264,7 @@ void ByteArrayOutputStream::writeTo(OutputStream* pOut) const
 //==============================================================================
 size_t ByteArrayOutputStream::size() const
 {
-	return m_buffer.size();
+	return m_size;
 }
 
 //==============================================================================
@@ -163,12 +272,87 @@ size_t ByteArrayOutputStream::size() const
 //
 /**
    Returns a constant pointer to the start of the internal byte buffer.
+
+   If the bytes are held in more than one segment, they are first copied into
+   a single segment.  The pointer remains valid until the next operation that
+   modifies this ByteArrayOutputStream.
+
+   @returns a pointer to the buffered bytes, or null if the buffer is empty
    @sa size()
+   @sa getSegments()
 */
 //==============================================================================
 const Byte* ByteArrayOutputStream::data() const
 {
-	return m_buffer.data();
+	if(!m_size)
+	{
+		return 0;
+	}
+
+	if(m_segmentsUsed > 1)
+	{
+		ByteString combined;
+		combined.reserve(m_size);
+		for(size_t i=0; i<m_segmentsUsed; ++i)
+		{
+			combined.append(m_segments[i]);
+			m_segments[i].erase();
+		}
+		m_segments[0].swap(combined);
+		m_segmentsUsed = 1;
+	}
+
+	return (const Byte*)m_segments[0].data();
+}
+
+//==============================================================================
+// ByteArrayOutputStream::toByteString
+//
+/**
+   Returns a copy of the bytes in the internal buffer.
+   @sa moveTo()
+*/
+//==============================================================================
+ByteString ByteArrayOutputStream::toByteString() const
+{
+	ByteString ret;
+	ret.reserve(m_size);
+	for(size_t i=0; i<m_segmentsUsed; ++i)
+	{
+		ret.append(m_segments[i]);
+	}
+	return ret;
+}
+
+//==============================================================================
+// ByteArrayOutputStream::moveTo
+//
+/**
+   Transfers the bytes in the internal buffer to @c ret, replacing its
+   previous contents, and then resets this ByteArrayOutputStream.
+
+   When the bytes are held in a single segment, the segment is exchanged
+   with @c ret, so no bytes are copied.
+
+   @param ret the ByteString to receive the contents of the buffer.
+   @sa toByteString()
+   @sa reset()
+*/
+//==============================================================================
+void ByteArrayOutputStream::moveTo(ByteString& ret)
+{
+	if(m_segmentsUsed == 1)
+	{
+		ret.swap(m_segments[0]);
+		m_segments[0].erase();
+		m_segmentsUsed = 0;
+		m_size = 0;
+	}
+	else
+	{
+		ret = toByteString();
+		reset();
+	}
 }
 
 //==============================================================================
@@ -242,7 +426,7 @@ String ByteArrayOutputStream::toString(CodeConverter* pDecoder) const
 	//
 	if(pDecoder->alwaysNoConversion())
 	{
-		return String((const CharType*)m_buffer.data(), m_buffer.size());
+		return String((const CharType*)data(), m_size);
 	}
 
 	//
@@ -254,8 +438,8 @@ String ByteArrayOutputStream::toString(CodeConverter* pDecoder) const
 	const size_t WorkBufferSize=256;
 	const size_t OverflowSize=10;
 	CharType workBuffer[WorkBufferSize];
-	const Byte* pFromNext = m_buffer.data();
-	const Byte* pFromEnd = pFromNext+m_buffer.size();
+	const Byte* pFromNext = data();
+	const Byte* pFromEnd = pFromNext+m_size;
 
 	while(pFromNext < pFromEnd)
 	{
@@ -36,7 +36,8 @@
 
 #include "OutputStream.h"
 
-#include "QcCore/base/AutoBuffer.h"
+#include <deque>
+#include <vector>
 
 QC_IO_NAMESPACE_BEGIN
 
@@ -50,6 +51,7 @@ public:
 
 #ifdef QC_USING_DECL_BROKEN
 	virtual void write(Byte x) {OutputStream::write(x);}
+	virtual void write(const IoVec* pVecs, size_t count) {OutputStream::write(pVecs, count);}
 #else
 	using OutputStream::write; 	// unhide inherited write method
 #endif
@@ -63,12 +65,24 @@ public:
 	String toString(CodeConverter* pDecoder) const;
 	String toString() const;
 	const Byte* data() const;
+	ByteString toByteString() const;
+	void moveTo(ByteString& ret);
+	size_t getSegments(std::vector<IoVec>& vecs) const;
 
 private:
 	ByteArrayOutputStream(const ByteArrayOutputStream& rhs);            // cannot be copied
 	ByteArrayOutputStream& operator=(const ByteArrayOutputStream& rhs); // nor assigned
 
-	AutoBuffer<Byte> m_buffer;
+	void addSegment(size_t required);
+
+private:
+	enum {DefaultSegmentSize = 256, MaxSegmentSize = 0x10000};
+	typedef std::deque<ByteString> SegmentList;
+
+	mutable SegmentList m_segments;
+	mutable size_t m_segmentsUsed;
+	size_t m_size;
+	size_t m_initialSize;
 	bool m_bClosed;
 };
 
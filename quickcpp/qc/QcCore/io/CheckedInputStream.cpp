@@ -0,0 +1,228 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CheckedInputStream
+/**
+	@class qc::io::CheckedInputStream
+	
+	@brief A FilterInputStream that adds every byte read to a
+	       util::Checksum.
+
+	Computing a checksum as the data is consumed avoids reading the data a
+	second time just to verify it.  Once the end of the stream has been
+	reached the checksum holds the value for the whole stream; it remains
+	available after the stream has been closed.
+
+	@code
+	AutoPtr<CheckedInputStream> rpIn =
+	    new CheckedInputStream(new FileInputStream(path), new CRC32C);
+	rpIn->transferTo(pOut);
+	rpIn->close();
+	if(rpIn->getChecksum()->getValue() != expected) ...
+	@endcode
+
+	When the contained stream supports readView(), so does the
+	CheckedInputStream, and the bytes are added to the checksum where they
+	lie.  Bytes that are skipped are read and added to the checksum too.
+	Because the checksum cannot be wound back, mark() and reset() are not
+	supported.
+
+	@sa CheckedOutputStream
+*/
+//==============================================================================
+
+#include "CheckedInputStream.h"
+
+#include "QcCore/base/BufferPool.h"
+#include "QcCore/base/NullPointerException.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//
+// The size of the buffer that skipped bytes are read into
+//
+const size_t SkipBufferSize = 0x2000;
+
+//==============================================================================
+// CheckedInputStream::CheckedInputStream
+//
+/**
+   Constructs a CheckedInputStream which reads from @c pInputStream and
+   adds the bytes read to @c pChecksum.
+
+   @param pInputStream the contained input stream
+   @param pChecksum the checksum to update
+   @throws NullPointerException if either argument is null.
+*/
+//==============================================================================
+CheckedInputStream::CheckedInputStream(InputStream* pInputStream,
+                                       util::Checksum* pChecksum) :
+	FilterInputStream(pInputStream),
+	m_rpChecksum(pChecksum)
+{
+	if(!pChecksum) throw NullPointerException();
+}
+
+//==============================================================================
+// CheckedInputStream::mark
+//
+/**
+   @throws IOException always, because bytes read again after a reset()
+           would be added to the checksum twice.
+*/
+//==============================================================================
+void CheckedInputStream::mark(size_t readLimit)
+{
+	InputStream::mark(readLimit);
+}
+
+//==============================================================================
+// CheckedInputStream::markSupported
+//
+/**
+   Returns false.
+*/
+//==============================================================================
+bool CheckedInputStream::markSupported() const
+{
+	return false;
+}
+
+//==============================================================================
+// CheckedInputStream::reset
+//
+/**
+   @throws IOException always, because mark() is not supported.
+*/
+//==============================================================================
+void CheckedInputStream::reset()
+{
+	InputStream::reset();
+}
+
+//==============================================================================
+// CheckedInputStream::read
+//
+//==============================================================================
+int CheckedInputStream::read()
+{
+	const int x = FilterInputStream::read();
+	if(x != EndOfFile)
+	{
+		const Byte b = Byte(x);
+		m_rpChecksum->update(&b, 1);
+	}
+	return x;
+}
+
+//==============================================================================
+// CheckedInputStream::read
+//
+//==============================================================================
+long CheckedInputStream::read(Byte* pBuffer, size_t bufLen)
+{
+	const long bytesRead = FilterInputStream::read(pBuffer, bufLen);
+	if(bytesRead > 0)
+	{
+		m_rpChecksum->update(pBuffer, bytesRead);
+	}
+	return bytesRead;
+}
+
+//==============================================================================
+// CheckedInputStream::readView
+//
+/**
+   Consumes up to @c maxLen bytes from the contained input stream without
+   copying them, adding them to the checksum where they lie.
+
+   @sa viewSupported()
+   @throws IOException if the contained input stream does not support views.
+*/
+//==============================================================================
+long CheckedInputStream::readView(const Byte*& pData, size_t maxLen)
+{
+	const long bytesRead = getInputStream()->readView(pData, maxLen);
+	if(bytesRead > 0)
+	{
+		m_rpChecksum->update(pData, bytesRead);
+	}
+	return bytesRead;
+}
+
+//==============================================================================
+// CheckedInputStream::skip
+//
+/**
+   Reads and discards up to @c n bytes, adding them to the checksum.
+
+   @returns the number of bytes skipped.
+*/
+//==============================================================================
+size_t CheckedInputStream::skip(size_t n)
+{
+	if(n == 0) return 0;
+
+	const size_t bufSize = (n < SkipBufferSize) ? n : SkipBufferSize;
+	PooledArray<Byte> buffer(bufSize);
+	size_t count = 0;
+	while(count < n)
+	{
+		const size_t toRead = (n - count < bufSize) ? n - count : bufSize;
+		const long bytesRead = read(buffer.get(), toRead);
+		if(bytesRead == EndOfFile)
+		{
+			break;
+		}
+		count += bytesRead;
+	}
+	return count;
+}
+
+//==============================================================================
+// CheckedInputStream::viewSupported
+//
+/**
+   Returns true if the contained input stream supports readView().
+*/
+//==============================================================================
+bool CheckedInputStream::viewSupported() const
+{
+	return getInputStream()->viewSupported();
+}
+
+//==============================================================================
+// CheckedInputStream::getChecksum
+//
+/**
+   Returns the checksum of the bytes read so far.
+*/
+//==============================================================================
+AutoPtr<util::Checksum> CheckedInputStream::getChecksum() const
+{
+	return m_rpChecksum;
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,104 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CheckedOutputStream
+/**
+	@class qc::io::CheckedOutputStream
+	
+	@brief A FilterOutputStream that adds every byte written to a
+	       util::Checksum.
+
+	The checksum is computed as the data passes through on its way to the
+	contained output stream, so it is ready as soon as the last byte has
+	been written, without the data having to be read back.  It remains
+	available after the stream has been closed.
+
+	Bytes are added to the checksum only once the contained stream has
+	accepted them, so a write() that throws an exception leaves the checksum
+	unchanged.
+
+	@sa CheckedInputStream
+*/
+//==============================================================================
+
+#include "CheckedOutputStream.h"
+
+#include "QcCore/base/NullPointerException.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// CheckedOutputStream::CheckedOutputStream
+//
+/**
+   Constructs a CheckedOutputStream which writes to @c pOutputStream and
+   adds the bytes written to @c pChecksum.
+
+   @param pOutputStream the contained output stream
+   @param pChecksum the checksum to update
+   @throws NullPointerException if either argument is null.
+*/
+//==============================================================================
+CheckedOutputStream::CheckedOutputStream(OutputStream* pOutputStream,
+                                         util::Checksum* pChecksum) :
+	FilterOutputStream(pOutputStream),
+	m_rpChecksum(pChecksum)
+{
+	if(!pChecksum) throw NullPointerException();
+}
+
+//==============================================================================
+// CheckedOutputStream::write
+//
+//==============================================================================
+void CheckedOutputStream::write(Byte x)
+{
+	FilterOutputStream::write(x);
+	m_rpChecksum->update(&x, 1);
+}
+
+//==============================================================================
+// CheckedOutputStream::write
+//
+//==============================================================================
+void CheckedOutputStream::write(const Byte* pBuffer, size_t bufLen)
+{
+	FilterOutputStream::write(pBuffer, bufLen);
+	m_rpChecksum->update(pBuffer, bufLen);
+}
+
+//==============================================================================
+// CheckedOutputStream::getChecksum
+//
+/**
+   Returns the checksum of the bytes written so far.
+*/
+//==============================================================================
+AutoPtr<util::Checksum> CheckedOutputStream::getChecksum() const
+{
+	return m_rpChecksum;
+}
+
+QC_IO_NAMESPACE_END
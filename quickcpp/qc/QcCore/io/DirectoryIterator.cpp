@@ -0,0 +1,299 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: DirectoryIterator
+/**
+	@class qc::io::DirectoryIterator
+
+	@brief An abstract base class that reads the entries of a directory
+	one at a time.
+
+    DirectoryIterators are created by FileSystem::openDirectory() or
+	File::openDirectory().  Unlike File::listDirectory(), which returns the
+	names of every entry at once, a DirectoryIterator reads the directory
+	incrementally, so the memory it uses does not depend on the number of
+	entries.
+
+	The iterator is initially positioned before the first entry.  Each call
+	to next() moves it to the following entry, and the methods getName(),
+	getPath(), getType(), getLength() and getLastModifiedTime() then describe
+	that entry.  The "." and ".." entries are never returned.
+
+	Most file systems report the type of each entry together with its name,
+	so getType() and isDirectory() do not normally need to query the
+	file system again.  The length and modification time are fetched when
+	first requested, using the directory that is already open rather than
+	resolving the full path name of the entry.  If the FetchStatus flag is
+	passed to openDirectory() they are fetched for a batch of entries at a
+	time as the directory is read.
+
+	Symbolic links are reported as such and are not followed.
+
+	A DirectoryIterator should only be used by one thread at a time.
+
+	@sa DirectoryWalker
+*/
+//==============================================================================
+
+#include "DirectoryIterator.h"
+#include "FileSystem.h"
+#include "FileNotFoundException.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// DirectoryIterator::DirectoryIterator
+//
+/**
+   Constructs a DirectoryIterator for the directory denoted by @c path,
+   positioned before the first entry.
+*/
+//==============================================================================
+DirectoryIterator::DirectoryIterator(const String& path) :
+	m_path(path),
+	m_type(Unknown),
+	m_bStatusKnown(false),
+	m_length(0)
+{
+}
+
+//==============================================================================
+// DirectoryIterator::~DirectoryIterator
+//
+/**
+   Destroys the DirectoryIterator, closing the directory if it is still open.
+*/
+//==============================================================================
+DirectoryIterator::~DirectoryIterator()
+{
+}
+
+#ifdef QC_DOCUMENTATION_ONLY
+
+//==============================================================================
+// DirectoryIterator::next
+//
+/**
+   Moves to the next entry in the directory.
+
+   @returns true if the iterator is positioned on an entry; false if there
+            are no more entries.
+   @throws IOException if an error occurs while reading the directory.
+*/
+//==============================================================================
+bool DirectoryIterator::next();
+
+//==============================================================================
+// DirectoryIterator::close
+//
+/**
+   Closes the directory and releases any system resources associated with
+   it.  Subsequent calls to next() return false.
+*/
+//==============================================================================
+void DirectoryIterator::close();
+
+#endif // QC_DOCUMENTATION_ONLY
+
+//==============================================================================
+// DirectoryIterator::getDirectoryPath
+//
+/**
+   Returns the path name of the directory being read.
+*/
+//==============================================================================
+const String& DirectoryIterator::getDirectoryPath() const
+{
+	return m_path;
+}
+
+//==============================================================================
+// DirectoryIterator::getName
+//
+/**
+   Returns the name of the current entry, without any directory prefix.
+*/
+//==============================================================================
+const String& DirectoryIterator::getName() const
+{
+	return m_name;
+}
+
+//==============================================================================
+// DirectoryIterator::getPath
+//
+/**
+   Returns the path name of the current entry, formed by appending its name
+   to the path name of the directory.
+*/
+//==============================================================================
+String DirectoryIterator::getPath() const
+{
+	return FileSystem::GetFileSystem()->resolve(m_path, m_name);
+}
+
+//==============================================================================
+// DirectoryIterator::getType
+//
+/**
+   Returns the type of the current entry.
+
+   If the type was not reported when the directory was read, the
+   file system is queried for it.
+
+   @throws FileNotFoundException if the entry has been removed.
+   @throws IOException if an error occurs while querying the file system.
+*/
+//==============================================================================
+DirectoryIterator::EntryType DirectoryIterator::getType()
+{
+	if(m_type == Unknown && !m_bStatusKnown)
+	{
+		fetchStatus();
+	}
+	return m_type;
+}
+
+//==============================================================================
+// DirectoryIterator::isDirectory
+//
+/**
+   Tests whether the current entry is a directory.  A symbolic link to a
+   directory is not itself a directory.
+
+   @sa getType()
+*/
+//==============================================================================
+bool DirectoryIterator::isDirectory()
+{
+	return (getType() == Directory);
+}
+
+//==============================================================================
+// DirectoryIterator::getLength
+//
+/**
+   Returns the length in bytes of the current entry.
+
+   @throws FileNotFoundException if the entry has been removed.
+   @throws IOException if an error occurs while querying the file system.
+*/
+//==============================================================================
+size_t DirectoryIterator::getLength()
+{
+	if(!m_bStatusKnown)
+	{
+		fetchStatus();
+	}
+	return m_length;
+}
+
+//==============================================================================
+// DirectoryIterator::getLastModifiedTime
+//
+/**
+   Returns the time that the current entry was last modified.
+
+   @throws FileNotFoundException if the entry has been removed.
+   @throws IOException if an error occurs while querying the file system.
+*/
+//==============================================================================
+DateTime DirectoryIterator::getLastModifiedTime()
+{
+	if(!m_bStatusKnown)
+	{
+		fetchStatus();
+	}
+	return m_lastModified;
+}
+
+//==============================================================================
+// DirectoryIterator::setEntry
+//
+/**
+   Called by derived classes to move to a new entry.  The status of the
+   entry is unknown until setStatus() is called.
+
+   @param name the name of the entry
+   @param type the type of the entry, or @c Unknown if the directory does
+          not report it
+*/
+//==============================================================================
+void DirectoryIterator::setEntry(const String& name, EntryType type)
+{
+	m_name = name;
+	m_type = type;
+	m_bStatusKnown = false;
+	m_length = 0;
+	m_lastModified = DateTime();
+}
+
+//==============================================================================
+// DirectoryIterator::setStatus
+//
+/**
+   Called by derived classes to record the status of the current entry.
+*/
+//==============================================================================
+void DirectoryIterator::setStatus(EntryType type, size_t length, const DateTime& lastModified)
+{
+	m_type = type;
+	m_length = length;
+	m_lastModified = lastModified;
+	m_bStatusKnown = true;
+}
+
+//==============================================================================
+// DirectoryIterator::fetchStatus
+//
+/**
+   Queries the file system for the status of the current entry and records
+   it by calling setStatus().
+
+   The default implementation queries the FileSystem by path name.  Derived
+   classes override it with something cheaper where they can.
+
+   @throws FileNotFoundException if the entry has been removed.
+*/
+//==============================================================================
+void DirectoryIterator::fetchStatus()
+{
+	AutoPtr<FileSystem> rpFS = FileSystem::GetFileSystem();
+	const String path = getPath();
+	const int attrs = rpFS->getFileAttributeFlags(path);
+
+	if(!(attrs & FileSystem::Exists))
+	{
+		throw FileNotFoundException(path);
+	}
+
+	const EntryType type = (attrs & FileSystem::Directory) ? Directory
+	                     : (attrs & FileSystem::RegularFile) ? RegularFile
+	                     : Other;
+
+	setStatus(type, rpFS->getLength(path), rpFS->getLastModifiedTime(path));
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,90 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: DirectoryIterator
+// 
+//==============================================================================
+
+#ifndef QC_IO_DirectoryIterator_h
+#define QC_IO_DirectoryIterator_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "QcCore/util/DateTime.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+using util::DateTime;
+
+class QC_IO_PKG DirectoryIterator : public virtual QCObject
+{
+public:
+	enum Flags {FetchStatus = 0x01 /*!< fetch the length and modification time of each entry as it is read */};
+
+	enum EntryType {Unknown      /*!< type not yet known */,
+	                RegularFile  /*!< a regular file */,
+	                Directory    /*!< a directory */,
+	                SymbolicLink /*!< a symbolic link, which is not followed */,
+	                Other        /*!< a device, pipe, socket or other special file */};
+
+	virtual ~DirectoryIterator();
+
+	virtual bool next()=0;
+	virtual void close()=0;
+
+	const String& getDirectoryPath() const;
+	const String& getName() const;
+	String getPath() const;
+
+	EntryType getType();
+	bool isDirectory();
+	size_t getLength();
+	DateTime getLastModifiedTime();
+
+protected:
+	DirectoryIterator(const String& path);
+
+	void setEntry(const String& name, EntryType type);
+	void setStatus(EntryType type, size_t length, const DateTime& lastModified);
+	virtual void fetchStatus();
+
+private: // not implemented
+	DirectoryIterator(const DirectoryIterator& rhs);            // cannot be copied
+	DirectoryIterator& operator=(const DirectoryIterator& rhs); // nor assigned
+
+private:
+	String m_path;
+	String m_name;
+	EntryType m_type;
+	bool m_bStatusKnown;
+	size_t m_length;
+	DateTime m_lastModified;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_DirectoryIterator_h
@@ -0,0 +1,532 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: DirectoryWalker
+//
+/**
+	@class qc::io::DirectoryWalker
+
+	@brief Visits every entry of a directory tree using several threads.
+
+	A DirectoryWalker reads the directories of a tree with DirectoryIterators
+	and passes each entry to a Visitor.  Sub-directories are placed on a
+	shared queue as they are found, and up to getThreadCount() threads from
+	the shared ThreadPool, including the calling thread, take directories
+	from the queue and read them concurrently.  The walk() method returns
+	once every directory has been read.
+
+	The Visitor decides which directories are entered, through
+	Visitor::enterDirectory(), and which I/O errors are ignored, through
+	Visitor::ignoreError().  As directories are read concurrently, the
+	Visitor's methods are called from different threads at the same time
+	and must be thread-safe.  The order in which entries are visited is not
+	defined.
+
+	Whether an entry is a directory is normally known from the directory
+	itself, so walking a tree does not require a stat() of every entry.  If
+	the Visitor needs the length or modification time of most entries, the
+	DirectoryIterator::FetchStatus flag can be set with setIteratorFlags().
+
+	Symbolic links are visited but never followed, so a tree containing a
+	link to one of its own directories is walked only once.
+
+	If an exception is thrown while a directory is being read on a pooled
+	thread, the directory is read again on the calling thread once the other
+	directories are complete.  In this way any exception is thrown on the
+	calling thread, exactly as it would be by a serial walk.  Note that this
+	means a Visitor that throws an exception may be passed some entries a
+	second time.
+
+	In single-threaded versions of the library the walk is serial.
+*/
+//==============================================================================
+
+#include "DirectoryWalker.h"
+#include "FileSystem.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/ThreadPool.h"
+
+#include <deque>
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// Class: DirectoryWalker::Walk
+//
+// The state of a single call to walk(): the queue of directories still to be
+// read and the number of directories being read.  Directories are taken from
+// the back of the queue, so the tree is walked roughly depth-first, which
+// keeps the queue short.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class DirectoryWalker::Walk : public Monitor
+{
+public:
+	struct PendingDirectory
+	{
+		String path;
+		size_t depth;
+	};
+
+	typedef std::deque<PendingDirectory> DirectoryQueue;
+
+	Walk(Visitor* pVisitor, size_t maxDepth, int iteratorFlags) :
+		m_rpVisitor(pVisitor),
+		m_maxDepth(maxDepth),
+		m_iteratorFlags(iteratorFlags),
+		m_active(0),
+		m_bFinished(false) {}
+
+	void run(const String& path, size_t numThreads);
+	void work();
+
+private:
+	class Task;
+
+	bool takeDirectory(PendingDirectory& dir);
+	void directoryFinished(const PendingDirectory* pFailed);
+	void addDirectories(DirectoryQueue& dirs);
+	void processDirectory(const PendingDirectory& dir);
+
+private:
+	AutoPtr<Visitor> m_rpVisitor;
+	size_t m_maxDepth;
+	int m_iteratorFlags;
+	DirectoryQueue m_queue;
+	DirectoryQueue m_failed;
+	size_t m_active;
+	bool m_bFinished;
+};
+
+#ifdef QC_MT
+
+//==============================================================================
+// Class: DirectoryWalker::Walk::Task
+//
+// Reads directories from the queue of a Walk on a pooled thread.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class DirectoryWalker::Walk::Task : public Runnable
+{
+public:
+	Task(Walk* pWalk) : m_rpWalk(pWalk) {}
+
+	virtual void run()
+	{
+		m_rpWalk->work();
+	}
+
+private:
+	AutoPtr<Walk> m_rpWalk;
+};
+
+#endif //QC_MT
+
+//==============================================================================
+// DirectoryWalker::Walk::run
+//
+// Walks the tree.  The calling thread reads directories alongside up to
+// numThreads-1 pooled threads until the queue is empty.  Directories that
+// failed are then read serially, allowing any exception to propagate.
+//==============================================================================
+void DirectoryWalker::Walk::run(const String& path, size_t numThreads)
+{
+	if(m_maxDepth == 0 || !m_rpVisitor->enterDirectory(path, 0))
+	{
+		return;
+	}
+
+	PendingDirectory root;
+	root.path = path;
+	root.depth = 0;
+	m_queue.push_back(root);
+
+#ifdef QC_MT
+
+	if(numThreads > 1)
+	{
+		AutoPtr<ThreadPool> rpPool = ThreadPool::GetDefaultPool();
+
+		for(size_t i=1; i<numThreads; ++i)
+		{
+			rpPool->execute(new Task(this));
+		}
+
+		//
+		// Tasks that only start once the walk has finished return at once
+		//
+		work();
+
+		QC_SYNCHRONIZED
+		m_queue.swap(m_failed);
+	}
+
+#else
+
+	(void)numThreads;
+
+#endif //QC_MT
+
+	while(!m_queue.empty())
+	{
+		const PendingDirectory dir = m_queue.back();
+		m_queue.pop_back();
+		processDirectory(dir);
+	}
+}
+
+#ifdef QC_MT
+
+//==============================================================================
+// DirectoryWalker::Walk::work
+//
+// Reads directories from the queue until the walk is finished.  Errors are
+// not thrown: the directory is queued to be read again on the calling thread.
+//==============================================================================
+void DirectoryWalker::Walk::work()
+{
+	PendingDirectory dir;
+	while(takeDirectory(dir))
+	{
+		try
+		{
+			processDirectory(dir);
+			directoryFinished(0);
+		}
+		catch(Exception& /*e*/)
+		{
+			directoryFinished(&dir);
+		}
+	}
+}
+
+//==============================================================================
+// DirectoryWalker::Walk::takeDirectory
+//
+// Waits until there is a directory to read, or until the queue is empty and
+// no other thread is reading a directory that could add to it, in which case
+// the walk is finished and false is returned.
+//==============================================================================
+bool DirectoryWalker::Walk::takeDirectory(PendingDirectory& dir)
+{
+	QC_SYNCHRONIZED
+	while(!m_bFinished)
+	{
+		if(!m_queue.empty())
+		{
+			dir = m_queue.back();
+			m_queue.pop_back();
+			++m_active;
+			return true;
+		}
+		else if(m_active == 0)
+		{
+			m_bFinished = true;
+			notifyAll();
+		}
+		else
+		{
+			wait();
+		}
+	}
+	return false;
+}
+
+//==============================================================================
+// DirectoryWalker::Walk::directoryFinished
+//
+//==============================================================================
+void DirectoryWalker::Walk::directoryFinished(const PendingDirectory* pFailed)
+{
+	QC_SYNCHRONIZED
+	if(pFailed)
+	{
+		m_failed.push_back(*pFailed);
+	}
+	if(--m_active == 0 && m_queue.empty())
+	{
+		notifyAll();
+	}
+}
+
+#endif //QC_MT
+
+//==============================================================================
+// DirectoryWalker::Walk::addDirectories
+//
+// Moves newly found directories onto the queue and wakes any threads that
+// are waiting for work.
+//==============================================================================
+void DirectoryWalker::Walk::addDirectories(DirectoryQueue& dirs)
+{
+	QC_SYNCHRONIZED
+	m_queue.insert(m_queue.end(), dirs.begin(), dirs.end());
+	dirs.clear();
+#ifdef QC_MT
+	notifyAll();
+#endif //QC_MT
+}
+
+//==============================================================================
+// DirectoryWalker::Walk::processDirectory
+//
+// Reads a single directory, visiting each entry and collecting the
+// sub-directories to be entered.  The sub-directories are only queued once
+// the whole directory has been read, so that a directory that fails and is
+// read again does not queue them twice.
+//==============================================================================
+void DirectoryWalker::Walk::processDirectory(const PendingDirectory& dir)
+{
+	const size_t depth = dir.depth + 1;
+	DirectoryQueue subDirs;
+
+	try
+	{
+		AutoPtr<DirectoryIterator> rpIter =
+			FileSystem::GetFileSystem()->openDirectory(dir.path, m_iteratorFlags);
+
+		while(rpIter->next())
+		{
+			try
+			{
+				m_rpVisitor->visitEntry(rpIter.get(), depth);
+
+				if(depth < m_maxDepth && rpIter->isDirectory())
+				{
+					PendingDirectory subDir;
+					subDir.path = rpIter->getPath();
+					subDir.depth = depth;
+					if(m_rpVisitor->enterDirectory(subDir.path, depth))
+					{
+						subDirs.push_back(subDir);
+					}
+				}
+			}
+			catch(IOException& e)
+			{
+				if(!m_rpVisitor->ignoreError(rpIter->getPath(), e))
+				{
+					throw;
+				}
+			}
+		}
+	}
+	catch(IOException& e)
+	{
+		if(!m_rpVisitor->ignoreError(dir.path, e))
+		{
+			throw;
+		}
+	}
+
+	if(!subDirs.empty())
+	{
+		addDirectories(subDirs);
+	}
+}
+
+//==============================================================================
+// DirectoryWalker::Visitor::enterDirectory
+//
+/**
+   Called before the entries of a directory are read, to decide whether the
+   directory should be entered.  It is called for the root of the tree as
+   well as for each sub-directory, after the sub-directory has itself been
+   passed to visitEntry().
+
+   The default implementation returns true.
+
+   @param path the path name of the directory
+   @param depth the depth of the directory within the tree.  The root has
+          a depth of zero.
+   @returns true if the entries of the directory should be visited.
+*/
+//==============================================================================
+bool DirectoryWalker::Visitor::enterDirectory(const String& /*path*/, size_t /*depth*/)
+{
+	return true;
+}
+
+//==============================================================================
+// DirectoryWalker::Visitor::ignoreError
+//
+/**
+   Called when an IOException is thrown while a directory is being read or
+   an entry is being visited, for example because the directory cannot be
+   opened or an entry has been removed.
+
+   The default implementation returns false.
+
+   @param path the path name of the directory or entry
+   @param e the exception
+   @returns true to skip the rest of the directory, or the entry, and
+            continue the walk; false to stop the walk and throw the
+            exception from DirectoryWalker::walk().
+*/
+//==============================================================================
+bool DirectoryWalker::Visitor::ignoreError(const String& /*path*/, const IOException& /*e*/)
+{
+	return false;
+}
+
+//==============================================================================
+// DirectoryWalker::DirectoryWalker
+//
+/**
+   Constructs a DirectoryWalker.
+
+   @param numThreads the maximum number of threads used to read directories,
+          including the calling thread.  If zero, one thread is used for
+          each processor.
+*/
+//==============================================================================
+DirectoryWalker::DirectoryWalker(size_t numThreads) :
+	m_numThreads(numThreads ? numThreads : ThreadPool::GetProcessorCount()),
+	m_maxDepth(size_t(-1)),
+	m_iteratorFlags(0)
+{
+}
+
+//==============================================================================
+// DirectoryWalker::walk
+//
+/**
+   Visits every entry of the directory tree rooted at @c path, returning when
+   the whole tree has been read.
+
+   @param path the path name of the root directory.  Path names passed to
+          the Visitor begin with this path.
+   @param pVisitor the Visitor that receives the entries
+   @throws NullPointerException if @c pVisitor is null.
+   @throws FileNotFoundException if the root directory does not exist and the
+           Visitor does not ignore the error.
+   @throws IOException if an I/O error occurs that the Visitor does not
+           ignore.
+   @throws Exception any exception thrown by @c pVisitor.
+*/
+//==============================================================================
+void DirectoryWalker::walk(const String& path, Visitor* pVisitor)
+{
+	if(!pVisitor) throw NullPointerException();
+
+	AutoPtr<Walk> rpWalk = new Walk(pVisitor, m_maxDepth, m_iteratorFlags);
+	rpWalk->run(path, m_numThreads);
+}
+
+//==============================================================================
+// DirectoryWalker::getThreadCount
+//
+/**
+   Returns the maximum number of threads used to read directories.
+*/
+//==============================================================================
+size_t DirectoryWalker::getThreadCount() const
+{
+	return m_numThreads;
+}
+
+//==============================================================================
+// DirectoryWalker::setThreadCount
+//
+/**
+   Sets the maximum number of threads used to read directories, including
+   the calling thread.
+
+   The directories are read by the default ThreadPool, which has one thread
+   for each processor; a larger value does not increase the number of
+   directories read at once.
+
+   @param numThreads the maximum number of threads.  If zero, one thread is
+          used for each processor.
+*/
+//==============================================================================
+void DirectoryWalker::setThreadCount(size_t numThreads)
+{
+	m_numThreads = numThreads ? numThreads : ThreadPool::GetProcessorCount();
+}
+
+//==============================================================================
+// DirectoryWalker::getMaxDepth
+//
+/**
+   Returns the maximum depth of the entries that are visited.
+*/
+//==============================================================================
+size_t DirectoryWalker::getMaxDepth() const
+{
+	return m_maxDepth;
+}
+
+//==============================================================================
+// DirectoryWalker::setMaxDepth
+//
+/**
+   Sets the maximum depth of the entries that are visited.  The entries of
+   the root directory have a depth of one, so a maximum depth of one visits
+   the root directory without entering any of its sub-directories.  By
+   default there is no limit.
+
+   @param depth the maximum depth
+*/
+//==============================================================================
+void DirectoryWalker::setMaxDepth(size_t depth)
+{
+	m_maxDepth = depth;
+}
+
+//==============================================================================
+// DirectoryWalker::getIteratorFlags
+//
+/**
+   Returns the flags passed to FileSystem::openDirectory() for each
+   directory.
+*/
+//==============================================================================
+int DirectoryWalker::getIteratorFlags() const
+{
+	return m_iteratorFlags;
+}
+
+//==============================================================================
+// DirectoryWalker::setIteratorFlags
+//
+/**
+   Sets the flags passed to FileSystem::openDirectory() for each directory.
+   The default is zero.
+
+   @param flags zero or more DirectoryIterator::Flags values combined
+          using the bitwise OR operator
+   @sa DirectoryIterator::FetchStatus
+*/
+//==============================================================================
+void DirectoryWalker::setIteratorFlags(int flags)
+{
+	m_iteratorFlags = flags;
+}
+
+QC_IO_NAMESPACE_END
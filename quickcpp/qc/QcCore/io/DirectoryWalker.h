@@ -0,0 +1,84 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: DirectoryWalker
+// 
+// Visits every entry of a directory tree, reading the directories
+// concurrently.
+//
+//==============================================================================
+
+#ifndef QC_IO_DirectoryWalker_h
+#define QC_IO_DirectoryWalker_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "DirectoryIterator.h"
+#include "IOException.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG DirectoryWalker : public virtual QCObject
+{
+public:
+
+	class Visitor : public virtual QCObject
+	{
+	public:
+		virtual bool enterDirectory(const String& path, size_t depth);
+		virtual void visitEntry(DirectoryIterator* pEntry, size_t depth)=0;
+		virtual bool ignoreError(const String& path, const IOException& e);
+	};
+
+	DirectoryWalker(size_t numThreads=0);
+
+	void walk(const String& path, Visitor* pVisitor);
+
+	size_t getThreadCount() const;
+	void setThreadCount(size_t numThreads);
+
+	size_t getMaxDepth() const;
+	void setMaxDepth(size_t depth);
+
+	int getIteratorFlags() const;
+	void setIteratorFlags(int flags);
+
+private:
+	DirectoryWalker(const DirectoryWalker& rhs);            // not implemented
+	DirectoryWalker& operator=(const DirectoryWalker& rhs); // not implemented
+
+	class Walk;
+
+private:
+	size_t m_numThreads;
+	size_t m_maxDepth;
+	int m_iteratorFlags;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_DirectoryWalker_h
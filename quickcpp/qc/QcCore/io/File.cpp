@@ -367,6 +367,32 @@ size_t File::length() const
 	return m_rpFS->getLength(m_path);
 }
 
+//==============================================================================
+// File::status
+//
+/**
+	Returns a snapshot of the status of the file denoted by this abstract
+	pathname.
+
+	This resolves the abstract filename and uses it to probe the file system
+	once, obtaining at the same time whether the file exists, whether it is a
+	file or a directory, whether it can be read or written to, its length and
+	the time it was last modified.  This is cheaper than calling exists(),
+	isFile(), canRead(), length() and lastModified() individually, each of
+	which probes the file system again.
+
+	Where the status of the same file is tested repeatedly, FileStatusCache
+	can be used to avoid probing the file system on every occasion.
+
+	@returns a FileStatus, for which FileStatus::exists() returns false if
+	         the file does not exist.
+*/
+//==============================================================================
+FileStatus File::status() const
+{
+	return m_rpFS->getFileStatus(m_path);
+}
+
 //==============================================================================
 // File::getAbsolutePath
 //
@@ -679,6 +705,30 @@ std::list<String> File::listDirectory() const
 	return retList;
 }
 
+//==============================================================================
+// File::openDirectory
+//
+/**
+	Opens the directory denoted by this abstract pathname so that its
+	entries can be read one at a time.
+
+	Unlike listDirectory(), this does not read the whole directory before
+	returning, and the DirectoryIterator can usually report whether each
+	entry is a directory without querying the file system again.
+
+	@param flags zero or more DirectoryIterator::Flags values combined
+	       using the bitwise OR operator
+	@returns a DirectoryIterator positioned before the first entry.
+	@throws FileNotFoundException if the directory does not exist.
+	@throws IOException if an error occurs while opening the directory.
+	@sa DirectoryWalker
+*/
+//==============================================================================
+AutoPtr<DirectoryIterator> File::openDirectory(int flags) const
+{
+	return m_rpFS->openDirectory(m_path, flags);
+}
+
 //==============================================================================
 // File::mkdir
 //
@@ -65,7 +65,9 @@ public:
 	bool isDirectory() const;
 	bool isFile() const;
 	size_t length() const;
+	FileStatus status() const;
 	std::list<String> listDirectory() const;
+	AutoPtr<DirectoryIterator> openDirectory(int flags=0) const;
 	void createNewFile() const;
 	void mkdir() const;
 	void mkdirs() const;
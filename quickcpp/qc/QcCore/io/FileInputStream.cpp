@@ -33,20 +33,37 @@
 	open file in the file system.  The open file is represented by a
 	FileDescriptor which ensures the file is closed when 
 	the FileInputStream is destroyed.
+
+	Applications that read large files can tell the operating system how the
+	file will be read by calling advise(), so that it can read ahead further
+	or less far.  A file that is read once from start to finish need not
+	remain in the system's file cache afterwards, where it would displace data
+	that other processes use.  setDropBehind() releases the parts of the file
+	that have been read from the cache as reading proceeds.  Alternatively,
+	the file can be opened with the DirectIO option, which reads it without
+	using the cache at all.  DirectIO transfers are made through an aligned
+	buffer of 1MB, and so suit bulk copies rather than small reads.
 */
 //==============================================================================
 
 #include "FileInputStream.h"
+#include "AlignedBuffer.h"
 #include "File.h"
 #include "FileSystem.h"
 #include "FileDescriptor.h"
 #include "IOException.h"
+#include "OutputStream.h"
 
 #include "QcCore/base/NullPointerException.h"
 #include "QcCore/base/SystemUtils.h"
 
+#include <string.h>
+
 QC_IO_NAMESPACE_BEGIN
 
+const size_t DirectBufferSize = 0x100000;   // buffer used for DirectIO reads
+const size_t DropBehindInterval = 0x400000; // bytes read between releases
+
 //==============================================================================
 // FileInputStream::FileInputStream
 //
@@ -63,7 +80,34 @@ QC_IO_NAMESPACE_BEGIN
 //==============================================================================
 FileInputStream::FileInputStream(const File& file)
 {
-	open(file.getPath());
+	init();
+	open(file.getPath(), 0);
+}
+
+//==============================================================================
+// FileInputStream::FileInputStream
+//
+/**
+   Constructs a FileInputStream by opening a connection to the file with
+   the abstract pathname denoted by @c file, using the given options.
+
+   If @c options includes DirectIO, the file is read bypassing the system's
+   file cache where the operating system and file system allow it.  On file
+   systems that do not, the file is read normally.
+
+   @param file the abstract pathname of the file to open
+   @param options zero or more Option values combined using the bitwise
+          OR operator
+   @throws FileNotFoundException if a file with the specified name does not
+           exist on the file system.  
+   @throws IOException if the specified file could not be opened.  This includes
+           the case where @c file refers to a directory instead of a normal file.
+*/
+//==============================================================================
+FileInputStream::FileInputStream(const File& file, int options)
+{
+	init();
+	open(file.getPath(), options);
 }
 
 //==============================================================================
@@ -81,7 +125,31 @@ FileInputStream::FileInputStream(const File& file)
 //==============================================================================
 FileInputStream::FileInputStream(const String& name)
 {
-	open(name);
+	init();
+	open(name, 0);
+}
+
+//==============================================================================
+// FileInputStream::FileInputStream
+//
+/**
+   Constructs a FileInputStream by opening a connection to the named file
+   @c name, using the given options.
+
+   @param name the name of the file to open
+   @param options zero or more Option values combined using the bitwise
+          OR operator
+   @throws FileNotFoundException if a file with the specified name does not
+           exist on the file system.  
+   @throws IOException if the specified file name could not be opened.  This includes
+           the case where @c name refers to a directory instead of a normal file.
+   @sa FileInputStream(const File&, int)
+*/
+//==============================================================================
+FileInputStream::FileInputStream(const String& name, int options)
+{
+	init();
+	open(name, options);
 }
 
 //==============================================================================
@@ -99,6 +167,31 @@ FileInputStream::FileInputStream(FileDescriptor* pFD) :
 	m_rpFD(pFD)
 {
 	if(!pFD) throw NullPointerException();
+	init();
+}
+
+//==============================================================================
+// FileInputStream::~FileInputStream
+//
+//==============================================================================
+FileInputStream::~FileInputStream()
+{
+	delete m_pDirectBuffer;
+}
+
+//==============================================================================
+// FileInputStream::init
+//
+// Private helper function called by each constructor.
+//==============================================================================
+void FileInputStream::init()
+{
+	m_pDirectBuffer = 0;
+	m_directPos = 0;
+	m_directLimit = 0;
+	m_bDropBehind = false;
+	m_dropBehindPos = 0;
+	m_dropBehindPending = 0;
 }
 
 //==============================================================================
@@ -114,6 +207,9 @@ void FileInputStream::close()
 		m_rpFD->close();
 		m_rpFD.release();
 	}
+	delete m_pDirectBuffer;
+	m_pDirectBuffer = 0;
+	m_directPos = m_directLimit = 0;
 }
 
 //==============================================================================
@@ -125,15 +221,221 @@ long FileInputStream::read(Byte* pBuffer, size_t bufLen)
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
 
-	size_t bytesRead = m_rpFD->getFileSystem()->readFile(m_rpFD.get(), pBuffer, bufLen);
+	size_t bytesRead = m_pDirectBuffer
+		? readDirect(pBuffer, bufLen)
+		: m_rpFD->getFileSystem()->readFile(m_rpFD.get(), pBuffer, bufLen);
 
 	if(bytesRead == 0)
 	{
 		return EndOfFile;
 	}
+
+	if(m_bDropBehind)
+	{
+		dropBehind(bytesRead, false);
+	}
+
 	return bytesRead;
 }
 
+//==============================================================================
+// FileInputStream::readDirect
+//
+// Reads from a file opened with DirectIO.  Direct transfers must use aligned
+// buffers and lengths, so the file is read a block at a time into the
+// aligned buffer and copied out from there.  A large request into a buffer
+// that happens to be aligned is read straight into it.
+//
+// Every transfer is a multiple of the alignment, so the file position stays
+// aligned until the end of the file is reached.
+//==============================================================================
+size_t FileInputStream::readDirect(Byte* pBuffer, size_t bufLen)
+{
+	if(m_directPos == m_directLimit)
+	{
+		const size_t alignment = FileSystem::DirectAlignment;
+		AutoPtr<FileSystem> rpFS = m_rpFD->getFileSystem();
+
+		if(bufLen >= alignment && AlignedBuffer::IsAligned(pBuffer, alignment))
+		{
+			return rpFS->readFile(m_rpFD.get(), pBuffer, bufLen & ~(alignment-1));
+		}
+
+		m_directPos = 0;
+		m_directLimit = rpFS->readFile(m_rpFD.get(), m_pDirectBuffer->get(),
+		                               m_pDirectBuffer->size());
+	}
+
+	const size_t available = m_directLimit - m_directPos;
+	const size_t len = (bufLen < available) ? bufLen : available;
+	::memcpy(pBuffer, m_pDirectBuffer->get() + m_directPos, len);
+	m_directPos += len;
+	return len;
+}
+
+//==============================================================================
+// FileInputStream::transferTo
+//
+/**
+   Writes the remainder of the file to the OutputStream @c pOut.
+
+   Rather than reading the file itself, the FileInputStream passes its
+   FileDescriptor and current position to OutputStream::transferFrom().  This
+   allows an OutputStream connected to a socket to have the operating system
+   send the file directly, without the data passing through a user buffer.
+   When the file does not support positioning (for example a pipe or the
+   console), the bytes are copied using InputStream::transferTo().
+
+   @param pOut the OutputStream to write to
+   @returns the number of bytes transferred.
+   @throws NullPointerException if @c pOut is null.
+   @throws IOException if this FileInputStream is closed or an I/O
+           error occurs.
+*/
+//==============================================================================
+size_t FileInputStream::transferTo(OutputStream* pOut)
+{
+	if(!pOut) throw NullPointerException();
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	//
+	// Bytes already read into the DirectIO buffer must be written first, and
+	// the operating system would read the rest of the file through its cache
+	//
+	if(m_pDirectBuffer)
+	{
+		return InputStream::transferTo(pOut);
+	}
+
+	AutoPtr<FileSystem> rpFS = m_rpFD->getFileSystem();
+	FileOffset pos;
+
+	try
+	{
+		pos = rpFS->getFilePosition(m_rpFD.get());
+	}
+	catch(IOException& /*e*/)
+	{
+		return InputStream::transferTo(pOut);
+	}
+
+	const size_t count = pOut->transferFrom(m_rpFD.get(), pos, size_t(-1));
+
+	if(m_bDropBehind)
+	{
+		dropBehind(count, true);
+	}
+
+	return count;
+}
+
+//==============================================================================
+// FileInputStream::advise
+//
+/**
+   Tells the operating system how the file will be read, so that it can
+   adjust how far it reads ahead and how long it keeps the data in its
+   cache.
+
+   For example, SequentialAccess increases the amount read ahead for a file
+   that will be read from start to finish, WillNeed starts reading a range
+   into the cache before it is required and DontNeed releases a range that
+   will not be read again.
+
+   This is a hint and has no effect on the bytes returned by read().
+
+   @param advice the expected pattern of access
+   @param offset the offset of the first byte the advice applies to
+   @param length the number of bytes the advice applies to, or zero for the
+          remainder of the file
+   @throws IOException if this FileInputStream is closed.
+   @sa setDropBehind()
+*/
+//==============================================================================
+void FileInputStream::advise(FileSystem::AccessAdvice advice, FileOffset offset, FileOffset length)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	m_rpFD->getFileSystem()->adviseFile(m_rpFD.get(), offset, length, advice);
+}
+
+//==============================================================================
+// FileInputStream::isDropBehind
+//
+/**
+   Tests if the parts of the file that have been read are being released
+   from the system's file cache.
+   @sa setDropBehind()
+*/
+//==============================================================================
+bool FileInputStream::isDropBehind() const
+{
+	return m_bDropBehind;
+}
+
+//==============================================================================
+// FileInputStream::setDropBehind
+//
+/**
+   Enables or disables releasing the parts of the file that have been read
+   from the system's file cache.
+
+   When enabled, the data read from the file is released from the cache
+   every few megabytes, using FileSystem::adviseFile() with
+   FileSystem::DontNeed.  This allows an application to read a large file
+   once without displacing data that is in use by other processes.
+
+   Drop-behind has no effect on files, such as pipes, that do not support
+   positioning.
+
+   @param bDropBehind true to enable drop-behind; false to disable it
+   @throws IOException if this FileInputStream is closed.
+*/
+//==============================================================================
+void FileInputStream::setDropBehind(bool bDropBehind)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	m_bDropBehind = false;
+	if(bDropBehind)
+	{
+		try
+		{
+			m_dropBehindPos = m_rpFD->getFileSystem()->getFilePosition(m_rpFD.get());
+			m_dropBehindPending = 0;
+			m_bDropBehind = true;
+		}
+		catch(IOException& /*e*/)
+		{
+			// the file does not support positioning
+		}
+	}
+}
+
+//==============================================================================
+// FileInputStream::dropBehind
+//
+// Releases the data read since the last release from the file cache, once
+// DropBehindInterval bytes have been read or when bForce is true.
+//==============================================================================
+void FileInputStream::dropBehind(size_t bytesRead, bool bForce)
+{
+	m_dropBehindPending += bytesRead;
+	if(bForce || m_dropBehindPending >= DropBehindInterval)
+	{
+		AutoPtr<FileSystem> rpFS = m_rpFD->getFileSystem();
+		const FileOffset pos = rpFS->getFilePosition(m_rpFD.get());
+		if(pos > m_dropBehindPos)
+
+		{
+			rpFS->adviseFile(m_rpFD.get(), m_dropBehindPos, pos - m_dropBehindPos,
+			                 FileSystem::DontNeed);
+		}
+		m_dropBehindPos = pos;
+		m_dropBehindPending = 0;
+	}
+}
+
 //==============================================================================
 // FileInputStream::getFD
 //
@@ -153,18 +455,29 @@ AutoPtr<FileDescriptor> FileInputStream::getFD() const
 //
 // Private helper function.
 //==============================================================================
-void FileInputStream::open(const String& fileName) 
+void FileInputStream::open(const String& fileName, int options) 
 {
 	if(fileName.empty())
 		throw IOException(QC_T("empty filename"));
 	else if(FileSystem::GetFileSystem()->getFileAttributeFlags(fileName) & FileSystem::Directory)
 		throw IOException(fileName + QC_T(" is a directory"));
 
+	int accessFlags = FileSystem::ReadAccess;
+	if(options & DirectIO)
+	{
+		accessFlags |= FileSystem::DirectAccess;
+	}
+
 	m_rpFD = 
 		FileSystem::GetFileSystem()->openFile(fileName,
-		                                      FileSystem::ReadAccess,
+		                                      accessFlags,
 		                                      FileSystem::OpenExisting,
 		                                      0);
+
+	if(options & DirectIO)
+	{
+		m_pDirectBuffer = new AlignedBuffer(DirectBufferSize, FileSystem::DirectAlignment);
+	}
 }
 
 QC_IO_NAMESPACE_END
@@ -31,9 +31,11 @@
 #endif //QC_IO_DEFS_h
 
 #include "InputStream.h"
+#include "FileSystem.h"
 
 QC_IO_NAMESPACE_BEGIN
 
+class AlignedBuffer;
 class File;
 class FileDescriptor;
 
@@ -41,9 +43,14 @@ class QC_IO_PKG FileInputStream : public InputStream
 {
 public:
 
+	enum Option {DirectIO = 0x01 /*!< read the file bypassing the system's file cache */};
+
 	FileInputStream(const File& file);
+	FileInputStream(const File& file, int options);
 	FileInputStream(const String& name);
+	FileInputStream(const String& name, int options);
 	FileInputStream(FileDescriptor* pFD);
+	virtual ~FileInputStream();
 
 	virtual void close();
 
@@ -54,6 +61,11 @@ public:
 #endif
 
 	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual size_t transferTo(OutputStream* pOut);
+
+	void advise(FileSystem::AccessAdvice advice, FileOffset offset=0, FileOffset length=0);
+	bool isDropBehind() const;
+	void setDropBehind(bool bDropBehind);
 
 	AutoPtr<FileDescriptor> getFD() const;
 
@@ -61,10 +73,20 @@ private:
 	FileInputStream(const FileInputStream& rhs);            // cannot be copied
 	FileInputStream& operator=(const FileInputStream& rhs); // nor assigned
 
-	void open(const String& fileName);
+	void init();
+	void open(const String& fileName, int options);
+	size_t readDirect(Byte* pBuffer, size_t bufLen);
+	void dropBehind(size_t bytesRead, bool bForce);
 
 private:
 	AutoPtr<FileDescriptor> m_rpFD;
+	AlignedBuffer* m_pDirectBuffer;
+	size_t m_directPos;
+	size_t m_directLimit;
+	bool m_bDropBehind;
+	FileOffset m_dropBehindPos;
+
+	size_t m_dropBehindPending;
 };
 
 QC_IO_NAMESPACE_END
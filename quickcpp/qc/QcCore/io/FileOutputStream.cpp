@@ -33,10 +33,19 @@
 	open file in the file system.  The open file is represented internally 
 	using a FileDescriptor which ensures that the file is closed when 
 	the FileOutputStream is destroyed.
+
+	An application that writes a large file can prevent it from filling the
+	system's file cache, where it would displace data that other processes
+	use, by calling setDropBehind().  Alternatively, the file can be opened
+	with the DirectIO option, which writes it without using the cache at all.
+	DirectIO transfers are made through an aligned buffer of 1MB, so unlike
+	other FileOutputStreams, written data may be held by the stream until
+	flush() or close() is called.
 */
 //==============================================================================
 
 #include "FileOutputStream.h"
+#include "AlignedBuffer.h"
 #include "File.h"
 #include "FileNotFoundException.h"
 #include "FileSystem.h"
@@ -44,8 +53,13 @@
 
 #include "QcCore/base/NullPointerException.h"
 
+#include <string.h>
+
 QC_IO_NAMESPACE_BEGIN
 
+const size_t DirectBufferSize = 0x100000;   // buffer used for DirectIO writes
+const size_t DropBehindInterval = 0x400000; // bytes written between releases
+
 //==============================================================================
 // FileOutputStream::FileOutputStream
 //
@@ -63,7 +77,34 @@ QC_IO_NAMESPACE_BEGIN
 //==============================================================================
 FileOutputStream::FileOutputStream(const File& file)
 {
-	open(file.getPath(), false /*bAppend*/);
+	init();
+	open(file.getPath(), false /*bAppend*/, 0);
+}
+
+//==============================================================================
+// FileOutputStream::FileOutputStream
+//
+/**
+   Constructs a FileOutputStream by opening a connection to the file with
+   the abstract pathname denoted by @c file, using the given options.
+   If a file with the abstract pathname already exists then it is truncated
+   and its contents discarded.
+
+   If @c options includes DirectIO, the file is written bypassing the
+   system's file cache where the operating system and file system allow it.
+   On file systems that do not, the file is written normally.
+
+   @param file the abstract pathname of the file to open
+   @param options zero or more Option values combined using the bitwise
+          OR operator
+   @throws IOException if the specified file could not be opened.  This includes
+           the case where @c file refers to a directory instead of a normal file.
+*/
+//==============================================================================
+FileOutputStream::FileOutputStream(const File& file, int options)
+{
+	init();
+	open(file.getPath(), false /*bAppend*/, options);
 }
 
 //==============================================================================
@@ -81,7 +122,8 @@ FileOutputStream::FileOutputStream(const File& file)
 //==============================================================================
 FileOutputStream::FileOutputStream(const String& name)
 {
-	open(name, false /*bAppend*/);
+	init();
+	open(name, false /*bAppend*/, 0);
 }
 
 //==============================================================================
@@ -99,7 +141,34 @@ FileOutputStream::FileOutputStream(const String& name)
 //==============================================================================
 FileOutputStream::FileOutputStream(const String& name, bool bAppend)
 {
-	open(name, bAppend);
+	init();
+	open(name, bAppend, 0);
+}
+
+//==============================================================================
+// FileOutputStream::FileOutputStream
+//
+/**
+   Constructs a FileOutputStream by opening a connection to the named file
+   @c name, using the given options.
+
+   The DirectIO option is ignored when @c bAppend is @c true, because the
+   end of an existing file is not usually aligned as direct transfers require.
+
+   @param name the name of the file to open
+   @param bAppend @c true if the contents of an existing file should be kept; @c false
+          if the file should be truncated
+   @param options zero or more Option values combined using the bitwise
+          OR operator
+   @throws IOException if the specified file name could not be opened.  This includes
+           the case where @c name refers to a directory instead of a normal file.
+   @sa FileOutputStream(const File&, int)
+*/
+//==============================================================================
+FileOutputStream::FileOutputStream(const String& name, bool bAppend, int options)
+{
+	init();
+	open(name, bAppend, options);
 }
 
 //==============================================================================
@@ -117,6 +186,45 @@ FileOutputStream::FileOutputStream(FileDescriptor* pFD) :
 	m_rpFD(pFD)
 {
 	if(!pFD) throw NullPointerException();
+	init();
+}
+
+//==============================================================================
+// FileOutputStream::~FileOutputStream
+//
+/**
+   Writes out any data held in the DirectIO buffer before destroying this
+   FileOutputStream.
+*/
+//==============================================================================
+FileOutputStream::~FileOutputStream()
+{
+	if(m_rpFD && m_pDirectBuffer)
+	{
+		try
+		{
+			writeDirectBuffer();
+		}
+		catch(IOException& /*e*/)
+		{
+		}
+	}
+	delete m_pDirectBuffer;
+}
+
+//==============================================================================
+// FileOutputStream::init
+//
+// Private helper function called by each constructor.
+//==============================================================================
+void FileOutputStream::init()
+{
+	m_pDirectBuffer = 0;
+	m_directUsed = 0;
+	m_bDropBehind = false;
+	m_dropBehindPos = 0;
+	m_writeBackPos = 0;
+	m_dropBehindPending = 0;
 }
 
 //==============================================================================
@@ -137,8 +245,64 @@ void FileOutputStream::close()
 {
 	if(m_rpFD)
 	{
-		m_rpFD->close();
+		AutoPtr<FileDescriptor> rpFD = m_rpFD;
+		AlignedBuffer* pDirectBuffer = m_pDirectBuffer;
+		try
+		{
+			if(pDirectBuffer)
+			{
+				writeDirectBuffer();
+			}
+		}
+		catch(IOException& /*e*/)
+		{
+			m_rpFD.release();
+			m_pDirectBuffer = 0;
+			delete pDirectBuffer;
+			rpFD->close();
+			throw;
+		}
 		m_rpFD.release();
+		m_pDirectBuffer = 0;
+		delete pDirectBuffer;
+		rpFD->close();
+	}
+}
+
+//==============================================================================
+// FileOutputStream::flush
+//
+/**
+   Writes out any data held in the DirectIO buffer.  Other FileOutputStreams
+   do not buffer data, and for them this has no effect.
+
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void FileOutputStream::flush()
+{
+	flushBuffers();
+}
+
+//==============================================================================
+// FileOutputStream::flushBuffers
+//
+/**
+   Writes out any data held in the DirectIO buffer.
+
+   A direct transfer cannot write part of a block, so when the buffer ends
+   part way through a block the whole block is written, padded, and the
+   file is then truncated to its proper length.  The block is kept in the
+   buffer and written again when more data is added to it.
+
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void FileOutputStream::flushBuffers()
+{
+	if(m_rpFD && m_pDirectBuffer)
+	{
+		writeDirectBuffer();
 	}
 }
 
@@ -152,7 +316,46 @@ void FileOutputStream::write(const Byte* pBuffer, size_t bufLen)
 	{
 		if(bufLen > 0)
 		{
-			m_rpFD->getFileSystem()->writeFile(m_rpFD.get(), pBuffer, bufLen);
+			if(m_pDirectBuffer)
+			{
+				writeDirect(pBuffer, bufLen);
+			}
+			else
+			{
+				m_rpFD->getFileSystem()->writeFile(m_rpFD.get(), pBuffer, bufLen);
+			}
+
+			if(m_bDropBehind)
+			{
+				dropBehind(bufLen);
+			}
+		}
+	}
+	else
+	{
+		throw IOException(QC_T("stream closed"));
+	}
+}
+
+//==============================================================================
+// FileOutputStream::write
+//
+// Gather write of several blocks using FileSystem::writeFile(), which issues
+// a single writev() call where the platform supports it.
+//==============================================================================
+void FileOutputStream::write(const IoVec* pVecs, size_t count)
+{
+	if(!pVecs && count) throw NullPointerException();
+
+	if(m_rpFD)
+	{
+		if(m_pDirectBuffer || m_bDropBehind)
+		{
+			OutputStream::write(pVecs, count);
+		}
+		else
+		{
+			m_rpFD->getFileSystem()->writeFile(m_rpFD.get(), pVecs, count);
 		}
 	}
 	else
@@ -174,14 +377,236 @@ AutoPtr<FileDescriptor> FileOutputStream::getFD() const
 	return m_rpFD;
 }
 
+//==============================================================================
+// FileOutputStream::writeDirect
+//
+// Writes to a file opened with DirectIO.  Direct transfers must use aligned
+// buffers and lengths, so the data is gathered in the aligned buffer and
+// written when it is full.  A large request from a buffer that happens to be
+// aligned is written straight from it while the aligned buffer is empty.
+//==============================================================================
+void FileOutputStream::writeDirect(const Byte* pBuffer, size_t bufLen)
+{
+	const size_t alignment = FileSystem::DirectAlignment;
+	const size_t bufSize = m_pDirectBuffer->size();
+	AutoPtr<FileSystem> rpFS = m_rpFD->getFileSystem();
+
+	while(bufLen)
+	{
+		if(m_directUsed == 0 && bufLen >= bufSize && AlignedBuffer::IsAligned(pBuffer, alignment))
+		{
+			const size_t len = bufLen & ~(alignment-1);
+			rpFS->writeFile(m_rpFD.get(), pBuffer, len);
+			pBuffer += len;
+			bufLen -= len;
+			continue;
+		}
+
+		const size_t space = bufSize - m_directUsed;
+		const size_t len = (bufLen < space) ? bufLen : space;
+		::memcpy(m_pDirectBuffer->get() + m_directUsed, pBuffer, len);
+		m_directUsed += len;
+		pBuffer += len;
+		bufLen -= len;
+
+		if(m_directUsed == bufSize)
+		{
+			rpFS->writeFile(m_rpFD.get(), m_pDirectBuffer->get(), bufSize);
+			m_directUsed = 0;
+		}
+	}
+}
+
+//==============================================================================
+// FileOutputStream::writeDirectBuffer
+//
+// Writes out the contents of the DirectIO buffer.  Whole blocks are written
+// and discarded.  A final partial block is padded and written, the file is
+// truncated to the correct length and the file position is moved back to
+// the start of the block, which stays at the start of the buffer to be
+// completed by later writes.
+//==============================================================================
+void FileOutputStream::writeDirectBuffer()
+{
+	if(m_directUsed == 0)
+	{
+		return;
+	}
+
+	const size_t alignment = FileSystem::DirectAlignment;
+	const size_t whole = m_directUsed & ~(alignment-1);
+	const size_t partial = m_directUsed - whole;
+	Byte* pBuffer = m_pDirectBuffer->get();
+	AutoPtr<FileSystem> rpFS = m_rpFD->getFileSystem();
+
+	if(whole)
+	{
+		rpFS->writeFile(m_rpFD.get(), pBuffer, whole);
+		::memmove(pBuffer, pBuffer + whole, partial);
+		m_directUsed = partial;
+	}
+
+	if(partial)
+	{
+		const FileOffset pos = rpFS->getFilePosition(m_rpFD.get());
+		::memset(pBuffer + partial, 0, alignment - partial);
+
+		rpFS->writeFile(m_rpFD.get(), pBuffer, alignment);
+		rpFS->setFileLength(m_rpFD.get(), pos + partial);
+		rpFS->setFilePosition(m_rpFD.get(), pos);
+	}
+}
+
+//==============================================================================
+// FileOutputStream::advise
+//
+/**
+   Tells the operating system how the file will be used, so that it can
+   adjust how long it keeps the data in its cache.  For example, DontNeed
+   releases a range that has already been written to the storage device
+   and will not be read again.
+
+   This is a hint and has no effect on the data written to the file.
+
+   @param advice the expected pattern of access
+   @param offset the offset of the first byte the advice applies to
+   @param length the number of bytes the advice applies to, or zero for the
+          remainder of the file
+   @throws IOException if this FileOutputStream is closed.
+   @sa setDropBehind()
+*/
+//==============================================================================
+void FileOutputStream::advise(FileSystem::AccessAdvice advice, FileOffset offset, FileOffset length)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream closed"));
+
+	m_rpFD->getFileSystem()->adviseFile(m_rpFD.get(), offset, length, advice);
+}
+
+//==============================================================================
+// FileOutputStream::isDirectIO
+//
+/**
+   Tests if the file is being written with the DirectIO option.  When it is,
+   written data may be held in the stream's aligned buffer until flush() or
+   close() is called, so the FileDescriptor must not be written to directly.
+*/
+//==============================================================================
+bool FileOutputStream::isDirectIO() const
+{
+	return m_pDirectBuffer != 0;
+}
+
+//==============================================================================
+// FileOutputStream::isDropBehind
+
+//
+/**
+   Tests if the parts of the file that have been written are being released
+   from the system's file cache.
+   @sa setDropBehind()
+*/
+//==============================================================================
+bool FileOutputStream::isDropBehind() const
+{
+	return m_bDropBehind;
+}
+
+//==============================================================================
+// FileOutputStream::setDropBehind
+//
+/**
+   Enables or disables releasing the parts of the file that have been
+   written from the system's file cache.
+
+   Data written to a file is normally held in the cache until the operating
+   system chooses to write it to the storage device, and often remains there
+   afterwards.  When drop-behind is enabled, every few megabytes the stream
+   starts writing the latest data to the device using
+   FileSystem::syncFileRange(), waits for the data written before that, and
+   releases it from the cache using FileSystem::adviseFile() with
+   FileSystem::DontNeed.  This keeps a large file from displacing data that
+   is in use by other processes, at the cost of writing it as it is
+   produced.
+
+   Drop-behind has no effect on files, such as pipes, that do not support
+   positioning.
+
+   @param bDropBehind true to enable drop-behind; false to disable it
+   @throws IOException if this FileOutputStream is closed.
+*/
+//==============================================================================
+void FileOutputStream::setDropBehind(bool bDropBehind)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream closed"));
+
+	m_bDropBehind = false;
+	if(bDropBehind)
+	{
+		try
+		{
+			m_dropBehindPos = m_rpFD->getFileSystem()->getFilePosition(m_rpFD.get());
+			m_writeBackPos = m_dropBehindPos;
+			m_dropBehindPending = 0;
+			m_bDropBehind = true;
+		}
+		catch(IOException& /*e*/)
+		{
+			// the file does not support positioning
+		}
+	}
+}
+
+//==============================================================================
+// FileOutputStream::dropBehind
+//
+// Called after each write while drop-behind is enabled.  Once
+// DropBehindInterval bytes have been written, waits for the range whose
+// write-back was started last time and releases it from the cache, then
+// starts write-back of the data written since.  Waiting one interval behind
+// lets the device write the latest data while the application continues.
+//==============================================================================
+void FileOutputStream::dropBehind(size_t bytesWritten)
+{
+	m_dropBehindPending += bytesWritten;
+	if(m_dropBehindPending >= DropBehindInterval)
+	{
+		AutoPtr<FileSystem> rpFS = m_rpFD->getFileSystem();
+		const FileOffset pos = rpFS->getFilePosition(m_rpFD.get());
+
+		if(m_writeBackPos > m_dropBehindPos)
+		{
+			const FileOffset len = m_writeBackPos - m_dropBehindPos;
+
+			rpFS->syncFileRange(m_rpFD.get(), m_dropBehindPos, len, true);
+			rpFS->adviseFile(m_rpFD.get(), m_dropBehindPos, len, FileSystem::DontNeed);
+		}
+		m_dropBehindPos = m_writeBackPos;
+
+		if(pos > m_writeBackPos)
+		{
+			rpFS->syncFileRange(m_rpFD.get(), m_writeBackPos, pos - m_writeBackPos, false);
+			m_writeBackPos = pos;
+		}
+		m_dropBehindPending = 0;
+	}
+}
+
 //==============================================================================
 // FileOutputStream::open
 //
 // Open (and optionally create) the file associated with this OutputStream.
 //==============================================================================
-void FileOutputStream::open(const String& fileName, bool bAppend) 
+void FileOutputStream::open(const String& fileName, bool bAppend, int options) 
 {
+	const bool bDirect = (options & DirectIO) && !bAppend;
+
 	int accessFlags = FileSystem::WriteAccess;
+	if(bDirect)
+	{
+		accessFlags |= FileSystem::DirectAccess;
+	}
+
 	FileSystem::CreationDisp disp = bAppend ? FileSystem::OpenCreateAppend
 	                                        : FileSystem::OpenCreateTruncate;
 	
@@ -190,6 +615,11 @@ void FileOutputStream::open(const String& fileName, bool bAppend)
 		                                      accessFlags,
 		                                      disp,
 		                                      0);
+
+	if(bDirect)
+	{
+		m_pDirectBuffer = new AlignedBuffer(DirectBufferSize, FileSystem::DirectAlignment);
+	}
 }
 
 QC_IO_NAMESPACE_END
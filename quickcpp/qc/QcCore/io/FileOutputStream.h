@@ -36,20 +36,30 @@
 
 #include "OutputStream.h"
 #include "FileDescriptor.h"
+#include "FileSystem.h"
 
 QC_IO_NAMESPACE_BEGIN
 
+class AlignedBuffer;
 class File;
 
 class QC_IO_PKG FileOutputStream : public OutputStream
 {
 public:
+
+	enum Option {DirectIO = 0x01 /*!< write the file bypassing the system's file cache */};
+
 	FileOutputStream(const File& file);
+	FileOutputStream(const File& file, int options);
 	FileOutputStream(const String& name);
 	FileOutputStream(const String& name, bool bAppend);
+	FileOutputStream(const String& name, bool bAppend, int options);
 	FileOutputStream(FileDescriptor* pFD);
+	virtual ~FileOutputStream();
 
 	virtual void close();
+	virtual void flush();
+	virtual void flushBuffers();
 
 #ifdef QC_USING_DECL_BROKEN
 	virtual void write(Byte x) {OutputStream::write(x);}
@@ -58,17 +68,36 @@ public:
 #endif
 
 	virtual void write(const Byte* pBuffer, size_t bufLen);
+	virtual void write(const IoVec* pVecs, size_t count);
 	
+	void advise(FileSystem::AccessAdvice advice, FileOffset offset=0, FileOffset length=0);
+	bool isDirectIO() const;
+	bool isDropBehind() const;
+	void setDropBehind(bool bDropBehind);
+
+
 	AutoPtr<FileDescriptor> getFD() const;
 
 private:
 	FileOutputStream(const FileOutputStream& rhs);            // cannot be copied
 	FileOutputStream& operator=(const FileOutputStream& rhs); // nor assigned
 
-	void open(const String& fileName, bool bAppend);
+	void init();
+	void open(const String& fileName, bool bAppend, int options);
+	void writeDirect(const Byte* pBuffer, size_t bufLen);
+	void writeDirectBuffer();
+	void dropBehind(size_t bytesWritten);
 
 private:
 	AutoPtr<FileDescriptor> m_rpFD;
+	AlignedBuffer* m_pDirectBuffer;
+	size_t m_directUsed;
+	bool m_bDropBehind;
+	FileOffset m_dropBehindPos;
+
+	FileOffset m_writeBackPos;
+
+	size_t m_dropBehindPending;
 };
 
 QC_IO_NAMESPACE_END
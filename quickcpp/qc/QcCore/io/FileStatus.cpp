@@ -0,0 +1,208 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: FileStatus
+/**
+	@class qc::io::FileStatus
+
+	@brief A snapshot of the attributes, length and modification time of a
+	file.
+
+	A FileStatus is returned by File::status() and FileSystem::getFileStatus().
+	All of its values are gathered by a single request to the file system,
+	whereas each of File::exists(), File::isFile(), File::length(),
+	File::lastModified(), File::canRead() and File::canWrite() makes a
+	request of its own.  When several of these values are needed it is
+	therefore cheaper, and more consistent, to ask for a FileStatus once.
+
+	The values are not updated when the file changes.  A FileStatus for a
+	file that does not exist reports false from exists() and every other
+	test, a length of zero and a default DateTime.
+
+	FileStatus is a simple value-type class.  It is not reference-counted
+	and can be passed by value or by reference.
+
+	@sa FileStatusCache
+*/
+//==============================================================================
+
+#include "FileStatus.h"
+#include "FileSystem.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// FileStatus::FileStatus
+//
+/**
+   Constructs a FileStatus describing a file that does not exist.
+*/
+//==============================================================================
+FileStatus::FileStatus() :
+	m_attributes(0),
+	m_accessModes(0),
+	m_length(0)
+{
+}
+
+//==============================================================================
+// FileStatus::FileStatus
+//
+/**
+   Constructs a FileStatus from values obtained from the file system.
+
+   @param attributes zero or more FileSystem::Attribute flags combined using
+          the bitwise OR operator
+   @param accessModes zero or more FileSystem::AccessMode flags, combined
+          using the bitwise OR operator, that the current process is
+          permitted
+   @param length the length of the file in bytes
+   @param lastModified the time that the file was last modified
+*/
+//==============================================================================
+FileStatus::FileStatus(int attributes, int accessModes, size_t length,
+                       const DateTime& lastModified) :
+	m_attributes(attributes),
+	m_accessModes(accessModes),
+	m_length(length),
+	m_lastModified(lastModified)
+{
+}
+
+//==============================================================================
+// FileStatus::exists
+//
+/**
+   Tests if the file existed when the FileStatus was obtained.
+*/
+//==============================================================================
+bool FileStatus::exists() const
+{
+	return ((m_attributes & FileSystem::Exists)!=0);
+}
+
+//==============================================================================
+// FileStatus::isFile
+//
+/**
+   Tests if the file was a regular file.
+*/
+//==============================================================================
+bool FileStatus::isFile() const
+{
+	return ((m_attributes & FileSystem::RegularFile)!=0);
+}
+
+//==============================================================================
+// FileStatus::isDirectory
+//
+/**
+   Tests if the file was a directory.
+*/
+//==============================================================================
+bool FileStatus::isDirectory() const
+{
+	return ((m_attributes & FileSystem::Directory)!=0);
+}
+
+//==============================================================================
+// FileStatus::isHidden
+//
+/**
+   Tests if the file was hidden.  Only file systems that have a hidden
+   attribute, such as Windows, report hidden files.
+*/
+//==============================================================================
+bool FileStatus::isHidden() const
+{
+	return ((m_attributes & FileSystem::Hidden)!=0);
+}
+
+//==============================================================================
+// FileStatus::canRead
+//
+/**
+   Tests if the file existed and its permission flags allowed it to be read
+   by the current process.
+   @sa File::canRead()
+*/
+//==============================================================================
+bool FileStatus::canRead() const
+{
+	return ((m_accessModes & FileSystem::ReadAccess)!=0);
+}
+
+//==============================================================================
+// FileStatus::canWrite
+//
+/**
+   Tests if the file existed and its permission flags allowed it to be
+   written to by the current process.
+   @sa File::canWrite()
+*/
+//==============================================================================
+bool FileStatus::canWrite() const
+{
+	return ((m_accessModes & FileSystem::WriteAccess)!=0);
+}
+
+//==============================================================================
+// FileStatus::length
+//
+/**
+   Returns the length of the file in bytes, or zero if it did not exist.
+*/
+//==============================================================================
+size_t FileStatus::length() const
+{
+	return m_length;
+}
+
+//==============================================================================
+// FileStatus::lastModified
+//
+/**
+   Returns the time that the file was last modified.
+*/
+//==============================================================================
+DateTime FileStatus::lastModified() const
+{
+	return m_lastModified;
+}
+
+//==============================================================================
+// FileStatus::getAttributeFlags
+//
+/**
+   Returns the FileSystem::Attribute flags of the file, as would have been
+   returned by FileSystem::getFileAttributeFlags().
+*/
+//==============================================================================
+int FileStatus::getAttributeFlags() const
+{
+	return m_attributes;
+}
+
+QC_IO_NAMESPACE_END
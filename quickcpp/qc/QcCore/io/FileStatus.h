@@ -0,0 +1,70 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: FileStatus
+// 
+//==============================================================================
+
+#ifndef QC_IO_FileStatus_h
+#define QC_IO_FileStatus_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "QcCore/util/DateTime.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+using util::DateTime;
+
+class QC_IO_PKG FileStatus : public virtual QCObject
+{
+public:
+	FileStatus();
+	FileStatus(int attributes, int accessModes, size_t length,
+	           const DateTime& lastModified);
+
+	bool exists() const;
+	bool isFile() const;
+	bool isDirectory() const;
+	bool isHidden() const;
+	bool canRead() const;
+	bool canWrite() const;
+	size_t length() const;
+	DateTime lastModified() const;
+
+	int getAttributeFlags() const;
+
+private:
+	int m_attributes;
+	int m_accessModes;
+	size_t m_length;
+	DateTime m_lastModified;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_FileStatus_h
@@ -0,0 +1,286 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: FileStatusCache
+// 
+/**
+	@class qc::io::FileStatusCache
+	
+	@brief Class module that remembers the status of recently probed files
+	for a short time.
+
+	Some parts of an application test whether the same files exist again and
+	again: an XML catalog, for example, may be listed by every resolver that
+	is created.  GetStatus() returns the FileStatus of a file as File::status()
+	would, but remembers it so that further requests for the same file within
+	the next few moments are answered without probing the file system.
+
+	Files are identified by their canonical path, so different abstract
+	pathnames for the same file share one entry.  The status of a file that
+	does not exist is remembered as well, which is often the more valuable
+	case.
+
+	Because a remembered status may be out of date by up to the time to live
+	set by SetTimeToLive() (one second by default), the cache should only be
+	used where that is acceptable.  Code that changes a file and needs to
+	see the change at once should call Invalidate().  Setting the time to
+	live to zero disables the cache, after which GetStatus() always probes the
+	file system.
+
+	At most GetMaxEntries() files are remembered.  When the cache is full,
+	expired entries are discarded, and if none have expired the cache is
+	emptied.
+
+    @mt
+    All methods may be called from any thread.
+*/
+//==============================================================================
+
+#include "FileStatusCache.h"
+#include "File.h"
+
+#ifdef QC_MT
+	#include "QcCore/base/AutoLock.h"
+	#include "QcCore/base/FastMutex.h"
+#endif //QC_MT
+
+#include <map>
+
+QC_IO_NAMESPACE_BEGIN
+
+struct StatusCacheEntry
+{
+	FileStatus status;
+	double fetched; // DateTime::currentTimeMillis() when status was obtained
+};
+
+typedef std::map<String, StatusCacheEntry> StatusMap;
+
+static unsigned long QC_MT_VOLATILE TimeToLive = FileStatusCache::DefaultTimeToLive;
+static size_t QC_MT_VOLATILE MaxEntries = FileStatusCache::DefaultMaxEntries;
+
+//
+// The following is protected by FileStatusCacheMutex
+//
+static StatusMap CachedEntries;
+
+#ifdef QC_MT
+	static FastMutex FileStatusCacheMutex;
+#endif //QC_MT
+
+//==============================================================================
+// IsCurrent
+//
+// Tests if an entry obtained at fetched is still usable at now.  An entry
+// from the future means the system clock has been put back, and is treated
+// as expired.
+//==============================================================================
+static bool IsCurrent(const StatusCacheEntry& entry, double now, unsigned long ttl)
+{
+	return (now >= entry.fetched && now < entry.fetched + ttl);
+}
+
+//==============================================================================
+// PurgeExpired
+//
+// Removes the entries that are no longer current.  Must be called with
+// FileStatusCacheMutex locked.
+//==============================================================================
+static void PurgeExpired(double now, unsigned long ttl)
+{
+	StatusMap::iterator iter = CachedEntries.begin();
+	while(iter != CachedEntries.end())
+	{
+		if(IsCurrent((*iter).second, now, ttl))
+		{
+			++iter;
+		}
+		else
+		{
+			CachedEntries.erase(iter++);
+		}
+	}
+}
+
+//==============================================================================
+// FileStatusCache::GetStatus
+//
+/**
+   Returns the status of @c file, probing the file system only if the status
+   has not already been obtained within the time to live.
+
+   @param file the file whose status is required
+   @returns a FileStatus, which may be up to GetTimeToLive() milliseconds
+            old.
+   @throws IOException if an error occurs obtaining the canonical path of
+           @c file.
+   @sa File::status()
+*/
+//==============================================================================
+FileStatus FileStatusCache::GetStatus(const File& file)
+{
+	const unsigned long ttl = TimeToLive;
+	if(ttl == 0)
+	{
+		return file.status();
+	}
+
+	const String key = file.getCanonicalPath();
+	const double now = DateTime::currentTimeMillis();
+
+	{
+		QC_AUTO_LOCK(FastMutex, FileStatusCacheMutex);
+		StatusMap::const_iterator iter = CachedEntries.find(key);
+		if(iter != CachedEntries.end() && IsCurrent((*iter).second, now, ttl))
+		{
+			return (*iter).second.status;
+		}
+	}
+
+	//
+	// The file system is probed without holding the lock, so that other
+	// threads are not held up.  If two threads probe the same file at once
+	// both results are equally valid and the later one is kept.
+	//
+	const FileStatus status = file.status();
+
+	{
+		QC_AUTO_LOCK(FastMutex, FileStatusCacheMutex);
+		const size_t maxEntries = MaxEntries;
+		if(CachedEntries.size() >= maxEntries && CachedEntries.find(key) == CachedEntries.end())
+		{
+			PurgeExpired(now, ttl);
+			if(CachedEntries.size() >= maxEntries)
+			{
+				CachedEntries.clear();
+			}
+		}
+		if(maxEntries)
+		{
+			StatusCacheEntry& entry = CachedEntries[key];
+			entry.status = status;
+			entry.fetched = now;
+		}
+	}
+
+	return status;
+}
+
+//==============================================================================
+// FileStatusCache::Invalidate
+//
+/**
+   Discards the remembered status of @c file, so that the next call to
+   GetStatus() for the same file probes the file system.
+
+   @throws IOException if an error occurs obtaining the canonical path of
+           @c file.
+*/
+//==============================================================================
+void FileStatusCache::Invalidate(const File& file)
+{
+	const String key = file.getCanonicalPath();
+	QC_AUTO_LOCK(FastMutex, FileStatusCacheMutex);
+	CachedEntries.erase(key);
+}
+
+//==============================================================================
+// FileStatusCache::Clear
+//
+/**
+   Discards the remembered status of every file.
+*/
+//==============================================================================
+void FileStatusCache::Clear()
+{
+	QC_AUTO_LOCK(FastMutex, FileStatusCacheMutex);
+	CachedEntries.clear();
+}
+
+//==============================================================================
+// FileStatusCache::GetTimeToLive
+//
+/**
+   Returns the number of milliseconds for which a status is remembered.
+   @sa SetTimeToLive()
+*/
+//==============================================================================
+unsigned long FileStatusCache::GetTimeToLive()
+{
+	return TimeToLive;
+}
+
+//==============================================================================
+// FileStatusCache::SetTimeToLive
+//
+/**
+   Sets the number of milliseconds for which a status is remembered.
+   Statuses already remembered are discarded.
+
+   @param millis the time to live in milliseconds, or zero to disable the
+          cache
+   @sa GetTimeToLive()
+*/
+//==============================================================================
+void FileStatusCache::SetTimeToLive(unsigned long millis)
+{
+	QC_AUTO_LOCK(FastMutex, FileStatusCacheMutex);
+	TimeToLive = millis;
+	CachedEntries.clear();
+}
+
+//==============================================================================
+// FileStatusCache::GetMaxEntries
+//
+/**
+   Returns the maximum number of files whose status is remembered.
+   @sa SetMaxEntries()
+*/
+//==============================================================================
+size_t FileStatusCache::GetMaxEntries()
+{
+	return MaxEntries;
+}
+
+//==============================================================================
+// FileStatusCache::SetMaxEntries
+//
+/**
+   Sets the maximum number of files whose status is remembered.  If more
+   than @c maxEntries statuses are already remembered they are discarded.
+   @sa GetMaxEntries()
+*/
+//==============================================================================
+void FileStatusCache::SetMaxEntries(size_t maxEntries)
+{
+	QC_AUTO_LOCK(FastMutex, FileStatusCacheMutex);
+	MaxEntries = maxEntries;
+	if(CachedEntries.size() > maxEntries)
+	{
+		CachedEntries.clear();
+	}
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,72 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: FileStatusCache
+// 
+// Overview
+// --------
+// The FileStatusCache class is a class module that remembers the status of
+// recently probed files for a short time.  It cannot be instantiated - all
+// methods are static.
+//
+//==============================================================================
+
+#ifndef QC_IO_FileStatusCache_h
+#define QC_IO_FileStatusCache_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "FileStatus.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class File;
+
+class QC_IO_PKG FileStatusCache
+{
+public:
+
+	enum {DefaultTimeToLive = 1000, /*!< milliseconds that a status is remembered by default */
+	      DefaultMaxEntries = 1024  /*!< default limit on the number of files remembered */};
+
+	static FileStatus GetStatus(const File& file);
+	static void Invalidate(const File& file);
+	static void Clear();
+
+	static unsigned long GetTimeToLive();
+	static void SetTimeToLive(unsigned long millis);
+
+	static size_t GetMaxEntries();
+	static void SetMaxEntries(size_t maxEntries);
+
+private:
+	FileStatusCache(); // not implemented
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_FileStatusCache_h
@@ -58,7 +58,11 @@
 
 #include "FileSystem.h"
 #include "File.h"
+#include "DirectoryIterator.h"
 #include "FileDescriptor.h"
+#include "FileNotFoundException.h"
+#include "IOException.h"
+#include "MappedByteBuffer.h"
 
 #if defined(WIN32)
 #	include "Win32FileSystem.h"
@@ -320,6 +324,442 @@ String FileSystem::resolve(const String& path) const
 	return resolve(getCurrentDirectory(), path);
 }
 
+//==============================================================================
+// FileSystem::getFileLength
+//
+/**
+   Returns the length of the open file denoted by @c pFD.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if the length of the file cannot be determined.
+*/
+//==============================================================================
+FileOffset FileSystem::getFileLength(FileDescriptor* /*pFD*/) const
+{
+	throw IOException(QC_T("file length is not available"));
+}
+
+//==============================================================================
+// FileSystem::getFilePosition
+//
+/**
+   Returns the current position of the open file denoted by @c pFD, expressed
+   as the number of bytes from the beginning of the file.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if the file does not support positioning, for example
+           because it is a pipe or a console device.
+   @sa setFilePosition()
+*/
+//==============================================================================
+FileOffset FileSystem::getFilePosition(FileDescriptor* /*pFD*/) const
+{
+	throw IOException(QC_T("file positioning is not supported"));
+}
+
+//==============================================================================
+// FileSystem::setFilePosition
+//
+/**
+   Sets the position of the open file denoted by @c pFD to @c pos bytes
+   from the beginning of the file.  The next readFile() or writeFile()
+   operation takes place at the new position.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if the file does not support positioning.
+   @sa getFilePosition()
+*/
+//==============================================================================
+void FileSystem::setFilePosition(FileDescriptor* /*pFD*/, FileOffset /*pos*/) const
+
+{
+	throw IOException(QC_T("file positioning is not supported"));
+}
+
+//==============================================================================
+// FileSystem::writeFile
+//
+/**
+   Writes @c count blocks of bytes, described by the array of IoVec structures
+   starting at @c pVecs, to an open file as though they were one contiguous
+   block.
+
+   The base class implementation writes each block in turn.  Derived classes
+   may override this to write all the blocks with a single system call.
+
+   @param pFD the open file
+   @param pVecs pointer to the first element of an array of IoVec structures
+   @param count number of elements in the array
+   @throws NullPointerException if @c pFD is null, or @c pVecs is null
+           and @c count is not zero.
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void FileSystem::writeFile(FileDescriptor* pFD, const IoVec* pVecs, size_t count) const
+{
+	if(!pFD) throw NullPointerException();
+	if(!pVecs && count) throw NullPointerException();
+
+	for(size_t i=0; i<count; ++i)
+	{
+		if(pVecs[i].length)
+		{
+			writeFile(pFD, pVecs[i].pData, pVecs[i].length);
+		}
+	}
+}
+
+//==============================================================================
+// FileSystem::mapFile
+//
+/**
+   Maps @c length bytes of the open file denoted by @c pFD, starting at
+   @c offset, into the address space of the process for reading.
+
+   The offset does not need to be aligned to a page boundary; the FileSystem
+   takes care of any alignment required by the operating system.  The file
+   must have been opened with read access and must not be truncated while the
+   returned MappedByteBuffer exists.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @param pFD the open file
+   @param offset the offset within the file of the first byte to map
+   @param length the number of bytes to map.  This must not be zero and
+          @c offset + @c length must not exceed the length of the file.
+   @throws NullPointerException if @c pFD is null.
+   @throws IllegalArgumentException if @c length is zero.
+   @throws IOException if the file cannot be mapped.
+   @sa MappedFileInputStream
+*/
+//==============================================================================
+AutoPtr<MappedByteBuffer> FileSystem::mapFile(FileDescriptor* /*pFD*/,
+                                              FileOffset /*offset*/,
+                                              size_t /*length*/) const
+
+{
+	throw IOException(QC_T("memory-mapped files are not supported"));
+}
+
+//==============================================================================
+// Class: ListDirectoryIterator
+//
+// A DirectoryIterator over the names returned by FileSystem::listDirectory(),
+// used by FileSystems that do not provide one of their own.  The type and
+// status of each entry are fetched by path name when they are requested.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ListDirectoryIterator : public DirectoryIterator
+{
+public:
+	ListDirectoryIterator(const String& path, const std::list<String>& names) :
+		DirectoryIterator(path),
+		m_names(names),
+		m_iter(m_names.begin()) {}
+
+	virtual bool next()
+	{
+		if(m_iter == m_names.end())
+		{
+			return false;
+		}
+		setEntry(*m_iter++, Unknown);
+		return true;
+	}
+
+	virtual void close()
+	{
+		m_names.clear();
+		m_iter = m_names.end();
+	}
+
+private:
+	std::list<String> m_names;
+	std::list<String>::const_iterator m_iter;
+};
+
+//==============================================================================
+// FileSystem::getFileStatus
+//
+/**
+   Returns a FileStatus describing the file denoted by @c path.
+
+   The default implementation combines the results of getFileAttributeFlags(),
+   checkAccess(), getLength() and getLastModifiedTime().  The FileSystems
+   supplied with the library override it to obtain all of the values with
+   a single request to the operating system.
+
+   This method does not throw exceptions.  If the file does not exist, or
+   is removed while its status is being obtained, a FileStatus is returned
+   for which FileStatus::exists() is false.
+
+   @param path the path name of the file
+   @sa File::status()
+*/
+//==============================================================================
+FileStatus FileSystem::getFileStatus(const String& path) const
+{
+	const int attributes = getFileAttributeFlags(path);
+	if(!(attributes & Exists))
+	{
+		return FileStatus();
+	}
+
+	try
+	{
+		int accessModes = 0;
+		if(checkAccess(path, ReadAccess))  accessModes |= ReadAccess;
+		if(checkAccess(path, WriteAccess)) accessModes |= WriteAccess;
+		return FileStatus(attributes, accessModes, getLength(path),
+		                  getLastModifiedTime(path));
+	}
+	catch(IOException& /*e*/)
+	{
+		return FileStatus();
+	}
+}
+
+//==============================================================================
+// FileSystem::openDirectory
+//
+/**
+   Opens the directory denoted by @c path so that its entries can be read
+   one at a time.
+
+   The default implementation reads all of the names at once using
+   listDirectory().  The FileSystems supplied with the library override it
+   to read the directory incrementally.
+
+   @param path the path name of the directory
+   @param flags zero or more DirectoryIterator::Flags values combined
+          using the bitwise OR operator
+   @returns a DirectoryIterator positioned before the first entry.
+   @throws FileNotFoundException if the directory does not exist.
+   @throws IOException if the directory cannot be opened.
+   @sa DirectoryWalker
+*/
+//==============================================================================
+AutoPtr<DirectoryIterator> FileSystem::openDirectory(const String& path, int /*flags*/) const
+{
+	if(!(getFileAttributeFlags(path) & Directory))
+	{
+		throw FileNotFoundException(path);
+	}
+	return new ListDirectoryIterator(path, listDirectory(path));
+}
+
+//==============================================================================
+// FileSystem::readFileAt
+//
+/**
+   Reads up to @c bufLen bytes from an open file into the supplied buffer,
+   starting @c pos bytes from the beginning of the file.
+
+   Unlike readFile(), this method neither uses nor changes the current
+   position of the file.  This allows several threads to read from
+   different parts of the same open file at once.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @param pFD the open file
+   @param pos the offset within the file of the first byte to read
+   @param pBuffer A pointer to the buffer into which the bytes will be copied.
+          This must be capable of holding at least @c bufLen bytes.
+   @param bufLen The maximum number of bytes to read into the passed buffer.
+   @returns The number of bytes read or zero if @c pos is at or beyond the
+            end of the file.
+   @throws NullPointerException if @c pFD or @c pBuffer is null.
+   @throws IOException if the file does not support positional reads or an
+           I/O error occurs.
+   @sa writeFileAt()
+*/
+//==============================================================================
+size_t FileSystem::readFileAt(FileDescriptor* /*pFD*/, FileOffset /*pos*/,
+                              Byte* /*pBuffer*/, size_t /*bufLen*/) const
+{
+	throw IOException(QC_T("positional i/o is not supported"));
+}
+
+//==============================================================================
+// FileSystem::writeFileAt
+//
+/**
+   Writes an array of bytes to an open file, starting @c pos bytes from the
+   beginning of the file.  The file is extended if necessary.
+
+   Unlike writeFile(), this method neither uses nor changes the current
+   position of the file, so several threads may write to different parts of
+   the same open file at once.  The result of writing to a file that was
+   opened for appending is platform-dependent.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @param pFD the open file
+   @param pos the offset within the file of the first byte to write
+   @param pBuffer pointer to the start of an array of bytes to be written
+   @param bufLen length of the byte array
+   @throws NullPointerException if @c pFD or @c pBuffer is null.
+   @throws IOException if the file does not support positional writes or an
+           I/O error occurs.
+   @sa readFileAt()
+*/
+//==============================================================================
+void FileSystem::writeFileAt(FileDescriptor* /*pFD*/, FileOffset /*pos*/,
+                             const Byte* /*pBuffer*/, size_t /*bufLen*/) const
+{
+	throw IOException(QC_T("positional i/o is not supported"));
+}
+
+//==============================================================================
+// FileSystem::setFileLength
+//
+/**
+   Truncates or extends the open file denoted by @c pFD so that it is exactly
+   @c length bytes long.  When the file is extended, the contents of the
+   extended portion are undefined.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if the length of the file cannot be changed.
+*/
+//==============================================================================
+void FileSystem::setFileLength(FileDescriptor* /*pFD*/, FileOffset /*length*/) const
+{
+	throw IOException(QC_T("file length cannot be changed"));
+}
+
+//==============================================================================
+// FileSystem::allocateFile
+//
+/**
+   Reserves disk space for @c length bytes of the open file denoted by
+   @c pFD, starting at @c offset.  If the file is shorter than
+   @c offset + @c length it is extended.
+
+   Allocating space for a file before it is written with writeFileAt()
+   ensures that writes will not fail for lack of space and allows the file
+   system to lay the file out contiguously.
+
+   The base class implementation extends the file with setFileLength(), which
+   does not necessarily reserve any disk space.  Derived classes may override
+   this to allocate the space using a facility of the operating system.
+
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if the space cannot be allocated.
+*/
+//==============================================================================
+void FileSystem::allocateFile(FileDescriptor* pFD, FileOffset offset, FileOffset length) const
+
+{
+	if(!pFD) throw NullPointerException();
+
+	if(getFileLength(pFD) < offset + length)
+	{
+		setFileLength(pFD, offset + length);
+	}
+}
+
+//==============================================================================
+// FileSystem::syncFile
+//
+/**
+   Forces any data written to the open file denoted by @c pFD to be written
+   to the storage device.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @param pFD the open file
+   @param bMetadata if @c true, file attributes such as the modification
+          time are also written.  If @c false only the file data, and any
+          attributes required to read it back, are written, which may be
+          considerably cheaper.
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void FileSystem::syncFile(FileDescriptor* /*pFD*/, bool /*bMetadata*/) const
+{
+	throw IOException(QC_T("file synchronization is not supported"));
+}
+
+//==============================================================================
+// FileSystem::syncFileRange
+//
+/**
+   Starts writing the data held in the system's cache for @c length bytes
+   of the open file denoted by @c pFD, starting at @c offset, to the storage
+   device.
+
+   Unlike syncFile(), this does not make the data durable: file attributes
+   are not written and the storage device's own cache is not flushed.  It
+   is intended for applications that write large files and wish to limit
+   the amount of unwritten data held by the cache, so that the pages can be
+   released by adviseFile() with DontNeed once they have been written.
+
+   This is a hint.  The base class implementation does nothing.
+
+   @param pFD the open file
+   @param offset the offset of the first byte of the range
+   @param length the number of bytes in the range, or zero for the remainder
+          of the file
+   @param bWait if @c true, waits until the data in the range has been
+          written; otherwise returns as soon as writing has started
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if an I/O error occurs.
+   @sa adviseFile()
+*/
+//==============================================================================
+void FileSystem::syncFileRange(FileDescriptor* pFD, FileOffset /*offset*/,
+                               FileOffset /*length*/, bool /*bWait*/) const
+{
+	if(!pFD) throw NullPointerException();
+}
+
+//==============================================================================
+// FileSystem::adviseFile
+//
+/**
+   Tells the operating system how the application intends to use @c length
+   bytes of the open file denoted by @c pFD, starting at @c offset, so that
+   it can adjust the amount of data it reads ahead and how long it keeps the
+   data in its cache.
+
+   This is a hint, which does not change the results of reading or writing
+   the file, and failures are ignored.  The base class implementation does
+   nothing.
+
+   @param pFD the open file
+   @param offset the offset of the first byte of the range
+   @param length the number of bytes in the range, or zero for the remainder
+          of the file
+   @param advice the expected pattern of access to the range
+   @throws NullPointerException if @c pFD is null.
+   @sa syncFileRange()
+*/
+//==============================================================================
+void FileSystem::adviseFile(FileDescriptor* pFD, FileOffset /*offset*/,
+                            FileOffset /*length*/, AccessAdvice /*advice*/) const
+
+{
+	if(!pFD) throw NullPointerException();
+}
+
 #ifdef QC_DOCUMENTATION_ONLY
 //=============================================================================
 //
@@ -426,6 +866,12 @@ size_t FileSystem::getLength(const String& path) const;
 //
 /**
    Opens a file and returns a FileDescriptor representing the open file.
+
+   If @c accessMode includes DirectAccess, the file is opened so that reads
+   and writes bypass the system's file cache, where the operating system
+   and file system allow it.  The buffers, file positions and lengths of
+   such transfers must then be multiples of DirectAlignment.  If the file
+   cannot be opened for direct access it is opened normally.
    @throws IOException if an error occurs opening the file
 */
 //==============================================================================
@@ -30,7 +30,11 @@
 #include "defs.h"
 #endif //QC_IO_DEFS_h
 
+#include "DirectoryIterator.h"
 #include "FileDescriptor.h"
+#include "FileStatus.h"
+#include "IoVec.h"
+#include "MappedByteBuffer.h"
 #include <list>
 
 QC_IO_NAMESPACE_BEGIN
@@ -63,18 +67,30 @@ public:
 
 	virtual int getFileAttributeFlags(const String& path) const=0;
 
-	enum AccessMode {ReadAccess  = 0x01 /*!< Request read access */,
-	                 WriteAccess = 0x02 /*!< Request write access */};
+	enum AccessMode {ReadAccess   = 0x01 /*!< Request read access */,
+	                 WriteAccess  = 0x02 /*!< Request write access */,
+	                 DirectAccess = 0x04 /*!< Bypass the system's file cache, see openFile() */};
+
+	enum {DirectAlignment = 0x1000 /*!< alignment required for DirectAccess transfers */};
+
+	enum AccessAdvice {NormalAccess     /*!< no particular access pattern */,
+	                   SequentialAccess /*!< data will be read from start to finish */,
+	                   RandomAccess     /*!< data will be read in no particular order */,
+	                   NoReuse          /*!< data will be read only once */,
+	                   WillNeed         /*!< data will be read soon and should be read ahead */,
+	                   DontNeed         /*!< data will not be read again and need not be cached */};
 
 	virtual bool checkAccess(const String& path, AccessMode mode) const=0;
 
 	virtual DateTime getLastModifiedTime(const String& path) const=0;
 	virtual size_t getLength(const String& path) const=0;
+	virtual FileStatus getFileStatus(const String& path) const;
 
 	enum CreationDisp {OpenExisting         /*!< open existing file only */,
 	                   OpenCreateAppend     /*!< open existing or create new, preserve existing contents */,
 	                   OpenCreateExclusive  /*!< create non-existing file only */,
-	                   OpenCreateTruncate   /*!< open existing or create new, destroy existing contents */ };
+	                   OpenCreateTruncate   /*!< open existing or create new, destroy existing contents */,
+	                   OpenCreate           /*!< open existing or create new, preserve existing contents and write from the start */ };
 
 	virtual AutoPtr<FileDescriptor> openFile(const String& path,
 	                                        int accessMode,
@@ -84,6 +100,7 @@ public:
 	virtual void closeFile(FileDescriptor* pFD) const=0;
     virtual void deleteFile(const String& path) const=0;
 	virtual std::list<String> listDirectory(const String& path) const=0;
+	virtual AutoPtr<DirectoryIterator> openDirectory(const String& path, int flags) const;
 	virtual void createDirectory(const String& path) const=0;
 	virtual void rename(const String& path1, const String& path2) const =0;
 	virtual void setLastModifiedTime(const String& path, const DateTime& time) const =0;
@@ -96,6 +113,23 @@ public:
 	virtual AutoPtr<FileDescriptor> getConsoleFD(ConsoleStream stream) const =0;
 	virtual size_t readFile(FileDescriptor* pFD, Byte* pBuffer, size_t bufLen) const =0;
 	virtual void writeFile(FileDescriptor* pFD, const Byte* pBuffer, size_t bufLen) const =0;
+	virtual void writeFile(FileDescriptor* pFD, const IoVec* pVecs, size_t count) const;
+	virtual FileOffset getFileLength(FileDescriptor* pFD) const;
+	virtual FileOffset getFilePosition(FileDescriptor* pFD) const;
+	virtual void setFilePosition(FileDescriptor* pFD, FileOffset pos) const;
+
+	virtual size_t readFileAt(FileDescriptor* pFD, FileOffset pos, Byte* pBuffer, size_t bufLen) const;
+	virtual void writeFileAt(FileDescriptor* pFD, FileOffset pos, const Byte* pBuffer, size_t bufLen) const;
+	virtual void setFileLength(FileDescriptor* pFD, FileOffset length) const;
+
+	virtual void allocateFile(FileDescriptor* pFD, FileOffset offset, FileOffset length) const;
+
+	virtual void syncFile(FileDescriptor* pFD, bool bMetadata) const;
+	virtual void syncFileRange(FileDescriptor* pFD, FileOffset offset, FileOffset length, bool bWait) const;
+	virtual void adviseFile(FileDescriptor* pFD, FileOffset offset, FileOffset length, AccessAdvice advice) const;
+
+	virtual AutoPtr<MappedByteBuffer> mapFile(FileDescriptor* pFD, FileOffset offset, size_t length) const;
+
 
 private:
 	static FileSystem* QC_MT_VOLATILE s_pFileSystem;
@@ -47,6 +47,13 @@ public:
 	virtual void close();
 	virtual void flush();
 	virtual void flushBuffers();
+
+#ifdef QC_USING_DECL_BROKEN
+	virtual void write(const IoVec* pVecs, size_t count) {OutputStream::write(pVecs, count);}
+#else
+	using OutputStream::write; 	// unhide inherited write method
+#endif
+
 	virtual void write(Byte x);
 	virtual void write(const Byte* pBuffer, size_t bufLen);
 
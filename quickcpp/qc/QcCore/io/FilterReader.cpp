@@ -71,6 +71,7 @@ FilterReader::FilterReader(Reader* pReader) :
 {
 	if(!pReader) throw NullPointerException();
 	m_rpLock = pReader->getLock();
+	m_bSynchronized = pReader->isSynchronized();
 }
 
 //==============================================================================
@@ -82,6 +83,20 @@ void FilterReader::close()
 	m_rpReader->close();
 }
 
+//==============================================================================
+// FilterReader::setSynchronized
+//
+// Also sets the mode of the contained Reader, which shares our lock.
+//==============================================================================
+void FilterReader::setSynchronized(bool bSynchronized)
+{
+	Reader::setSynchronized(bSynchronized);
+	if(m_rpReader)
+	{
+		m_rpReader->setSynchronized(bSynchronized);
+	}
+}
+
 //==============================================================================
 // FilterReader::mark
 //
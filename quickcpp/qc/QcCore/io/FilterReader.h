@@ -53,6 +53,7 @@ public:
 	FilterReader(Reader* pReader);
 
 	virtual void close();
+	virtual void setSynchronized(bool bSynchronized);
 	virtual void mark(size_t readLimit);
 	virtual bool markSupported() const;
 	virtual IntType read();
@@ -65,6 +65,7 @@ FilterWriter::FilterWriter(Writer* pWriter) :
 {
 	if(!pWriter) throw NullPointerException();
 	m_rpLock = pWriter->getLock();
+	m_bSynchronized = pWriter->isSynchronized();
 }
 	
 void FilterWriter::close()
@@ -72,6 +73,20 @@ void FilterWriter::close()
 	m_rpWriter->close();
 }
 
+//==============================================================================
+// FilterWriter::setSynchronized
+//
+// Also sets the mode of the contained Writer, which shares our lock.
+//==============================================================================
+void FilterWriter::setSynchronized(bool bSynchronized)
+{
+	Writer::setSynchronized(bSynchronized);
+	if(m_rpWriter)
+	{
+		m_rpWriter->setSynchronized(bSynchronized);
+	}
+}
+
 void FilterWriter::flush()
 {
 	m_rpWriter->flush();
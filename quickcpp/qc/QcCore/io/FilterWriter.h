@@ -44,6 +44,7 @@ public:
 	FilterWriter(Writer* pWriter);
 	
 	virtual void close();
+	virtual void setSynchronized(bool bSynchronized);
 	virtual void flush();
 	virtual void flushBuffers();
 	virtual void write(const CharType* pStr, size_t len);
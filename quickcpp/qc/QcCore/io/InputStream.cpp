@@ -68,10 +68,17 @@
 //==============================================================================
 
 #include "InputStream.h"
+#include "OutputStream.h"
 #include "IOException.h"
 
+#include "QcCore/base/BufferPool.h"
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/NullPointerException.h"
+
 QC_IO_NAMESPACE_BEGIN
 
+const size_t TransferBufferSize = 0x10000;
+
 //==============================================================================
 // InputStream::mark
 //
@@ -174,6 +181,44 @@ size_t InputStream::skip(size_t n)
 	return count;
 }
 
+//==============================================================================
+// InputStream::transferTo
+//
+/**
+   Reads all the remaining bytes from this InputStream and writes them to
+   the OutputStream @c pOut.
+
+   The base class implementation copies the bytes through a 64KB buffer.
+   Derived classes that know more about their data source may override this
+   to avoid the copy; FileInputStream, for example, lets the OutputStream
+   take the bytes straight from the file, which allows a socket to send them
+   with a single system call.
+
+   Neither stream is closed by this method.
+
+   @param pOut the OutputStream to write to
+   @returns the number of bytes transferred.
+   @throws NullPointerException if @c pOut is null.
+   @throws IOException if an error occurs reading from this InputStream
+           or writing to @c pOut.
+   @sa OutputStream::transferFrom()
+*/
+//==============================================================================
+size_t InputStream::transferTo(OutputStream* pOut)
+{
+	if(!pOut) throw NullPointerException();
+
+	PooledArray<Byte> buffer(TransferBufferSize);
+	size_t count = 0;
+	long bytesRead;
+	while( (bytesRead = read(buffer.get(), TransferBufferSize)) != EndOfFile)
+	{
+		pOut->write(buffer.get(), bytesRead);
+		count += bytesRead;
+	}
+	return count;
+}
+
 //==============================================================================
 // InputStream::read
 //
@@ -223,6 +268,138 @@ size_t InputStream::available()
 	return 0;
 }
 
+//==============================================================================
+// InputStream::readUntil
+//
+/**
+   Reads bytes up to and including the first occurrence of the byte @c delim
+   and appends them to @c out.
+
+   Reading also stops when @c maxLen bytes have been read or the end of the
+   byte stream is reached, so the caller can tell whether a delimiter was
+   found by testing the last byte appended to @c out.
+
+   The base class implementation calls read() once for each byte.
+   BufferedInputStream overrides this to search its buffer for the
+   delimiter, which is much faster for line-oriented protocols.
+
+   @param delim the delimiter byte
+   @param out the ByteString to which the bytes are appended
+   @param maxLen the maximum number of bytes to read
+   @returns the number of bytes read, including the delimiter, or
+            InputStream::EndOfFile if the end of the byte stream has been
+            reached before any bytes were read.
+   @throws IllegalArgumentException if @c maxLen is zero.
+   @throws IOException if an error occurs while reading from the byte stream
+   @sa skipUntil()
+*/
+//==============================================================================
+long InputStream::readUntil(Byte delim, ByteString& out, size_t maxLen)
+{
+	if(!maxLen) throw IllegalArgumentException(QC_T("zero buffer length"));
+
+	size_t count = 0;
+	int x;
+	while(count < maxLen && (x = read()) != EndOfFile)
+	{
+		out += char(x);
+		++count;
+		if(x == delim)
+			break;
+	}
+	return count ? (long)count : (long)EndOfFile;
+}
+
+//==============================================================================
+// InputStream::skipUntil
+//
+/**
+   Reads and discards bytes up to and including the first occurrence of the
+   byte @c delim.
+
+   Skipping also stops when @c maxLen bytes have been skipped or the end of
+   the byte stream is reached.
+
+   The base class implementation calls read() once for each byte.
+
+   @param delim the delimiter byte
+   @param maxLen the maximum number of bytes to skip
+   @returns the number of bytes skipped, including the delimiter, or
+            InputStream::EndOfFile if the end of the byte stream has been
+            reached before any bytes were skipped.
+   @throws IllegalArgumentException if @c maxLen is zero.
+   @throws IOException if an error occurs while reading from the byte stream
+   @sa readUntil()
+*/
+//==============================================================================
+long InputStream::skipUntil(Byte delim, size_t maxLen)
+{
+	if(!maxLen) throw IllegalArgumentException(QC_T("zero buffer length"));
+
+	size_t count = 0;
+	int x;
+	while(count < maxLen && (x = read()) != EndOfFile)
+	{
+		++count;
+		if(x == delim)
+			break;
+	}
+	return count ? (long)count : (long)EndOfFile;
+}
+
+//==============================================================================
+// InputStream::readView
+//
+/**
+   Consumes up to @c maxLen bytes and returns a pointer to them in
+   @c pData without copying them.
+
+   The returned bytes belong to the InputStream.  They remain valid until
+   the next operation on the InputStream (including read(), readView(),
+   skip(), reset() and close()) and must not be modified.
+
+   Only InputStreams that hold their data in memory, such as
+   ByteArrayInputStream and MappedFileInputStream, support this operation.
+   Consumers that can work directly on a (pointer, length) pair should test
+   viewSupported() and use this method in preference to read() to avoid a
+   copy.
+
+   The base class contains an implementation that always throws an
+   IOException.
+
+   @param pData set to the first byte returned
+   @param maxLen the maximum number of bytes to return.  If this exceeds the
+          maximum value that can be represented by a long integer, it is
+          reduced to a value that can be so represented.
+   @returns the number of bytes returned or InputStream::EndOfFile.
+   @throws IllegalArgumentException if @c maxLen is zero.
+   @throws IOException if the InputStream does not support views.
+   @throws IOException if the InputStream is closed.
+   @sa viewSupported()
+*/
+//==============================================================================
+long InputStream::readView(const Byte*& /*pData*/, size_t /*maxLen*/)
+{
+	throw IOException(QC_T("view operation is not supported"));
+}
+
+//==============================================================================
+// InputStream::viewSupported
+//
+/**
+   Tests whether the InputStream supports the readView() operation.
+
+   The base class contains an implementation that always returns false.
+
+   @returns true if the InputStream supports readView(); false otherwise
+   @sa readView()
+*/
+//==============================================================================
+bool InputStream::viewSupported() const
+{
+	return false;
+}
+
 //=============================================================================
 // InputStream::close
 //
@@ -32,6 +32,8 @@
 
 QC_IO_NAMESPACE_BEGIN
 
+class OutputStream;
+
 class QC_IO_PKG InputStream : public virtual QCObject
 {
 public:
@@ -47,8 +49,13 @@ public:
 	virtual bool markSupported() const;
 	virtual int read();
 	virtual long read(Byte* pBuffer, size_t bufLen)=0;
+	virtual long readUntil(Byte delim, ByteString& out, size_t maxLen=size_t(-1));
+	virtual long readView(const Byte*& pData, size_t maxLen);
 	virtual void reset();
 	virtual size_t skip(size_t n);
+	virtual long skipUntil(Byte delim, size_t maxLen=size_t(-1));
+	virtual size_t transferTo(OutputStream* pOut);
+	virtual bool viewSupported() const;
 };
 
 QC_IO_NAMESPACE_END
@@ -47,6 +47,9 @@
 	into which it reads bytes from the underlying input stream.  Therefore
 	more bytes may be read ahead from the underlying stream than are necessary
 	to satisfy the current read operation. 
+	When the InputStream supports InputStream::readView() (for example a
+	MappedFileInputStream or a ByteArrayInputStream), bytes are decoded
+	directly from the stream's own storage instead.
 	
     The following example demonstrates a simple transcoding function.  It
 	decodes a UTF-8 encoded file into a stream of Unicode characters and 
@@ -88,6 +91,7 @@
 #include "MalformedInputException.h"
 #include "UnsupportedEncodingException.h"
 
+#include "QcCore/base/BufferPool.h"
 #include "QcCore/base/SystemUtils.h"
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/base/IllegalCharacterException.h"
@@ -101,6 +105,7 @@ using namespace cvt;
 
 const size_t ByteBufferSize = 2000 * sizeof(CharType);
 const size_t OverflowBufferSize = 3 * sizeof(CharType);
+const size_t MaxViewSize = 0x100000;
 
 //==============================================================================
 // InputStreamReader::InputStreamReader
@@ -125,7 +130,8 @@ InputStreamReader::InputStreamReader(InputStream* pInputStream) :
 	m_pCharSeqNext(0),
 	m_charSeqLen(0),
 	m_bRequiresDecoding(false),
-	m_bAtEof(false)
+	m_bAtEof(false),
+	m_bUsingView(false)
 {
 	if(!pInputStream) throw NullPointerException();
 
@@ -157,7 +163,8 @@ InputStreamReader::InputStreamReader(InputStream* pInputStream, const String& en
 	m_pCharSeqNext(0),
 	m_charSeqLen(0),
 	m_bRequiresDecoding(false),
-	m_bAtEof(false)
+	m_bAtEof(false),
+	m_bUsingView(false)
 {
 	if(!pInputStream) throw NullPointerException();
 
@@ -195,7 +202,8 @@ InputStreamReader::InputStreamReader(InputStream* pInputStream,
 	m_pCharSeqNext(0),
 	m_charSeqLen(0),
 	m_bRequiresDecoding(false),
-	m_bAtEof(false)
+	m_bAtEof(false),
+	m_bUsingView(false)
 {
 	if(!pInputStream) throw NullPointerException();
 
@@ -225,7 +233,8 @@ InputStreamReader::InputStreamReader(InputStream* pInputStream, CodeConverter* p
 	m_pCharSeqNext(0),
 	m_charSeqLen(0),
 	m_bRequiresDecoding(false),
-	m_bAtEof(false)
+	m_bAtEof(false),
+	m_bUsingView(false)
 {
 	if(!pInputStream) throw NullPointerException();
 
@@ -301,7 +310,7 @@ void InputStreamReader::initDecoder(CodeConverter* pDecoder)
 	if(m_bRequiresDecoding)
 	{
 		m_byteBufferSize = ByteBufferSize;
-		m_pByteBuffer = new Byte[m_byteBufferSize];
+		m_pByteBuffer = BufferPool::AllocateArray<Byte>(m_byteBufferSize);
 		m_pNextByteFree = m_pNextByteAvailable = m_pByteBuffer;
 	}
 }
@@ -323,6 +332,25 @@ void InputStreamReader::fillByteBuffer()
 	QC_DBG_ASSERT(!m_bAtEof);
 	QC_DBG_ASSERT(m_pByteBuffer!=0);
 
+	//
+	// Bytes that are left over from a view of the InputStream's storage
+	// are only valid until the next operation on the stream.  They can only
+	// be the start of an incomplete character sequence, so they are moved
+	// into our own buffer before the stream is read again.
+	//
+	if(m_bUsingView)
+	{
+		const size_t bytesLeft = m_pNextByteFree-m_pNextByteAvailable;
+		if(bytesLeft >= m_byteBufferSize)
+		{
+			throw IOException(QC_T("Input buffer too small to hold required sequence"));
+		}
+		::memcpy(m_pByteBuffer, m_pNextByteAvailable, bytesLeft);
+		m_pNextByteAvailable = m_pByteBuffer;
+		m_pNextByteFree = m_pByteBuffer + bytesLeft;
+		m_bUsingView = false;
+	}
+
 	//
 	// If we have successfully used up all the bytes in the buffer
 	// then we can expedite things by resetting the buffer pointers
@@ -334,6 +362,29 @@ void InputStreamReader::fillByteBuffer()
 		m_pNextByteAvailable = m_pNextByteFree = m_pByteBuffer;
 	}
 
+	//
+	// If there is nothing left to decode and the InputStream can let us see
+	// its own storage, decode straight from there rather than copying the
+	// bytes into our buffer.
+	//
+	if(m_pNextByteFree == m_pByteBuffer && m_rpInputStream->viewSupported())
+	{
+		const Byte* pView;
+		const long numBytes = m_rpInputStream->readView(pView, MaxViewSize);
+
+		if(numBytes == InputStream::EndOfFile)
+		{
+			m_bAtEof = true;
+		}
+		else
+		{
+			m_pNextByteAvailable = const_cast<Byte*>(pView);
+			m_pNextByteFree = m_pNextByteAvailable + numBytes;
+			m_bUsingView = true;
+		}
+		return;
+	}
+
 	//
 	// Calculate the free space in the buffer
 	//
@@ -389,9 +440,10 @@ void InputStreamReader::fillByteBuffer()
 //==============================================================================
 void InputStreamReader::freeBuffers()
 {
-	delete [] m_pByteBuffer;
+	BufferPool::ReleaseArray(m_pByteBuffer, m_byteBufferSize);
 	m_pNextByteFree = m_pNextByteAvailable = m_pByteBuffer = 0;
 	m_byteBufferSize = 0;
+	m_bUsingView = false;
 
 	m_pCharSeqNext = m_charSeqBuffer;
 	m_charSeqLen = 0;
@@ -413,7 +465,7 @@ void InputStreamReader::freeBuffers()
 //==============================================================================
 void InputStreamReader::close()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_rpInputStream)
 	{
@@ -451,7 +503,7 @@ long InputStreamReader::read(CharType* pBuffer, size_t bufLen)
 {
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 	
 	int returnLen = 0;
 
@@ -504,7 +556,7 @@ long InputStreamReader::readAtomic(CharType* pBuffer, size_t bufLen)
 {
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	//
 	// It is not legal for us to have stored characters in our character
@@ -526,7 +578,7 @@ long InputStreamReader::readAtomic(CharType* pBuffer, size_t bufLen)
 //==============================================================================
 Character InputStreamReader::readAtomic()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	//
 	// It is not legal for us to have stored characters in our character
@@ -1111,7 +1163,7 @@ bool InputStreamReader::readDirect(CharType* pBuffer, size_t bufLen, bool bAtomi
 			if(!m_pByteBuffer)
 			{
 				m_byteBufferSize = OverflowBufferSize;
-				m_pByteBuffer = new Byte[m_byteBufferSize];
+				m_pByteBuffer = BufferPool::AllocateArray<Byte>(m_byteBufferSize);
 				m_pNextByteFree = m_pNextByteAvailable = m_pByteBuffer;
 			}
 			QC_DBG_ASSERT(overflowBytes <= m_byteBufferSize);
@@ -1188,36 +1240,47 @@ String InputStreamReader::SenseEncoding(InputStream* pInputStream, size_t& BOMSi
 			bomBytesRead += rc;
 	}
 
-	if(bomBytesRead ==4)
+	//
+	// The UTF-16 and UTF-8 byte order marks are recognized even when the
+	// stream holds fewer than 4 bytes.  A UTF-16 BOM resolves to the encoding
+	// name with explicit byte order, so the decoder created from the name
+	// goes straight to its block conversion without examining the BOM again.
+	//
+	BOMSize=0;
+	if(bomBytesRead ==4 && bom[0] == 0 && bom[1] == 0 && bom[2] == 0xFE && bom[3] == 0xFF)
 	{
+		encoding = QC_T("UCS-4BE");
 		BOMSize=4;
-		if(bom[0] == 0 && bom[1] == 0 && bom[2] == 0xFE && bom[3] == 0xFF)
-			encoding = QC_T("UCS-4BE");
-		else if(bom[0] == 0xFF && bom[1] == 0xFE && bom[2] == 0 && bom[3] == 0)
-			encoding = QC_T("UCS-4LE");
-		else if(bom[0] == 0 && bom[1] == 0 && bom[2] == 0xFF && bom[3] == 0xFE)
-			encoding = QC_T("UCS-4-2143");
-		else if(bom[0] == 0xFE && bom[1] == 0xFF && bom[2] == 0 && bom[3] == 0)
-			encoding = QC_T("UCS-4-3412");
-		else if(bom[0] == 0xFE && bom[1] == 0xFF && (bom[2] != 0 || bom[3] != 0))
-		{
-			encoding = QC_T("UTF-16BE");
-			BOMSize=2;
-		}
-		else if(bom[0] == 0xFF && bom[1] == 0xFE && (bom[2] != 0 || bom[3] != 0))
-		{
-			encoding = QC_T("UTF-16LE");
-			BOMSize=2;
-		}
-		else if(bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF)
-		{
-			encoding = QC_T("UTF-8");
-			BOMSize=3;
-		}
-		else
-		{
-			BOMSize=0;
-		}
+	}
+	else if(bomBytesRead ==4 && bom[0] == 0xFF && bom[1] == 0xFE && bom[2] == 0 && bom[3] == 0)
+	{
+		encoding = QC_T("UCS-4LE");
+		BOMSize=4;
+	}
+	else if(bomBytesRead ==4 && bom[0] == 0 && bom[1] == 0 && bom[2] == 0xFF && bom[3] == 0xFE)
+	{
+		encoding = QC_T("UCS-4-2143");
+		BOMSize=4;
+	}
+	else if(bomBytesRead ==4 && bom[0] == 0xFE && bom[1] == 0xFF && bom[2] == 0 && bom[3] == 0)
+	{
+		encoding = QC_T("UCS-4-3412");
+		BOMSize=4;
+	}
+	else if(bomBytesRead >= 2 && bom[0] == 0xFE && bom[1] == 0xFF)
+	{
+		encoding = QC_T("UTF-16BE");
+		BOMSize=2;
+	}
+	else if(bomBytesRead >= 2 && bom[0] == 0xFF && bom[1] == 0xFE)
+	{
+		encoding = QC_T("UTF-16LE");
+		BOMSize=2;
+	}
+	else if(bomBytesRead >= 3 && bom[0] == 0xEF && bom[1] == 0xBB && bom[2] == 0xBF)
+	{
+		encoding = QC_T("UTF-8");
+		BOMSize=3;
 	}
 	pInputStream->reset();
 
@@ -1251,7 +1314,7 @@ void InputStreamReader::suspendDecodingOptimization(const Byte* pExtraBytes,
 	{
 		m_bRequiresDecoding = true;
 
-		Byte* pBuffer = new Byte[ByteBufferSize];
+		Byte* pBuffer = BufferPool::AllocateArray<Byte>(ByteBufferSize);
 		const size_t storedBytes = m_pNextByteFree-m_pNextByteAvailable;
 		QC_DBG_ASSERT(storedBytes <= m_byteBufferSize);
 		QC_DBG_ASSERT(storedBytes + extraLen <= ByteBufferSize);
@@ -1263,7 +1326,7 @@ void InputStreamReader::suspendDecodingOptimization(const Byte* pExtraBytes,
 		{
 			::memcpy(pBuffer+extraLen, m_pNextByteAvailable, storedBytes);
 		}
-		delete [] m_pByteBuffer;
+		BufferPool::ReleaseArray(m_pByteBuffer, m_byteBufferSize);
 		m_pNextByteAvailable = m_pByteBuffer = pBuffer;
 		m_pNextByteFree = m_pNextByteAvailable + storedBytes + extraLen;
 		m_byteBufferSize = ByteBufferSize;
@@ -94,6 +94,7 @@ private:
 	size_t m_charSeqLen;
 	bool m_bRequiresDecoding;
 	bool m_bAtEof;
+	bool m_bUsingView;
 };
 
 QC_IO_NAMESPACE_END
@@ -0,0 +1,56 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Struct: IoVec
+/**
+	@struct qc::io::IoVec
+	
+	@brief Describes one block of bytes in a gather write.
+
+	An array of IoVec structures is passed to OutputStream::write() to
+	write several separate blocks of memory as though they were one
+	contiguous block.  Where the operating system supports it, the blocks
+	are written with a single system call.
+*/
+//==============================================================================
+
+#ifndef QC_IO_IoVec_h
+#define QC_IO_IoVec_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+QC_IO_NAMESPACE_BEGIN
+
+struct IoVec
+{
+	const Byte* pData;  //!< address of the first byte in the block
+	size_t      length; //!< number of bytes in the block
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_IoVec_h
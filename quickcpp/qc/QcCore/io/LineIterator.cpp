@@ -0,0 +1,149 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+// 
+// Class: LineIterator
+// 
+/**
+	@class qc::io::LineIterator
+	
+	@brief Iterates over the lines of text read from a Reader without
+	       copying them.
+
+	Each call to next() reads the next line using BufferedReader::readLine(StringView&).
+	The current line, which is available from getLine(), normally refers
+	directly to the internal buffer of the BufferedReader; it is only copied
+	when it spans a refill of the buffer.  This makes a LineIterator the most
+	efficient way to process large volumes of line-oriented text such as
+	log files.
+
+	@code
+	LineIterator it(new InputStreamReader(new FileInputStream(path)));
+	while(it.next())
+	{
+		const StringView& line = it.getLine();
+		...
+	}
+	@endcode
+
+	The current line is only valid until next() is called again or another
+	operation is performed on the BufferedReader.  Use StringView::toString()
+	to retain a copy.
+
+    @mt
+    A LineIterator must not be shared between threads without external
+	synchronization.
+*/
+//=============================================================================
+
+#include "LineIterator.h"
+
+#include "QcCore/base/NullPointerException.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// LineIterator::LineIterator
+//
+/**
+   Constructs a LineIterator that reads lines from @c pReader.  If @c pReader
+   is not a BufferedReader it is wrapped in one.
+
+   @param pReader the Reader to read lines from
+   @throws NullPointerException if @c pReader is null.
+*/
+//==============================================================================
+LineIterator::LineIterator(Reader* pReader) :
+	m_lineNumber(0)
+{
+	if(!pReader) throw NullPointerException();
+
+	m_rpReader = dynamic_cast<BufferedReader*>(pReader);
+	if(!m_rpReader)
+	{
+		m_rpReader = new BufferedReader(pReader);
+	}
+}
+
+//==============================================================================
+// LineIterator::next
+//
+/**
+   Advances to the next line.
+
+   @returns true if a line was read, or false if the end of the character
+   stream has been reached.
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+bool LineIterator::next()
+{
+	if(m_rpReader->readLine(m_line) == Reader::EndOfFile)
+	{
+		return false;
+	}
+
+	++m_lineNumber;
+	return true;
+}
+
+//==============================================================================
+// LineIterator::getLine
+//
+/**
+   Returns the current line, excluding its terminator.  The line is empty
+   before the first call to next().
+*/
+//==============================================================================
+const StringView& LineIterator::getLine() const
+{
+	return m_line;
+}
+
+//==============================================================================
+// LineIterator::getLineNumber
+//
+/**
+   Returns the number of the current line, starting at 1 for the first line.
+   Returns 0 before the first call to next().
+*/
+//==============================================================================
+size_t LineIterator::getLineNumber() const
+{
+	return m_lineNumber;
+}
+
+//==============================================================================
+// LineIterator::getReader
+//
+/**
+   Returns the BufferedReader that lines are read from.
+*/
+//==============================================================================
+AutoPtr<BufferedReader> LineIterator::getReader() const
+{
+	return m_rpReader;
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,64 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: LineIterator
+// 
+//=============================================================================
+
+#ifndef QC_IO_LineIterator_h
+#define QC_IO_LineIterator_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "BufferedReader.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG LineIterator : public virtual QCObject
+{
+public:
+	LineIterator(Reader* pReader);
+
+	bool next();
+	const StringView& getLine() const;
+	size_t getLineNumber() const;
+
+	AutoPtr<BufferedReader> getReader() const;
+
+private:
+	LineIterator(const LineIterator& rhs);            // cannot be copied
+	LineIterator& operator=(const LineIterator& rhs); // nor assigned
+
+private:
+	AutoPtr<BufferedReader> m_rpReader;
+	StringView m_line;
+	size_t m_lineNumber;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_LineIterator_h
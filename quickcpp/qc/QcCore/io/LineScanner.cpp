@@ -0,0 +1,201 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: LineScanner
+//
+// Carriage return and line feed are represented by a single ::CharType in
+// every internal encoding, and neither value can occur inside a multi-unit
+// UTF-8 or UTF-16 sequence.  A line terminator can therefore be found by
+// comparing every ::CharType lane of a vector against both values without
+// regard to character boundaries.
+//
+// Each vector loop tests a whole block with a single movemask instruction.
+// As soon as a block containing a terminator is found, the scalar
+// implementation locates its exact position within the block.
+//
+// The SSE2 and AVX2 implementations are compiled with function-level target
+// attributes so that the library does not require the application to be
+// compiled for a particular instruction set.  The AVX2 implementation must
+// issue vzeroupper before returning to non-VEX code.
+//
+//==============================================================================
+
+#include "LineScanner.h"
+
+#include "QcCore/base/CpuFeatures.h"
+
+#if defined(QC_X86_SIMD)
+	#include <immintrin.h>
+#endif
+
+QC_IO_NAMESPACE_BEGIN
+
+LineScanner::FindFunc QC_MT_VOLATILE LineScanner::s_pFindLineEnd = 0;
+
+//==============================================================================
+// FindLineEnd_Scalar
+//
+// Portable implementation.
+//==============================================================================
+static size_t FindLineEnd_Scalar(const CharType* pData, size_t len)
+{
+	size_t i = 0;
+
+	while(i < len && pData[i] != '\n' && pData[i] != '\r')
+	{
+		++i;
+	}
+
+	return i;
+}
+
+#if defined(QC_X86_SIMD)
+
+//==============================================================================
+// FindLineEnd_SSE2
+//
+// 16 bytes per iteration.
+//==============================================================================
+QC_TARGET_SSE2
+static size_t FindLineEnd_SSE2(const CharType* pData, size_t len)
+{
+	const size_t blockChars = 16 / sizeof(CharType);
+	__m128i lf, cr;
+
+	if(sizeof(CharType) == 1)
+	{
+		lf = _mm_set1_epi8('\n');
+		cr = _mm_set1_epi8('\r');
+	}
+	else if(sizeof(CharType) == 2)
+	{
+		lf = _mm_set1_epi16('\n');
+		cr = _mm_set1_epi16('\r');
+	}
+	else
+	{
+		lf = _mm_set1_epi32('\n');
+		cr = _mm_set1_epi32('\r');
+	}
+
+	size_t i = 0;
+
+	for(; i + blockChars <= len; i += blockChars)
+	{
+		const __m128i v = _mm_loadu_si128((const __m128i*)(pData + i));
+		__m128i match;
+
+		if(sizeof(CharType) == 1)
+			match = _mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr));
+		else if(sizeof(CharType) == 2)
+			match = _mm_or_si128(_mm_cmpeq_epi16(v, lf), _mm_cmpeq_epi16(v, cr));
+		else
+			match = _mm_or_si128(_mm_cmpeq_epi32(v, lf), _mm_cmpeq_epi32(v, cr));
+
+		if(_mm_movemask_epi8(match))
+		{
+			break;
+		}
+	}
+
+	return i + FindLineEnd_Scalar(pData + i, len - i);
+}
+
+//==============================================================================
+// FindLineEnd_AVX2
+//
+// 32 bytes per iteration.
+//==============================================================================
+QC_TARGET_AVX2
+static size_t FindLineEnd_AVX2(const CharType* pData, size_t len)
+{
+	const size_t blockChars = 32 / sizeof(CharType);
+	__m256i lf, cr;
+
+	if(sizeof(CharType) == 1)
+	{
+		lf = _mm256_set1_epi8('\n');
+		cr = _mm256_set1_epi8('\r');
+	}
+	else if(sizeof(CharType) == 2)
+	{
+		lf = _mm256_set1_epi16('\n');
+		cr = _mm256_set1_epi16('\r');
+	}
+	else
+	{
+		lf = _mm256_set1_epi32('\n');
+		cr = _mm256_set1_epi32('\r');
+	}
+
+	size_t i = 0;
+
+	for(; i + blockChars <= len; i += blockChars)
+	{
+		const __m256i v = _mm256_loadu_si256((const __m256i*)(pData + i));
+		__m256i match;
+
+		if(sizeof(CharType) == 1)
+			match = _mm256_or_si256(_mm256_cmpeq_epi8(v, lf), _mm256_cmpeq_epi8(v, cr));
+		else if(sizeof(CharType) == 2)
+			match = _mm256_or_si256(_mm256_cmpeq_epi16(v, lf), _mm256_cmpeq_epi16(v, cr));
+		else
+			match = _mm256_or_si256(_mm256_cmpeq_epi32(v, lf), _mm256_cmpeq_epi32(v, cr));
+
+		if(_mm256_movemask_epi8(match))
+		{
+			break;
+		}
+	}
+
+	//
+	// Clear the upper halves of the YMM registers before running legacy
+	// SSE code, otherwise every transition incurs a heavy penalty
+	//
+	_mm256_zeroupper();
+
+	return i + FindLineEnd_Scalar(pData + i, len - i);
+}
+
+#endif //QC_X86_SIMD
+
+//==============================================================================
+// LineScanner::SelectFind
+//
+// Selects the best FindLineEnd implementation for the host processor.
+//==============================================================================
+LineScanner::FindFunc LineScanner::SelectFind()
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasAVX2())
+		return &FindLineEnd_AVX2;
+	else if(CpuFeatures::HasSSE2())
+		return &FindLineEnd_SSE2;
+#endif //QC_X86_SIMD
+
+	return &FindLineEnd_Scalar;
+}
+
+QC_IO_NAMESPACE_END
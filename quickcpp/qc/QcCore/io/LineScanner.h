@@ -0,0 +1,79 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: LineScanner
+// 
+// Overview
+// --------
+// Class module containing the vectorized search for line terminators used
+// by BufferedReader.  The operation is implemented for SSE2, AVX2 and plain
+// C++; the best implementation supported by the host processor is selected
+// the first time it is used.
+//
+// This is an internal class and is not exported from the library.
+//
+//=============================================================================
+
+#ifndef QC_IO_LineScanner_h
+#define QC_IO_LineScanner_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+QC_IO_NAMESPACE_BEGIN
+
+class LineScanner
+{
+public:
+
+	static size_t FindLineEnd(const CharType* pData, size_t len);
+
+private:
+	LineScanner(); // not implemented
+
+	typedef size_t (*FindFunc)(const CharType*, size_t);
+
+	static FindFunc SelectFind();
+
+	static FindFunc QC_MT_VOLATILE s_pFindLineEnd;
+};
+
+//==============================================================================
+// LineScanner::FindLineEnd
+//
+// Returns the position of the first carriage return or line feed character
+// in the ::CharType array [pData, pData+len), or @c len if there is none.
+//==============================================================================
+inline
+	size_t LineScanner::FindLineEnd(const CharType* pData, size_t len)
+{
+	if(!s_pFindLineEnd) s_pFindLineEnd = SelectFind();
+	return (*s_pFindLineEnd)(pData, len);
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_LineScanner_h
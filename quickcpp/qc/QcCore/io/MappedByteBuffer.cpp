@@ -0,0 +1,156 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: MappedByteBuffer
+/**
+	@class qc::io::MappedByteBuffer
+	
+	@brief An abstract base class representing a read-only region of a file
+	that has been mapped into the address space of the process.
+
+    MappedByteBuffers are created by FileSystem::mapFile().  The bytes of
+	the file can be accessed directly through the pointer returned from
+	getData(), without being copied into an application buffer.  This makes
+	them suitable for passing to functions that accept a (pointer, length)
+	pair such as Base64::Decode() or CodeConverter::decode().
+
+	The region remains mapped until the MappedByteBuffer is destroyed, which
+	happens automatically when the last reference to it is removed.  The
+	mapping does not depend on the FileDescriptor that was used to create
+	it, so the file may be closed while the region is still in use.
+
+    If the file is truncated while it is mapped, accessing the bytes
+	that no longer exist will cause the process to receive a signal (or a
+	structured exception on Windows).  Applications should only map files that
+	are not being modified by other processes.
+
+	@sa MappedFileInputStream
+*/
+//==============================================================================
+
+#include "MappedByteBuffer.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// MappedByteBuffer::MappedByteBuffer
+//
+/**
+   Constructs a MappedByteBuffer for @c length bytes that have been mapped
+   at @c pData.
+
+   @param pData the address of the first byte of the mapped region
+   @param length the number of bytes in the mapped region
+   @param fileOffset the offset within the file of the first byte of
+          the mapped region
+*/
+//==============================================================================
+MappedByteBuffer::MappedByteBuffer(const Byte* pData, size_t length, FileOffset fileOffset) :
+	m_pData(pData),
+	m_length(length),
+	m_fileOffset(fileOffset)
+{
+}
+
+//==============================================================================
+// MappedByteBuffer::~MappedByteBuffer
+//
+/**
+   Destructor.  This method does nothing, @a derived classes are 
+   expected to unmap the region.
+*/
+//==============================================================================
+MappedByteBuffer::~MappedByteBuffer()
+{
+}
+
+//==============================================================================
+// MappedByteBuffer::getData
+//
+/**
+   Returns a pointer to the first byte of the mapped region.
+   The bytes must not be modified.
+*/
+//==============================================================================
+const Byte* MappedByteBuffer::getData() const
+{
+	return m_pData;
+}
+
+//==============================================================================
+// MappedByteBuffer::getLength
+//
+/**
+   Returns the number of bytes in the mapped region.
+*/
+//==============================================================================
+size_t MappedByteBuffer::getLength() const
+{
+	return m_length;
+}
+
+//==============================================================================
+// MappedByteBuffer::getFileOffset
+//
+/**
+   Returns the offset within the file of the first byte of the
+   mapped region.
+*/
+//==============================================================================
+FileOffset MappedByteBuffer::getFileOffset() const
+
+{
+	return m_fileOffset;
+}
+
+#ifdef QC_DOCUMENTATION_ONLY
+//=============================================================================
+//
+// Documentation for pure virtual methods follows:
+//
+//=============================================================================
+
+//==============================================================================
+// MappedByteBuffer::advise
+//
+/**
+   Informs the operating system how the application expects to access the
+   mapped bytes from @c offset for a length of @c len bytes.  The advice
+   is a hint which may improve the performance of read-ahead and paging; it
+   does not change the contents of the buffer.  Platforms that do not
+   support a particular hint silently ignore it.
+
+   @param advice the expected access pattern
+   @param offset the offset, relative to getData(), of the first byte
+          the advice applies to
+   @param len the number of bytes the advice applies to.  This is reduced
+          so that it does not extend beyond the end of the buffer.
+*/
+//==============================================================================
+void MappedByteBuffer::advise(Advice advice, size_t offset, size_t len);
+
+#endif //QC_DOCUMENTATION_ONLY
+
+QC_IO_NAMESPACE_END
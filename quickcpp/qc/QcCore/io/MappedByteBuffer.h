@@ -0,0 +1,72 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: MappedByteBuffer
+// 
+//==============================================================================
+
+#ifndef QC_IO_MappedByteBuffer_h
+#define QC_IO_MappedByteBuffer_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG MappedByteBuffer : public virtual QCObject
+{
+public:
+	enum Advice {Normal     /*!< no special treatment */,
+	             Sequential /*!< pages will be read in ascending order */,
+	             Random     /*!< pages will be read in no particular order */,
+	             WillNeed   /*!< pages will be read soon */,
+	             DontNeed   /*!< pages will not be read again soon */};
+
+	virtual ~MappedByteBuffer();
+
+	const Byte* getData() const;
+	size_t getLength() const;
+	FileOffset getFileOffset() const;
+
+	virtual void advise(Advice advice, size_t offset, size_t len)=0;
+
+protected:
+	MappedByteBuffer(const Byte* pData, size_t length, FileOffset fileOffset);
+
+private: // not implemented
+	MappedByteBuffer(const MappedByteBuffer& rhs);            // cannot be copied
+	MappedByteBuffer& operator=(const MappedByteBuffer& rhs); // nor assigned
+
+private:
+	const Byte* m_pData;
+	size_t m_length;
+	FileOffset m_fileOffset;
+
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_MappedByteBuffer_h
@@ -0,0 +1,483 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: MappedFileInputStream
+/**
+	@class qc::io::MappedFileInputStream
+	
+	@brief An InputStream that reads the contents of a file by mapping it
+	into the address space of the process.
+
+    A FileInputStream asks the operating system to copy the file's contents
+	into the caller's buffer on every read(), and a BufferedInputStream or
+	InputStreamReader wrapped around it copies the bytes once more.  A
+	MappedFileInputStream maps the file with FileSystem::mapFile() instead,
+	so read() is a single copy from the page cache and readView() returns
+	the bytes without copying them at all.  An InputStreamReader
+	uses readView() automatically, which means that a mapped file is decoded
+	directly from the page cache.
+
+	Files larger than the window size (1GB on 64-bit platforms and 64MB on
+	32-bit platforms, unless specified in the constructor) are mapped one
+	window at a time.  The window slides forward as the file is read, so the
+	address space used by the stream is bounded.  Each window is mapped
+	with sequential access advice to encourage the operating system to read
+	ahead.
+
+    The length of the file is determined when the stream is opened; bytes
+	appended to the file later are not read.  The file must not be
+	truncated while it is being read.
+
+	MappedFileInputStream supports mark() and reset() without limit, as the
+	whole file remains available until the stream is closed.
+
+	@sa MappedByteBuffer
+	@sa FileInputStream
+*/
+//==============================================================================
+
+#include "MappedFileInputStream.h"
+#include "File.h"
+#include "FileSystem.h"
+#include "FileDescriptor.h"
+#include "IOException.h"
+#include "OutputStream.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/SystemUtils.h"
+
+#include <limits.h>
+#include <string.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+const size_t DefaultWindowSize = (sizeof(void*) > 4) ? 0x40000000 : 0x4000000;
+const size_t WillNeedSize = 0x100000;
+
+//==============================================================================
+// ClampToSize
+//
+// Returns a file length as a size_t, limited to the largest value a size_t
+// can hold on platforms where it is narrower than a FileOffset.
+//==============================================================================
+static size_t ClampToSize(FileOffset n)
+{
+	return (n < FileOffset(size_t(-1))) ? size_t(n) : size_t(-1);
+}
+
+//==============================================================================
+// MappedFileInputStream::MappedFileInputStream
+//
+/**
+   Constructs a MappedFileInputStream by opening and mapping the file with
+   the abstract pathname denoted by @c file.
+
+   @param file the abstract pathname of the file to open
+   @throws FileNotFoundException if a file with the specified name does not
+           exist on the file system.  
+   @throws IOException if the specified file could not be opened.  This includes
+           the case where @c file refers to a directory instead of a normal file.
+*/
+//==============================================================================
+MappedFileInputStream::MappedFileInputStream(const File& file) :
+	m_windowSize(0), m_length(0), m_pos(0), m_markPos(0), m_bMarked(false)
+{
+	open(file.getPath());
+}
+
+//==============================================================================
+// MappedFileInputStream::MappedFileInputStream
+//
+/**
+   Constructs a MappedFileInputStream by opening and mapping the named
+   file @c name.
+
+   @param name the name of the file to open
+   @throws FileNotFoundException if a file with the specified name does not
+           exist on the file system.  
+   @throws IOException if the specified file name could not be opened.  This includes
+           the case where @c name refers to a directory instead of a normal file.
+*/
+//==============================================================================
+MappedFileInputStream::MappedFileInputStream(const String& name) :
+	m_windowSize(0), m_length(0), m_pos(0), m_markPos(0), m_bMarked(false)
+{
+	open(name);
+}
+
+//==============================================================================
+// MappedFileInputStream::MappedFileInputStream
+//
+/**
+   Constructs a MappedFileInputStream that maps the open file
+   denoted by the FileDescriptor @c pFD.
+
+   The file is read from its beginning, regardless of the current
+   position of @c pFD.
+
+   @param pFD the FileDescriptor of a file opened for reading
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if the length of the file cannot be determined.
+*/
+//==============================================================================
+MappedFileInputStream::MappedFileInputStream(FileDescriptor* pFD) :
+	m_rpFD(pFD),
+	m_windowSize(0), m_length(0), m_pos(0), m_markPos(0), m_bMarked(false)
+{
+	if(!pFD) throw NullPointerException();
+
+	init(DefaultWindowSize);
+}
+
+//==============================================================================
+// MappedFileInputStream::MappedFileInputStream
+//
+/**
+   Constructs a MappedFileInputStream that maps the open file
+   denoted by the FileDescriptor @c pFD, using a window of @c windowSize
+   bytes.
+
+   The file is read from its beginning, regardless of the current
+   position of @c pFD.
+
+   @param pFD the FileDescriptor of a file opened for reading
+   @param windowSize the maximum number of bytes of the file that are mapped
+          at any one time
+   @throws NullPointerException if @c pFD is null.
+   @throws IllegalArgumentException if @c windowSize is zero.
+   @throws IOException if the length of the file cannot be determined.
+*/
+//==============================================================================
+MappedFileInputStream::MappedFileInputStream(FileDescriptor* pFD, size_t windowSize) :
+	m_rpFD(pFD),
+	m_windowSize(0), m_length(0), m_pos(0), m_markPos(0), m_bMarked(false)
+{
+	if(!pFD) throw NullPointerException();
+
+	init(windowSize);
+}
+
+//==============================================================================
+// MappedFileInputStream::init
+//
+// Common initialization (called from constructors)
+//==============================================================================
+void MappedFileInputStream::init(size_t windowSize)
+{
+	if(!windowSize) throw IllegalArgumentException(QC_T("zero window size"));
+
+	m_windowSize = windowSize;
+	m_length = m_rpFD->getFileSystem()->getFileLength(m_rpFD.get());
+}
+
+//==============================================================================
+// MappedFileInputStream::open
+//
+// Private helper function.
+//==============================================================================
+void MappedFileInputStream::open(const String& fileName) 
+{
+	if(fileName.empty())
+		throw IOException(QC_T("empty filename"));
+	else if(FileSystem::GetFileSystem()->getFileAttributeFlags(fileName) & FileSystem::Directory)
+		throw IOException(fileName + QC_T(" is a directory"));
+
+	m_rpFD = 
+		FileSystem::GetFileSystem()->openFile(fileName,
+		                                      FileSystem::ReadAccess,
+		                                      FileSystem::OpenExisting,
+		                                      0);
+	init(DefaultWindowSize);
+}
+
+//==============================================================================
+// MappedFileInputStream::close
+//
+/**
+   Unmaps and closes the file.  Further calls to close() have no effect.
+*/
+//==============================================================================
+void MappedFileInputStream::close()
+{
+	m_rpWindow.release();
+	if(m_rpFD)
+	{
+		// must call close on the FD rather than the FileSystem
+		// in case the FD has AutoClose enabled
+		m_rpFD->close();
+		m_rpFD.release();
+	}
+	m_pos = m_length = 0;
+	m_bMarked = false;
+}
+
+//==============================================================================
+// MappedFileInputStream::available
+//
+/**
+   Returns the number of bytes remaining in the file.
+*/
+//==============================================================================
+size_t MappedFileInputStream::available()
+{
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	return ClampToSize(m_length - m_pos);
+}
+
+//==============================================================================
+// MappedFileInputStream::mark
+//
+/**
+   Marks the current position in the file.  A subsequent call to reset()
+   re-positions the stream at the marked position.
+
+   The @c readLimit has no effect, as the whole file is always available
+   until the stream is closed.
+*/
+//==============================================================================
+void MappedFileInputStream::mark(size_t /*readLimit*/)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	m_markPos = m_pos;
+	m_bMarked = true;
+}
+
+//==============================================================================
+// MappedFileInputStream::markSupported
+//
+/**
+   Returns @c true for MappedFileInputStream.
+*/
+//==============================================================================
+bool MappedFileInputStream::markSupported() const
+{
+	return true;
+}
+
+//==============================================================================
+// MappedFileInputStream::reset
+//
+/**
+   Resets the position in the file to the position established by the
+   most recent mark() operation.
+
+   @throws IOException if mark() has not been called.
+*/
+//==============================================================================
+void MappedFileInputStream::reset()
+{
+	if(!m_bMarked)
+	{
+		throw IOException(QC_T("unable to reset input stream, no marked position"));
+	}
+	m_pos = m_markPos;
+}
+
+//==============================================================================
+// MappedFileInputStream::skip
+//
+/**
+   Skips over @c n bytes, or to the end of the file if fewer than @c n
+   bytes remain.  Skipped bytes are not accessed.
+
+   @returns the number of bytes skipped.
+*/
+//==============================================================================
+size_t MappedFileInputStream::skip(size_t n)
+{
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	const size_t remaining = ClampToSize(m_length - m_pos);
+	const size_t count = (n < remaining) ? n : remaining;
+	m_pos += count;
+	return count;
+}
+
+//==============================================================================
+// MappedFileInputStream::read
+//
+//==============================================================================
+long MappedFileInputStream::read(Byte* pBuffer, size_t bufLen)
+{
+	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
+
+	const Byte* pData;
+	const long count = readView(pData, bufLen);
+	if(count != EndOfFile)
+	{
+		::memcpy(pBuffer, pData, count);
+	}
+	return count;
+}
+
+//==============================================================================
+// MappedFileInputStream::readView
+//
+/**
+   Returns a pointer to up to @c maxLen bytes of the mapped file without
+   copying them.  Fewer bytes are returned when the end of the current
+   window is reached.
+
+   @sa InputStream::readView()
+*/
+//==============================================================================
+long MappedFileInputStream::readView(const Byte*& pData, size_t maxLen)
+{
+	if(!maxLen) throw IllegalArgumentException(QC_T("zero buffer length"));
+	if(maxLen > LONG_MAX) maxLen = LONG_MAX;
+
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	const size_t windowAvailable = mapWindow();
+	if(!windowAvailable)
+	{
+		return EndOfFile;
+	}
+
+	const size_t count = (maxLen < windowAvailable)
+	                   ? maxLen
+	                   : windowAvailable;
+
+	pData = m_rpWindow->getData() + size_t(m_pos - m_rpWindow->getFileOffset());
+	m_pos += count;
+	return count;
+}
+
+//==============================================================================
+// MappedFileInputStream::transferTo
+//
+/**
+   Writes the remainder of the file to the OutputStream @c pOut.
+
+   The bytes are passed to OutputStream::transferFrom() using the underlying
+   FileDescriptor, so a socket can send them without a mapping being created.
+
+   @sa FileInputStream::transferTo()
+*/
+//==============================================================================
+size_t MappedFileInputStream::transferTo(OutputStream* pOut)
+{
+	if(!pOut) throw NullPointerException();
+	if(!m_rpFD) throw IOException(QC_T("stream is closed"));
+
+	if(m_pos >= m_length)
+	{
+		return 0;
+	}
+
+	const size_t count = pOut->transferFrom(m_rpFD.get(), m_pos, ClampToSize(m_length-m_pos));
+	m_pos += count;
+	return count;
+}
+
+//==============================================================================
+// MappedFileInputStream::viewSupported
+//
+/**
+   Returns @c true for MappedFileInputStream.
+   @sa readView()
+*/
+//==============================================================================
+bool MappedFileInputStream::viewSupported() const
+{
+	return true;
+}
+
+//==============================================================================
+// MappedFileInputStream::getFD
+//
+/**
+   Returns a FileDescriptor for the open file
+   connected to this MappedFileInputStream.  A null AutoPtr is returned
+   if this MappedFileInputStream has been closed.
+*/
+//==============================================================================
+AutoPtr<FileDescriptor> MappedFileInputStream::getFD() const
+{
+	return m_rpFD;
+}
+
+//==============================================================================
+// MappedFileInputStream::getLength
+//
+/**
+   Returns the length of the file, as determined when the stream was opened.
+*/
+//==============================================================================
+FileOffset MappedFileInputStream::getLength() const
+{
+	return m_length;
+}
+
+//==============================================================================
+// MappedFileInputStream::mapWindow
+//
+// Makes sure that the current position lies within the mapped window,
+// sliding the window forward (or back, after a reset) if it does not.
+// The old window is unmapped before the new one is mapped so that no more
+// than one window's worth of address space is ever in use.
+//
+// Returns the number of bytes from the current position to the end of the
+// window, which is zero only at the end of the file.
+//==============================================================================
+size_t MappedFileInputStream::mapWindow()
+{
+	if(m_pos >= m_length)
+	{
+		return 0;
+	}
+
+	if(m_rpWindow)
+	{
+		const FileOffset windowStart = m_rpWindow->getFileOffset();
+		const FileOffset windowEnd = windowStart + m_rpWindow->getLength();
+		if(m_pos >= windowStart && m_pos < windowEnd)
+		{
+			return size_t(windowEnd - m_pos);
+		}
+		m_rpWindow.release();
+	}
+
+	const size_t remaining = ClampToSize(m_length - m_pos);
+	const size_t windowLen = (remaining < m_windowSize) ? remaining : m_windowSize;
+
+
+	m_rpWindow = m_rpFD->getFileSystem()->mapFile(m_rpFD.get(), m_pos, windowLen);
+
+	//
+	// Sequential advice lets the operating system read ahead aggressively
+	// and drop pages behind us.  Asking for the start of the window straight
+	// away avoids a page fault on each of the first few pages.
+	//
+	m_rpWindow->advise(MappedByteBuffer::Sequential, 0, windowLen);
+	m_rpWindow->advise(MappedByteBuffer::WillNeed, 0, WillNeedSize);
+
+	return windowLen;
+}
+
+QC_IO_NAMESPACE_END
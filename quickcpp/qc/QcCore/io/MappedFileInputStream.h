@@ -0,0 +1,96 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: MappedFileInputStream
+// 
+//==============================================================================
+
+#ifndef QC_IO_MappedFileInputStream_h
+#define QC_IO_MappedFileInputStream_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "InputStream.h"
+#include "MappedByteBuffer.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class File;
+class FileDescriptor;
+
+class QC_IO_PKG MappedFileInputStream : public InputStream
+{
+public:
+
+	MappedFileInputStream(const File& file);
+	MappedFileInputStream(const String& name);
+	MappedFileInputStream(FileDescriptor* pFD);
+	MappedFileInputStream(FileDescriptor* pFD, size_t windowSize);
+
+	virtual size_t available();
+	virtual void close();
+	virtual void mark(size_t readLimit);
+	virtual bool markSupported() const;
+
+#ifdef QC_USING_DECL_BROKEN
+	virtual int read() {return InputStream::read();}
+#else
+	using InputStream::read; 	// unhide inherited read methods
+#endif
+
+	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual long readView(const Byte*& pData, size_t maxLen);
+	virtual void reset();
+	virtual size_t skip(size_t n);
+	virtual size_t transferTo(OutputStream* pOut);
+	virtual bool viewSupported() const;
+
+	AutoPtr<FileDescriptor> getFD() const;
+	FileOffset getLength() const;
+
+private:
+	MappedFileInputStream(const MappedFileInputStream& rhs);            // cannot be copied
+	MappedFileInputStream& operator=(const MappedFileInputStream& rhs); // nor assigned
+
+	void open(const String& fileName);
+	void init(size_t windowSize);
+	size_t mapWindow();
+
+private:
+	AutoPtr<FileDescriptor> m_rpFD;
+	AutoPtr<MappedByteBuffer> m_rpWindow;
+	size_t m_windowSize;
+	FileOffset m_length;
+	FileOffset m_pos;
+	FileOffset m_markPos;
+
+	bool m_bMarked;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_MappedFileInputStream_h
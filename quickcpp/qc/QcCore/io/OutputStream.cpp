@@ -41,9 +41,16 @@
 //==============================================================================
 
 #include "OutputStream.h"
+#include "FileSystem.h"
+#include "FileDescriptor.h"
+
+#include "QcCore/base/ArrayAutoPtr.h"
+#include "QcCore/base/NullPointerException.h"
 
 QC_IO_NAMESPACE_BEGIN
 
+const size_t TransferBufferSize = 0x10000;
+
 //==============================================================================
 // OutputStream::close
 //
@@ -92,6 +99,52 @@ void OutputStream::flushBuffers()
 {
 }
 
+//==============================================================================
+// OutputStream::transferFrom
+//
+/**
+   Writes up to @c length bytes from the open file denoted by @c pFD, starting
+   at @c offset bytes from the beginning of the file, to this output stream.
+   The transfer stops early if the end of the file is reached.  When the method
+   returns, the position of @c pFD is @c offset plus the number of bytes
+   transferred.
+
+   The base class implementation reads the file through a 64KB buffer and
+   passes the bytes to write().  Output streams connected to an operating
+   system resource may override this to have the operating system move the
+   bytes without copying them into user space.  SocketOutputStream does this
+   using @c sendfile() where it is available.
+
+   @param pFD the open file to transfer from
+   @param offset the position within the file of the first byte to transfer
+   @param length the maximum number of bytes to transfer
+   @returns the number of bytes transferred.
+   @throws NullPointerException if @c pFD is null.
+   @throws IOException if an I/O error occurs.
+   @sa InputStream::transferTo()
+*/
+//==============================================================================
+size_t OutputStream::transferFrom(FileDescriptor* pFD, FileOffset offset, size_t length)
+{
+	if(!pFD) throw NullPointerException();
+
+	AutoPtr<FileSystem> rpFS = pFD->getFileSystem();
+	rpFS->setFilePosition(pFD, offset);
+
+	ArrayAutoPtr<Byte> apBuffer(new Byte[TransferBufferSize]);
+	size_t count = 0;
+	while(count < length)
+	{
+		const size_t toRead = (length-count < TransferBufferSize) ? length-count : TransferBufferSize;
+		const size_t bytesRead = rpFS->readFile(pFD, apBuffer.get(), toRead);
+		if(bytesRead == 0)
+			break;
+		write(apBuffer.get(), bytesRead);
+		count += bytesRead;
+	}
+	return count;
+}
+
 //==============================================================================
 // OutputStream::write
 //
@@ -106,6 +159,38 @@ void OutputStream::write(Byte x)
 	write(&x, 1);
 }
 
+//==============================================================================
+// OutputStream::write
+//
+/**
+   Writes @c count blocks of bytes, described by the array of IoVec
+   structures starting at @c pVecs, to this output stream.  The effect is the
+   same as writing each block in turn.
+
+   The base class implementation does exactly that.  Output streams connected
+   to an operating system resource override this to write all the blocks
+   with a single system call (a <i>gather write</i>), which avoids copying the
+   blocks into one contiguous buffer.
+
+   @param pVecs pointer to the first element of an array of IoVec structures
+   @param count number of elements in the array
+   @throws NullPointerException if @c pVecs is null and @c count is not zero.
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void OutputStream::write(const IoVec* pVecs, size_t count)
+{
+	if(!pVecs && count) throw NullPointerException();
+
+	for(size_t i=0; i<count; ++i)
+	{
+		if(pVecs[i].length)
+		{
+			write(pVecs[i].pData, pVecs[i].length);
+		}
+	}
+}
+
 #ifdef QC_DOCUMENTATION_ONLY
 //=============================================================================
 //
@@ -30,8 +30,12 @@
 #include "defs.h"
 #endif //QC_IO_DEFS_h
 
+#include "IoVec.h"
+
 QC_IO_NAMESPACE_BEGIN
 
+class FileDescriptor;
+
 class QC_IO_PKG OutputStream : public virtual QCObject
 {
 public:
@@ -41,8 +45,11 @@ public:
 	virtual void close();
 	virtual void flush();
 	virtual void flushBuffers(); 
+	virtual size_t transferFrom(FileDescriptor* pFD, FileOffset offset, size_t length);
+
 	virtual void write(Byte x);
 	virtual void write(const Byte* pBuffer, size_t bufLen)=0;
+	virtual void write(const IoVec* pVecs, size_t count);
 };
 
 QC_IO_NAMESPACE_END
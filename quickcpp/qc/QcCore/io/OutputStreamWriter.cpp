@@ -66,6 +66,7 @@
 #include "OutputStream.h"
 #include "UnsupportedEncodingException.h"
 
+#include "QcCore/base/BufferPool.h"
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/cvt/CodeConverterFactory.h"
 
@@ -75,6 +76,7 @@ using namespace cvt;
 
 const size_t ByteBufferSize = 2000;
 const size_t CharSeqBufferSize = 32;
+const size_t EncodeBlockSize = 1024; // characters, see initEncoder()
 
 //==============================================================================
 // OutputStreamWriter::OutputStreamWriter
@@ -237,8 +239,7 @@ OutputStreamWriter::~OutputStreamWriter()
 //==============================================================================
 void OutputStreamWriter::freeBuffers()
 {
-	if(m_pByteBuffer)
-		delete [] m_pByteBuffer; m_pByteBuffer = 0;
+	BufferPool::ReleaseArray(m_pByteBuffer, m_byteBufferSize); m_pByteBuffer = 0;
 	m_byteBufferUsed = m_byteBufferSize = 0;
 	
 	if(m_pCharSeqBuffer)
@@ -294,10 +295,19 @@ void OutputStreamWriter::initEncoder(CodeConverter* pEncoder)
 	// If decoding is required (ie the underlying byte stream
 	// is not encoded in the same way as the internal quickcpp encoding)
 	// then allocate a buffer for the efficient writing of Bytes.
+	//
+	// The byte buffer is made large enough to hold the encoded form of
+	// a block of EncodeBlockSize characters (the default size of a
+	// BufferedWriter), so that a typical write can be encoded by a single
+	// call to the encoder.
+	//
 	if(m_bRequiresEncoding)
 	{
-		m_byteBufferSize = ByteBufferSize;
-		m_pByteBuffer = new Byte [m_byteBufferSize];
+		const size_t maxEncodedLength = m_rpEncoder->getMaxEncodedLength();
+		m_byteBufferSize = EncodeBlockSize * (maxEncodedLength ? maxEncodedLength : 1);
+		if(m_byteBufferSize < ByteBufferSize)
+			m_byteBufferSize = ByteBufferSize;
+		m_pByteBuffer = BufferPool::AllocateArray<Byte>(m_byteBufferSize);
 	}
 }
 
@@ -307,7 +317,7 @@ void OutputStreamWriter::initEncoder(CodeConverter* pEncoder)
 //==============================================================================
 void OutputStreamWriter::close()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_rpOutputStream)
 	{
@@ -324,7 +334,7 @@ void OutputStreamWriter::close()
 //==============================================================================
 void OutputStreamWriter::flush()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(!m_rpOutputStream) throw IOException(QC_T("stream is closed"));
 
@@ -338,7 +348,7 @@ void OutputStreamWriter::flush()
 //==============================================================================
 void OutputStreamWriter::flushBuffers()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(!m_rpOutputStream) throw IOException(QC_T("stream is closed"));
 
@@ -390,7 +400,7 @@ void OutputStreamWriter::write(const CharType* pBuffer, size_t bufLen)
 {
 	if(!pBuffer) throw NullPointerException();
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(!m_rpOutputStream) throw IOException(QC_T("stream is closed"));
 
@@ -467,18 +477,29 @@ bool OutputStreamWriter::doEncoding(const CharType* pBuffer, size_t bufLen)
 	size_t charsRemaining = bufLen;
 	const CharType* fromNext = pBuffer;
 
+	const size_t maxEncodedLength = m_rpEncoder->getMaxEncodedLength();
+
 	while(charsRemaining)
 	{
 		Byte* toNext;
 		const CharType* pCharStart = fromNext;
 
 		//
-		// Make room if necessary
+		// Make room if necessary.  If the remaining characters are
+		// guaranteed to fit into an empty buffer but may not fit into what
+		// is left of the current one, the buffer is written first so that
+		// the characters are encoded in one piece.
 		//
 		if(m_byteBufferUsed == m_byteBufferSize)
 		{
 			writeByteBuffer();
 		}
+		else if(m_byteBufferUsed && maxEncodedLength &&
+		        charsRemaining <= m_byteBufferSize / maxEncodedLength &&
+		        charsRemaining > (m_byteBufferSize - m_byteBufferUsed) / maxEncodedLength)
+		{
+			writeByteBuffer();
+		}
 
 		//
 		// Every time writeByteBuffer is called, we ask the encoder again
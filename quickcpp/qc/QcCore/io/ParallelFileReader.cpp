@@ -0,0 +1,522 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ParallelFileReader
+//
+/**
+	@class qc::io::ParallelFileReader
+	
+	@brief Reads large parts of a file using several threads.
+
+	A ParallelFileReader divides a range of a RandomAccessFile into smaller
+	ranges and reads them concurrently on the shared ThreadPool, using
+	RandomAccessFile::readFullyAt().  Positional reads do not share a file
+	pointer, so the threads do not need to synchronize with one another.
+	Keeping several reads outstanding at once allows the storage device and
+	the operating system's read-ahead to work in parallel, which can greatly
+	reduce the time taken to load a large file.
+
+	The range can either be read into a single buffer supplied by the
+	application, using read(), or be passed to a BlockHandler one block at a
+	time, using process().  When process() is used the blocks of each range
+	are delivered in order, but the ranges are processed concurrently, so the
+	BlockHandler::processBlock() method must be thread-safe.
+
+	If an exception is thrown while a range is being read on a pooled thread,
+	the remainder of that range, starting with the block that failed, is read
+	again on the calling thread once the other ranges are complete.  In this
+	way any exception is thrown on the calling thread, exactly as it would be
+	by a serial read.  Note that this means a BlockHandler that throws an
+	exception may be passed the same block a second time.
+
+	Ranges that are smaller than twice the minimum range size (see
+	setMinRangeSize()) are always read serially.  In single-threaded
+	versions of the library all reading is serial.
+*/
+//==============================================================================
+
+#include "ParallelFileReader.h"
+#include "IOException.h"
+
+#include "QcCore/base/ArrayAutoPtr.h"
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/ThreadPool.h"
+
+#include <vector>
+
+QC_IO_NAMESPACE_BEGIN
+
+//
+// The default minimum size of a range.  Smaller ranges do not read
+// enough bytes to repay the cost of dispatching them to another thread.
+//
+const size_t DefaultMinRangeSize = 1024 * 1024;
+
+//
+// The default number of bytes read by each call to readFullyAt().
+//
+const size_t DefaultBlockSize = 256 * 1024;
+
+//==============================================================================
+// Class: ParallelFileReader::Batch
+//
+// The set of ranges that a read has been divided into.  The ranges are taken
+// in turn by the calling thread and by pooled threads; the Batch counts the
+// ranges that are being read.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ParallelFileReader::Batch : public Monitor
+{
+public:
+	struct Range
+	{
+		FileOffset from;
+		FileOffset end;
+		FileOffset next;
+	};
+
+	typedef std::vector<Range> RangeVector;
+
+	Batch(RandomAccessFile* pFile, size_t blockSize,
+	      FileOffset offset, Byte* pBuffer, BlockHandler* pHandler) :
+		m_rpFile(pFile),
+		m_blockSize(blockSize),
+		m_offset(offset),
+		m_pBuffer(pBuffer),
+		m_pHandler(pHandler),
+		m_nextRange(0),
+		m_active(0) {}
+
+	void addRange(FileOffset from, FileOffset end)
+	{
+		Range range;
+		range.from = range.next = from;
+		range.end = end;
+		m_ranges.push_back(range);
+	}
+
+	void run();
+	void work();
+
+private:
+	class Task;
+
+	bool takeRange(size_t& index);
+	void rangeFinished();
+	void processRange(size_t index);
+
+private:
+	AutoPtr<RandomAccessFile> m_rpFile;
+	size_t m_blockSize;
+	FileOffset m_offset;
+	Byte* m_pBuffer;
+	BlockHandler* m_pHandler;
+	RangeVector m_ranges;
+	size_t m_nextRange;
+	size_t m_active;
+};
+
+#ifdef QC_MT
+
+//==============================================================================
+// Class: ParallelFileReader::Batch::Task
+//
+// Reads ranges of a Batch on a pooled thread.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ParallelFileReader::Batch::Task : public Runnable
+{
+public:
+	Task(Batch* pBatch) : m_rpBatch(pBatch) {}
+
+	virtual void run()
+	{
+		m_rpBatch->work();
+	}
+
+private:
+	AutoPtr<Batch> m_rpBatch;
+};
+
+#endif //QC_MT
+
+//==============================================================================
+// ParallelFileReader::Batch::run
+//
+// Reads every range.  The calling thread takes ranges alongside the pooled
+// threads, so every range is read even if no pooled thread is free, as
+// happens when the caller is itself running on the default ThreadPool.  The
+// caller waits only for ranges that other threads have already started.
+// Ranges that failed are then completed serially, allowing any exception to
+// propagate.
+//==============================================================================
+void ParallelFileReader::Batch::run()
+{
+#ifdef QC_MT
+
+	if(m_ranges.size() > 1)
+	{
+		AutoPtr<ThreadPool> rpPool = ThreadPool::GetDefaultPool();
+
+		for(size_t i=1; i<m_ranges.size(); ++i)
+		{
+			rpPool->execute(new Task(this));
+		}
+
+		//
+		// Tasks that only start once every range has been taken return at once
+		//
+		work();
+
+		QC_SYNCHRONIZED
+		while(m_active)
+		{
+			wait();
+		}
+	}
+
+#endif //QC_MT
+
+	for(size_t i=0; i<m_ranges.size(); ++i)
+	{
+		processRange(i);
+	}
+}
+
+#ifdef QC_MT
+
+//==============================================================================
+// ParallelFileReader::Batch::work
+//
+// Reads ranges until none remain to be taken.  Nothing is thrown: the
+// unread part of a range that fails is completed on the calling thread,
+// and rangeFinished() is called whatever happens.
+//==============================================================================
+void ParallelFileReader::Batch::work()
+{
+	size_t index;
+	while(takeRange(index))
+	{
+		try
+		{
+			processRange(index);
+		}
+		catch(...)
+		{
+			// the rest of the range is read by run()
+		}
+		rangeFinished();
+	}
+}
+
+//==============================================================================
+// ParallelFileReader::Batch::takeRange
+//
+// Returns the index of the next range to be read, or false if every range
+// has been taken.
+//==============================================================================
+bool ParallelFileReader::Batch::takeRange(size_t& index)
+{
+	QC_SYNCHRONIZED
+	if(m_nextRange == m_ranges.size())
+	{
+		return false;
+	}
+	index = m_nextRange++;
+	++m_active;
+	return true;
+}
+
+//==============================================================================
+// ParallelFileReader::Batch::rangeFinished
+//
+//==============================================================================
+void ParallelFileReader::Batch::rangeFinished()
+{
+	QC_SYNCHRONIZED
+	if(--m_active == 0)
+	{
+		notifyAll();
+	}
+}
+
+#endif //QC_MT
+
+//==============================================================================
+// ParallelFileReader::Batch::processRange
+//
+// Reads the unread part of a range one block at a time, either straight into
+// the caller's buffer or into a block buffer that is passed to the handler.
+//==============================================================================
+void ParallelFileReader::Batch::processRange(size_t index)
+{
+	Range& range = m_ranges[index];
+	if(range.next == range.end)
+	{
+		return;
+	}
+
+	if(m_pBuffer)
+	{
+		while(range.next < range.end)
+		{
+			const size_t blockLen = (range.end - range.next < m_blockSize)
+			                      ? size_t(range.end - range.next) : m_blockSize;
+			m_rpFile->readFullyAt(range.next, m_pBuffer + size_t(range.next - m_offset), blockLen);
+			range.next += blockLen;
+		}
+	}
+	else
+	{
+		const size_t bufferSize = (range.end - range.next < m_blockSize)
+		                        ? size_t(range.end - range.next) : m_blockSize;
+		ArrayAutoPtr<Byte> apBlock(new Byte[bufferSize]);
+
+		while(range.next < range.end)
+		{
+			const size_t blockLen = (range.end - range.next < bufferSize)
+			                      ? size_t(range.end - range.next) : bufferSize;
+			m_rpFile->readFullyAt(range.next, apBlock.get(), blockLen);
+			m_pHandler->processBlock(range.next, apBlock.get(), blockLen);
+			range.next += blockLen;
+		}
+	}
+}
+
+//==============================================================================
+// ParallelFileReader::ParallelFileReader
+//
+/**
+   Constructs a ParallelFileReader that reads from @c pFile.
+
+   @param pFile the file to read, which must remain open while this
+          ParallelFileReader is in use
+   @param numThreads the maximum number of threads to use.  If zero, one
+          thread is used for each processor.
+   @throws NullPointerException if @c pFile is null.
+*/
+//==============================================================================
+ParallelFileReader::ParallelFileReader(RandomAccessFile* pFile, size_t numThreads) :
+	m_rpFile(pFile),
+	m_numThreads(numThreads ? numThreads : ThreadPool::GetProcessorCount()),
+	m_minRangeSize(DefaultMinRangeSize),
+	m_blockSize(DefaultBlockSize)
+{
+	if(!pFile) throw NullPointerException();
+}
+
+//==============================================================================
+// ParallelFileReader::read
+//
+/**
+   Reads @c length bytes, starting @c offset bytes from the beginning of the
+   file, into the supplied buffer.
+
+   @param offset the offset within the file of the first byte to read
+   @param pBuffer pointer to a buffer capable of holding at least @c length
+          bytes
+   @param length the number of bytes to read
+   @throws NullPointerException if @c pBuffer is null.
+   @throws IOException if the file ends before @c length bytes have been
+           read, or if an I/O error occurs.
+*/
+//==============================================================================
+void ParallelFileReader::read(FileOffset offset, Byte* pBuffer, size_t length)
+{
+	if(!pBuffer) throw NullPointerException();
+
+	readRanges(offset, length, pBuffer, 0);
+}
+
+//==============================================================================
+// ParallelFileReader::process
+//
+/**
+   Reads @c length bytes, starting @c offset bytes from the beginning of the
+   file, and passes them to @c pHandler in blocks of no more than
+   getBlockSize() bytes.
+
+   Each block is passed to BlockHandler::processBlock() together with its
+   offset within the file.  Blocks from different ranges are passed
+   concurrently from different threads.
+
+   @param offset the offset within the file of the first byte to read
+   @param length the number of bytes to read.  If this is @c FileOffset(-1)
+          the file is read from @c offset to its end.
+   @param pHandler the BlockHandler that receives the blocks
+   @throws NullPointerException if @c pHandler is null.
+   @throws IOException if the file ends before @c length bytes have been
+           read, or if an I/O error occurs.
+   @throws Exception any exception thrown by @c pHandler.
+*/
+//==============================================================================
+void ParallelFileReader::process(FileOffset offset, FileOffset length, BlockHandler* pHandler)
+{
+	if(!pHandler) throw NullPointerException();
+
+	if(length == FileOffset(-1))
+	{
+		const FileOffset fileLength = m_rpFile->length();
+		length = (fileLength > offset) ? fileLength - offset : 0;
+	}
+
+	readRanges(offset, length, 0, pHandler);
+}
+
+//==============================================================================
+// ParallelFileReader::readRanges
+//
+// Divides [offset, offset+length) into at most m_numThreads ranges, each a
+// whole number of blocks and no smaller than the minimum range size, and
+// reads them using a Batch.
+//==============================================================================
+void ParallelFileReader::readRanges(FileOffset offset, FileOffset length,
+                                    Byte* pBuffer, BlockHandler* pHandler)
+{
+	if(!length)
+	{
+		return;
+	}
+
+	const FileOffset maxRanges = length / m_minRangeSize;
+	size_t numRanges = (maxRanges < m_numThreads) ? size_t(maxRanges) : m_numThreads;
+	if(numRanges == 0) numRanges = 1;
+
+	FileOffset rangeSize = (length + numRanges - 1) / numRanges;
+	rangeSize = ((rangeSize + m_blockSize - 1) / m_blockSize) * m_blockSize;
+
+	AutoPtr<Batch> rpBatch = new Batch(m_rpFile.get(), m_blockSize, offset, pBuffer, pHandler);
+
+	const FileOffset end = offset + length;
+	for(FileOffset from = offset; from < end; from += rangeSize)
+
+	{
+		rpBatch->addRange(from, (end - from > rangeSize) ? from + rangeSize : end);
+	}
+
+	rpBatch->run();
+}
+
+//==============================================================================
+// ParallelFileReader::getThreadCount
+//
+/**
+   Returns the maximum number of threads used to read a range of the file.
+*/
+//==============================================================================
+size_t ParallelFileReader::getThreadCount() const
+{
+	return m_numThreads;
+}
+
+//==============================================================================
+// ParallelFileReader::setThreadCount
+//
+/**
+   Sets the maximum number of threads used to read a range of the file.  The
+   range is divided into no more than this number of smaller ranges.
+
+   The ranges are read by the default ThreadPool, which has one thread
+   for each processor; a larger value divides the range more finely but does
+   not increase the number of ranges read at once.
+
+   @param numThreads the maximum number of threads.  If zero, one thread is
+          used for each processor.
+*/
+//==============================================================================
+void ParallelFileReader::setThreadCount(size_t numThreads)
+{
+	m_numThreads = numThreads ? numThreads : ThreadPool::GetProcessorCount();
+}
+
+//==============================================================================
+// ParallelFileReader::getMinRangeSize
+//
+/**
+   Returns the minimum number of bytes in a range.
+*/
+//==============================================================================
+size_t ParallelFileReader::getMinRangeSize() const
+{
+	return m_minRangeSize;
+}
+
+//==============================================================================
+// ParallelFileReader::setMinRangeSize
+//
+/**
+   Sets the minimum number of bytes in a range.  The default is 1MB.
+
+   @param size the minimum range size, which must be greater than zero.
+*/
+//==============================================================================
+void ParallelFileReader::setMinRangeSize(size_t size)
+{
+	m_minRangeSize = size ? size : 1;
+}
+
+//==============================================================================
+// ParallelFileReader::getBlockSize
+//
+/**
+   Returns the number of bytes read at a time.
+*/
+//==============================================================================
+size_t ParallelFileReader::getBlockSize() const
+{
+	return m_blockSize;
+}
+
+//==============================================================================
+// ParallelFileReader::setBlockSize
+//
+/**
+   Sets the number of bytes read at a time, which is also the largest block
+   passed to BlockHandler::processBlock().  The default is 256KB.
+
+   @param size the block size, which must be greater than zero.
+*/
+//==============================================================================
+void ParallelFileReader::setBlockSize(size_t size)
+{
+	m_blockSize = size ? size : 1;
+}
+
+//==============================================================================
+// ParallelFileReader::getFile
+//
+/**
+   Returns the RandomAccessFile that this ParallelFileReader reads from.
+*/
+//==============================================================================
+AutoPtr<RandomAccessFile> ParallelFileReader::getFile() const
+{
+	return m_rpFile;
+}
+
+QC_IO_NAMESPACE_END
+
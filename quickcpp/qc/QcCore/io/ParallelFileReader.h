@@ -0,0 +1,89 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ParallelFileReader
+// 
+// Reads large ranges of a RandomAccessFile by dividing them into smaller
+// ranges which are read concurrently.
+//
+//==============================================================================
+
+#ifndef QC_IO_ParallelFileReader_h
+#define QC_IO_ParallelFileReader_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "RandomAccessFile.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG ParallelFileReader : public virtual QCObject
+{
+public:
+
+	class BlockHandler : public virtual QCObject
+	{
+	public:
+		virtual void processBlock(FileOffset offset, const Byte* pData, size_t length)=0;
+	};
+
+	ParallelFileReader(RandomAccessFile* pFile, size_t numThreads=0);
+
+	void read(FileOffset offset, Byte* pBuffer, size_t length);
+	void process(FileOffset offset, FileOffset length, BlockHandler* pHandler);
+
+	size_t getThreadCount() const;
+	void setThreadCount(size_t numThreads);
+
+	size_t getMinRangeSize() const;
+	void setMinRangeSize(size_t size);
+
+	size_t getBlockSize() const;
+	void setBlockSize(size_t size);
+
+	AutoPtr<RandomAccessFile> getFile() const;
+
+private:
+	ParallelFileReader(const ParallelFileReader& rhs);            // not implemented
+	ParallelFileReader& operator=(const ParallelFileReader& rhs); // not implemented
+
+	class Batch;
+
+	void readRanges(FileOffset offset, FileOffset length, Byte* pBuffer, BlockHandler* pHandler);
+
+
+private:
+	AutoPtr<RandomAccessFile> m_rpFile;
+	size_t m_numThreads;
+	size_t m_minRangeSize;
+	size_t m_blockSize;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_ParallelFileReader_h
+
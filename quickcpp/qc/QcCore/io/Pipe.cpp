@@ -0,0 +1,135 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Pipe
+/**
+	@class qc::io::Pipe
+	
+	@brief A connected pair of streams for passing bytes from one thread to
+	       another.
+
+	Bytes written to a Pipe's PipeOutputStream can be read from its
+	PipeInputStream, in the same order, once they have been written.  A
+	Pipe lets a producer thread stream data to a consumer thread without
+	accumulating it in a ByteArrayOutputStream or sending it through a
+	loopback socket.
+
+	The streams share a circular buffer of fixed capacity.  A Pipe is
+	designed for exactly one thread writing and one thread reading, and in
+	that case no lock is taken while bytes are passed: the reader and writer
+	each publish their position in the buffer with ordered memory accesses.
+	A thread only blocks, on a condition variable, when it reads from an
+	empty pipe or writes to a full one.  Using either stream from more than
+	one thread at a time requires external synchronization.
+
+	The PipeOutputStream also allows a producer to build its output directly
+	in the pipe's buffer with PipeOutputStream::acquireWrite() and
+	PipeOutputStream::commitWrite(), and the PipeInputStream supports
+	readView(), so that neither side need copy the bytes through a buffer of
+	its own.
+
+	Closing the PipeOutputStream causes the reader to receive
+	InputStream::EndOfFile once it has read everything written.  Closing the
+	PipeInputStream causes further writes to throw an IOException.  A
+	stream is closed when it is destroyed, so a consumer thread is not left
+	waiting forever if the producer discards its stream.
+
+	@code
+	AutoPtr<Pipe> rpPipe = new Pipe;
+	AutoPtr<PipeOutputStream> rpOut = rpPipe->getOutputStream();
+	AutoPtr<PipeInputStream> rpIn = rpPipe->getInputStream();
+	// pass rpOut to a producer thread and rpIn to a consumer thread
+	@endcode
+
+	In single-threaded versions of the library, reading from an empty pipe
+	or writing to a full one throws an IOException, as no other thread could
+	ever change its state.
+*/
+//==============================================================================
+
+#include "Pipe.h"
+#include "PipeBuffer.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// Pipe::Pipe
+//
+/**
+   Constructs a Pipe with a buffer of at least @c capacity bytes.
+
+   @param capacity the size of the buffer, which is rounded up to a power of
+          two.  A larger buffer lets the producer run further ahead of the
+          consumer before it has to wait.
+*/
+//==============================================================================
+Pipe::Pipe(size_t capacity)
+{
+	AutoPtr<PipeBuffer> rpBuffer = new PipeBuffer(capacity);
+	m_capacity = rpBuffer->getCapacity();
+	m_rpInputStream = new PipeInputStream(rpBuffer.get());
+	m_rpOutputStream = new PipeOutputStream(rpBuffer.get());
+}
+
+//==============================================================================
+// Pipe::getCapacity
+//
+/**
+   Returns the size of the Pipe's buffer, which is the number of bytes that
+   can be written before anything has to be read.
+*/
+//==============================================================================
+size_t Pipe::getCapacity() const
+{
+	return m_capacity;
+}
+
+//==============================================================================
+// Pipe::getInputStream
+//
+/**
+   Returns the stream from which bytes written to the Pipe are read.  Every
+   call returns the same PipeInputStream.
+*/
+//==============================================================================
+AutoPtr<PipeInputStream> Pipe::getInputStream() const
+{
+	return m_rpInputStream;
+}
+
+//==============================================================================
+// Pipe::getOutputStream
+//
+/**
+   Returns the stream to which bytes are written.  Every call returns the
+   same PipeOutputStream.
+*/
+//==============================================================================
+AutoPtr<PipeOutputStream> Pipe::getOutputStream() const
+{
+	return m_rpOutputStream;
+}
+
+QC_IO_NAMESPACE_END
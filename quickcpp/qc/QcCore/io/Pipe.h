@@ -0,0 +1,65 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Pipe
+// 
+//==============================================================================
+
+#ifndef QC_IO_Pipe_h
+#define QC_IO_Pipe_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "PipeInputStream.h"
+#include "PipeOutputStream.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG Pipe : public virtual QCObject
+{
+public:
+	enum {DefaultCapacity = 65536 /*!< default size of the pipe's buffer */};
+
+	Pipe(size_t capacity=DefaultCapacity);
+
+	size_t getCapacity() const;
+	AutoPtr<PipeInputStream> getInputStream() const;
+	AutoPtr<PipeOutputStream> getOutputStream() const;
+
+private:
+	Pipe(const Pipe& rhs);            // cannot be copied
+	Pipe& operator=(const Pipe& rhs); // nor assigned
+
+private:
+	size_t m_capacity;
+	AutoPtr<PipeInputStream> m_rpInputStream;
+	AutoPtr<PipeOutputStream> m_rpOutputStream;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_Pipe_h
@@ -0,0 +1,378 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PipeBuffer
+//
+// See PipeBuffer.h for an overview.
+//
+// In single-threaded versions of the library nobody else can fill or drain
+// the buffer, so a read from an empty pipe or a write to a full one throws
+// an IOException instead of waiting forever.
+//
+//==============================================================================
+
+#include "PipeBuffer.h"
+#include "IOException.h"
+
+#include "QcCore/base/Atomic.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// PipeBuffer::PipeBuffer
+//
+// The capacity is rounded up to a power of two.
+//==============================================================================
+PipeBuffer::PipeBuffer(size_t capacity) :
+	m_head(0),
+	m_bReaderClosed(false),
+	m_bReaderWaiting(false),
+	m_tail(0),
+	m_bWriterClosed(false),
+	m_bWriterWaiting(false)
+{
+	m_ring.allocate(capacity);
+}
+
+//==============================================================================
+// PipeBuffer::getCapacity
+//
+//==============================================================================
+size_t PipeBuffer::getCapacity() const
+{
+	return m_ring.capacity();
+}
+
+//==============================================================================
+// PipeBuffer::available
+//
+// Returns the number of bytes that can be read without waiting.
+//==============================================================================
+size_t PipeBuffer::available() const
+{
+	return Atomic::LoadAcquire(m_tail) - m_head;
+}
+
+//==============================================================================
+// PipeBuffer::waitForData
+//
+// Waits until there is something to read and returns the number of bytes
+// available.  Zero is returned once the writer has closed its end and every
+// byte has been read.
+//
+// The writer's closed flag is loaded before its offset, so bytes committed
+// before the writer closed are never missed.
+//==============================================================================
+size_t PipeBuffer::waitForData()
+{
+	size_t count = Atomic::LoadAcquire(m_tail) - m_head;
+	if(count)
+	{
+		return count;
+	}
+
+#ifdef QC_MT
+
+	QC_SYNCHRONIZED
+
+	Atomic::StoreRelease(m_bReaderWaiting, true);
+	Atomic::FullBarrier();
+	while(true)
+	{
+		const bool bWriterClosed = Atomic::LoadAcquire(m_bWriterClosed);
+		count = Atomic::LoadAcquire(m_tail) - m_head;
+		if(count || bWriterClosed)
+		{
+			break;
+		}
+		wait();
+	}
+	Atomic::StoreRelease(m_bReaderWaiting, false);
+
+#else
+
+	const bool bWriterClosed = m_bWriterClosed;
+	count = m_tail - m_head;
+	if(!count && !bWriterClosed)
+	{
+		throw IOException(QC_T("pipe is empty and no other thread can write to it"));
+	}
+
+#endif //QC_MT
+
+	return count;
+}
+
+//==============================================================================
+// PipeBuffer::readPointer
+//
+// Returns the address of the next byte to be read, and sets contiguous to the
+// number of bytes that can be addressed from it before the end of the
+// storage.
+//==============================================================================
+const Byte* PipeBuffer::readPointer(size_t& contiguous) const
+{
+	contiguous = m_ring.contiguous(m_head);
+	return m_ring.at(m_head);
+}
+
+//==============================================================================
+// PipeBuffer::readVecs
+//
+// Describes the next len bytes as one block, or as two when they wrap around
+// the end of the storage, and returns the number of blocks.  pVecs must have
+// room for two elements, and the caller must have established that len bytes
+// are available.
+//==============================================================================
+size_t PipeBuffer::readVecs(size_t len, IoVec* pVecs) const
+{
+	const size_t contiguous = m_ring.contiguous(m_head);
+	pVecs[0].pData = m_ring.at(m_head);
+	if(len <= contiguous)
+	{
+		pVecs[0].length = len;
+		return 1;
+	}
+	pVecs[0].length = contiguous;
+	pVecs[1].pData = m_ring.at(m_head + contiguous);
+	pVecs[1].length = len - contiguous;
+	return 2;
+}
+
+//==============================================================================
+// PipeBuffer::copyOut
+//
+// Copies the next len bytes to pDest without consuming them.  The caller
+// must have established that len bytes are available.
+//==============================================================================
+void PipeBuffer::copyOut(Byte* pDest, size_t len) const
+{
+	m_ring.copyOut(m_head, pDest, len);
+}
+
+//==============================================================================
+// PipeBuffer::consume
+//
+// Releases the next len bytes to the writer, waking it if it is waiting for
+// space.
+//==============================================================================
+void PipeBuffer::consume(size_t len)
+{
+	Atomic::StoreRelease(m_head, m_head + len);
+
+#ifdef QC_MT
+	Atomic::FullBarrier();
+	if(Atomic::LoadAcquire(m_bWriterWaiting))
+	{
+		QC_SYNCHRONIZED
+		notifyAll();
+	}
+#endif //QC_MT
+}
+
+//==============================================================================
+// PipeBuffer::closeRead
+//
+// Called when the reader closes its end.  A writer waiting for space is woken
+// so that it can report that the pipe is closed.
+//==============================================================================
+void PipeBuffer::closeRead()
+{
+	Atomic::StoreRelease(m_bReaderClosed, true);
+
+#ifdef QC_MT
+	QC_SYNCHRONIZED
+	notifyAll();
+#endif //QC_MT
+}
+
+//==============================================================================
+// PipeBuffer::space
+//
+// Returns the number of bytes that can be written without waiting.
+//==============================================================================
+size_t PipeBuffer::space() const
+{
+	return m_ring.capacity() - (m_tail - Atomic::LoadAcquire(m_head));
+}
+
+//==============================================================================
+// PipeBuffer::waitForSpace
+//
+// Waits until there is room to write and returns the number of bytes that
+// can be written.
+//
+// Throws IOException if the reader has closed its end, as nothing written
+// could ever be read.
+//==============================================================================
+size_t PipeBuffer::waitForSpace()
+{
+	if(Atomic::LoadAcquire(m_bReaderClosed))
+	{
+		throw IOException(QC_T("pipe is closed for reading"));
+	}
+
+	size_t space = m_ring.capacity() - (m_tail - Atomic::LoadAcquire(m_head));
+	if(space)
+	{
+		return space;
+	}
+
+#ifdef QC_MT
+
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+
+		Atomic::StoreRelease(m_bWriterWaiting, true);
+		Atomic::FullBarrier();
+		while(!Atomic::LoadAcquire(m_bReaderClosed) &&
+		      (space = m_ring.capacity() - (m_tail - Atomic::LoadAcquire(m_head))) == 0)
+		{
+			wait();
+		}
+		Atomic::StoreRelease(m_bWriterWaiting, false);
+	}
+
+	if(!space)
+	{
+		throw IOException(QC_T("pipe is closed for reading"));
+	}
+
+#else
+
+	throw IOException(QC_T("pipe is full and no other thread can read from it"));
+
+#endif //QC_MT
+
+	return space;
+}
+
+//==============================================================================
+// PipeBuffer::waitForEmpty
+//
+// Waits until the reader has consumed every byte committed so far.
+//
+// Throws IOException if the reader closes its end first.
+//==============================================================================
+void PipeBuffer::waitForEmpty()
+{
+	if(Atomic::LoadAcquire(m_head) == m_tail)
+	{
+		return;
+	}
+
+#ifdef QC_MT
+
+	bool bEmpty;
+
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+
+		Atomic::StoreRelease(m_bWriterWaiting, true);
+		Atomic::FullBarrier();
+		while(!(bEmpty = (Atomic::LoadAcquire(m_head) == m_tail)) &&
+		      !Atomic::LoadAcquire(m_bReaderClosed))
+		{
+			wait();
+		}
+		Atomic::StoreRelease(m_bWriterWaiting, false);
+	}
+
+	if(!bEmpty)
+	{
+		throw IOException(QC_T("pipe is closed for reading"));
+	}
+
+#else
+
+	throw IOException(QC_T("pipe is not empty and no other thread can read from it"));
+
+#endif //QC_MT
+}
+
+//==============================================================================
+// PipeBuffer::writePointer
+//
+
+// Returns the address at which the next byte will be written, and sets
+// contiguous to the number of bytes that can be addressed from it before the
+// end of the storage.
+//==============================================================================
+Byte* PipeBuffer::writePointer(size_t& contiguous)
+{
+	contiguous = m_ring.contiguous(m_tail);
+	return m_ring.at(m_tail);
+}
+
+//==============================================================================
+// PipeBuffer::copyIn
+//
+// Copies len bytes from pSrc into the free space without publishing them.
+// The caller must have established that there is room for len bytes.
+//==============================================================================
+void PipeBuffer::copyIn(const Byte* pSrc, size_t len)
+{
+	m_ring.copyIn(m_tail, pSrc, len);
+}
+
+//==============================================================================
+// PipeBuffer::commit
+//
+// Publishes the next len bytes to the reader, waking it if it is waiting for
+// data.
+//==============================================================================
+void PipeBuffer::commit(size_t len)
+{
+	Atomic::StoreRelease(m_tail, m_tail + len);
+
+#ifdef QC_MT
+	Atomic::FullBarrier();
+	if(Atomic::LoadAcquire(m_bReaderWaiting))
+	{
+		QC_SYNCHRONIZED
+		notifyAll();
+	}
+#endif //QC_MT
+}
+
+//==============================================================================
+// PipeBuffer::closeWrite
+//
+// Called when the writer closes its end.  The reader sees end of file once
+// it has read everything committed before this call.
+//==============================================================================
+void PipeBuffer::closeWrite()
+{
+	Atomic::StoreRelease(m_bWriterClosed, true);
+
+#ifdef QC_MT
+	QC_SYNCHRONIZED
+	notifyAll();
+#endif //QC_MT
+}
+
+QC_IO_NAMESPACE_END
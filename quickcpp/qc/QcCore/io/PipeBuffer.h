@@ -0,0 +1,118 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PipeBuffer
+// 
+// Overview
+// --------
+// The ring buffer shared by the two ends of a Pipe, and by an
+// AsyncFileOutputStream and its writer thread.
+//
+// The buffer is designed for exactly one reader and one writer.  The read
+// offset (m_head) is only changed by the reader and the write offset
+// (m_tail) only by the writer; each side publishes its offset with a
+// release store and reads the other side's offset with an acquire load, so
+// bytes are passed between threads without taking a lock.
+//
+// The Monitor's lock is only taken when one side has to wait: the reader
+// because the buffer is empty, or the writer because it is full or because
+// it is waiting for the reader to empty it.  The waiting side sets a flag
+// before checking the buffer again, and the other side checks the flag after
+// publishing its offset, with a full barrier between the store and the load
+// on both sides, so a wake-up cannot be missed.  When nobody is waiting, the
+// only cost of synchronization is that barrier.
+//
+// The reader's and writer's fields are kept on separate cache lines so
+// that the two threads do not contend for the same line.
+//
+// This is an internal class and is not exported from the library.
+//
+//==============================================================================
+
+#ifndef QC_IO_PipeBuffer_h
+#define QC_IO_PipeBuffer_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "IoVec.h"
+#include "RingBuffer.h"
+
+#include "QcCore/base/Monitor.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class PipeBuffer : public Monitor
+{
+public:
+	PipeBuffer(size_t capacity);
+
+	size_t getCapacity() const;
+
+	// Called by the reader...
+	size_t available() const;
+	size_t waitForData();
+	const Byte* readPointer(size_t& contiguous) const;
+	size_t readVecs(size_t len, IoVec* pVecs) const;
+	void copyOut(Byte* pDest, size_t len) const;
+	void consume(size_t len);
+	void closeRead();
+
+	// Called by the writer...
+	size_t space() const;
+	size_t waitForSpace();
+	void waitForEmpty();
+
+	Byte* writePointer(size_t& contiguous);
+	void copyIn(const Byte* pSrc, size_t len);
+	void commit(size_t len);
+	void closeWrite();
+
+private:
+	PipeBuffer(const PipeBuffer& rhs);            // cannot be copied
+	PipeBuffer& operator=(const PipeBuffer& rhs); // nor assigned
+
+	enum {CacheLineSize = 64};
+
+private:
+	RingBuffer<Byte> m_ring;
+
+	Byte m_readerPad[CacheLineSize];
+	volatile size_t m_head;
+	volatile bool m_bReaderClosed;
+	volatile bool m_bReaderWaiting;
+
+	Byte m_writerPad[CacheLineSize];
+	volatile size_t m_tail;
+	volatile bool m_bWriterClosed;
+	volatile bool m_bWriterWaiting;
+
+	Byte m_endPad[CacheLineSize];
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_PipeBuffer_h
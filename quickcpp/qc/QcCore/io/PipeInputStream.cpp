@@ -0,0 +1,211 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PipeInputStream
+/**
+	@class qc::io::PipeInputStream
+	
+	@brief The reading end of a Pipe.
+
+	A PipeInputStream is obtained from Pipe::getInputStream().  read() waits
+	until at least one byte is available and then returns as many as are
+	available, up to the size of the caller's buffer.  It returns
+	InputStream::EndOfFile once the PipeOutputStream has been closed and
+	every byte written to it has been read.
+
+	readView() returns bytes in place in the pipe's buffer.  They are not
+	released to the writer until the next operation on the stream, so the
+	writer cannot overwrite them while they are being used.
+
+	@sa Pipe
+*/
+//==============================================================================
+
+#include "PipeInputStream.h"
+#include "IOException.h"
+#include "PipeBuffer.h"
+
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/SystemUtils.h"
+
+#include <limits.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+PipeInputStream::PipeInputStream(PipeBuffer* pBuffer) :
+	m_rpBuffer(pBuffer),
+	m_viewLen(0)
+{
+}
+
+//==============================================================================
+// PipeInputStream::~PipeInputStream
+//
+/**
+   Destructor.  Closes the stream, so that a writer is not left waiting for
+   space that will never become free.
+*/
+//==============================================================================
+PipeInputStream::~PipeInputStream()
+{
+	close();
+}
+
+//==============================================================================
+// PipeInputStream::available
+//
+/**
+   Returns the number of bytes that can be read without blocking.
+   @throws IOException if the stream is closed.
+*/
+//==============================================================================
+size_t PipeInputStream::available()
+{
+	if(!m_rpBuffer) throw IOException(QC_T("stream is closed"));
+
+	return m_rpBuffer->available() - m_viewLen;
+}
+
+//==============================================================================
+// PipeInputStream::close
+//
+/**
+   Closes the reading end of the Pipe.  Subsequent writes to the
+   PipeOutputStream throw an IOException.
+*/
+//==============================================================================
+void PipeInputStream::close()
+{
+	if(m_rpBuffer)
+	{
+		m_rpBuffer->closeRead();
+		m_rpBuffer.release();
+		m_viewLen = 0;
+	}
+}
+
+//==============================================================================
+// PipeInputStream::read
+//
+/**
+   Reads up to @c bufLen bytes into the buffer at @c pBuffer, waiting until
+   at least one byte is available or the PipeOutputStream is closed.
+
+   @param pBuffer the buffer to receive the bytes
+   @param bufLen the size of the buffer
+   @returns the number of bytes read or InputStream::EndOfFile.
+   @throws IOException if the stream is closed.
+*/
+//==============================================================================
+long PipeInputStream::read(Byte* pBuffer, size_t bufLen)
+{
+	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
+
+	if(!m_rpBuffer) throw IOException(QC_T("stream is closed"));
+
+	releaseView();
+
+	const size_t bytesAvailable = m_rpBuffer->waitForData();
+	if(!bytesAvailable)
+	{
+		return EndOfFile;
+	}
+
+	size_t count = (bufLen < bytesAvailable) ? bufLen : bytesAvailable;
+	if(count > LONG_MAX) count = LONG_MAX;
+
+	m_rpBuffer->copyOut(pBuffer, count);
+	m_rpBuffer->consume(count);
+	return count;
+}
+
+//==============================================================================
+// PipeInputStream::readView
+//
+/**
+   Returns a pointer to up to @c maxLen bytes in the pipe's buffer without
+   copying them, waiting until at least one byte is available or the
+   PipeOutputStream is closed.
+
+   Fewer bytes than are available may be returned when they wrap around the
+   end of the buffer.  The bytes remain valid until the next operation on
+   the stream.
+
+   @sa InputStream::readView()
+*/
+//==============================================================================
+long PipeInputStream::readView(const Byte*& pData, size_t maxLen)
+{
+	if(!maxLen) throw IllegalArgumentException(QC_T("zero buffer length"));
+	if(maxLen > LONG_MAX) maxLen = LONG_MAX;
+
+	if(!m_rpBuffer) throw IOException(QC_T("stream is closed"));
+
+	releaseView();
+
+	const size_t bytesAvailable = m_rpBuffer->waitForData();
+	if(!bytesAvailable)
+	{
+		return EndOfFile;
+	}
+
+	size_t contiguous;
+	pData = m_rpBuffer->readPointer(contiguous);
+
+	size_t count = (maxLen < bytesAvailable) ? maxLen : bytesAvailable;
+	if(count > contiguous) count = contiguous;
+
+	m_viewLen = count;
+	return count;
+}
+
+//==============================================================================
+// PipeInputStream::viewSupported
+//
+/**
+   Returns @c true for PipeInputStream.
+   @sa readView()
+*/
+//==============================================================================
+bool PipeInputStream::viewSupported() const
+{
+	return true;
+}
+
+//==============================================================================
+// PipeInputStream::releaseView
+//
+// Releases the bytes returned by the last call to readView() to the writer.
+//==============================================================================
+void PipeInputStream::releaseView()
+{
+	if(m_viewLen)
+	{
+		m_rpBuffer->consume(m_viewLen);
+		m_viewLen = 0;
+	}
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,78 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PipeInputStream
+// 
+//==============================================================================
+
+#ifndef QC_IO_PipeInputStream_h
+#define QC_IO_PipeInputStream_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "InputStream.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class Pipe;
+class PipeBuffer;
+
+class QC_IO_PKG PipeInputStream : public InputStream
+{
+	friend class Pipe;
+
+public:
+	virtual ~PipeInputStream();
+
+	virtual size_t available();
+	virtual void close();
+
+#ifdef QC_USING_DECL_BROKEN
+	virtual int read() {return InputStream::read();}
+#else
+	using InputStream::read; 	// unhide inherited read methods
+#endif
+
+	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual long readView(const Byte*& pData, size_t maxLen);
+	virtual bool viewSupported() const;
+
+private:
+	PipeInputStream(PipeBuffer* pBuffer);
+	PipeInputStream(const PipeInputStream& rhs);            // cannot be copied
+	PipeInputStream& operator=(const PipeInputStream& rhs); // nor assigned
+
+	void releaseView();
+
+private:
+	AutoPtr<PipeBuffer> m_rpBuffer;
+	size_t m_viewLen;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_PipeInputStream_h
@@ -0,0 +1,186 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PipeOutputStream
+/**
+	@class qc::io::PipeOutputStream
+	
+	@brief The writing end of a Pipe.
+
+	A PipeOutputStream is obtained from Pipe::getOutputStream().  write()
+	copies bytes into the pipe's buffer, waiting whenever the buffer is full
+	for the reader to make room.  Bytes become readable as soon as each
+	write() returns, so there is nothing for flush() to do.
+
+	A producer that generates its output in pieces can avoid copying it by
+	writing directly into the pipe's buffer:
+
+	@code
+	size_t available;
+	Byte* pSpace = rpOut->acquireWrite(available);
+	size_t len = produce(pSpace, available);
+	rpOut->commitWrite(len);
+	@endcode
+
+	@sa Pipe
+*/
+//==============================================================================
+
+#include "PipeOutputStream.h"
+#include "IOException.h"
+#include "PipeBuffer.h"
+
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/SystemUtils.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+PipeOutputStream::PipeOutputStream(PipeBuffer* pBuffer) :
+	m_rpBuffer(pBuffer),
+	m_acquired(0)
+{
+}
+
+//==============================================================================
+// PipeOutputStream::~PipeOutputStream
+//
+/**
+   Destructor.  Closes the stream, so that the reader receives end of file
+   rather than waiting forever.
+*/
+//==============================================================================
+PipeOutputStream::~PipeOutputStream()
+{
+	close();
+}
+
+//==============================================================================
+// PipeOutputStream::close
+//
+/**
+   Closes the writing end of the Pipe.  The PipeInputStream returns
+   InputStream::EndOfFile once it has read the bytes already written.  Space
+   obtained from acquireWrite() and not committed is discarded.
+*/
+//==============================================================================
+void PipeOutputStream::close()
+{
+	if(m_rpBuffer)
+	{
+		m_rpBuffer->closeWrite();
+		m_rpBuffer.release();
+		m_acquired = 0;
+	}
+}
+
+//==============================================================================
+// PipeOutputStream::write
+//
+/**
+   Writes @c bufLen bytes from @c pBuffer to the Pipe, waiting for the reader
+   to make room whenever the pipe's buffer is full.
+
+   @param pBuffer the bytes to write
+   @param bufLen the number of bytes to write
+   @throws IOException if the stream is closed, or if the PipeInputStream is
+           closed before every byte has been written.
+*/
+//==============================================================================
+void PipeOutputStream::write(const Byte* pBuffer, size_t bufLen)
+{
+	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
+
+	if(!m_rpBuffer) throw IOException(QC_T("stream is closed"));
+
+	m_acquired = 0;
+
+	while(bufLen)
+	{
+		const size_t space = m_rpBuffer->waitForSpace();
+		const size_t count = (bufLen < space) ? bufLen : space;
+		m_rpBuffer->copyIn(pBuffer, count);
+		m_rpBuffer->commit(count);
+		pBuffer += count;
+		bufLen -= count;
+	}
+}
+
+//==============================================================================
+// PipeOutputStream::acquireWrite
+//
+/**
+   Returns space in the pipe's buffer into which the caller can write bytes
+   directly, waiting until some space is free.
+
+   The bytes written are not visible to the reader until they are committed
+   by commitWrite().  The space may be smaller than the free space in the
+   buffer when it would otherwise wrap around the end of the buffer.
+
+   @param available set to the number of bytes that may be written at the
+          returned address
+   @returns the address at which to write.
+   @throws IOException if the stream or the PipeInputStream is closed.
+   @sa commitWrite()
+*/
+//==============================================================================
+Byte* PipeOutputStream::acquireWrite(size_t& available)
+{
+	if(!m_rpBuffer) throw IOException(QC_T("stream is closed"));
+
+	const size_t space = m_rpBuffer->waitForSpace();
+	size_t contiguous;
+	Byte* pSpace = m_rpBuffer->writePointer(contiguous);
+
+	m_acquired = (space < contiguous) ? space : contiguous;
+	available = m_acquired;
+	return pSpace;
+}
+
+//==============================================================================
+// PipeOutputStream::commitWrite
+//
+/**
+   Makes the first @c len bytes of the space returned by the last call to
+   acquireWrite() available to the reader.
+
+   @param len the number of bytes written, which may be zero
+   @throws IllegalArgumentException if @c len exceeds the space acquired.
+   @throws IOException if the stream is closed.
+   @sa acquireWrite()
+*/
+//==============================================================================
+void PipeOutputStream::commitWrite(size_t len)
+{
+	if(!m_rpBuffer) throw IOException(QC_T("stream is closed"));
+	if(len > m_acquired) throw IllegalArgumentException(QC_T("length exceeds the space acquired"));
+
+	m_acquired = 0;
+	if(len)
+	{
+		m_rpBuffer->commit(len);
+	}
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,76 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PipeOutputStream
+// 
+//==============================================================================
+
+#ifndef QC_IO_PipeOutputStream_h
+#define QC_IO_PipeOutputStream_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "OutputStream.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class Pipe;
+class PipeBuffer;
+
+class QC_IO_PKG PipeOutputStream : public OutputStream
+{
+	friend class Pipe;
+
+public:
+	virtual ~PipeOutputStream();
+
+	virtual void close();
+
+#ifdef QC_USING_DECL_BROKEN
+	virtual void write(Byte x) {OutputStream::write(x);}
+#else
+	using OutputStream::write; 	// unhide inherited write methods
+#endif
+
+	virtual void write(const Byte* pBuffer, size_t bufLen);
+
+	Byte* acquireWrite(size_t& available);
+	void commitWrite(size_t len);
+
+private:
+	PipeOutputStream(PipeBuffer* pBuffer);
+	PipeOutputStream(const PipeOutputStream& rhs);            // cannot be copied
+	PipeOutputStream& operator=(const PipeOutputStream& rhs); // nor assigned
+
+private:
+	AutoPtr<PipeBuffer> m_rpBuffer;
+	size_t m_acquired;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_PipeOutputStream_h
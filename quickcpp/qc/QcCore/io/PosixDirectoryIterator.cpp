@@ -0,0 +1,273 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PosixDirectoryIterator
+//
+// The directory is opened by PosixFileSystem::openDirectory() and read with
+// readdir() a batch of entries at a time.  Where the platform supports it,
+// the type of each entry is taken from the d_type field so that no stat()
+// is needed to tell files from directories.  When the status of an entry is
+// required it is fetched with fstatat() relative to the open directory,
+// which avoids resolving the entry's full path name.
+//
+// When the FetchStatus flag is given, each batch of names is read first and
+// the entries are then stat'ed one after another, keeping the directory
+// reads and the inode lookups apart.
+//
+//==============================================================================
+
+#ifndef WIN32
+
+#include "PosixDirectoryIterator.h"
+#include "FileNotFoundException.h"
+#include "IOException.h"
+
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/base/SystemUtils.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+//
+// The number of entries read from the directory by each call to readBatch()
+//
+const size_t BatchSize = 64;
+
+//==============================================================================
+// TypeFromMode
+//
+// Translates the file type bits of a stat mode.
+//==============================================================================
+static DirectoryIterator::EntryType TypeFromMode(mode_t mode)
+{
+	if(S_ISREG(mode)) return DirectoryIterator::RegularFile;
+	if(S_ISDIR(mode)) return DirectoryIterator::Directory;
+	if(S_ISLNK(mode)) return DirectoryIterator::SymbolicLink;
+	return DirectoryIterator::Other;
+}
+
+PosixDirectoryIterator::PosixDirectoryIterator(const String& path, void* pDir, int flags) :
+	DirectoryIterator(path),
+	m_pDir(pDir),
+	m_flags(flags),
+	m_batchPos(0)
+{
+	m_batch.reserve(BatchSize);
+}
+
+PosixDirectoryIterator::~PosixDirectoryIterator()
+{
+	close();
+}
+
+//==============================================================================
+// PosixDirectoryIterator::next
+//
+//==============================================================================
+bool PosixDirectoryIterator::next()
+{
+	if(m_batchPos == m_batch.size())
+	{
+		readBatch();
+		if(m_batch.empty())
+		{
+			return false;
+		}
+	}
+
+	const Entry& entry = m_batch[m_batchPos++];
+	setEntry(StringUtils::FromNativeMBCS(entry.name.c_str()), entry.type);
+	if(entry.bStatusKnown)
+	{
+		setStatus(entry.statusType, entry.length, entry.lastModified);
+	}
+	return true;
+}
+
+//==============================================================================
+// PosixDirectoryIterator::close
+//
+//==============================================================================
+void PosixDirectoryIterator::close()
+{
+	if(m_pDir)
+	{
+		::closedir(static_cast<DIR*>(m_pDir));
+		m_pDir = 0;
+	}
+	m_batch.clear();
+	m_batchPos = 0;
+}
+
+//==============================================================================
+// PosixDirectoryIterator::readBatch
+//
+// Replaces the current batch with up to BatchSize further entries, skipping
+// "." and "..".  The batch is empty once the end of the directory has been
+// reached.
+//==============================================================================
+void PosixDirectoryIterator::readBatch()
+{
+	m_batch.clear();
+	m_batchPos = 0;
+
+	if(!m_pDir)
+	{
+		return;
+	}
+
+	DIR* pDir = static_cast<DIR*>(m_pDir);
+
+	while(m_batch.size() < BatchSize)
+	{
+		errno = 0;
+		struct dirent* pDirEntry = ::readdir(pDir);
+		if(!pDirEntry)
+		{
+			if(errno != 0)
+			{
+				String errMsg = getDirectoryPath() + QC_T(" (");
+				errMsg += SystemUtils::GetSystemErrorString(errno);
+				errMsg += QC_T(")");
+				throw IOException(errMsg);
+			}
+			break;
+		}
+
+		const char* pName = pDirEntry->d_name;
+		if(pName[0] == '.' && (pName[1] == 0 || (pName[1] == '.' && pName[2] == 0)))
+		{
+			continue;
+		}
+
+		m_batch.resize(m_batch.size()+1);
+		Entry& entry = m_batch.back();
+		entry.name = pName;
+		entry.type = Unknown;
+		entry.bStatusKnown = false;
+		entry.length = 0;
+
+#if defined(DT_DIR)
+		switch(pDirEntry->d_type)
+		{
+		case DT_REG: entry.type = RegularFile;  break;
+		case DT_DIR: entry.type = Directory;    break;
+		case DT_LNK: entry.type = SymbolicLink; break;
+		case DT_UNKNOWN:                        break;
+		default:     entry.type = Other;        break;
+		}
+#endif //DT_DIR
+	}
+
+	if(m_flags & FetchStatus)
+	{
+		//
+		// An entry that cannot be stat'ed now, perhaps because it has been
+		// removed, is left for fetchStatus() to report if it is asked for
+		//
+		for(size_t i=0; i<m_batch.size(); ++i)
+		{
+			Entry& entry = m_batch[i];
+			int errCode;
+			entry.bStatusKnown = statEntry(entry.name, entry.statusType, entry.length,
+			                               entry.lastModified, errCode);
+		}
+	}
+}
+
+//==============================================================================
+// PosixDirectoryIterator::statEntry
+//
+// Fetches the status of the named entry without following symbolic links.
+// Returns false and sets errCode if it cannot be fetched.
+//==============================================================================
+bool PosixDirectoryIterator::statEntry(const ByteString& name, EntryType& type,
+                                       size_t& length, DateTime& lastModified,
+                                       int& errCode) const
+{
+	struct stat myStat;
+
+#if defined(AT_SYMLINK_NOFOLLOW)
+	const int rc = ::fstatat(::dirfd(static_cast<DIR*>(m_pDir)), name.c_str(),
+	                         &myStat, AT_SYMLINK_NOFOLLOW);
+#else
+	ByteString path = StringUtils::ToNativeMBCS(getDirectoryPath());
+	path += '/';
+	path += name;
+	const int rc = ::lstat(path.c_str(), &myStat);
+#endif //AT_SYMLINK_NOFOLLOW
+
+	if(rc != 0)
+	{
+		errCode = errno;
+		return false;
+	}
+
+	type = TypeFromMode(myStat.st_mode);
+	length = myStat.st_size;
+	lastModified = DateTime::FromAnsiTime(myStat.st_mtime, 0 /*no uSeconds*/);
+	return true;
+}
+
+//==============================================================================
+// PosixDirectoryIterator::fetchStatus
+//
+//==============================================================================
+void PosixDirectoryIterator::fetchStatus()
+{
+	if(!m_pDir || m_batchPos == 0)
+	{
+		throw IOException(QC_T("directory is closed"));
+	}
+
+	EntryType type = Unknown;
+	size_t length = 0;
+	DateTime lastModified;
+	int errCode = 0;
+
+	if(statEntry(m_batch[m_batchPos-1].name, type, length, lastModified, errCode))
+	{
+		setStatus(type, length, lastModified);
+	}
+	else if(errCode == ENOENT)
+	{
+		throw FileNotFoundException(getPath());
+	}
+	else
+	{
+		String errMsg = getPath() + QC_T(" (");
+		errMsg += SystemUtils::GetSystemErrorString(errCode);
+		errMsg += QC_T(")");
+		throw IOException(errMsg);
+	}
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //WIN32
@@ -0,0 +1,81 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PosixDirectoryIterator
+// 
+//==============================================================================
+
+#ifndef QC_IO_PosixDirectoryIterator_h
+#define QC_IO_PosixDirectoryIterator_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "DirectoryIterator.h"
+
+#include <vector>
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG PosixDirectoryIterator : public DirectoryIterator
+{
+public:
+	PosixDirectoryIterator(const String& path, void* pDir, int flags);
+	virtual ~PosixDirectoryIterator();
+
+	virtual bool next();
+	virtual void close();
+
+protected:
+	virtual void fetchStatus();
+
+private:
+	struct Entry
+	{
+		ByteString name;
+		EntryType type;
+		bool bStatusKnown;
+		EntryType statusType;
+		size_t length;
+		DateTime lastModified;
+	};
+
+	typedef std::vector<Entry> EntryVector;
+
+	void readBatch();
+	bool statEntry(const ByteString& name, EntryType& type, size_t& length,
+	               DateTime& lastModified, int& errCode) const;
+
+private:
+	void* m_pDir;
+	int m_flags;
+	EntryVector m_batch;
+	size_t m_batchPos;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_PosixDirectoryIterator_h
@@ -28,7 +28,9 @@
 #include "FileNotFoundException.h"
 #include "ExistingFileException.h"
 #include "IOException.h"
+#include "PosixDirectoryIterator.h"
 #include "PosixFileDescriptor.h"
+#include "PosixMappedByteBuffer.h"
 
 #include "QcCore/base/IllegalArgumentException.h"
 #include "QcCore/base/Tracer.h"
@@ -50,11 +52,14 @@
 #else
 #include <dirent.h>
 #include <utime.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
 #endif //WIN32
 
 QC_IO_NAMESPACE_BEGIN
 
 const size_t MaxPathLen = 256;
+const size_t MaxIoVecs = 64;  // blocks passed to each writev() call
 const String sNull;
 
 //==============================================================================
@@ -90,6 +95,34 @@ CharType PosixFileSystem::getSeparatorChar() const
 	return '/';
 }
 
+//==============================================================================
+// AttributesFromMode
+//
+// Translates the mode of a file into FileSystem::Attribute flags.
+//==============================================================================
+static int AttributesFromMode(mode_t mode)
+{
+	int ret = FileSystem::Exists;
+	if(S_ISDIR(mode))          ret |= FileSystem::Directory;
+	if(S_ISREG(mode))          ret |= FileSystem::RegularFile;
+	if((mode & S_IWUSR)==0)    ret |= FileSystem::ReadOnly;
+	return ret;
+}
+
+//==============================================================================
+// AccessModesFromMode
+//
+// Translates the mode of a file into the FileSystem::AccessMode flags that
+// checkAccess() would report.
+//==============================================================================
+static int AccessModesFromMode(mode_t mode)
+{
+	int ret = 0;
+	if(mode & S_IRUSR) ret |= FileSystem::ReadAccess;
+	if(mode & S_IWUSR) ret |= FileSystem::WriteAccess;
+	return ret;
+}
+
 //==============================================================================
 // PosixFileSystem::getFileAttributeFlags
 //
@@ -100,15 +133,56 @@ int PosixFileSystem::getFileAttributeFlags(const String& path) const
 	struct stat myStat;
 	if(::stat(GetPosixFilename(path).c_str(), &myStat) == 0)
 	{
-		int ret = Exists;
-		if(myStat.st_mode & S_IFDIR)       ret |= Directory;
-		if(myStat.st_mode & S_IFREG)       ret |= RegularFile;
-		if((myStat.st_mode & S_IWUSR)==0)  ret |= ReadOnly;
-		return ret;
+		return AttributesFromMode(myStat.st_mode);
 	}
 	return 0;
 }
 
+//==============================================================================
+// PosixFileSystem::getFileStatus
+//
+// Obtains the status with a single statx() call where the C library
+// provides it, asking only for the fields that a FileStatus holds.  Kernels
+// that predate statx(), and sandboxes that refuse it, fail the call with
+// something other than ENOENT or ENOTDIR, in which case stat() is used
+// instead.
+//
+// The modification time is truncated to whole seconds so that it agrees
+// with getLastModifiedTime().
+//
+// Does not throw any exceptions
+//==============================================================================
+FileStatus PosixFileSystem::getFileStatus(const String& path) const
+{
+	const ByteString posixPath = GetPosixFilename(path);
+
+#if defined(STATX_BASIC_STATS)
+	struct statx myStatx;
+	if(::statx(AT_FDCWD, posixPath.c_str(), 0,
+	           STATX_TYPE | STATX_MODE | STATX_SIZE | STATX_MTIME, &myStatx) == 0)
+	{
+		const mode_t mode = myStatx.stx_mode;
+		return FileStatus(AttributesFromMode(mode), AccessModesFromMode(mode),
+		                  size_t(myStatx.stx_size),
+		                  DateTime::FromAnsiTime(long(myStatx.stx_mtime.tv_sec), 0 /*no uSeconds*/));
+	}
+	else if(errno == ENOENT || errno == ENOTDIR)
+	{
+		return FileStatus();
+	}
+#endif //STATX_BASIC_STATS
+
+	struct stat myStat;
+	if(::stat(posixPath.c_str(), &myStat) == 0)
+	{
+		const mode_t mode = myStat.st_mode;
+		return FileStatus(AttributesFromMode(mode), AccessModesFromMode(mode),
+		                  myStat.st_size,
+		                  DateTime::FromAnsiTime(myStat.st_mtime, 0 /*no uSeconds*/));
+	}
+	return FileStatus();
+}
+
 //==============================================================================
 // PosixFileSystem::checkAccess
 //
@@ -297,9 +371,12 @@ AutoPtr<FileDescriptor> PosixFileSystem::openFile(const String& path,
 		case OpenCreateTruncate:
 			flags |= O_CREAT | O_TRUNC;
 			break;
+		case OpenCreate:
+			flags |= O_CREAT;
+			break;
 	}
 
-	if(creationDisp == OpenCreateExclusive || creationDisp == OpenCreateTruncate)
+	if(creationDisp != OpenExisting)
 	{
 		if(attributes & ReadOnly)
 			permissionFlags = S_IRUSR;
@@ -314,8 +391,30 @@ AutoPtr<FileDescriptor> PosixFileSystem::openFile(const String& path,
 
 	}
 
+#if defined(O_DIRECT)
+	if(accessMode & DirectAccess) flags |= O_DIRECT;
+#endif //O_DIRECT
+
 	int fd = ::open(GetPosixFilename(path).c_str(), flags, permissionFlags);
 
+#if defined(O_DIRECT)
+	//
+	// File systems that cannot bypass the cache refuse O_DIRECT with EINVAL,
+	// and the file is then opened normally.  The check is made after the
+	// file has been created, so an exclusive create must not be repeated.
+	//
+	if(fd == -1 && errno == EINVAL && (flags & O_DIRECT))
+	{
+		flags &= ~(O_DIRECT | O_EXCL);
+		fd = ::open(GetPosixFilename(path).c_str(), flags, permissionFlags);
+	}
+#elif defined(F_NOCACHE)
+	if(fd != -1 && (accessMode & DirectAccess))
+	{
+		::fcntl(fd, F_NOCACHE, 1);
+	}
+#endif //O_DIRECT
+
 	if(Tracer::IsEnabled())
 	{
 		String traceMsg = QC_T("open: ");
@@ -395,6 +494,25 @@ std::list<String> PosixFileSystem::listDirectory(const String& path) const
 	return ret;
 }
 
+//==============================================================================
+// PosixFileSystem::openDirectory
+//
+// The DIR stream is owned by the PosixDirectoryIterator, which closes it.
+//==============================================================================
+AutoPtr<DirectoryIterator> PosixFileSystem::openDirectory(const String& path, int flags) const
+{
+#ifndef WIN32
+	DIR* pDir = ::opendir(GetPosixFilename(path).c_str());
+	if(!pDir)
+	{
+		TranslateCodeToException(0, path);
+	}
+	return new PosixDirectoryIterator(path, pDir, flags);
+#else
+	return FileSystem::openDirectory(path, flags);
+#endif //WIN32
+}
+
 //==============================================================================
 // PosixFileSystem::createDirectory
 //
@@ -558,6 +676,359 @@ void PosixFileSystem::writeFile(FileDescriptor* pFD, const Byte* pBuffer, size_t
 	}
 }
 
+//==============================================================================
+// PosixFileSystem::writeFile
+//
+// Gather write using writev().  writev() may write fewer bytes than
+// requested, in which case we carry on from the first unwritten byte.
+//==============================================================================
+void PosixFileSystem::writeFile(FileDescriptor* pFD, const IoVec* pVecs, size_t count) const
+{
+#ifndef WIN32
+	if(!pFD) throw NullPointerException();
+	if(!pVecs && count) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	size_t skip = 0; // bytes of pVecs[0] already written
+	while(count)
+	{
+		struct iovec iov[MaxIoVecs];
+		const size_t numVecs = (count < MaxIoVecs) ? count : MaxIoVecs;
+		for(size_t i=0; i<numVecs; ++i)
+		{
+			iov[i].iov_base = (void*)(pVecs[i].pData + (i ? 0 : skip));
+			iov[i].iov_len = pVecs[i].length - (i ? 0 : skip);
+		}
+
+		const ssize_t bytesWritten = ::writev(pMyFD->getFD(), iov, (int)numVecs);
+		if(bytesWritten < 0)
+		{
+			if(errno == EINTR) continue;
+			throw IOException(SystemUtils::GetSystemErrorString());
+		}
+
+		size_t done = bytesWritten;
+		while(count && done >= pVecs->length - skip)
+		{
+			done -= pVecs->length - skip;
+			skip = 0;
+			++pVecs;
+			--count;
+		}
+		skip += done;
+	}
+#else
+	FileSystem::writeFile(pFD, pVecs, count);
+#endif //WIN32
+}
+
+//==============================================================================
+// ToOffset
+//
+// Converts a FileOffset into the off_t expected by the system calls.  Unless
+// the library is built with _FILE_OFFSET_BITS=64, off_t is only 32 bits wide
+// on 32-bit platforms, so offsets that do not fit are rejected rather than
+// being silently truncated.
+//==============================================================================
+static off_t ToOffset(FileOffset offset)
+{
+	const off_t ret = (off_t)offset;
+	if(ret < 0 || FileOffset(ret) != offset)
+	{
+		throw IOException(QC_T("file offset is too large"));
+	}
+	return ret;
+}
+
+//==============================================================================
+// PosixFileSystem::getFileLength
+//
+//==============================================================================
+FileOffset PosixFileSystem::getFileLength(FileDescriptor* pFD) const
+{
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	struct stat myStat;
+	if(::fstat(pMyFD->getFD(), &myStat) != 0)
+	{
+		throw IOException(SystemUtils::GetSystemErrorString());
+	}
+	return FileOffset(myStat.st_size);
+}
+
+//==============================================================================
+// PosixFileSystem::getFilePosition
+//
+//==============================================================================
+FileOffset PosixFileSystem::getFilePosition(FileDescriptor* pFD) const
+{
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	const off_t pos = ::lseek(pMyFD->getFD(), 0, SEEK_CUR);
+	if(pos == (off_t)-1)
+	{
+		throw IOException(SystemUtils::GetSystemErrorString());
+	}
+	return FileOffset(pos);
+}
+
+//==============================================================================
+// PosixFileSystem::setFilePosition
+//
+//==============================================================================
+void PosixFileSystem::setFilePosition(FileDescriptor* pFD, FileOffset pos) const
+{
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	if(::lseek(pMyFD->getFD(), ToOffset(pos), SEEK_SET) == (off_t)-1)
+
+	{
+		throw IOException(SystemUtils::GetSystemErrorString());
+	}
+}
+
+//==============================================================================
+// PosixFileSystem::readFileAt
+//
+// Positional read using pread(), which leaves the file offset alone.
+//==============================================================================
+size_t PosixFileSystem::readFileAt(FileDescriptor* pFD, FileOffset pos, Byte* pBuffer, size_t bufLen) const
+{
+#ifndef WIN32
+	if(!pFD) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	const off_t offset = ToOffset(pos);
+	ssize_t bytesRead;
+	while((bytesRead = ::pread(pMyFD->getFD(), pBuffer, bufLen, offset)) < 0)
+	{
+		if(errno != EINTR)
+		{
+			throw IOException(SystemUtils::GetSystemErrorString());
+		}
+	}
+	return bytesRead;
+#else
+	return FileSystem::readFileAt(pFD, pos, pBuffer, bufLen);
+#endif //WIN32
+}
+
+//==============================================================================
+// PosixFileSystem::writeFileAt
+//
+// Positional write using pwrite().  pwrite() may write fewer bytes than
+// requested, in which case we carry on from the first unwritten byte.
+//==============================================================================
+void PosixFileSystem::writeFileAt(FileDescriptor* pFD, FileOffset pos, const Byte* pBuffer, size_t bufLen) const
+{
+#ifndef WIN32
+	if(!pFD) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	while(bufLen)
+	{
+		const ssize_t bytesWritten = ::pwrite(pMyFD->getFD(), pBuffer, bufLen, ToOffset(pos));
+		if(bytesWritten < 0)
+		{
+			if(errno == EINTR) continue;
+			throw IOException(SystemUtils::GetSystemErrorString());
+		}
+		pBuffer += bytesWritten;
+		bufLen -= bytesWritten;
+		pos += bytesWritten;
+	}
+#else
+	FileSystem::writeFileAt(pFD, pos, pBuffer, bufLen);
+#endif //WIN32
+}
+
+//==============================================================================
+// PosixFileSystem::setFileLength
+//
+//==============================================================================
+void PosixFileSystem::setFileLength(FileDescriptor* pFD, FileOffset length) const
+{
+#ifndef WIN32
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	if(::ftruncate(pMyFD->getFD(), ToOffset(length)) != 0)
+	{
+		throw IOException(SystemUtils::GetSystemErrorString());
+	}
+#else
+	FileSystem::setFileLength(pFD, length);
+#endif //WIN32
+}
+
+//==============================================================================
+// PosixFileSystem::allocateFile
+//
+// Uses posix_fallocate() on Linux.  Some file systems cannot allocate space
+// in advance, and the call fails with EOPNOTSUPP or EINVAL; in that case we
+// fall back to simply extending the file.
+//==============================================================================
+void PosixFileSystem::allocateFile(FileDescriptor* pFD, FileOffset offset, FileOffset length) const
+{
+#if defined(__linux__)
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	if(length)
+	{
+		const int rc = ::posix_fallocate(pMyFD->getFD(), ToOffset(offset), ToOffset(length));
+
+		if(rc == EOPNOTSUPP || rc == EINVAL)
+		{
+			FileSystem::allocateFile(pFD, offset, length);
+		}
+		else if(rc != 0)
+		{
+			throw IOException(SystemUtils::GetSystemErrorString(rc));
+		}
+	}
+#else
+	FileSystem::allocateFile(pFD, offset, length);
+#endif //__linux__
+}
+
+//==============================================================================
+// PosixFileSystem::syncFile
+//
+// fdatasync() skips the metadata that is not needed to read the data back,
+// such as the modification time.  Where it is not available we use fsync().
+//==============================================================================
+void PosixFileSystem::syncFile(FileDescriptor* pFD, bool bMetadata) const
+{
+#ifndef WIN32
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+#if defined(__linux__)
+	const int rc = bMetadata ? ::fsync(pMyFD->getFD()) : ::fdatasync(pMyFD->getFD());
+#else
+	const int rc = ::fsync(pMyFD->getFD());
+#endif //__linux__
+	if(rc != 0)
+	{
+		throw IOException(SystemUtils::GetSystemErrorString());
+	}
+#else
+	FileSystem::syncFile(pFD, bMetadata);
+#endif //WIN32
+}
+
+//==============================================================================
+// PosixFileSystem::syncFileRange
+//
+// Uses sync_file_range() on Linux.  Files that it cannot be applied to, such
+// as pipes, fail with ESPIPE or EINVAL and are silently ignored, as this is
+// only a hint; errors writing the data are reported.
+//==============================================================================
+void PosixFileSystem::syncFileRange(FileDescriptor* pFD, FileOffset offset,
+                                    FileOffset length, bool bWait) const
+{
+#if defined(SYNC_FILE_RANGE_WRITE)
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	const unsigned int flags = bWait
+		? (SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER)
+		: SYNC_FILE_RANGE_WRITE;
+
+	if(::sync_file_range(pMyFD->getFD(), ToOffset(offset), ToOffset(length), flags) != 0)
+	{
+		if(errno == EIO || errno == ENOSPC)
+		{
+			throw IOException(SystemUtils::GetSystemErrorString());
+		}
+	}
+#else
+	FileSystem::syncFileRange(pFD, offset, length, bWait);
+#endif //SYNC_FILE_RANGE_WRITE
+}
+
+//==============================================================================
+// PosixFileSystem::adviseFile
+//
+// Uses posix_fadvise() where it is available.  On Linux, WillNeed starts
+// reading the range into the cache in the same way as readahead(), but
+// without waiting for the reads to be queued.
+//==============================================================================
+void PosixFileSystem::adviseFile(FileDescriptor* pFD, FileOffset offset,
+                                 FileOffset length, AccessAdvice advice) const
+{
+#if defined(POSIX_FADV_NORMAL)
+	if(!pFD) throw NullPointerException();
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	int posixAdvice = POSIX_FADV_NORMAL;
+	switch(advice)
+	{
+	case NormalAccess:     posixAdvice = POSIX_FADV_NORMAL;     break;
+	case SequentialAccess: posixAdvice = POSIX_FADV_SEQUENTIAL; break;
+	case RandomAccess:     posixAdvice = POSIX_FADV_RANDOM;     break;
+	case NoReuse:          posixAdvice = POSIX_FADV_NOREUSE;    break;
+	case WillNeed:         posixAdvice = POSIX_FADV_WILLNEED;   break;
+	case DontNeed:         posixAdvice = POSIX_FADV_DONTNEED;   break;
+	}
+
+	::posix_fadvise(pMyFD->getFD(), ToOffset(offset), ToOffset(length), posixAdvice);
+
+#else
+	FileSystem::adviseFile(pFD, offset, length, advice);
+#endif //POSIX_FADV_NORMAL
+}
+
+//==============================================================================
+// PosixFileSystem::mapFile
+//
+// mmap() requires the file offset to be a multiple of the page size, so the
+// mapping is started at the preceding page boundary and the
+// PosixMappedByteBuffer is told how far into the mapping the requested
+// bytes begin.
+//==============================================================================
+AutoPtr<MappedByteBuffer> PosixFileSystem::mapFile(FileDescriptor* pFD, FileOffset offset, size_t length) const
+{
+#ifndef WIN32
+	if(!pFD) throw NullPointerException();
+	if(!length) throw IllegalArgumentException(QC_T("zero mapping length"));
+
+	PosixFileDescriptor* pMyFD = static_cast<PosixFileDescriptor*>(pFD);
+
+	static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+	const size_t dataOffset = size_t(offset % pageSize);
+
+	void* pMapping = ::mmap(0, length+dataOffset, PROT_READ, MAP_SHARED,
+	                        pMyFD->getFD(), ToOffset(offset-dataOffset));
+
+	if(pMapping == MAP_FAILED)
+	{
+		throw IOException(SystemUtils::GetSystemErrorString());
+	}
+
+	return new PosixMappedByteBuffer(pMapping, length+dataOffset, dataOffset, offset);
+#else
+	return FileSystem::mapFile(pFD, offset, length);
+#endif //WIN32
+}
+
 //==============================================================================
 // PosixFileSystem::GetPosixFilename
 //
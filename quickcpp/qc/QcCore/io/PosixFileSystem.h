@@ -48,6 +48,7 @@ public:
 	bool checkAccess(const String& path, AccessMode mode) const;
 	virtual DateTime getLastModifiedTime(const String& path) const;
 	virtual size_t getLength(const String& path) const;
+	virtual FileStatus getFileStatus(const String& path) const;
 
 	virtual AutoPtr<FileDescriptor> openFile(const String& path,
 	                                        int accessMode,
@@ -57,6 +58,7 @@ public:
 	virtual void closeFile(FileDescriptor* pFD) const;
     virtual void deleteFile(const String& path) const;
 	virtual std::list<String> listDirectory(const String& path) const;
+	virtual AutoPtr<DirectoryIterator> openDirectory(const String& path, int flags) const;
 	virtual void createDirectory(const String& path) const;
 	virtual void rename(const String& path1, const String& path2) const;
 	virtual void setLastModifiedTime(const String& path, const DateTime& time) const;
@@ -64,6 +66,23 @@ public:
 	virtual AutoPtr<FileDescriptor> getConsoleFD(ConsoleStream stream) const;
 	virtual size_t readFile(FileDescriptor* pFD, Byte* pBuffer, size_t bufLen) const;
 	virtual void writeFile(FileDescriptor* pFD, const Byte* pBuffer, size_t bufLen) const;
+	virtual void writeFile(FileDescriptor* pFD, const IoVec* pVecs, size_t count) const;
+	virtual FileOffset getFileLength(FileDescriptor* pFD) const;
+	virtual FileOffset getFilePosition(FileDescriptor* pFD) const;
+	virtual void setFilePosition(FileDescriptor* pFD, FileOffset pos) const;
+
+	virtual size_t readFileAt(FileDescriptor* pFD, FileOffset pos, Byte* pBuffer, size_t bufLen) const;
+	virtual void writeFileAt(FileDescriptor* pFD, FileOffset pos, const Byte* pBuffer, size_t bufLen) const;
+	virtual void setFileLength(FileDescriptor* pFD, FileOffset length) const;
+
+	virtual void allocateFile(FileDescriptor* pFD, FileOffset offset, FileOffset length) const;
+
+	virtual void syncFile(FileDescriptor* pFD, bool bMetadata) const;
+	virtual void syncFileRange(FileDescriptor* pFD, FileOffset offset, FileOffset length, bool bWait) const;
+	virtual void adviseFile(FileDescriptor* pFD, FileOffset offset, FileOffset length, AccessAdvice advice) const;
+
+	virtual AutoPtr<MappedByteBuffer> mapFile(FileDescriptor* pFD, FileOffset offset, size_t length) const;
+
 
 private:
 
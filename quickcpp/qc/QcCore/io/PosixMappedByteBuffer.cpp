@@ -0,0 +1,87 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: PosixMappedByteBuffer
+// 
+// The region is mapped by PosixFileSystem::mapFile() from a page boundary,
+// so the start of the mapping may precede the first byte that was requested
+// by up to one page.
+//
+//==============================================================================
+
+#ifndef WIN32
+
+#include "PosixMappedByteBuffer.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+PosixMappedByteBuffer::PosixMappedByteBuffer(void* pMapping, size_t mapLength,
+                                             size_t dataOffset, FileOffset fileOffset) :
+
+	MappedByteBuffer(static_cast<const Byte*>(pMapping)+dataOffset, mapLength-dataOffset, fileOffset),
+	m_pMapping(pMapping),
+	m_mapLength(mapLength)
+{
+}
+
+PosixMappedByteBuffer::~PosixMappedByteBuffer()
+{
+	::munmap(m_pMapping, m_mapLength);
+}
+
+void PosixMappedByteBuffer::advise(Advice advice, size_t offset, size_t len)
+{
+	if(offset >= getLength()) return;
+	if(len > getLength() - offset) len = getLength() - offset;
+
+	int posixAdvice;
+	switch(advice)
+	{
+	case Sequential: posixAdvice = POSIX_MADV_SEQUENTIAL; break;
+	case Random:     posixAdvice = POSIX_MADV_RANDOM;     break;
+	case WillNeed:   posixAdvice = POSIX_MADV_WILLNEED;   break;
+	case DontNeed:   posixAdvice = POSIX_MADV_DONTNEED;   break;
+	default:         posixAdvice = POSIX_MADV_NORMAL;     break;
+	}
+
+	//
+	// The advice must start on a page boundary.  The mapping itself starts
+	// on one, so the distance from there is rounded down to the page size.
+	//
+	static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+	size_t start = (getData() - static_cast<const Byte*>(m_pMapping)) + offset;
+	len += start % pageSize;
+	start -= start % pageSize;
+
+	// advice is only a hint, so failure is not reported
+	::posix_madvise(static_cast<Byte*>(m_pMapping)+start, len, posixAdvice);
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //WIN32
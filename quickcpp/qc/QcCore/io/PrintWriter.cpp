@@ -80,7 +80,8 @@ PrintWriter::PrintWriter(OutputStream* pOut, bool bAutoFlush) :
     @throws NullPointerException if @c pWriter is null
 
     @mt
-    The existing Writer is used as the lock object for synchronized methods.
+    The existing Writer is used as the lock object for synchronized methods,
+    and the new PrintWriter adopts its synchronization mode.
 */
 //==============================================================================
 PrintWriter::PrintWriter(Writer* pWriter, bool bAutoFlush) :
@@ -90,6 +91,7 @@ PrintWriter::PrintWriter(Writer* pWriter, bool bAutoFlush) :
 {
 	QC_DBG_ASSERT(this != pWriter);
 	if(!pWriter) throw NullPointerException();
+	m_bSynchronized = pWriter->isSynchronized();
 }
 
 //==============================================================================
@@ -126,6 +128,20 @@ void PrintWriter::close()
 	}
 }
 
+//==============================================================================
+// PrintWriter::setSynchronized
+//
+// Also sets the mode of the contained Writer, which shares our lock.
+//==============================================================================
+void PrintWriter::setSynchronized(bool bSynchronized)
+{
+	Writer::setSynchronized(bSynchronized);
+	if(m_rpWriter)
+	{
+		m_rpWriter->setSynchronized(bSynchronized);
+	}
+}
+
 //==============================================================================
 // PrintWriter::print
 //
@@ -317,7 +333,7 @@ void PrintWriter::println()
 //==============================================================================
 void PrintWriter::println(Character c)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(c);
 	println();
@@ -335,7 +351,7 @@ void PrintWriter::println(Character c)
 //==============================================================================
 void PrintWriter::println(const CharType* pStr)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(pStr);
 	println();
@@ -351,7 +367,7 @@ void PrintWriter::println(const CharType* pStr)
 //==============================================================================
 void PrintWriter::println(double x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -367,7 +383,7 @@ void PrintWriter::println(double x)
 //==============================================================================
 void PrintWriter::println(float x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -383,7 +399,7 @@ void PrintWriter::println(float x)
 //==============================================================================
 void PrintWriter::println(long x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -399,7 +415,7 @@ void PrintWriter::println(long x)
 //==============================================================================
 void PrintWriter::println(unsigned long x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -415,7 +431,7 @@ void PrintWriter::println(unsigned long x)
 //==============================================================================
 void PrintWriter::println(int x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -431,7 +447,7 @@ void PrintWriter::println(int x)
 //==============================================================================
 void PrintWriter::println(unsigned int x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -447,7 +463,7 @@ void PrintWriter::println(unsigned int x)
 //==============================================================================
 void PrintWriter::println(const String& x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
@@ -511,7 +527,7 @@ void PrintWriter::print(bool b)
 //==============================================================================
 void PrintWriter::println(bool x)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	print(x);
 	println();
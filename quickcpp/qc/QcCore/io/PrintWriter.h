@@ -46,6 +46,7 @@ public:
 	virtual ~PrintWriter();
 
 	virtual void close();
+	virtual void setSynchronized(bool bSynchronized);
 	virtual void flush();
 	virtual void flushBuffers();
 
@@ -172,7 +172,7 @@ long PushbackInputStream::read(Byte* b, size_t len)
 
 	SystemUtils::TestBufferIsValid(b, len);
 
-	int avail = len - pos;
+	size_t avail = buf_size - pos;
 	if (avail > 0)
 	{
 		if (len < avail)
@@ -189,12 +189,12 @@ long PushbackInputStream::read(Byte* b, size_t len)
 	if (len > 0)
 	{
 		//len = super.read(b, len);
-		len = this->getInputStream()->read(b, len);
-		if (len == -1)
+		long nRead = this->getInputStream()->read(b, len);
+		if (nRead == EndOfFile)
 		{
-			return avail == 0 ? -1 : avail;
+			return avail == 0 ? long(EndOfFile) : long(avail);
 		}
-		return avail + len;
+		return long(avail) + nRead;
 	}
 	return avail;
 }
@@ -245,7 +245,7 @@ void PushbackInputStream::unread(Byte *b, int len)
 	ensureOpen();
 	if (len > pos)
 	{
-		throw new IOException(QC_T("Push back buffer is full"));
+		throw IOException(QC_T("Push back buffer is full"));
 	}
 	pos -= len;
 	//System.arraycopy(b, off, buf, pos, len);
@@ -0,0 +1,476 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: RandomAccessFile
+/**
+	@class qc::io::RandomAccessFile
+	
+	@brief Provides reading and writing at any position within a file.
+
+	A RandomAccessFile behaves like a large array of bytes stored in the
+	file system.  Like FileInputStream and FileOutputStream it represents the
+	open file using a FileDescriptor, which ensures that the file is closed
+	when the RandomAccessFile is destroyed.
+
+	The sequential read() and write() methods take place at the current
+	<i>file pointer</i>, which may be moved with seek().  The positional
+	methods readAt(), readFullyAt() and writeAt() are given an explicit file
+	offset instead and do not use or change the file pointer.  This makes
+	them safe to call from several threads at once, provided that each thread
+	reads or writes a different part of the file.  ParallelFileReader uses
+	readAt() in this way to read large files on several threads, and
+	FtpClient::retrieveFile() uses writeAt() so that different parts of a
+	file can be downloaded concurrently.
+
+	Before a file is written in pieces, the application can reserve disk
+	space for the whole file using allocate().  sync() forces written data
+	to the storage device.
+*/
+//==============================================================================
+
+#include "RandomAccessFile.h"
+#include "File.h"
+#include "FileSystem.h"
+#include "IOException.h"
+
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/SystemUtils.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+//==============================================================================
+// RandomAccessFile::RandomAccessFile
+//
+/**
+   Constructs a RandomAccessFile by opening a connection to the file with
+   the abstract pathname denoted by @c file.
+
+   The @c mode argument specifies how the file is to be opened:
+   - @c "r" opens an existing file for reading only
+   - @c "rw" opens the file for reading and writing, creating it if it does
+     not already exist.  The contents of an existing file are preserved.
+
+   @param file the abstract pathname of the file to open
+   @param mode the access mode
+   @throws IllegalArgumentException if @c mode is not @c "r" or @c "rw".
+   @throws FileNotFoundException if @c mode is @c "r" and a file with the
+           specified name does not exist on the file system.
+   @throws IOException if the specified file could not be opened.  This includes
+           the case where @c file refers to a directory instead of a normal file.
+*/
+//==============================================================================
+RandomAccessFile::RandomAccessFile(const File& file, const String& mode)
+{
+	open(file.getPath(), mode);
+}
+
+//==============================================================================
+// RandomAccessFile::RandomAccessFile
+//
+/**
+   Constructs a RandomAccessFile by opening a connection to the named file
+   @c name.
+
+   @param name the name of the file to open
+   @param mode the access mode: @c "r" or @c "rw".  See
+          RandomAccessFile(const File&, const String&) for details.
+   @throws IllegalArgumentException if @c mode is not @c "r" or @c "rw".
+   @throws FileNotFoundException if @c mode is @c "r" and a file with the
+           specified name does not exist on the file system.
+   @throws IOException if the specified file name could not be opened.  This
+           includes the case where @c name refers to a directory instead of a
+           normal file.
+*/
+//==============================================================================
+RandomAccessFile::RandomAccessFile(const String& name, const String& mode)
+{
+	open(name, mode);
+}
+
+//==============================================================================
+// RandomAccessFile::RandomAccessFile
+//
+/**
+   Constructs a RandomAccessFile and connects it with an open file
+   denoted by the FileDescriptor @c pFD.
+
+   @param pFD the FileDescriptor to connect to this RandomAccessFile
+   @throws NullPointerException if @c pFD is null.
+*/
+//==============================================================================
+RandomAccessFile::RandomAccessFile(FileDescriptor* pFD) : 
+	m_rpFD(pFD)
+{
+	if(!pFD) throw NullPointerException();
+}
+
+//==============================================================================
+// RandomAccessFile::close
+//
+/**
+   Closes the file and releases any system resources associated with it.
+
+   Once a RandomAccessFile is closed further calls to read or write it
+   will result in an IOException being thrown.  Further calls to close()
+   are legal but have no effect.
+
+   @throws IOException if an I/O error occurs.
+*/
+//==============================================================================
+void RandomAccessFile::close()
+{
+	if(m_rpFD)
+	{
+		// must call close on the FD rather than the FileSystem
+		// in case the FD has AutoClose enabled
+		m_rpFD->close();
+		m_rpFD.release();
+	}
+}
+
+//==============================================================================
+// RandomAccessFile::read
+//
+/**
+   Reads up to @c bufLen bytes into the supplied buffer, starting at the
+   current file pointer.  The file pointer is advanced by the number of bytes
+   read.
+
+   @param pBuffer A pointer to the buffer into which the bytes will be copied.
+          This must be capable of holding at least @c bufLen bytes.
+   @param bufLen The maximum number of bytes to read into the passed buffer.
+   @returns The number of bytes read or EndOfFile if the file pointer is at
+            or beyond the end of the file.
+   @throws IllegalArgumentException if @c bufLen is zero.
+   @throws NullPointerException if @c pBuffer is null.
+   @throws IOException if the file is closed or an I/O error occurs.
+*/
+//==============================================================================
+long RandomAccessFile::read(Byte* pBuffer, size_t bufLen)
+{
+	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
+	FileDescriptor* pFD = getOpenFD();
+
+	const size_t bytesRead = pFD->getFileSystem()->readFile(pFD, pBuffer, bufLen);
+
+	return bytesRead ? (long)bytesRead : (long)EndOfFile;
+}
+
+//==============================================================================
+// RandomAccessFile::write
+//
+/**
+   Writes @c bufLen bytes from the supplied buffer, starting at the current
+   file pointer.  The file pointer is advanced by the number of bytes
+   written.
+
+   @param pBuffer pointer to the start of an array of bytes to be written
+   @param bufLen length of the byte array
+   @throws NullPointerException if @c pBuffer is null.
+   @throws IOException if the file is closed or an I/O error occurs.
+*/
+//==============================================================================
+void RandomAccessFile::write(const Byte* pBuffer, size_t bufLen)
+{
+	if(!pBuffer) throw NullPointerException();
+	FileDescriptor* pFD = getOpenFD();
+
+	if(bufLen)
+	{
+		pFD->getFileSystem()->writeFile(pFD, pBuffer, bufLen);
+	}
+}
+
+//==============================================================================
+// RandomAccessFile::getFilePointer
+//
+/**
+   Returns the current file pointer, expressed as the number of bytes from the
+   beginning of the file.
+
+   @throws IOException if the file is closed or an I/O error occurs.
+   @sa seek()
+*/
+//==============================================================================
+FileOffset RandomAccessFile::getFilePointer() const
+{
+	FileDescriptor* pFD = getOpenFD();
+	return pFD->getFileSystem()->getFilePosition(pFD);
+}
+
+//==============================================================================
+// RandomAccessFile::seek
+//
+/**
+   Sets the file pointer to @c pos bytes from the beginning of the file.  The
+   next read() or write() operation takes place at this position.
+
+   The file pointer may be set beyond the end of the file.  This does not
+   change the length of the file, but a subsequent write() will extend it.
+
+   @throws IOException if the file is closed or an I/O error occurs.
+   @sa getFilePointer()
+*/
+//==============================================================================
+void RandomAccessFile::seek(FileOffset pos)
+{
+	FileDescriptor* pFD = getOpenFD();
+	pFD->getFileSystem()->setFilePosition(pFD, pos);
+}
+
+//==============================================================================
+// RandomAccessFile::readAt
+//
+/**
+   Reads up to @c bufLen bytes into the supplied buffer, starting @c pos
+   bytes from the beginning of the file.  The file pointer is neither used
+   nor changed.
+
+   Fewer than @c bufLen bytes may be read even when the end of the file has
+   not been reached.  readFullyAt() can be used to read an exact number of
+   bytes.
+
+   @param pos the offset within the file of the first byte to read
+   @param pBuffer A pointer to the buffer into which the bytes will be copied.
+          This must be capable of holding at least @c bufLen bytes.
+   @param bufLen The maximum number of bytes to read into the passed buffer.
+   @returns The number of bytes read or EndOfFile if @c pos is at or beyond
+            the end of the file.
+   @throws IllegalArgumentException if @c bufLen is zero.
+   @throws NullPointerException if @c pBuffer is null.
+   @throws IOException if the file is closed or an I/O error occurs.
+*/
+//==============================================================================
+long RandomAccessFile::readAt(FileOffset pos, Byte* pBuffer, size_t bufLen)
+{
+	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
+	FileDescriptor* pFD = getOpenFD();
+
+	const size_t bytesRead = pFD->getFileSystem()->readFileAt(pFD, pos, pBuffer, bufLen);
+
+	return bytesRead ? (long)bytesRead : (long)EndOfFile;
+}
+
+//==============================================================================
+// RandomAccessFile::readFullyAt
+//
+/**
+   Reads exactly @c bufLen bytes into the supplied buffer, starting @c pos
+   bytes from the beginning of the file.  The file pointer is neither used
+   nor changed.
+
+   @param pos the offset within the file of the first byte to read
+   @param pBuffer A pointer to the buffer into which the bytes will be copied.
+          This must be capable of holding at least @c bufLen bytes.
+   @param bufLen The number of bytes to read.
+   @throws NullPointerException if @c pBuffer is null.
+   @throws IOException if the end of the file is reached before @c bufLen
+           bytes have been read, if the file is closed or if an I/O error
+           occurs.
+*/
+//==============================================================================
+void RandomAccessFile::readFullyAt(FileOffset pos, Byte* pBuffer, size_t bufLen)
+{
+	if(!pBuffer) throw NullPointerException();
+	FileDescriptor* pFD = getOpenFD();
+	AutoPtr<FileSystem> rpFS = pFD->getFileSystem();
+
+	while(bufLen)
+	{
+		const size_t bytesRead = rpFS->readFileAt(pFD, pos, pBuffer, bufLen);
+		if(!bytesRead)
+		{
+			throw IOException(QC_T("unexpected end of file"));
+		}
+		pos += bytesRead;
+		pBuffer += bytesRead;
+		bufLen -= bytesRead;
+	}
+}
+
+//==============================================================================
+// RandomAccessFile::writeAt
+//
+/**
+   Writes @c bufLen bytes from the supplied buffer, starting @c pos bytes
+   from the beginning of the file.  The file is extended if necessary.  The
+   file pointer is neither used nor changed.
+
+   @param pos the offset within the file of the first byte to write
+   @param pBuffer pointer to the start of an array of bytes to be written
+   @param bufLen length of the byte array
+   @throws NullPointerException if @c pBuffer is null.
+   @throws IOException if the file is closed or an I/O error occurs.
+*/
+//==============================================================================
+void RandomAccessFile::writeAt(FileOffset pos, const Byte* pBuffer, size_t bufLen)
+{
+	if(!pBuffer) throw NullPointerException();
+	FileDescriptor* pFD = getOpenFD();
+
+	if(bufLen)
+	{
+		pFD->getFileSystem()->writeFileAt(pFD, pos, pBuffer, bufLen);
+	}
+}
+
+//==============================================================================
+// RandomAccessFile::length
+//
+/**
+   Returns the length of the file in bytes.
+
+   @throws IOException if the file is closed or an I/O error occurs.
+*/
+//==============================================================================
+FileOffset RandomAccessFile::length() const
+{
+	FileDescriptor* pFD = getOpenFD();
+	return pFD->getFileSystem()->getFileLength(pFD);
+}
+
+//==============================================================================
+// RandomAccessFile::setLength
+//
+/**
+   Truncates or extends the file so that it is exactly @c length bytes long.
+   When the file is extended the contents of the extended portion are
+   undefined.
+
+   If the file pointer is beyond the new end of the file it is not moved.
+
+   @throws IOException if the file is closed or an I/O error occurs.
+*/
+//==============================================================================
+void RandomAccessFile::setLength(FileOffset length)
+{
+	FileDescriptor* pFD = getOpenFD();
+	pFD->getFileSystem()->setFileLength(pFD, length);
+}
+
+//==============================================================================
+// RandomAccessFile::allocate
+//
+/**
+   Reserves disk space for @c length bytes starting @c offset bytes from the
+   beginning of the file, extending the file if necessary.
+
+   Allocating the space for a file before it is written in pieces with
+   writeAt() ensures that the writes will not fail for lack of space and
+   allows the file system to lay the file out contiguously.  Where the
+   platform cannot reserve space in advance the file is simply extended.
+
+   @throws IOException if the file is closed, the space cannot be allocated
+           or an I/O error occurs.
+   @sa FileSystem::allocateFile()
+*/
+//==============================================================================
+void RandomAccessFile::allocate(FileOffset offset, FileOffset length)
+
+{
+	FileDescriptor* pFD = getOpenFD();
+	pFD->getFileSystem()->allocateFile(pFD, offset, length);
+}
+
+//==============================================================================
+// RandomAccessFile::sync
+//
+/**
+   Forces any data written to the file to be written to the storage device.
+
+   @param bMetadata if @c true, file attributes such as the modification
+          time are also written.  By default only the file data and those
+          attributes required to read it back are written, which may be
+          considerably cheaper.
+   @throws IOException if the file is closed or an I/O error occurs.
+   @sa FileSystem::syncFile()
+*/
+//==============================================================================
+void RandomAccessFile::sync(bool bMetadata)
+{
+	FileDescriptor* pFD = getOpenFD();
+	pFD->getFileSystem()->syncFile(pFD, bMetadata);
+}
+
+//==============================================================================
+// RandomAccessFile::getFD
+//
+/**
+   Returns a reference to the FileDescriptor for the open file
+   connected to this RandomAccessFile.
+*/
+//==============================================================================
+AutoPtr<FileDescriptor> RandomAccessFile::getFD() const
+{
+	return m_rpFD;
+}
+
+//==============================================================================
+// RandomAccessFile::getOpenFD
+//
+// Private helper function that returns the FileDescriptor or throws an
+// IOException if the file has been closed.
+//==============================================================================
+FileDescriptor* RandomAccessFile::getOpenFD() const
+{
+	if(!m_rpFD) throw IOException(QC_T("file is closed"));
+	return m_rpFD.get();
+}
+
+//==============================================================================
+// RandomAccessFile::open
+//
+// Private helper function.
+//==============================================================================
+void RandomAccessFile::open(const String& fileName, const String& mode) 
+{
+	int accessFlags = FileSystem::ReadAccess;
+	FileSystem::CreationDisp disp = FileSystem::OpenExisting;
+
+	if(mode == QC_T("rw"))
+	{
+		accessFlags |= FileSystem::WriteAccess;
+		disp = FileSystem::OpenCreate;
+	}
+	else if(mode != QC_T("r"))
+	{
+		throw IllegalArgumentException(QC_T("invalid mode: ") + mode);
+	}
+
+	if(fileName.empty())
+		throw IOException(QC_T("empty filename"));
+	else if(FileSystem::GetFileSystem()->getFileAttributeFlags(fileName) & FileSystem::Directory)
+		throw IOException(fileName + QC_T(" is a directory"));
+
+	m_rpFD = 
+		FileSystem::GetFileSystem()->openFile(fileName,
+		                                      accessFlags,
+		                                      disp,
+		                                      0);
+}
+
+QC_IO_NAMESPACE_END
+
@@ -0,0 +1,86 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: RandomAccessFile
+// 
+//==============================================================================
+
+#ifndef QC_IO_RandomAccessFile_h
+#define QC_IO_RandomAccessFile_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "FileDescriptor.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class File;
+
+class QC_IO_PKG RandomAccessFile : public virtual QCObject
+{
+public:
+
+	enum {EndOfFile=-1 /*!< end of file reached */ };
+
+	RandomAccessFile(const File& file, const String& mode);
+	RandomAccessFile(const String& name, const String& mode);
+	RandomAccessFile(FileDescriptor* pFD);
+
+	void close();
+
+	long read(Byte* pBuffer, size_t bufLen);
+	void write(const Byte* pBuffer, size_t bufLen);
+	FileOffset getFilePointer() const;
+	void seek(FileOffset pos);
+
+	long readAt(FileOffset pos, Byte* pBuffer, size_t bufLen);
+	void readFullyAt(FileOffset pos, Byte* pBuffer, size_t bufLen);
+	void writeAt(FileOffset pos, const Byte* pBuffer, size_t bufLen);
+
+	FileOffset length() const;
+	void setLength(FileOffset length);
+	void allocate(FileOffset offset, FileOffset length);
+
+	void sync(bool bMetadata=false);
+
+	AutoPtr<FileDescriptor> getFD() const;
+
+private:
+	RandomAccessFile(const RandomAccessFile& rhs);            // cannot be copied
+	RandomAccessFile& operator=(const RandomAccessFile& rhs); // nor assigned
+
+	void open(const String& fileName, const String& mode);
+	FileDescriptor* getOpenFD() const;
+
+private:
+	AutoPtr<FileDescriptor> m_rpFD;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_RandomAccessFile_h
+
@@ -46,6 +46,10 @@
 	SynchronizedObject, which gives it the ability to protect its internal
 	state from concurrent access from multiple threads.  All public methods 
 	are synchronized for safe concurrent access.
+
+	A Reader that is only ever used by one thread can avoid the cost of
+	acquiring the lock for every call by being switched into an
+	unsynchronized mode with setSynchronized().
 */
 //==============================================================================
 
@@ -65,7 +69,8 @@ QC_IO_NAMESPACE_BEGIN
 */
 //==============================================================================
 Reader::Reader() :
-	m_rpLock(this, this)
+	m_rpLock(this, this),
+	m_bSynchronized(true)
 {
 }
 
@@ -80,7 +85,8 @@ Reader::Reader() :
 */
 //==============================================================================
 Reader::Reader(SynchronizedObject* pLockObject) :
-	m_rpLock(this, pLockObject)
+	m_rpLock(this, pLockObject),
+	m_bSynchronized(true)
 {
 	if(!pLockObject) throw NullPointerException();
 }
@@ -293,6 +299,50 @@ AutoPtr<SynchronizedObject> Reader::getLock() const
 	return pLock;
 }
 
+//==============================================================================
+// Reader::isSynchronized
+//
+/**
+   Returns @c true if the public methods of this Reader acquire the lock
+   returned by getLock(); @c false if the Reader is in unsynchronized mode.
+   @sa setSynchronized()
+*/
+//==============================================================================
+bool Reader::isSynchronized() const
+{
+	return m_bSynchronized;
+}
+
+//==============================================================================
+// Reader::setSynchronized
+//
+/**
+   Switches this Reader between synchronized and unsynchronized mode.
+
+   In synchronized mode, which is the default, every public method acquires
+   the lock returned by getLock() so that the Reader may safely be used by
+   several threads at once.  In unsynchronized mode the lock is not acquired,
+   which makes each call cheaper.  This is only safe when the Reader, and
+   every other Reader that shares its lock, is confined to a single thread.
+
+   A Reader that wraps another Reader passes the setting on to the
+   contained Reader, so the mode of a complete chain can be set by calling
+   this method on the outermost object.  A wrapper also adopts the mode of
+   the Reader it wraps when it is constructed.
+
+   This method is not synchronized: it should be called before the Reader
+   is shared, typically straight after it is constructed.
+
+   @param bSynchronized @c false to stop acquiring the lock; @c true to
+          restore the default behaviour.
+   @sa isSynchronized()
+*/
+//==============================================================================
+void Reader::setSynchronized(bool bSynchronized)
+{
+	m_bSynchronized = bSynchronized;
+}
+
 #ifdef QC_DOCUMENTATION_ONLY
 //=============================================================================
 //
@@ -57,9 +57,12 @@ public:
 	virtual size_t skipAtomic(size_t n);
 
 	AutoPtr<SynchronizedObject> getLock() const;
+	bool isSynchronized() const;
+	virtual void setSynchronized(bool bSynchronized);
 
 protected:
 	AutoPtrMember<SynchronizedObject> m_rpLock;
+	bool m_bSynchronized;
 
 private:
 	Reader(const Reader& rhs);            // cannot be copied
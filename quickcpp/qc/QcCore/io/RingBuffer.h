@@ -0,0 +1,274 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: RingBuffer
+// 
+// Overview
+// --------
+// Template class providing the circular storage used by BufferedInputStream,
+// BufferedReader and Pipe.
+//
+// Elements are addressed by a logical offset which increases without limit
+// (modulo the range of size_t) as data is added.  The owner keeps track of
+// which range of offsets is in use; the RingBuffer maps each offset onto its
+// storage, so data can be consumed and replaced without ever being moved.
+//
+// The capacity is always a power of two.  Storage is allocated from the
+// BufferPool.
+//
+// This is an internal class and is not exported from the library.
+//
+//=============================================================================
+
+#ifndef QC_IO_RingBuffer_h
+#define QC_IO_RingBuffer_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "QcCore/base/BufferPool.h"
+#include "QcCore/base/debug.h"
+
+#include <string.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+	template<typename T>
+class RingBuffer
+{
+public:
+	RingBuffer();
+	~RingBuffer();
+
+	void allocate(size_t capacity);
+	void free();
+
+	size_t capacity() const;
+	T* at(size_t offset) const;
+	size_t contiguous(size_t offset) const;
+	void copyIn(size_t offset, const T* pSrc, size_t len);
+	void copyOut(size_t offset, T* pDest, size_t len) const;
+	void rebase(size_t offset);
+	void relocate(size_t from, size_t to, size_t capacity);
+
+private:
+	RingBuffer(const RingBuffer& rhs);            // cannot be copied
+	RingBuffer& operator=(const RingBuffer& rhs); // nor assigned
+
+	static size_t RoundCapacity(size_t capacity);
+
+private:
+	T* m_pBuffer;
+	size_t m_capacity;
+	size_t m_base;
+};
+
+template<typename T>
+inline
+	RingBuffer<T>::RingBuffer() :
+	m_pBuffer(0),
+	m_capacity(0),
+	m_base(0)
+{
+}
+
+template<typename T>
+inline
+	RingBuffer<T>::~RingBuffer()
+{
+	free();
+}
+
+//==============================================================================
+// RingBuffer<T>::RoundCapacity
+//
+// Returns the smallest power of two that is not less than capacity.
+//==============================================================================
+template<typename T>
+inline
+	size_t RingBuffer<T>::RoundCapacity(size_t capacity)
+{
+	size_t ret = 16;
+	while(ret < capacity)
+	{
+		ret <<= 1;
+	}
+	return ret;
+}
+
+//==============================================================================
+// RingBuffer<T>::allocate
+//
+// Allocates storage for at least capacity elements, discarding any previous
+// contents.  Offset 0 is mapped onto the start of the storage.
+//==============================================================================
+template<typename T>
+inline
+	void RingBuffer<T>::allocate(size_t capacity)
+{
+	free();
+	m_capacity = RoundCapacity(capacity);
+	m_pBuffer = BufferPool::AllocateArray<T>(m_capacity);
+	m_base = 0;
+}
+
+//==============================================================================
+// RingBuffer<T>::free
+//
+//==============================================================================
+template<typename T>
+inline
+	void RingBuffer<T>::free()
+{
+	BufferPool::ReleaseArray(m_pBuffer, m_capacity);
+	m_pBuffer = 0;
+	m_capacity = 0;
+}
+
+//==============================================================================
+// RingBuffer<T>::capacity
+//
+//==============================================================================
+template<typename T>
+inline
+	size_t RingBuffer<T>::capacity() const
+{
+	return m_capacity;
+}
+
+//==============================================================================
+// RingBuffer<T>::at
+//
+// Returns the address of the element stored at offset.
+//==============================================================================
+template<typename T>
+inline
+	T* RingBuffer<T>::at(size_t offset) const
+{
+	QC_DBG_ASSERT(m_pBuffer!=0);
+	return m_pBuffer + ((offset - m_base) & (m_capacity-1));
+}
+
+//==============================================================================
+// RingBuffer<T>::contiguous
+//
+// Returns the number of elements that can be addressed from at(offset)
+// before the end of the storage is reached.
+//==============================================================================
+template<typename T>
+inline
+	size_t RingBuffer<T>::contiguous(size_t offset) const
+{
+	return m_capacity - ((offset - m_base) & (m_capacity-1));
+}
+
+//==============================================================================
+// RingBuffer<T>::copyIn
+//
+// Copies len elements from pSrc into the storage starting at offset, which
+// may require two copy operations if the elements wrap around the end of the
+// storage.
+//==============================================================================
+template<typename T>
+inline
+	void RingBuffer<T>::copyIn(size_t offset, const T* pSrc, size_t len)
+{
+	QC_DBG_ASSERT(len <= m_capacity);
+	const size_t first = contiguous(offset);
+	if(len <= first)
+	{
+		::memcpy(at(offset), pSrc, len*sizeof(T));
+	}
+	else
+	{
+		::memcpy(at(offset), pSrc, first*sizeof(T));
+		::memcpy(m_pBuffer, pSrc+first, (len-first)*sizeof(T));
+	}
+}
+
+//==============================================================================
+// RingBuffer<T>::copyOut
+//
+// Copies len elements starting at offset into pDest, which may require two
+// copy operations if the elements wrap around the end of the storage.
+//==============================================================================
+template<typename T>
+inline
+	void RingBuffer<T>::copyOut(size_t offset, T* pDest, size_t len) const
+{
+	QC_DBG_ASSERT(len <= m_capacity);
+	const size_t first = contiguous(offset);
+	if(len <= first)
+	{
+		::memcpy(pDest, at(offset), len*sizeof(T));
+	}
+	else
+	{
+		::memcpy(pDest, at(offset), first*sizeof(T));
+		::memcpy(pDest+first, m_pBuffer, (len-first)*sizeof(T));
+	}
+}
+
+//==============================================================================
+// RingBuffer<T>::rebase
+//
+// Maps offset onto the start of the storage.  This may only be called when
+// the buffer holds no data that is still required.
+//==============================================================================
+template<typename T>
+inline
+	void RingBuffer<T>::rebase(size_t offset)
+{
+	m_base = offset;
+}
+
+//==============================================================================
+// RingBuffer<T>::relocate
+//
+// Moves the elements in the range [from, to) into new storage of at least
+// capacity elements, with from at the start of the new storage so that the
+// range is contiguous.
+//==============================================================================
+template<typename T>
+inline
+	void RingBuffer<T>::relocate(size_t from, size_t to, size_t capacity)
+{
+	QC_DBG_ASSERT(to - from <= capacity);
+	const size_t newCapacity = RoundCapacity(capacity);
+	T* pNewBuffer = BufferPool::AllocateArray<T>(newCapacity);
+	if(to != from)
+	{
+		copyOut(from, pNewBuffer, to - from);
+	}
+	BufferPool::ReleaseArray(m_pBuffer, m_capacity);
+	m_pBuffer = pNewBuffer;
+	m_capacity = newCapacity;
+	m_base = from;
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_RingBuffer_h
@@ -88,7 +88,7 @@ StringReader::StringReader(const CharType* pStr, size_t length) :
 //==============================================================================
 void StringReader::close()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	m_markPos = -1;
 	m_bClosed = true;
@@ -106,7 +106,7 @@ void StringReader::close()
 //==============================================================================
 void StringReader::mark(size_t /*readLimit*/)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_bClosed) throw IOException(QC_T("stream is closed"));
 	m_markPos = m_pos;
@@ -120,7 +120,7 @@ void StringReader::mark(size_t /*readLimit*/)
 //==============================================================================
 void StringReader::reset()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_markPos == -1)
 	{
@@ -157,7 +157,7 @@ long StringReader::read(CharType* pBuffer, size_t bufLen)
 {
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 	
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_bClosed) throw IOException(QC_T("stream is closed"));
 
@@ -187,7 +187,7 @@ long StringReader::readAtomic(CharType* pBuffer, size_t bufLen)
 {
 	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
 
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_bClosed) throw IOException(QC_T("stream is closed"));
 
@@ -251,7 +251,7 @@ long StringReader::readAtomic(CharType* pBuffer, size_t bufLen)
 //==============================================================================
 Character StringReader::readAtomic()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_bClosed) throw IOException(QC_T("stream is closed"));
 	
@@ -77,7 +77,7 @@ StringWriter::StringWriter(size_t initialSize) :
 //==============================================================================
 void StringWriter::close()
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	m_bClosed = true;
 }
@@ -94,7 +94,7 @@ void StringWriter::close()
 //==============================================================================
 void StringWriter::write(const CharType* pBuf, size_t len)
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	if(m_bClosed) throw IOException(QC_T("cannot write to a closed stream"));
 
@@ -114,7 +114,7 @@ void StringWriter::write(const CharType* pBuf, size_t len)
 //==============================================================================
 String StringWriter::toString() const
 {
-	QC_SYNCHRONIZED_PTR(m_rpLock)
+	QC_SYNCHRONIZED_PTR_IF(m_rpLock, m_bSynchronized)
 
 	return String(m_buffer.data(), m_buffer.size());
 }
@@ -0,0 +1,465 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: TranscodingInputStream
+/**
+	@class qc::io::TranscodingInputStream
+	
+	@brief A FilterInputStream that converts the bytes of the contained
+	InputStream from one encoding into another.
+
+	Converting a byte stream from one encoding into another could be
+	achieved by reading it through an InputStreamReader and writing the
+	characters through an OutputStreamWriter.  A TranscodingInputStream
+	produces the same bytes without an intermediate buffer of Unicode
+	characters: common pairs of encodings (such as ISO-8859-1 and UTF-8,
+	or UTF-16 and UTF-8) are converted directly from bytes to bytes by a
+	Transcoder.
+
+    Invalid and unmappable characters are treated according to the policies
+	of the decoding and encoding CodeConverters, exactly as they would be by
+	an InputStreamReader and OutputStreamWriter.
+
+	@sa TranscodingOutputStream
+*/
+//==============================================================================
+
+#include "TranscodingInputStream.h"
+#include "IOException.h"
+#include "MalformedInputException.h"
+#include "UnsupportedEncodingException.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/SystemUtils.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+
+#include <string.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+using cvt::CodeConverterFactory;
+
+const size_t ByteBufferSize = 4096;
+const size_t MaxViewSize = 0x100000;
+
+//==============================================================================
+// TranscodingInputStream::TranscodingInputStream
+//
+/**
+   Constructs a TranscodingInputStream that converts bytes from
+   @c pInputStream from the encoding @c fromEncoding into the encoding
+   @c toEncoding.
+
+   The CodeConverters are obtained from the CodeConverterFactory.
+
+   @param pInputStream the contained InputStream.
+   @param fromEncoding the name of the encoding of the contained InputStream
+   @param toEncoding the name of the encoding of the bytes returned by read()
+   @throws NullPointerException if @c pInputStream is null.
+   @throws UnsupportedEncodingException if the CodeConverterFactory is unable
+           to create a CodeConverter for either encoding
+*/
+//==============================================================================
+TranscodingInputStream::TranscodingInputStream(InputStream* pInputStream,
+                                               const String& fromEncoding,
+                                               const String& toEncoding) :
+	FilterInputStream(pInputStream),
+	m_pByteBuffer(0), m_pNextByteAvailable(0), m_pNextByteFree(0),
+	m_byteBufferSize(0),
+	m_overflowNext(0),
+	m_overflowEnd(0),
+	m_bAtEof(false),
+	m_bUsingView(false)
+{
+	AutoPtr<CodeConverter> rpDecoder = CodeConverterFactory::GetInstance().getConverter(fromEncoding);
+	if(rpDecoder.isNull())
+	{
+		throw UnsupportedEncodingException(fromEncoding);
+	}
+
+	AutoPtr<CodeConverter> rpEncoder = CodeConverterFactory::GetInstance().getConverter(toEncoding);
+	if(rpEncoder.isNull())
+	{
+		throw UnsupportedEncodingException(toEncoding);
+	}
+
+	init(rpDecoder.get(), rpEncoder.get());
+}
+
+//==============================================================================
+// TranscodingInputStream::TranscodingInputStream
+//
+/**
+   Constructs a TranscodingInputStream that converts bytes from
+   @c pInputStream using @c pDecoder to decode the contained InputStream and
+   @c pEncoder to encode the bytes returned by read().
+
+   @param pInputStream the contained InputStream.
+   @param pDecoder the CodeConverter for the encoding of the contained InputStream
+   @param pEncoder the CodeConverter for the encoding of the bytes returned
+          by read()
+   @throws NullPointerException if any of the parameters is null.
+*/
+//==============================================================================
+TranscodingInputStream::TranscodingInputStream(InputStream* pInputStream,
+                                               CodeConverter* pDecoder,
+                                               CodeConverter* pEncoder) :
+	FilterInputStream(pInputStream),
+	m_pByteBuffer(0), m_pNextByteAvailable(0), m_pNextByteFree(0),
+	m_byteBufferSize(0),
+	m_overflowNext(0),
+	m_overflowEnd(0),
+	m_bAtEof(false),
+	m_bUsingView(false)
+{
+	init(pDecoder, pEncoder);
+}
+
+//==============================================================================
+// TranscodingInputStream::~TranscodingInputStream
+//
+//==============================================================================
+TranscodingInputStream::~TranscodingInputStream()
+{
+	freeBuffers();
+}
+
+//==============================================================================
+// TranscodingInputStream::init
+//
+// Common initialization (called from constructors)
+//==============================================================================
+void TranscodingInputStream::init(CodeConverter* pDecoder, CodeConverter* pEncoder)
+{
+	m_rpTranscoder = new Transcoder(pDecoder, pEncoder);
+
+	m_byteBufferSize = ByteBufferSize;
+	m_pByteBuffer = new Byte[m_byteBufferSize];
+	m_pNextByteAvailable = m_pNextByteFree = m_pByteBuffer;
+}
+
+//==============================================================================
+// TranscodingInputStream::freeBuffers
+//
+//==============================================================================
+void TranscodingInputStream::freeBuffers()
+{
+	delete [] m_pByteBuffer;
+	m_pNextByteFree = m_pNextByteAvailable = m_pByteBuffer = 0;
+	m_byteBufferSize = 0;
+	m_overflowNext = m_overflowEnd = 0;
+	m_bUsingView = false;
+}
+
+//==============================================================================
+// TranscodingInputStream::close
+//
+/**
+   Closes the TranscodingInputStream and its contained InputStream.
+   Further calls to close() have no effect.
+*/
+//==============================================================================
+void TranscodingInputStream::close()
+{
+	if(m_rpTranscoder)
+	{
+		FilterInputStream::close();
+		m_rpTranscoder.release();
+	}
+	freeBuffers();
+}
+
+//==============================================================================
+// TranscodingInputStream::available
+//
+/**
+   Returns the number of converted bytes that can be read without blocking.
+*/
+//==============================================================================
+size_t TranscodingInputStream::available()
+{
+	if(!m_rpTranscoder) throw IOException(QC_T("stream is closed"));
+
+	return m_overflowEnd - m_overflowNext;
+}
+
+//==============================================================================
+// TranscodingInputStream::mark
+//
+/**
+   The mark() operation is not supported.
+   @throws IOException always.
+*/
+//==============================================================================
+void TranscodingInputStream::mark(size_t readLimit)
+{
+	InputStream::mark(readLimit);
+}
+
+//==============================================================================
+// TranscodingInputStream::markSupported
+//
+/**
+   Returns false.
+*/
+//==============================================================================
+bool TranscodingInputStream::markSupported() const
+{
+	return false;
+}
+
+//==============================================================================
+// TranscodingInputStream::reset
+//
+/**
+   The reset() operation is not supported.
+   @throws IOException always.
+*/
+//==============================================================================
+void TranscodingInputStream::reset()
+{
+	InputStream::reset();
+}
+
+//==============================================================================
+// TranscodingInputStream::read
+//
+/**
+   Reads and returns a single converted ::Byte or InputStream::EndOfFile.
+*/
+//==============================================================================
+int TranscodingInputStream::read()
+{
+	return InputStream::read();
+}
+
+//==============================================================================
+// TranscodingInputStream::skip
+//
+/**
+   Reads and discards @c n converted bytes.
+   @returns the number of bytes skipped.
+*/
+//==============================================================================
+size_t TranscodingInputStream::skip(size_t n)
+{
+	Byte buffer[256];
+	size_t count = 0;
+
+	while(count < n)
+	{
+		const size_t len = (n - count < sizeof(buffer)) ? n - count : sizeof(buffer);
+		const long rc = read(buffer, len);
+		if(rc == EndOfFile)
+		{
+			break;
+		}
+		count += rc;
+	}
+	return count;
+}
+
+//==============================================================================
+// TranscodingInputStream::read
+//
+/**
+   Reads up to @c bufLen converted bytes into the buffer at @c pBuffer.
+
+   The converted form of a single character is never split between the
+   contained InputStream's reads, but it may be split between calls to
+   read() when @c bufLen is very small.
+
+   @returns the number of bytes read, or InputStream::EndOfFile.
+   @throws IOException if an I/O error occurs.
+   @throws CharacterCodingException if an invalid or unmappable character is
+           detected and the policy of the relevant CodeConverter is to abort.
+*/
+//==============================================================================
+long TranscodingInputStream::read(Byte* pBuffer, size_t bufLen)
+{
+	SystemUtils::TestBufferIsValid(pBuffer, bufLen);
+
+	if(!m_rpTranscoder) throw IOException(QC_T("stream is closed"));
+
+	//
+	// A buffer that may be too small to hold the converted form of a single
+	// character is filled from the overflow buffer.
+	//
+	if(m_overflowNext == m_overflowEnd && bufLen < OverflowBufferSize)
+	{
+		const long rc = readTranscoded(m_overflowBuffer, OverflowBufferSize);
+		if(rc == EndOfFile)
+		{
+			return EndOfFile;
+		}
+		m_overflowNext = 0;
+		m_overflowEnd = rc;
+	}
+
+	if(m_overflowNext < m_overflowEnd)
+	{
+		size_t count = m_overflowEnd - m_overflowNext;
+		if(count > bufLen) count = bufLen;
+		::memcpy(pBuffer, m_overflowBuffer + m_overflowNext, count);
+		m_overflowNext += count;
+		return long(count);
+	}
+
+	return readTranscoded(pBuffer, bufLen);
+}
+
+//==============================================================================
+// TranscodingInputStream::readTranscoded
+//
+// Converts bytes from the byte buffer directly into the caller's buffer,
+// refilling the byte buffer from the contained InputStream until at least
+// one byte has been produced.
+//==============================================================================
+long TranscodingInputStream::readTranscoded(Byte* pBuffer, size_t bufLen)
+{
+	long returnLen = 0;
+
+	while(true)
+	{
+		Byte* pNext;
+		const CodeConverter::Result ret = m_rpTranscoder->transcode(
+			m_pNextByteAvailable, m_pNextByteFree, (const Byte*&)m_pNextByteAvailable,
+			pBuffer, pBuffer+bufLen, pNext);
+
+		returnLen += long(pNext - pBuffer);
+
+		if(ret == CodeConverter::error && returnLen == 0)
+		{
+			throw MalformedInputException(QC_T("encoding error"), m_rpTranscoder->getDecoder().get());
+		}
+		else if(ret == CodeConverter::outputExhausted || returnLen)
+		{
+			break;
+		}
+		else if(m_bAtEof)
+		{
+			//
+			// A trailing incomplete sequence is treated according to
+			// the policy of the decoder
+			//
+			if(m_pNextByteAvailable < m_pNextByteFree)
+			{
+				m_rpTranscoder->endOfInput(m_pNextByteAvailable, m_pNextByteFree);
+				m_pNextByteAvailable = m_pNextByteFree;
+			}
+			else
+			{
+				break;
+			}
+		}
+		else
+		{
+			fillByteBuffer();
+		}
+	}
+
+	return returnLen ? returnLen : long(EndOfFile);
+}
+
+//==============================================================================
+// TranscodingInputStream::fillByteBuffer
+//
+// Moves any unconsumed bytes to the start of the byte buffer and reads
+// more bytes from the contained InputStream into the remainder.
+//
+// When the byte buffer is empty and the contained InputStream supports
+// views, the bytes are converted straight from the stream's storage.  Any
+// incomplete sequence left at the end of a view is copied into the byte
+// buffer before the stream is read again, as the view is only valid until
+// then.
+//==============================================================================
+void TranscodingInputStream::fillByteBuffer()
+{
+	if(m_bUsingView)
+	{
+		const size_t bytesLeft = m_pNextByteFree - m_pNextByteAvailable;
+		if(bytesLeft >= m_byteBufferSize)
+		{
+			throw IOException(QC_T("Input buffer too small to hold required sequence"));
+		}
+		::memcpy(m_pByteBuffer, m_pNextByteAvailable, bytesLeft);
+		m_pNextByteAvailable = m_pByteBuffer;
+		m_pNextByteFree = m_pByteBuffer + bytesLeft;
+		m_bUsingView = false;
+	}
+	else if(m_pNextByteAvailable > m_pByteBuffer)
+	{
+		const size_t bytesLeft = m_pNextByteFree - m_pNextByteAvailable;
+		::memmove(m_pByteBuffer, m_pNextByteAvailable, bytesLeft);
+		m_pNextByteAvailable = m_pByteBuffer;
+		m_pNextByteFree = m_pByteBuffer + bytesLeft;
+	}
+
+	if(m_pNextByteFree == m_pByteBuffer && getInputStream()->viewSupported())
+	{
+		const Byte* pView;
+		const long numBytes = getInputStream()->readView(pView, MaxViewSize);
+
+		if(numBytes == InputStream::EndOfFile)
+		{
+			m_bAtEof = true;
+		}
+		else
+		{
+			m_pNextByteAvailable = const_cast<Byte*>(pView);
+			m_pNextByteFree = m_pNextByteAvailable + numBytes;
+			m_bUsingView = true;
+		}
+		return;
+	}
+
+	const size_t freeBytes = (m_pByteBuffer + m_byteBufferSize) - m_pNextByteFree;
+	QC_DBG_ASSERT(freeBytes > 0);
+
+	const long numBytes = getInputStream()->read(m_pNextByteFree, freeBytes);
+
+	if(numBytes == InputStream::EndOfFile)
+	{
+		m_bAtEof = true;
+	}
+	else
+	{
+		m_pNextByteFree += numBytes;
+	}
+}
+
+//==============================================================================
+// TranscodingInputStream::getTranscoder
+//
+/**
+   Returns the Transcoder used to convert the contained InputStream.
+*/
+//==============================================================================
+AutoPtr<Transcoder> TranscodingInputStream::getTranscoder() const
+{
+	return m_rpTranscoder;
+}
+
+QC_IO_NAMESPACE_END
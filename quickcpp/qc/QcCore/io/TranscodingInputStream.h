@@ -0,0 +1,92 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: TranscodingInputStream
+// 
+//=============================================================================
+
+#ifndef QC_IO_TranscodingInputStream_h
+#define QC_IO_TranscodingInputStream_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "FilterInputStream.h"
+
+#include "QcCore/cvt/Transcoder.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+using cvt::Transcoder;
+
+class QC_IO_PKG TranscodingInputStream : public FilterInputStream
+{
+public:
+	TranscodingInputStream(InputStream* pInputStream, const String& fromEncoding,
+	                       const String& toEncoding);
+	TranscodingInputStream(InputStream* pInputStream, CodeConverter* pDecoder,
+	                       CodeConverter* pEncoder);
+
+	virtual ~TranscodingInputStream();
+
+	virtual void mark(size_t readLimit);
+	virtual bool markSupported() const;
+	virtual void reset();
+	virtual size_t available();
+	virtual void close();
+	virtual int read();
+	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual size_t skip(size_t n);
+
+	AutoPtr<Transcoder> getTranscoder() const;
+
+private:
+	TranscodingInputStream(const TranscodingInputStream& rhs);            // not implemented
+	TranscodingInputStream& operator=(const TranscodingInputStream& rhs); // not implemented
+
+	void init(CodeConverter* pDecoder, CodeConverter* pEncoder);
+	void freeBuffers();
+	void fillByteBuffer();
+	long readTranscoded(Byte* pBuffer, size_t bufLen);
+
+	enum {OverflowBufferSize = 16};
+
+private:
+	AutoPtr<Transcoder> m_rpTranscoder;
+	Byte* m_pByteBuffer;
+	Byte* m_pNextByteAvailable;
+	Byte* m_pNextByteFree;
+	size_t m_byteBufferSize;
+	Byte m_overflowBuffer[OverflowBufferSize];
+	size_t m_overflowNext;
+	size_t m_overflowEnd;
+	bool m_bAtEof;
+	bool m_bUsingView;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_TranscodingInputStream_h
@@ -0,0 +1,402 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: TranscodingOutputStream
+/**
+	@class qc::io::TranscodingOutputStream
+	
+	@brief A FilterOutputStream that converts bytes written to it from one
+	encoding into another before writing them to the contained OutputStream.
+
+	A TranscodingOutputStream produces the same bytes as reading through an
+	InputStreamReader and writing through an OutputStreamWriter, without an
+	intermediate buffer of Unicode characters.  Common pairs of encodings
+	are converted directly from bytes to bytes by a Transcoder.
+
+	Bytes may be written in arbitrary pieces: an incomplete sequence at the
+	end of one write() is held until the remaining bytes arrive.  If the
+	stream is closed part-way through a sequence, it is treated according
+	to the policy of the decoding CodeConverter.
+
+	@sa TranscodingInputStream
+*/
+//==============================================================================
+
+#include "TranscodingOutputStream.h"
+#include "IOException.h"
+#include "MalformedInputException.h"
+#include "UnsupportedEncodingException.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+
+#include <string.h>
+
+QC_IO_NAMESPACE_BEGIN
+
+using cvt::CodeConverterFactory;
+
+const size_t ByteBufferSize = 4096;
+
+//==============================================================================
+// TranscodingOutputStream::TranscodingOutputStream
+//
+/**
+   Constructs a TranscodingOutputStream that converts bytes from the encoding
+   @c fromEncoding into the encoding @c toEncoding before writing them to
+   @c pOutputStream.
+
+   The CodeConverters are obtained from the CodeConverterFactory.
+
+   @param pOutputStream the contained OutputStream.
+   @param fromEncoding the name of the encoding of the bytes passed to write()
+   @param toEncoding the name of the encoding of the contained OutputStream
+   @throws NullPointerException if @c pOutputStream is null.
+   @throws UnsupportedEncodingException if the CodeConverterFactory is unable
+           to create a CodeConverter for either encoding
+*/
+//==============================================================================
+TranscodingOutputStream::TranscodingOutputStream(OutputStream* pOutputStream,
+                                                 const String& fromEncoding,
+                                                 const String& toEncoding) :
+	FilterOutputStream(pOutputStream),
+	m_pByteBuffer(0),
+	m_byteBufferSize(0),
+	m_byteBufferUsed(0),
+	m_partialLen(0)
+{
+	AutoPtr<CodeConverter> rpDecoder = CodeConverterFactory::GetInstance().getConverter(fromEncoding);
+	if(rpDecoder.isNull())
+	{
+		throw UnsupportedEncodingException(fromEncoding);
+	}
+
+	AutoPtr<CodeConverter> rpEncoder = CodeConverterFactory::GetInstance().getConverter(toEncoding);
+	if(rpEncoder.isNull())
+	{
+		throw UnsupportedEncodingException(toEncoding);
+	}
+
+	init(rpDecoder.get(), rpEncoder.get());
+}
+
+//==============================================================================
+// TranscodingOutputStream::TranscodingOutputStream
+//
+/**
+   Constructs a TranscodingOutputStream that uses @c pDecoder to decode the
+   bytes passed to write() and @c pEncoder to encode them for
+   @c pOutputStream.
+
+   @param pOutputStream the contained OutputStream.
+   @param pDecoder the CodeConverter for the encoding of the bytes passed
+          to write()
+   @param pEncoder the CodeConverter for the encoding of the contained
+          OutputStream
+   @throws NullPointerException if any of the parameters is null.
+*/
+//==============================================================================
+TranscodingOutputStream::TranscodingOutputStream(OutputStream* pOutputStream,
+                                                 CodeConverter* pDecoder,
+                                                 CodeConverter* pEncoder) :
+	FilterOutputStream(pOutputStream),
+	m_pByteBuffer(0),
+	m_byteBufferSize(0),
+	m_byteBufferUsed(0),
+	m_partialLen(0)
+{
+	init(pDecoder, pEncoder);
+}
+
+//==============================================================================
+// TranscodingOutputStream::~TranscodingOutputStream
+//
+/**
+   The destructor writes any converted bytes to the contained OutputStream
+   before freeing resources associated with this TranscodingOutputStream.
+   An incomplete trailing sequence is discarded.
+*/
+//==============================================================================
+TranscodingOutputStream::~TranscodingOutputStream()
+{
+	if(m_rpTranscoder)
+	{
+		try
+		{
+			flush();
+		}
+		catch(Exception& /*e*/)
+		{
+		}
+	}
+	freeBuffers();
+}
+
+//==============================================================================
+// TranscodingOutputStream::init
+//
+// Common initialization (called from constructors)
+//==============================================================================
+void TranscodingOutputStream::init(CodeConverter* pDecoder, CodeConverter* pEncoder)
+{
+	m_rpTranscoder = new Transcoder(pDecoder, pEncoder);
+
+	m_byteBufferSize = ByteBufferSize;
+	m_pByteBuffer = new Byte[m_byteBufferSize];
+}
+
+//==============================================================================
+// TranscodingOutputStream::freeBuffers
+//
+//==============================================================================
+void TranscodingOutputStream::freeBuffers()
+{
+	delete [] m_pByteBuffer;
+	m_pByteBuffer = 0;
+	m_byteBufferSize = m_byteBufferUsed = 0;
+	m_partialLen = 0;
+}
+
+//==============================================================================
+// TranscodingOutputStream::close
+//
+/**
+   Writes any remaining converted bytes and closes the contained
+   OutputStream.  Further calls to close() have no effect.
+
+   @throws MalformedInputException if the bytes written so far end with an
+           incomplete sequence and the policy of the decoder is to abort.
+*/
+//==============================================================================
+void TranscodingOutputStream::close()
+{
+	if(m_rpTranscoder)
+	{
+		const size_t partialLen = m_partialLen;
+		m_partialLen = 0;
+		m_rpTranscoder->endOfInput(m_partialBuffer, m_partialBuffer+partialLen);
+		flush();
+		FilterOutputStream::close();
+		m_rpTranscoder.release();
+	}
+	freeBuffers();
+}
+
+//==============================================================================
+// TranscodingOutputStream::flush
+//
+/**
+   Writes all converted bytes to the contained OutputStream and flushes it.
+   An incomplete sequence at the end of the bytes written so far is retained
+   until the rest of the sequence is written.
+*/
+//==============================================================================
+void TranscodingOutputStream::flush()
+{
+	if(!m_rpTranscoder) throw IOException(QC_T("stream is closed"));
+
+	writePending();
+	FilterOutputStream::flush();
+}
+
+//==============================================================================
+// TranscodingOutputStream::flushBuffers
+//
+//==============================================================================
+void TranscodingOutputStream::flushBuffers()
+{
+	if(!m_rpTranscoder) throw IOException(QC_T("stream is closed"));
+
+	writePending();
+	FilterOutputStream::flushBuffers();
+}
+
+//==============================================================================
+// TranscodingOutputStream::write
+//
+//==============================================================================
+void TranscodingOutputStream::write(Byte x)
+{
+	write(&x, 1);
+}
+
+//==============================================================================
+// TranscodingOutputStream::write
+//
+/**
+   Converts @c bufLen bytes from the buffer at @c pBuffer.  Converted bytes
+   are written to the contained OutputStream whenever the internal buffer
+   becomes full.
+
+   @throws IOException if an I/O error occurs.
+   @throws CharacterCodingException if an invalid or unmappable character is
+           detected and the policy of the relevant CodeConverter is to abort.
+*/
+//==============================================================================
+void TranscodingOutputStream::write(const Byte* pBuffer, size_t bufLen)
+{
+	if(!pBuffer) throw NullPointerException();
+	if(!m_rpTranscoder) throw IOException(QC_T("stream is closed"));
+
+	//
+	// Complete the sequence left over from the previous write by
+	// appending bytes to it until it has been consumed.
+	//
+	if(m_partialLen)
+	{
+		const size_t oldLen = m_partialLen;
+		size_t copied = PartialBufferSize - oldLen;
+		if(copied > bufLen) copied = bufLen;
+		::memcpy(m_partialBuffer + oldLen, pBuffer, copied);
+
+		const Byte* pNext = transcodeBytes(m_partialBuffer, m_partialBuffer + oldLen + copied);
+		const size_t consumed = pNext - m_partialBuffer;
+
+		if(consumed < oldLen)
+		{
+			if(copied < bufLen)
+			{
+				throw MalformedInputException(m_partialBuffer, oldLen + copied,
+				                              m_rpTranscoder->getDecoder().get());
+			}
+			m_partialLen = oldLen + copied;
+			return;
+		}
+
+		m_partialLen = 0;
+		pBuffer += (consumed - oldLen);
+		bufLen -= (consumed - oldLen);
+	}
+
+	const Byte* pEnd = pBuffer + bufLen;
+	const Byte* pNext = transcodeBytes(pBuffer, pEnd);
+
+	const size_t remaining = pEnd - pNext;
+	if(remaining > PartialBufferSize)
+	{
+		throw MalformedInputException(pNext, remaining, m_rpTranscoder->getDecoder().get());
+	}
+	::memcpy(m_partialBuffer, pNext, remaining);
+	m_partialLen = remaining;
+}
+
+//==============================================================================
+// TranscodingOutputStream::transcodeBytes
+//
+// Converts bytes into the byte buffer, writing the buffer to the contained
+// OutputStream each time it becomes full.  Returns a pointer to the first
+// byte of any incomplete trailing sequence.
+//==============================================================================
+const Byte* TranscodingOutputStream::transcodeBytes(const Byte* pFrom, const Byte* pEnd)
+{
+	const Byte* pNext = pFrom;
+
+	while(true)
+	{
+		Byte* pStart = m_pByteBuffer + m_byteBufferUsed;
+		Byte* pTo;
+		const CodeConverter::Result ret = m_rpTranscoder->transcode(
+			pNext, pEnd, pNext,
+			pStart, m_pByteBuffer + m_byteBufferSize, pTo);
+
+		m_byteBufferUsed = pTo - m_pByteBuffer;
+
+		if(ret == CodeConverter::outputExhausted)
+		{
+			if(m_byteBufferUsed == 0)
+			{
+				throw IOException(QC_T("Output buffer too small to hold required sequence"));
+			}
+			writeByteBuffer();
+		}
+		else if(ret == CodeConverter::error)
+		{
+			//
+			// If bytes were converted before the error, the next call
+			// will raise the appropriate exception
+			//
+			if(pTo == pStart)
+			{
+				throw MalformedInputException(QC_T("encoding error"), m_rpTranscoder->getDecoder().get());
+			}
+		}
+		else
+		{
+			return pNext;
+		}
+	}
+}
+
+//==============================================================================
+// TranscodingOutputStream::writePending
+//
+// Writes every converted byte, including characters held by the Transcoder,
+// to the contained OutputStream.
+//==============================================================================
+void TranscodingOutputStream::writePending()
+{
+	while(m_rpTranscoder->hasPendingOutput())
+	{
+		Byte* pTo;
+		m_rpTranscoder->flush(m_pByteBuffer + m_byteBufferUsed,
+		                      m_pByteBuffer + m_byteBufferSize, pTo);
+		const bool bProgress = (pTo > m_pByteBuffer + m_byteBufferUsed);
+		m_byteBufferUsed = pTo - m_pByteBuffer;
+
+		if(!bProgress && m_byteBufferUsed == 0)
+		{
+			throw IOException(QC_T("Output buffer too small to hold required sequence"));
+		}
+		writeByteBuffer();
+	}
+	writeByteBuffer();
+}
+
+//==============================================================================
+// TranscodingOutputStream::writeByteBuffer
+//
+//==============================================================================
+void TranscodingOutputStream::writeByteBuffer()
+{
+	if(m_byteBufferUsed)
+	{
+		FilterOutputStream::write(m_pByteBuffer, m_byteBufferUsed);
+		m_byteBufferUsed = 0;
+	}
+}
+
+//==============================================================================
+// TranscodingOutputStream::getTranscoder
+//
+/**
+   Returns the Transcoder used to convert the bytes written to this stream.
+*/
+//==============================================================================
+AutoPtr<Transcoder> TranscodingOutputStream::getTranscoder() const
+{
+	return m_rpTranscoder;
+}
+
+QC_IO_NAMESPACE_END
@@ -0,0 +1,86 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: TranscodingOutputStream
+// 
+//=============================================================================
+
+#ifndef QC_IO_TranscodingOutputStream_h
+#define QC_IO_TranscodingOutputStream_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "FilterOutputStream.h"
+
+#include "QcCore/cvt/Transcoder.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+using cvt::Transcoder;
+
+class QC_IO_PKG TranscodingOutputStream : public FilterOutputStream
+{
+public:
+	TranscodingOutputStream(OutputStream* pOutputStream, const String& fromEncoding,
+	                        const String& toEncoding);
+	TranscodingOutputStream(OutputStream* pOutputStream, CodeConverter* pDecoder,
+	                        CodeConverter* pEncoder);
+
+	virtual ~TranscodingOutputStream();
+
+	virtual void close();
+	virtual void flush();
+	virtual void flushBuffers();
+	virtual void write(Byte x);
+	virtual void write(const Byte* pBuffer, size_t bufLen);
+
+	AutoPtr<Transcoder> getTranscoder() const;
+
+private:
+	TranscodingOutputStream(const TranscodingOutputStream& rhs);            // not implemented
+	TranscodingOutputStream& operator=(const TranscodingOutputStream& rhs); // not implemented
+
+	void init(CodeConverter* pDecoder, CodeConverter* pEncoder);
+	void freeBuffers();
+	const Byte* transcodeBytes(const Byte* pFrom, const Byte* pEnd);
+	void writePending();
+	void writeByteBuffer();
+
+	enum {PartialBufferSize = 8};
+
+private:
+	AutoPtr<Transcoder> m_rpTranscoder;
+	Byte* m_pByteBuffer;
+	size_t m_byteBufferSize;
+	size_t m_byteBufferUsed;
+	Byte m_partialBuffer[PartialBufferSize];
+	size_t m_partialLen;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_TranscodingOutputStream_h
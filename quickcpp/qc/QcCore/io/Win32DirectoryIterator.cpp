@@ -0,0 +1,140 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Win32DirectoryIterator
+//
+// The search is started by Win32FileSystem::openDirectory(), which passes
+// the handle and the first entry found.  FindNextFile() returns the
+// attributes, length and modification time of every entry along with its
+// name, so the status of each entry is always known and the FetchStatus
+// flag makes no difference.
+//
+// Reparse points, which include symbolic links and junctions, are reported
+// as symbolic links so that they are not mistaken for directories.
+//
+//==============================================================================
+
+#ifdef WIN32
+
+#include "Win32DirectoryIterator.h"
+#include "IOException.h"
+
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/base/SystemUtils.h"
+#include "QcCore/util/Win32Utils.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+using util::Win32Utils;
+
+Win32DirectoryIterator::Win32DirectoryIterator(const String& path, HANDLE hFind,
+                                               const WIN32_FIND_DATA& firstEntry) :
+	DirectoryIterator(path),
+	m_hFind(hFind),
+	m_findData(firstEntry),
+	m_bPending(true)
+{
+}
+
+Win32DirectoryIterator::~Win32DirectoryIterator()
+{
+	close();
+}
+
+//==============================================================================
+// Win32DirectoryIterator::next
+//
+//==============================================================================
+bool Win32DirectoryIterator::next()
+{
+	while(m_hFind != INVALID_HANDLE_VALUE)
+	{
+		if(m_bPending)
+		{
+			m_bPending = false;
+		}
+		else if(!::FindNextFile(m_hFind, &m_findData))
+		{
+			const DWORD errCode = ::GetLastError();
+			close();
+			if(errCode == ERROR_NO_MORE_FILES)
+			{
+				return false;
+			}
+			String errMsg = getDirectoryPath() + QC_T(" (");
+			errMsg += SystemUtils::GetWin32ErrorString(errCode);
+			errMsg += QC_T(")");
+			throw IOException(errMsg);
+		}
+
+		const String name = StringUtils::FromWin32String(m_findData.cFileName);
+		//
+		// Filter out the ".." (parent) and "." (this) directory names
+		//
+		if(name == QC_T(".") || name == QC_T(".."))
+		{
+			continue;
+		}
+
+		const DWORD dwAttrs = m_findData.dwFileAttributes;
+		const EntryType type = (dwAttrs & FILE_ATTRIBUTE_REPARSE_POINT) ? SymbolicLink
+		                     : (dwAttrs & FILE_ATTRIBUTE_DIRECTORY) ? Directory
+		                     : (dwAttrs & FILE_ATTRIBUTE_DEVICE) ? Other
+		                     : RegularFile;
+
+		const unsigned __int64 length =
+			((unsigned __int64)m_findData.nFileSizeHigh << 32) | m_findData.nFileSizeLow;
+
+		DateTime lastModified;
+		SYSTEMTIME sysTime;
+		if(::FileTimeToSystemTime(&m_findData.ftLastWriteTime, &sysTime))
+		{
+			lastModified = Win32Utils::SystemTimeToDateTime(&sysTime);
+		}
+
+		setEntry(name, type);
+		setStatus(type, size_t(length), lastModified);
+		return true;
+	}
+
+	return false;
+}
+
+//==============================================================================
+// Win32DirectoryIterator::close
+//
+//==============================================================================
+void Win32DirectoryIterator::close()
+{
+	if(m_hFind != INVALID_HANDLE_VALUE)
+	{
+		::FindClose(m_hFind);
+		m_hFind = INVALID_HANDLE_VALUE;
+	}
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //WIN32
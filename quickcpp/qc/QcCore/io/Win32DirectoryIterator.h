@@ -0,0 +1,59 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Win32DirectoryIterator
+// 
+//==============================================================================
+
+#ifndef QC_IO_Win32DirectoryIterator_h
+#define QC_IO_Win32DirectoryIterator_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "DirectoryIterator.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG Win32DirectoryIterator : public DirectoryIterator
+{
+public:
+	Win32DirectoryIterator(const String& path, HANDLE hFind,
+	                       const WIN32_FIND_DATA& firstEntry);
+	virtual ~Win32DirectoryIterator();
+
+	virtual bool next();
+	virtual void close();
+
+private:
+	HANDLE m_hFind;
+	WIN32_FIND_DATA m_findData;
+	bool m_bPending;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_Win32DirectoryIterator_h
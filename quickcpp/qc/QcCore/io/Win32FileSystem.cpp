@@ -30,7 +30,9 @@
 #include "FileNotFoundException.h"
 #include "ExistingFileException.h"
 #include "IOException.h"
+#include "Win32DirectoryIterator.h"
 #include "Win32FileDescriptor.h"
+#include "Win32MappedByteBuffer.h"
 
 #include "QcCore/base/Tracer.h"
 #include "QcCore/base/NullPointerException.h"
@@ -302,6 +304,33 @@ std::list<String> Win32FileSystem::listDirectory(const String& path) const
 	return ret;
 }
 
+//==============================================================================
+// Win32FileSystem::openDirectory
+//
+// The search handle is owned by the Win32DirectoryIterator, which closes it.
+//==============================================================================
+AutoPtr<DirectoryIterator> Win32FileSystem::openDirectory(const String& path, int /*flags*/) const
+{
+	if(!(getFileAttributeFlags(path) & Directory))
+	{
+		throw FileNotFoundException(path);
+	}
+
+	String wildPath = path;
+	wildPath += getSeparatorChar();
+	wildPath += '*';
+
+	WIN32_FIND_DATA findData;
+	HANDLE hFind = ::FindFirstFile(GetWin32Filename(wildPath).get(), &findData);
+
+	if(hFind == INVALID_HANDLE_VALUE)
+	{
+		TranslateCodeToException(0, path);
+	}
+
+	return new Win32DirectoryIterator(path, hFind, findData);
+}
+
 //==============================================================================
 // Win32FileSystem::createDirectory
 //
@@ -452,6 +481,9 @@ AutoPtr<FileDescriptor> Win32FileSystem::openFile(const String& path,
 	case OpenCreateTruncate:
 		dwCreationDisposition = CREATE_ALWAYS;
 		break;
+	case OpenCreate:
+		dwCreationDisposition = OPEN_ALWAYS;
+		break;
 	}
 
 	//
@@ -467,6 +499,8 @@ AutoPtr<FileDescriptor> Win32FileSystem::openFile(const String& path,
 		if(attributes & Hidden)   dwFlagsAndAttributes |= FILE_ATTRIBUTE_HIDDEN;
 	}
 
+	if(accessMode & DirectAccess) dwFlagsAndAttributes |= FILE_FLAG_NO_BUFFERING;
+
 	HANDLE hFile = ::CreateFile(GetWin32Filename(path).get(), 
 	                            dwDesiredAccess,
 	                            dwShareMode,
@@ -584,6 +618,50 @@ size_t Win32FileSystem::getLength(const String& path) const
 	return findbuf.nFileSizeLow;
 }
 
+//==============================================================================
+// Win32FileSystem::getFileStatus
+//
+// GetFileAttributesEx() returns the attributes, length and modification
+// time of the file in one call.
+//
+// Does not throw any exceptions
+//==============================================================================
+FileStatus Win32FileSystem::getFileStatus(const String& path) const
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if(!::GetFileAttributesEx(GetWin32Filename(path).get(), GetFileExInfoStandard, &data))
+	{
+		return FileStatus();
+	}
+
+	int attributes = FileSystem::Exists;
+	int accessModes = ReadAccess;
+
+	if(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+		attributes |= FileSystem::Directory;
+	else
+		attributes |= FileSystem::RegularFile;
+
+	if(data.dwFileAttributes & FILE_ATTRIBUTE_HIDDEN)   attributes |= FileSystem::Hidden;
+
+	if(data.dwFileAttributes & FILE_ATTRIBUTE_READONLY)
+		attributes |= FileSystem::ReadOnly;
+	else
+		accessModes |= WriteAccess;
+
+	const unsigned __int64 length =
+		((unsigned __int64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+
+	DateTime lastModified;
+	SYSTEMTIME sysTime;
+	if(::FileTimeToSystemTime(&data.ftLastWriteTime, &sysTime))
+	{
+		lastModified = Win32Utils::SystemTimeToDateTime(&sysTime);
+	}
+
+	return FileStatus(attributes, accessModes, size_t(length), lastModified);
+}
+
 //==============================================================================
 // Win32FileSystem::deleteFile
 //
@@ -675,6 +753,190 @@ void Win32FileSystem::writeFile(FileDescriptor* pFD, const Byte* pBuffer, size_t
 	}
 }
 
+//==============================================================================
+// Win32FileSystem::getFileLength
+//
+//==============================================================================
+FileOffset Win32FileSystem::getFileLength(FileDescriptor* pFD) const
+{
+	if(!pFD) throw NullPointerException();
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	DWORD sizeHigh;
+	const DWORD sizeLow = ::GetFileSize(pMyFD->getHandle(), &sizeHigh);
+	if(sizeLow == INVALID_FILE_SIZE && ::GetLastError() != NO_ERROR)
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(::GetLastError()));
+	}
+	return (FileOffset(sizeHigh) << 32) | sizeLow;
+}
+
+//==============================================================================
+// Win32FileSystem::getFilePosition
+//
+//==============================================================================
+FileOffset Win32FileSystem::getFilePosition(FileDescriptor* pFD) const
+{
+	if(!pFD) throw NullPointerException();
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	LONG posHigh = 0;
+	const DWORD posLow = ::SetFilePointer(pMyFD->getHandle(), 0, &posHigh, FILE_CURRENT);
+	if(posLow == INVALID_SET_FILE_POINTER && ::GetLastError() != NO_ERROR)
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(::GetLastError()));
+	}
+	return (FileOffset(DWORD(posHigh)) << 32) | posLow;
+}
+
+//==============================================================================
+// Win32FileSystem::setFilePosition
+//
+//==============================================================================
+void Win32FileSystem::setFilePosition(FileDescriptor* pFD, FileOffset pos) const
+{
+	if(!pFD) throw NullPointerException();
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	LONG posHigh = LONG(pos >> 32);
+	const DWORD posLow
+ = ::SetFilePointer(pMyFD->getHandle(), LONG(DWORD(pos)), &posHigh, FILE_BEGIN);
+	if(posLow == INVALID_SET_FILE_POINTER && ::GetLastError() != NO_ERROR)
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(::GetLastError()));
+	}
+}
+
+//==============================================================================
+// Win32FileSystem::readFileAt
+//
+// ReadFile() reads from the offset given in the OVERLAPPED structure.  For a
+// handle opened for synchronous i/o this also moves the file pointer, but
+// concurrent positional reads do not disturb one another.
+//==============================================================================
+size_t Win32FileSystem::readFileAt(FileDescriptor* pFD, FileOffset pos, Byte* pBuffer, size_t bufLen) const
+{
+	if(!pFD) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	OVERLAPPED overlapped;
+	::ZeroMemory(&overlapped, sizeof(overlapped));
+	overlapped.Offset = DWORD(pos);
+	overlapped.OffsetHigh = DWORD(pos >> 32);
+	DWORD bytesRead;
+	const BOOL bSuccess = ::ReadFile(pMyFD->getHandle(), pBuffer, bufLen, &bytesRead, &overlapped);
+	if(!bSuccess)
+	{
+		const DWORD errorCode = ::GetLastError();
+		if(errorCode == ERROR_HANDLE_EOF)
+		{
+			return 0;
+		}
+		throw IOException(SystemUtils::GetWin32ErrorString(errorCode));
+	}
+	return bytesRead;
+}
+
+//==============================================================================
+// Win32FileSystem::writeFileAt
+//
+//==============================================================================
+void Win32FileSystem::writeFileAt(FileDescriptor* pFD, FileOffset pos, const Byte* pBuffer, size_t bufLen) const
+{
+	if(!pFD) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	OVERLAPPED overlapped;
+	::ZeroMemory(&overlapped, sizeof(overlapped));
+	overlapped.Offset = DWORD(pos);
+	overlapped.OffsetHigh = DWORD(pos >> 32);
+	DWORD bytesWritten;
+	const BOOL bSuccess = ::WriteFile(pMyFD->getHandle(), pBuffer, bufLen, &bytesWritten, &overlapped);
+	if(!bSuccess)
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(::GetLastError()));
+	}
+}
+
+//==============================================================================
+// Win32FileSystem::setFileLength
+//
+// SetEndOfFile() truncates or extends the file at the file pointer, so the
+// pointer is moved to the new length and then restored.
+//==============================================================================
+void Win32FileSystem::setFileLength(FileDescriptor* pFD, FileOffset length) const
+{
+	const FileOffset pos = getFilePosition(pFD);
+
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	setFilePosition(pFD, length);
+	const BOOL bSuccess = ::SetEndOfFile(pMyFD->getHandle());
+	const DWORD errorCode = ::GetLastError();
+	setFilePosition(pFD, pos);
+	if(!bSuccess)
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(errorCode));
+	}
+}
+
+//==============================================================================
+// Win32FileSystem::syncFile
+//
+// FlushFileBuffers() always writes the metadata as well as the data.
+//==============================================================================
+void Win32FileSystem::syncFile(FileDescriptor* pFD, bool /*bMetadata*/) const
+{
+	if(!pFD) throw NullPointerException();
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+	if(!::FlushFileBuffers(pMyFD->getHandle()))
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(::GetLastError()));
+	}
+}
+
+//==============================================================================
+// Win32FileSystem::mapFile
+//
+// MapViewOfFile() requires the file offset to be a multiple of the
+// allocation granularity, so the view is started at the preceding multiple
+// and the Win32MappedByteBuffer is told how far into the view the requested
+// bytes begin.
+//==============================================================================
+AutoPtr<MappedByteBuffer> Win32FileSystem::mapFile(FileDescriptor* pFD, FileOffset offset, size_t length) const
+{
+	if(!pFD) throw NullPointerException();
+	if(!length) throw IllegalArgumentException(QC_T("zero mapping length"));
+
+	Win32FileDescriptor* pMyFD = static_cast<Win32FileDescriptor*>(pFD);
+
+	SYSTEM_INFO info;
+	::GetSystemInfo(&info);
+	const size_t dataOffset = size_t(offset % info.dwAllocationGranularity);
+	const FileOffset viewOffset = offset - dataOffset;
+
+	HANDLE hMapping = ::CreateFileMapping(pMyFD->getHandle(), NULL, PAGE_READONLY, 0, 0, NULL);
+	if(!hMapping)
+	{
+		throw IOException(SystemUtils::GetWin32ErrorString(::GetLastError()));
+	}
+
+	void* pView = ::MapViewOfFile(hMapping, FILE_MAP_READ, DWORD(viewOffset >> 32), DWORD(viewOffset),
+
+	                              length+dataOffset);
+	if(!pView)
+	{
+		const DWORD errCode = ::GetLastError();
+		::CloseHandle(hMapping);
+		throw IOException(SystemUtils::GetWin32ErrorString(errCode));
+	}
+
+	return new Win32MappedByteBuffer(hMapping, pView, length+dataOffset, dataOffset, offset);
+}
+
 CharType Win32FileSystem::getSeparatorChar() const
 {
 	return '\\';
@@ -0,0 +1,66 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Win32MappedByteBuffer
+// 
+// The view is mapped by Win32FileSystem::mapFile() from a multiple of the
+// system allocation granularity, so the start of the view may precede the
+// first byte that was requested.
+//
+// Windows has no equivalent of madvise() that is available on all supported
+// versions, so advise() does nothing.  The cache manager detects sequential
+// access to mapped views by itself.
+//
+//==============================================================================
+
+#ifdef WIN32
+
+#include "Win32MappedByteBuffer.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+Win32MappedByteBuffer::Win32MappedByteBuffer(HANDLE hMapping, void* pView,
+                                             size_t viewLength, size_t dataOffset,
+                                             FileOffset fileOffset) :
+
+	MappedByteBuffer(static_cast<const Byte*>(pView)+dataOffset, viewLength-dataOffset, fileOffset),
+	m_hMapping(hMapping),
+	m_pView(pView)
+{
+}
+
+Win32MappedByteBuffer::~Win32MappedByteBuffer()
+{
+	::UnmapViewOfFile(m_pView);
+	::CloseHandle(m_hMapping);
+}
+
+void Win32MappedByteBuffer::advise(Advice /*advice*/, size_t /*offset*/, size_t /*len*/)
+{
+}
+
+QC_IO_NAMESPACE_END
+
+#endif //WIN32
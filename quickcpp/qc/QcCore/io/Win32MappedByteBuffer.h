@@ -0,0 +1,58 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Win32MappedByteBuffer
+// 
+//==============================================================================
+
+#ifndef QC_IO_Win32MappedByteBuffer_h
+#define QC_IO_Win32MappedByteBuffer_h
+
+#ifndef QC_IO_DEFS_h
+#include "defs.h"
+#endif //QC_IO_DEFS_h
+
+#include "MappedByteBuffer.h"
+
+QC_IO_NAMESPACE_BEGIN
+
+class QC_IO_PKG Win32MappedByteBuffer : public MappedByteBuffer
+{
+public:
+	Win32MappedByteBuffer(HANDLE hMapping, void* pView, size_t viewLength,
+	                      size_t dataOffset, FileOffset fileOffset);
+
+	virtual ~Win32MappedByteBuffer();
+
+	virtual void advise(Advice advice, size_t offset, size_t len);
+
+private:
+	HANDLE m_hMapping;
+	void* m_pView;
+};
+
+QC_IO_NAMESPACE_END
+
+#endif //QC_IO_Win32MappedByteBuffer_h
@@ -47,6 +47,10 @@
 	SynchronizedObject, which gives it the ability to protect its internal
 	state from concurrent access from multiple threads.  All public methods 
 	are synchronized for safe concurrent access.
+
+	A Writer that is only ever used by one thread can avoid the cost of
+	acquiring the lock for every call by being switched into an
+	unsynchronized mode with setSynchronized().
 */
 //==============================================================================
 
@@ -64,7 +68,8 @@ QC_IO_NAMESPACE_BEGIN
 */
 //==============================================================================
 Writer::Writer() :
-	m_rpLock(this, this)
+	m_rpLock(this, this),
+	m_bSynchronized(true)
 {
 }
 
@@ -79,7 +84,8 @@ Writer::Writer() :
 */
 //==============================================================================
 Writer::Writer(SynchronizedObject* pLockObject) :
-	m_rpLock(this, pLockObject)
+	m_rpLock(this, pLockObject),
+	m_bSynchronized(true)
 {
 	if(!pLockObject) throw NullPointerException();
 }
@@ -199,6 +205,50 @@ AutoPtr<SynchronizedObject> Writer::getLock() const
 	return pLock;
 }
 
+//==============================================================================
+// Writer::isSynchronized
+//
+/**
+   Returns @c true if the public methods of this Writer acquire the lock
+   returned by getLock(); @c false if the Writer is in unsynchronized mode.
+   @sa setSynchronized()
+*/
+//==============================================================================
+bool Writer::isSynchronized() const
+{
+	return m_bSynchronized;
+}
+
+//==============================================================================
+// Writer::setSynchronized
+//
+/**
+   Switches this Writer between synchronized and unsynchronized mode.
+
+   In synchronized mode, which is the default, every public method acquires
+   the lock returned by getLock() so that the Writer may safely be used by
+   several threads at once.  In unsynchronized mode the lock is not acquired,
+   which makes each call cheaper.  This is only safe when the Writer, and
+   every other Writer that shares its lock, is confined to a single thread.
+
+   A Writer that wraps another Writer passes the setting on to the
+   contained Writer, so the mode of a complete chain can be set by calling
+   this method on the outermost object.  A wrapper also adopts the mode of
+   the Writer it wraps when it is constructed.
+
+   This method is not synchronized: it should be called before the Writer
+   is shared, typically straight after it is constructed.
+
+   @param bSynchronized @c false to stop acquiring the lock; @c true to
+          restore the default behaviour.
+   @sa isSynchronized()
+*/
+//==============================================================================
+void Writer::setSynchronized(bool bSynchronized)
+{
+	m_bSynchronized = bSynchronized;
+}
+
 #ifdef QC_DOCUMENTATION_ONLY
 //=============================================================================
 //
@@ -67,6 +67,8 @@ public:
 	virtual void write(const String& str);
 
 	AutoPtr<SynchronizedObject> getLock() const;
+	bool isSynchronized() const;
+	virtual void setSynchronized(bool bSynchronized);
 
 protected:
 	/**
@@ -74,6 +76,7 @@ protected:
 	* multi-threaded access to synchronized methods.
 	*/
 	AutoPtrMember<SynchronizedObject> m_rpLock;
+	bool m_bSynchronized;
 
 private:
 	Writer(const Writer& rhs);            // cannot be copied
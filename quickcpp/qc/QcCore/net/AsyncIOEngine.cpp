@@ -0,0 +1,661 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: AsyncIOEngine
+/**
+	@class qc::net::AsyncIOEngine
+	
+	@brief Performs reads and writes on files and sockets asynchronously.
+
+	An AsyncIOEngine lets an application start many I/O operations and carry
+	on with other work while they are performed.  Each of the methods read(),
+	write(), receive(), send(), accept() and connect() prepares an Operation
+	and returns it straight away.  Prepared operations are started together
+	by submit(), so that a batch of requests costs as little as one system
+	call.
+
+	An Operation acts as a future: get() waits for it to complete and returns
+	its result, throwing an exception if it failed.  Alternatively a Handler
+	can be passed when the operation is prepared, and its
+	Handler::operationCompleted() method is called as soon as the operation
+	completes.  Handlers are called on a thread belonging to the engine, so
+	they should do little work and must be thread-safe.  Calling get() on an
+	operation that has not yet been submitted submits it.
+
+	The buffers passed to read(), write(), receive() and send() are used
+	after the method returns, and must not be freed or reused until the
+	operation has completed.  The engine holds references to the file and
+	socket descriptors until then.
+
+	Each Operation holds a reference to the engine that prepared it, and the
+	engine holds its prepared and in-progress operations.  An engine with
+	operations outstanding is therefore not destroyed when the application
+	releases its own references.  Call shutdown() once the engine is no
+	longer needed; it completes the outstanding operations and breaks these
+	references.
+
+	Create() returns the best engine available on the platform.  On Linux
+	this is a UringIOEngine, which uses the io_uring interface to perform
+	the operations in the kernel without tying up any threads.  Where
+	io_uring is not available a ThreadPoolIOEngine is returned instead,
+	which performs each operation as a blocking call on a pooled thread.
+
+	A file Read or Write operation reads or writes at an explicit offset and
+	does not change the file position.  As with the corresponding system
+	calls, Read, Receive and Send operations may transfer fewer bytes than
+	requested; a Read or Receive that transfers zero bytes indicates the end
+	of the file or connection.
+*/
+//==============================================================================
+
+#include "AsyncIOEngine.h"
+#include "ConnectException.h"
+#include "InetAddress.h"
+#include "NetUtils.h"
+#include "SocketException.h"
+#include "ThreadPoolIOEngine.h"
+#include "UringIOEngine.h"
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/SystemUtils.h"
+#include "QcCore/io/IOException.h"
+
+#include <string.h>
+
+QC_NET_NAMESPACE_BEGIN
+
+using io::IOException;
+
+//==============================================================================
+// AsyncIOEngine::Operation::Operation
+//
+//==============================================================================
+AsyncIOEngine::Operation::Operation(AsyncIOEngine* pEngine, Type type, Handler* pHandler) :
+	m_rpEngine(pEngine),
+	m_type(type),
+	m_rpHandler(pHandler),
+	m_pBuffer(0),
+	m_length(0),
+	m_offset(0),
+	m_addressLength(0),
+	m_bDone(false),
+	m_result(0),
+	m_errorCode(0)
+{
+	::memset(&m_address, 0, sizeof(m_address));
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::getType
+//
+/**
+   Returns the type of this Operation.
+*/
+//==============================================================================
+AsyncIOEngine::Operation::Type AsyncIOEngine::Operation::getType() const
+{
+	return m_type;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::isDone
+//
+/**
+   Tests if this Operation has completed, successfully or not.
+*/
+//==============================================================================
+bool AsyncIOEngine::Operation::isDone() const
+{
+	QC_SYNCHRONIZED
+	return m_bDone;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::get
+//
+/**
+   Waits for this Operation to complete and returns its result.  If the
+   operation has not yet been submitted, the engine's prepared operations are
+   submitted first.
+
+   @returns the number of bytes transferred.  Accept and Connect operations
+            return zero; use getSocketDescriptor() to obtain the connected
+            socket.
+   @throws IOException if a file operation failed.
+   @throws SocketException if a socket operation failed.
+*/
+//==============================================================================
+size_t AsyncIOEngine::Operation::get()
+{
+	if(!isDone())
+	{
+		m_rpEngine->submit();
+	}
+
+#ifdef QC_MT
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+		while(!m_bDone)
+		{
+			wait();
+		}
+	}
+#endif //QC_MT
+
+	if(m_errorCode)
+	{
+		throwError();
+	}
+	return m_result;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::waitFor
+//
+/**
+   Waits up to @c timeoutMS milliseconds for this Operation to complete.  If
+   the operation has not yet been submitted, the engine's prepared operations
+   are submitted first.
+
+   @param timeoutMS the maximum time to wait, in milliseconds
+   @returns @c true if the operation has completed; @c false otherwise.
+*/
+//==============================================================================
+bool AsyncIOEngine::Operation::waitFor(size_t timeoutMS)
+{
+	if(!isDone())
+	{
+		m_rpEngine->submit();
+	}
+
+	QC_SYNCHRONIZED
+#ifdef QC_MT
+	if(!m_bDone && timeoutMS)
+	{
+		wait(timeoutMS);
+	}
+#else
+	(void)timeoutMS;
+#endif //QC_MT
+	return m_bDone;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::getResult
+//
+/**
+   Returns the number of bytes transferred by a completed Operation, or zero
+   if it failed or has not completed.
+*/
+//==============================================================================
+size_t AsyncIOEngine::Operation::getResult() const
+{
+	QC_SYNCHRONIZED
+	return m_result;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::getErrorCode
+//
+/**
+   Returns the operating system's error code for a failed Operation, or zero
+   if it succeeded or has not completed.  If an operation failed for a
+   reason that has no error code, -1 is returned.
+*/
+//==============================================================================
+int AsyncIOEngine::Operation::getErrorCode() const
+{
+	QC_SYNCHRONIZED
+	return m_errorCode;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::getSocketDescriptor
+//
+/**
+   Returns the socket used by this Operation.  For a completed Accept
+   operation this is the newly accepted socket, and for a Connect operation
+   it is the socket created for the connection.  A null AutoPtr is returned
+   for file operations and for an Accept operation that has not succeeded.
+*/
+//==============================================================================
+AutoPtr<SocketDescriptor> AsyncIOEngine::Operation::getSocketDescriptor() const
+{
+	QC_SYNCHRONIZED
+	return m_rpSocket;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::getInetAddress
+//
+/**
+   Returns the remote address of the socket for an Accept operation that
+   has succeeded, or the address being connected to by a Connect operation.
+   Otherwise a null AutoPtr is returned.
+*/
+//==============================================================================
+AutoPtr<InetAddress> AsyncIOEngine::Operation::getInetAddress() const
+{
+	QC_SYNCHRONIZED
+	if((m_type == Accept && m_bDone && !m_errorCode) || m_type == Connect)
+	{
+		return InetAddress::FromNetworkAddress(
+			reinterpret_cast<const struct sockaddr*>(m_address.bytes), m_addressLength);
+	}
+	return 0;
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::complete
+//
+// Records the outcome of the operation, wakes any threads waiting for it and
+// calls the Handler.  Exceptions thrown by the Handler are ignored as there
+// is nobody to report them to.
+//==============================================================================
+void AsyncIOEngine::Operation::complete(long result, int errorCode)
+{
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+		m_result = errorCode ? 0 : size_t(result);
+		m_errorCode = errorCode;
+		m_bDone = true;
+#ifdef QC_MT
+		notifyAll();
+#endif //QC_MT
+	}
+
+	if(m_rpHandler)
+	{
+		try
+		{
+			m_rpHandler->operationCompleted(this);
+		}
+		catch(Exception& /*e*/)
+		{
+		}
+	}
+}
+
+//==============================================================================
+// AsyncIOEngine::Operation::throwError
+//
+// Throws the exception that corresponds to the operation's error code.
+//==============================================================================
+void AsyncIOEngine::Operation::throwError() const
+{
+	const String errMsg = (m_errorCode == -1)
+		? String(QC_T("asynchronous operation failed"))
+		: NetUtils::GetSocketErrorString(m_errorCode);
+
+	switch(m_type)
+	{
+	case Read:
+	case Write:
+		throw IOException(errMsg);
+	case Connect:
+		throw ConnectException(errMsg);
+	default:
+		throw SocketException(errMsg);
+	}
+}
+
+//==============================================================================
+// AsyncIOEngine::AsyncIOEngine
+//
+//==============================================================================
+AsyncIOEngine::AsyncIOEngine()
+{
+}
+
+//==============================================================================
+// AsyncIOEngine::~AsyncIOEngine
+//
+//==============================================================================
+AsyncIOEngine::~AsyncIOEngine()
+{
+}
+
+//==============================================================================
+// AsyncIOEngine::Create
+//
+/**
+   Creates the most efficient AsyncIOEngine that the platform supports.
+   This is a UringIOEngine where the Linux io_uring interface is available
+   and supports all of the operations, otherwise a ThreadPoolIOEngine.
+
+   @param queueDepth the number of operations that a UringIOEngine can
+          accept from one call to submit() without waiting
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine> AsyncIOEngine::Create(size_t queueDepth)
+{
+#if defined(HAVE_LINUX_IO_URING_H) && defined(QC_MT)
+	try
+	{
+		return new UringIOEngine(queueDepth);
+	}
+	catch(IOException& /*e*/)
+	{
+		// io_uring is not available to this process, so fall back
+	}
+#else
+	(void)queueDepth;
+#endif //HAVE_LINUX_IO_URING_H
+
+
+	return new ThreadPoolIOEngine(0);
+}
+
+//==============================================================================
+// AsyncIOEngine::read
+//
+/**
+   Prepares an Operation that reads up to @c bufLen bytes from the file
+   @c pFD, starting @c offset bytes from the beginning of the file.
+
+   @param pFD the file to read from
+   @param offset the position in the file of the first byte to read
+   @param pBuffer the buffer to read into, which must remain valid until the
+          operation has completed
+   @param bufLen the maximum number of bytes to read
+   @param pHandler optional Handler to call when the operation completes
+   @returns the prepared Operation.
+   @throws NullPointerException if @c pFD or @c pBuffer is null.
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::read(FileDescriptor* pFD, FileOffset offset,
+                                                      Byte* pBuffer, size_t bufLen,
+                                                      Handler* pHandler)
+{
+	if(!pFD) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	AutoPtr<Operation> rpOp = new Operation(this, Operation::Read, pHandler);
+	rpOp->m_rpFD = pFD;
+	rpOp->m_pBuffer = pBuffer;
+	rpOp->m_length = bufLen;
+	rpOp->m_offset = offset;
+	return prepare(rpOp.get());
+}
+
+//==============================================================================
+// AsyncIOEngine::write
+//
+/**
+   Prepares an Operation that writes @c bufLen bytes to the file @c pFD,
+   starting @c offset bytes from the beginning of the file.
+
+   @param pFD the file to write to
+   @param offset the position in the file of the first byte to write
+   @param pBuffer the bytes to write, which must remain valid until the
+          operation has completed
+   @param bufLen the number of bytes to write
+   @param pHandler optional Handler to call when the operation completes
+   @returns the prepared Operation.
+   @throws NullPointerException if @c pFD or @c pBuffer is null.
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::write(FileDescriptor* pFD, FileOffset offset,
+                                                       const Byte* pBuffer, size_t bufLen,
+                                                       Handler* pHandler)
+{
+	if(!pFD) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	AutoPtr<Operation> rpOp = new Operation(this, Operation::Write, pHandler);
+	rpOp->m_rpFD = pFD;
+	rpOp->m_pBuffer = const_cast<Byte*>(pBuffer);
+	rpOp->m_length = bufLen;
+	rpOp->m_offset = offset;
+	return prepare(rpOp.get());
+}
+
+//==============================================================================
+// AsyncIOEngine::receive
+//
+/**
+   Prepares an Operation that receives up to @c bufLen bytes from the
+   connected socket @c pSocket.
+
+   @param pSocket the socket to receive from
+   @param pBuffer the buffer to receive into, which must remain valid until
+          the operation has completed
+   @param bufLen the maximum number of bytes to receive
+   @param pHandler optional Handler to call when the operation completes
+   @returns the prepared Operation.
+   @throws NullPointerException if @c pSocket or @c pBuffer is null.
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::receive(SocketDescriptor* pSocket,
+                                                         Byte* pBuffer, size_t bufLen,
+                                                         Handler* pHandler)
+{
+	if(!pSocket) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	AutoPtr<Operation> rpOp = new Operation(this, Operation::Receive, pHandler);
+	rpOp->m_rpSocket = pSocket;
+	rpOp->m_pBuffer = pBuffer;
+	rpOp->m_length = bufLen;
+	return prepare(rpOp.get());
+}
+
+//==============================================================================
+// AsyncIOEngine::send
+//
+/**
+   Prepares an Operation that sends up to @c bufLen bytes over the connected
+   socket @c pSocket.
+
+   @param pSocket the socket to send to
+   @param pBuffer the bytes to send, which must remain valid until the
+          operation has completed
+   @param bufLen the number of bytes to send
+   @param pHandler optional Handler to call when the operation completes
+   @returns the prepared Operation.
+   @throws NullPointerException if @c pSocket or @c pBuffer is null.
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::send(SocketDescriptor* pSocket,
+                                                      const Byte* pBuffer, size_t bufLen,
+                                                      Handler* pHandler)
+{
+	if(!pSocket) throw NullPointerException();
+	if(!pBuffer) throw NullPointerException();
+
+	AutoPtr<Operation> rpOp = new Operation(this, Operation::Send, pHandler);
+	rpOp->m_rpSocket = pSocket;
+	rpOp->m_pBuffer = const_cast<Byte*>(pBuffer);
+	rpOp->m_length = bufLen;
+	return prepare(rpOp.get());
+}
+
+//==============================================================================
+// AsyncIOEngine::accept
+//
+/**
+   Prepares an Operation that accepts the next connection made to the
+   listening socket @c pServerSocket.  When the operation completes,
+   Operation::getSocketDescriptor() returns the new socket.
+
+   @param pServerSocket a socket that is bound and listening, such as the
+          one returned by ServerSocket::getSocketDescriptor()
+   @param pHandler optional Handler to call when the operation completes
+   @returns the prepared Operation.
+   @throws NullPointerException if @c pServerSocket is null.
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::accept(SocketDescriptor* pServerSocket,
+                                                        Handler* pHandler)
+{
+	if(!pServerSocket) throw NullPointerException();
+
+	AutoPtr<Operation> rpOp = new Operation(this, Operation::Accept, pHandler);
+	rpOp->m_rpSocket = pServerSocket;
+	rpOp->m_addressLength = sizeof(rpOp->m_address);
+	return prepare(rpOp.get());
+}
+
+//==============================================================================
+// AsyncIOEngine::connect
+//
+/**
+   Creates a stream socket and prepares an Operation that connects it to
+   @c port at @c pAddress.  The socket is available from
+   Operation::getSocketDescriptor() straight away, and is connected once the
+   operation has completed successfully.
+
+   @param pAddress the address to connect to
+   @param port the port to connect to
+   @param pHandler optional Handler to call when the operation completes
+   @returns the prepared Operation.
+   @throws NullPointerException if @c pAddress is null.
+   @throws SocketException if the socket cannot be created.
+*/
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::connect(InetAddress* pAddress, int port,
+                                                         Handler* pHandler)
+{
+	if(!pAddress) throw NullPointerException();
+
+	NetUtils::InitializeSocketLibrary();
+
+	const SocketDescriptor::OSSocketDescriptorType fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	if(fd == QC_INVALID_SOCKET)
+	{
+		static const String err(QC_T("unable to create socket: "));
+		throw SocketException(err + NetUtils::GetSocketErrorString());
+	}
+
+	AutoPtr<Operation> rpOp = new Operation(this, Operation::Connect, pHandler);
+	rpOp->m_rpSocket = new SocketDescriptor(fd);
+
+	struct sockaddr_in* pSA = reinterpret_cast<struct sockaddr_in*>(rpOp->m_address.bytes);
+	pSA->sin_family = AF_INET;
+	pSA->sin_port = htons(port); // convert port to network byte order
+	::memcpy(&pSA->sin_addr, pAddress->getAddress(), pAddress->getAddressLength());
+	rpOp->m_addressLength = sizeof(struct sockaddr_in);
+
+	return prepare(rpOp.get());
+}
+
+//==============================================================================
+// AsyncIOEngine::submit
+//
+/**
+   Starts all of the operations that have been prepared since the last call
+   to submit().
+   @throws IOException if the operations cannot be passed to the operating
+           system.
+*/
+//==============================================================================
+void AsyncIOEngine::submit()
+{
+	OperationVector batch;
+
+	// create a scope for the lock
+	{
+		QC_AUTO_LOCK(FastMutex, m_pendingMutex);
+		batch.swap(m_pending);
+	}
+
+	if(!batch.empty())
+	{
+		std::vector<Operation*> operations(batch.size());
+		for(size_t i=0; i<batch.size(); ++i)
+		{
+			operations[i] = batch[i].get();
+		}
+		start(operations);
+	}
+}
+
+//==============================================================================
+// AsyncIOEngine::Complete
+//
+// Called by derived engines when an operation has completed.  A non-zero
+// error code indicates failure, in which case the result is ignored.
+//==============================================================================
+void AsyncIOEngine::Complete(Operation* pOperation, long result, int errorCode)
+{
+	pOperation->complete(result, errorCode);
+}
+
+//==============================================================================
+// AsyncIOEngine::prepare
+//
+// Adds an operation to the batch started by the next submit().
+//==============================================================================
+AutoPtr<AsyncIOEngine::Operation> AsyncIOEngine::prepare(Operation* pOperation)
+{
+	QC_AUTO_LOCK(FastMutex, m_pendingMutex);
+	m_pending.push_back(pOperation);
+	return pOperation;
+}
+
+#ifdef QC_DOCUMENTATION_ONLY
+//=============================================================================
+//
+// Documentation for pure virtual methods follows:
+//
+//=============================================================================
+
+//==============================================================================
+// AsyncIOEngine::shutdown
+//
+/**
+   Submits any prepared operations, waits for the operations in progress to
+   complete and releases the engine's threads and other resources.
+   Operations submitted after shutdown() fail with the error code
+   @c ECANCELED.
+*/
+//==============================================================================
+void AsyncIOEngine::shutdown();
+
+//==============================================================================
+// AsyncIOEngine::getName
+//
+/**
+   Returns a short name for the mechanism used by this engine, such as
+   "io_uring".
+*/
+//==============================================================================
+String AsyncIOEngine::getName() const;
+
+//==============================================================================
+// AsyncIOEngine::start
+//
+/**
+   Starts a batch of operations.  Implementations must eventually call
+   Complete() for every operation, including those they cannot start.
+*/
+//==============================================================================
+void AsyncIOEngine::start(const std::vector<Operation*>& operations);
+
+#endif //QC_DOCUMENTATION_ONLY
+
+QC_NET_NAMESPACE_END
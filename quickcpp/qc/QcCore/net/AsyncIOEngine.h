@@ -0,0 +1,164 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: AsyncIOEngine
+// 
+// Starts reads and writes on files and sockets and reports their completion
+// later, through a Handler or by waiting on the Operation.
+//
+//==============================================================================
+
+#ifndef QC_NET_AsyncIOEngine_h
+#define QC_NET_AsyncIOEngine_h
+
+#ifndef QC_NET_DEFS_h
+#include "defs.h"
+#endif //QC_NET_DEFS_h
+
+#include "SocketDescriptor.h"
+
+#include "QcCore/base/FastMutex.h"
+#include "QcCore/base/Monitor.h"
+#include "QcCore/io/FileDescriptor.h"
+
+#include <vector>
+
+QC_NET_NAMESPACE_BEGIN
+
+using io::FileDescriptor;
+
+class InetAddress;
+
+class QC_NET_PKG AsyncIOEngine : public virtual QCObject
+{
+public:
+
+	class Operation;
+
+	class QC_NET_PKG Handler : public virtual QCObject
+	{
+	public:
+		virtual void operationCompleted(Operation* pOperation)=0;
+	};
+
+	class QC_NET_PKG Operation : public Monitor
+	{
+		friend class AsyncIOEngine;
+		friend class ThreadPoolIOEngine;
+		friend class UringIOEngine;
+
+	public:
+		enum Type {Read,    /*!< positional read from a file */
+		           Write,   /*!< positional write to a file */
+		           Receive, /*!< receive from a connected socket */
+		           Send,    /*!< send to a connected socket */
+		           Accept,  /*!< accept a connection on a listening socket */
+		           Connect  /*!< connect a new socket to a remote address */};
+
+		Type getType() const;
+		bool isDone() const;
+		size_t get();
+		bool waitFor(size_t timeoutMS);
+
+		size_t getResult() const;
+		int getErrorCode() const;
+		AutoPtr<SocketDescriptor> getSocketDescriptor() const;
+		AutoPtr<InetAddress> getInetAddress() const;
+
+	private:
+		Operation(AsyncIOEngine* pEngine, Type type, Handler* pHandler);
+
+		void complete(long result, int errorCode);
+		void throwError() const;
+
+		union Address
+		{
+			Byte bytes[128];
+			long align;
+		};
+
+	private:
+		AutoPtr<AsyncIOEngine> m_rpEngine;
+		Type m_type;
+		AutoPtr<Handler> m_rpHandler;
+		AutoPtr<FileDescriptor> m_rpFD;
+		AutoPtr<SocketDescriptor> m_rpSocket;
+		Byte* m_pBuffer;
+		size_t m_length;
+		FileOffset m_offset;
+		Address m_address;
+		unsigned m_addressLength;
+		bool m_bDone;
+		size_t m_result;
+		int m_errorCode;
+	};
+
+	enum {DefaultQueueDepth = 256 /*!< default number of operations in progress */};
+
+	static AutoPtr<AsyncIOEngine> Create(size_t queueDepth=DefaultQueueDepth);
+
+	virtual ~AsyncIOEngine();
+
+	AutoPtr<Operation> read(FileDescriptor* pFD, FileOffset offset, Byte* pBuffer,
+	                        size_t bufLen, Handler* pHandler=0);
+	AutoPtr<Operation> write(FileDescriptor* pFD, FileOffset offset, const Byte* pBuffer,
+	                         size_t bufLen, Handler* pHandler=0);
+	AutoPtr<Operation> receive(SocketDescriptor* pSocket, Byte* pBuffer,
+	                           size_t bufLen, Handler* pHandler=0);
+	AutoPtr<Operation> send(SocketDescriptor* pSocket, const Byte* pBuffer,
+	                        size_t bufLen, Handler* pHandler=0);
+	AutoPtr<Operation> accept(SocketDescriptor* pServerSocket, Handler* pHandler=0);
+	AutoPtr<Operation> connect(InetAddress* pAddress, int port, Handler* pHandler=0);
+
+	void submit();
+	virtual void shutdown()=0;
+	virtual String getName() const=0;
+
+protected:
+	AsyncIOEngine();
+
+	virtual void start(const std::vector<Operation*>& operations)=0;
+
+	static void Complete(Operation* pOperation, long result, int errorCode);
+
+private:
+	AsyncIOEngine(const AsyncIOEngine& rhs);            // cannot be copied
+	AsyncIOEngine& operator=(const AsyncIOEngine& rhs); // nor assigned
+
+	AutoPtr<Operation> prepare(Operation* pOperation);
+
+private:
+	typedef std::vector< AutoPtr<Operation> > OperationVector;
+
+	OperationVector m_pending;
+
+#ifdef QC_MT
+	FastMutex m_pendingMutex;
+#endif //QC_MT
+};
+
+QC_NET_NAMESPACE_END
+
+#endif //QC_NET_AsyncIOEngine_h
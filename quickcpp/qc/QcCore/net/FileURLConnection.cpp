@@ -31,7 +31,9 @@
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/base/NumUtils.h"
 #include "QcCore/io/IOException.h"
+#include "QcCore/io/FileNotFoundException.h"
 #include "QcCore/io/FileInputStream.h"
+#include "QcCore/io/MappedFileInputStream.h"
 #include "QcCore/io/FileOutputStream.h"
 #include "QcCore/io/File.h"
 
@@ -39,6 +41,12 @@ QC_NET_NAMESPACE_BEGIN
 
 using namespace io;
 
+//
+// Files of at least this size are read through a MappedFileInputStream.
+// Smaller files are cheaper to read than to map.
+//
+const size_t MinMappedFileSize = 0x40000;
+
 //==============================================================================
 // FileURLConnection::FileURLConnection
 //
@@ -100,11 +108,35 @@ AutoPtr<InputStream> FileURLConnection::getInputStream()
 			throw ProtocolException(QC_T("URLConnection not enabled for input"));
 		}
 
+		//
+		// The length and modification time are both needed, so they are
+		// obtained together rather than probing the file twice
+		//
 		File file(URLDecoder::RawDecode(getURL().getFile()));
-		m_rpInputStream = new FileInputStream(file);
-		String strLen = NumUtils::ToString(file.length());
+		const FileStatus status = file.status();
+		if(!status.exists())
+		{
+			throw FileNotFoundException(file.getPath());
+		}
+		const size_t fileLength = status.length();
+		if(fileLength >= MinMappedFileSize)
+		{
+			try
+			{
+				m_rpInputStream = new MappedFileInputStream(file);
+			}
+			catch(IOException& /*e*/)
+			{
+				// fall back to reading the file normally
+			}
+		}
+		if(!m_rpInputStream)
+		{
+			m_rpInputStream = new FileInputStream(file);
+		}
+		String strLen = NumUtils::ToString(fileLength);
 		setHeaderField(QC_T("content-length"), strLen);
-		DateTime modDate = file.lastModified();
+		DateTime modDate = status.lastModified();
 		//  Format as RFC 822 eg: Thu, 25 Oct 2001 20:03:28 GMT
 		setHeaderField(QC_T("last-modified"), modDate.Format(QC_T("%a, %d %b %Y %H:%M:%S GMT")));
 	}
@@ -80,6 +80,7 @@
 #include "InetAddress.h"
 #include "ProtocolException.h"
 
+#include "QcCore/base/BufferPool.h"
 #include "QcCore/base/IllegalStateException.h"
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/base/NumUtils.h"
@@ -97,6 +98,7 @@ using namespace io;
 const int DATA_CONNECTION_OPEN = 125;
 const int OPENING_DATA_CONNECTION = 150;
 const int COMMAND_OK = 200;
+const int DATA_CONNECTION_IDLE = 225;
 const int FILE_STATUS = 213;
 const int READY_FOR_NEW_USER = 220;
 const int CONTROL_CONNECTION_CLOSED = 221;
@@ -114,6 +116,12 @@ const int ACTION_NOT_TAKEN = 550;
 
 const int FTP_PORT = 21;
 
+//
+// The number of bytes read at a time when a file is retrieved into a
+// RandomAccessFile.
+//
+const size_t RetrieveBufferSize = 0x10000;
+
 //==============================================================================
 // FtpClient::FtpClient
 //
@@ -315,7 +323,7 @@ void FtpClient::asyncCommand(const String& cmd)
    @sa dataTransferComplete()
 */
 //==============================================================================
-AutoPtr<InputStream> FtpClient::retrieveFile(const String& path, size_t offset)
+AutoPtr<InputStream> FtpClient::retrieveFile(const String& path, FileOffset offset)
 {
 	if(offset)
 		restart(offset);
@@ -357,7 +365,7 @@ AutoPtr<InputStream> FtpClient::retrieveFile(const String& path, size_t offset)
    @throws IllegalStateException if the FtpClient is not connected.
 */
 //==============================================================================
-void FtpClient::retrieveFile(const String& path, OutputStream* pOut, size_t offset)
+void FtpClient::retrieveFile(const String& path, OutputStream* pOut, FileOffset offset)
 {
 	if(!pOut) throw NullPointerException();
 
@@ -369,6 +377,91 @@ void FtpClient::retrieveFile(const String& path, OutputStream* pOut, size_t offs
 	dataTransferComplete();
 }
 
+//==============================================================================
+// FtpClient::retrieveFile
+//
+/**
+   Retrieves part of the specified file from the remote server and writes it
+   to the same position within a local RandomAccessFile.
+
+   The transfer is restarted at @c offset, and the bytes received are written
+   to @c pFile at @c offset onwards using RandomAccessFile::writeAt().  This
+   does not use or change the file pointer of @c pFile, so several FtpClient
+   objects, each with its own connection to the server, may retrieve
+   different parts of a file into the same RandomAccessFile concurrently.
+   The application can reserve space for the whole file beforehand using
+   RandomAccessFile::allocate().
+
+   If @c length bytes are received before the end of the transfer, the
+   remainder of the transfer is aborted.
+
+   As restart offsets only correspond to file offsets for binary transfers,
+   the transfer type should be set to FtpClient::Binary.
+
+   @param path the file name to retrieve.
+   @param pFile the local file to write to.
+   @param offset the offset of the first byte to retrieve and write.
+   @param length the maximum number of bytes to retrieve.  By default the
+          remainder of the file is retrieved.
+   @returns the number of bytes written to @c pFile.
+   @throws NullPointerException if @c pFile is null.
+   @throws IOException if an error occurs retrieving the file from the FTP
+           server or writing to @c pFile.
+   @throws ProtocolException if an invalid response is received from the 
+           FTP server.
+   @throws ProtocolException if @c offset is not zero and the FTP server does
+           not support the REST command for stream-mode operations.
+   @throws IllegalStateException if the FtpClient is not connected.
+*/
+//==============================================================================
+FileOffset FtpClient::retrieveFile(const String& path, RandomAccessFile* pFile,
+                                   FileOffset offset, FileOffset length)
+{
+	if(!pFile) throw NullPointerException();
+
+	AutoPtr<InputStream> rpIS = retrieveFile(path, offset);
+
+	PooledArray<Byte> buffer(RetrieveBufferSize);
+	FileOffset bytesWritten = 0;
+	bool bEndOfFile = false;
+
+	while(bytesWritten < length)
+	{
+		const size_t maxRead = (length - bytesWritten < RetrieveBufferSize)
+		                     ? size_t(length - bytesWritten) : RetrieveBufferSize;
+		const long bytesRead = rpIS->read(buffer.get(), maxRead);
+		if(bytesRead == InputStream::EndOfFile)
+		{
+			bEndOfFile = true;
+			break;
+		}
+		pFile->writeAt(offset + bytesWritten, buffer.get(), bytesRead);
+		bytesWritten += bytesRead;
+	}
+
+	//
+	// Having received the requested number of bytes, see whether the
+	// server has finished sending before deciding to abort the transfer.
+	//
+	if(!bEndOfFile)
+	{
+		Byte next;
+		bEndOfFile = (rpIS->read(&next, 1) == InputStream::EndOfFile);
+	}
+
+	if(bEndOfFile)
+	{
+		dataTransferComplete();
+	}
+	else
+	{
+		rpIS->close();
+		abortDataTransfer();
+	}
+
+	return bytesWritten;
+}
+
 //==============================================================================
 // FtpClient::storeFile
 //
@@ -405,7 +498,7 @@ void FtpClient::retrieveFile(const String& path, OutputStream* pOut, size_t offs
    @throws IllegalStateException if the FtpClient is not connected.
 */
 //==============================================================================
-AutoPtr<OutputStream> FtpClient::storeFile(const String& path, size_t offset)
+AutoPtr<OutputStream> FtpClient::storeFile(const String& path, FileOffset offset)
 {
 	if(offset)
 		restart(offset);
@@ -446,7 +539,7 @@ AutoPtr<OutputStream> FtpClient::storeFile(const String& path, size_t offset)
    @throws IllegalStateException if the FtpClient is not connected.
 */
 //==============================================================================
-void FtpClient::storeFile(const String& path, InputStream* pIn, size_t offset)
+void FtpClient::storeFile(const String& path, InputStream* pIn, FileOffset offset)
 {
 	if(!pIn) throw NullPointerException();
 
@@ -1355,7 +1448,7 @@ void FtpClient::dataTransferComplete()
 //==============================================================================
 void FtpClient::abortDataTransfer()
 {
-	int response = syncCommand(QC_T("ABORT"));
+	int response = syncCommand(QC_T("ABOR"));
 
 	if(response == TRANSFER_ABORTED)
 	{
@@ -1363,29 +1456,25 @@ void FtpClient::abortDataTransfer()
 		response = readCommandResponse();
 	}
 
-	if(response != CLOSING_DATA_CONNECTION)
+	if(response != CLOSING_DATA_CONNECTION && response != DATA_CONNECTION_IDLE)
 	{
-		handleInvalidResponse(QC_T("ABORT"));
+		handleInvalidResponse(QC_T("ABOR"));
 	}
 }
 
 //==============================================================================
 // FtpClient::copyInputStream
 //
-// Private helper function that performs a buffered copy from an
-// InputStream to an OutputStream.
+// Private helper function that copies an InputStream to an OutputStream
+// using InputStream::transferTo().  In binary mode this lets a local file be
+// sent straight to the data connection with sendfile(), or a received file
+// be spliced from the data connection into a FileOutputStream.
 //==============================================================================
 void FtpClient::copyInputStream(InputStream* pFrom, OutputStream* pTo)
 {
 	if(!pFrom || !pTo) throw NullPointerException();
 
-	const size_t BufferSize = 1024;
-	ArrayAutoPtr<Byte> apBuffer(new Byte[BufferSize]);
-	long bytesRead;
-	while( (bytesRead = pFrom->read(apBuffer.get(), BufferSize)) != InputStream::EndOfFile)
-	{
-		pTo->write(apBuffer.get(), bytesRead);
-	}
+	pFrom->transferTo(pTo);
 }
 
 //==============================================================================
@@ -1402,7 +1491,8 @@ void FtpClient::copyInputStream(InputStream* pFrom, OutputStream* pTo)
 // that another command, which should be either RETR or STOR, should
 // then follow to complete the restart.
 //==============================================================================
-void FtpClient::restart(size_t offset)
+void FtpClient::restart(FileOffset offset)
+
 {
 	String rest = QC_T("REST ");
 	rest += NumUtils::ToString(offset);
@@ -34,11 +34,13 @@
 
 #include "QcCore/io/Writer.h"
 #include "QcCore/io/BufferedReader.h"
+#include "QcCore/io/RandomAccessFile.h"
 
 QC_NET_NAMESPACE_BEGIN
 
 using io::Writer;
 using io::BufferedReader;
+using io::RandomAccessFile;
 
 class QC_NET_PKG FtpClient : public TcpNetworkClient
 {
@@ -76,11 +78,12 @@ public:
 	AutoPtr<InputStream> listDetails(const String& spec);
 	AutoPtr<InputStream> listNames(const String& spec);
 
-	AutoPtr<InputStream> retrieveFile(const String& path, size_t offset=0);
-	void retrieveFile(const String& path, OutputStream* pOut, size_t offset=0);
+	AutoPtr<InputStream> retrieveFile(const String& path, FileOffset offset=0);
+	void retrieveFile(const String& path, OutputStream* pOut, FileOffset offset=0);
+	FileOffset retrieveFile(const String& path, RandomAccessFile* pFile, FileOffset offset, FileOffset length=FileOffset(-1));
 
-	AutoPtr<OutputStream> storeFile(const String& path, size_t offset=0);
-	void storeFile(const String& path, InputStream* pIn, size_t offset=0);
+	AutoPtr<OutputStream> storeFile(const String& path, FileOffset offset=0);
+	void storeFile(const String& path, InputStream* pIn, FileOffset offset=0);
 
 	AutoPtr<OutputStream> appendFile(const String& path);
 	void appendFile(const String& path, InputStream* pIn);
@@ -102,7 +105,8 @@ private:
 	int syncCommand(const String& command);
 	void asyncCommand(const String& command);
 	int readCommandResponse();
-	void restart(size_t offset);
+	void restart(FileOffset offset);
+
 
 	void handleInvalidResponse(const String& cmd);
 	void handleInvalidFileResponse(const String& cmd, const String& path);
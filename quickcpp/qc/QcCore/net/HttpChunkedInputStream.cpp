@@ -84,41 +84,46 @@ long HttpChunkedInputStream::read(Byte* pBuffer, size_t bufLen)
 void HttpChunkedInputStream::readChunkHeader()
 {
 	//
-	// First extract the hex chunk size
-	// (perhaps with leading white space)
+	// The header is read a line at a time using readUntil(), which the
+	// BufferedInputStream of the HTTP connection implements by searching
+	// its buffer rather than reading one byte at a time
 	//
-	bool bSkipWhitespace = true;
-	ByteString strChunkSize;
-	int x;
+	AutoPtr<InputStream> rpInputStream = getInputStream();
+	ByteString line;
+	size_t pos;
 
+	//
+	// First find the hex chunk size
+	// (perhaps with leading white space)
+	//
 	while(true)
 	{
-		x = FilterInputStream::read();
-		if(x == EndOfFile)
+		line.erase();
+		if(rpInputStream->readUntil('\n', line) == EndOfFile
+		   || line[line.size()-1] != '\n')
 		{
 			throw IOException(QC_T("HTTP Chunked encoding exception"));
 		}
-		if(isxdigit(x))
-		{
-			strChunkSize += char(x);
-			bSkipWhitespace = false;
-		}
-		else if(UnicodeCharacterType::IsSpace(x) && bSkipWhitespace)
+
+		pos = 0;
+		while(pos < line.size() && UnicodeCharacterType::IsSpace(Byte(line[pos])))
 		{
-			// carry on camping;
+			++pos;
 		}
-		else
+
+		if(pos < line.size())
 		{
 			break;
 		}
 	}
 
 	//
-	// Now discard the rest of the line
+	// Extract the hex digits, discarding the rest of the line
 	//
-	while(x != EndOfFile && x != '\n')
+	ByteString strChunkSize;
+	while(pos < line.size() && isxdigit(Byte(line[pos])))
 	{
-		x = FilterInputStream::read();
+		strChunkSize += line[pos++];
 	}
 
 	//
@@ -134,20 +139,12 @@ void HttpChunkedInputStream::readChunkHeader()
 	if(m_chunkSize == 0)
 	{
 		m_eof = true;
-		x = 0;
-		size_t lineSize=0;
-		while(x != EndOfFile && !(x == '\n' && lineSize == 0))
+		do
 		{
-			x = FilterInputStream::read();
-			if(x != '\r' && x != '\n')
-			{
-				lineSize++;
-			}
-			else if(x == '\n')
-			{
-				lineSize=0;
-			}
+			line.erase();
 		}
+		while(rpInputStream->readUntil('\n', line) != EndOfFile
+		      && line.find_first_not_of("\r\n") != ByteString::npos);
 	}
 
 	m_chunkRead = 0;
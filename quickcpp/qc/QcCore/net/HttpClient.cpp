@@ -43,6 +43,7 @@
 #include "QcCore/base/Tracer.h"
 #include "QcCore/base/debug.h"
 #include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/io/FileInputStream.h"
 #include "QcCore/io/FileNotFoundException.h"
 #include "QcCore/io/IOException.h"
 #include "QcCore/io/InputStreamReader.h"
@@ -53,6 +54,7 @@
 #include "QcCore/util/StringTokenizer.h"
 
 #include <map>
+#include <vector>
 
 QC_NET_NAMESPACE_BEGIN
 
@@ -104,6 +106,10 @@ int HttpClient::getDefaultPort() const
 /**
    Protected function called when a socket connection has been established with 
    the TCP/IP network server.
+
+   The request line and headers are written to a memory buffer rather than
+   directly to the socket, so that sendRequest() can send them together with
+   the request body.
 */
 //==============================================================================
 void HttpClient::postConnect(const String& /*server*/,
@@ -112,8 +118,8 @@ void HttpClient::postConnect(const String& /*server*/,
 {
 	const String encoding = QC_T("ISO-8859-1");
 
-	m_rpWriter = new OutputStreamWriter(
-		TcpNetworkClient::getOutputStream().get(), encoding);
+	m_rpRequestBuffer = new ByteArrayOutputStream;
+	m_rpWriter = new OutputStreamWriter(m_rpRequestBuffer.get(), encoding);
 }
 
 //==============================================================================
@@ -294,7 +300,20 @@ int HttpClient::sendRequest()
 		// "content-length" header
 		//
 		ByteArrayOutputStream* pOS = reinterpret_cast<ByteArrayOutputStream*>(m_rpOutputStream.get());
-		if(pOS)
+		AutoPtr<FileInputStream> rpFileIS;
+		if(!m_requestFile.empty())
+		{
+			//
+			// A request file replaces the OutputStream.  Open it now
+			// so that its length is known for the "content-length" header
+			//
+			pOS = 0;
+			rpFileIS = new FileInputStream(m_requestFile);
+			m_rpRequestHeaders->setHeaderExclusive(
+				QC_T("content-length"),
+				NumUtils::ToString(File(m_requestFile).length()));
+		}
+		else if(pOS)
 		{
 			m_rpOutputStream->close();
 			m_rpRequestHeaders->setHeaderExclusive(
@@ -303,12 +322,13 @@ int HttpClient::sendRequest()
 		}
 
 		//
-		// Write the request to the HTTP server
+		// Write the request to the request buffer
 		//
+		m_rpRequestBuffer->reset();
 		m_rpWriter->write(request + CRLF);
 
 		//
-		// Write the MIME-type headers to the HTTP server
+		// Write the MIME-type headers to the request buffer
 		//
 		m_rpRequestHeaders->writeHeaders(m_rpWriter.get());
 
@@ -319,16 +339,31 @@ int HttpClient::sendRequest()
 		m_rpWriter->flush();
 
 		//
-		// Write the contents of the OutputStream (if any).
-		// Note: this of course by-passes the writer and writes 
-		// directly to the byte stream
+		// Send the request and the contents of the OutputStream (if any)
+		// to the HTTP server with one gather write, so that neither has to
+		// be copied into the other's buffer, nor their segments combined.
 		//
+		AutoPtr<OutputStream> rpSocketOS = TcpNetworkClient::getOutputStream();
+		std::vector<IoVec> vecs;
+		m_rpRequestBuffer->getSegments(vecs);
 		if(pOS)
 		{
-			pOS->writeTo(TcpNetworkClient::getOutputStream().get());
-			TcpNetworkClient::getOutputStream()->flush();
+			pOS->getSegments(vecs);
+		}
+		if(!vecs.empty())
+		{
+			rpSocketOS->write(&vecs[0], vecs.size());
 		}
 
+		if(rpFileIS)
+		{
+			// The file goes straight to the socket, using sendfile()
+			// where the platform supports it
+			rpFileIS->transferTo(rpSocketOS.get());
+			rpFileIS->close();
+		}
+		rpSocketOS->flush();
+
 		//
 		// Read the result line and attached headers...
 		//
@@ -668,6 +703,19 @@ AutoPtr<OutputStream> HttpClient::getOutputStream() const
 	return m_rpOutputStream;
 }
 
+//==============================================================================
+// HttpClient::setRequestFile
+//
+// Specifies a file whose contents are sent as the body of the request
+// for POST or PUT operations.  This replaces any data written to the
+// OutputStream returned from getOutputStream().  The file is not read
+// into memory; it is transferred to the socket when the request is sent.
+//==============================================================================
+void HttpClient::setRequestFile(const File& file)
+{
+	m_requestFile = file.getPath();
+}
+
 //==============================================================================
 // HttpClient::setRequestMethod
 //
@@ -34,10 +34,14 @@
 #include "MimeHeaderSequence.h"
 #include "URL.h"
 
+#include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/io/File.h"
 #include "QcCore/io/Writer.h"
 
 QC_NET_NAMESPACE_BEGIN
 
+using io::ByteArrayOutputStream;
+using io::File;
 using io::Writer;
 
 class QC_NET_PKG HttpClient : public virtual QCObject, private TcpNetworkClient
@@ -72,6 +76,7 @@ public:
 
 	virtual AutoPtr<InputStream> getInputStream() const;
 	virtual AutoPtr<OutputStream> getOutputStream() const;
+	void setRequestFile(const File& file);
 
 protected:
 	virtual int getDefaultPort() const;
@@ -83,6 +88,7 @@ private:
 
 private:
 	AutoPtr<Writer>       m_rpWriter;
+	AutoPtr<ByteArrayOutputStream> m_rpRequestBuffer;
 	AutoPtr<InputStream>  m_rpInputStream;
 	AutoPtr<OutputStream> m_rpOutputStream;
 	AutoPtr<MimeHeaderSequence> m_rpRequestHeaders;
@@ -96,6 +102,7 @@ private:
 	int                  m_nProxyPort;
 	size_t               m_timeoutMS;
 	String               m_proxyHost;
+	String               m_requestFile;
 };
 
 QC_NET_NAMESPACE_END
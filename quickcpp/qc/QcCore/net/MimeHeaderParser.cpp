@@ -28,6 +28,8 @@
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/base/Tracer.h"
 
+#include <algorithm>
+
 QC_NET_NAMESPACE_BEGIN
 
 //==============================================================================
@@ -109,28 +111,30 @@ AutoPtr<MimeHeaderSequence> MimeHeaderParser::ParseHeaders(InputStream* pInputSt
 //==============================================================================
 // MimeHeaderParser::ReadLineLatin1
 //
+// Reads a line terminated by a line feed using InputStream::readUntil(),
+// which BufferedInputStream implements by searching its buffer rather than
+// reading one byte at a time.  Carriage returns are discarded.
 //==============================================================================
 long MimeHeaderParser::ReadLineLatin1(InputStream* pInputStream, String& retLine)
 {
 	retLine.erase();
 
-	long charCount=0;
-	int x;
+	ByteString line;
+	if(pInputStream->readUntil('\n', line) == InputStream::EndOfFile
+	   || line[line.size()-1] != '\n')
+	{
+		return InputStream::EndOfFile;
+	}
 
-	while( (x=pInputStream->read()) != InputStream::EndOfFile)
+	line.erase(line.size()-1);
+
+	if(line.find('\r') != ByteString::npos)
 	{
-		if(x == '\n')
-		{
-			return charCount;
-		}
-		else if(x != '\r')
-		{
-			Character ch((UCS4Char)x);
-			ch.appendToString(retLine);
-			++charCount;
-		}
+		line.erase(std::remove(line.begin(), line.end(), '\r'), line.end());
 	}
-	return InputStream::EndOfFile;
+
+	retLine = StringUtils::FromLatin1(line);
+	return line.size();
 }
 
 QC_NET_NAMESPACE_END
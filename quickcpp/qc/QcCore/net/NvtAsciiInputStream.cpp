@@ -67,43 +67,57 @@ long NvtAsciiInputStream::read(Byte* pBuffer, size_t bufLen)
 		return EndOfFile;
 	}
 
-	Byte* pNext = pBuffer;
-	Byte* pEnd = pBuffer + bytesRead;
 	const Byte CR = 13;
 	const Byte LF = 10;
 
+	//
+	// Search for each <CR> using ::memchr and compact the buffer in place,
+	// so the bytes between line ends are moved in blocks
+	//
+	Byte* pOut = (Byte*)::memchr(pBuffer, CR, bytesRead);
+	if(!pOut)
+	{
+		return bytesRead;
+	}
+
+	const Byte* pEnd = pBuffer + bytesRead;
+	const Byte* pNext = pOut;
+
 	while(pNext < pEnd)
 	{
-		const Byte b = *pNext++;
-		if(b == CR)
+		//
+		// pNext addresses a <CR> which is replaced by <LF>
+		//
+		*pOut++ = LF;
+		++pNext;
+
+		if(pNext == pEnd)
 		{
-			//
-			// Reset the <CR> to <LF> and check to see if we have enough
-			// buffer space to zap the next byte
-			//
-			*--pNext = LF;
-			if(pNext >= pEnd)
+			int b = FilterInputStream::read(); // eat the next byte - it must be <null> of <LF>
+			if(b != 0 && b != LF)
 			{
-				int b = FilterInputStream::read(); // eat the next byte - it must be <null> of <LF>
-				if(b != 0 && b != LF)
-				{
-					throw ProtocolException(QC_T("invalid NVT-ASCII byte sequence"));
-				}
-			}
-			else
-			{
-				//
-				// We can now deal with the second half of the <CRLF> pair
-				// which simply needs to be discarded
-				//
-				::memmove(pNext, pNext+1, pEnd-pNext-1);
-				--bytesRead;
-				--pEnd;
+				throw ProtocolException(QC_T("invalid NVT-ASCII byte sequence"));
 			}
+			break;
 		}
+
+		//
+		// The second half of the <CRLF> or <CR><null> pair
+		// simply needs to be discarded
+		//
+		if(*pNext == 0 || *pNext == LF)
+		{
+			++pNext;
+		}
+
+		const Byte* pCR = (const Byte*)::memchr(pNext, CR, pEnd-pNext);
+		const Byte* pRunEnd = pCR ? pCR : pEnd;
+		::memmove(pOut, pNext, pRunEnd-pNext);
+		pOut += (pRunEnd-pNext);
+		pNext = pRunEnd;
 	}
 
-	return bytesRead;
+	return (pOut - pBuffer);
 
 #endif // WIN32
 }
@@ -44,36 +44,33 @@ void NvtAsciiOutputStream::write(const Byte* pBuffer, size_t bufLen)
 	if(!pBuffer) throw NullPointerException();
 
 	//
-	// Search for <CR> bytes not followed by a <LF> and replace by <CRLF>
+	// Search for <LF> bytes not preceded by a <CR> and replace by <CRLF>
 	//
 	const Byte* pEnd = pBuffer+bufLen;
 	const Byte* pNext = pBuffer;
 	const Byte* pLast = pBuffer;
+	const Byte* pLF;
 	const Byte CR = 13;
 
-	while(pNext < pEnd)
+	while((pLF = (const Byte*)::memchr(pNext, 10, pEnd-pNext)) != 0)
 	{
-		const Byte b = *pNext;
-		if(b == CR)
+		const bool bCRSeen = (pLF > pBuffer) ? (pLF[-1] == CR) : m_bCRSeen;
+		if(!bCRSeen)
 		{
-			m_bCRSeen = true;
+			// flush out what's gone so far
+			FilterOutputStream::write(pLast, pLF-pLast);
+			pLast = pLF;
+			// write an additional <CR>
+			FilterOutputStream::write(&CR, 1);
 		}
-		else if(b == 10)
-		{
-			if(!m_bCRSeen)
-			{
-				// flush out what's gone so far
-				FilterOutputStream::write(pLast, pNext-pLast);
-				pLast = pNext;
-				// write an additional <CR>
-				FilterOutputStream::write(&CR, 1);
-			}
-			m_bCRSeen = false;
-		}
-		++pNext;
+		pNext = pLF+1;
+	}
+
+	if(bufLen)
+	{
+		m_bCRSeen = (pEnd[-1] == CR);
 	}
-	QC_DBG_ASSERT(pEnd == pNext);
-	FilterOutputStream::write(pLast, pNext-pLast);
+	FilterOutputStream::write(pLast, pEnd-pLast);
 }
 
 QC_NET_NAMESPACE_END
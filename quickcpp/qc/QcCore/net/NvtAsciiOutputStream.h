@@ -39,6 +39,7 @@
 QC_NET_NAMESPACE_BEGIN
 
 using io::FilterOutputStream;
+using io::IoVec;
 
 class QC_NET_PKG NvtAsciiOutputStream : public FilterOutputStream
 {
@@ -47,6 +48,7 @@ public:
 
 #ifdef QC_USING_DECL_BROKEN
 	virtual void write(Byte x) {FilterOutputStream::write(x);}
+	virtual void write(const IoVec* pVecs, size_t count) {FilterOutputStream::write(pVecs, count);}
 #else
 	using FilterOutputStream::write; 	// unhide inherited write method
 #endif
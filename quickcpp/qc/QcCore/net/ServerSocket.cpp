@@ -465,6 +465,22 @@ size_t ServerSocket::getSoTimeout() const
 	return m_rpSocketImpl->getTimeout();
 }
 
+//==============================================================================
+// ServerSocket::getSocketDescriptor
+//
+/**
+   Returns the SocketDescriptor of the listening socket, which can be used
+   to accept connections asynchronously with an AsyncIOEngine.
+
+   @returns the SocketDescriptor, or null if this ServerSocket is not bound.
+*/
+//==============================================================================
+AutoPtr<SocketDescriptor> ServerSocket::getSocketDescriptor() const
+{
+	QC_DBG_ASSERT(m_rpSocketImpl);
+	return m_rpSocketImpl->getSocketDescriptor();
+}
+
 //==============================================================================
 // ServerSocket::setSoTimeout
 //
@@ -34,6 +34,7 @@ QC_NET_NAMESPACE_BEGIN
 
 class InetAddress;
 class Socket;
+class SocketDescriptor;
 class SocketImpl;
 class SocketImplFactory;
 
@@ -56,6 +57,7 @@ public:
 	virtual size_t getReceiveBufferSize() const;
 	virtual bool getReuseAddress() const;
 	virtual size_t getSoTimeout() const;
+	virtual AutoPtr<SocketDescriptor> getSocketDescriptor() const;
 	virtual bool isBound() const;
 	virtual void setReceiveBufferSize(size_t size);
 	virtual void setReuseAddress(bool bEnable);
@@ -74,6 +74,7 @@
 #include "QcCore/base/ObjectManager.h"
 #include "QcCore/base/NullPointerException.h"
 #include "QcCore/base/FastMutex.h"
+#include "QcCore/io/FileSystem.h"
 
 #ifndef WIN32
 #include <netinet/tcp.h>
@@ -81,6 +82,9 @@
 
 QC_NET_NAMESPACE_BEGIN
 
+using io::FileDescriptor;
+using io::FileSystem;
+
 //==================================================================
 // Multi-threaded locking strategy
 //
@@ -395,6 +399,41 @@ AutoPtr<OutputStream> Socket::getOutputStream() const
 	return m_rpSocketImpl->getOutputStream();
 }
 
+//==============================================================================
+// Socket::sendFile
+//
+/**
+   Sends up to @c length bytes of @c file, starting @c offset bytes from
+   the beginning of the file, over this Socket.
+
+   The bytes are written to the Socket's OutputStream using
+   OutputStream::transferFrom().  On platforms that support it, the operating
+   system sends the file directly from its cache without the data being
+   copied into the application.  Fewer than @c length bytes are sent if
+   the end of the file is reached first.
+
+   @param file the file to send
+   @param offset the position within the file of the first byte to send
+   @param length the maximum number of bytes to send
+   @returns the number of bytes sent.
+   @throws FileNotFoundException if @c file does not exist.
+   @throws IOException if the file cannot be read or an error occurs sending
+           the data.
+   @sa getOutputStream()
+*/
+//==============================================================================
+size_t Socket::sendFile(const File& file, FileOffset offset, size_t length)
+
+{
+	AutoPtr<FileDescriptor> rpFD =
+		FileSystem::GetFileSystem()->openFile(file.getPath(),
+		                                      FileSystem::ReadAccess,
+		                                      FileSystem::OpenExisting,
+		                                      0);
+
+	return getOutputStream()->transferFrom(rpFD.get(), offset, length);
+}
+
 //==============================================================================
 // Socket::SetSocketImplFactory
 //
@@ -770,6 +809,25 @@ void Socket::setSoTimeout(size_t timeoutMS)
 #endif
 }
 
+//==============================================================================
+// Socket::getSocketDescriptor
+//
+/**
+   Returns the SocketDescriptor of the underlying socket, which can be used
+   to perform asynchronous operations with an AsyncIOEngine.
+
+   The SocketDescriptor remains owned by this Socket and is closed when the
+   Socket is closed.
+
+   @returns the SocketDescriptor, or null if the socket has not been created.
+*/
+//==============================================================================
+AutoPtr<SocketDescriptor> Socket::getSocketDescriptor() const
+{
+	QC_DBG_ASSERT(m_rpSocketImpl);
+	return m_rpSocketImpl->getSocketDescriptor();
+}
+
 //==============================================================================
 // Socket::getTcpNoDelay
 //
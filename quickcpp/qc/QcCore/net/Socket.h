@@ -41,8 +41,12 @@
 
 #include "SocketImpl.h"
 
+#include "QcCore/io/File.h"
+
 QC_NET_NAMESPACE_BEGIN
 
+using io::File;
+
 class InetAddress;
 class SocketImplFactory;
 
@@ -79,9 +83,12 @@ public:
 	virtual int getSendBufferSize() const;
 	virtual int getSoLinger() const;
 	virtual size_t getSoTimeout() const;
+	virtual AutoPtr<SocketDescriptor> getSocketDescriptor() const;
 	virtual bool getTcpNoDelay() const;
 	virtual bool isClosed();
 	virtual bool isConnected();
+	virtual size_t sendFile(const File& file, FileOffset offset, size_t length);
+
 	virtual void setAutoClose(bool bEnable);
 	virtual void setKeepAlive(bool bEnable);
 	virtual void setReceiveBufferSize(size_t size);
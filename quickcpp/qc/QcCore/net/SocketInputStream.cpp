@@ -30,9 +30,12 @@
 #include "SocketTimeoutException.h"
 
 #include "QcCore/io/IOException.h"
+#include "QcCore/io/FileOutputStream.h"
+#include "QcCore/io/PosixFileDescriptor.h"
 #include "QcCore/base/SystemUtils.h"
 #include "QcCore/base/Tracer.h"
 #include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/NumUtils.h"
 
 #ifndef WIN32
 #include <sys/types.h>
@@ -40,9 +43,25 @@
 #include <sys/time.h>
 #endif //WIN32
 
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif //__linux__
+
 QC_NET_NAMESPACE_BEGIN
 
 using io::IOException;
+using io::FileDescriptor;
+using io::FileOutputStream;
+using io::PosixFileDescriptor;
+
+#if defined(__linux__)
+//
+// The number of bytes requested from each splice() call.  This matches the
+// default capacity of a Linux pipe.
+//
+const size_t SpliceChunkSize = 0x10000;
+#endif //__linux__
 
 //==============================================================================
 // SocketInputStream::SocketInputStream
@@ -154,6 +173,159 @@ long SocketInputStream::read(Byte* pBuffer, size_t bufLen)
 	return iBytes;
 }
 
+//==============================================================================
+// SocketInputStream::transferTo
+//
+// Part of the InputStream interface.  When the destination is a
+// FileOutputStream and no receive timeout has been set, Linux allows
+// the data to be moved from the socket to the file with splice() through an
+// intermediate pipe, so that it never enters user space.  In all other cases
+// the base class copy is used.
+//
+// A FileOutputStream using DirectIO may be holding data in its aligned
+// buffer, and one using drop-behind has to see every write, so both are
+// written through the stream itself.
+//==============================================================================
+size_t SocketInputStream::transferTo(OutputStream* pOut)
+{
+	if(!pOut) throw NullPointerException();
+	if(!m_rpSocketDescriptor) throw IOException(QC_T("stream is closed"));
+
+#if defined(__linux__)
+	FileOutputStream* pFileOut = dynamic_cast<FileOutputStream*>(pOut);
+	if(pFileOut && !m_timeoutMS && !pFileOut->isDirectIO() && !pFileOut->isDropBehind())
+	{
+		AutoPtr<FileDescriptor> rpFD = pFileOut->getFD();
+		PosixFileDescriptor* pPosixFD = dynamic_cast<PosixFileDescriptor*>(rpFD.get());
+		if(pPosixFD)
+		{
+			const size_t count = spliceTo(pPosixFD->getFD());
+			if(count != size_t(-1))
+			{
+				return count;
+			}
+		}
+	}
+#endif //__linux__
+
+	return InputStream::transferTo(pOut);
+}
+
+//==============================================================================
+// SocketInputStream::spliceTo
+//
+// Private helper which moves the remainder of the socket stream to the file
+// descriptor fd using splice().  Returns size_t(-1) without having consumed
+// any data if splice() cannot be used for this pair of descriptors.
+//
+// splice() refuses to write to a file opened for appending, and writes to a
+// file opened with O_DIRECT must be aligned, so such files are left to the
+// base class.  Other failures are only detected once bytes have been read
+// from the socket, so they are reported as errors.
+//==============================================================================
+size_t SocketInputStream::spliceTo(int fd)
+{
+#if defined(__linux__)
+	int unsupportedFlags = O_APPEND;
+#if defined(O_DIRECT)
+	unsupportedFlags |= O_DIRECT;
+#endif //O_DIRECT
+
+	const int fileFlags = ::fcntl(fd, F_GETFL);
+	if(fileFlags == -1 || (fileFlags & unsupportedFlags))
+	{
+		return size_t(-1);
+	}
+
+
+	int pipeFDs[2];
+	if(::pipe(pipeFDs) != 0)
+	{
+		return size_t(-1);
+	}
+
+	size_t count = 0;
+	int errNum = 0;
+	bool bFileError = false;
+
+	for(;;)
+	{
+		const ssize_t bytesIn = ::splice(m_rpSocketDescriptor->getFD(), 0,
+		                                 pipeFDs[1], 0, SpliceChunkSize,
+		                                 SPLICE_F_MOVE | SPLICE_F_MORE);
+		if(bytesIn == 0)
+		{
+			break; // end of file
+		}
+		else if(bytesIn < 0)
+		{
+			if(errno == EINTR) continue;
+			errNum = errno;
+			break;
+		}
+
+		ssize_t pending = bytesIn;
+		while(pending > 0)
+		{
+			const ssize_t bytesOut = ::splice(pipeFDs[0], 0, fd, 0, pending,
+			                                  SPLICE_F_MOVE | SPLICE_F_MORE);
+			if(bytesOut < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			else if(bytesOut <= 0)
+			{
+				errNum = (bytesOut < 0) ? errno : EIO;
+				bFileError = true;
+				break;
+			}
+			pending -= bytesOut;
+			count += bytesOut;
+		}
+
+		if(bFileError)
+			break;
+	}
+
+	::close(pipeFDs[0]);
+	::close(pipeFDs[1]);
+
+	if(bFileError)
+	{
+		throw IOException(QC_T("error writing to file: ") + SystemUtils::GetSystemErrorString(errNum));
+	}
+	else if(errNum)
+	{
+		if(count == 0 && (errNum == EINVAL || errNum == ENOSYS))
+			return size_t(-1);
+
+		// As for read(), an error from a shutdown socket is the end of file
+		const int sockFlags = m_rpSocketDescriptor->getSocketFlags();
+		if(sockFlags & SocketDescriptor::DescriptorClosed)
+			throw IOException(QC_T("stream is closed"));
+		else if(!(sockFlags & SocketDescriptor::ShutdownInput))
+		{
+			static const String err = QC_T("error reading from socket: ");
+			String errMsg = err + NetUtils::GetSocketErrorString(errNum);
+			throw IOException(errMsg);
+		}
+	}
+	else
+	{
+		m_rpSocketDescriptor->modifySocketFlags(SocketDescriptor::ShutdownInput, 0);
+	}
+
+	if(Tracer::IsEnabled())
+	{
+		Tracer::Trace(Tracer::Net, Tracer::Low, String(QC_T("File data rcvd: ")) + NumUtils::ToString(count));
+	}
+
+	return count;
+#else
+	return size_t(-1);
+#endif //__linux__
+}
+
 //==============================================================================
 // SocketInputStream::available
 //
@@ -50,11 +50,15 @@ public:
 #endif
 
 	virtual long read(Byte* pBuffer, size_t bufLen);
+	virtual size_t transferTo(OutputStream* pOut);
 
 public:
 	size_t getTimeout() const;
 	void setTimeout(size_t timeoutMS);
 
+private:
+	size_t spliceTo(int fd);
+
 private:
 	AutoPtr<SocketDescriptor> m_rpSocketDescriptor;
 	size_t m_timeoutMS;
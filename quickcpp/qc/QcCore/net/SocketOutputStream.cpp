@@ -31,18 +31,89 @@
 
 #include "QcCore/base/debug.h"
 #include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/NumUtils.h"
 #include "QcCore/base/Tracer.h"
 #include "QcCore/io/IOException.h"
+#include "QcCore/io/FileSystem.h"
+#include "QcCore/io/PosixFileDescriptor.h"
 
 #ifndef WIN32
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <sys/uio.h>
+#include <string.h>
 #endif //WIN32
 
+#if defined(__linux__)
+#include <sys/sendfile.h>
+#include <signal.h>
+#include <time.h>
+#endif //__linux__
+
 QC_NET_NAMESPACE_BEGIN
 
 using io::IOException;
+using io::PosixFileDescriptor;
+
+const size_t MaxIoVecs = 64;  // blocks passed to each gather send
+
+#if defined(__linux__)
+
+//
+// The largest number of bytes passed to a single sendfile() call.  Linux
+// will not transfer more than this in one go anyway.
+//
+const size_t MaxSendFileSize = 0x7ffff000;
+
+//==============================================================================
+// SigPipeBlocker
+//
+// Unlike send(), sendfile() has no MSG_NOSIGNAL flag, so writing to a broken
+// connection raises SIGPIPE.  This helper blocks SIGPIPE for the calling
+// thread while it exists.  If the transfer failed with EPIPE, the SIGPIPE it
+// raised is consumed before the signal mask is restored - unless one was
+// already pending for the thread, in which case it is left alone.
+//==============================================================================
+class SigPipeBlocker
+{
+public:
+	SigPipeBlocker() : m_bWasPending(false), m_bEPipe(false)
+	{
+		sigset_t pending;
+		::sigemptyset(&pending);
+		::sigpending(&pending);
+		m_bWasPending = (::sigismember(&pending, SIGPIPE) == 1);
+
+		sigset_t sigPipe;
+		::sigemptyset(&sigPipe);
+		::sigaddset(&sigPipe, SIGPIPE);
+		::pthread_sigmask(SIG_BLOCK, &sigPipe, &m_oldMask);
+	}
+
+	~SigPipeBlocker()
+	{
+		if(m_bEPipe && !m_bWasPending)
+		{
+			sigset_t sigPipe;
+			::sigemptyset(&sigPipe);
+			::sigaddset(&sigPipe, SIGPIPE);
+			struct timespec zero = {0, 0};
+			while(::sigtimedwait(&sigPipe, 0, &zero) == -1 && errno == EINTR)
+				;
+		}
+		::pthread_sigmask(SIG_SETMASK, &m_oldMask, 0);
+	}
+
+	void setEPipe() {m_bEPipe = true;}
+
+private:
+	sigset_t m_oldMask;
+	bool m_bWasPending;
+	bool m_bEPipe;
+};
+
+#endif //__linux__
 
 //==============================================================================
 // SocketOutputStream::SocketOutputStream
@@ -141,6 +212,180 @@ void SocketOutputStream::write(const Byte* pBuffer, size_t bufLen)
 	}
 }
 
+//=============================================================================
+// SocketOutputStream::write
+// 
+// Part of the OutputStream interface.  The blocks are sent with a single
+// sendmsg() (WSASend() on Windows) call, so that for example an HTTP header
+// and its body leave in the same TCP segment without first being copied into
+// one buffer.  sendmsg() is used rather than writev() because it accepts
+// the MSG_NOSIGNAL flag.
+//
+// As for the single buffer write(), we loop round until every byte has
+// been sent.
+//=============================================================================
+void SocketOutputStream::write(const IoVec* pVecs, size_t count)
+{
+	if(!pVecs && count) throw NullPointerException();
+	if(!m_rpSocketDescriptor) throw IOException(QC_T("stream is closed"));
+
+#if defined(MSG_NOSIGNAL)
+	const int iFlags = MSG_NOSIGNAL;
+#elif !defined(WIN32)
+	const int iFlags = 0;
+#endif
+
+	if(Tracer::IsEnabled())
+	{
+		for(size_t i=0; i<count; ++i)
+		{
+			Tracer::TraceBytes(Tracer::Net, Tracer::Low, QC_T("Data send:"), pVecs[i].pData, pVecs[i].length);
+		}
+	}
+
+	size_t skip = 0; // bytes of pVecs[0] already sent
+	while(count)
+	{
+		const size_t numVecs = (count < MaxIoVecs) ? count : MaxIoVecs;
+#if defined(WIN32)
+		WSABUF bufs[MaxIoVecs];
+		for(size_t i=0; i<numVecs; ++i)
+		{
+			bufs[i].buf = (char*)(pVecs[i].pData + (i ? 0 : skip));
+			bufs[i].len = (ULONG)(pVecs[i].length - (i ? 0 : skip));
+		}
+		DWORD sent = 0;
+		const int rc = ::WSASend(m_rpSocketDescriptor->getFD(), bufs, (DWORD)numVecs, &sent, 0, NULL, NULL);
+		const long bytesSent = (rc == 0) ? (long)sent : -1;
+#else
+		struct iovec iov[MaxIoVecs];
+		for(size_t i=0; i<numVecs; ++i)
+		{
+			iov[i].iov_base = (void*)(pVecs[i].pData + (i ? 0 : skip));
+			iov[i].iov_len = pVecs[i].length - (i ? 0 : skip);
+		}
+		struct msghdr msg;
+		::memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iov;
+		msg.msg_iovlen = numVecs;
+		const long bytesSent = ::sendmsg(m_rpSocketDescriptor->getFD(), &msg, iFlags);
+#endif //WIN32
+
+		if(bytesSent < 0)
+		{
+			const int errNum = NetUtils::GetLastSocketError();
+
+			// An error generated by a shutdown socket should be reported as such
+			if(m_rpSocketDescriptor->getSocketFlags() & SocketDescriptor::ShutdownOutput)
+				throw SocketException(QC_T("socket shutdown for output"));
+
+			static const String err = QC_T("error writing to socket");
+			String errMsg = err + NetUtils::GetSocketErrorString(errNum);
+			throw SocketException(errMsg);
+		}
+
+		size_t done = bytesSent;
+		while(count && done >= pVecs->length - skip)
+		{
+			done -= pVecs->length - skip;
+			skip = 0;
+			++pVecs;
+			--count;
+		}
+		skip += done;
+	}
+}
+
+//=============================================================================
+// SocketOutputStream::transferFrom
+// 
+// Part of the OutputStream interface.  Where the operating system supports it,
+// the file is sent with sendfile(), which moves the bytes from the file cache
+// to the socket without copying them into user space.  sendfile() is
+// given an explicit offset, so the file position is set afterwards to match
+// the behaviour of the base class.
+//
+// Some file systems do not support sendfile(), in which case it fails
+// straight away and we fall back to the OutputStream implementation.
+//=============================================================================
+size_t SocketOutputStream::transferFrom(FileDescriptor* pFD, FileOffset offset, size_t length)
+{
+	if(!pFD) throw NullPointerException();
+	if(!m_rpSocketDescriptor) throw IOException(QC_T("stream is closed"));
+
+#if defined(__linux__)
+	PosixFileDescriptor* pPosixFD = dynamic_cast<PosixFileDescriptor*>(pFD);
+	if(pPosixFD)
+	{
+		SigPipeBlocker sigPipeBlocker;
+
+		off_t fileOffset = (off_t)offset;
+		if(fileOffset < 0 || FileOffset(fileOffset) != offset)
+		{
+			throw IOException(QC_T("file offset is too large"));
+		}
+
+		size_t count = 0;
+		while(count < length)
+		{
+			const size_t toSend = (length-count < MaxSendFileSize)
+			                    ? length-count
+			                    : MaxSendFileSize;
+
+			const ssize_t bytesSent = ::sendfile(m_rpSocketDescriptor->getFD(),
+			                                     pPosixFD->getFD(),
+			                                     &fileOffset, toSend);
+			if(bytesSent == 0)
+			{
+				break; // end of file
+			}
+			else if(bytesSent < 0)
+			{
+				const int errNum = errno;
+				if(errNum == EINTR)
+				{
+					continue;
+				}
+				else if(count == 0 && (errNum == EINVAL || errNum == ENOSYS))
+				{
+					return OutputStream::transferFrom(pFD, offset, length);
+				}
+				else if(errNum == EPIPE)
+				{
+					sigPipeBlocker.setEPipe();
+				}
+
+				// Leave the file positioned after the data that was sent,
+				// just as the success path and the generic copy do
+				if(count > 0)
+				{
+					pFD->getFileSystem()->setFilePosition(pFD, offset+count);
+				}
+
+				// An error generated by a shutdown socket should be reported as such
+				if(m_rpSocketDescriptor->getSocketFlags() & SocketDescriptor::ShutdownOutput)
+					throw SocketException(QC_T("socket shutdown for output"));
+
+				static const String err = QC_T("error writing to socket");
+				String errMsg = err + NetUtils::GetSocketErrorString(errNum);
+				throw SocketException(errMsg);
+			}
+			count += bytesSent;
+		}
+
+		if(Tracer::IsEnabled())
+		{
+			Tracer::Trace(Tracer::Net, Tracer::Low, String(QC_T("File data sent: ")) + NumUtils::ToString(count));
+		}
+
+		pFD->getFileSystem()->setFilePosition(pFD, offset+count);
+		return count;
+	}
+#endif //__linux__
+
+	return OutputStream::transferFrom(pFD, offset, length);
+}
+
 //==============================================================================
 // SocketOutputStream::close
 //
@@ -32,6 +32,9 @@
 
 QC_NET_NAMESPACE_BEGIN
 
+using io::FileDescriptor;
+using io::IoVec;
+
 class SocketDescriptor;
 
 class QC_NET_PKG SocketOutputStream : public OutputStream
@@ -49,7 +52,10 @@ public:
 	using OutputStream::write; 	// unhide inherited write method
 #endif
 
+	virtual size_t transferFrom(FileDescriptor* pFD, FileOffset offset, size_t length);
+
 	virtual void write(const Byte* pBuffer, size_t bufLen);
+	virtual void write(const IoVec* pVecs, size_t count);
 
 private:
 	AutoPtr<SocketDescriptor> m_rpSocketDescriptor;
@@ -0,0 +1,290 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ThreadPoolIOEngine
+/**
+	@class qc::net::ThreadPoolIOEngine
+	
+	@brief An AsyncIOEngine that performs each operation as a blocking call
+	       on a pooled thread.
+
+	This is the engine returned by AsyncIOEngine::Create() on platforms that
+	have no kernel interface for asynchronous I/O.  It owns a ThreadPool, and
+	every submitted operation becomes a task for the pool.  File operations
+	use FileSystem::readFileAt() and FileSystem::writeFileAt(); socket
+	operations use the blocking @c recv(), @c send(), @c accept() and
+	@c connect() calls.
+
+	The number of threads limits how many operations are performed at once.
+	An operation that blocks, such as a receive on an idle connection or an
+	accept with no client, occupies a thread until it completes, so the pool
+	should be given enough threads for the sockets in use.
+
+	In single-threaded versions of the library there is no pool, and each
+	operation is performed by submit() before it returns.
+*/
+//==============================================================================
+
+#include "ThreadPoolIOEngine.h"
+#include "NetUtils.h"
+
+#include "QcCore/io/FileSystem.h"
+#include "QcCore/io/IOException.h"
+
+#include <errno.h>
+
+QC_NET_NAMESPACE_BEGIN
+
+using io::FileSystem;
+using io::IOException;
+
+#ifdef QC_MT
+
+//==============================================================================
+// Class: ThreadPoolIOEngine::Task
+//
+// Performs one operation on a pooled thread.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class ThreadPoolIOEngine::Task : public Runnable
+{
+public:
+	Task(Operation* pOperation) : m_rpOperation(pOperation) {}
+
+	virtual void run()
+	{
+		Perform(m_rpOperation.get());
+	}
+
+private:
+	AutoPtr<Operation> m_rpOperation;
+};
+
+#endif //QC_MT
+
+//==============================================================================
+// ThreadPoolIOEngine::ThreadPoolIOEngine
+//
+/**
+   Constructs a ThreadPoolIOEngine and starts its threads.
+
+   @param numThreads the number of threads in the pool, which is the largest
+          number of operations that are performed at once.  If zero, one
+          thread is started for each processor.
+*/
+//==============================================================================
+ThreadPoolIOEngine::ThreadPoolIOEngine(size_t numThreads) :
+	m_bShutdown(false)
+{
+#ifdef QC_MT
+	m_rpPool = new ThreadPool(numThreads);
+#else
+	(void)numThreads;
+#endif //QC_MT
+}
+
+//==============================================================================
+// ThreadPoolIOEngine::~ThreadPoolIOEngine
+//
+/**
+   Destructor.  Waits for the operations in progress to complete.
+*/
+//==============================================================================
+ThreadPoolIOEngine::~ThreadPoolIOEngine()
+{
+	try
+	{
+		shutdown();
+	}
+	catch(Exception& /*e*/)
+	{
+	}
+}
+
+//==============================================================================
+// ThreadPoolIOEngine::shutdown
+//
+//==============================================================================
+void ThreadPoolIOEngine::shutdown()
+{
+	submit();
+
+#ifdef QC_MT
+	AutoPtr<ThreadPool> rpPool;
+
+	// create a scope for the lock
+	{
+		QC_AUTO_LOCK(FastMutex, m_mutex);
+		m_bShutdown = true;
+		rpPool = m_rpPool;
+		m_rpPool.release();
+	}
+
+	if(rpPool)
+	{
+		rpPool->shutdown();
+	}
+#else
+	m_bShutdown = true;
+#endif //QC_MT
+}
+
+//==============================================================================
+// ThreadPoolIOEngine::getName
+//
+//==============================================================================
+String ThreadPoolIOEngine::getName() const
+{
+	return QC_T("thread pool");
+}
+
+//==============================================================================
+// ThreadPoolIOEngine::start
+//
+// Passes each operation to the pool, or performs it straight away in
+// single-threaded builds.  Operations submitted after shutdown() are
+// cancelled.
+//==============================================================================
+void ThreadPoolIOEngine::start(const std::vector<Operation*>& operations)
+{
+#ifdef QC_MT
+	AutoPtr<ThreadPool> rpPool;
+
+	// create a scope for the lock
+	{
+		QC_AUTO_LOCK(FastMutex, m_mutex);
+		rpPool = m_rpPool;
+	}
+
+	for(size_t i=0; i<operations.size(); ++i)
+	{
+		if(rpPool)
+		{
+			rpPool->execute(new Task(operations[i]));
+		}
+		else
+		{
+			Complete(operations[i], 0, ECANCELED);
+		}
+	}
+#else
+	for(size_t i=0; i<operations.size(); ++i)
+	{
+		if(m_bShutdown)
+		{
+			Complete(operations[i], 0, ECANCELED);
+		}
+		else
+		{
+			Perform(operations[i]);
+		}
+	}
+#endif //QC_MT
+}
+
+//==============================================================================
+// ThreadPoolIOEngine::Perform
+//
+// Performs an operation with a blocking call and completes it.  File errors
+// are reported by the FileSystem as exceptions, which carry no error code.
+//==============================================================================
+void ThreadPoolIOEngine::Perform(Operation* pOp)
+{
+	long result = 0;
+	int errorCode = 0;
+
+	switch(pOp->m_type)
+	{
+	case Operation::Read:
+	case Operation::Write:
+		try
+		{
+			AutoPtr<FileSystem> rpFS = pOp->m_rpFD->getFileSystem();
+			if(pOp->m_type == Operation::Read)
+			{
+				result = rpFS->readFileAt(pOp->m_rpFD.get(), pOp->m_offset, pOp->m_pBuffer, pOp->m_length);
+			}
+			else
+			{
+				rpFS->writeFileAt(pOp->m_rpFD.get(), pOp->m_offset, pOp->m_pBuffer, pOp->m_length);
+				result = pOp->m_length;
+			}
+		}
+		catch(IOException& /*e*/)
+		{
+			errorCode = -1;
+		}
+		break;
+
+	case Operation::Receive:
+		result = ::recv(pOp->m_rpSocket->getFD(), (char*)pOp->m_pBuffer, pOp->m_length, 0);
+		break;
+
+	case Operation::Send:
+	{
+#if defined(MSG_NOSIGNAL)
+		const int flags = MSG_NOSIGNAL;
+#else
+		const int flags = 0;
+#endif //MSG_NOSIGNAL
+		result = ::send(pOp->m_rpSocket->getFD(), (const char*)pOp->m_pBuffer, pOp->m_length, flags);
+		break;
+	}
+
+	case Operation::Accept:
+	{
+		cel_socklen_t addrLen = sizeof(pOp->m_address);
+		const SocketDescriptor::OSSocketDescriptorType fd =
+			::accept(pOp->m_rpSocket->getFD(), reinterpret_cast<struct sockaddr*>(pOp->m_address.bytes), &addrLen);
+		if(fd == QC_INVALID_SOCKET)
+		{
+			result = -1;
+		}
+		else
+		{
+			pOp->m_addressLength = addrLen;
+			pOp->m_rpSocket = new SocketDescriptor(fd);
+		}
+		break;
+	}
+
+	case Operation::Connect:
+		result = ::connect(pOp->m_rpSocket->getFD(),
+		                   reinterpret_cast<struct sockaddr*>(pOp->m_address.bytes),
+		                   pOp->m_addressLength);
+		break;
+	}
+
+	if(result < 0 && errorCode == 0)
+	{
+		errorCode = NetUtils::GetLastSocketError();
+		if(errorCode == 0) errorCode = -1;
+	}
+
+	Complete(pOp, result, errorCode);
+}
+
+QC_NET_NAMESPACE_END
@@ -0,0 +1,71 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: ThreadPoolIOEngine
+// 
+//==============================================================================
+
+#ifndef QC_NET_ThreadPoolIOEngine_h
+#define QC_NET_ThreadPoolIOEngine_h
+
+#ifndef QC_NET_DEFS_h
+#include "defs.h"
+#endif //QC_NET_DEFS_h
+
+#include "AsyncIOEngine.h"
+
+#include "QcCore/base/ThreadPool.h"
+
+QC_NET_NAMESPACE_BEGIN
+
+class QC_NET_PKG ThreadPoolIOEngine : public AsyncIOEngine
+{
+public:
+	ThreadPoolIOEngine(size_t numThreads=0);
+	virtual ~ThreadPoolIOEngine();
+
+	virtual void shutdown();
+	virtual String getName() const;
+
+protected:
+	virtual void start(const std::vector<Operation*>& operations);
+
+private:
+	class Task;
+
+	static void Perform(Operation* pOperation);
+
+private:
+	bool m_bShutdown;
+
+#ifdef QC_MT
+	AutoPtr<ThreadPool> m_rpPool;
+	FastMutex m_mutex;
+#endif //QC_MT
+};
+
+QC_NET_NAMESPACE_END
+
+#endif //QC_NET_ThreadPoolIOEngine_h
@@ -0,0 +1,759 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: UringIOEngine
+/**
+	@class qc::net::UringIOEngine
+	
+	@brief An AsyncIOEngine that uses the Linux io_uring interface.
+
+	io_uring lets a process place I/O requests in a submission queue that it
+	shares with the kernel, and collect their results from a completion
+	queue, so that a whole batch of operations is started by a single
+	system call and no thread is blocked while they are performed.  This
+	includes reads and writes of regular files, which the traditional
+	non-blocking interfaces cannot perform asynchronously.
+
+	Each call to submit() places the prepared operations in the submission
+	queue and passes them to the kernel with one @c io_uring_enter() call.
+	A thread owned by the engine waits for completions and calls each
+	operation's Handler.  No more operations are kept in progress than the
+	completion queue can hold, which is twice the queue depth given to the
+	constructor; submit() waits for earlier operations to complete when this
+	limit is reached.
+
+	The constructor throws an IOException if io_uring is not available, for
+	example because the kernel is too old to support every operation or
+	because the process is not permitted to use it.  AsyncIOEngine::Create()
+	catches this and returns a ThreadPoolIOEngine instead.
+
+	shutdown() asks the kernel to cancel each operation still in progress,
+	which ends receives and accepts that would otherwise wait indefinitely,
+	and then waits for them to complete.  Operations that are already being
+	performed, such as a read from a disk, cannot be cancelled and are
+	allowed to finish.  If the kernel reports an error while the engine is
+	waiting for completions, every operation in progress is completed with
+	that error.
+
+	This class is only present in multi-threaded versions of the library
+	built for Linux with the io_uring header available.
+*/
+//==============================================================================
+
+#include "UringIOEngine.h"
+
+#if defined(HAVE_LINUX_IO_URING_H) && defined(QC_MT)
+
+#include "QcCore/base/SystemUtils.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/io/PosixFileDescriptor.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <set>
+#include <vector>
+
+QC_NET_NAMESPACE_BEGIN
+
+using io::IOException;
+using io::PosixFileDescriptor;
+
+//
+// The largest transfer that Linux performs in one read or write call.
+//
+const size_t MaxTransfer = 0x7ffff000;
+
+//
+// Values of user_data that mark entries which are not Operations.
+//
+const __u64 ExitMarker = 1;
+const __u64 CancelMarker = 2;
+
+//==============================================================================
+// Class: UringIOEngine::Ring
+//
+// The submission and completion queues shared with the kernel.  Operations
+// are added to the submission queue under the Monitor's lock.  The
+// completion queue is only read by the thread running run().
+//
+// An Operation's address is passed to the kernel as its user_data, and the
+// Ring holds a reference to the Operation until its completion is reaped.
+// The Operations in flight are kept in a set so that stop() can cancel
+// each of them, and so that they can be failed if the ring breaks.
+//
+// This is an internal class and is not exported from the library.
+//==============================================================================
+class UringIOEngine::Ring : public Runnable, public Monitor
+{
+public:
+	Ring(unsigned entries);
+	~Ring();
+
+	void submit(const std::vector<Operation*>& operations);
+	void stop();
+
+	// From Runnable...
+	virtual void run();
+
+private:
+	typedef std::set<Operation*> OperationSet;
+
+	struct io_uring_sqe* nextSQE();
+	void commitSQE();
+	void flush();
+	void prepare(struct io_uring_sqe* pSQE, Operation* pOp);
+	void fail(int errorNum);
+	void unmap();
+
+private:
+	int m_fd;
+	void* m_pSQRing;
+	size_t m_sqRingSize;
+	void* m_pCQRing;
+	size_t m_cqRingSize;
+	struct io_uring_sqe* m_pSQEs;
+	size_t m_sqesSize;
+	unsigned* m_pSQHead;
+	unsigned* m_pSQTail;
+	unsigned m_sqMask;
+	unsigned m_sqEntries;
+	unsigned* m_pCQHead;
+	unsigned* m_pCQTail;
+	unsigned m_cqMask;
+	unsigned m_cqEntries;
+	struct io_uring_cqe* m_pCQEs;
+	unsigned m_sqPending;
+	OperationSet m_inFlight;
+	int m_errorNum;
+	bool m_bStopped;
+};
+
+//==============================================================================
+// UringIOEngine::Ring::Ring
+//
+// Creates the ring, maps its queues and checks that the kernel supports
+// every operation that the engine uses.
+//==============================================================================
+UringIOEngine::Ring::Ring(unsigned entries) :
+	m_fd(-1),
+	m_pSQRing(MAP_FAILED),
+	m_sqRingSize(0),
+	m_pCQRing(MAP_FAILED),
+	m_cqRingSize(0),
+	m_pSQEs(0),
+	m_sqesSize(0),
+	m_sqPending(0),
+	m_errorNum(0),
+	m_bStopped(false)
+{
+	struct io_uring_params params;
+	::memset(&params, 0, sizeof(params));
+
+	m_fd = (int)::syscall(__NR_io_uring_setup, entries, &params);
+	if(m_fd < 0)
+	{
+		throw IOException(QC_T("io_uring_setup: ") + SystemUtils::GetSystemErrorString(errno));
+	}
+
+	try
+	{
+		m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		const bool bSingleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if(bSingleMap)
+		{
+			if(m_cqRingSize > m_sqRingSize) m_sqRingSize = m_cqRingSize;
+			m_cqRingSize = m_sqRingSize;
+		}
+
+		m_pSQRing = ::mmap(0, m_sqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+		                   m_fd, IORING_OFF_SQ_RING);
+		if(m_pSQRing == MAP_FAILED)
+		{
+			throw IOException(QC_T("io_uring mmap: ") + SystemUtils::GetSystemErrorString(errno));
+		}
+
+		m_pCQRing = bSingleMap ? m_pSQRing
+		                       : ::mmap(0, m_cqRingSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+		                                m_fd, IORING_OFF_CQ_RING);
+		if(m_pCQRing == MAP_FAILED)
+		{
+			throw IOException(QC_T("io_uring mmap: ") + SystemUtils::GetSystemErrorString(errno));
+		}
+
+		m_sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+		void* pSQEs = ::mmap(0, m_sqesSize, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE,
+		                     m_fd, IORING_OFF_SQES);
+		if(pSQEs == MAP_FAILED)
+		{
+			throw IOException(QC_T("io_uring mmap: ") + SystemUtils::GetSystemErrorString(errno));
+		}
+		m_pSQEs = static_cast<struct io_uring_sqe*>(pSQEs);
+
+		char* pSQ = static_cast<char*>(m_pSQRing);
+		m_pSQHead = reinterpret_cast<unsigned*>(pSQ + params.sq_off.head);
+		m_pSQTail = reinterpret_cast<unsigned*>(pSQ + params.sq_off.tail);
+		m_sqMask = *reinterpret_cast<unsigned*>(pSQ + params.sq_off.ring_mask);
+		m_sqEntries = params.sq_entries;
+
+		char* pCQ = static_cast<char*>(m_pCQRing);
+		m_pCQHead = reinterpret_cast<unsigned*>(pCQ + params.cq_off.head);
+		m_pCQTail = reinterpret_cast<unsigned*>(pCQ + params.cq_off.tail);
+		m_cqMask = *reinterpret_cast<unsigned*>(pCQ + params.cq_off.ring_mask);
+		m_cqEntries = params.cq_entries;
+		m_pCQEs = reinterpret_cast<struct io_uring_cqe*>(pCQ + params.cq_off.cqes);
+
+		//
+		// Each submission queue slot always refers to the entry with the
+		// same index
+		//
+		unsigned* pArray = reinterpret_cast<unsigned*>(pSQ + params.sq_off.array);
+		for(unsigned i=0; i<m_sqEntries; ++i)
+		{
+			pArray[i] = i;
+		}
+
+		//
+		// Kernels before 5.6 lack the probe, and also the READ, WRITE, SEND
+		// and RECV operations, so a failure here means io_uring cannot be used.
+		// ASYNC_CANCEL is needed by stop().
+		//
+		const unsigned numOps = 256;
+		std::vector<Byte> probeBuffer(sizeof(struct io_uring_probe) +
+		                              numOps * sizeof(struct io_uring_probe_op));
+		struct io_uring_probe* pProbe = reinterpret_cast<struct io_uring_probe*>(&probeBuffer[0]);
+		if(::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, pProbe, numOps) < 0)
+		{
+			throw IOException(QC_T("io_uring probe: ") + SystemUtils::GetSystemErrorString(errno));
+		}
+
+		static const unsigned requiredOps[] = {IORING_OP_NOP, IORING_OP_READ, IORING_OP_WRITE,
+		                                       IORING_OP_RECV, IORING_OP_SEND,
+		                                       IORING_OP_ACCEPT, IORING_OP_CONNECT,
+		                                       IORING_OP_ASYNC_CANCEL};
+		for(size_t i=0; i<sizeof(requiredOps)/sizeof(requiredOps[0]); ++i)
+		{
+			const unsigned op = requiredOps[i];
+			if(op > pProbe->last_op || !(pProbe->ops[op].flags & IO_URING_OP_SUPPORTED))
+			{
+				throw IOException(QC_T("io_uring does not support the required operations"));
+			}
+		}
+	}
+	catch(IOException& /*e*/)
+	{
+		unmap();
+		::close(m_fd);
+		throw;
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Ring::~Ring
+//
+//==============================================================================
+UringIOEngine::Ring::~Ring()
+{
+	unmap();
+	::close(m_fd);
+}
+
+//==============================================================================
+// UringIOEngine::Ring::unmap
+//
+//==============================================================================
+void UringIOEngine::Ring::unmap()
+{
+	if(m_pSQEs)
+	{
+		::munmap(m_pSQEs, m_sqesSize);
+		m_pSQEs = 0;
+	}
+	if(m_pCQRing != MAP_FAILED && m_pCQRing != m_pSQRing)
+	{
+		::munmap(m_pCQRing, m_cqRingSize);
+	}
+	m_pCQRing = MAP_FAILED;
+	if(m_pSQRing != MAP_FAILED)
+	{
+		::munmap(m_pSQRing, m_sqRingSize);
+		m_pSQRing = MAP_FAILED;
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Ring::submit
+//
+// Places the operations in the submission queue and passes them to the
+// kernel.  While the completion queue could not hold the result of another
+// operation, waits for the reaping thread to take some.
+//==============================================================================
+void UringIOEngine::Ring::submit(const std::vector<Operation*>& operations)
+{
+	std::vector<Operation*> cancelled;
+	int errorNum = ECANCELED;
+
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+
+		for(size_t i=0; i<operations.size(); ++i)
+		{
+			while(!m_bStopped && m_inFlight.size() >= m_cqEntries)
+			{
+				flush();
+				wait();
+			}
+
+			if(m_bStopped)
+			{
+				cancelled.push_back(operations[i]);
+				continue;
+			}
+
+			prepare(nextSQE(), operations[i]);
+			commitSQE();
+			m_inFlight.insert(operations[i]);
+		}
+
+		if(m_errorNum)
+		{
+			errorNum = m_errorNum;
+		}
+		else
+		{
+			flush();
+		}
+	}
+
+	for(size_t i=0; i<cancelled.size(); ++i)
+	{
+		Complete(cancelled[i], 0, errorNum);
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Ring::stop
+//
+// Cancels each operation in progress by its user_data, waits for them all to
+// complete and then tells the reaping thread to finish.  If the reaping
+// thread has failed it has already completed the operations and returned.
+//==============================================================================
+void UringIOEngine::Ring::stop()
+{
+	QC_SYNCHRONIZED
+
+	if(m_bStopped)
+	{
+		return;
+	}
+	m_bStopped = true;
+
+	for(OperationSet::const_iterator i=m_inFlight.begin(); i!=m_inFlight.end(); ++i)
+	{
+		struct io_uring_sqe* pSQE = nextSQE();
+		::memset(pSQE, 0, sizeof(*pSQE));
+		pSQE->opcode = IORING_OP_ASYNC_CANCEL;
+		pSQE->fd = -1;
+		pSQE->addr = (__u64)(uintptr_t)*i;
+		pSQE->user_data = CancelMarker;
+		commitSQE();
+	}
+	flush();
+
+	while(!m_inFlight.empty())
+	{
+		wait();
+	}
+
+	if(m_errorNum)
+	{
+		return;
+	}
+
+	struct io_uring_sqe* pSQE = nextSQE();
+	::memset(pSQE, 0, sizeof(*pSQE));
+	pSQE->opcode = IORING_OP_NOP;
+	pSQE->user_data = ExitMarker;
+	commitSQE();
+	flush();
+}
+
+//==============================================================================
+// UringIOEngine::Ring::run
+//
+// The reaping thread.  Waits for completions, takes them from the completion
+// queue and completes their Operations, until the exit marker is reaped.
+// Operations are removed from the in-flight set before the Handlers are
+// called so that a Handler can submit further operations without waiting
+// for itself.  If the kernel refuses to wait, the operations in flight can
+// never complete, so they are failed with the kernel's error.
+//==============================================================================
+void UringIOEngine::Ring::run()
+{
+	std::vector<Operation*> completed;
+	std::vector<int> results;
+
+	while(true)
+	{
+		if(::syscall(__NR_io_uring_enter, m_fd, 0, 1, IORING_ENTER_GETEVENTS, 0, 0) < 0)
+		{
+			const int errorNum = errno;
+			if(errorNum != EINTR && errorNum != EAGAIN && errorNum != EBUSY)
+			{
+				fail(errorNum);
+				return;
+			}
+		}
+
+		bool bExit = false;
+		completed.clear();
+		results.clear();
+
+		unsigned head = *m_pCQHead;
+		const unsigned tail = __atomic_load_n(m_pCQTail, __ATOMIC_ACQUIRE);
+		while(head != tail)
+		{
+			const struct io_uring_cqe* pCQE = &m_pCQEs[head & m_cqMask];
+			if(pCQE->user_data == ExitMarker)
+			{
+				bExit = true;
+			}
+			else if(pCQE->user_data != CancelMarker)
+			{
+				completed.push_back(reinterpret_cast<Operation*>(pCQE->user_data));
+				results.push_back(pCQE->res);
+			}
+			++head;
+		}
+		__atomic_store_n(m_pCQHead, head, __ATOMIC_RELEASE);
+
+		if(!completed.empty())
+		{
+			// create a scope for the lock
+			{
+				QC_SYNCHRONIZED
+				for(size_t i=0; i<completed.size(); ++i)
+				{
+					m_inFlight.erase(completed[i]);
+				}
+				notifyAll();
+			}
+
+			for(size_t i=0; i<completed.size(); ++i)
+			{
+				AutoPtr<Operation> rpOp = completed[i];
+				completed[i]->release(); // the reference taken by prepare()
+				Finish(rpOp.get(), results[i]);
+			}
+		}
+
+		if(bExit)
+		{
+			return;
+		}
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Ring::fail
+//
+// Stops the Ring and completes every operation in flight with the error
+// errorNum.  Called by the reaping thread when it cannot wait for
+// completions.
+//==============================================================================
+void UringIOEngine::Ring::fail(int errorNum)
+{
+	std::vector<Operation*> failed;
+
+	// create a scope for the lock
+	{
+		QC_SYNCHRONIZED
+		m_bStopped = true;
+		m_errorNum = errorNum;
+		failed.assign(m_inFlight.begin(), m_inFlight.end());
+		m_inFlight.clear();
+		notifyAll();
+	}
+
+	for(size_t i=0; i<failed.size(); ++i)
+	{
+		AutoPtr<Operation> rpOp = failed[i];
+		failed[i]->release(); // the reference taken by prepare()
+		Complete(rpOp.get(), 0, errorNum);
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Ring::nextSQE
+
+//
+// Returns the next free submission queue entry, passing the entries already
+// filled to the kernel if the queue is full.  Called with the lock held.
+//==============================================================================
+struct io_uring_sqe* UringIOEngine::Ring::nextSQE()
+{
+	const unsigned tail = *m_pSQTail;
+	if(tail - __atomic_load_n(m_pSQHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+	{
+		flush();
+	}
+	return &m_pSQEs[tail & m_sqMask];
+}
+
+//==============================================================================
+// UringIOEngine::Ring::commitSQE
+//
+// Makes the entry returned by nextSQE() visible to the kernel.
+//==============================================================================
+void UringIOEngine::Ring::commitSQE()
+{
+	__atomic_store_n(m_pSQTail, *m_pSQTail + 1, __ATOMIC_RELEASE);
+	++m_sqPending;
+}
+
+//==============================================================================
+// UringIOEngine::Ring::flush
+//
+// Passes the committed entries to the kernel.  If the kernel is busy
+// because completions are waiting to be reaped, waits briefly for the
+// reaping thread and tries again.  Called with the lock held.
+//==============================================================================
+void UringIOEngine::Ring::flush()
+{
+	while(m_sqPending)
+	{
+		const long ret = ::syscall(__NR_io_uring_enter, m_fd, m_sqPending, 0, 0, 0, 0);
+		if(ret < 0)
+		{
+			const int errorNum = errno;
+			if(errorNum == EINTR)
+			{
+				continue;
+			}
+			if(errorNum == EAGAIN || errorNum == EBUSY)
+			{
+				wait(1);
+				continue;
+			}
+			throw IOException(QC_T("io_uring_enter: ") + SystemUtils::GetSystemErrorString(errorNum));
+		}
+		m_sqPending -= (unsigned)ret;
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Ring::prepare
+//
+// Fills a submission queue entry for an operation and takes a reference to
+// the operation, which is released when its completion is reaped.
+//==============================================================================
+void UringIOEngine::Ring::prepare(struct io_uring_sqe* pSQE, Operation* pOp)
+{
+	::memset(pSQE, 0, sizeof(*pSQE));
+
+	const __u32 length = (__u32)((pOp->m_length > MaxTransfer) ? MaxTransfer : pOp->m_length);
+
+	switch(pOp->m_type)
+	{
+	case Operation::Read:
+	case Operation::Write:
+		pSQE->opcode = (pOp->m_type == Operation::Read) ? IORING_OP_READ : IORING_OP_WRITE;
+		pSQE->fd = static_cast<PosixFileDescriptor*>(pOp->m_rpFD.get())->getFD();
+		pSQE->addr = (__u64)(uintptr_t)pOp->m_pBuffer;
+		pSQE->len = length;
+		pSQE->off = pOp->m_offset;
+		break;
+
+	case Operation::Receive:
+	case Operation::Send:
+		pSQE->opcode = (pOp->m_type == Operation::Receive) ? IORING_OP_RECV : IORING_OP_SEND;
+		pSQE->fd = pOp->m_rpSocket->getFD();
+		pSQE->addr = (__u64)(uintptr_t)pOp->m_pBuffer;
+		pSQE->len = length;
+#if defined(MSG_NOSIGNAL)
+		if(pOp->m_type == Operation::Send)
+		{
+			pSQE->msg_flags = MSG_NOSIGNAL;
+		}
+#endif //MSG_NOSIGNAL
+		break;
+
+	case Operation::Accept:
+		pSQE->opcode = IORING_OP_ACCEPT;
+		pSQE->fd = pOp->m_rpSocket->getFD();
+		pSQE->addr = (__u64)(uintptr_t)pOp->m_address.bytes;
+		pSQE->addr2 = (__u64)(uintptr_t)&pOp->m_addressLength;
+		break;
+
+	case Operation::Connect:
+		pSQE->opcode = IORING_OP_CONNECT;
+		pSQE->fd = pOp->m_rpSocket->getFD();
+		pSQE->addr = (__u64)(uintptr_t)pOp->m_address.bytes;
+		pSQE->off = pOp->m_addressLength;
+		break;
+	}
+
+	pSQE->user_data = (__u64)(uintptr_t)pOp;
+	pOp->addRef();
+}
+
+//==============================================================================
+// UringIOEngine::UringIOEngine
+//
+/**
+   Constructs a UringIOEngine and starts the thread that waits for
+   completions.
+
+   @param queueDepth the number of entries in the submission queue, which is
+          rounded up to a power of two by the kernel
+   @throws IOException if io_uring is not available or does not support all
+           of the operations.
+*/
+//==============================================================================
+UringIOEngine::UringIOEngine(size_t queueDepth)
+{
+	if(queueDepth == 0) queueDepth = 1;
+	if(queueDepth > 4096) queueDepth = 4096;
+
+	m_rpRing = new Ring((unsigned)queueDepth);
+	m_rpThread = new Thread(m_rpRing.get());
+	m_rpThread->setDaemon(true);
+	m_rpThread->start();
+}
+
+//==============================================================================
+// UringIOEngine::~UringIOEngine
+//
+/**
+   Destructor.  Cancels the operations in progress and waits for them to
+   complete.
+*/
+//==============================================================================
+UringIOEngine::~UringIOEngine()
+{
+	try
+	{
+		shutdown();
+	}
+	catch(Exception& /*e*/)
+	{
+	}
+}
+
+//==============================================================================
+// UringIOEngine::shutdown
+//
+//==============================================================================
+void UringIOEngine::shutdown()
+{
+	submit();
+
+	AutoPtr<Ring> rpRing;
+	AutoPtr<Thread> rpThread;
+
+	// create a scope for the lock
+	{
+		QC_AUTO_LOCK(FastMutex, m_mutex);
+		rpRing = m_rpRing;
+		rpThread = m_rpThread;
+		m_rpRing.release();
+		m_rpThread.release();
+	}
+
+	if(rpRing)
+	{
+		rpRing->stop();
+		rpThread->join();
+	}
+}
+
+//==============================================================================
+// UringIOEngine::getName
+//
+//==============================================================================
+String UringIOEngine::getName() const
+{
+	return QC_T("io_uring");
+}
+
+//==============================================================================
+// UringIOEngine::start
+//
+//==============================================================================
+void UringIOEngine::start(const std::vector<Operation*>& operations)
+{
+	AutoPtr<Ring> rpRing;
+
+	// create a scope for the lock
+	{
+		QC_AUTO_LOCK(FastMutex, m_mutex);
+		rpRing = m_rpRing;
+	}
+
+	if(rpRing)
+	{
+		rpRing->submit(operations);
+	}
+	else
+	{
+		for(size_t i=0; i<operations.size(); ++i)
+		{
+			Complete(operations[i], 0, ECANCELED);
+		}
+	}
+}
+
+//==============================================================================
+// UringIOEngine::Finish
+//
+// Completes an operation with the result of its completion queue entry,
+// which is a negated error number on failure.  A successful accept returns
+// the new socket.
+//==============================================================================
+void UringIOEngine::Finish(Operation* pOp, int result)
+{
+	if(result < 0)
+	{
+		Complete(pOp, 0, -result);
+	}
+	else if(pOp->m_type == Operation::Accept)
+	{
+		pOp->m_rpSocket = new SocketDescriptor(result);
+		Complete(pOp, 0, 0);
+	}
+	else
+	{
+		Complete(pOp, result, 0);
+	}
+}
+
+QC_NET_NAMESPACE_END
+
+#endif //HAVE_LINUX_IO_URING_H
@@ -0,0 +1,72 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: UringIOEngine
+// 
+//==============================================================================
+
+#ifndef QC_NET_UringIOEngine_h
+#define QC_NET_UringIOEngine_h
+
+#ifndef QC_NET_DEFS_h
+#include "defs.h"
+#endif //QC_NET_DEFS_h
+
+#if defined(HAVE_LINUX_IO_URING_H) && defined(QC_MT)
+
+#include "AsyncIOEngine.h"
+
+#include "QcCore/base/Thread.h"
+
+QC_NET_NAMESPACE_BEGIN
+
+class QC_NET_PKG UringIOEngine : public AsyncIOEngine
+{
+public:
+	UringIOEngine(size_t queueDepth=DefaultQueueDepth);
+	virtual ~UringIOEngine();
+
+	virtual void shutdown();
+	virtual String getName() const;
+
+protected:
+	virtual void start(const std::vector<Operation*>& operations);
+
+private:
+	class Ring;
+
+	static void Finish(Operation* pOperation, int result);
+
+private:
+	AutoPtr<Ring> m_rpRing;
+	AutoPtr<Thread> m_rpThread;
+	FastMutex m_mutex;
+};
+
+QC_NET_NAMESPACE_END
+
+#endif //HAVE_LINUX_IO_URING_H
+
+#endif //QC_NET_UringIOEngine_h
@@ -0,0 +1,247 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CRC32
+/**
+	@class qc::util::CRC32
+	
+	@brief Computes the CRC-32 used by zip, gzip, PNG and Ethernet.
+
+	The CRC uses the polynomial 0x04C11DB7 in its bit-reflected form.  The
+	CRC of the ASCII string "123456789" is 0xCBF43926.
+
+	Where the processor supports the carry-less multiplication instruction,
+	blocks of 64 bytes or more are processed by "folding" the data with
+	@c pclmulqdq, as described by Intel in "Fast CRC Computation for Generic
+	Polynomials Using PCLMULQDQ Instruction", which processes 16 bytes per
+	step.  Otherwise, and for the remaining bytes, the portable
+	slicing-by-8 method is used.
+
+	@sa CRC32C
+*/
+//==============================================================================
+
+#include "CRC32.h"
+#include "CrcTable.h"
+
+#include "QcCore/base/CpuFeatures.h"
+
+#if defined(QC_X86_SIMD)
+	#include <immintrin.h>
+#endif //QC_X86_SIMD
+
+QC_UTIL_NAMESPACE_BEGIN
+
+typedef CrcTable<0xEDB88320> Crc32Table;
+
+#if defined(QC_X86_SIMD)
+
+//
+// The folding constants and the Barrett reduction constants for the
+// reflected polynomial, from the Intel paper
+//
+static const unsigned long long K1K2[2] = {0x0154442bd4ULL, 0x01c6e41596ULL};
+static const unsigned long long K3K4[2] = {0x01751997d0ULL, 0x00ccaa009eULL};
+static const unsigned long long K5K0[2] = {0x0163cd6124ULL, 0x0000000000ULL};
+static const unsigned long long Poly[2] = {0x01db710641ULL, 0x01f7011641ULL};
+
+//==============================================================================
+// Update_PCLMUL
+//
+// Adds len bytes to crc (in its inverted form).  len must be at least 64 and
+// a multiple of 16.  Four 16-byte lanes are folded in parallel, then folded
+// into one, and the 128-bit remainder is reduced to 32 bits.
+//==============================================================================
+QC_TARGET_PCLMUL
+static unsigned int Update_PCLMUL(unsigned int crc, const Byte* pData, size_t len)
+{
+	__m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+
+	x1 = _mm_loadu_si128((const __m128i*)(pData + 0x00));
+	x2 = _mm_loadu_si128((const __m128i*)(pData + 0x10));
+	x3 = _mm_loadu_si128((const __m128i*)(pData + 0x20));
+	x4 = _mm_loadu_si128((const __m128i*)(pData + 0x30));
+
+	x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(int(crc)));
+
+	x0 = _mm_loadu_si128((const __m128i*)K1K2);
+
+	pData += 64;
+	len -= 64;
+
+	//
+	// Fold four lanes in parallel, 64 bytes per iteration
+	//
+	while(len >= 64)
+	{
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+		x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+		x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+		x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+		x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+
+		y5 = _mm_loadu_si128((const __m128i*)(pData + 0x00));
+		y6 = _mm_loadu_si128((const __m128i*)(pData + 0x10));
+		y7 = _mm_loadu_si128((const __m128i*)(pData + 0x20));
+		y8 = _mm_loadu_si128((const __m128i*)(pData + 0x30));
+
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+		x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+		x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+		x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+
+		pData += 64;
+		len -= 64;
+	}
+
+	//
+	// Fold the four lanes into one
+	//
+	x0 = _mm_loadu_si128((const __m128i*)K3K4);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+
+	x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+	x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+	//
+	// Fold any remaining 16-byte blocks
+	//
+	while(len >= 16)
+	{
+		x2 = _mm_loadu_si128((const __m128i*)pData);
+
+		x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+		x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+		x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+
+		pData += 16;
+		len -= 16;
+	}
+
+	//
+	// Fold 128 bits to 64 bits
+	//
+	x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+	x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+	x1 = _mm_srli_si128(x1, 8);
+	x1 = _mm_xor_si128(x1, x2);
+
+	x0 = _mm_loadl_epi64((const __m128i*)K5K0);
+
+	x2 = _mm_srli_si128(x1, 4);
+	x1 = _mm_and_si128(x1, x3);
+	x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	//
+	// Barrett reduction to 32 bits
+	//
+	x0 = _mm_loadu_si128((const __m128i*)Poly);
+
+	x2 = _mm_and_si128(x1, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+	x2 = _mm_and_si128(x2, x3);
+	x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+	x1 = _mm_xor_si128(x1, x2);
+
+	return (unsigned int)_mm_extract_epi32(x1, 1);
+}
+
+#endif //QC_X86_SIMD
+
+//==============================================================================
+// CRC32::CRC32
+//
+/**
+   Constructs a CRC32 with no bytes added.
+*/
+//==============================================================================
+CRC32::CRC32() :
+	m_crc(0xFFFFFFFF)
+{
+}
+
+//==============================================================================
+// CRC32::getName
+//
+/**
+   Returns "CRC32".
+*/
+//==============================================================================
+String CRC32::getName() const
+{
+	return QC_T("CRC32");
+}
+
+//==============================================================================
+// CRC32::getValue
+//
+//==============================================================================
+unsigned long long CRC32::getValue() const
+{
+	return (unsigned int)~m_crc;
+}
+
+//==============================================================================
+// CRC32::reset
+//
+//==============================================================================
+void CRC32::reset()
+{
+	m_crc = 0xFFFFFFFF;
+}
+
+//==============================================================================
+// CRC32::update
+//
+//==============================================================================
+void CRC32::update(const Byte* pData, size_t len)
+{
+#if defined(QC_X86_SIMD)
+	if(len >= 64 && CpuFeatures::HasPCLMUL() && CpuFeatures::HasSSE42())
+	{
+		const size_t blockLen = len & ~size_t(15);
+		m_crc = Update_PCLMUL(m_crc, pData, blockLen);
+		pData += blockLen;
+		len -= blockLen;
+	}
+#endif //QC_X86_SIMD
+
+	m_crc = Crc32Table::Update(m_crc, pData, len);
+}
+
+QC_UTIL_NAMESPACE_END
@@ -0,0 +1,333 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CRC32C
+/**
+	@class qc::util::CRC32C
+	
+	@brief Computes the CRC-32C (Castagnoli) used by iSCSI, SCTP, ext4 and
+	       many storage formats.
+
+	The CRC uses the polynomial 0x1EDC6F41 in its bit-reflected form.  The
+	CRC of the ASCII string "123456789" is 0xE3069283.
+
+	Processors that support SSE4.2 calculate this CRC with the @c crc32
+	instruction, eight bytes at a time.  On 64-bit processors large blocks
+	are split into three streams that are calculated together, hiding the
+	instruction's latency, and the three results are then combined.
+	Otherwise the portable slicing-by-8 method is used.
+
+	@sa CRC32
+*/
+//==============================================================================
+
+#include "CRC32C.h"
+#include "CrcTable.h"
+
+#include "QcCore/base/CpuFeatures.h"
+
+#include <string.h>
+
+#if defined(QC_X86_SIMD)
+	#include <immintrin.h>
+#endif //QC_X86_SIMD
+
+QC_UTIL_NAMESPACE_BEGIN
+
+const unsigned int Castagnoli = 0x82F63B78;
+
+typedef CrcTable<Castagnoli> Crc32cTable;
+
+#if defined(QC_X86_SIMD) && (defined(_M_X64) || defined(__x86_64__))
+
+//
+// The lengths of the streams calculated together.  Blocks of three times
+// LongStream bytes are split into three streams of LongStream bytes, and
+// what remains into streams of ShortStream bytes.
+//
+const size_t LongStream = 8192;
+const size_t ShortStream = 256;
+
+//
+// Tables which shift a CRC past LongStream and ShortStream zero bytes, so
+// that the CRC of one stream can be combined with that of the next.  Like
+// the tables of CrcTable, they are calculated on first use.
+//
+static unsigned int s_longShift[4][256];
+static unsigned int s_shortShift[4][256];
+static bool QC_MT_VOLATILE s_bShiftInitialized = false;
+
+//==============================================================================
+// MatrixTimes
+//
+// Multiplies a 32x32 matrix over GF(2) by a vector.
+//==============================================================================
+static unsigned int MatrixTimes(const unsigned int* pMatrix, unsigned int vec)
+{
+	unsigned int sum = 0;
+	for(; vec; vec >>= 1, ++pMatrix)
+	{
+		if(vec & 1)
+		{
+			sum ^= *pMatrix;
+		}
+	}
+	return sum;
+}
+
+//==============================================================================
+// MatrixSquare
+//
+//==============================================================================
+static void MatrixSquare(unsigned int* pSquare, const unsigned int* pMatrix)
+{
+	for(int n=0; n<32; ++n)
+	{
+		pSquare[n] = MatrixTimes(pMatrix, pMatrix[n]);
+	}
+}
+
+//==============================================================================
+// MakeShiftTable
+//
+// Builds the tables that apply len zero bytes to a CRC, where len is a power
+// of two.  The operator for one zero bit is squared repeatedly to obtain
+// the operator for len bytes, which is then tabulated a byte at a time.
+//==============================================================================
+static void MakeShiftTable(unsigned int table[4][256], size_t len)
+{
+	unsigned int even[32];
+	unsigned int odd[32];
+
+	odd[0] = Castagnoli;
+	unsigned int row = 1;
+	for(int n=1; n<32; ++n)
+	{
+		odd[n] = row;
+		row <<= 1;
+	}
+
+	MatrixSquare(even, odd);  // two zero bits
+	MatrixSquare(odd, even);  // four zero bits
+
+	const unsigned int* pOperator = 0;
+	while(true)
+	{
+		MatrixSquare(even, odd);
+		len >>= 1;
+		if(len == 0)
+		{
+			pOperator = even;
+			break;
+		}
+		MatrixSquare(odd, even);
+		len >>= 1;
+		if(len == 0)
+		{
+			pOperator = odd;
+			break;
+		}
+	}
+
+	for(unsigned int n=0; n<256; ++n)
+	{
+		table[0][n] = MatrixTimes(pOperator, n);
+		table[1][n] = MatrixTimes(pOperator, n << 8);
+		table[2][n] = MatrixTimes(pOperator, n << 16);
+		table[3][n] = MatrixTimes(pOperator, n << 24);
+	}
+}
+
+//==============================================================================
+// Shift
+//
+//==============================================================================
+static inline unsigned int Shift(const unsigned int table[4][256], unsigned int crc)
+{
+	return table[0][crc & 0xFF] ^ table[1][(crc >> 8) & 0xFF] ^
+	       table[2][(crc >> 16) & 0xFF] ^ table[3][crc >> 24];
+}
+
+//==============================================================================
+// UpdateStreams
+//
+// Calculates three consecutive streams of streamLen bytes together and
+// combines their CRCs.  Returns the number of bytes consumed, which is a
+// multiple of three times streamLen.
+//==============================================================================
+QC_TARGET_SSE42
+static size_t UpdateStreams(unsigned int& crc, const Byte* pData, size_t len,
+                            size_t streamLen, const unsigned int table[4][256])
+{
+	size_t consumed = 0;
+	unsigned long long crc0 = crc;
+
+	while(len - consumed >= streamLen * 3)
+	{
+		const Byte* p = pData + consumed;
+		const Byte* pEnd = p + streamLen;
+		unsigned long long crc1 = 0;
+		unsigned long long crc2 = 0;
+		unsigned long long v0, v1, v2;
+		for(; p < pEnd; p += 8)
+		{
+			::memcpy(&v0, p, 8);
+			::memcpy(&v1, p + streamLen, 8);
+			::memcpy(&v2, p + streamLen * 2, 8);
+			crc0 = _mm_crc32_u64(crc0, v0);
+			crc1 = _mm_crc32_u64(crc1, v1);
+			crc2 = _mm_crc32_u64(crc2, v2);
+		}
+		crc0 = Shift(table, (unsigned int)crc0) ^ (unsigned int)crc1;
+		crc0 = Shift(table, (unsigned int)crc0) ^ (unsigned int)crc2;
+		consumed += streamLen * 3;
+	}
+
+	crc = (unsigned int)crc0;
+	return consumed;
+}
+
+#endif //QC_X86_SIMD && 64-bit
+
+#if defined(QC_X86_SIMD)
+
+//==============================================================================
+// Update_SSE42
+//
+// Adds len bytes to crc (in its inverted form) using the crc32 instruction.
+//==============================================================================
+QC_TARGET_SSE42
+static unsigned int Update_SSE42(unsigned int crc, const Byte* pData, size_t len)
+{
+	for(; len && (size_t(pData) & 7); --len)
+	{
+		crc = _mm_crc32_u8(crc, *pData++);
+	}
+
+#if defined(_M_X64) || defined(__x86_64__)
+
+	if(len >= ShortStream * 3)
+	{
+		if(!s_bShiftInitialized)
+		{
+			MakeShiftTable(s_longShift, LongStream);
+			MakeShiftTable(s_shortShift, ShortStream);
+			s_bShiftInitialized = true;
+		}
+
+		size_t consumed = UpdateStreams(crc, pData, len, LongStream, s_longShift);
+		consumed += UpdateStreams(crc, pData + consumed, len - consumed, ShortStream, s_shortShift);
+		pData += consumed;
+		len -= consumed;
+	}
+
+	unsigned long long crc64 = crc;
+	for(; len >= 8; len -= 8, pData += 8)
+	{
+		unsigned long long v;
+		::memcpy(&v, pData, 8);
+		crc64 = _mm_crc32_u64(crc64, v);
+	}
+	crc = (unsigned int)crc64;
+
+#endif //64-bit
+
+	for(; len >= 4; len -= 4, pData += 4)
+	{
+		unsigned int v;
+		::memcpy(&v, pData, 4);
+		crc = _mm_crc32_u32(crc, v);
+	}
+
+	for(; len; --len)
+	{
+		crc = _mm_crc32_u8(crc, *pData++);
+	}
+
+	return crc;
+}
+
+#endif //QC_X86_SIMD
+
+//==============================================================================
+// CRC32C::CRC32C
+//
+/**
+   Constructs a CRC32C with no bytes added.
+*/
+//==============================================================================
+CRC32C::CRC32C() :
+	m_crc(0xFFFFFFFF)
+{
+}
+
+//==============================================================================
+// CRC32C::getName
+//
+/**
+   Returns "CRC32C".
+*/
+//==============================================================================
+String CRC32C::getName() const
+{
+	return QC_T("CRC32C");
+}
+
+//==============================================================================
+// CRC32C::getValue
+//
+//==============================================================================
+unsigned long long CRC32C::getValue() const
+{
+	return (unsigned int)~m_crc;
+}
+
+//==============================================================================
+// CRC32C::reset
+//
+//==============================================================================
+void CRC32C::reset()
+{
+	m_crc = 0xFFFFFFFF;
+}
+
+//==============================================================================
+// CRC32C::update
+//
+//==============================================================================
+void CRC32C::update(const Byte* pData, size_t len)
+{
+#if defined(QC_X86_SIMD)
+	if(CpuFeatures::HasSSE42())
+	{
+		m_crc = Update_SSE42(m_crc, pData, len);
+		return;
+	}
+#endif //QC_X86_SIMD
+
+	m_crc = Crc32cTable::Update(m_crc, pData, len);
+}
+
+QC_UTIL_NAMESPACE_END
@@ -0,0 +1,57 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CRC32C
+// 
+//==============================================================================
+
+#ifndef QC_UTIL_CRC32C_h
+#define QC_UTIL_CRC32C_h
+
+#ifndef QC_UTIL_DEFS_h
+#include "defs.h"
+#endif //QC_UTIL_DEFS_h
+
+#include "Checksum.h"
+
+QC_UTIL_NAMESPACE_BEGIN
+
+class QC_UTIL_PKG CRC32C : public Checksum
+{
+public:
+	CRC32C();
+
+	virtual String getName() const;
+	virtual unsigned long long getValue() const;
+	virtual void reset();
+	virtual void update(const Byte* pData, size_t len);
+
+private:
+	unsigned int m_crc;
+};
+
+QC_UTIL_NAMESPACE_END
+
+#endif //QC_UTIL_CRC32C_h
@@ -0,0 +1,101 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Checksum
+/**
+	@class qc::util::Checksum
+	
+	@brief Abstract base class for algorithms that compute a checksum or hash
+	       of a sequence of bytes.
+
+	The bytes are passed to update() in as many pieces as is convenient;
+	the value returned by getValue() depends only on the sequence of bytes
+	and not on how it was divided.  getValue() may be called at any time and
+	does not change the state of the Checksum, so a running checksum can be
+	inspected while more bytes are still to come.
+
+	The library provides CRC32, CRC32C and XXHash64.  Checksums are most
+	conveniently computed while data is being read or written, by
+	io::CheckedInputStream and io::CheckedOutputStream.
+
+	A Checksum should be used by only one thread at a time.
+*/
+//==============================================================================
+
+#include "Checksum.h"
+
+QC_UTIL_NAMESPACE_BEGIN
+
+#ifdef QC_DOCUMENTATION_ONLY
+//=============================================================================
+//
+// Documentation for pure virtual methods follows:
+//
+//=============================================================================
+
+//==============================================================================
+// Checksum::getName
+//
+/**
+   Returns the name of the algorithm, for example "CRC32C".
+*/
+//==============================================================================
+String Checksum::getName() const;
+
+//==============================================================================
+// Checksum::getValue
+//
+/**
+   Returns the checksum of all the bytes passed to update() since the
+   Checksum was constructed or last reset.  Checksums narrower than 64 bits
+   occupy the low-order bits of the value.
+*/
+//==============================================================================
+unsigned long long Checksum::getValue() const;
+
+//==============================================================================
+// Checksum::reset
+//
+/**
+   Returns the Checksum to its initial state, as if no bytes had been passed
+   to update().
+*/
+//==============================================================================
+void Checksum::reset();
+
+//==============================================================================
+// Checksum::update
+//
+/**
+   Adds @c len bytes starting at @c pData to the checksum.
+   @param pData the bytes to add
+   @param len the number of bytes to add, which may be zero
+*/
+//==============================================================================
+void Checksum::update(const Byte* pData, size_t len);
+
+#endif //QC_DOCUMENTATION_ONLY
+
+QC_UTIL_NAMESPACE_END
@@ -0,0 +1,52 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: Checksum
+// 
+//==============================================================================
+
+#ifndef QC_UTIL_Checksum_h
+#define QC_UTIL_Checksum_h
+
+#ifndef QC_UTIL_DEFS_h
+#include "defs.h"
+#endif //QC_UTIL_DEFS_h
+
+#include "QcCore/base/QCObject.h"
+
+QC_UTIL_NAMESPACE_BEGIN
+
+class QC_UTIL_PKG Checksum : public virtual QCObject
+{
+public:
+	virtual String getName() const=0;
+	virtual unsigned long long getValue() const=0;
+	virtual void reset()=0;
+	virtual void update(const Byte* pData, size_t len)=0;
+};
+
+QC_UTIL_NAMESPACE_END
+
+#endif //QC_UTIL_Checksum_h
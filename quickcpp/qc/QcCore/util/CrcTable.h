@@ -0,0 +1,148 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: CrcTable
+// 
+// Overview
+// --------
+// Template class providing the portable implementation shared by CRC32 and
+// CRC32C, for the bit-reflected 32-bit CRC with the given polynomial.
+//
+// Update() uses the "slicing-by-8" method: eight tables of 256 entries
+// allow eight bytes to be processed with one table lookup per byte and no
+// dependency between the lookups, instead of the eight dependent steps of
+// the classic byte-at-a-time method.
+//
+// The tables are calculated on first use.  No mutex is required because
+// every thread calculates exactly the same values.
+//
+// This is an internal class and is not exported from the library.
+//
+//=============================================================================
+
+#ifndef QC_UTIL_CrcTable_h
+#define QC_UTIL_CrcTable_h
+
+#ifndef QC_UTIL_DEFS_h
+#include "defs.h"
+#endif //QC_UTIL_DEFS_h
+
+QC_UTIL_NAMESPACE_BEGIN
+
+	template<unsigned int Polynomial>
+class CrcTable
+{
+public:
+	static unsigned int Update(unsigned int crc, const Byte* pData, size_t len);
+
+private:
+	CrcTable(); // not implemented
+
+	static void Initialize();
+
+private:
+	static unsigned int s_table[8][256];
+	static bool QC_MT_VOLATILE s_bInitialized;
+};
+
+template<unsigned int Polynomial>
+	unsigned int CrcTable<Polynomial>::s_table[8][256];
+
+template<unsigned int Polynomial>
+	bool QC_MT_VOLATILE CrcTable<Polynomial>::s_bInitialized = false;
+
+//==============================================================================
+// CrcTable<Polynomial>::Initialize
+//
+//==============================================================================
+template<unsigned int Polynomial>
+	void CrcTable<Polynomial>::Initialize()
+{
+	for(unsigned int i=0; i<256; ++i)
+	{
+		unsigned int crc = i;
+		for(int bit=0; bit<8; ++bit)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ Polynomial : (crc >> 1);
+		}
+		s_table[0][i] = crc;
+	}
+
+	for(unsigned int i=0; i<256; ++i)
+	{
+		for(int k=1; k<8; ++k)
+		{
+			const unsigned int prev = s_table[k-1][i];
+			s_table[k][i] = (prev >> 8) ^ s_table[0][prev & 0xFF];
+		}
+	}
+
+	s_bInitialized = true;
+}
+
+//==============================================================================
+// CrcTable<Polynomial>::Update
+//
+// Adds len bytes to crc, which is the inverted form held while a CRC is
+// being calculated, and returns the result.
+//==============================================================================
+template<unsigned int Polynomial>
+	unsigned int CrcTable<Polynomial>::Update(unsigned int crc, const Byte* pData, size_t len)
+{
+	if(!s_bInitialized)
+	{
+		Initialize();
+	}
+
+	const unsigned int (*t)[256] = s_table;
+
+	for(; len && (size_t(pData) & 7); --len)
+	{
+		crc = t[0][(crc ^ *pData++) & 0xFF] ^ (crc >> 8);
+	}
+
+	for(; len >= 8; len -= 8, pData += 8)
+	{
+		const unsigned int lo = crc ^ (pData[0] | (pData[1] << 8) | (pData[2] << 16) |
+		                               ((unsigned int)pData[3] << 24));
+		const unsigned int hi = pData[4] | (pData[5] << 8) | (pData[6] << 16) |
+		                        ((unsigned int)pData[7] << 24);
+		crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+		      t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+		      t[3][hi & 0xFF] ^ t[2][(hi >> 8) & 0xFF] ^
+		      t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+	}
+
+	for(; len; --len)
+	{
+		crc = t[0][(crc ^ *pData++) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc;
+}
+
+QC_UTIL_NAMESPACE_END
+
+#endif //QC_UTIL_CrcTable_h
@@ -0,0 +1,256 @@
+/*
+ * This file is part of QuickCPP.
+ * (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+ *
+ * QuickCPP is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * QuickCPP is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+ */
+ 
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// Class: XXHash64
+/**
+	@class qc::util::XXHash64
+	
+	@brief Computes the 64-bit xxHash of a sequence of bytes.
+
+	xxHash is not a cryptographic hash, but it detects accidental corruption
+	as well as a CRC while running several times faster, because it works
+	on four independent 64-bit lanes of each 32-byte stripe using only
+	multiplication, rotation and addition.  The values produced match the
+	reference XXH64 implementation for the same seed.
+
+	Bytes are assembled in little-endian order, so the hash of a given
+	sequence of bytes is the same on every platform.
+*/
+//==============================================================================
+
+#include "XXHash64.h"
+
+#include <string.h>
+
+QC_UTIL_NAMESPACE_BEGIN
+
+const unsigned long long Prime1 = 0x9E3779B185EBCA87ULL;
+const unsigned long long Prime2 = 0xC2B2AE3D27D4EB4FULL;
+const unsigned long long Prime3 = 0x165667B19E3779F9ULL;
+const unsigned long long Prime4 = 0x85EBCA77C2B2AE63ULL;
+const unsigned long long Prime5 = 0x27D4EB2F165667C5ULL;
+
+static inline unsigned long long RotateLeft(unsigned long long x, int bits)
+{
+	return (x << bits) | (x >> (64 - bits));
+}
+
+static inline unsigned long long Read64(const Byte* p)
+{
+	return  (unsigned long long)p[0]        | ((unsigned long long)p[1] << 8)  |
+	       ((unsigned long long)p[2] << 16) | ((unsigned long long)p[3] << 24) |
+	       ((unsigned long long)p[4] << 32) | ((unsigned long long)p[5] << 40) |
+	       ((unsigned long long)p[6] << 48) | ((unsigned long long)p[7] << 56);
+}
+
+static inline unsigned int Read32(const Byte* p)
+{
+	return (unsigned int)p[0] | ((unsigned int)p[1] << 8) |
+	       ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static inline unsigned long long Round(unsigned long long acc, unsigned long long input)
+{
+	acc += input * Prime2;
+	acc = RotateLeft(acc, 31);
+	return acc * Prime1;
+}
+
+static inline unsigned long long Merge(unsigned long long hash, unsigned long long acc)
+{
+	hash ^= Round(0, acc);
+	return hash * Prime1 + Prime4;
+}
+
+//==============================================================================
+// XXHash64::XXHash64
+//
+/**
+   Constructs an XXHash64 with no bytes added.
+
+   @param seed the seed of the hash; different seeds produce unrelated
+          hash values for the same data
+*/
+//==============================================================================
+XXHash64::XXHash64(unsigned long long seed) :
+	m_seed(seed)
+{
+	reset();
+}
+
+//==============================================================================
+// XXHash64::getName
+//
+/**
+   Returns "XXHash64".
+*/
+//==============================================================================
+String XXHash64::getName() const
+{
+	return QC_T("XXHash64");
+}
+
+//==============================================================================
+// XXHash64::getValue
+//
+// The buffered bytes of an incomplete stripe are digested into a copy of
+// the state, so the hash may continue to be updated afterwards.
+//==============================================================================
+unsigned long long XXHash64::getValue() const
+{
+	unsigned long long hash;
+
+	if(m_totalLen >= StripeSize)
+	{
+		hash = RotateLeft(m_acc[0], 1) + RotateLeft(m_acc[1], 7) +
+		       RotateLeft(m_acc[2], 12) + RotateLeft(m_acc[3], 18);
+		hash = Merge(hash, m_acc[0]);
+		hash = Merge(hash, m_acc[1]);
+		hash = Merge(hash, m_acc[2]);
+		hash = Merge(hash, m_acc[3]);
+	}
+	else
+	{
+		hash = m_seed + Prime5;
+	}
+
+	hash += m_totalLen;
+
+	const Byte* p = m_pending;
+	const Byte* pEnd = m_pending + m_pendingLen;
+
+	for(; p + 8 <= pEnd; p += 8)
+	{
+		hash ^= Round(0, Read64(p));
+		hash = RotateLeft(hash, 27) * Prime1 + Prime4;
+	}
+
+	if(p + 4 <= pEnd)
+	{
+		hash ^= (unsigned long long)Read32(p) * Prime1;
+		hash = RotateLeft(hash, 23) * Prime2 + Prime3;
+		p += 4;
+	}
+
+	for(; p < pEnd; ++p)
+	{
+		hash ^= (unsigned long long)*p * Prime5;
+		hash = RotateLeft(hash, 11) * Prime1;
+	}
+
+	hash ^= hash >> 33;
+	hash *= Prime2;
+	hash ^= hash >> 29;
+	hash *= Prime3;
+	hash ^= hash >> 32;
+
+	return hash;
+}
+
+//==============================================================================
+// XXHash64::reset
+//
+// Restores the initial state for the seed given to the constructor.
+//==============================================================================
+void XXHash64::reset()
+{
+	m_acc[0] = m_seed + Prime1 + Prime2;
+	m_acc[1] = m_seed + Prime2;
+	m_acc[2] = m_seed;
+	m_acc[3] = m_seed - Prime1;
+	m_totalLen = 0;
+	m_pendingLen = 0;
+}
+
+//==============================================================================
+// XXHash64::update
+//
+// Bytes are collected in m_pending until a whole stripe is available, and
+// whole stripes of the caller's data are consumed without being copied.
+//==============================================================================
+void XXHash64::update(const Byte* pData, size_t len)
+{
+	m_totalLen += len;
+
+	if(m_pendingLen)
+	{
+		const size_t toCopy = (len < size_t(StripeSize) - m_pendingLen)
+		                    ? len : size_t(StripeSize) - m_pendingLen;
+		::memcpy(m_pending + m_pendingLen, pData, toCopy);
+		m_pendingLen += toCopy;
+		pData += toCopy;
+		len -= toCopy;
+
+		if(m_pendingLen < size_t(StripeSize))
+		{
+			return;
+		}
+		consumeStripes(m_pending, 1);
+		m_pendingLen = 0;
+	}
+
+	const size_t numStripes = len / StripeSize;
+	if(numStripes)
+	{
+		consumeStripes(pData, numStripes);
+		pData += numStripes * StripeSize;
+		len -= numStripes * StripeSize;
+	}
+
+	if(len)
+	{
+		::memcpy(m_pending, pData, len);
+		m_pendingLen = len;
+	}
+}
+
+//==============================================================================
+// XXHash64::consumeStripes
+//
+// Each of the four lanes is independent of the others, so the processor
+// can overlap their multiplications.
+//==============================================================================
+void XXHash64::consumeStripes(const Byte* pData, size_t numStripes)
+{
+	unsigned long long acc0 = m_acc[0];
+	unsigned long long acc1 = m_acc[1];
+	unsigned long long acc2 = m_acc[2];
+	unsigned long long acc3 = m_acc[3];
+
+	for(; numStripes; --numStripes, pData += StripeSize)
+	{
+		acc0 = Round(acc0, Read64(pData));
+		acc1 = Round(acc1, Read64(pData + 8));
+		acc2 = Round(acc2, Read64(pData + 16));
+		acc3 = Round(acc3, Read64(pData + 24));
+	}
+
+	m_acc[0] = acc0;
+	m_acc[1] = acc1;
+	m_acc[2] = acc2;
+	m_acc[3] = acc3;
+}
+
+QC_UTIL_NAMESPACE_END
@@ -33,6 +33,12 @@
 // This class provides an efficient table-driven mechanism to determine
 // the classification of a single character.
 //
+// GetMask() classifies the character at the start of an internally-encoded
+// sequence without first constructing a Character.  When the internal
+// encoding is UTF-8, well-formed sequences are decoded directly from their
+// bytes; anything it cannot classify is reported with a length of zero,
+// leaving the caller to fall back to the Character-based functions.
+//
 //==============================================================================
 
 #ifndef QC_XML_CharTypeFacet_h
@@ -70,6 +76,7 @@ public:
 	static bool IsCharType(const Character& ch, Mask includeMask, Mask excludeMask);
 	static bool IsCharType(const String& str, Mask mask);
 	static bool IsValidName(const String& str, bool bName);
+	static Mask GetMask(const CharType* pSeq, size_t len, size_t& seqLen);
 
 	static unsigned char s_XMLTable[];
 	static const UCS4Char s_MaxChar;
@@ -162,6 +169,87 @@ inline bool CharTypeFacet::IsValidName(const String& str, bool bName)
 		&& (!bName || IsNameStartChar(Character(str.data(), str.size())) ));
 }
 
+inline CharTypeFacet::Mask CharTypeFacet::GetMask(const CharType* pSeq, size_t len, size_t& seqLen)
+{
+	QC_DBG_ASSERT(len != 0);
+	const UCharType lead = UCharType(*pSeq);
+
+	if(lead < 0x80U)
+	{
+		seqLen = 1;
+		return s_XMLTable[lead];
+	}
+
+#if defined(QC_UTF8)
+
+	const Byte* p = (const Byte*)pSeq;
+
+	if(lead >= 0xC2U && lead <= 0xDFU)
+	{
+		if(len > 1 && (p[1] & 0xC0) == 0x80)
+		{
+			seqLen = 2;
+			return s_XMLTable[((lead & 0x1F) << 6) | (p[1] & 0x3F)];
+		}
+	}
+	else if(lead >= 0xE0U && lead <= 0xEFU)
+	{
+		if(len > 2 &&
+		   (p[1] & 0xC0) == 0x80 &&
+		   (p[2] & 0xC0) == 0x80 &&
+		   (lead != 0xE0U || p[1] >= 0xA0U) &&
+		   (lead != 0xEDU || p[1] <  0xA0U))
+		{
+			seqLen = 3;
+			return s_XMLTable[((lead & 0x0F) << 12) | ((p[1] & 0x3F) << 6) | (p[2] & 0x3F)];
+		}
+	}
+	else if(lead >= 0xF0U && lead <= 0xF4U)
+	{
+		// characters above the table are valid but have no other classification
+		if(len > 3 &&
+		   (p[1] & 0xC0) == 0x80 &&
+		   (p[2] & 0xC0) == 0x80 &&
+		   (p[3] & 0xC0) == 0x80 &&
+		   (lead != 0xF0U || p[1] >= 0x90U) &&
+		   (lead != 0xF4U || p[1] <  0x90U))
+		{
+			seqLen = 4;
+			return ValidChar;
+		}
+	}
+
+#elif defined(QC_UTF16)
+
+	(void)len; // a sequence is never more than one CharType
+
+	if((lead & 0xF800) != 0xD800)
+	{
+		seqLen = 1;
+		return s_XMLTable[lead];
+	}
+
+#else
+
+	(void)len; // a sequence is never more than one CharType
+
+	if(lead < s_CharTabSize)
+	{
+		seqLen = 1;
+		return s_XMLTable[lead];
+	}
+	else if(lead <= s_MaxChar)
+	{
+		seqLen = 1;
+		return ValidChar;
+	}
+
+#endif
+
+	seqLen = 0;
+	return None;
+}
+
 QC_XML_NAMESPACE_END
 
 #endif //QC_XML_CharTypeFacet_h
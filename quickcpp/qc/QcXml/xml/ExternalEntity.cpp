@@ -188,8 +188,15 @@ void ExternalEntity::load()
 		//
 		// In order to test the first n characters of the input stream
 		// we need to wrap it in a stream that permits the mark/reset
-		// functionality - which the BufferedInputStream does
-		AutoPtr<InputStream> rpBufferedStream = new BufferedInputStream(rpInputStream.get());
+		// functionality - which the BufferedInputStream does.
+		// Streams that hold their data in memory (such as a mapped file)
+		// already support mark/reset, and are left unwrapped so that the
+		// Reader can decode directly from their storage.
+		AutoPtr<InputStream> rpBufferedStream = rpInputStream;
+		if(!rpInputStream->markSupported() || !rpInputStream->viewSupported())
+		{
+			rpBufferedStream = new BufferedInputStream(rpInputStream.get());
+		}
 
 		createReader(m_parser, extEncoding, rpBufferedStream.get());
 
@@ -354,9 +361,17 @@ void ExternalEntity::createReader(ParserImpl& parser, const String& extEncoding,
 	// Okay, we have sensed the InputStream's encoding - but now we may just disregard it
 	// if we have external encoding information.
 	//
+	// A generic "UTF-16" external encoding adds nothing to a UTF-16 BOM that
+	// has already been skipped, so the sensed name with its explicit byte
+	// order is retained.
+	//
 	if(!extEncoding.empty())
 	{
-		encoding = extEncoding;
+		if(StringUtils::CompareNoCase(extEncoding, QC_T("UTF-16")) != 0
+			|| nByteOrderMarkSize != 2)
+		{
+			encoding = extEncoding;
+		}
 	}
 
 	size_t bufSize = 1000;
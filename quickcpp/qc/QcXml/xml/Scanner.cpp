@@ -401,7 +401,23 @@ BufferRange Scanner::GetNextContigString(ScannerPosition& position,
 		const size_t charsAvailable = (pBuffer->m_used - bufferOffset);
 		if(charsAvailable)
 		{
-			nextChar = Character(pBuffer->m_pData+bufferOffset, charsAvailable);
+			//
+			// Characters that are classified straight from the buffer and
+			// accepted are consumed without constructing a Character.  The
+			// delimiter and anything else that would end the string take
+			// the general route below.
+			//
+			const CharType* pNext = pBuffer->m_pData+bufferOffset;
+			size_t seqLen;
+			const CharTypeFacet::Mask entry = CharTypeFacet::GetMask(pNext, charsAvailable, seqLen);
+			if(seqLen && *pNext != cDelim && (entry & includeMask) != 0 && (entry & excludeMask) == 0)
+			{
+				retLength+=seqLen;
+				bufferOffset+=seqLen;
+				position.m_streamPosition.incrementByChar(*pNext);
+				continue;
+			}
+			nextChar = Character(pNext, charsAvailable);
 		}
 		else
 		{
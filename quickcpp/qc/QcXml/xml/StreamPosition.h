@@ -51,6 +51,7 @@ public:
 	StreamPosition();
 
 	void incrementByChar(const Character& ch); 
+	void incrementByChar(CharType firstCh); 
 	void incrementByString(const String& str); 
 	void decrementColumns(size_t colCount); 
 
@@ -103,6 +104,24 @@ inline void StreamPosition::incrementByChar(const Character& ch)
 	}
 }
 
+//
+// Increments the position by one character given the first ::CharType of its
+// sequence, for callers that have already determined the sequence length.
+//
+inline void StreamPosition::incrementByChar(CharType firstCh)
+{
+	m_offset++;
+	if(firstCh == '\n')
+	{
+		m_lineNo++;
+		m_colNo=1;
+	}
+	else
+	{
+		m_colNo++;
+	}
+}
+
 inline void StreamPosition::incrementByString(const String& str)
 {
 	for(String::const_iterator it=str.begin(); it!=str.end(); ++it)
@@ -33,6 +33,11 @@
 
 #include "QcCore/base/debug.h"
 #include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/io/File.h"
+#include "QcCore/io/FileStatusCache.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/net/URLDecoder.h"
 #include "QcCore/util/stlutils.h"
 #include "QcXml/xml/Parser.h"
 #include "QcXml/xml/ParserFactory.h"
@@ -44,6 +49,10 @@ QC_XMLCAT_NAMESPACE_BEGIN
 
 using namespace xml;
 using namespace util;
+using io::File;
+using io::FileStatusCache;
+using io::IOException;
+using net::URLDecoder;
 
 bool sortEntries(CatalogEntry* const& p1, CatalogEntry* const& p2)
 {
@@ -263,9 +272,32 @@ bool CatalogFile::testCircularReference(const List& catList) const
 //==============================================================================
 // CatalogFile::open
 //
+// Catalogs that are listed but do not exist are common, for example when they
+// are named by an environment variable, and each attempt to parse one costs
+// a parser and a thrown exception.  The existence of a local catalog is
+// therefore tested first using the FileStatusCache, which also saves probing
+// the file again when several resolvers list the same catalog.  A missing
+// catalog is treated as empty, just as it is when the parse fails.
 //==============================================================================
 void CatalogFile::open()
 {
+	if(StringUtils::CompareNoCase(m_url.getProtocol(), QC_T("file")) == 0)
+	{
+		try
+		{
+			const File file(URLDecoder::RawDecode(m_url.getFile()));
+			if(!FileStatusCache::GetStatus(file).exists())
+			{
+				m_bOpen = true;
+				return;
+			}
+		}
+		catch(IOException& /*e*/)
+		{
+			// leave it to the parser to report
+		}
+	}
+
 	AutoPtr<Parser> rpParser = ParserFactory::CreateXMLParser();
 
 	CatalogParserHandler parserEventHandler(*this, *rpParser.get());
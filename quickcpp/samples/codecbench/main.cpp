@@ -0,0 +1,532 @@
+/*
+* This file is part of QuickCPP.
+* (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+*
+* QuickCPP is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* QuickCPP is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// QuickCPP Sample Application: codecbench
+//
+// This console application measures the throughput of the CodeConverters
+// over in-memory corpora of generated text, and the cost of looking a
+// converter up by name in the CodeConverterFactory.
+//
+// The single-byte code pages are each measured over text that is mostly
+// ASCII with a proportion of the high characters the code page defines.
+//
+// Finally the ParallelTranscoder is run with 1 to 16 threads, giving the
+// speedup over a single thread.  The chunks run on the default ThreadPool,
+// which has one thread per processor, so the speedup cannot exceed the
+// number of processors reported.
+//
+// The vectorized code paths are selected at run-time from the features of
+// the processor.  The --isa option restricts the features that are reported,
+// so running the program once for each instruction set compares the
+// portable and vector implementations over exactly the same input.
+//
+//==============================================================================
+
+#include "QcCore/base/CpuFeatures.h"
+#include "QcCore/base/NumUtils.h"
+#include "QcCore/base/ThreadPool.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/cvt/CodeConverter.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+#include "QcCore/cvt/ParallelTranscoder.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/util/DateTime.h"
+#include "QcCore/auxil/MemCheckSystemMonitor.h"
+#include "QcCore/auxil/CommandLineParser.h"
+#include "QcCore/auxil/BasicOption.h"
+
+#include <string>
+#include <vector>
+
+using namespace qc;
+using namespace qc::cvt;
+using namespace qc::io;
+using namespace qc::util;
+using namespace qc::auxil;
+
+#define COUT Console::cout()
+#define CERR Console::cerr()
+
+const size_t DefaultSizeKB = 4096;
+const size_t DefaultRepeat = 5;
+
+void showUsage(const String& programName)
+{
+	COUT << QC_T("Usage: ") << programName << QC_T(" [option]... ") << endl << endl;
+	COUT << QC_T("CodeConverter throughput benchmark.") << endl << endl;
+
+	COUT << QC_T("  -h, --help           display this help") << endl;
+	COUT << QC_T("  -i, --isa <name>     use at most: scalar, sse2 or avx2 (default: best available)") << endl;
+	COUT << QC_T("  -r, --repeat <n>     runs per measurement, the best is reported (default 5)") << endl;
+	COUT << QC_T("  -s, --size <kb>      size of each corpus in kilobytes (default 4096)") << endl;
+}
+
+//
+// A small linear congruential generator, so that every run of the program
+// converts the same text
+//
+unsigned long nextRandom(unsigned long& seed)
+{
+	seed = seed * 1103515245UL + 12345UL;
+	return (seed >> 16) & 0x7FFF;
+}
+
+//
+// Builds a UTF-8 corpus of about size bytes by choosing words at random
+// from a list and separating them with spaces, punctuation and line feeds
+//
+std::string makeCorpus(const char* const* ppWords, size_t size)
+{
+	size_t numWords = 0;
+	while(ppWords[numWords]) ++numWords;
+
+	std::string ret;
+	unsigned long seed = 12345;
+	while(ret.size() < size)
+	{
+		ret += ppWords[nextRandom(seed) % numWords];
+		const unsigned long r = nextRandom(seed) % 16;
+		ret += (r == 0) ? ".\n" : (r == 1) ? ", " : " ";
+	}
+	return ret;
+}
+
+const char* const EnglishWords[] =
+{
+	"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "request",
+	"header", "content", "length", "server", "response", "document", "element",
+	"attribute", "value", "and", "of", "to", "in", "is", "that", "for", 0
+};
+
+const char* const FrenchWords[] =
+{
+	"le", "d\xC3\xA9j\xC3\xA0", "\xC3\xA9t\xC3\xA9", "fran\xC3\xA7" "ais", "tr\xC3\xA8s",
+	"o\xC3\xB9", "na\xC3\xAF" "ve", "ma\xC3\xAEtre", "c\xC5\x93ur", "et", "la", "de",
+	"r\xC3\xA9ponse", "serveur", "\xC3\xA9l\xC3\xA9ment", "valeur", "que", "pour", 0
+};
+
+const char* const CJKWords[] =
+{
+	"\xE4\xB8\xAD\xE6\x96\x87", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E",
+	"\xED\x95\x9C\xEA\xB5\xAD\xEC\x96\xB4", "\xE6\x96\x87\xE6\xA1\xA3",
+	"\xE6\x9C\x8D\xE5\x8A\xA1\xE5\x99\xA8", "\xE5\x93\x8D\xE5\xBA\x94",
+	"\xE5\x85\x83\xE7\xB4\xA0", "\xE5\xB1\x9E\xE6\x80\xA7", 0
+};
+
+const char* const MixedWords[] =
+{
+	"data", "\xD0\xB4\xD0\xB0\xD0\xBD\xD0\xBD\xD1\x8B\xD0\xB5", "\xCE\xB4\xCE\xB5\xCE\xB4\xCE\xBF\xCE\xBC\xCE\xAD\xCE\xBD\xCE\xB1",
+	"\xE6\x95\xB0\xE6\x8D\xAE", "\xF0\x9F\x98\x80", "\xF0\x9D\x90\x80\xF0\x9D\x90\x81", "value", "\xC3\xBC" "ber", 0
+};
+
+struct Corpus
+{
+	const CharType* name;
+	const char* const* ppWords;
+};
+
+const Corpus Corpora[] =
+{
+	{QC_T("ascii  "), EnglishWords},
+	{QC_T("latin  "), FrenchWords},
+	{QC_T("cjk    "), CJKWords},
+	{QC_T("mixed  "), MixedWords},
+	{0, 0}
+};
+
+//
+// Decodes the whole of input into chars, returning the elapsed time
+//
+double timeDecode(CodeConverter* pDecoder, const std::string& input, std::vector<CharType>& chars)
+{
+	chars.resize(input.size() + 1);
+	const Byte* pFrom = (const Byte*)input.data();
+	const Byte* pEnd = pFrom + input.size();
+	CharType* pTo = &chars[0];
+
+	const double start = DateTime::currentTimeMillis();
+	while(pFrom < pEnd)
+	{
+		const Byte* pFromNext;
+		CharType* pToNext;
+		pDecoder->decode(pFrom, pEnd, pFromNext, pTo, &chars[0] + chars.size(), pToNext);
+		if(pFromNext == pFrom) break;
+		pFrom = pFromNext;
+		pTo = pToNext;
+	}
+	const double elapsed = DateTime::currentTimeMillis() - start;
+
+	chars.resize(pTo - &chars[0]);
+	return elapsed;
+}
+
+//
+// Returns the throughput in MB/s of the best of repeat runs of a
+// measurement
+//
+//
+// Encodes the whole of input into bytes, returning the elapsed time
+//
+double timeEncode(CodeConverter* pEncoder, const std::vector<CharType>& input, std::vector<Byte>& bytes)
+{
+	bytes.resize(input.size() * pEncoder->getMaxEncodedLength() + 1);
+	const CharType* pFrom = &input[0];
+	const CharType* pEnd = pFrom + input.size();
+	Byte* pTo = &bytes[0];
+
+	const double start = DateTime::currentTimeMillis();
+	while(pFrom < pEnd)
+	{
+		const CharType* pFromNext;
+		Byte* pToNext;
+		pEncoder->encode(pFrom, pEnd, pFromNext, pTo, &bytes[0] + bytes.size(), pToNext);
+		if(pFromNext == pFrom) break;
+		pFrom = pFromNext;
+		pTo = pToNext;
+	}
+	const double elapsed = DateTime::currentTimeMillis() - start;
+
+	bytes.resize(pTo - &bytes[0]);
+	return elapsed;
+}
+
+String throughput(size_t bytes, double bestMS)
+{
+	if(bestMS <= 0) bestMS = 0.001;
+	return NumUtils::ToString((unsigned long)((bytes / 1048576.0) / (bestMS / 1000))) + QC_T(" MB/s");
+}
+
+//
+// Tests if a byte survives being decoded and encoded again, which is the
+// case for every byte that the code page defines
+//
+bool roundTrips(CodeConverter* pConverter, Byte b)
+{
+	const std::string input(1, (char)b);
+	std::vector<CharType> chars;
+	std::vector<Byte> bytes;
+	timeDecode(pConverter, input, chars);
+	timeEncode(pConverter, chars, bytes);
+	return (bytes.size() == 1 && bytes[0] == b);
+}
+
+//
+// Builds a corpus of about size bytes in which one character in eight is
+// taken at random from the high bytes that the code page defines
+//
+std::string makeCodePageCorpus(CodeConverter* pConverter, size_t size)
+{
+	std::string highBytes;
+	for(int b=0x80; b<0x100; ++b)
+	{
+		if(roundTrips(pConverter, (Byte)b))
+		{
+			highBytes += (char)b;
+		}
+	}
+
+	std::string ret = makeCorpus(EnglishWords, size);
+	unsigned long seed = 54321;
+	for(size_t i=0; i<ret.size() && !highBytes.empty(); ++i)
+	{
+		if(nextRandom(seed) % 8 == 0 && ret[i] != ' ' && ret[i] != '\n')
+		{
+			ret[i] = highBytes[nextRandom(seed) % highBytes.size()];
+		}
+	}
+	return ret;
+}
+
+//
+// Formats baseMS/ms with two decimal places
+//
+String ratio(double baseMS, double ms)
+{
+	if(ms <= 0) ms = 0.001;
+	const unsigned long hundredths = (unsigned long)(baseMS * 100 / ms + 0.5);
+	const unsigned long fraction = hundredths % 100;
+	return NumUtils::ToString(hundredths / 100) + (fraction < 10 ? QC_T(".0") : QC_T("."))
+	       + NumUtils::ToString(fraction) + QC_T("x");
+}
+
+void benchUTF8Decode(size_t size, size_t repeat)
+{
+	AutoPtr<CodeConverter> rpDecoder = CodeConverterFactory::GetInstance().getConverter(QC_T("UTF-8"));
+	std::vector<CharType> chars;
+
+	for(size_t i=0; Corpora[i].name; ++i)
+	{
+		const std::string input = makeCorpus(Corpora[i].ppWords, size);
+		double best = 0;
+		for(size_t j=0; j<repeat; ++j)
+		{
+			const double ms = timeDecode(rpDecoder.get(), input, chars);
+			if(j == 0 || ms < best) best = ms;
+		}
+		COUT << QC_T("UTF-8 decode ") << Corpora[i].name << QC_T(": ") << throughput(input.size(), best) << endl;
+	}
+}
+
+//
+// Encodes each corpus back to UTF-8.  The throughput is given in terms of
+// the UTF-8 bytes produced so that it can be compared with decoding.
+//
+void benchUTF8Encode(size_t size, size_t repeat)
+{
+	AutoPtr<CodeConverter> rpConverter = CodeConverterFactory::GetInstance().getConverter(QC_T("UTF-8"));
+	std::vector<CharType> chars;
+	std::vector<Byte> bytes;
+
+	for(size_t i=0; Corpora[i].name; ++i)
+	{
+		const std::string input = makeCorpus(Corpora[i].ppWords, size);
+		timeDecode(rpConverter.get(), input, chars);
+		double best = 0;
+		for(size_t j=0; j<repeat; ++j)
+		{
+			const double ms = timeEncode(rpConverter.get(), chars, bytes);
+			if(j == 0 || ms < best) best = ms;
+		}
+		COUT << QC_T("UTF-8 encode ") << Corpora[i].name << QC_T(": ") << throughput(bytes.size(), best) << endl;
+	}
+}
+
+//
+// Decodes and encodes a corpus through each single-byte code page
+//
+void benchCodePages(size_t size, size_t repeat)
+{
+	static const CharType* const CodePages[] =
+	{
+		QC_T("ISO-8859-1"),
+		QC_T("windows-1250"), QC_T("windows-1251"), QC_T("windows-1252"),
+		QC_T("windows-1253"), QC_T("windows-1254"), QC_T("windows-1255"),
+		QC_T("windows-1256"), QC_T("windows-1257"), QC_T("windows-1258"),
+		QC_T("ISO-8859-2"),   QC_T("ISO-8859-3"),   QC_T("ISO-8859-4"),
+		QC_T("ISO-8859-5"),   QC_T("ISO-8859-6"),   QC_T("ISO-8859-7"),
+		QC_T("ISO-8859-8"),   QC_T("ISO-8859-9"),   QC_T("ISO-8859-10"),
+		QC_T("ISO-8859-13"),  QC_T("ISO-8859-14"),  QC_T("ISO-8859-15"),
+		QC_T("ISO-8859-16"),  QC_T("IBM850"),       0
+	};
+
+	std::vector<CharType> chars;
+	std::vector<Byte> bytes;
+
+	for(size_t i=0; CodePages[i]; ++i)
+	{
+		AutoPtr<CodeConverter> rpConverter = CodeConverterFactory::GetInstance().getConverter(CodePages[i]);
+		const std::string input = makeCodePageCorpus(rpConverter.get(), size);
+		double bestDecode = 0;
+		double bestEncode = 0;
+		for(size_t j=0; j<repeat; ++j)
+		{
+			const double decodeMS = timeDecode(rpConverter.get(), input, chars);
+			const double encodeMS = timeEncode(rpConverter.get(), chars, bytes);
+			if(j == 0 || decodeMS < bestDecode) bestDecode = decodeMS;
+			if(j == 0 || encodeMS < bestEncode) bestEncode = encodeMS;
+		}
+
+		String name = CodePages[i];
+		name.resize(13, ' ');
+		COUT << name << QC_T("decode: ") << throughput(input.size(), bestDecode)
+		     << QC_T(", encode: ") << throughput(bytes.size(), bestEncode) << endl;
+	}
+}
+
+//
+// Transcodes a corpus with an increasing number of threads
+//
+void benchParallel(const CharType* fromEncoding, const CharType* toEncoding,
+                   const std::string& input, size_t repeat)
+{
+	CodeConverterFactory& factory = CodeConverterFactory::GetInstance();
+	ParallelTranscoder transcoder(factory.getConverter(fromEncoding).get(),
+	                              factory.getConverter(toEncoding).get());
+
+	const Byte* pFrom = (const Byte*)input.data();
+	double serial = 0;
+	for(size_t numThreads=1; numThreads<=16; numThreads*=2)
+	{
+		transcoder.setThreadCount(numThreads);
+		double best = 0;
+		for(size_t j=0; j<repeat; ++j)
+		{
+			size_t resultLen;
+			const double start = DateTime::currentTimeMillis();
+			transcoder.transcode(pFrom, pFrom + input.size(), resultLen);
+			const double ms = DateTime::currentTimeMillis() - start;
+			if(j == 0 || ms < best) best = ms;
+		}
+		if(numThreads == 1)
+		{
+			serial = best;
+		}
+
+		COUT << fromEncoding << QC_T(" -> ") << toEncoding << QC_T(", ")
+		     << NumUtils::ToString((unsigned long)numThreads) << QC_T(" threads: ")
+		     << throughput(input.size(), best) << QC_T(", speedup ")
+		     << ratio(serial, best) << endl;
+	}
+}
+
+//
+// Times CodeConverterFactory::getConverter() for canonical encoding names
+// and for aliases that have to be normalized before they are found
+//
+void benchLookup(size_t repeat)
+{
+	static const CharType* const Canonical[] =
+	{
+		QC_T("UTF-8"), QC_T("ISO-8859-1"), QC_T("windows-1252"), QC_T("UTF-16LE"), 0
+	};
+	static const CharType* const Aliases[] =
+	{
+		QC_T("utf8"), QC_T("latin1"), QC_T("CP1252"), QC_T("csISOLatin2"), 0
+	};
+	static const CharType* const* const Sets[] = {Canonical, Aliases};
+	static const CharType* const SetNames[] = {QC_T("canonical"), QC_T("aliases  ")};
+
+	const size_t Lookups = 100000;
+	CodeConverterFactory& factory = CodeConverterFactory::GetInstance();
+
+	for(size_t s=0; s<2; ++s)
+	{
+		size_t numNames = 0;
+		while(Sets[s][numNames]) ++numNames;
+
+		const std::vector<String> names(Sets[s], Sets[s] + numNames);
+		double best = 0;
+		for(size_t j=0; j<repeat; ++j)
+		{
+			const double start = DateTime::currentTimeMillis();
+			for(size_t k=0; k<Lookups; ++k)
+			{
+				factory.getConverter(names[k % numNames]);
+			}
+			const double ms = DateTime::currentTimeMillis() - start;
+			if(j == 0 || ms < best) best = ms;
+		}
+		COUT << QC_T("getConverter ") << SetNames[s] << QC_T(": ")
+		     << NumUtils::ToString((unsigned long)(best * 1000000 / Lookups)) << QC_T(" ns/call") << endl;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	MemCheckSystemMonitor monitor;
+
+	BasicOption optHelp(QC_T("help"), 'h', BasicOption::none);
+	BasicOption optIsa(QC_T("isa"), 'i', BasicOption::mandatory);
+	BasicOption optRepeat(QC_T("repeat"), 'r', BasicOption::mandatory);
+	BasicOption optSize(QC_T("size"), 's', BasicOption::mandatory);
+
+	CommandLineParser cmdlineParser;
+	cmdlineParser.addOption(&optHelp);
+	cmdlineParser.addOption(&optIsa);
+	cmdlineParser.addOption(&optRepeat);
+	cmdlineParser.addOption(&optSize);
+
+	try
+	{
+		cmdlineParser.parse(argc, argv);
+	}
+	catch (CommandLineException& e)
+	{
+		CERR << cmdlineParser.getProgramName() << QC_T(": ") << e.getMessage() << endl << endl;
+		CERR << QC_T("Try ") << cmdlineParser.getProgramName() << QC_T(" --help") << endl;
+		return (1);
+	}
+
+	if(optHelp.isPresent())
+	{
+		showUsage(cmdlineParser.getProgramName());
+		return (0);
+	}
+
+	//
+	// The instruction set must be restricted before any converter selects
+	// its implementation
+	//
+	if(optIsa.isPresent())
+	{
+		const String isa = optIsa.getArgument();
+		if(isa == QC_T("scalar"))
+		{
+			CpuFeatures::Disable(CpuFeatures::SSE2 | CpuFeatures::SSE41 | CpuFeatures::SSE42 |
+			                     CpuFeatures::PCLMUL | CpuFeatures::AVX2);
+		}
+		else if(isa == QC_T("sse2"))
+		{
+			CpuFeatures::Disable(CpuFeatures::AVX2);
+		}
+		else if(isa != QC_T("avx2"))
+		{
+			CERR << cmdlineParser.getProgramName() << QC_T(": unknown instruction set: ") << isa << endl;
+			return (1);
+		}
+	}
+
+	size_t size = DefaultSizeKB * 1024;
+	if(optSize.isPresent())
+	{
+		size = NumUtils::ToInt(optSize.getArgument()) * 1024;
+	}
+
+	size_t repeat = DefaultRepeat;
+	if(optRepeat.isPresent())
+	{
+		repeat = NumUtils::ToInt(optRepeat.getArgument());
+	}
+	if(repeat == 0)
+	{
+		repeat = 1;
+	}
+
+	COUT << QC_T("Instruction set: ")
+	     << (CpuFeatures::HasAVX2() ? QC_T("avx2") : CpuFeatures::HasSSE2() ? QC_T("sse2") : QC_T("scalar"))
+	     << QC_T(", corpus size: ") << NumUtils::ToString((unsigned long)size) << QC_T(" bytes") << endl;
+
+	try
+	{
+		benchUTF8Decode(size, repeat);
+		benchUTF8Encode(size, repeat);
+		benchCodePages(size, repeat);
+
+		COUT << QC_T("Processors: ") << NumUtils::ToString((unsigned long)ThreadPool::GetProcessorCount()) << endl;
+		benchParallel(QC_T("UTF-8"), QC_T("UTF-16LE"), makeCorpus(MixedWords, size * 4), repeat);
+		{
+			AutoPtr<CodeConverter> rpConverter = CodeConverterFactory::GetInstance().getConverter(QC_T("windows-1252"));
+			benchParallel(QC_T("windows-1252"), QC_T("UTF-8"), makeCodePageCorpus(rpConverter.get(), size * 4), repeat);
+		}
+		benchLookup(repeat);
+	}
+	catch(Exception& e)
+	{
+		CERR << e.toString() << endl;
+		return (1);
+	}
+
+	return (0);
+}
@@ -0,0 +1,360 @@
+/*
+* This file is part of QuickCPP.
+* (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+*
+* QuickCPP is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* QuickCPP is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// QuickCPP Sample Application: modebench
+//
+// This console application compares the internal character encodings that
+// QuickCPP can be built with.  Build it once against a library compiled
+// with wchar_t characters (QC_UNICODE) and once against a library compiled
+// with QC_UTF8, then compare the output of the two programs.
+//
+// Two workloads are timed:
+//   - an in-memory UTF-8 XML document parsed with the SAX XMLReader
+//   - a series of HTTP responses: the headers are parsed with
+//     MimeHeaderParser, the body is decoded by an InputStreamReader and
+//     the links found in the headers are parsed and URL-decoded
+//
+// For each workload the program also reports the memory taken by the
+// characters it produced: the number of CharType units times
+// sizeof(CharType).
+//
+//==============================================================================
+
+#include "QcCore/base/NumUtils.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/io/InputStreamReader.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/net/MimeHeaderParser.h"
+#include "QcCore/net/MimeHeaderSequence.h"
+#include "QcCore/net/URL.h"
+#include "QcCore/net/URLDecoder.h"
+#include "QcCore/util/DateTime.h"
+#include "QcCore/auxil/MemCheckSystemMonitor.h"
+#include "QcCore/auxil/CommandLineParser.h"
+#include "QcCore/auxil/BasicOption.h"
+#include "QcXml/sax/XMLReaderFactory.h"
+#include "QcXml/sax/XMLReader.h"
+#include "QcXml/sax/InputSource.h"
+#include "QcXml/sax/DefaultHandler.h"
+
+#include <string>
+#include <stdio.h>
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::net;
+using namespace qc::util;
+using namespace qc::auxil;
+using namespace qc::sax;
+
+#define COUT Console::cout()
+#define CERR Console::cerr()
+
+const size_t DefaultSizeKB = 4096;
+const size_t DefaultRepeat = 5;
+
+void showUsage(const String& programName)
+{
+	COUT << QC_T("Usage: ") << programName << QC_T(" [option]... ") << endl << endl;
+	COUT << QC_T("Internal character encoding benchmark.") << endl << endl;
+
+	COUT << QC_T("  -h, --help           display this help") << endl;
+	COUT << QC_T("  -r, --repeat <n>     runs per measurement, the best is reported (default 5)") << endl;
+	COUT << QC_T("  -s, --size <kb>      size of each workload in kilobytes (default 4096)") << endl;
+}
+
+//
+// Counts the characters reported by the parser, so that the memory they
+// occupy in the internal encoding can be given
+//
+class CountingHandler : public DefaultHandler
+{
+public:
+	CountingHandler() : m_elements(0), m_chars(0) {}
+
+	virtual void characters(const CharType* /*pStart*/, size_t length)
+	{
+		m_chars += length;
+	}
+
+	virtual void startElement(const String& /*namespaceURI*/,
+	                          const String& localName,
+	                          const String& /*qName*/,
+	                          const Attributes& /*atts*/)
+	{
+		++m_elements;
+		m_chars += localName.size();
+	}
+
+	size_t m_elements;
+	size_t m_chars;
+};
+
+//
+// Text in several scripts for the XML content and the HTTP bodies
+//
+const char* const Words[] =
+{
+	"the", "quick", "brown", "fox", "request", "header", "content", "server",
+	"d\xC3\xA9j\xC3\xA0", "fran\xC3\xA7" "ais", "\xC3\xBC" "ber",
+	"\xD0\xB4\xD0\xB0\xD0\xBD\xD0\xBD\xD1\x8B\xD0\xB5", "\xCE\xB4\xCE\xB5\xCE\xB4\xCE\xBF\xCE\xBC\xCE\xAD\xCE\xBD\xCE\xB1",
+	"\xE4\xB8\xAD\xE6\x96\x87", "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E", 0
+};
+
+//
+// Appends about len bytes of words chosen by a linear congruential
+// generator, so that every run of the program processes the same text
+//
+void appendText(std::string& str, size_t len, unsigned long& seed)
+{
+	size_t numWords = 0;
+	while(Words[numWords]) ++numWords;
+
+	const size_t end = str.size() + len;
+	while(str.size() < end)
+	{
+		seed = seed * 1103515245UL + 12345UL;
+		str += Words[(seed >> 16) % numWords];
+		str += ' ';
+	}
+}
+
+std::string toDecimal(size_t x)
+{
+	char buffer[32];
+	sprintf(buffer, "%lu", (unsigned long)x);
+	return buffer;
+}
+
+std::string makeXMLDocument(size_t size)
+{
+	std::string ret = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<catalog>\n";
+	unsigned long seed = 12345;
+	for(size_t i=0; ret.size() < size; ++i)
+	{
+		ret += "  <item id=\"" + toDecimal(i) + "\" lang=\"mul\">\n    <title>";
+		appendText(ret, 40, seed);
+		ret += "</title>\n    <description>";
+		appendText(ret, 200, seed);
+		ret += "</description>\n  </item>\n";
+	}
+	ret += "</catalog>\n";
+	return ret;
+}
+
+//
+// Builds a series of HTTP responses, each with a UTF-8 body of about 2KB
+//
+std::string makeHttpResponses(size_t size, size_t& numResponses)
+{
+	std::string ret;
+	unsigned long seed = 54321;
+	for(numResponses=0; ret.size() < size; ++numResponses)
+	{
+		std::string body;
+		appendText(body, 2048, seed);
+
+		const std::string id = toDecimal(numResponses);
+		ret += "HTTP/1.1 200 OK\r\n"
+		       "Date: Sun, 18 Oct 2026 12:00:00 GMT\r\n"
+		       "Server: QuickCPP\r\n"
+		       "Content-Type: text/plain; charset=UTF-8\r\n"
+		       "Content-Location: http://www.example.com/docs/caf%C3%A9/page" + id + ".txt?lang=fr&id=" + id + "#top\r\n"
+		       "Link: http://www.example.com/docs/%E4%B8%AD%E6%96%87/next" + id + ".txt\r\n"
+		       "Cache-Control: max-age=3600\r\n"
+		       "Content-Length: " + toDecimal(body.size()) + "\r\n"
+		       "\r\n";
+		ret += body;
+	}
+	return ret;
+}
+
+//
+// Parses the XML document, returning the elapsed time
+//
+double timeXML(const std::string& doc, CountingHandler* pHandler)
+{
+	const double start = DateTime::currentTimeMillis();
+
+	AutoPtr<XMLReader> rpReader = XMLReaderFactory::CreateXMLReader();
+	rpReader->setContentHandler(pHandler);
+	AutoPtr<InputStream> rpStream = new ByteArrayInputStream((const Byte*)doc.data(), doc.size());
+	AutoPtr<InputSource> rpSource = new InputSource(rpStream.get());
+	rpReader->parse(rpSource.get());
+
+	return DateTime::currentTimeMillis() - start;
+}
+
+//
+// Processes each HTTP response, returning the elapsed time.  bodyChars
+// receives the number of characters decoded from the bodies.
+//
+double timeHttp(const std::string& responses, size_t numResponses, size_t& bodyChars)
+{
+	const double start = DateTime::currentTimeMillis();
+
+	AutoPtr<ByteArrayInputStream> rpStream =
+		new ByteArrayInputStream((const Byte*)responses.data(), responses.size());
+
+	bodyChars = 0;
+	for(size_t i=0; i<numResponses; ++i)
+	{
+		String statusLine;
+		MimeHeaderParser::ReadLineLatin1(rpStream.get(), statusLine);
+		AutoPtr<MimeHeaderSequence> rpHeaders = MimeHeaderParser::ParseHeaders(rpStream.get());
+
+		URL location(rpHeaders->getHeader(QC_T("Content-Location")));
+		URL link(rpHeaders->getHeader(QC_T("Link")));
+		const String path = URLDecoder::Decode(location.getPath()) + URLDecoder::Decode(link.getPath());
+		bodyChars += path.size();
+
+		//
+		// Decode exactly Content-Length bytes of body
+		//
+		const size_t bodyLen = NumUtils::ToInt(rpHeaders->getHeader(QC_T("Content-Length")));
+		AutoPtr<ByteArrayInputStream> rpBody =
+			new ByteArrayInputStream((const Byte*)responses.data() + (responses.size() - rpStream->available()), bodyLen);
+		rpStream->skip(bodyLen);
+
+		AutoPtr<InputStreamReader> rpReader = new InputStreamReader(rpBody.get(), QC_T("UTF-8"));
+		String body;
+		CharType buffer[4096];
+		long count;
+		while((count = rpReader->read(buffer, sizeof(buffer)/sizeof(CharType))) != Reader::EndOfFile)
+		{
+			body.append(buffer, count);
+		}
+		bodyChars += body.size();
+	}
+
+	return DateTime::currentTimeMillis() - start;
+}
+
+//
+// Formats a number of bytes as kilobytes
+//
+String kilobytes(size_t bytes)
+{
+	return NumUtils::ToString((unsigned long)(bytes / 1024)) + QC_T(" KB");
+}
+
+int main(int argc, char* argv[])
+{
+	MemCheckSystemMonitor monitor;
+
+	BasicOption optHelp(QC_T("help"), 'h', BasicOption::none);
+	BasicOption optRepeat(QC_T("repeat"), 'r', BasicOption::mandatory);
+	BasicOption optSize(QC_T("size"), 's', BasicOption::mandatory);
+
+	CommandLineParser cmdlineParser;
+	cmdlineParser.addOption(&optHelp);
+	cmdlineParser.addOption(&optRepeat);
+	cmdlineParser.addOption(&optSize);
+
+	try
+	{
+		cmdlineParser.parse(argc, argv);
+	}
+	catch (CommandLineException& e)
+	{
+		CERR << cmdlineParser.getProgramName() << QC_T(": ") << e.getMessage() << endl << endl;
+		CERR << QC_T("Try ") << cmdlineParser.getProgramName() << QC_T(" --help") << endl;
+		return (1);
+	}
+
+	if(optHelp.isPresent())
+	{
+		showUsage(cmdlineParser.getProgramName());
+		return (0);
+	}
+
+	size_t size = DefaultSizeKB * 1024;
+	if(optSize.isPresent())
+	{
+		size = NumUtils::ToInt(optSize.getArgument()) * 1024;
+	}
+
+	size_t repeat = DefaultRepeat;
+	if(optRepeat.isPresent())
+	{
+		repeat = NumUtils::ToInt(optRepeat.getArgument());
+	}
+	if(repeat == 0)
+	{
+		repeat = 1;
+	}
+
+#if defined(QC_UTF8)
+	const CharType* mode = QC_T("UTF-8");
+#elif defined(QC_UCS2)
+	const CharType* mode = QC_T("UTF-16");
+#else
+	const CharType* mode = QC_T("UCS-4");
+#endif
+
+	COUT << QC_T("Internal encoding: ") << mode << QC_T(", sizeof(CharType): ")
+	     << NumUtils::ToString((unsigned long)sizeof(CharType)) << endl;
+
+	try
+	{
+		const std::string doc = makeXMLDocument(size);
+		double best = 0;
+		size_t elements = 0;
+		size_t chars = 0;
+		for(size_t i=0; i<repeat; ++i)
+		{
+			AutoPtr<CountingHandler> rpHandler = new CountingHandler;
+			const double ms = timeXML(doc, rpHandler.get());
+			if(i == 0 || ms < best) best = ms;
+			elements = rpHandler->m_elements;
+			chars = rpHandler->m_chars;
+		}
+		COUT << QC_T("XML parse: ") << NumUtils::ToString((long)best) << QC_T(" ms, ")
+		     << kilobytes(doc.size()) << QC_T(" document, ")
+		     << NumUtils::ToString((unsigned long)elements) << QC_T(" elements, characters: ")
+		     << kilobytes(chars * sizeof(CharType)) << endl;
+
+		size_t numResponses;
+		const std::string responses = makeHttpResponses(size / 4, numResponses);
+		size_t bodyChars = 0;
+		best = 0;
+		for(size_t i=0; i<repeat; ++i)
+		{
+			const double ms = timeHttp(responses, numResponses, bodyChars);
+			if(i == 0 || ms < best) best = ms;
+		}
+		COUT << QC_T("HTTP: ") << NumUtils::ToString((long)best) << QC_T(" ms, ")
+		     << NumUtils::ToString((unsigned long)numResponses) << QC_T(" responses, characters: ")
+		     << kilobytes(bodyChars * sizeof(CharType)) << endl;
+	}
+	catch(Exception& e)
+	{
+		CERR << e.toString() << endl;
+		return (1);
+	}
+
+	return (0);
+}
@@ -0,0 +1,374 @@
+/*
+* This file is part of QuickCPP.
+* (c) Copyright 2011 Jie Wang(twj31470952@gmail.com)
+*
+* QuickCPP is free software: you can redistribute it and/or modify
+* it under the terms of the GNU Lesser General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* QuickCPP is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU Lesser General Public License for more details.
+*
+* You should have received a copy of the GNU Lesser General Public License
+* along with QuickCPP.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+//==============================================================================
+//
+// $Revision$
+// $Date$
+//
+//==============================================================================
+//
+// QuickCPP Sample Application: readerbench
+//
+// This console application measures the cost of the per-call lock taken by
+// Readers and Writers.  It decodes and encodes an in-memory UTF-8 document
+// through a BufferedReader and a PrintWriter, first in the default
+// synchronized mode and then after setSynchronized(false), and reports the
+// throughput of each.
+//
+// Three workloads are timed:
+//   - BufferedReader::read(), one character per call
+//   - BufferedReader::readLine() over every line
+//   - PrintWriter::write(CharType), one character per call
+//
+// It then compares the ways of reading the document a line at a time, in
+// the default synchronized mode.  The first of them calls read() for each
+// character until a line feed is seen, which is how readLine() used to
+// work, and the others are timed relative to it:
+//   - BufferedReader::readLine(String&)
+//   - BufferedReader::readLine(StringView&)
+//   - LineIterator::next()
+//
+//==============================================================================
+
+#include "QcCore/base/NumUtils.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/io/BufferedReader.h"
+#include "QcCore/io/BufferedWriter.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/io/InputStreamReader.h"
+#include "QcCore/io/LineIterator.h"
+#include "QcCore/io/OutputStreamWriter.h"
+#include "QcCore/io/PrintWriter.h"
+#include "QcCore/util/DateTime.h"
+#include "QcCore/auxil/MemCheckSystemMonitor.h"
+#include "QcCore/auxil/CommandLineParser.h"
+#include "QcCore/auxil/BasicOption.h"
+
+#include <string>
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+using namespace qc::auxil;
+
+#define COUT Console::cout()
+#define CERR Console::cerr()
+
+const size_t DefaultLines = 300000;
+const size_t DefaultRepeat = 3;
+
+void showUsage(const String& programName)
+{
+	COUT << QC_T("Usage: ") << programName << QC_T(" [option]... ") << endl << endl;
+	COUT << QC_T("Reader/Writer throughput benchmark.") << endl << endl;
+
+	COUT << QC_T("  -h, --help           display this help") << endl;
+	COUT << QC_T("  -l, --lines <n>      number of lines in the document (default 300000)") << endl;
+	COUT << QC_T("  -r, --repeat <n>     runs per measurement, the best is reported (default 3)") << endl;
+}
+
+//
+// Builds a UTF-8 document of the requested number of lines.  Line lengths
+// vary between 4 and 64 characters and roughly one line in eight contains
+// a non-ASCII character, so the decoder sees a realistic mixture.
+//
+std::string makeDocument(size_t lines, size_t& charCount)
+{
+	std::string doc;
+	unsigned long seed = 12345;
+	charCount = 0;
+
+	for(size_t i=0; i<lines; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		const size_t len = 4 + ((seed >> 16) % 61);
+		for(size_t j=0; j<len; ++j)
+		{
+			doc += (char)('a' + (i + j) % 26);
+		}
+		charCount += len;
+		if(((seed >> 8) & 7) == 0)
+		{
+			doc += "\xC3\xA9"; // U+00E9
+			++charCount;
+		}
+		doc += '\n';
+		++charCount;
+	}
+	return doc;
+}
+
+AutoPtr<BufferedReader> makeReader(const std::string& doc, bool bSynchronized)
+{
+	AutoPtr<InputStream> rpIn = new ByteArrayInputStream((const Byte*)doc.data(), doc.size());
+	AutoPtr<Reader> rpDecoder = new InputStreamReader(rpIn.get(), QC_T("UTF-8"));
+	AutoPtr<BufferedReader> rpReader = new BufferedReader(rpDecoder.get());
+	rpReader->setSynchronized(bSynchronized);
+	return rpReader;
+}
+
+double timeRead(const std::string& doc, bool bSynchronized, size_t& count)
+{
+	AutoPtr<BufferedReader> rpReader = makeReader(doc, bSynchronized);
+	count = 0;
+
+	const double start = DateTime::currentTimeMillis();
+	while(rpReader->read() != Reader::EndOfFile)
+	{
+		++count;
+	}
+	return DateTime::currentTimeMillis() - start;
+}
+
+double timeReadLine(const std::string& doc, bool bSynchronized, size_t& count)
+{
+	AutoPtr<BufferedReader> rpReader = makeReader(doc, bSynchronized);
+	String line;
+	count = 0;
+
+	const double start = DateTime::currentTimeMillis();
+	while(rpReader->readLine(line) != Reader::EndOfFile)
+	{
+		++count;
+	}
+	return DateTime::currentTimeMillis() - start;
+}
+
+double timeReadLineByChar(const std::string& doc, bool bSynchronized, size_t& count)
+{
+	AutoPtr<BufferedReader> rpReader = makeReader(doc, bSynchronized);
+	String line;
+	count = 0;
+
+	const double start = DateTime::currentTimeMillis();
+	for(;;)
+	{
+		line.erase();
+		int ch;
+		while((ch = rpReader->read()) != Reader::EndOfFile && ch != '\n')
+		{
+			line += CharType(ch);
+		}
+		if(ch == Reader::EndOfFile && line.empty())
+		{
+			break;
+		}
+		++count;
+	}
+	return DateTime::currentTimeMillis() - start;
+}
+
+double timeReadLineView(const std::string& doc, bool bSynchronized, size_t& count)
+{
+	AutoPtr<BufferedReader> rpReader = makeReader(doc, bSynchronized);
+	StringView line;
+	count = 0;
+
+	const double start = DateTime::currentTimeMillis();
+	while(rpReader->readLine(line) != Reader::EndOfFile)
+	{
+		++count;
+	}
+	return DateTime::currentTimeMillis() - start;
+}
+
+double timeLineIterator(const std::string& doc, bool bSynchronized, size_t& count)
+{
+	AutoPtr<BufferedReader> rpReader = makeReader(doc, bSynchronized);
+	LineIterator iter(rpReader.get());
+	count = 0;
+
+	const double start = DateTime::currentTimeMillis();
+	while(iter.next())
+	{
+		++count;
+	}
+	return DateTime::currentTimeMillis() - start;
+}
+
+double timeWrite(const String& text, bool bSynchronized, size_t& count)
+{
+	AutoPtr<ByteArrayOutputStream> rpOut = new ByteArrayOutputStream;
+	AutoPtr<Writer> rpEncoder = new OutputStreamWriter(rpOut.get(), QC_T("UTF-8"));
+	AutoPtr<Writer> rpBuffered = new BufferedWriter(rpEncoder.get());
+	AutoPtr<PrintWriter> rpWriter = new PrintWriter(rpBuffered.get());
+	rpWriter->setSynchronized(bSynchronized);
+
+	const double start = DateTime::currentTimeMillis();
+	const size_t len = text.size();
+	for(size_t i=0; i<len; ++i)
+	{
+		rpWriter->write(text[i]);
+	}
+	rpWriter->flush();
+	const double elapsed = DateTime::currentTimeMillis() - start;
+
+	count = rpOut->size();
+	return elapsed;
+}
+
+//
+// Runs one workload in both modes, keeping the best time of each, and prints
+// a line of results.
+//
+template<typename Input>
+void measure(const String& name, double (*pFn)(const Input&, bool, size_t&),
+             const Input& input, size_t repeat)
+{
+	double best[2] = {0, 0};
+	size_t count = 0;
+
+	for(int mode=0; mode<2; ++mode)
+	{
+		for(size_t i=0; i<repeat; ++i)
+		{
+			const double ms = (*pFn)(input, mode == 0, count);
+			if(i == 0 || ms < best[mode])
+			{
+				best[mode] = ms;
+			}
+		}
+	}
+
+	COUT << name << QC_T(": synchronized ") << NumUtils::ToString((long)best[0])
+	     << QC_T(" ms, unsynchronized ") << NumUtils::ToString((long)best[1])
+	     << QC_T(" ms (") << NumUtils::ToString((unsigned long)count)
+	     << QC_T(" units)") << endl;
+}
+
+//
+// Runs one line reading workload in synchronized mode and prints its best
+// time, with the speedup over baseMS when one is given.  Returns the best
+// time.
+//
+double measureLines(const String& name, double (*pFn)(const std::string&, bool, size_t&),
+                    const std::string& doc, size_t repeat, double baseMS)
+{
+	double best = 0;
+	size_t count = 0;
+
+	for(size_t i=0; i<repeat; ++i)
+	{
+		const double ms = (*pFn)(doc, true, count);
+		if(i == 0 || ms < best)
+		{
+			best = ms;
+		}
+	}
+
+	COUT << name << QC_T(": ") << NumUtils::ToString((long)best)
+	     << QC_T(" ms (") << NumUtils::ToString((unsigned long)count) << QC_T(" lines)");
+	if(baseMS > 0)
+	{
+		const unsigned long tenths = (unsigned long)(baseMS * 10 / (best > 0 ? best : 0.1) + 0.5);
+		COUT << QC_T(", ") << NumUtils::ToString(tenths / 10) << QC_T(".")
+		     << NumUtils::ToString(tenths % 10) << QC_T("x faster");
+	}
+	COUT << endl;
+	return best;
+}
+
+int main(int argc, char* argv[])
+{
+	MemCheckSystemMonitor monitor;
+
+	BasicOption optHelp(QC_T("help"), 'h', BasicOption::none);
+	BasicOption optLines(QC_T("lines"), 'l', BasicOption::mandatory);
+	BasicOption optRepeat(QC_T("repeat"), 'r', BasicOption::mandatory);
+
+	CommandLineParser cmdlineParser;
+	cmdlineParser.addOption(&optHelp);
+	cmdlineParser.addOption(&optLines);
+	cmdlineParser.addOption(&optRepeat);
+
+	try
+	{
+		cmdlineParser.parse(argc, argv);
+	}
+	catch (CommandLineException& e)
+	{
+		CERR << cmdlineParser.getProgramName() << QC_T(": ") << e.getMessage() << endl << endl;
+		CERR << QC_T("Try ") << cmdlineParser.getProgramName() << QC_T(" --help") << endl;
+		return (1);
+	}
+
+	if(optHelp.isPresent())
+	{
+		showUsage(cmdlineParser.getProgramName());
+		return (0);
+	}
+
+	size_t lines = DefaultLines;
+	if(optLines.isPresent())
+	{
+		lines = NumUtils::ToInt(optLines.getArgument());
+	}
+
+	size_t repeat = DefaultRepeat;
+	if(optRepeat.isPresent())
+	{
+		repeat = NumUtils::ToInt(optRepeat.getArgument());
+	}
+	if(repeat == 0)
+	{
+		repeat = 1;
+	}
+
+	try
+	{
+		size_t charCount;
+		const std::string doc = makeDocument(lines, charCount);
+
+		COUT << QC_T("Document: ") << NumUtils::ToString((unsigned long)lines)
+		     << QC_T(" lines, ") << NumUtils::ToString((unsigned long)charCount)
+		     << QC_T(" characters, ") << NumUtils::ToString((unsigned long)doc.size())
+		     << QC_T(" bytes") << endl;
+
+		// Decode the document once up front so the write test measures the
+		// writer chain alone
+		String text;
+		{
+			AutoPtr<BufferedReader> rpReader = makeReader(doc, false);
+			CharType buffer[4096];
+			long nRead;
+			while((nRead = rpReader->read(buffer, sizeof(buffer)/sizeof(CharType))) != Reader::EndOfFile)
+			{
+				text.append(buffer, nRead);
+			}
+		}
+
+		measure(QC_T("read()       "), &timeRead, doc, repeat);
+		measure(QC_T("readLine()   "), &timeReadLine, doc, repeat);
+		measure(QC_T("write(char)  "), &timeWrite, text, repeat);
+
+		const double baseMS = measureLines(QC_T("read() until LF       "), &timeReadLineByChar, doc, repeat, 0);
+		measureLines(QC_T("readLine(String&)     "), &timeReadLine, doc, repeat, baseMS);
+		measureLines(QC_T("readLine(StringView&) "), &timeReadLineView, doc, repeat, baseMS);
+		measureLines(QC_T("LineIterator::next()  "), &timeLineIterator, doc, repeat, baseMS);
+	}
+	catch(Exception& e)
+	{
+		CERR << e.toString() << endl;
+		return (1);
+	}
+
+	return (0);
+}
@@ -46,10 +46,10 @@
 #include "QcCore/base/StringUtils.h"
 #include "QcCore/base/System.h"
 #include "QcCore/base/Thread.h"
+#include "QcCore/io/AsyncFileOutputStream.h"
 #include "QcCore/io/BufferedReader.h"
 #include "QcCore/io/BufferedInputStream.h"
 #include "QcCore/io/Console.h"
-#include "QcCore/io/FileOutputStream.h"
 #include "QcCore/io/InterruptedIOException.h"
 #include "QcCore/io/InputStreamReader.h"
 #include "QcCore/io/OutputStreamWriter.h"
@@ -82,7 +82,7 @@ void ClientHandler::run()
 #endif // QC_MT
 
 	AutoPtr<OutputStream> rpSockOut = m_rpSocket->getOutputStream();
-	AutoPtr<OutputStream> rpLog = new FileOutputStream(QC_T("server.log"));
+	AutoPtr<OutputStream> rpLog = new AsyncFileOutputStream(QC_T("server.log"));
 	AutoPtr<Writer> rpSockWriter = new OutputStreamWriter(m_rpSocket->getOutputStream().get());
 	AutoPtr<InputStream> rpInput = new BufferedInputStream(m_rpSocket->getInputStream().get());
 	
@@ -120,7 +120,6 @@ void ClientHandler::run()
 				if(bLog)
 				{
 					rpLog->write(buffer, bytesRead);
-					rpLog->flush();
 				}
 
 				if(bEcho)
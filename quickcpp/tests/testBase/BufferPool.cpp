@@ -0,0 +1,170 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+
+#include "QcCore/base/BufferPool.h"
+#include "QcCore/base/Thread.h"
+#include "QcCore/base/Runnable.h"
+#include "QcCore/io/BufferedInputStream.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+
+using namespace qc; 
+
+#ifdef QC_MT
+
+//
+// class: testPoolThread
+//
+// Allocates and releases a buffer, leaving it in the thread's cache.  The
+// cache should be emptied into the shared pool when the thread ends.
+//
+class testPoolThread : public Runnable
+{
+	virtual void run()
+	{
+		BufferPool::Release(BufferPool::Allocate(0x2000), 0x2000);
+	}
+};
+
+#endif //QC_MT
+
+void BufferPool_Tests()
+{
+	testMessage(QC_T("Starting tests for BufferPool"));
+
+	const size_t maxPoolSize = BufferPool::GetMaxPoolSize();
+	const size_t threadCacheSize = BufferPool::GetThreadCacheSize();
+
+	try
+	{
+		BufferPool::SetThreadCacheSize(2);
+		BufferPool::Statistics before = BufferPool::GetStatistics();
+		void* p1 = BufferPool::Allocate(4096);
+		BufferPool::Release(p1, 4096);
+		void* p2 = BufferPool::Allocate(4000);
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		BufferPool::Release(p2, 4000);
+		if(p1 == p2 && after.threadCacheHits == before.threadCacheHits+1 && after.allocations == before.allocations+2) {testPassed(QC_T("thread cache"));} else {testFailed(QC_T("thread cache"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("thread cache"));
+	}
+
+	try
+	{
+		BufferPool::SetThreadCacheSize(0);
+		BufferPool::Purge();
+		void* p1 = BufferPool::Allocate(0x8000);
+		BufferPool::Release(p1, 0x8000);
+		BufferPool::Statistics before = BufferPool::GetStatistics();
+		void* p2 = BufferPool::Allocate(0x8000);
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		BufferPool::Release(p2, 0x8000);
+		if(p1 == p2 && before.pooledBytes == 0x8000 && after.pooledBytes == 0 && after.poolHits == before.poolHits+1) {testPassed(QC_T("shared pool"));} else {testFailed(QC_T("shared pool"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("shared pool"));
+	}
+
+	try
+	{
+		BufferPool::Purge();
+		BufferPool::SetMaxPoolSize(0x1000);
+		void* p1 = BufferPool::Allocate(0x1000);
+		void* p2 = BufferPool::Allocate(0x1000);
+		BufferPool::Statistics before = BufferPool::GetStatistics();
+		BufferPool::Release(p1, 0x1000);
+		BufferPool::Release(p2, 0x1000);
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		if(after.pooledBytes == 0x1000 && after.heapReleases == before.heapReleases+1) {testPassed(QC_T("max pool size"));} else {testFailed(QC_T("max pool size"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("max pool size"));
+	}
+	BufferPool::SetMaxPoolSize(maxPoolSize);
+
+	try
+	{
+		BufferPool::Statistics before = BufferPool::GetStatistics();
+		void* p1 = BufferPool::Allocate(BufferPool::MaxBlockSize+1);
+		BufferPool::Release(p1, BufferPool::MaxBlockSize+1);
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		if(after.heapAllocations == before.heapAllocations+1 && after.heapReleases == before.heapReleases+1) {testPassed(QC_T("large block"));} else {testFailed(QC_T("large block"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("large block"));
+	}
+
+	try
+	{
+		BufferPool::SetEnabled(false);
+		BufferPool::Statistics before = BufferPool::GetStatistics();
+		PooledArray<Byte> array(100);
+		array.get()[99] = 0;
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		BufferPool::SetEnabled(true);
+		if(!BufferPool::IsEnabled() || after.allocations != before.allocations || after.pooledBytes != 0) {testFailed(QC_T("disabled"));} else {testPassed(QC_T("disabled"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("disabled"));
+	}
+	BufferPool::SetEnabled(true);
+	BufferPool::SetThreadCacheSize(threadCacheSize);
+
+	try
+	{
+		//
+		// A second stream of the same buffer size should reuse the buffer
+		// released by the first
+		//
+		const Byte data[] = {'a', 'b', 'c'};
+		{
+			AutoPtr<io::BufferedInputStream> rpIS = new io::BufferedInputStream(new io::ByteArrayInputStream(data, sizeof(data)));
+			rpIS->read();
+		}
+		BufferPool::Statistics before = BufferPool::GetStatistics();
+		AutoPtr<io::BufferedInputStream> rpIS = new io::BufferedInputStream(new io::ByteArrayInputStream(data, sizeof(data)));
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		if(rpIS->read() == 'a' && after.threadCacheHits == before.threadCacheHits+1) {testPassed(QC_T("stream buffer"));} else {testFailed(QC_T("stream buffer"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("stream buffer"));
+	}
+
+#ifdef QC_MT
+	try
+	{
+		BufferPool::Purge();
+		AutoPtr<Thread> rpThread = new Thread(new testPoolThread);
+		rpThread->start();
+		rpThread->join();
+		BufferPool::Statistics after = BufferPool::GetStatistics();
+		if(after.pooledBytes == 0x2000) {testPassed(QC_T("thread end"));} else {testFailed(QC_T("thread end"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("thread end"));
+	}
+#endif //QC_MT
+}
+
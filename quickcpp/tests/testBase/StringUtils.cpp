@@ -94,6 +94,17 @@ void StringUtils_Tests()
 	{
 		uncaughtException(e.toString(), QC_T("fromLatin1-2"));
 	}
+	try
+	{
+		ByteString allLatin1;
+		for(size_t i=1; i<256; ++i) allLatin1 += char(i);
+		String sAll = StringUtils::FromLatin1(allLatin1.data(), allLatin1.size());
+		if(sAll.size() >= allLatin1.size() && StringUtils::ToLatin1(sAll) == allLatin1) {testPassed(QC_T("Latin1 round trip"));} else {testFailed(QC_T("Latin1 round trip"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("Latin1 round trip"));
+	}
 
 #if !defined(QC_UCS2)
 	Character hiChar(0x10f000UL);
@@ -16,6 +16,7 @@ void goodCatch(const String& test, const String& eMsg);
 void uncaughtException(const String& e, const String& test);
 
 
+void BufferPool_Tests();
 void NumUtils_Tests();
 void StringUtils_Tests();
 void Thread_Tests();
@@ -110,6 +111,7 @@ int main(int argc, char* argv[])
 
 	try
 	{
+		BufferPool_Tests();
 		NumUtils_Tests();
 		StringUtils_Tests();
 		Thread_Tests();
@@ -0,0 +1,199 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/io/AsyncFileOutputStream.h"
+#include "QcCore/io/FileInputStream.h"
+#include "QcCore/io/FileSystem.h"
+#include "QcCore/io/File.h"
+#include "QcCore/io/IOException.h"
+
+#include <vector>
+
+using namespace qc::io;
+
+//
+// Reads the whole of a file into a vector
+//
+static std::vector<Byte> ReadFile(const File& file)
+{
+	std::vector<Byte> contents;
+	AutoPtr<FileInputStream> rpIS = new FileInputStream(file);
+	Byte buffer[4096];
+	long count;
+	while((count = rpIS->read(buffer, sizeof(buffer))) != InputStream::EndOfFile)
+	{
+		contents.insert(contents.end(), buffer, buffer+count);
+	}
+	rpIS->close();
+	return contents;
+}
+
+void AsyncFileOutputStream_Tests()
+{
+	testMessage(QC_T("Starting tests for AsyncFileOutputStream"));
+
+	File testFile(QC_T("async.out"));
+
+	//
+	// Writes of many sizes, with flush barriers part way through
+	//
+	try
+	{
+		std::vector<Byte> expected;
+		AutoPtr<AsyncFileOutputStream> rpOS = new AsyncFileOutputStream(testFile);
+		Byte buffer[10000];
+		bool bOK = true;
+		for(size_t i=0; i<400; ++i)
+		{
+			const size_t len = (i * 37) % sizeof(buffer);
+			for(size_t j=0; j<len; ++j)
+			{
+				buffer[j] = Byte(i + j);
+			}
+			rpOS->write(buffer, len);
+			expected.insert(expected.end(), buffer, buffer+len);
+			if(i % 100 == 50)
+			{
+				rpOS->flush();
+				bOK = bOK && (testFile.length() == expected.size());
+			}
+			else if(i % 10 == 0)
+			{
+				rpOS->flushBuffers();
+			}
+		}
+		rpOS->sync();
+		bOK = bOK && (testFile.length() == expected.size());
+		rpOS->write(7);
+		expected.push_back(7);
+		rpOS->close();
+		bOK = bOK && (ReadFile(testFile) == expected);
+		if(bOK) {testPassed(QC_T("async write"));} else {testFailed(QC_T("async write"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("async write"));
+	}
+
+	//
+	// Appending, and writing after close
+	//
+	try
+	{
+		const Byte data[3] = {1, 2, 3};
+		const size_t length = testFile.length();
+		AutoPtr<AsyncFileOutputStream> rpOS = new AsyncFileOutputStream(testFile.getPath(), true);
+		rpOS->write(data, 3);
+		rpOS->close();
+		if(testFile.length() == length+3) {testPassed(QC_T("async append"));} else {testFailed(QC_T("async append"));}
+		rpOS->write(data, 3);
+		testFailed(QC_T("async closed"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("async closed"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("async closed"));
+	}
+
+	//
+	// With the DiscardData policy every byte is either written or counted
+	// as discarded
+	//
+	try
+	{
+		AutoPtr<AsyncFileOutputStream> rpOS = new AsyncFileOutputStream(testFile);
+		rpOS->setQueueLimit(0x10000);
+		rpOS->setOverflowPolicy(AsyncFileOutputStream::DiscardData);
+		bool bOK = (rpOS->getOverflowPolicy() == AsyncFileOutputStream::DiscardData);
+		bOK = bOK && (rpOS->getQueueLimit() == 0x10000);
+		std::vector<Byte> block(0x8000, 'x');
+		const size_t numBlocks = 200;
+		for(size_t i=0; i<numBlocks; ++i)
+		{
+			rpOS->write(&block[0], block.size());
+		}
+		rpOS->flush();
+		bOK = bOK && (testFile.length() + rpOS->getDiscardedCount() == numBlocks * block.size());
+		rpOS->close();
+		if(bOK) {testPassed(QC_T("async discard"));} else {testFailed(QC_T("async discard"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("async discard"));
+	}
+
+	//
+	// Small writes share the queue's space, so many of them fit however far
+	// behind the writer thread is
+	//
+	try
+	{
+		AutoPtr<AsyncFileOutputStream> rpOS = new AsyncFileOutputStream(testFile);
+		rpOS->setQueueLimit(0x10000);
+		rpOS->setOverflowPolicy(AsyncFileOutputStream::DiscardData);
+		const Byte message[10] = {'0','1','2','3','4','5','6','7','8','\n'};
+		const size_t numMessages = 0x10000 / sizeof(message);
+		for(size_t i=0; i<numMessages; ++i)
+		{
+			rpOS->write(message, sizeof(message));
+			rpOS->flushBuffers();
+		}
+		bool bOK = (rpOS->getDiscardedCount() == 0);
+		rpOS->close();
+		bOK = bOK && (testFile.length() == numMessages * sizeof(message));
+		if(bOK) {testPassed(QC_T("async small writes"));} else {testFailed(QC_T("async small writes"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("async small writes"));
+	}
+
+	//
+	// An error on the writer thread is reported by the next flush()
+	//
+	try
+	{
+		AutoPtr<FileDescriptor> rpFD = FileSystem::GetFileSystem()->openFile(testFile.getPath(),
+			FileSystem::ReadAccess, FileSystem::OpenExisting, 0);
+		AutoPtr<AsyncFileOutputStream> rpOS = new AsyncFileOutputStream(rpFD.get());
+		rpOS->write(1);
+		rpOS->flush();
+		testFailed(QC_T("async error"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("async error"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("async error"));
+	}
+
+	try
+	{
+		testFile.deleteFile(); testPassed(QC_T("delete"));
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("delete"));
+	}
+
+	testMessage(QC_T("End of tests for AsyncFileOutputStream"));
+}
@@ -162,6 +162,100 @@ void BufferedInputStream_Tests()
 	}
 
 
+	//
+	// Delimiter scanning across refills of a small buffer
+	//
+	try
+	{
+		const char* pLines = "first line\nsecond line is longer\nthird\nlast";
+		AutoPtr<BufferedInputStream> rpLines = new BufferedInputStream(
+			new ByteArrayInputStream((const Byte*)pLines, strlen(pLines)), 8);
+		ByteString line;
+		bool bOK = rpLines->readUntil('\n', line) == 11 && line == "first line\n";
+		line.erase();
+		bOK = bOK && rpLines->readUntil('\n', line, 6) == 6 && line == "second";
+		bOK = bOK && rpLines->readUntil('\n', line) == 16 && line == "second line is longer\n";
+		bOK = bOK && rpLines->skipUntil('\n') == 6;
+		line.erase();
+		bOK = bOK && rpLines->readUntil('\n', line) == 4 && line == "last";
+		bOK = bOK && rpLines->readUntil('\n', line) == InputStream::EndOfFile;
+		bOK = bOK && rpLines->skipUntil('\n') == InputStream::EndOfFile;
+		if(bOK) {testPassed(QC_T("readUntil"));} else {testFailed(QC_T("readUntil"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("readUntil"));
+	}
+
+	//
+	// peek() beyond the buffer size, preserving the mark
+	//
+	try
+	{
+		const char* pPeek = "0123456789abcdefghij";
+		AutoPtr<BufferedInputStream> rpPeek = new BufferedInputStream(
+			new ByteArrayInputStream((const Byte*)pPeek, strlen(pPeek)), 8);
+		const Byte* pData;
+		bool bOK = rpPeek->read() == '0';
+		rpPeek->mark(4);
+		bOK = bOK && rpPeek->read() == '1';
+		bOK = bOK && rpPeek->peek(pData, 12) >= 12 && ::memcmp(pData, "23456789abcd", 12) == 0;
+		rpPeek->reset();
+		bOK = bOK && rpPeek->read() == '1';
+		bOK = bOK && rpPeek->skip(17) == 17;
+		bOK = bOK && rpPeek->peek(pData, 5) == 1 && *pData == 'j';
+		bOK = bOK && rpPeek->read() == 'j';
+		bOK = bOK && rpPeek->peek(pData, 1) == InputStream::EndOfFile;
+		if(bOK) {testPassed(QC_T("peek"));} else {testFailed(QC_T("peek"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("peek"));
+	}
+
+	//
+	// mark() and reset() across the end of a small circular buffer
+	//
+	try
+	{
+		Byte wrapData[100];
+		for(size_t i=0; i<sizeof(wrapData); ++i) wrapData[i] = Byte(i);
+		AutoPtr<BufferedInputStream> rpWrap = new BufferedInputStream(
+			new ByteArrayInputStream(wrapData, sizeof(wrapData)), 16);
+		Byte wrapBuf[40];
+		bool bOK = rpWrap->read(wrapBuf, 10) == 10;
+		rpWrap->mark(50);
+		bOK = bOK && rpWrap->skip(32) == 32;
+		rpWrap->reset();
+		size_t total = 0;
+		while(total < 40)
+		{
+			long count = rpWrap->read(wrapBuf+total, 40-total);
+			if(count <= 0) break;
+			total += count;
+		}
+		bOK = bOK && total == 40 && ::memcmp(wrapBuf, wrapData+10, 40) == 0;
+		rpWrap->mark(4);
+		bOK = bOK && rpWrap->read(wrapBuf, 3) == 3;
+		rpWrap->reset();
+		bOK = bOK && rpWrap->read() == 50;
+		if(bOK) {testPassed(QC_T("mark across wrap"));} else {testFailed(QC_T("mark across wrap"));}
+
+		rpWrap = new BufferedInputStream(new ByteArrayInputStream(wrapData, sizeof(wrapData)), 16);
+		rpWrap->mark(4);
+		rpWrap->skip(40);
+		rpWrap->reset();
+		testFailed(QC_T("mark limit exceeded"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("mark limit exceeded"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("mark across wrap"));
+	}
+
 	testMessage(QC_T("End of tests for BufferedInputStream"));
 }
 
@@ -21,6 +21,7 @@ void uncaughtException(const String& e, const String& test);
 #include "QcCore/base/IllegalArgumentException.h"
 #include "QcCore/io/ByteArrayInputStream.h"
 #include "QcCore/io/InputStreamReader.h"
+#include "QcCore/io/LineIterator.h"
 
 using namespace qc::io;
 
@@ -143,6 +144,102 @@ void BufferedReader_Tests()
 	}
 
 
+	//
+	// Unsynchronized mode is passed down the chain of Readers
+	//
+	try
+	{
+		const char* pData = "one\ntwo\n";
+		AutoPtr<InputStreamReader> rpISR = new InputStreamReader(new ByteArrayInputStream((const Byte*)pData, 8));
+		AutoPtr<BufferedReader> rpBR = new BufferedReader(rpISR.get());
+		rpBR->setSynchronized(false);
+		bool bOK = !rpBR->isSynchronized() && !rpISR->isSynchronized();
+		bOK = bOK && rpBR->readLine(line) == 3 && line == QC_T("one");
+		bOK = bOK && rpBR->read() == 't';
+		AutoPtr<BufferedReader> rpOuter = new BufferedReader(rpBR.get());
+		bOK = bOK && !rpOuter->isSynchronized();
+		bOK = bOK && rpOuter->readLine(line) == 2 && line == QC_T("wo");
+		if(bOK) {testPassed(QC_T("unsynchronized"));} else {testFailed(QC_T("unsynchronized"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("unsynchronized"));
+	}
+
+	//
+	// Lines longer than the buffer, and a CR LF pair split by a refill
+	//
+	try
+	{
+		const char* pData = "a line of text that is longer than the buffer\r\n"
+		                    "short\r\n\n"
+		                    "0123456789012345678901234567890123456789\r"
+		                    "\n\rlast";
+		AutoPtr<BufferedReader> rpBR = new BufferedReader(
+			new InputStreamReader(new ByteArrayInputStream((const Byte*)pData, strlen(pData))), 16);
+		bool bOK = rpBR->readLine(line) == 45 && line == QC_T("a line of text that is longer than the buffer");
+		bOK = bOK && rpBR->readLine(line) == 5 && line == QC_T("short");
+		bOK = bOK && rpBR->readLine(line) == 0 && line.empty();
+		bOK = bOK && rpBR->readLine(line) == 40 && line == QC_T("0123456789012345678901234567890123456789");
+		bOK = bOK && rpBR->readLine(line) == 0 && line.empty();
+		bOK = bOK && rpBR->readLine(line) == 4 && line == QC_T("last");
+		bOK = bOK && rpBR->readLine(line) == BufferedReader::EndOfFile;
+		if(bOK) {testPassed(QC_T("readline across refills"));} else {testFailed(QC_T("readline across refills"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("readline across refills"));
+	}
+
+	//
+	// Lines returned as views into the buffer
+	//
+	try
+	{
+		const char* pData = "first line\nsecond line which spans the end of the buffer\r\n\nend";
+		LineIterator it(new BufferedReader(
+			new InputStreamReader(new ByteArrayInputStream((const Byte*)pData, strlen(pData))), 20));
+		bool bOK = it.getLineNumber() == 0 && it.getLine().empty();
+		bOK = bOK && it.next() && it.getLine() == StringView(QC_T("first line"), 10);
+		bOK = bOK && it.next() && it.getLine().toString() == QC_T("second line which spans the end of the buffer");
+		bOK = bOK && it.next() && it.getLine().empty() && it.getLineNumber() == 3;
+		bOK = bOK && it.next() && it.getLine().toString() == QC_T("end");
+		bOK = bOK && !it.next() && it.getLineNumber() == 4;
+		if(bOK) {testPassed(QC_T("LineIterator"));} else {testFailed(QC_T("LineIterator"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("LineIterator"));
+	}
+
+	//
+	// mark() and reset() across the end of a small circular buffer
+	//
+	try
+	{
+		const char* pData = "abcdefghijklmnopqrstuvwxyz\nABCDEFGHIJKLMNOPQRSTUVWXYZ\n0123456789";
+		AutoPtr<BufferedReader> rpBR = new BufferedReader(
+			new InputStreamReader(new ByteArrayInputStream((const Byte*)pData, strlen(pData))), 16);
+		CharType buf[30];
+		bool bOK = rpBR->read(buf, 10) == 10;
+		rpBR->mark(50);
+		bOK = bOK && rpBR->readLine(line) == 16 && line == QC_T("klmnopqrstuvwxyz");
+		bOK = bOK && rpBR->readLine(line) == 26 && line == QC_T("ABCDEFGHIJKLMNOPQRSTUVWXYZ");
+		rpBR->reset();
+		bOK = bOK && rpBR->read(buf, 5) == 5 && String(buf, 5) == QC_T("klmno");
+		bOK = bOK && rpBR->readLine(line) == 11 && line == QC_T("pqrstuvwxyz");
+		bOK = bOK && rpBR->readLine(line) == 26;
+		rpBR->mark(2);
+		bOK = bOK && rpBR->read() == '0';
+		rpBR->reset();
+		bOK = bOK && rpBR->readLine(line) == 10 && line == QC_T("0123456789");
+		if(bOK) {testPassed(QC_T("mark across wrap"));} else {testFailed(QC_T("mark across wrap"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("mark across wrap"));
+	}
+
 	testMessage(QC_T("End of tests for BufferedReader"));
 }
 
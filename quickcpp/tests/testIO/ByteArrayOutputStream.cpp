@@ -0,0 +1,152 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+
+#include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/io/IOException.h"
+
+#include <memory.h>
+#include <vector>
+
+using namespace qc::io;
+
+
+void ByteArrayOutputStream_Tests()
+{
+	testMessage(QC_T("Starting tests for ByteArrayOutputStream"));
+
+	//
+	// Create some test data that will span several segments
+	//
+	const size_t dataLen = 100000;
+	ByteString expected;
+	for(size_t i=0; i<dataLen; ++i)
+	{
+		expected += char(i % 251);
+	}
+
+	try
+	{
+		AutoPtr<ByteArrayOutputStream> rpOS = new ByteArrayOutputStream(16);
+		for(size_t i=0; i<dataLen; i+=1000)
+		{
+			rpOS->write((const Byte*)expected.data()+i, 1000);
+		}
+		std::vector<IoVec> vecs;
+		bool bOK = (rpOS->size()==dataLen && rpOS->getSegments(vecs)>1);
+		size_t pos = 0;
+		for(size_t i=0; bOK && i<vecs.size(); ++i)
+		{
+			bOK = (::memcmp(vecs[i].pData, expected.data()+pos, vecs[i].length)==0);
+			pos += vecs[i].length;
+		}
+		bOK = bOK && (pos==dataLen);
+		bOK = bOK && (::memcmp(rpOS->data(), expected.data(), dataLen)==0);
+		vecs.clear();
+		bOK = bOK && (rpOS->getSegments(vecs)==1);
+		bOK = bOK && (rpOS->toByteString()==expected);
+		if(bOK) {testPassed(QC_T("segmented write"));} else {testFailed(QC_T("segmented write"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("segmented write"));
+	}
+
+	try
+	{
+		AutoPtr<ByteArrayOutputStream> rpOS = new ByteArrayOutputStream(16);
+		rpOS->write((const Byte*)expected.data(), 10);
+		rpOS->write((const Byte*)expected.data()+10, dataLen-10);
+		AutoPtr<ByteArrayOutputStream> rpCopy = new ByteArrayOutputStream;
+		rpOS->writeTo(rpCopy.get());
+		if(rpCopy->toByteString()==expected) {testPassed(QC_T("writeTo"));} else {testFailed(QC_T("writeTo"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("writeTo"));
+	}
+
+	try
+	{
+		//
+		// A single segment is handed over without being copied
+		//
+		AutoPtr<ByteArrayOutputStream> rpOS = new ByteArrayOutputStream(dataLen);
+		rpOS->write((const Byte*)expected.data(), dataLen);
+		const Byte* pData = rpOS->data();
+		ByteString moved;
+		rpOS->moveTo(moved);
+		bool bOK = (moved==expected && (const Byte*)moved.data()==pData && rpOS->size()==0);
+		rpOS->write((const Byte*)"abc", 3);
+		rpOS->write((const Byte*)expected.data(), dataLen);
+		rpOS->moveTo(moved);
+		bOK = bOK && (moved.size()==dataLen+3 && moved.substr(3)==expected && rpOS->size()==0);
+		if(bOK) {testPassed(QC_T("moveTo"));} else {testFailed(QC_T("moveTo"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("moveTo"));
+	}
+
+	try
+	{
+		//
+		// After reset() the same segments are used again
+		//
+		AutoPtr<ByteArrayOutputStream> rpOS = new ByteArrayOutputStream(16);
+		rpOS->write((const Byte*)expected.data(), 1000);
+		rpOS->write((const Byte*)expected.data()+1000, 1000);
+		std::vector<IoVec> before;
+		rpOS->getSegments(before);
+		rpOS->reset();
+		bool bOK = (rpOS->size()==0);
+		rpOS->write((const Byte*)expected.data(), 1000);
+		rpOS->write((const Byte*)expected.data()+1000, 1000);
+		std::vector<IoVec> after;
+		rpOS->getSegments(after);
+		bOK = bOK && (before.size()==after.size() && before[0].pData==after[0].pData);
+		bOK = bOK && (rpOS->toByteString()==expected.substr(0, 2000));
+		if(bOK) {testPassed(QC_T("reset"));} else {testFailed(QC_T("reset"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("reset"));
+	}
+
+	try
+	{
+		AutoPtr<ByteArrayOutputStream> rpOS = new ByteArrayOutputStream;
+		bool bOK = (rpOS->size()==0 && rpOS->toString().empty());
+		rpOS->write((const Byte*)"hello", 5);
+		bOK = bOK && (rpOS->toString(QC_T("ISO-8859-1"))==QC_T("hello"));
+		if(bOK) {testPassed(QC_T("toString"));} else {testFailed(QC_T("toString"));}
+		rpOS->close();
+		rpOS->write((const Byte*)"x", 1);
+		testFailed(QC_T("write closed"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("write closed"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("write closed"));
+	}
+
+	testMessage(QC_T("End of tests for ByteArrayOutputStream"));
+}
+
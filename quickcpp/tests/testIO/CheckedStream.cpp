@@ -0,0 +1,176 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/io/CheckedInputStream.h"
+#include "QcCore/io/CheckedOutputStream.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/util/CRC32.h"
+#include "QcCore/util/CRC32C.h"
+#include "QcCore/util/XXHash64.h"
+
+#include <string.h>
+#include <vector>
+
+using util::CRC32;
+using util::CRC32C;
+using util::XXHash64;
+
+void CheckedStream_Tests()
+{
+	std::vector<Byte> data(50000);
+	for(size_t i=0; i<data.size(); ++i)
+	{
+		data[i] = Byte((i * 7 + i / 251) & 0xFF);
+	}
+
+	CRC32C expected;
+	expected.update(&data[0], data.size());
+
+	//
+	// Writing with each of the write() methods
+	//
+	AutoPtr<ByteArrayOutputStream> rpBytes = new ByteArrayOutputStream;
+	try
+	{
+		AutoPtr<CheckedOutputStream> rpOut = new CheckedOutputStream(rpBytes.get(), new CRC32C);
+		rpOut->write(data[0]);
+		rpOut->write(&data[1], 999);
+		IoVec vecs[2];
+		vecs[0].pData = &data[1000];
+		vecs[0].length = 9000;
+		vecs[1].pData = &data[10000];
+		vecs[1].length = data.size() - 10000;
+		rpOut->write(vecs, 2);
+		rpOut->close();
+		bool bOK = (rpOut->getChecksum()->getValue() == expected.getValue());
+		bOK = bOK && (rpBytes->size() == data.size());
+		bOK = bOK && (memcmp(rpBytes->data(), &data[0], data.size()) == 0);
+		if(bOK) {testPassed(QC_T("CheckedOutputStream write"));} else {testFailed(QC_T("CheckedOutputStream write"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CheckedOutputStream write"));
+	}
+
+	//
+	// Reading it back with read() and skip()
+	//
+	try
+	{
+		AutoPtr<CheckedInputStream> rpIn =
+			new CheckedInputStream(new ByteArrayInputStream(&data[0], data.size()), new CRC32C);
+		std::vector<Byte> buffer(data.size());
+		size_t pos = 0;
+		bool bOK = (rpIn->read() == data[0]);
+		++pos;
+		bOK = bOK && (rpIn->skip(20000) == 20000);
+		pos += 20000;
+		long bytesRead;
+		while((bytesRead = rpIn->read(&buffer[pos], 4096)) != InputStream::EndOfFile)
+		{
+			pos += bytesRead;
+		}
+		rpIn->close();
+		bOK = bOK && (pos == data.size());
+		bOK = bOK && (memcmp(&buffer[20001], &data[20001], data.size()-20001) == 0);
+		bOK = bOK && (rpIn->getChecksum()->getValue() == expected.getValue());
+		if(bOK) {testPassed(QC_T("CheckedInputStream read"));} else {testFailed(QC_T("CheckedInputStream read"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CheckedInputStream read"));
+	}
+
+	//
+	// Views of the contained stream are checksummed where they lie
+	//
+	try
+	{
+		AutoPtr<CheckedInputStream> rpIn =
+			new CheckedInputStream(new ByteArrayInputStream(&data[0], data.size()), new CRC32C);
+		bool bOK = rpIn->viewSupported();
+		const Byte* pView;
+		long bytesRead;
+		size_t total = 0;
+		while((bytesRead = rpIn->readView(pView, 3000)) != InputStream::EndOfFile)
+		{
+			total += bytesRead;
+		}
+		bOK = bOK && (total == data.size());
+		bOK = bOK && (rpIn->getChecksum()->getValue() == expected.getValue());
+		if(bOK) {testPassed(QC_T("CheckedInputStream readView"));} else {testFailed(QC_T("CheckedInputStream readView"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CheckedInputStream readView"));
+	}
+
+	//
+	// Checksums at both ends of a copy agree
+	//
+	try
+	{
+		AutoPtr<CheckedInputStream> rpIn =
+			new CheckedInputStream(new ByteArrayInputStream(&data[0], data.size()), new XXHash64);
+		AutoPtr<CheckedOutputStream> rpOut =
+			new CheckedOutputStream(new ByteArrayOutputStream, new XXHash64);
+		bool bOK = (rpIn->transferTo(rpOut.get()) == data.size());
+		XXHash64 hash;
+		hash.update(&data[0], data.size());
+		bOK = bOK && (rpIn->getChecksum()->getValue() == hash.getValue());
+		bOK = bOK && (rpOut->getChecksum()->getValue() == hash.getValue());
+		if(bOK) {testPassed(QC_T("transferTo"));} else {testFailed(QC_T("transferTo"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transferTo"));
+	}
+
+	try
+	{
+		AutoPtr<CheckedInputStream> rpIn =
+			new CheckedInputStream(new ByteArrayInputStream(&data[0], data.size()), new CRC32);
+		if(rpIn->markSupported()) testFailed(QC_T("markSupported"));
+		rpIn->reset();
+		testFailed(QC_T("reset"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("reset"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("reset"));
+	}
+
+	try
+	{
+		AutoPtr<CheckedOutputStream> rpOut = new CheckedOutputStream(new ByteArrayOutputStream, 0);
+		testFailed(QC_T("null checksum"));
+	}
+	catch(NullPointerException& e)
+	{
+		goodCatch(QC_T("null checksum"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("null checksum"));
+	}
+}
@@ -0,0 +1,189 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/base/Character.h"
+#include "QcCore/cvt/CodeConverter.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+
+#include <vector>
+
+using namespace qc::cvt;
+
+//
+// A small linear congruential generator, so that every run of the tests
+// uses the same data
+//
+static unsigned long NextRandom(unsigned long& seed)
+{
+	seed = seed * 1103515245UL + 12345UL;
+	return (seed >> 16) & 0x7FFF;
+}
+
+//
+// Builds a buffer of ASCII runs of assorted lengths, long enough to fill
+// whole vector blocks, separated by short runs of bytes from the upper half
+// of the code page, some of which the code page does not map
+//
+static std::vector<Byte> MixedBytes(unsigned long seed, size_t length)
+{
+	std::vector<Byte> bytes;
+	while(bytes.size() < length)
+	{
+		const size_t asciiLen = NextRandom(seed) % 80;
+		for(size_t i=0; i<asciiLen; ++i)
+		{
+			bytes.push_back(Byte(0x20 + NextRandom(seed) % 0x5F));
+		}
+		const size_t highLen = 1 + NextRandom(seed) % 12;
+		for(size_t j=0; j<highLen; ++j)
+		{
+			bytes.push_back(Byte(0x80 + NextRandom(seed) % 0x80));
+		}
+	}
+	bytes.resize(length);
+	return bytes;
+}
+
+//
+// Decodes the whole buffer with one call, which lets the converter use its
+// vector implementations
+//
+static std::vector<CharType> DecodeAll(CodeConverter* pConverter, const std::vector<Byte>& bytes)
+{
+	std::vector<CharType> chars(bytes.size() * 4 + 1);
+	const Byte* pFrom = &bytes[0];
+	const Byte* pFromNext = pFrom;
+	CharType* pTo = &chars[0];
+	CharType* pToNext = pTo;
+	while(pFrom < &bytes[0] + bytes.size())
+	{
+		pConverter->decode(pFrom, &bytes[0] + bytes.size(), pFromNext,
+		                   pTo, &chars[0] + chars.size(), pToNext);
+		pFrom = pFromNext;
+		pTo = pToNext;
+	}
+	chars.resize(pTo - &chars[0]);
+	return chars;
+}
+
+//
+// Decodes the buffer one byte at a time, which is too short for any of the
+// vector implementations, so the result comes from the scalar code
+//
+static std::vector<CharType> DecodeBytewise(CodeConverter* pConverter, const std::vector<Byte>& bytes)
+{
+	std::vector<CharType> chars(bytes.size() * 4 + 1);
+	CharType* pTo = &chars[0];
+	for(size_t i=0; i<bytes.size(); ++i)
+	{
+		const Byte* pFromNext;
+		CharType* pToNext;
+		pConverter->decode(&bytes[i], &bytes[i] + 1, pFromNext,
+		                   pTo, &chars[0] + chars.size(), pToNext);
+		pTo = pToNext;
+	}
+	chars.resize(pTo - &chars[0]);
+	return chars;
+}
+
+//
+// Returns the Unicode code point of the first character in chars, which may
+// take several CharTypes when the internal encoding is UTF-8 or UTF-16
+//
+static UCS4Char FirstCodePoint(const std::vector<CharType>& chars)
+{
+	return chars.empty() ? 0 : Character(&chars[0], chars.size()).toUnicode();
+}
+
+//
+// Encodes characters back into the code page
+//
+static std::vector<Byte> EncodeAll(CodeConverter* pConverter, const std::vector<CharType>& chars)
+{
+	std::vector<Byte> bytes(chars.size() * pConverter->getMaxEncodedLength() + 1);
+	const CharType* pFrom = &chars[0];
+	const CharType* pFromNext = pFrom;
+	Byte* pTo = &bytes[0];
+	Byte* pToNext = pTo;
+	while(pFrom < &chars[0] + chars.size())
+	{
+		pConverter->encode(pFrom, &chars[0] + chars.size(), pFromNext,
+		                   pTo, &bytes[0] + bytes.size(), pToNext);
+		pFrom = pFromNext;
+		pTo = pToNext;
+	}
+	bytes.resize(pTo - &bytes[0]);
+	return bytes;
+}
+
+//
+// Compares the vector and scalar decoders for a single-byte code page, with
+// unmapped bytes replaced, then checks that the bytes the code page does map
+// survive a round trip
+//
+static void TestSingleByte(const String& encoding)
+{
+	const String test = QC_T("decode ") + encoding;
+	try
+	{
+		AutoPtr<CodeConverter> rpConverter =
+			CodeConverterFactory::GetInstance().getConverter(encoding);
+		rpConverter->setInvalidCharAction(CodeConverter::replace);
+
+		const std::vector<Byte> bytes = MixedBytes(1, 0x4000);
+		const std::vector<CharType> vectorChars = DecodeAll(rpConverter.get(), bytes);
+		bool bOK = (vectorChars == DecodeBytewise(rpConverter.get(), bytes));
+
+		//
+		// Keep only the bytes that decode to themselves after a round trip
+		// through a converter that refuses unmapped bytes
+		//
+		std::vector<Byte> mapped;
+		for(size_t i=0; i<bytes.size(); ++i)
+		{
+			const std::vector<Byte> one(1, bytes[i]);
+			if(FirstCodePoint(DecodeBytewise(rpConverter.get(), one)) != rpConverter->getInvalidCharReplacement())
+			{
+				mapped.push_back(bytes[i]);
+			}
+		}
+
+		rpConverter->setInvalidCharAction(CodeConverter::abort);
+		const std::vector<CharType> mappedChars = DecodeAll(rpConverter.get(), mapped);
+		bOK = bOK && (mappedChars == DecodeBytewise(rpConverter.get(), mapped));
+		bOK = bOK && (EncodeAll(rpConverter.get(), mappedChars) == mapped);
+
+		if(bOK) {testPassed(test);} else {testFailed(test);}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), test);
+	}
+}
+
+void CodeConverter_Tests()
+{
+	testMessage(QC_T("Starting tests for CodeConverter"));
+
+	TestSingleByte(QC_T("windows-1252"));
+	TestSingleByte(QC_T("windows-1253"));
+	TestSingleByte(QC_T("ISO-8859-3"));
+	TestSingleByte(QC_T("ISO-8859-6"));
+	TestSingleByte(QC_T("IBM850"));
+
+	testMessage(QC_T("End of tests for CodeConverter"));
+}
@@ -0,0 +1,301 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+#include "QcCore/base/Character.h"
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/NullPointerException.h"
+#include "QcCore/base/UnsupportedOperationException.h"
+#include "QcCore/cvt/CodeConverter.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+
+using namespace qc::cvt;
+
+//
+// A CodeConverter registered by the tests.  It counts the clones made of it
+// so the tests can tell that the factory hands out copies of the prototype.
+//
+class TestConverter : public CodeConverter
+{
+public:
+	TestConverter(const String& name) : m_name(name) {}
+
+	virtual String getEncodingName() const {return m_name;}
+
+	virtual AutoPtr<CodeConverter> clone() const
+	{
+		++CloneCount;
+		AutoPtr<CodeConverter> rpClone = new TestConverter(m_name);
+		rpClone->setInvalidCharAction(getInvalidCharAction());
+		return rpClone;
+	}
+
+	static size_t CloneCount;
+
+private:
+	String m_name;
+};
+
+size_t TestConverter::CloneCount = 0;
+
+//
+// A CodeConverter which does not override clone()
+//
+class UncloneableConverter : public CodeConverter
+{
+public:
+	virtual String getEncodingName() const {return QC_T("x-uncloneable");}
+};
+
+static bool IsEncoding(CodeConverterFactory& factory, const String& name, const String& expected)
+{
+	AutoPtr<CodeConverter> rpConverter = factory.getConverter(name);
+	return rpConverter && rpConverter->getEncodingName() == expected;
+}
+
+static void TestLookup()
+{
+	try
+	{
+		CodeConverterFactory factory;
+		bool bOK = IsEncoding(factory, QC_T("UTF-8"), QC_T("UTF-8"))
+		        && IsEncoding(factory, QC_T("utf8"), QC_T("UTF-8"))
+		        && IsEncoding(factory, QC_T("Utf_8"), QC_T("UTF-8"))
+		        && IsEncoding(factory, QC_T(" u.t.f 8 "), QC_T("UTF-8"))
+		        && IsEncoding(factory, QC_T("utf-16le"), QC_T("UTF-16LE"))
+		        && IsEncoding(factory, QC_T("WINDOWS1252"), QC_T("windows-1252"));
+		bOK = bOK && !factory.getConverter(QC_T("no-such-encoding"))
+		          && !factory.getConverter(QC_T("utf-9"))
+		          && !factory.getConverter(QC_T("-"));
+		if(bOK) {testPassed(QC_T("factory normalized names"));} else {testFailed(QC_T("factory normalized names"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory normalized names"));
+	}
+
+	try
+	{
+		CodeConverterFactory factory;
+		bool bOK = IsEncoding(factory, QC_T("latin1"), QC_T("ISO-8859-1"))
+		        && IsEncoding(factory, QC_T("L1"), QC_T("ISO-8859-1"))
+		        && IsEncoding(factory, QC_T("iso_8859-1:1987"), QC_T("ISO-8859-1"))
+		        && IsEncoding(factory, QC_T("cp1252"), QC_T("windows-1252"))
+		        && IsEncoding(factory, QC_T("CS-Windows-1252"), QC_T("windows-1252"));
+		if(bOK) {testPassed(QC_T("factory aliases"));} else {testFailed(QC_T("factory aliases"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory aliases"));
+	}
+}
+
+static void TestRegistration()
+{
+	try
+	{
+		CodeConverterFactory factory;
+		factory.registerConverter(QC_T("X-Test"), new TestConverter(QC_T("X-Test")));
+		factory.registerAlias(QC_T("test alias"), QC_T("x_test"));
+
+		const size_t clones = TestConverter::CloneCount;
+		AutoPtr<CodeConverter> rpFirst = factory.getConverter(QC_T("xtest"));
+		AutoPtr<CodeConverter> rpSecond = factory.getConverter(QC_T("TEST-ALIAS"));
+		bool bOK = rpFirst && rpSecond && rpFirst.get() != rpSecond.get()
+		        && rpFirst->getEncodingName() == QC_T("X-Test")
+		        && rpSecond->getEncodingName() == QC_T("X-Test")
+		        && TestConverter::CloneCount == clones + 2;
+		if(bOK) {testPassed(QC_T("factory registerConverter"));} else {testFailed(QC_T("factory registerConverter"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory registerConverter"));
+	}
+
+	//
+	// Registering an existing name replaces the converter for all its
+	// aliases, but does not change the other factories
+	//
+	try
+	{
+		CodeConverterFactory factory;
+		factory.registerConverter(QC_T("latin1"), new TestConverter(QC_T("x-latin")));
+		bool bOK = IsEncoding(factory, QC_T("ISO-8859-1"), QC_T("x-latin"))
+		        && IsEncoding(factory, QC_T("l1"), QC_T("x-latin"))
+		        && IsEncoding(factory, QC_T("CP819"), QC_T("x-latin"));
+		CodeConverterFactory other;
+		bOK = bOK && IsEncoding(other, QC_T("ISO-8859-1"), QC_T("ISO-8859-1"));
+		if(bOK) {testPassed(QC_T("factory replace converter"));} else {testFailed(QC_T("factory replace converter"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory replace converter"));
+	}
+
+	try
+	{
+		CodeConverterFactory factory;
+		factory.registerAlias(QC_T("my-utf8"), QC_T("UTF-8"));
+		factory.registerAlias(QC_T("my-utf8"), QC_T("UTF-16BE"));
+		bool bOK = IsEncoding(factory, QC_T("MyUTF8"), QC_T("UTF-16BE"));
+		if(bOK) {testPassed(QC_T("factory replace alias"));} else {testFailed(QC_T("factory replace alias"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory replace alias"));
+	}
+
+	CodeConverterFactory factory;
+
+	try
+	{
+		factory.registerAlias(QC_T("alias"), QC_T("no-such-encoding"));
+		testFailed(QC_T("factory alias unknown encoding"));
+	}
+	catch(IllegalArgumentException& e)
+	{
+		goodCatch(QC_T("factory alias unknown encoding"), e.toString());
+	}
+
+	try
+	{
+		factory.registerAlias(QC_T(" - "), QC_T("UTF-8"));
+		testFailed(QC_T("factory alias invalid name"));
+	}
+	catch(IllegalArgumentException& e)
+	{
+		goodCatch(QC_T("factory alias invalid name"), e.toString());
+	}
+
+	try
+	{
+		factory.registerConverter(QC_T("--"), new TestConverter(QC_T("--")));
+		testFailed(QC_T("factory register invalid name"));
+	}
+	catch(IllegalArgumentException& e)
+	{
+		goodCatch(QC_T("factory register invalid name"), e.toString());
+	}
+
+	try
+	{
+		factory.registerConverter(QC_T("x-null"), 0);
+		testFailed(QC_T("factory register null"));
+	}
+	catch(NullPointerException& e)
+	{
+		goodCatch(QC_T("factory register null"), e.toString());
+	}
+
+	try
+	{
+		factory.registerConverter(QC_T("x-uncloneable"), new UncloneableConverter);
+		factory.getConverter(QC_T("x-uncloneable"));
+		testFailed(QC_T("factory uncloneable prototype"));
+	}
+	catch(UnsupportedOperationException& e)
+	{
+		goodCatch(QC_T("factory uncloneable prototype"), e.toString());
+	}
+}
+
+//
+// Decodes len bytes and returns the code point of the first character
+// produced, or 0
+//
+static UCS4Char DecodeFirst(CodeConverter* pConverter, const char* pBytes, size_t len)
+{
+	const Byte* pFrom = (const Byte*)pBytes;
+	const Byte* pFromNext;
+	CharType buffer[8];
+	CharType* pToNext;
+	pConverter->decode(pFrom, pFrom+len, pFromNext, buffer, buffer+8, pToNext);
+	return (pToNext > buffer) ? Character(buffer, pToNext - buffer).toUnicode() : 0;
+}
+
+static void TestClone()
+{
+	//
+	// Converters returned by the factory do not share settings with each
+	// other or with the prototype
+	//
+	try
+	{
+		CodeConverterFactory factory;
+		AutoPtr<CodeConverter> rpFirst = factory.getConverter(QC_T("UTF-8"));
+		rpFirst->setInvalidCharAction(CodeConverter::abort);
+		rpFirst->setInvalidCharReplacement('?');
+		AutoPtr<CodeConverter> rpSecond = factory.getConverter(QC_T("UTF-8"));
+		bool bOK = rpSecond->getInvalidCharAction() == CodeConverter::replace
+		        && rpSecond->getInvalidCharReplacement() != '?';
+
+		AutoPtr<CodeConverter> rpCopy = rpFirst->clone();
+		bOK = bOK && rpCopy->getInvalidCharAction() == CodeConverter::abort
+		          && rpCopy->getInvalidCharReplacement() == '?';
+		rpCopy->setInvalidCharAction(CodeConverter::replace);
+		bOK = bOK && rpFirst->getInvalidCharAction() == CodeConverter::abort;
+		if(bOK) {testPassed(QC_T("factory clone settings"));} else {testFailed(QC_T("factory clone settings"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory clone settings"));
+	}
+
+	//
+	// A UTF-16 converter learns its byte order from the byte order mark.
+	// That must not carry over to the next converter the factory returns.
+	//
+	try
+	{
+		CodeConverterFactory factory;
+		AutoPtr<CodeConverter> rpFirst = factory.getConverter(QC_T("UTF-16"));
+		bool bOK = DecodeFirst(rpFirst.get(), "\xFF\xFE" "A\0", 4) == 'A';
+		AutoPtr<CodeConverter> rpSecond = factory.getConverter(QC_T("UTF-16"));
+		bOK = bOK && DecodeFirst(rpSecond.get(), "\xFE\xFF" "\0B", 4) == 'B';
+		bOK = bOK && DecodeFirst(rpFirst.get(), "C\0", 2) == 'C';
+		if(bOK) {testPassed(QC_T("factory clone state"));} else {testFailed(QC_T("factory clone state"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory clone state"));
+	}
+
+	//
+	// Single-byte converters share their tables
+	//
+	try
+	{
+		CodeConverterFactory factory;
+		AutoPtr<CodeConverter> rpFirst = factory.getConverter(QC_T("windows-1252"));
+		AutoPtr<CodeConverter> rpSecond = factory.getConverter(QC_T("cp1252"));
+		bool bOK = rpFirst.get() != rpSecond.get()
+		        && DecodeFirst(rpFirst.get(), "\x80", 1) == 0x20AC
+		        && DecodeFirst(rpSecond.get(), "\x80", 1) == 0x20AC;
+		if(bOK) {testPassed(QC_T("factory clone code page"));} else {testFailed(QC_T("factory clone code page"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("factory clone code page"));
+	}
+}
+
+void CodeConverterFactory_Tests()
+{
+	testMessage(QC_T("Starting tests for CodeConverterFactory"));
+
+	TestLookup();
+	TestRegistration();
+	TestClone();
+}
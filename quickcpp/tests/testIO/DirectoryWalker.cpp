@@ -0,0 +1,236 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/io/DirectoryIterator.h"
+#include "QcCore/io/DirectoryWalker.h"
+#include "QcCore/io/File.h"
+#include "QcCore/io/FileNotFoundException.h"
+#include "QcCore/io/FileOutputStream.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/base/SynchronizedObject.h"
+
+#include <set>
+
+using namespace qc::io;
+
+//
+// A Visitor that records the names of the entries it is passed, optionally
+// refusing to enter directories with a given name or ignoring errors.
+//
+class NameCollector : public DirectoryWalker::Visitor,
+                      public SynchronizedObject
+{
+public:
+	NameCollector(const String& skipName=String(), bool bIgnoreErrors=false) :
+		m_skipName(skipName), m_bIgnoreErrors(bIgnoreErrors), m_length(0), m_errors(0) {}
+
+	virtual bool enterDirectory(const String& path, size_t /*depth*/)
+	{
+		return m_skipName.empty() || File(path).getName() != m_skipName;
+	}
+
+	virtual void visitEntry(DirectoryIterator* pEntry, size_t /*depth*/)
+	{
+		const size_t length = pEntry->isDirectory() ? 0 : pEntry->getLength();
+		QC_SYNCHRONIZED
+		m_names.insert(pEntry->getName());
+		m_length += length;
+	}
+
+	virtual bool ignoreError(const String& /*path*/, const IOException& /*e*/)
+	{
+		QC_SYNCHRONIZED
+		++m_errors;
+		return m_bIgnoreErrors;
+	}
+
+	String m_skipName;
+	bool m_bIgnoreErrors;
+	std::set<String> m_names;
+	size_t m_length;
+	size_t m_errors;
+};
+
+static void createTestFile(const File& file, size_t length)
+{
+	AutoPtr<FileOutputStream> rpOut = new FileOutputStream(file);
+	for(size_t i=0; i<length; ++i)
+	{
+		rpOut->write(Byte('x'));
+	}
+	rpOut->close();
+}
+
+void DirectoryWalker_Tests()
+{
+	testMessage(QC_T("Starting tests for DirectoryWalker"));
+
+	File root(QC_T("walktest"));
+	File dirA(root, QC_T("a"));
+	File dirB(dirA, QC_T("b"));
+	File dirC(dirB, QC_T("c"));
+	File file1(root, QC_T("f1"));
+	File file2(dirA, QC_T("f2"));
+	File file3(dirB, QC_T("f3"));
+	File file4(dirC, QC_T("f4"));
+
+	try
+	{
+		dirC.mkdirs();
+		createTestFile(file1, 1);
+		createTestFile(file2, 2);
+		createTestFile(file3, 3);
+		createTestFile(file4, 4);
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("create tree"));
+	}
+
+	//
+	// Iterate over a single directory, with and without fetching the
+	// status of each entry as it is read
+	//
+	for(int flags=0; flags<=DirectoryIterator::FetchStatus; flags+=DirectoryIterator::FetchStatus)
+	{
+		try
+		{
+			AutoPtr<DirectoryIterator> rpIter = root.openDirectory(flags);
+			std::set<String> names;
+			bool bOK = true;
+			while(rpIter->next())
+			{
+				names.insert(rpIter->getName());
+				if(rpIter->getName() == QC_T("a"))
+				{
+					bOK = bOK && rpIter->isDirectory() && File(rpIter->getPath()) == dirA;
+				}
+				else
+				{
+					bOK = bOK && rpIter->getType() == DirectoryIterator::RegularFile
+					          && rpIter->getLength() == 1
+					          && rpIter->getLastModifiedTime() == file1.lastModified();
+				}
+			}
+			bOK = bOK && names.size() == 2 && !rpIter->next();
+			rpIter->close();
+			if(bOK) {testPassed(QC_T("openDirectory"));} else {testFailed(QC_T("openDirectory"));}
+		}
+		catch(Exception& e)
+		{
+			uncaughtException(e.toString(), QC_T("openDirectory"));
+		}
+	}
+
+	try
+	{
+		File(QC_T("walktest-missing")).openDirectory();
+		testFailed(QC_T("openDirectory missing"));
+	}
+	catch(FileNotFoundException& e)
+	{
+		goodCatch(QC_T("openDirectory missing"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("openDirectory missing"));
+	}
+
+	//
+	// Walk the whole tree, serially and in parallel
+	//
+	for(size_t numThreads=1; numThreads<=4; numThreads+=3)
+	{
+		try
+		{
+			DirectoryWalker walker(numThreads);
+			AutoPtr<NameCollector> rpCollector = new NameCollector;
+			walker.walk(root.getPath(), rpCollector.get());
+			bool bOK = rpCollector->m_names.size() == 7 && rpCollector->m_length == 10;
+			bOK = bOK && rpCollector->m_names.count(QC_T("f4")) == 1;
+			if(bOK) {testPassed(QC_T("walk"));} else {testFailed(QC_T("walk"));}
+		}
+		catch(Exception& e)
+		{
+			uncaughtException(e.toString(), QC_T("walk"));
+		}
+	}
+
+	//
+	// Filtering by directory and by depth
+	//
+	try
+	{
+		DirectoryWalker walker(4);
+		walker.setIteratorFlags(DirectoryIterator::FetchStatus);
+		AutoPtr<NameCollector> rpCollector = new NameCollector(QC_T("b"));
+		walker.walk(root.getPath(), rpCollector.get());
+		bool bOK = rpCollector->m_names.size() == 4 && rpCollector->m_length == 3;
+
+		walker.setMaxDepth(2);
+		rpCollector = new NameCollector;
+		walker.walk(root.getPath(), rpCollector.get());
+		bOK = bOK && rpCollector->m_names.size() == 4 && rpCollector->m_names.count(QC_T("b")) == 1;
+		if(bOK) {testPassed(QC_T("walk filters"));} else {testFailed(QC_T("walk filters"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("walk filters"));
+	}
+
+	//
+	// Errors are thrown from walk() unless the Visitor ignores them
+	//
+	try
+	{
+		DirectoryWalker walker(4);
+		AutoPtr<NameCollector> rpCollector = new NameCollector(String(), true);
+		walker.walk(QC_T("walktest-missing"), rpCollector.get());
+		bool bOK = rpCollector->m_names.empty() && rpCollector->m_errors == 1;
+		if(bOK) {testPassed(QC_T("walk ignore error"));} else {testFailed(QC_T("walk ignore error"));}
+
+		rpCollector = new NameCollector;
+		walker.walk(QC_T("walktest-missing"), rpCollector.get());
+		testFailed(QC_T("walk error"));
+	}
+	catch(FileNotFoundException& e)
+	{
+		goodCatch(QC_T("walk error"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("walk error"));
+	}
+
+	try
+	{
+		file4.deleteFile();
+		file3.deleteFile();
+		file2.deleteFile();
+		file1.deleteFile();
+		dirC.deleteFile();
+		dirB.deleteFile();
+		dirA.deleteFile();
+		root.deleteFile();
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("delete tree"));
+	}
+
+	testMessage(QC_T("End of tests for DirectoryWalker"));
+}
@@ -19,6 +19,7 @@ void uncaughtException(const String& e, const String& test);
 #include "QcCore/base/Character.h"
 #include "QcCore/base/IllegalArgumentException.h"
 #include "QcCore/io/File.h"
+#include "QcCore/io/FileStatusCache.h"
 #include "QcCore/io/FileOutputStream.h"
 #include "QcCore/io/FileInputStream.h"
 #include "QcCore/io/OutputStreamWriter.h"
@@ -87,6 +88,19 @@ void doFileTests(const File& f, bool bDir)
 	{
 		uncaughtException(e.toString(), QC_T("operator=="));
 	}
+	try
+	{
+		const FileStatus status = f.status();
+		const bool bOK = status.exists() && status.isFile()==!bDir && status.isDirectory()==bDir
+		              && status.canRead() && status.canWrite()
+		              && status.length()==f.length() && status.lastModified()==f.lastModified()
+		              && status.getAttributeFlags()==f.status().getAttributeFlags();
+		if(bOK) {testPassed(QC_T("status"));} else {testFailed(QC_T("status"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("status"));
+	}
 
 	File canon(f.getCanonicalPath());
 	File abs(f.getAbsolutePath());
@@ -176,6 +190,17 @@ void File_Tests()
 	{
 		uncaughtException(e.toString(), QC_T("canWrite_bad"));
 	};
+	try
+	{
+		const FileStatus status = badFile.status();
+		const bool bOK = !status.exists() && !status.isFile() && !status.isDirectory()
+		              && !status.canRead() && !status.canWrite() && status.length()==0;
+		if(bOK) {testPassed(QC_T("status_bad"));} else {testFailed(QC_T("status_bad"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("status_bad"));
+	};
 
 	File badFile2(QC_T(""));
 	try
@@ -446,6 +471,15 @@ void File_Tests()
 		uncaughtException(e.toString(), QC_T("canWrite"));
 	};
 	try
+	{
+		const FileStatus status = file1.status();
+		if(status.canRead() && !status.canWrite()) {testPassed(QC_T("status readOnly"));} else {testFailed(QC_T("status readOnly"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("status readOnly"));
+	};
+	try
 	{
 		file1.setReadOnly(false); testPassed(QC_T("setReadOnly"));
 	}
@@ -462,6 +496,20 @@ void File_Tests()
 		uncaughtException(e.toString(), QC_T("canWrite"));
 	};
 
+	//
+	// The FileStatusCache should remember the status of file1, by its
+	// canonical path, until it is invalidated
+	//
+	FileStatusCache::SetTimeToLive(60000);
+	try
+	{
+		if(FileStatusCache::GetStatus(file1a).exists()) {testPassed(QC_T("FileStatusCache"));} else {testFailed(QC_T("FileStatusCache"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("FileStatusCache"));
+	}
+
 	//
 	// Delete the files created earlier
 	//
@@ -474,6 +522,25 @@ void File_Tests()
 		uncaughtException(e.toString(), QC_T("deleteFile1"));
 	}
 	try
+	{
+		const bool bOK = FileStatusCache::GetStatus(file1).exists() && !file1.status().exists();
+		if(bOK) {testPassed(QC_T("FileStatusCache remembered"));} else {testFailed(QC_T("FileStatusCache remembered"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("FileStatusCache remembered"));
+	}
+	try
+	{
+		FileStatusCache::Invalidate(file1);
+		if(!FileStatusCache::GetStatus(file1).exists()) {testPassed(QC_T("FileStatusCache invalidate"));} else {testFailed(QC_T("FileStatusCache invalidate"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("FileStatusCache invalidate"));
+	}
+	FileStatusCache::SetTimeToLive(FileStatusCache::DefaultTimeToLive);
+	try
 	{
 		file1.deleteFile();
 		testFailed(QC_T("deleteFile2"));
@@ -16,12 +16,19 @@ void goodCatch(const String& test, const String& eMsg);
 void uncaughtException(const String& e, const String& test);
 
 
+#include "QcCore/io/ByteArrayOutputStream.h"
 #include "QcCore/io/FileInputStream.h"
 #include "QcCore/io/FileOutputStream.h"
+#include "QcCore/io/MappedFileInputStream.h"
+#include "QcCore/io/InputStreamReader.h"
+#include "QcCore/io/OutputStreamWriter.h"
+#include "QcCore/io/FileSystem.h"
 #include "QcCore/io/File.h"
 #include "QcCore/io/IOException.h"
 #include "QcCore/io/FileNotFoundException.h"
 
+#include <string.h>
+
 using namespace qc::io;
 
 
@@ -270,6 +277,61 @@ void FileInputStream_Tests()
 	}
 	}
 
+	//
+	// Read the same file through a MappedFileInputStream with a window
+	// smaller than the file
+	//
+	AutoPtr<MappedFileInputStream> rpMapped;
+	try
+	{
+		AutoPtr<FileDescriptor> rpFD = FileSystem::GetFileSystem()->openFile(testFile.getPath(),
+			FileSystem::ReadAccess, FileSystem::OpenExisting, 0);
+		rpMapped = new MappedFileInputStream(rpFD.get(), 2); testPassed(QC_T("mapped open"));
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("mapped open"));
+	}
+	if(rpMapped)
+	{
+		try
+		{
+			const Byte* pView = 0;
+			rpMapped->mark(0);
+			bool bOK = (rpMapped->available()==3 && rpMapped->read()==1);
+			bOK = bOK && (rpMapped->readView(pView, 10)==1 && *pView==2);
+			bOK = bOK && (rpMapped->readView(pView, 10)==1 && *pView==3);
+			bOK = bOK && (rpMapped->readView(pView, 10)==InputStream::EndOfFile);
+			rpMapped->reset();
+			Byte input[3];
+			bOK = bOK && (rpMapped->skip(1)==1 && rpMapped->read(input, 3)==2 && input[0]==2 && input[1]==3);
+			if(bOK) {testPassed(QC_T("mapped read"));} else {testFailed(QC_T("mapped read"));}
+			rpMapped->close();
+		}
+		catch(Exception& e)
+		{
+			uncaughtException(e.toString(), QC_T("mapped read"));
+		}
+	}
+
+	//
+	// transferTo() sends the rest of the file from the current position
+	//
+	try
+	{
+		AutoPtr<FileInputStream> rpIS = new FileInputStream(testFile);
+		AutoPtr<ByteArrayOutputStream> rpOS = new ByteArrayOutputStream;
+		bool bOK = (rpIS->read()==1 && rpIS->transferTo(rpOS.get())==2);
+		bOK = bOK && (rpOS->size()==2 && rpOS->data()[0]==2 && rpOS->data()[1]==3);
+		bOK = bOK && (rpIS->read()==InputStream::EndOfFile);
+		rpIS->close();
+		if(bOK) {testPassed(QC_T("transferTo"));} else {testFailed(QC_T("transferTo"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transferTo"));
+	}
+
 	// Make the file writable then delete it
 	try
 	{
@@ -289,6 +351,93 @@ void FileInputStream_Tests()
 	}
 
 
+	//
+	// Decode a UTF-8 file through an InputStreamReader that reads views of
+	// a mapped file.  The small window means that multi-byte sequences
+	// are split between views.
+	//
+	try
+	{
+		File utf8File(QC_T("mapped.out"));
+		String expected;
+		for(int i=0; i<2000; ++i)
+		{
+			expected += QC_T("a");
+			expected += Character(0xE9UL).toString();
+			expected += Character(0x20ACUL).toString();
+		}
+		AutoPtr<Writer> rpWriter = new OutputStreamWriter(new FileOutputStream(utf8File), QC_T("UTF-8"));
+		rpWriter->write(expected);
+		rpWriter->close();
+
+		AutoPtr<FileDescriptor> rpFD = FileSystem::GetFileSystem()->openFile(utf8File.getPath(),
+			FileSystem::ReadAccess, FileSystem::OpenExisting, 0);
+		AutoPtr<Reader> rpReader = new InputStreamReader(new MappedFileInputStream(rpFD.get(), 4097), QC_T("UTF-8"));
+		String actual;
+		CharType buffer[100];
+		long count;
+		while((count = rpReader->read(buffer, 100)) != Reader::EndOfFile)
+		{
+			actual.append(buffer, count);
+		}
+		rpReader->close();
+		utf8File.deleteFile();
+		if(actual == expected) {testPassed(QC_T("mapped reader"));} else {testFailed(QC_T("mapped reader"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("mapped reader"));
+	}
+
+	//
+	// Access hints and drop-behind do not change the data read, and DirectIO
+	// reads of odd sizes return the whole file including its unaligned tail
+	//
+	try
+	{
+		File bigFile(QC_T("direct.out"));
+		const size_t fileLen = 0x500000 + 4321;
+		ByteArrayOutputStream expected;
+		AutoPtr<FileOutputStream> rpOut = new FileOutputStream(bigFile);
+		for(size_t i=0; i<fileLen; ++i)
+		{
+			expected.write(Byte(i % 253));
+		}
+		rpOut->write(expected.data(), fileLen);
+		rpOut->close();
+
+		bool bOK = true;
+		for(int opt=0; opt<2; ++opt)
+		{
+			AutoPtr<FileInputStream> rpIS = (opt == 0)
+				? new FileInputStream(bigFile)
+				: new FileInputStream(bigFile, FileInputStream::DirectIO);
+			if(opt == 0)
+			{
+				rpIS->advise(FileSystem::SequentialAccess);
+				rpIS->advise(FileSystem::WillNeed, 0, 0x10000);
+				rpIS->setDropBehind(true);
+				bOK = bOK && rpIS->isDropBehind();
+			}
+			ByteArrayOutputStream actual;
+			Byte buffer[5000];
+			long count;
+			while((count = rpIS->read(buffer, (actual.size() % 2) ? 17 : sizeof(buffer))) != InputStream::EndOfFile)
+			{
+				actual.write(buffer, count);
+			}
+			rpIS->close();
+			bOK = bOK && (actual.size() == fileLen)
+			          && ::memcmp(actual.data(), expected.data(), fileLen) == 0;
+		}
+		bigFile.deleteFile();
+		if(bOK) {testPassed(QC_T("direct read"));} else {testFailed(QC_T("direct read"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("direct read"));
+	}
+
 	testMessage(QC_T("End of tests for FileInputStream"));
 }
 
@@ -16,11 +16,16 @@ void goodCatch(const String& test, const String& eMsg);
 void uncaughtException(const String& e, const String& test);
 
 
+#include "QcCore/io/BufferedOutputStream.h"
+#include "QcCore/io/FileInputStream.h"
 #include "QcCore/io/FileOutputStream.h"
 #include "QcCore/io/File.h"
 #include "QcCore/io/IOException.h"
 #include "QcCore/io/FileNotFoundException.h"
 
+#include <vector>
+#include <string.h>
+
 using namespace qc::io;
 
 
@@ -155,6 +160,104 @@ void FileOutputStream_Tests()
 		uncaughtException(e.toString(), QC_T("delete"));
 	}
 
+	//
+	// Gather writes, both directly and through a BufferedOutputStream
+	// whose buffer is too small for the blocks
+	//
+	try
+	{
+		const Byte block1[2] = {4, 5};
+		const Byte block2[4] = {6, 7, 8, 9};
+		IoVec vecs[3];
+		vecs[0].pData = block1; vecs[0].length = 2;
+		vecs[1].pData = 0;      vecs[1].length = 0;
+		vecs[2].pData = block2; vecs[2].length = 4;
+
+		AutoPtr<FileOutputStream> rpFileOS = new FileOutputStream(testFile);
+		rpFileOS->write(buffer, 3);
+		rpFileOS->write(vecs, 3);
+		AutoPtr<BufferedOutputStream> rpBufOS = new BufferedOutputStream(rpFileOS.get(), 4);
+		rpBufOS->write(buffer, 3);
+		rpBufOS->write(vecs, 3);
+		rpBufOS->write(block2, 4);
+		rpBufOS->write(block1, 2);
+		rpBufOS->write(vecs, 3);
+		rpBufOS->close();
+
+		const Byte expected[] = {1,2,3,4,5,6,7,8,9, 1,2,3,4,5,6,7,8,9, 6,7,8,9, 4,5, 4,5,6,7,8,9};
+		AutoPtr<FileInputStream> rpFileIS = new FileInputStream(testFile);
+		bool bOK = true;
+		for(size_t i=0; bOK && i<sizeof(expected); ++i)
+		{
+			bOK = (rpFileIS->read() == expected[i]);
+		}
+		bOK = bOK && (rpFileIS->read() == InputStream::EndOfFile);
+		rpFileIS->close();
+		testFile.deleteFile();
+		if(bOK) {testPassed(QC_T("gather write"));} else {testFailed(QC_T("gather write"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("gather write"));
+	}
+
+	//
+	// DirectIO and drop-behind writes of a file whose length is not a
+	// multiple of the alignment, flushing part way through
+	//
+	try
+	{
+		const size_t fileLen = 0x300000 + 123;
+		std::vector<Byte> data(fileLen);
+		for(size_t i=0; i<fileLen; ++i)
+		{
+			data[i] = Byte(i % 251);
+		}
+
+		bool bOK = true;
+		for(int opt=0; opt<2; ++opt)
+		{
+			AutoPtr<FileOutputStream> rpFileOS = (opt == 0)
+				? new FileOutputStream(testFile, FileOutputStream::DirectIO)
+				: new FileOutputStream(testFile);
+			if(opt == 1)
+			{
+				rpFileOS->setDropBehind(true);
+			}
+			size_t pos = 0;
+			rpFileOS->write(&data[0], 1000); pos += 1000;
+			rpFileOS->flush();
+			bOK = bOK && (testFile.length() == 1000);
+			rpFileOS->write(&data[pos], 0x200000); pos += 0x200000;
+			rpFileOS->flush();
+			bOK = bOK && (testFile.length() == pos);
+			while(pos < fileLen)
+			{
+				const size_t len = (fileLen - pos < 7777) ? fileLen - pos : 7777;
+				rpFileOS->write(&data[pos], len);
+				pos += len;
+			}
+			rpFileOS->close();
+			bOK = bOK && (testFile.length() == fileLen);
+
+			AutoPtr<FileInputStream> rpFileIS = new FileInputStream(testFile, FileInputStream::DirectIO);
+			std::vector<Byte> readBack(fileLen + 1);
+			size_t total = 0;
+			long bytesRead;
+			while((bytesRead = rpFileIS->read(&readBack[total], readBack.size() - total)) > 0)
+			{
+				total += bytesRead;
+			}
+			rpFileIS->close();
+			bOK = bOK && (total == fileLen) && ::memcmp(&data[0], &readBack[0], fileLen) == 0;
+			testFile.deleteFile();
+		}
+		if(bOK) {testPassed(QC_T("direct write"));} else {testFailed(QC_T("direct write"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("direct write"));
+	}
 
 	testMessage(QC_T("End of tests for FileOutputStream"));
 }
@@ -2,6 +2,7 @@
 #include "QcCore/io/Console.h"
 #include "QcCore/base/Exception.h"
 #include "QcCore/base/StringUtils.h"
+#include "QcCore/base/Character.h"
 #include "QcCore/util/AttributeListParser.h"
 
 using namespace qc;
@@ -22,6 +23,7 @@ void uncaughtException(const String& e, const String& test);
 #include "QcCore/io/File.h"
 #include "QcCore/io/IOException.h"
 #include "QcCore/io/UnsupportedEncodingException.h"
+#include "QcCore/io/ByteArrayInputStream.h"
 #include "QcCore/base/NullPointerException.h"
 
 using namespace qc::io;
@@ -224,6 +226,93 @@ void InputStreamReader_Tests()
 	}
 
 
+	//
+	// UTF-8 decoding of long ASCII runs mixed with multi-byte sequences
+	//
+	try
+	{
+		String expected;
+		ByteString utf8;
+		for(int i=0; i<100; ++i)
+		{
+			utf8 += "abcdefghijklmnopqrstuvwxyz0123456789";
+			expected += QC_T("abcdefghijklmnopqrstuvwxyz0123456789");
+			utf8 += "\xC3\xA9\xE4\xB8\xAD";  // U+00E9 U+4E2D
+			expected += Character(0xE9).toString();
+			expected += Character(0x4E2D).toString();
+		}
+		AutoPtr<InputStreamReader> rpReader = new InputStreamReader(
+			new ByteArrayInputStream((const Byte*)utf8.data(), utf8.size()), QC_T("UTF-8"));
+		String result;
+		CharType chBuf[257];
+		long count;
+		while((count = rpReader->read(chBuf, sizeof(chBuf)/sizeof(CharType))) != Reader::EndOfFile)
+		{
+			result.append(chBuf, count);
+		}
+		if(result == expected) {testPassed(QC_T("decode UTF-8"));} else {testFailed(QC_T("decode UTF-8"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("decode UTF-8"));
+	}
+
+	//
+	// UTF-16LE decoding of long BMP runs mixed with surrogate pairs, with
+	// the encoding sensed from the byte order mark
+	//
+	try
+	{
+		String expected;
+		ByteString utf16;
+		utf16 += "\xFF\xFE";
+		for(int i=0; i<100; ++i)
+		{
+			for(int j=0; j<36; ++j)
+			{
+				const UCS4Char ch = (j % 4) ? 'a' + j : 0x4E2D;
+				utf16 += char(ch & 0xFF);
+				utf16 += char(ch >> 8);
+				expected += Character(ch).toString();
+			}
+			utf16.append("\x3D\xD8\x00\xDE", 4);  // U+1F600
+			expected += Character(0x1F600).toString();
+		}
+		AutoPtr<InputStream> rpBytes = new ByteArrayInputStream((const Byte*)utf16.data(), utf16.size());
+		size_t bomSize = 0;
+		String encoding = InputStreamReader::SenseEncoding(rpBytes.get(), bomSize);
+		if(encoding == QC_T("UTF-16LE") && bomSize == 2) {testPassed(QC_T("SenseEncoding"));} else {testFailed(QC_T("SenseEncoding"));}
+		rpBytes->skip(bomSize);
+		AutoPtr<InputStreamReader> rpReader = new InputStreamReader(rpBytes.get(), encoding);
+		String result;
+		CharType chBuf[257];
+		long count;
+		while((count = rpReader->read(chBuf, sizeof(chBuf)/sizeof(CharType))) != Reader::EndOfFile)
+		{
+			result.append(chBuf, count);
+		}
+		if(result == expected) {testPassed(QC_T("decode UTF-16"));} else {testFailed(QC_T("decode UTF-16"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("decode UTF-16"));
+	}
+
+	//
+	// A UTF-16 byte order mark is recognized in a stream of only 2 bytes
+	//
+	try
+	{
+		AutoPtr<InputStream> rpBytes = new ByteArrayInputStream((const Byte*)"\xFE\xFF", 2);
+		size_t bomSize = 0;
+		String encoding = InputStreamReader::SenseEncoding(rpBytes.get(), bomSize);
+		if(encoding == QC_T("UTF-16BE") && bomSize == 2) {testPassed(QC_T("SenseEncoding"));} else {testFailed(QC_T("SenseEncoding"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("SenseEncoding"));
+	}
+
 	testMessage(QC_T("End of tests for InputStreamReader"));
 }
 
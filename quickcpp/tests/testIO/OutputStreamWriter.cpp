@@ -2,6 +2,7 @@
 #include "QcCore/io/Console.h"
 #include "QcCore/base/Exception.h"
 #include "QcCore/base/StringUtils.h"
+#include "QcCore/base/Character.h"
 #include "QcCore/util/AttributeListParser.h"
 
 using namespace qc;
@@ -22,6 +23,7 @@ void uncaughtException(const String& e, const String& test);
 #include "QcCore/io/File.h"
 #include "QcCore/io/IOException.h"
 #include "QcCore/io/UnsupportedEncodingException.h"
+#include "QcCore/io/ByteArrayOutputStream.h"
 #include "QcCore/base/NullPointerException.h"
 
 using namespace qc::io;
@@ -150,6 +152,34 @@ void OutputStreamWriter_Tests()
 	}
 
 
+	//
+	// UTF-8 encoding of long ASCII runs mixed with multi-byte characters
+	//
+	try
+	{
+		String text;
+		ByteString expected;
+		for(int i=0; i<100; ++i)
+		{
+			text += QC_T("abcdefghijklmnopqrstuvwxyz0123456789");
+			expected += "abcdefghijklmnopqrstuvwxyz0123456789";
+			text += Character(0xE9).toString();
+			text += Character(0x4E2D).toString();
+			expected += "\xC3\xA9\xE4\xB8\xAD";  // U+00E9 U+4E2D
+		}
+		AutoPtr<ByteArrayOutputStream> rpBytes = new ByteArrayOutputStream;
+		AutoPtr<OutputStreamWriter> rpWriter = new OutputStreamWriter(rpBytes.get(), QC_T("UTF-8"));
+		rpWriter->write(text);
+		rpWriter->flush();
+		if(rpBytes->size() == expected.size() &&
+		   ::memcmp(rpBytes->data(), expected.data(), expected.size()) == 0)
+		{testPassed(QC_T("encode UTF-8"));} else {testFailed(QC_T("encode UTF-8"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("encode UTF-8"));
+	}
+
 	testMessage(QC_T("End of tests for OutputStreamWriter"));
 }
 
@@ -0,0 +1,305 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/Runnable.h"
+#include "QcCore/base/Thread.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/io/Pipe.h"
+
+#include <string.h>
+
+//
+// The byte expected at position pos of the test data
+//
+static Byte PatternByte(size_t pos)
+{
+	return Byte((pos * 7 + pos / 251) & 0xFF);
+}
+
+#ifdef QC_MT
+
+//
+// class: testPipeWriter
+//
+// Writes totalLen bytes of the test pattern to a PipeOutputStream, using
+// write() with varying lengths or acquireWrite()/commitWrite(), then closes
+// the stream.
+//
+class testPipeWriter : public Runnable
+{
+public:
+	testPipeWriter(PipeOutputStream* pOut, size_t totalLen, bool bZeroCopy) :
+		m_rpOut(pOut), m_totalLen(totalLen), m_bZeroCopy(bZeroCopy), m_bFailed(false) {}
+
+	virtual void run()
+	{
+		try
+		{
+			size_t pos = 0;
+			Byte buffer[1000];
+			while(pos < m_totalLen)
+			{
+				if(m_bZeroCopy)
+				{
+					size_t available;
+					Byte* pSpace = m_rpOut->acquireWrite(available);
+					size_t count = (m_totalLen - pos < available) ? m_totalLen - pos : available;
+					if(count > 1 && (pos & 1)) count /= 2;
+					for(size_t i=0; i<count; ++i)
+					{
+						pSpace[i] = PatternByte(pos+i);
+					}
+					m_rpOut->commitWrite(count);
+					pos += count;
+				}
+				else
+				{
+					size_t count = (pos % sizeof(buffer)) + 1;
+					if(count > m_totalLen - pos) count = m_totalLen - pos;
+					for(size_t i=0; i<count; ++i)
+					{
+						buffer[i] = PatternByte(pos+i);
+					}
+					m_rpOut->write(buffer, count);
+					pos += count;
+				}
+			}
+			m_rpOut->close();
+		}
+		catch(Exception& /*e*/)
+		{
+			m_bFailed = true;
+		}
+	}
+
+	bool failed() const {return m_bFailed;}
+
+private:
+	AutoPtr<PipeOutputStream> m_rpOut;
+	size_t m_totalLen;
+	bool m_bZeroCopy;
+	bool m_bFailed;
+};
+
+//
+// Reads a PipeInputStream to the end, using read() or readView(), and checks
+// that it returns the test pattern
+//
+static bool ReadPattern(PipeInputStream* pIn, size_t totalLen, bool bView)
+{
+	size_t pos = 0;
+	Byte buffer[777];
+	while(true)
+	{
+		const Byte* pData = buffer;
+		const long count = bView ? pIn->readView(pData, 5000)
+		                         : pIn->read(buffer, sizeof(buffer));
+		if(count == InputStream::EndOfFile)
+		{
+			break;
+		}
+		for(long i=0; i<count; ++i)
+		{
+			if(pData[i] != PatternByte(pos+i)) return false;
+		}
+		pos += count;
+	}
+	return pos == totalLen;
+}
+
+#endif //QC_MT
+
+void Pipe_Tests()
+{
+	testMessage(QC_T("Starting tests for Pipe"));
+
+	try
+	{
+		AutoPtr<Pipe> rpPipe = new Pipe(1000);
+		bool bOK = rpPipe->getCapacity() == 1024 &&
+		           rpPipe->getInputStream() == rpPipe->getInputStream();
+		if(bOK) {testPassed(QC_T("capacity"));} else {testFailed(QC_T("capacity"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("capacity"));
+	}
+
+	//
+	// Bytes that fit in the buffer can be written and read on one thread
+	//
+	try
+	{
+		AutoPtr<Pipe> rpPipe = new Pipe(64);
+		AutoPtr<PipeOutputStream> rpOut = rpPipe->getOutputStream();
+		AutoPtr<PipeInputStream> rpIn = rpPipe->getInputStream();
+
+		const char* pMessage = "abcdefghijklmnopqrstuvwxyz0123456789";
+		const size_t msgLen = strlen(pMessage);
+		rpOut->write((const Byte*)pMessage, msgLen);
+		bool bOK = rpIn->available() == msgLen;
+
+		Byte buffer[100];
+		long count = rpIn->read(buffer, 10);
+		bOK = bOK && count == 10 && memcmp(buffer, pMessage, 10) == 0;
+
+		//
+		// Wrap around the end of the buffer
+		//
+		rpOut->write((const Byte*)pMessage, msgLen);
+		count = rpIn->read(buffer, sizeof(buffer));
+		bOK = bOK && count == long(msgLen*2 - 10);
+		bOK = bOK && memcmp(buffer, pMessage+10, msgLen-10) == 0;
+		bOK = bOK && memcmp(buffer+msgLen-10, pMessage, msgLen) == 0;
+		bOK = bOK && rpIn->available() == 0;
+		if(bOK) {testPassed(QC_T("write/read"));} else {testFailed(QC_T("write/read"));}
+
+		//
+		// readView() holds the bytes until the next operation
+		//
+		rpOut->write((const Byte*)pMessage, msgLen);
+		const Byte* pData = 0;
+		count = rpIn->readView(pData, 5);
+		bOK = count == 5 && memcmp(pData, pMessage, 5) == 0 && rpIn->available() == msgLen-5;
+		size_t space = 0;
+		rpOut->acquireWrite(space);
+		bOK = bOK && space <= 64 - msgLen;
+		rpOut->commitWrite(0);
+		count = rpIn->read(buffer, sizeof(buffer));
+		bOK = bOK && count == long(msgLen-5) && memcmp(buffer, pMessage+5, msgLen-5) == 0;
+		if(bOK) {testPassed(QC_T("readView"));} else {testFailed(QC_T("readView"));}
+
+		//
+		// Closing the writer gives end of file after the remaining bytes
+		//
+		rpOut->write((const Byte*)"xyz", 3);
+		rpOut->close();
+		count = rpIn->read(buffer, sizeof(buffer));
+		bOK = count == 3 && rpIn->read(buffer, sizeof(buffer)) == InputStream::EndOfFile;
+		bOK = bOK && rpIn->read() == InputStream::EndOfFile;
+		if(bOK) {testPassed(QC_T("eof"));} else {testFailed(QC_T("eof"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("write/read"));
+	}
+
+	//
+	// Writing after the reader has closed fails
+	//
+	try
+	{
+		AutoPtr<Pipe> rpPipe = new Pipe(64);
+		rpPipe->getInputStream()->close();
+		rpPipe->getOutputStream()->write((const Byte*)"x", 1);
+		testFailed(QC_T("reader closed"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("reader closed"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("reader closed"));
+	}
+
+	try
+	{
+		AutoPtr<Pipe> rpPipe = new Pipe(64);
+		size_t space;
+		rpPipe->getOutputStream()->acquireWrite(space);
+		rpPipe->getOutputStream()->commitWrite(space+1);
+		testFailed(QC_T("commitWrite"));
+	}
+	catch(IllegalArgumentException& e)
+	{
+		goodCatch(QC_T("commitWrite"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("commitWrite"));
+	}
+
+#ifdef QC_MT
+	//
+	// Stream a few megabytes from a producer thread through a small pipe, so
+	// that both sides repeatedly wait for each other
+	//
+	for(int i=0; i<4; ++i)
+	{
+		const bool bZeroCopy = (i & 1) != 0;
+		const bool bView = (i & 2) != 0;
+		const String testName = String(QC_T("threads ")) + (bZeroCopy ? QC_T("acquireWrite") : QC_T("write"))
+		                      + (bView ? QC_T("/readView") : QC_T("/read"));
+		try
+		{
+			const size_t totalLen = 4000000;
+			AutoPtr<Pipe> rpPipe = new Pipe(4096);
+			AutoPtr<testPipeWriter> rpWriter = new testPipeWriter(rpPipe->getOutputStream().get(), totalLen, bZeroCopy);
+			AutoPtr<Thread> rpThread = new Thread(rpWriter.get());
+			rpThread->start();
+			bool bOK = ReadPattern(rpPipe->getInputStream().get(), totalLen, bView);
+			rpThread->join();
+			bOK = bOK && !rpWriter->failed();
+			if(bOK) {testPassed(testName);} else {testFailed(testName);}
+		}
+		catch(Exception& e)
+		{
+			uncaughtException(e.toString(), testName);
+		}
+	}
+
+	//
+	// Closing the reader wakes a writer that is waiting for space
+	//
+	try
+	{
+		AutoPtr<Pipe> rpPipe = new Pipe(64);
+		AutoPtr<testPipeWriter> rpWriter = new testPipeWriter(rpPipe->getOutputStream().get(), 1000, false);
+		AutoPtr<Thread> rpThread = new Thread(rpWriter.get());
+		rpThread->start();
+		Byte buffer[10];
+		rpPipe->getInputStream()->read(buffer, sizeof(buffer));
+		rpPipe->getInputStream()->close();
+		rpThread->join();
+		if(rpWriter->failed()) {testPassed(QC_T("wake writer"));} else {testFailed(QC_T("wake writer"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("wake writer"));
+	}
+#else
+	//
+	// With no other thread, reading from an empty pipe cannot block
+	//
+	try
+	{
+		AutoPtr<Pipe> rpPipe = new Pipe(64);
+		rpPipe->getInputStream()->read();
+		testFailed(QC_T("empty pipe"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("empty pipe"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("empty pipe"));
+	}
+#endif //QC_MT
+}
@@ -0,0 +1,333 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+
+
+#include "QcCore/io/File.h"
+#include "QcCore/io/FileNotFoundException.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/io/ParallelFileReader.h"
+#include "QcCore/io/RandomAccessFile.h"
+#include "QcCore/base/IllegalArgumentException.h"
+#include "QcCore/base/Monitor.h"
+#include "QcCore/base/Runnable.h"
+#include "QcCore/base/SynchronizedObject.h"
+#include "QcCore/base/ThreadPool.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace qc::io;
+
+//
+// A BlockHandler that checks each block against the pattern written
+// by the tests and counts the bytes it has been passed.
+//
+class PatternChecker : public ParallelFileReader::BlockHandler,
+                       public SynchronizedObject
+{
+public:
+	PatternChecker() : m_count(0), m_bOK(true) {}
+
+	virtual void processBlock(FileOffset offset, const Byte* pData, size_t length)
+	{
+		bool bOK = true;
+		for(size_t i=0; i<length; ++i)
+		{
+			bOK = bOK && (pData[i] == Byte((offset + i) % 251));
+		}
+		QC_SYNCHRONIZED
+		m_count += length;
+		m_bOK = m_bOK && bOK;
+	}
+
+	size_t m_count;
+	bool m_bOK;
+};
+
+//
+// A PatternChecker that throws something other than an Exception the first
+// time it is passed a block
+//
+class ThrowingChecker : public PatternChecker
+{
+public:
+	ThrowingChecker() : m_bThrown(false) {}
+
+	virtual void processBlock(FileOffset offset, const Byte* pData, size_t length)
+	{
+		// create a scope for the lock
+		{
+			QC_SYNCHRONIZED
+			if(!m_bThrown)
+			{
+				m_bThrown = true;
+				throw 42;
+			}
+		}
+		PatternChecker::processBlock(offset, pData, length);
+	}
+
+	bool m_bThrown;
+};
+
+#ifdef QC_MT
+
+//
+// class: testNestedReader
+//
+// Reads a file with a ParallelFileReader from a thread of the default
+// ThreadPool, and counts itself finished in a shared Monitor.
+//
+class testNestedReader : public Runnable
+{
+public:
+	testNestedReader(RandomAccessFile* pFile, size_t fileLen, Monitor* pDone,
+	                 size_t* pRemaining, bool* pFailed) :
+		m_rpFile(pFile), m_fileLen(fileLen), m_rpDone(pDone),
+		m_pRemaining(pRemaining), m_pFailed(pFailed) {}
+
+	virtual void run()
+	{
+		bool bOK = false;
+		try
+		{
+			ParallelFileReader reader(m_rpFile.get(), 4);
+			reader.setMinRangeSize(100000);
+			reader.setBlockSize(30000);
+			AutoPtr<PatternChecker> rpChecker = new PatternChecker;
+			reader.process(0, m_fileLen, rpChecker.get());
+			bOK = rpChecker->m_bOK && (rpChecker->m_count == m_fileLen);
+		}
+		catch(Exception& /*e*/)
+		{
+		}
+
+		QC_SYNCHRONIZED_PTR(m_rpDone.get())
+		if(!bOK) *m_pFailed = true;
+		if(--*m_pRemaining == 0) m_rpDone->notifyAll();
+	}
+
+private:
+	AutoPtr<RandomAccessFile> m_rpFile;
+	size_t m_fileLen;
+	AutoPtr<Monitor> m_rpDone;
+	size_t* m_pRemaining;
+	bool* m_pFailed;
+};
+
+#endif //QC_MT
+
+void RandomAccessFile_Tests()
+{
+	testMessage(QC_T("Starting tests for RandomAccessFile"));
+
+	File testFile(QC_T("test.raf"));
+
+	try
+	{
+		RandomAccessFile x(testFile, QC_T("w"));
+		testFailed(QC_T("bad mode"));
+	}
+	catch(IllegalArgumentException& e)
+	{
+		goodCatch(QC_T("bad mode"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("bad mode"));
+	}
+
+	try
+	{
+		RandomAccessFile x(testFile, QC_T("r"));
+		testFailed(QC_T("read missing file"));
+	}
+	catch(FileNotFoundException& e)
+	{
+		goodCatch(QC_T("read missing file"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("read missing file"));
+	}
+
+	//
+	// Write blocks out of order at explicit positions, then read
+	// them back both positionally and sequentially
+	//
+	try
+	{
+		AutoPtr<RandomAccessFile> rpFile = new RandomAccessFile(testFile, QC_T("rw"));
+		rpFile->allocate(0, 10);
+		const Byte block1[4] = {1, 2, 3, 4};
+		const Byte block2[6] = {5, 6, 7, 8, 9, 10};
+		rpFile->writeAt(4, block2, 6);
+		rpFile->writeAt(0, block1, 4);
+		rpFile->sync();
+
+		Byte buffer[10];
+		rpFile->readFullyAt(0, buffer, 10);
+		bool bOK = (rpFile->length() == 10) && (rpFile->getFilePointer() == 0);
+		for(size_t i=0; i<10; ++i)
+		{
+			bOK = bOK && (buffer[i] == i+1);
+		}
+		bOK = bOK && (rpFile->readAt(10, buffer, 10) == RandomAccessFile::EndOfFile);
+		rpFile->seek(8);
+		bOK = bOK && (rpFile->read(buffer, 10) == 2) && (buffer[0] == 9);
+		rpFile->setLength(5);
+		bOK = bOK && (rpFile->length() == 5) && (rpFile->readAt(2, buffer, 10) == 3);
+		rpFile->close();
+		if(bOK) {testPassed(QC_T("positional i/o"));} else {testFailed(QC_T("positional i/o"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("positional i/o"));
+	}
+
+	try
+	{
+		AutoPtr<RandomAccessFile> rpFile = new RandomAccessFile(testFile, QC_T("r"));
+		Byte buffer[10];
+		rpFile->readFullyAt(2, buffer, 10);
+		testFailed(QC_T("readFullyAt eof"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("readFullyAt eof"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("readFullyAt eof"));
+	}
+
+	//
+	// Offsets beyond 4GB must not be truncated, even where size_t is only
+	// 32 bits wide.  The file is sparse, so no disk space is used.
+	//
+	try
+	{
+		const FileOffset farPos = (FileOffset(1) << 32) + 16;
+		AutoPtr<RandomAccessFile> rpFile = new RandomAccessFile(testFile, QC_T("rw"));
+		const Byte block[4] = {1, 2, 3, 4};
+		rpFile->writeAt(farPos, block, 4);
+
+		Byte buffer[4] = {0};
+		rpFile->readFullyAt(farPos, buffer, 4);
+		bool bOK = (rpFile->length() == farPos + 4) && std::equal(block, block + 4, buffer);
+
+		ParallelFileReader reader(rpFile.get());
+		reader.read(farPos + 1, buffer, 3);
+		bOK = bOK && (buffer[0] == 2) && (buffer[2] == 4);
+
+		rpFile->seek(farPos + 2);
+		bOK = bOK && (rpFile->getFilePointer() == farPos + 2);
+		bOK = bOK && (rpFile->read(buffer, 4) == 2) && (buffer[0] == 3);
+
+		rpFile->setLength(0);
+		rpFile->close();
+		if(bOK) {testPassed(QC_T("offset beyond 4GB"));} else {testFailed(QC_T("offset beyond 4GB"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("offset beyond 4GB"));
+	}
+
+
+	//
+	// Read a large file in parallel ranges
+	//
+	try
+	{
+		const size_t fileLen = 1000000;
+		std::vector<Byte> data(fileLen);
+		for(size_t i=0; i<fileLen; ++i)
+		{
+			data[i] = Byte(i % 251);
+		}
+		AutoPtr<RandomAccessFile> rpFile = new RandomAccessFile(testFile, QC_T("rw"));
+		rpFile->setLength(0);
+		rpFile->writeAt(0, &data[0], fileLen);
+
+		ParallelFileReader reader(rpFile.get(), 4);
+		reader.setMinRangeSize(100000);
+		reader.setBlockSize(30000);
+
+		std::vector<Byte> result(fileLen - 7);
+		reader.read(7, &result[0], fileLen - 7);
+		bool bOK = std::equal(result.begin(), result.end(), data.begin() + 7);
+
+		AutoPtr<PatternChecker> rpChecker = new PatternChecker;
+		reader.process(3, FileOffset(-1), rpChecker.get());
+		bOK = bOK && rpChecker->m_bOK && (rpChecker->m_count == fileLen - 3);
+		if(bOK) {testPassed(QC_T("parallel read"));} else {testFailed(QC_T("parallel read"));}
+
+		try
+		{
+			reader.read(1, &result[0], fileLen);
+			testFailed(QC_T("parallel read eof"));
+		}
+		catch(IOException& e)
+		{
+			goodCatch(QC_T("parallel read eof"), e.toString());
+		}
+
+#ifdef QC_MT
+		//
+		// A range whose handler throws, even something that is not an
+		// Exception, is completed on the calling thread
+		//
+		AutoPtr<ThrowingChecker> rpThrower = new ThrowingChecker;
+		reader.process(0, fileLen, rpThrower.get());
+		if(rpThrower->m_bOK && rpThrower->m_count == fileLen) {testPassed(QC_T("parallel read throws"));} else {testFailed(QC_T("parallel read throws"));}
+
+		//
+		// Read from every thread of the default ThreadPool at once, so that
+		// no pooled thread is free to read their ranges
+		//
+		AutoPtr<Monitor> rpDone = new Monitor;
+		AutoPtr<ThreadPool> rpPool = ThreadPool::GetDefaultPool();
+		size_t remaining = rpPool->getThreadCount() * 2;
+		const size_t numTasks = remaining;
+		bool bFailed = false;
+		for(size_t i=0; i<numTasks; ++i)
+		{
+			rpPool->execute(new testNestedReader(rpFile.get(), fileLen, rpDone.get(), &remaining, &bFailed));
+		}
+		// create a scope for the lock
+		{
+			QC_SYNCHRONIZED_PTR(rpDone.get())
+			while(remaining)
+			{
+				rpDone->wait();
+			}
+		}
+		if(!bFailed) {testPassed(QC_T("nested parallel read"));} else {testFailed(QC_T("nested parallel read"));}
+#endif //QC_MT
+
+		rpFile->close();
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("parallel read"));
+	}
+
+	testFile.deleteFile();
+
+	testMessage(QC_T("End of tests for RandomAccessFile"));
+}
@@ -37,8 +37,17 @@ void uncaughtException(const String& e, const String& test);
 #include "QcCore/base/IllegalCharacterException.h"
 #include "QcCore/io/CharacterCodingException.h"
 #include "QcCore/io/MalformedInputException.h"
+#include "QcCore/io/TranscodingInputStream.h"
+#include "QcCore/io/TranscodingOutputStream.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+#include "QcCore/cvt/ParallelTranscoder.h"
+#include "QcCore/base/ArrayAutoPtr.h"
+#include "QcCore/base/Monitor.h"
+#include "QcCore/base/Runnable.h"
+#include "QcCore/base/ThreadPool.h"
 
 using namespace qc::io;
+using namespace qc::cvt;
 
 //
 // write a range of characters to a Writer
@@ -76,6 +85,28 @@ void genFile(const File& file, const String& enc, unsigned long firstChar, unsig
 	}
 }
 
+//
+// Helper function to compare the bytes from two InputStreams
+//
+bool sameBytes(InputStream* pIn1, InputStream* pIn2)
+{
+	Byte buffer1[1000];
+	Byte buffer2[1000];
+	long count;
+	while((count = pIn1->read(buffer1, sizeof(buffer1))) != InputStream::EndOfFile)
+	{
+		long total = 0;
+		while(total < count)
+		{
+			long rc = pIn2->read(buffer2+total, count-total);
+			if(rc == InputStream::EndOfFile) return false;
+			total += rc;
+		}
+		if(::memcmp(buffer1, buffer2, count) != 0) return false;
+	}
+	return (pIn2->read() == InputStream::EndOfFile);
+}
+
 //
 // Helper function to check that all methods return the correct value
 // when  a character stream is at EOF
@@ -596,6 +627,100 @@ void testClosedOps(Writer* pWriter)
 }
 
 
+#ifdef QC_MT
+
+//
+// class: testNestedTranscode
+//
+// Converts a buffer with a ParallelTranscoder from a thread of the default
+// ThreadPool, and counts itself finished in a shared Monitor.
+//
+class testNestedTranscode : public Runnable
+{
+public:
+	testNestedTranscode(const ByteString& input, const ByteString& expected,
+	                    Monitor* pDone, size_t* pRemaining, bool* pFailed) :
+		m_input(input), m_expected(expected), m_rpDone(pDone),
+		m_pRemaining(pRemaining), m_pFailed(pFailed) {}
+
+	virtual void run()
+	{
+		bool bOK = false;
+		try
+		{
+			AutoPtr<ParallelTranscoder> rpTranscoder = new ParallelTranscoder(
+				CodeConverterFactory::GetInstance().getConverter(QC_T("utf-8")).get(),
+				CodeConverterFactory::GetInstance().getConverter(QC_T("utf-16le")).get(), 4);
+			rpTranscoder->setMinChunkSize(1000);
+			size_t len;
+			const Byte* pFrom = (const Byte*)m_input.data();
+			ArrayAutoPtr<Byte> apResult = rpTranscoder->transcode(pFrom, pFrom + m_input.size(), len);
+			bOK = (ByteString((const char*)apResult.get(), len) == m_expected);
+		}
+		catch(Exception& /*e*/)
+		{
+		}
+
+		QC_SYNCHRONIZED_PTR(m_rpDone.get())
+		if(!bOK) *m_pFailed = true;
+		if(--*m_pRemaining == 0) m_rpDone->notifyAll();
+	}
+
+private:
+	ByteString m_input;
+	ByteString m_expected;
+	AutoPtr<Monitor> m_rpDone;
+	size_t* m_pRemaining;
+	bool* m_pFailed;
+};
+
+//
+// Runs ParallelTranscoders on every thread of the default ThreadPool at once,
+// so that no pooled thread is free to convert their chunks.
+//
+static void testNestedParallelTranscode()
+{
+	try
+	{
+		ByteString input;
+		while(input.size() < 100000)
+		{
+			input += "h\xC3\xA9llo w\xE2\x82\xACrld \xF0\x9F\x98\x80 ";
+		}
+
+		AutoPtr<ParallelTranscoder> rpSerial = new ParallelTranscoder(
+			CodeConverterFactory::GetInstance().getConverter(QC_T("utf-8")).get(),
+			CodeConverterFactory::GetInstance().getConverter(QC_T("utf-16le")).get(), 1);
+		size_t len;
+		ArrayAutoPtr<Byte> apExpected = rpSerial->transcode((const Byte*)input.data(),
+			(const Byte*)input.data() + input.size(), len);
+		const ByteString expected((const char*)apExpected.get(), len);
+
+		AutoPtr<Monitor> rpDone = new Monitor;
+		AutoPtr<ThreadPool> rpPool = ThreadPool::GetDefaultPool();
+		size_t remaining = rpPool->getThreadCount() * 2;
+		const size_t numTasks = remaining;
+		bool bFailed = false;
+		for(size_t i=0; i<numTasks; ++i)
+		{
+			rpPool->execute(new testNestedTranscode(input, expected, rpDone.get(), &remaining, &bFailed));
+		}
+
+		QC_SYNCHRONIZED_PTR(rpDone.get())
+		while(remaining)
+		{
+			rpDone->wait();
+		}
+		if(!bFailed) {testPassed(QC_T("nested parallel transcode"));} else {testFailed(QC_T("nested parallel transcode"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("nested parallel transcode"));
+	}
+}
+
+#endif //QC_MT
+
 void Stream_Tests()
 {
 	testMessage(QC_T("Starting tests for Stream"));
@@ -617,6 +742,73 @@ void Stream_Tests()
 	genFile(iso88591, QC_T("iso-8859-1"), 1, 0x00FEUL);
 	testFileContents(iso88591, QC_T("iso-8859-1"), 1, 0x00FEUL);
 
+	//
+	// transcode the utf-8 file into utf-16le using both transcoding streams
+	// and compare the result with a file written by an OutputStreamWriter
+	//
+	File utf16le(QC_T("test_utf16le"));
+	genFile(utf16le, QC_T("utf-16le"), 1, 0x10FFFFUL);
+	try
+	{
+		AutoPtr<InputStream> rpTranscoded = new TranscodingInputStream(
+			new FileInputStream(utf8), QC_T("utf-8"), QC_T("utf-16le"));
+		AutoPtr<InputStream> rpExpected = new FileInputStream(utf16le);
+		if(sameBytes(rpTranscoded.get(), rpExpected.get())) {testPassed(QC_T("transcode input"));} else {testFailed(QC_T("transcode input"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transcode input"));
+	}
+	try
+	{
+		File transcoded(QC_T("test_transcoded"));
+		AutoPtr<OutputStream> rpOS = new TranscodingOutputStream(
+			new FileOutputStream(transcoded), QC_T("utf-8"), QC_T("utf-16le"));
+		AutoPtr<InputStream> rpIS = new FileInputStream(utf8);
+		Byte buffer[999];
+		long count;
+		while((count = rpIS->read(buffer, sizeof(buffer))) != InputStream::EndOfFile)
+		{
+			rpOS->write(buffer, count);
+		}
+		rpIS->close();
+		rpOS->close();
+		AutoPtr<InputStream> rpTranscoded = new FileInputStream(transcoded);
+		AutoPtr<InputStream> rpExpected = new FileInputStream(utf16le);
+		if(sameBytes(rpTranscoded.get(), rpExpected.get())) {testPassed(QC_T("transcode output"));} else {testFailed(QC_T("transcode output"));}
+		rpTranscoded->close();
+		transcoded.deleteFile();
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transcode output"));
+	}
+	try
+	{
+		File transcoded(QC_T("test_transcoded"));
+		AutoPtr<ParallelTranscoder> rpTranscoder = new ParallelTranscoder(
+			CodeConverterFactory::GetInstance().getConverter(QC_T("utf-8")).get(),
+			CodeConverterFactory::GetInstance().getConverter(QC_T("utf-16le")).get(), 4);
+		rpTranscoder->setMinChunkSize(1000);
+		AutoPtr<InputStream> rpIS = new FileInputStream(utf8);
+		AutoPtr<OutputStream> rpOS = new FileOutputStream(transcoded);
+		rpTranscoder->transcode(rpIS.get(), rpOS.get());
+		rpIS->close();
+		rpOS->close();
+		AutoPtr<InputStream> rpTranscoded = new FileInputStream(transcoded);
+		AutoPtr<InputStream> rpExpected = new FileInputStream(utf16le);
+		if(sameBytes(rpTranscoded.get(), rpExpected.get())) {testPassed(QC_T("parallel transcode"));} else {testFailed(QC_T("parallel transcode"));}
+		rpTranscoded->close();
+		transcoded.deleteFile();
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("parallel transcode"));
+	}
+#ifdef QC_MT
+	testNestedParallelTranscode();
+#endif //QC_MT
+
 	//
 	// test ability to write illegal surrogate value
 	// with strict turned on and then off
@@ -1225,6 +1417,14 @@ void Stream_Tests()
 	{
 		uncaughtException(e.toString(), QC_T("deleteFile"));
 	}
+	try
+	{
+		utf16le.deleteFile(); testPassed(QC_T("deleteFile"));
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("deleteFile"));
+	}
 
 	//
 	// Test atomic operations
@@ -0,0 +1,355 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+#include "QcCore/cvt/CodeConverter.h"
+#include "QcCore/cvt/CodeConverterFactory.h"
+#include "QcCore/cvt/Transcoder.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/io/InputStreamReader.h"
+#include "QcCore/io/MalformedInputException.h"
+#include "QcCore/io/OutputStreamWriter.h"
+#include "QcCore/io/UnmappableCharacterException.h"
+
+#include <vector>
+
+using namespace qc::cvt;
+
+static AutoPtr<CodeConverter> GetConverter(const String& encoding)
+{
+	return CodeConverterFactory::GetInstance().getConverter(encoding);
+}
+
+//
+// Converts the input with an InputStreamReader and an OutputStreamWriter,
+// giving the result that a Transcoder must reproduce
+//
+static ByteString ReferenceTranscode(const ByteString& input, const String& from, const String& to)
+{
+	AutoPtr<Reader> rpReader = new InputStreamReader(
+		new ByteArrayInputStream((const Byte*)input.data(), input.size()), from);
+	AutoPtr<ByteArrayOutputStream> rpBytes = new ByteArrayOutputStream;
+	AutoPtr<Writer> rpWriter = new OutputStreamWriter(rpBytes.get(), to);
+
+	CharType buffer[256];
+	long count;
+	while((count = rpReader->read(buffer, 256)) != Reader::EndOfFile)
+	{
+		rpWriter->write(buffer, count);
+	}
+	rpWriter->flush();
+	return rpBytes->toByteString();
+}
+
+//
+// Converts the input offering at most inSize bytes of input and outSize
+// bytes of output to each call, so that the specialized loops are stopped
+// by the ends of both buffers.  An incomplete sequence is passed to
+// endOfInput() once the input is exhausted.
+//
+static ByteString TranscodeAll(Transcoder* pTranscoder, const ByteString& input,
+                               size_t inSize, size_t outSize)
+{
+	ByteString ret;
+	std::vector<Byte> out(outSize);
+	const Byte* pNext = (const Byte*)input.data();
+	const Byte* pEnd = pNext + input.size();
+	size_t window = inSize;
+	size_t stalls = 0;
+
+	while(pNext < pEnd && stalls < 2)
+	{
+		const Byte* pWindowEnd = (size_t(pEnd - pNext) > window) ? pNext + window : pEnd;
+		const Byte* pFromNext;
+		Byte* pToNext;
+		const Transcoder::Result result = pTranscoder->transcode(pNext, pWindowEnd, pFromNext,
+		                                                         &out[0], &out[0] + outSize, pToNext);
+		ret.append((const char*)&out[0], pToNext - &out[0]);
+
+		if(pFromNext > pNext || pToNext > &out[0])
+		{
+			window = inSize;
+			stalls = 0;
+		}
+		else if(result == CodeConverter::inputExhausted && pWindowEnd < pEnd)
+		{
+			window += inSize;
+		}
+		else if(result == CodeConverter::inputExhausted)
+		{
+			pTranscoder->endOfInput(pFromNext, pEnd);
+			pFromNext = pEnd;
+		}
+		else
+		{
+			++stalls;
+		}
+		pNext = pFromNext;
+	}
+
+	while(pTranscoder->hasPendingOutput() && stalls < 2)
+	{
+		Byte* pToNext;
+		pTranscoder->flush(&out[0], &out[0] + outSize, pToNext);
+		ret.append((const char*)&out[0], pToNext - &out[0]);
+		stalls = (pToNext > &out[0]) ? 0 : stalls + 1;
+	}
+	return ret;
+}
+
+//
+// Compares a Transcoder with the reference for a range of buffer sizes
+//
+static void TestPair(const ByteString& input, const String& from, const String& to,
+                     const String& testName)
+{
+	try
+	{
+		const ByteString expected = ReferenceTranscode(input, from, to);
+		const size_t inSizes[] = {1, 3, 17, 1000, input.size()};
+		const size_t outSizes[] = {4, 7, 64, 4 * input.size() + 16};
+
+		AutoPtr<Transcoder> rpPrototype = new Transcoder(GetConverter(from).get(), GetConverter(to).get());
+		bool bOK = true;
+		for(size_t i=0; i<sizeof(inSizes)/sizeof(inSizes[0]); ++i)
+		{
+			for(size_t j=0; j<sizeof(outSizes)/sizeof(outSizes[0]); ++j)
+			{
+				AutoPtr<Transcoder> rpTranscoder = rpPrototype->clone();
+				bOK = bOK && TranscodeAll(rpTranscoder.get(), input, inSizes[i], outSizes[j]) == expected;
+			}
+		}
+		if(bOK) {testPassed(testName);} else {testFailed(testName);}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), testName);
+	}
+}
+
+//
+// Builds single-byte input containing every byte value, with ASCII runs
+// long enough to be copied a block at a time
+//
+static ByteString SingleByteInput()
+{
+	ByteString ret;
+	for(size_t i=0; i<256; ++i)
+	{
+		ret += char(i);
+		ret.append(i % 41, char('a' + i % 26));
+	}
+	return ret;
+}
+
+//
+// Builds UTF-8 input with sequences of every length, characters that
+// windows-1252 cannot encode and ill-formed sequences
+//
+static ByteString UTF8Input()
+{
+	static const char* const Pieces[] =
+	{
+		"\xC3\xA9",          // U+00E9, in windows-1252
+		"\xE2\x82\xAC",      // U+20AC, in windows-1252 as 0x80
+		"\xE4\xB8\xAD",      // U+4E2D, unmappable
+		"\xF0\x9F\x98\x80",  // U+1F600, unmappable
+		"\xFF",              // never valid
+		"\xC0\x80",          // overlong
+		"\xED\xA0\x80",      // surrogate
+		"\x80",              // lone continuation byte
+		"\xE2\x82",          // truncated
+		"\xC2\xA0\xC2\xBF",  // U+00A0 U+00BF
+	};
+	const size_t numPieces = sizeof(Pieces)/sizeof(Pieces[0]);
+
+	ByteString ret;
+	for(size_t i=0; i<200; ++i)
+	{
+		ret.append((i * 7) % 37, char('A' + i % 26));
+		ret += Pieces[i % numPieces];
+	}
+	ret += "end";
+	return ret;
+}
+
+static void TestKernels()
+{
+	const ByteString singleByte = SingleByteInput();
+	const ByteString utf8 = UTF8Input();
+
+	TestPair(singleByte, QC_T("windows-1252"), QC_T("ISO-8859-1"), QC_T("transcode byteToByte"));
+	TestPair(singleByte, QC_T("windows-1252"), QC_T("windows-1253"), QC_T("transcode byteToByte unmappable"));
+	TestPair(singleByte, QC_T("windows-1252"), QC_T("UTF-8"), QC_T("transcode byteToUTF8"));
+	TestPair(singleByte, QC_T("IBM850"), QC_T("UTF-8"), QC_T("transcode byteToUTF8 IBM850"));
+	TestPair(utf8, QC_T("UTF-8"), QC_T("windows-1252"), QC_T("transcode utf8ToByte"));
+	TestPair(utf8, QC_T("UTF-8"), QC_T("ISO-8859-1"), QC_T("transcode utf8ToByte ISO-8859-1"));
+	TestPair(utf8, QC_T("UTF-8"), QC_T("UTF-16BE"), QC_T("transcode utf8ToUTF16"));
+}
+
+static void TestRecovery()
+{
+	//
+	// The replacement characters of both converters are used
+	//
+	try
+	{
+		AutoPtr<CodeConverter> rpDecoder = GetConverter(QC_T("UTF-8"));
+		AutoPtr<CodeConverter> rpEncoder = GetConverter(QC_T("windows-1252"));
+		rpDecoder->setInvalidCharAction(CodeConverter::replace);
+		rpDecoder->setInvalidCharReplacement('?');
+		rpEncoder->setUnmappableCharAction(CodeConverter::replace);
+		rpEncoder->setUnmappableCharReplacement('#');
+		AutoPtr<Transcoder> rpTranscoder = new Transcoder(rpDecoder.get(), rpEncoder.get());
+
+		const ByteString prefix(40, 'x');
+		const ByteString input = prefix + "a\xFF" "b\xE4\xB8\xAD" "c\xE2\x82\xAC" + prefix + "\xFF\xE4\xB8\xAD" "d";
+		const ByteString expected = prefix + "a?b#c\x80" + prefix + "?#d";
+		bool bOK = TranscodeAll(rpTranscoder.get(), input, input.size(), 1000) == expected;
+		if(bOK) {testPassed(QC_T("transcode replace"));} else {testFailed(QC_T("transcode replace"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transcode replace"));
+	}
+
+	//
+	// With an abort policy the bytes before the error are returned first,
+	// and the exception is thrown by the next call.  The ASCII prefix
+	// means that the error is found by the specialized loop.
+	//
+	for(int unmappable=0; unmappable<2; ++unmappable)
+	{
+		const String testName = unmappable ? QC_T("transcode abort unmappable")
+		                                   : QC_T("transcode abort invalid");
+		try
+		{
+			AutoPtr<CodeConverter> rpDecoder = GetConverter(QC_T("UTF-8"));
+			AutoPtr<CodeConverter> rpEncoder = GetConverter(QC_T("windows-1252"));
+			rpDecoder->setInvalidCharAction(CodeConverter::abort);
+			rpEncoder->setUnmappableCharAction(CodeConverter::abort);
+			AutoPtr<Transcoder> rpTranscoder = new Transcoder(rpDecoder.get(), rpEncoder.get());
+
+			const ByteString prefix(40, 'x');
+			const ByteString input = prefix + (unmappable ? "\xE4\xB8\xAD" : "\xFF") + "tail";
+			Byte out[100];
+			const Byte* pFrom = (const Byte*)input.data();
+			const Byte* pFromNext;
+			Byte* pToNext;
+			bool bOK = rpTranscoder->transcode(pFrom, pFrom + input.size(), pFromNext,
+			                                   out, out+100, pToNext) == CodeConverter::error
+			        && ByteString((const char*)out, pToNext-out) == prefix;
+			if(!bOK)
+			{
+				testFailed(testName);
+			}
+			else
+			{
+				rpTranscoder->transcode(pFromNext, pFrom + input.size(), pFromNext,
+				                        out, out+100, pToNext);
+				testFailed(testName);
+			}
+		}
+		catch(MalformedInputException& e)
+		{
+			if(!unmappable) {goodCatch(testName, e.toString());} else {uncaughtException(e.toString(), testName);}
+		}
+		catch(UnmappableCharacterException& e)
+		{
+			if(unmappable) {goodCatch(testName, e.toString());} else {uncaughtException(e.toString(), testName);}
+		}
+		catch(Exception& e)
+		{
+			uncaughtException(e.toString(), testName);
+		}
+	}
+
+	//
+	// Characters that are decoded but do not fit are held until the next
+	// call
+	//
+	try
+	{
+		AutoPtr<Transcoder> rpTranscoder = new Transcoder(GetConverter(QC_T("windows-1252")).get(),
+		                                                  GetConverter(QC_T("UTF-8")).get());
+		const ByteString input("a\xE9\x80");
+		Byte out[8];
+		const Byte* pFrom = (const Byte*)input.data();
+		const Byte* pFromNext;
+		Byte* pToNext;
+		bool bOK = rpTranscoder->transcode(pFrom, pFrom + input.size(), pFromNext,
+		                                   out, out+2, pToNext) == CodeConverter::outputExhausted
+		        && pFromNext == pFrom + input.size()
+		        && ByteString((const char*)out, pToNext-out) == ByteString("a")
+		        && rpTranscoder->hasPendingOutput();
+		bOK = bOK && rpTranscoder->flush(out, out+2, pToNext) == CodeConverter::outputExhausted
+		          && ByteString((const char*)out, pToNext-out) == ByteString("\xC3\xA9")
+		          && rpTranscoder->hasPendingOutput();
+		bOK = bOK && rpTranscoder->flush(out, out+8, pToNext) == CodeConverter::ok
+		          && ByteString((const char*)out, pToNext-out) == ByteString("\xE2\x82\xAC")
+		          && !rpTranscoder->hasPendingOutput();
+		if(bOK) {testPassed(QC_T("transcode pending"));} else {testFailed(QC_T("transcode pending"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transcode pending"));
+	}
+
+	//
+	// An incomplete sequence at the end of the input
+	//
+	try
+	{
+		AutoPtr<CodeConverter> rpDecoder = GetConverter(QC_T("UTF-8"));
+		rpDecoder->setInvalidCharAction(CodeConverter::replace);
+		rpDecoder->setInvalidCharReplacement('?');
+		AutoPtr<Transcoder> rpTranscoder = new Transcoder(rpDecoder.get(), GetConverter(QC_T("windows-1252")).get());
+		const ByteString input("ab\xE2\x82");
+		Byte out[8];
+		const Byte* pFrom = (const Byte*)input.data();
+		const Byte* pFromNext;
+		Byte* pToNext;
+		bool bOK = rpTranscoder->transcode(pFrom, pFrom + input.size(), pFromNext,
+		                                   out, out+8, pToNext) == CodeConverter::inputExhausted
+		        && pFromNext == pFrom + 2
+		        && ByteString((const char*)out, pToNext-out) == ByteString("ab");
+		rpTranscoder->endOfInput(pFromNext, pFrom + input.size());
+		bOK = bOK && rpTranscoder->hasPendingOutput()
+		          && rpTranscoder->flush(out, out+8, pToNext) == CodeConverter::ok
+		          && ByteString((const char*)out, pToNext-out) == ByteString("?");
+		if(bOK) {testPassed(QC_T("transcode truncated"));} else {testFailed(QC_T("transcode truncated"));}
+
+		rpDecoder->setInvalidCharAction(CodeConverter::abort);
+		rpTranscoder->endOfInput(pFromNext, pFrom + input.size());
+		testFailed(QC_T("transcode truncated abort"));
+	}
+	catch(MalformedInputException& e)
+	{
+		goodCatch(QC_T("transcode truncated abort"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transcode truncated"));
+	}
+}
+
+void Transcoder_Tests()
+{
+	testMessage(QC_T("Starting tests for Transcoder"));
+
+	TestKernels();
+	TestRecovery();
+}
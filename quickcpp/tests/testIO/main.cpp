@@ -24,6 +24,15 @@ void OutputStreamWriter_Tests();
 void Stream_Tests();
 void BufferedInputStream_Tests();
 void BufferedReader_Tests();
+void RandomAccessFile_Tests();
+void ByteArrayOutputStream_Tests();
+void DirectoryWalker_Tests();
+void AsyncFileOutputStream_Tests();
+void Pipe_Tests();
+void CheckedStream_Tests();
+void CodeConverter_Tests();
+void CodeConverterFactory_Tests();
+void Transcoder_Tests();
 
 
 #include "QcCore/base/System.h"
@@ -123,6 +132,15 @@ int main(int argc, char* argv[])
 		Stream_Tests();
 		BufferedInputStream_Tests();
 		BufferedReader_Tests();
+		RandomAccessFile_Tests();
+		ByteArrayOutputStream_Tests();
+		DirectoryWalker_Tests();
+		AsyncFileOutputStream_Tests();
+		Pipe_Tests();
+		CheckedStream_Tests();
+		CodeConverter_Tests();
+		CodeConverterFactory_Tests();
+		Transcoder_Tests();
 	}
 	catch(Exception& e)
 	{
@@ -0,0 +1,323 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/base/Monitor.h"
+#include "QcCore/io/File.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/io/RandomAccessFile.h"
+#include "QcCore/net/AsyncIOEngine.h"
+#include "QcCore/net/InetAddress.h"
+#include "QcCore/net/ServerSocket.h"
+#include "QcCore/net/Socket.h"
+#include "QcCore/net/SocketException.h"
+#include "QcCore/net/ThreadPoolIOEngine.h"
+#include "QcCore/net/UringIOEngine.h"
+
+#include <string.h>
+
+using namespace qc::net;
+
+//
+// A Handler that counts the operations it is told about
+//
+class CountingHandler : public AsyncIOEngine::Handler, public Monitor
+{
+public:
+	CountingHandler() : m_count(0), m_bytes(0) {}
+
+	virtual void operationCompleted(AsyncIOEngine::Operation* pOperation)
+	{
+		QC_SYNCHRONIZED
+		++m_count;
+		m_bytes += pOperation->getResult();
+#ifdef QC_MT
+		notifyAll();
+#endif //QC_MT
+	}
+
+	bool waitFor(size_t count)
+	{
+		QC_SYNCHRONIZED
+#ifdef QC_MT
+		for(int i=0; i<100 && m_count < count; ++i)
+		{
+			wait(100);
+		}
+#endif //QC_MT
+		return m_count == count;
+	}
+
+	size_t getBytes()
+	{
+		QC_SYNCHRONIZED
+		return m_bytes;
+	}
+
+private:
+	size_t m_count;
+	size_t m_bytes;
+};
+
+//
+// Runs the tests against one engine
+//
+static void TestEngine(AsyncIOEngine* pEngine)
+{
+	const String name = pEngine->getName();
+	testMessage(String(QC_T("Testing engine: ")) + name);
+
+	//
+	// Write two blocks with one submission, then read them back in the
+	// opposite order
+	//
+	try
+	{
+		File file(QC_T("asyncio.out"));
+		AutoPtr<RandomAccessFile> rpFile = new RandomAccessFile(file, QC_T("rw"));
+		rpFile->setLength(0);
+		AutoPtr<FileDescriptor> rpFD = rpFile->getFD();
+
+		const size_t blockSize = 8192;
+		Byte block1[blockSize];
+		Byte block2[blockSize];
+		memset(block1, 'a', blockSize);
+		memset(block2, 'b', blockSize);
+
+		AutoPtr<AsyncIOEngine::Operation> rpWrite1 = pEngine->write(rpFD.get(), 0, block1, blockSize);
+		AutoPtr<AsyncIOEngine::Operation> rpWrite2 = pEngine->write(rpFD.get(), blockSize, block2, blockSize);
+		pEngine->submit();
+		bool bOK = (rpWrite1->get() == blockSize && rpWrite2->get() == blockSize);
+
+		Byte read1[blockSize];
+		Byte read2[blockSize];
+		AutoPtr<AsyncIOEngine::Operation> rpRead2 = pEngine->read(rpFD.get(), blockSize, read2, blockSize);
+		AutoPtr<AsyncIOEngine::Operation> rpRead1 = pEngine->read(rpFD.get(), 0, read1, blockSize);
+		pEngine->submit();
+		bOK = bOK && rpRead1->get() == blockSize && rpRead2->get() == blockSize;
+		bOK = bOK && memcmp(read1, block1, blockSize) == 0 && memcmp(read2, block2, blockSize) == 0;
+		bOK = bOK && rpRead1->getType() == AsyncIOEngine::Operation::Read;
+		if(bOK) {testPassed(name + QC_T(" read/write"));} else {testFailed(name + QC_T(" read/write"));}
+
+		//
+		// A read past the end of the file transfers nothing
+		//
+		AutoPtr<AsyncIOEngine::Operation> rpEOF = pEngine->read(rpFD.get(), blockSize*2, read1, blockSize);
+		if(rpEOF->get() == 0) {testPassed(name + QC_T(" read eof"));} else {testFailed(name + QC_T(" read eof"));}
+
+		//
+		// Handlers are called for each operation
+		//
+		AutoPtr<CountingHandler> rpHandler = new CountingHandler;
+		for(size_t i=0; i<16; ++i)
+		{
+			pEngine->read(rpFD.get(), i*1024, read1 + (i%8)*1024, 1024, rpHandler.get());
+		}
+		pEngine->submit();
+		if(rpHandler->waitFor(16) && rpHandler->getBytes() == 16*1024) {testPassed(name + QC_T(" handler"));} else {testFailed(name + QC_T(" handler"));}
+
+		rpFile->close();
+		file.deleteFile();
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), name + QC_T(" file"));
+	}
+
+	//
+	// Accept and connect over the loopback interface, then exchange data
+	//
+	try
+	{
+		AutoPtr<InetAddress> rpLoopback = InetAddress::GetByName(QC_T("127.0.0.1"));
+		AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, rpLoopback.get());
+
+		AutoPtr<AsyncIOEngine::Operation> rpAccept = pEngine->accept(rpServer->getSocketDescriptor().get());
+		AutoPtr<AsyncIOEngine::Operation> rpConnect = pEngine->connect(rpLoopback.get(), rpServer->getLocalPort());
+		pEngine->submit();
+		rpConnect->get();
+		rpAccept->get();
+
+		AutoPtr<SocketDescriptor> rpClient = rpConnect->getSocketDescriptor();
+		AutoPtr<SocketDescriptor> rpPeer = rpAccept->getSocketDescriptor();
+		bool bOK = rpClient && rpPeer && rpAccept->getInetAddress() &&
+		           rpAccept->getInetAddress()->equals(*rpLoopback);
+		if(bOK) {testPassed(name + QC_T(" accept/connect"));} else {testFailed(name + QC_T(" accept/connect"));}
+
+		const char* pMessage = "hello, asynchronous world";
+		const size_t msgLen = strlen(pMessage);
+		Byte buffer[100];
+		AutoPtr<AsyncIOEngine::Operation> rpReceive = pEngine->receive(rpPeer.get(), buffer, sizeof(buffer));
+		AutoPtr<AsyncIOEngine::Operation> rpSend = pEngine->send(rpClient.get(), (const Byte*)pMessage, msgLen);
+		pEngine->submit();
+		bOK = rpSend->get() == msgLen;
+		size_t received = rpReceive->get();
+		while(bOK && received < msgLen && received != 0)
+		{
+			AutoPtr<AsyncIOEngine::Operation> rpMore = pEngine->receive(rpPeer.get(), buffer+received, sizeof(buffer)-received);
+			const size_t count = rpMore->get();
+			if(count == 0) break;
+			received += count;
+		}
+		bOK = bOK && received == msgLen && memcmp(buffer, pMessage, msgLen) == 0;
+		if(bOK) {testPassed(name + QC_T(" send/receive"));} else {testFailed(name + QC_T(" send/receive"));}
+
+		//
+		// A receive waits until data arrives or the connection is closed
+		//
+		AutoPtr<AsyncIOEngine::Operation> rpPending = pEngine->receive(rpPeer.get(), buffer, sizeof(buffer));
+		pEngine->submit();
+		if(!rpPending->waitFor(50)) {testPassed(name + QC_T(" pending"));} else {testFailed(name + QC_T(" pending"));}
+
+		rpClient->close();
+		rpPending->waitFor(5000);
+		if(rpPending->isDone()) {testPassed(name + QC_T(" receive eof"));} else {testFailed(name + QC_T(" receive eof"));}
+		rpPeer->close();
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), name + QC_T(" socket"));
+	}
+
+	//
+	// Connecting to a port with no listener fails
+	//
+	try
+	{
+		AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, InetAddress::GetByName(QC_T("127.0.0.1")).get());
+		const int port = rpServer->getLocalPort();
+		rpServer->close();
+		AutoPtr<AsyncIOEngine::Operation> rpConnect = pEngine->connect(InetAddress::GetByName(QC_T("127.0.0.1")).get(), port);
+		rpConnect->get();
+		testFailed(name + QC_T(" connect refused"));
+	}
+	catch(SocketException& e)
+	{
+		goodCatch(name + QC_T(" connect refused"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), name + QC_T(" connect refused"));
+	}
+
+	//
+	// Operations submitted after shutdown are cancelled
+	//
+	try
+	{
+		pEngine->shutdown();
+		Byte buffer[10];
+		File file(QC_T("asyncio.out"));
+		AutoPtr<RandomAccessFile> rpFile = new RandomAccessFile(file, QC_T("rw"));
+		AutoPtr<AsyncIOEngine::Operation> rpRead = pEngine->read(rpFile->getFD().get(), 0, buffer, sizeof(buffer));
+		pEngine->submit();
+		bool bOK = rpRead->isDone() && rpRead->getErrorCode() != 0;
+		rpFile->close();
+		file.deleteFile();
+		if(bOK) {testPassed(name + QC_T(" shutdown"));} else {testFailed(name + QC_T(" shutdown"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), name + QC_T(" shutdown"));
+	}
+}
+
+#if defined(HAVE_LINUX_IO_URING_H) && defined(QC_MT)
+
+//
+// Runs the tests against a UringIOEngine constructed directly, so that they
+// cover io_uring even where Create() would fall back.  The small queue depth
+// makes submit() wait for room in the completion queue.
+//
+static void TestUring()
+{
+	AutoPtr<AsyncIOEngine> rpEngine;
+	try
+	{
+		rpEngine = new UringIOEngine(2);
+	}
+	catch(IOException& e)
+	{
+		testMessage(QC_T("io_uring is not available: ") + e.toString());
+		return;
+	}
+	TestEngine(rpEngine.get());
+}
+
+//
+// Shuts down a UringIOEngine while a receive and an accept are waiting on
+// idle sockets.  Both must be cancelled rather than holding up shutdown().
+//
+static void TestUringShutdown()
+{
+	AutoPtr<UringIOEngine> rpEngine;
+	try
+	{
+		rpEngine = new UringIOEngine;
+	}
+	catch(IOException& e)
+	{
+		testMessage(QC_T("io_uring is not available: ") + e.toString());
+		return;
+	}
+
+	try
+	{
+		AutoPtr<InetAddress> rpLoopback = InetAddress::GetByName(QC_T("127.0.0.1"));
+		AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, rpLoopback.get());
+		AutoPtr<Socket> rpClient = new Socket(rpLoopback.get(), rpServer->getLocalPort());
+		AutoPtr<Socket> rpPeer = rpServer->accept();
+		AutoPtr<ServerSocket> rpIdle = new ServerSocket(0, 1, rpLoopback.get());
+
+		Byte buffer[10];
+		AutoPtr<AsyncIOEngine::Operation> rpReceive =
+			rpEngine->receive(rpPeer->getSocketDescriptor().get(), buffer, sizeof(buffer));
+		AutoPtr<AsyncIOEngine::Operation> rpAccept =
+			rpEngine->accept(rpIdle->getSocketDescriptor().get());
+		rpEngine->submit();
+		bool bOK = !rpReceive->waitFor(50);
+
+		rpEngine->shutdown();
+		bOK = bOK && rpReceive->isDone() && rpReceive->getErrorCode() != 0;
+		bOK = bOK && rpAccept->isDone() && rpAccept->getErrorCode() != 0;
+		rpIdle->close();
+		rpPeer->close();
+		rpClient->close();
+		rpServer->close();
+		if(bOK) {testPassed(QC_T("io_uring shutdown pending"));} else {testFailed(QC_T("io_uring shutdown pending"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("io_uring shutdown pending"));
+	}
+}
+
+#endif //HAVE_LINUX_IO_URING_H
+
+void AsyncIOEngine_Tests()
+{
+	testMessage(QC_T("Starting tests for AsyncIOEngine"));
+
+	TestEngine(AsyncIOEngine::Create().get());
+	TestEngine(AutoPtr<AsyncIOEngine>(new ThreadPoolIOEngine(4)).get());
+
+#if defined(HAVE_LINUX_IO_URING_H) && defined(QC_MT)
+	TestUring();
+	TestUringShutdown();
+
+#endif //HAVE_LINUX_IO_URING_H
+}
+
@@ -0,0 +1,115 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+#include "QcCore/io/BufferedInputStream.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/io/IOException.h"
+#include "QcCore/net/HttpChunkedInputStream.h"
+
+using namespace qc::net;
+
+//
+// Decodes a chunked body, reading at most chunkSize bytes at a time, and
+// returns what is left in the underlying stream in pRest.  Passing a
+// bufSize places a BufferedInputStream of that size beneath the decoder so
+// that the chunk header lines span buffer refills.
+//
+static ByteString ReadChunked(const ByteString& input, size_t chunkSize,
+                              size_t bufSize, ByteString* pRest)
+{
+	AutoPtr<InputStream> rpRaw = new ByteArrayInputStream((const Byte*)input.data(), input.size());
+	if(bufSize)
+	{
+		rpRaw = new BufferedInputStream(rpRaw.get(), bufSize);
+	}
+	AutoPtr<InputStream> rpIn = new HttpChunkedInputStream(rpRaw.get());
+
+	ByteString ret;
+	Byte buffer[64];
+	long count;
+	while((count = rpIn->read(buffer, chunkSize)) != InputStream::EndOfFile)
+	{
+		ret.append((const char*)buffer, count);
+	}
+
+	if(pRest)
+	{
+		pRest->erase();
+		while((count = rpRaw->read(buffer, sizeof(buffer))) != InputStream::EndOfFile)
+		{
+			pRest->append((const char*)buffer, count);
+		}
+	}
+	return ret;
+}
+
+static void TestChunked(const ByteString& input, const ByteString& expected,
+                        const ByteString& expectedRest, const String& testName)
+{
+	try
+	{
+		ByteString rest;
+		bool bOK = ReadChunked(input, 64, 0, &rest) == expected && rest == expectedRest;
+		for(size_t bufSize=1; bufSize<=8; ++bufSize)
+		{
+			bOK = bOK && ReadChunked(input, bufSize, bufSize, &rest) == expected
+			          && rest == expectedRest;
+		}
+		if(bOK) {testPassed(testName);} else {testFailed(testName);}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), testName);
+	}
+}
+
+void HttpChunkedInputStream_Tests()
+{
+	testMessage(QC_T("Starting tests for HttpChunkedInputStream"));
+
+	TestChunked(ByteString("5\r\nhello\r\n6\r\n world\r\n0\r\n\r\nNEXT"),
+	            ByteString("hello world"), ByteString("NEXT"),
+	            QC_T("chunked"));
+
+	TestChunked(ByteString("a\r\n0123456789\r\n  B\r\nabcdefghijk\r\n0\r\n\r\n"),
+	            ByteString("0123456789abcdefghijk"), ByteString(),
+	            QC_T("chunked hex sizes"));
+
+	TestChunked(ByteString("5;name=value\r\nhello\r\n3;x;y=\"a;b\"\r\nabc\r\n0;last\r\n\r\nNEXT"),
+	            ByteString("helloabc"), ByteString("NEXT"),
+	            QC_T("chunked extensions"));
+
+	TestChunked(ByteString("4\r\nwxyz\r\n0\r\nExpires: never\r\nX-Sum: 1\r\n\r\nNEXT"),
+	            ByteString("wxyz"), ByteString("NEXT"),
+	            QC_T("chunked trailers"));
+
+	//
+	// A body that ends before its last chunk header is an error
+	//
+	try
+	{
+		ReadChunked(ByteString("5\r\nhello\r\n"), 64, 4, 0);
+		testFailed(QC_T("chunked truncated"));
+	}
+	catch(IOException& e)
+	{
+		goodCatch(QC_T("chunked truncated"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("chunked truncated"));
+	}
+}
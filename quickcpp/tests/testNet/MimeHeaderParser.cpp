@@ -0,0 +1,105 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+#include "QcCore/io/BufferedInputStream.h"
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/net/MimeHeaderParser.h"
+
+using namespace qc::net;
+
+static AutoPtr<InputStream> MakeStream(const ByteString& input, size_t bufSize)
+{
+	AutoPtr<InputStream> rpIn = new ByteArrayInputStream((const Byte*)input.data(), input.size());
+	if(bufSize)
+	{
+		rpIn = new BufferedInputStream(rpIn.get(), bufSize);
+	}
+	return rpIn;
+}
+
+//
+// ReadLineLatin1 over an unbuffered stream and over small buffers, so
+// that lines and <CRLF> pairs span refills
+//
+static void TestReadLine()
+{
+	try
+	{
+		const ByteString input("one\r\ntwo\n\r\nth\rree\r\n\xE9t\xE9\nlast");
+		bool bOK = true;
+		for(size_t bufSize=0; bufSize<=6; ++bufSize)
+		{
+			AutoPtr<InputStream> rpIn = MakeStream(input, bufSize);
+			String line;
+			bOK = bOK && MimeHeaderParser::ReadLineLatin1(rpIn.get(), line) == 3 && line == QC_T("one");
+			bOK = bOK && MimeHeaderParser::ReadLineLatin1(rpIn.get(), line) == 3 && line == QC_T("two");
+			bOK = bOK && MimeHeaderParser::ReadLineLatin1(rpIn.get(), line) == 0 && line.empty();
+			bOK = bOK && MimeHeaderParser::ReadLineLatin1(rpIn.get(), line) == 5 && line == QC_T("three");
+			bOK = bOK && MimeHeaderParser::ReadLineLatin1(rpIn.get(), line) == 3
+			          && line == StringUtils::FromLatin1(ByteString("\xE9t\xE9"));
+			bOK = bOK && MimeHeaderParser::ReadLineLatin1(rpIn.get(), line) == InputStream::EndOfFile;
+		}
+		if(bOK) {testPassed(QC_T("ReadLineLatin1"));} else {testFailed(QC_T("ReadLineLatin1"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("ReadLineLatin1"));
+	}
+}
+
+static void TestParseHeaders()
+{
+	try
+	{
+		const ByteString input("Host: example.com\r\n"
+		                       "X-Long: first\r\n"
+		                       "  second\r\n"
+		                       "Empty:\r\n"
+		                       "NoColon \r\n"
+		                       "\r\n"
+		                       "BODY");
+		bool bOK = true;
+		for(size_t bufSize=0; bufSize<=6; ++bufSize)
+		{
+			AutoPtr<InputStream> rpIn = MakeStream(input, bufSize);
+			AutoPtr<MimeHeaderSequence> rpHeaders = MimeHeaderParser::ParseHeaders(rpIn.get());
+			bOK = bOK && rpHeaders->size() == 4;
+			bOK = bOK && rpHeaders->getHeader(QC_T("Host")) == QC_T("example.com");
+			bOK = bOK && rpHeaders->getHeader(QC_T("X-Long")) == QC_T("firstsecond");
+			bOK = bOK && rpHeaders->containsHeader(QC_T("Empty"))
+			          && rpHeaders->getHeader(QC_T("Empty")).empty();
+			bOK = bOK && rpHeaders->getHeaderKey(3).empty()
+			          && rpHeaders->getHeader(3) == QC_T("NoColon");
+
+			// the body must be left in the stream
+			Byte body[8];
+			bOK = bOK && rpIn->read(body, 4) == 4 && ::memcmp(body, "BODY", 4) == 0;
+		}
+		if(bOK) {testPassed(QC_T("ParseHeaders"));} else {testFailed(QC_T("ParseHeaders"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("ParseHeaders"));
+	}
+}
+
+void MimeHeaderParser_Tests()
+{
+	testMessage(QC_T("Starting tests for MimeHeaderParser"));
+
+	TestReadLine();
+	TestParseHeaders();
+}
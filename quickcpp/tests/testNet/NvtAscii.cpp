@@ -0,0 +1,209 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+#include "QcCore/io/ByteArrayInputStream.h"
+#include "QcCore/io/ByteArrayOutputStream.h"
+#include "QcCore/net/NvtAsciiInputStream.h"
+#include "QcCore/net/NvtAsciiOutputStream.h"
+#include "QcCore/net/ProtocolException.h"
+
+using namespace qc::net;
+
+//
+// Reads the whole of an NvtAsciiInputStream using reads of at most
+// chunkSize bytes, so that a <CR> can be made to fall at the end of a read
+//
+static ByteString ReadNvt(const ByteString& input, size_t chunkSize)
+{
+	AutoPtr<InputStream> rpIn = new NvtAsciiInputStream(
+		new ByteArrayInputStream((const Byte*)input.data(), input.size()));
+
+	ByteString ret;
+	Byte buffer[64];
+	long count;
+	while((count = rpIn->read(buffer, chunkSize)) != InputStream::EndOfFile)
+	{
+		ret.append((const char*)buffer, count);
+	}
+	return ret;
+}
+
+static void TestInput()
+{
+	//
+	// <CRLF> and <CR><NUL> within a single read
+	//
+	try
+	{
+		const ByteString input("ab\r\ncd\r\nef\r", 11);
+		const ByteString input2("ab\r\0cd", 6);
+#if defined(WIN32)
+		const ByteString expected(input);
+		const ByteString expected2(input2);
+#else
+		const ByteString expected("ab\ncd\nef\n", 9);
+		const ByteString expected2("ab\ncd", 5);
+#endif
+		bool bOK = ReadNvt(input + ByteString("\n"), 64) == expected
+		        && ReadNvt(input2, 64) == expected2;
+		if(bOK) {testPassed(QC_T("NVT input"));} else {testFailed(QC_T("NVT input"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT input"));
+	}
+
+#if !defined(WIN32)
+
+	//
+	// A <CR> that ends a read must consume the <LF> or <NUL> which follows
+	// it from the underlying stream
+	//
+	try
+	{
+		const ByteString input("a\r\nb\r\0c", 7);
+		AutoPtr<InputStream> rpIn = new NvtAsciiInputStream(
+			new ByteArrayInputStream((const Byte*)input.data(), input.size()));
+		Byte buffer[8];
+		bool bOK = rpIn->read(buffer, 2) == 2 && ::memcmp(buffer, "a\n", 2) == 0;
+		bOK = bOK && rpIn->read(buffer, 2) == 2 && ::memcmp(buffer, "b\n", 2) == 0;
+		bOK = bOK && rpIn->read(buffer, 2) == 1 && buffer[0] == 'c';
+		bOK = bOK && rpIn->read(buffer, 2) == InputStream::EndOfFile;
+		if(bOK) {testPassed(QC_T("NVT input CR at boundary"));} else {testFailed(QC_T("NVT input CR at boundary"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT input CR at boundary"));
+	}
+
+	//
+	// The result must not depend on where the reads are split
+	//
+	try
+	{
+		ByteString input;
+		ByteString expected;
+		for(int i=0; i<40; ++i)
+		{
+			const ByteString text(size_t(i % 7), char('a' + i % 26));
+			input += text;
+			expected += text;
+			input += (i % 3) ? ByteString("\r\n") : ByteString("\r\0", 2);
+			expected += '\n';
+		}
+		bool bOK = true;
+		for(size_t chunkSize=1; chunkSize<=9; ++chunkSize)
+		{
+			bOK = bOK && ReadNvt(input, chunkSize) == expected;
+		}
+		if(bOK) {testPassed(QC_T("NVT input split reads"));} else {testFailed(QC_T("NVT input split reads"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT input split reads"));
+	}
+
+	try
+	{
+		ReadNvt(ByteString("a\rX"), 2);
+		testFailed(QC_T("NVT input invalid CR"));
+	}
+	catch(ProtocolException& e)
+	{
+		goodCatch(QC_T("NVT input invalid CR"), e.toString());
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT input invalid CR"));
+	}
+
+#endif //WIN32
+}
+
+static void TestOutput()
+{
+	//
+	// A lone <LF> gains a <CR>, an existing <CRLF> is left alone
+	//
+	try
+	{
+		AutoPtr<ByteArrayOutputStream> rpBytes = new ByteArrayOutputStream;
+		AutoPtr<OutputStream> rpOut = new NvtAsciiOutputStream(rpBytes.get());
+		const ByteString input("\na\nb\r\nc\n\n");
+		rpOut->write((const Byte*)input.data(), input.size());
+		rpOut->flush();
+		bool bOK = rpBytes->toByteString() == ByteString("\r\na\r\nb\r\nc\r\n\r\n");
+		if(bOK) {testPassed(QC_T("NVT output"));} else {testFailed(QC_T("NVT output"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT output"));
+	}
+
+	//
+	// A <CRLF> pair split across two writes must not gain a second <CR>
+	//
+	try
+	{
+		AutoPtr<ByteArrayOutputStream> rpBytes = new ByteArrayOutputStream;
+		AutoPtr<OutputStream> rpOut = new NvtAsciiOutputStream(rpBytes.get());
+		rpOut->write((const Byte*)"x\r", 2);
+		rpOut->write((const Byte*)"\ny", 2);
+		rpOut->write((const Byte*)"z", 1);
+		rpOut->write((const Byte*)"\n", 1);
+		rpOut->flush();
+		bool bOK = rpBytes->toByteString() == ByteString("x\r\nyz\r\n");
+		if(bOK) {testPassed(QC_T("NVT output split CRLF"));} else {testFailed(QC_T("NVT output split CRLF"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT output split CRLF"));
+	}
+
+	//
+	// Writing a byte at a time must give the same result as one write
+	//
+	try
+	{
+		const ByteString input("one\ntwo\r\n\nthree\r\r\nfour\n");
+		AutoPtr<ByteArrayOutputStream> rpWhole = new ByteArrayOutputStream;
+		AutoPtr<ByteArrayOutputStream> rpBytewise = new ByteArrayOutputStream;
+		AutoPtr<OutputStream> rpOut = new NvtAsciiOutputStream(rpWhole.get());
+		rpOut->write((const Byte*)input.data(), input.size());
+		rpOut->flush();
+		rpOut = new NvtAsciiOutputStream(rpBytewise.get());
+		for(size_t i=0; i<input.size(); ++i)
+		{
+			rpOut->write((const Byte*)input.data()+i, 1);
+		}
+		rpOut->flush();
+		bool bOK = rpWhole->toByteString() == rpBytewise->toByteString()
+		        && rpWhole->toByteString() == ByteString("one\r\ntwo\r\n\r\nthree\r\r\nfour\r\n");
+		if(bOK) {testPassed(QC_T("NVT output bytewise"));} else {testFailed(QC_T("NVT output bytewise"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("NVT output bytewise"));
+	}
+}
+
+void NvtAscii_Tests()
+{
+	testMessage(QC_T("Starting tests for NvtAsciiInputStream and NvtAsciiOutputStream"));
+
+	TestInput();
+	TestOutput();
+}
@@ -16,10 +16,18 @@ void goodCatch(const String& test, const String& eMsg);
 void uncaughtException(const String& e, const String& test);
 
 
+#include "QcCore/io/File.h"
+#include "QcCore/io/FileInputStream.h"
+#include "QcCore/io/FileOutputStream.h"
+#include "QcCore/io/FileSystem.h"
 #include "QcCore/net/InetAddress.h"
+#include "QcCore/net/ServerSocket.h"
 #include "QcCore/net/Socket.h"
 #include "QcCore/net/SocketException.h"
 
+#include <string.h>
+#include <vector>
+
 using namespace qc::net; 
 
 
@@ -112,6 +120,182 @@ void Socket_Tests()
 	}
 
 
+	//
+	// Send part of a file over a loopback connection with sendFile() and
+	// receive it into another file with transferTo().  The file is small
+	// enough to fit in the socket buffers, so no second thread is required.
+	//
+	try
+	{
+		File sendFile(QC_T("sendfile.out"));
+		File recvFile(QC_T("recvfile.out"));
+		const size_t fileSize = 10000;
+		AutoPtr<FileOutputStream> rpFileOS = new FileOutputStream(sendFile);
+		for(size_t i=0; i<fileSize; ++i)
+		{
+			rpFileOS->write(Byte(i % 251));
+		}
+		rpFileOS->close();
+
+		AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, InetAddress::GetByName(QC_T("127.0.0.1")).get());
+		AutoPtr<Socket> rpClient = new Socket(QC_T("127.0.0.1"), rpServer->getLocalPort());
+		AutoPtr<Socket> rpPeer = rpServer->accept();
+
+		bool bOK = (rpClient->sendFile(sendFile, 100, fileSize) == fileSize-100);
+		rpClient->shutdownOutput();
+
+		rpFileOS = new FileOutputStream(recvFile);
+		bOK = bOK && (rpPeer->getInputStream()->transferTo(rpFileOS.get()) == fileSize-100);
+		rpFileOS->close();
+		rpPeer->close();
+		rpClient->close();
+		rpServer->close();
+
+		AutoPtr<FileInputStream> rpFileIS = new FileInputStream(recvFile);
+		for(size_t j=100; bOK && j<fileSize; ++j)
+		{
+			bOK = (rpFileIS->read() == int(j % 251));
+		}
+		bOK = bOK && (rpFileIS->read() == InputStream::EndOfFile);
+		rpFileIS->close();
+		sendFile.deleteFile();
+		recvFile.deleteFile();
+		if(bOK) {testPassed(QC_T("sendFile"));} else {testFailed(QC_T("sendFile"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("sendFile"));
+	}
+
+	//
+	// When the peer goes away part way through a transfer, the file is
+	// still left positioned after the data that was sent
+	//
+	{
+		File sendFile(QC_T("sendfile.out"));
+		try
+		{
+			const size_t fileSize = 4*1024*1024;
+			AutoPtr<FileOutputStream> rpFileOS = new FileOutputStream(sendFile);
+			std::vector<Byte> block(64*1024, Byte('x'));
+			for(size_t i=0; i<fileSize; i+=block.size())
+			{
+				rpFileOS->write(&block[0], block.size());
+			}
+			rpFileOS->close();
+
+			AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, InetAddress::GetByName(QC_T("127.0.0.1")).get());
+			AutoPtr<Socket> rpClient = new Socket(QC_T("127.0.0.1"), rpServer->getLocalPort());
+			rpServer->accept()->close();
+			rpServer->close();
+
+			AutoPtr<FileInputStream> rpFileIS = new FileInputStream(sendFile);
+			AutoPtr<FileDescriptor> rpFD = rpFileIS->getFD();
+			try
+			{
+				rpClient->getOutputStream()->transferFrom(rpFD.get(), 100, fileSize-100);
+				testFailed(QC_T("transferFrom reset"));
+			}
+			catch(SocketException& e)
+			{
+				goodCatch(QC_T("transferFrom reset"), e.toString());
+				const FileOffset pos = rpFD->getFileSystem()->getFilePosition(rpFD.get());
+				if(pos > 100 && pos < fileSize) {testPassed(QC_T("transferFrom reset position"));} else {testFailed(QC_T("transferFrom reset position"));}
+			}
+			rpFileIS->close();
+			rpClient->close();
+		}
+		catch(Exception& e)
+		{
+			uncaughtException(e.toString(), QC_T("transferFrom reset"));
+		}
+		sendFile.deleteFile();
+	}
+
+	//
+	// Receive into a file opened with DirectIO using transferTo().  The
+	// bytes already held in the stream's aligned buffer must come first.
+	//
+	try
+	{
+		File recvFile(QC_T("recvdirect.out"));
+		const size_t dataSize = 10000;
+		Byte data[dataSize];
+		for(size_t i=0; i<dataSize; ++i)
+		{
+			data[i] = Byte(i % 251);
+		}
+
+		AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, InetAddress::GetByName(QC_T("127.0.0.1")).get());
+		AutoPtr<Socket> rpClient = new Socket(QC_T("127.0.0.1"), rpServer->getLocalPort());
+		AutoPtr<Socket> rpPeer = rpServer->accept();
+		rpClient->getOutputStream()->write(data, dataSize);
+		rpClient->shutdownOutput();
+
+		AutoPtr<FileOutputStream> rpFileOS = new FileOutputStream(recvFile, FileOutputStream::DirectIO);
+		const Byte head[] = {'H', 'E', 'A', 'D'};
+		rpFileOS->write(head, sizeof(head));
+		bool bOK = (rpPeer->getInputStream()->transferTo(rpFileOS.get()) == dataSize);
+		rpFileOS->close();
+		rpPeer->close();
+		rpClient->close();
+		rpServer->close();
+
+		AutoPtr<FileInputStream> rpFileIS = new FileInputStream(recvFile);
+		Byte buffer[sizeof(head)];
+		bOK = bOK && (rpFileIS->read(buffer, sizeof(head)) == sizeof(head));
+		bOK = bOK && (memcmp(buffer, head, sizeof(head)) == 0);
+		for(size_t j=0; bOK && j<dataSize; ++j)
+		{
+			bOK = (rpFileIS->read() == int(j % 251));
+		}
+		bOK = bOK && (rpFileIS->read() == InputStream::EndOfFile);
+		rpFileIS->close();
+		recvFile.deleteFile();
+		if(bOK) {testPassed(QC_T("transferTo DirectIO file"));} else {testFailed(QC_T("transferTo DirectIO file"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("transferTo DirectIO file"));
+	}
+
+
+	//
+	// Send several blocks with one gather write over a loopback connection
+	//
+	try
+	{
+		const Byte head[] = {'H', 'E', 'A', 'D'};
+		const Byte body[] = {'b', 'o', 'd', 'y', '!'};
+		IoVec vecs[2];
+		vecs[0].pData = head; vecs[0].length = sizeof(head);
+		vecs[1].pData = body; vecs[1].length = sizeof(body);
+
+		AutoPtr<ServerSocket> rpServer = new ServerSocket(0, 1, InetAddress::GetByName(QC_T("127.0.0.1")).get());
+		AutoPtr<Socket> rpClient = new Socket(QC_T("127.0.0.1"), rpServer->getLocalPort());
+		AutoPtr<Socket> rpPeer = rpServer->accept();
+		rpClient->getOutputStream()->write(vecs, 2);
+		rpClient->shutdownOutput();
+
+		AutoPtr<InputStream> rpIS = rpPeer->getInputStream();
+		Byte input[16];
+		size_t received = 0;
+		long count;
+		while(received < sizeof(input) && (count = rpIS->read(input+received, sizeof(input)-received)) != InputStream::EndOfFile)
+		{
+			received += count;
+		}
+		rpPeer->close();
+		rpClient->close();
+		rpServer->close();
+
+		const bool bOK = (received == 9 && ::memcmp(input, "HEADbody!", 9) == 0);
+		if(bOK) {testPassed(QC_T("gather write"));} else {testFailed(QC_T("gather write"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("gather write"));
+	}
 
 	testMessage(QC_T("End of tests for Socket"));
 }
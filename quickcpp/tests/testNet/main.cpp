@@ -19,6 +19,10 @@ void uncaughtException(const String& e, const String& test);
 void URL_Tests();
 void HttpClient_Tests();
 void Socket_Tests();
+void AsyncIOEngine_Tests();
+void NvtAscii_Tests();
+void HttpChunkedInputStream_Tests();
+void MimeHeaderParser_Tests();
 
 
 #include "QcCore/base/System.h"
@@ -113,6 +117,10 @@ int main(int argc, char* argv[])
 		URL_Tests();
 		HttpClient_Tests();
 		Socket_Tests();
+		AsyncIOEngine_Tests();
+		NvtAscii_Tests();
+		HttpChunkedInputStream_Tests();
+		MimeHeaderParser_Tests();
 	}
 	catch(Exception& e)
 	{
@@ -0,0 +1,248 @@
+#include "QcCore/base/System.h"
+#include "QcCore/io/Console.h"
+#include "QcCore/base/Exception.h"
+#include "QcCore/base/StringUtils.h"
+#include "QcCore/util/AttributeListParser.h"
+
+using namespace qc;
+using namespace qc::io;
+using namespace qc::util;
+
+String getTestAttribute(const String& name);
+void testMessage(const String& msg);
+void testFailed(const String& test);
+void testPassed(const String& test);
+void goodCatch(const String& test, const String& eMsg);
+void uncaughtException(const String& e, const String& test);
+
+#include "QcCore/util/CRC32.h"
+#include "QcCore/util/CRC32C.h"
+#include "QcCore/util/XXHash64.h"
+#include <string.h>
+#include <vector>
+
+using namespace qc::util;
+
+//
+// Bit-at-a-time reference CRC for the reflected polynomial poly
+//
+static unsigned int ReferenceCrc(unsigned int poly, const Byte* pData, size_t len)
+{
+	unsigned int crc = 0xFFFFFFFF;
+	for(size_t i=0; i<len; ++i)
+	{
+		crc ^= pData[i];
+		for(int bit=0; bit<8; ++bit)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ poly : (crc >> 1);
+		}
+	}
+	return ~crc;
+}
+
+static void FillBuffer(std::vector<Byte>& buffer, size_t len)
+{
+	buffer.resize(len);
+	unsigned int seed = 12345;
+	for(size_t i=0; i<len; ++i)
+	{
+		seed = seed * 1103515245 + 12345;
+		buffer[i] = Byte(seed >> 16);
+	}
+}
+
+//
+// Compares a checksum of every length up to maxLen, starting at every offset
+// from 0 to 15, with the reference CRC.
+//
+static bool CompareWithReference(Checksum& checksum, unsigned int poly,
+                                 const std::vector<Byte>& buffer, size_t maxLen,
+                                 size_t step)
+{
+	for(size_t offset=0; offset<16; ++offset)
+	{
+		for(size_t len=0; len+offset<=buffer.size() && len<=maxLen; len+=step)
+		{
+			checksum.reset();
+			checksum.update(&buffer[0]+offset, len);
+			if(checksum.getValue() != ReferenceCrc(poly, &buffer[0]+offset, len))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+//
+// Feeds buffer to the checksum in pieces of pieceLen bytes and compares the
+// result with expected.
+//
+static bool UpdateInPieces(Checksum& checksum, const std::vector<Byte>& buffer,
+                           size_t pieceLen, unsigned long long expected)
+{
+	checksum.reset();
+	for(size_t pos=0; pos<buffer.size(); pos+=pieceLen)
+	{
+		const size_t len = (buffer.size()-pos < pieceLen) ? buffer.size()-pos : pieceLen;
+		checksum.update(&buffer[0]+pos, len);
+	}
+	return checksum.getValue() == expected;
+}
+
+void Checksum_Tests()
+{
+	const Byte* pCheck = (const Byte*)"123456789";
+	const size_t checkLen = 9;
+
+	//
+	// The standard check values
+	//
+	try
+	{
+		CRC32 crc;
+		crc.update(pCheck, checkLen);
+		if(crc.getValue() == 0xCBF43926) {testPassed(QC_T("CRC32 check value"));} else {testFailed(QC_T("CRC32 check value"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CRC32 check value"));
+	}
+
+	try
+	{
+		CRC32C crc;
+		crc.update(pCheck, checkLen);
+		if(crc.getValue() == 0xE3069283) {testPassed(QC_T("CRC32C check value"));} else {testFailed(QC_T("CRC32C check value"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CRC32C check value"));
+	}
+
+	try
+	{
+		XXHash64 empty;
+		XXHash64 hash;
+		hash.update(pCheck, checkLen);
+		XXHash64 a;
+		a.update((const Byte*)"abc", 3);
+		bool bOK = (empty.getValue() == 0xEF46DB3751D8E999ULL);
+		bOK = bOK && (hash.getValue() == 0x8CB841DB40E6AE83ULL);
+		bOK = bOK && (a.getValue() == 0x44BC2CF5AD770999ULL);
+		if(bOK) {testPassed(QC_T("XXHash64 check values"));} else {testFailed(QC_T("XXHash64 check values"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("XXHash64 check values"));
+	}
+
+	//
+	// The accelerated paths must agree with the reference for every length
+	// and alignment, including the large blocks that are split into streams
+	//
+	std::vector<Byte> buffer;
+	FillBuffer(buffer, 100000);
+
+	try
+	{
+		CRC32 crc;
+		bool bOK = CompareWithReference(crc, 0xEDB88320, buffer, 300, 1);
+		bOK = bOK && CompareWithReference(crc, 0xEDB88320, buffer, 99000, 997);
+		if(bOK) {testPassed(QC_T("CRC32 lengths"));} else {testFailed(QC_T("CRC32 lengths"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CRC32 lengths"));
+	}
+
+	try
+	{
+		CRC32C crc;
+		bool bOK = CompareWithReference(crc, 0x82F63B78, buffer, 300, 1);
+		bOK = bOK && CompareWithReference(crc, 0x82F63B78, buffer, 99000, 997);
+		if(bOK) {testPassed(QC_T("CRC32C lengths"));} else {testFailed(QC_T("CRC32C lengths"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("CRC32C lengths"));
+	}
+
+	try
+	{
+		XXHash64 hash;
+		hash.update(&buffer[0], 1000);
+		XXHash64 seeded(0x9E3779B97F4A7C15ULL);
+		seeded.update(&buffer[0], 1000);
+		std::vector<Byte> counting(1000);
+		for(size_t i=0; i<counting.size(); ++i) counting[i] = Byte(i);
+		XXHash64 count;
+		count.update(&counting[0], counting.size());
+		XXHash64 countSeeded(0x9E3779B97F4A7C15ULL);
+		countSeeded.update(&counting[0], counting.size());
+		bool bOK = (count.getValue() == 0x6EF436B00EBA4078ULL);
+		bOK = bOK && (countSeeded.getValue() == 0xDB4568E0FAAF632CULL);
+		bOK = bOK && (hash.getValue() != seeded.getValue());
+		if(bOK) {testPassed(QC_T("XXHash64 seed"));} else {testFailed(QC_T("XXHash64 seed"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("XXHash64 seed"));
+	}
+
+	//
+	// The value must not depend upon how the data is divided between calls
+	//
+	try
+	{
+		CRC32 crc32;
+		CRC32C crc32c;
+		XXHash64 xxh;
+		crc32.update(&buffer[0], buffer.size());
+		crc32c.update(&buffer[0], buffer.size());
+		xxh.update(&buffer[0], buffer.size());
+		const unsigned long long crc32Value = crc32.getValue();
+		const unsigned long long crc32cValue = crc32c.getValue();
+		const unsigned long long xxhValue = xxh.getValue();
+
+		const size_t pieces[] = {1, 3, 7, 31, 33, 64, 1000, 4099};
+		bool bOK = true;
+		for(size_t i=0; i<sizeof(pieces)/sizeof(pieces[0]); ++i)
+		{
+			bOK = bOK && UpdateInPieces(crc32, buffer, pieces[i], crc32Value);
+			bOK = bOK && UpdateInPieces(crc32c, buffer, pieces[i], crc32cValue);
+			bOK = bOK && UpdateInPieces(xxh, buffer, pieces[i], xxhValue);
+		}
+		if(bOK) {testPassed(QC_T("update in pieces"));} else {testFailed(QC_T("update in pieces"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("update in pieces"));
+	}
+
+	//
+	// getValue() does not disturb the state and reset() restores it
+	//
+	try
+	{
+		XXHash64 xxh;
+		xxh.update(&buffer[0], 40);
+		const unsigned long long partial = xxh.getValue();
+		bool bOK = (xxh.getValue() == partial);
+		xxh.update(&buffer[0]+40, 60);
+		XXHash64 whole;
+		whole.update(&buffer[0], 100);
+		bOK = bOK && (xxh.getValue() == whole.getValue());
+		xxh.reset();
+		bOK = bOK && (xxh.getValue() == 0xEF46DB3751D8E999ULL);
+		CRC32C crc;
+		crc.update(pCheck, checkLen);
+		crc.reset();
+		bOK = bOK && (crc.getValue() == 0);
+		if(bOK) {testPassed(QC_T("getValue and reset"));} else {testFailed(QC_T("getValue and reset"));}
+	}
+	catch(Exception& e)
+	{
+		uncaughtException(e.toString(), QC_T("getValue and reset"));
+	}
+}
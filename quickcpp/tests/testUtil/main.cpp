@@ -19,6 +19,7 @@ void uncaughtException(const String& e, const String& test);
 void Base64_Tests();
 void StringIterator_Tests();
 void StringTokenizer_Tests();
+void Checksum_Tests();
 
 
 #include "QcCore/base/System.h"
@@ -115,6 +116,7 @@ int main(int argc, char* argv[])
 	Base64_Tests();
 	StringIterator_Tests();
 	StringTokenizer_Tests();
+	Checksum_Tests();
 
 
 